@@ -4,6 +4,7 @@
   */
 
 #include "client/si/scriptside.hpp"
+#include "afl/string/format.hpp"
 #include "afl/sys/semaphore.hpp"
 #include "client/si/requestlink1.hpp"
 #include "client/si/requestlink2.hpp"
@@ -12,23 +13,35 @@
 
 namespace {
     const char*const LOG_NAME = "script.si";
+
+    /* Number of instructions a process executes before yielding to other requests */
+    const uint32_t TIME_SLICE = 20000;
+
+    /* Log a message if the game thread was blocked longer than this (milliseconds) */
+    const uint32_t LATENCY_WARNING = 200;
 }
 
 // Constructor.
-client::si::ScriptSide::ScriptSide(util::RequestSender<UserSide> reply, game::Session& session)
+client::si::ScriptSide::ScriptSide(util::RequestSender<UserSide> reply, util::RequestSender<game::Session> gameSender, game::Session& session)
     : m_session(session),
       conn_processGroupFinish(),
       m_reply(reply),
+      m_gameSender(gameSender),
       m_waits()
 {
     conn_processGroupFinish = session.processList().sig_processGroupFinish.add(this, &ScriptSide::onProcessGroupFinish);
     conn_runRequest = session.sig_runRequest.add(this, &ScriptSide::runProcesses);
+    conn_preempt = session.processList().sig_preempt.add(this, &ScriptSide::onPreempt);
+    session.processList().setTimeSlice(TIME_SLICE);
     // FIXME: set break handler?
 }
 
 // Destructor.
 client::si::ScriptSide::~ScriptSide()
-{ }
+{
+    // Without us, nobody would continue preempted processes
+    m_session.processList().setTimeSlice(0);
+}
 
 // Access the underlying RequestSender.
 util::RequestSender<client::si::UserSide>
@@ -326,6 +339,13 @@ client::si::ScriptSide::runProcesses()
 
     // Clean up messages
     m_session.notifications().removeOrphanedMessages();
+
+    // Report latency
+    const uint32_t duration = processList.getLastRunDuration();
+    if (duration >= LATENCY_WARNING) {
+        m_session.log().write(afl::sys::LogListener::Trace, LOG_NAME,
+                              afl::string::Format("Script execution blocked requests for %d ms (max %d ms)", duration, processList.getMaxRunDuration()));
+    }
 }
 
 
@@ -333,6 +353,24 @@ client::si::ScriptSide::runProcesses()
  *  Private
  */
 
+// Preemption callback.
+void
+client::si::ScriptSide::onPreempt()
+{
+    // Continue preempted processes after other requests, no matter who ran them.
+    // A replaceable request avoids piling up continuations if we're called from elsewhere in the meantime.
+    class Task : public util::Request<game::Session> {
+     public:
+        virtual void handle(game::Session& session)
+            {
+                if (ScriptSide* ss = session.extra().get(SCRIPTSIDE_ID)) {
+                    ss->runProcesses();
+                }
+            }
+    };
+    m_gameSender.postNewReplaceableRequest(new Task(), this);
+}
+
 // Wait callback.
 void
 client::si::ScriptSide::onTaskComplete(uint32_t waitId)
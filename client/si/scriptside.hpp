@@ -42,8 +42,9 @@ namespace client { namespace si {
      public:
         /** Constructor.
             @param reply RequestSender to send requests back to UserSide
+            @param gameSender RequestSender to the game thread (used to continue preempted processes)
             @param session Session */
-        ScriptSide(util::RequestSender<UserSide> reply, game::Session& session);
+        ScriptSide(util::RequestSender<UserSide> reply, util::RequestSender<game::Session> gameSender, game::Session& session);
 
         /** Destructor. */
         ~ScriptSide();
@@ -210,6 +211,11 @@ namespace client { namespace si {
         /** Run processes.
             Executes all pending processes.
 
+            Processes are run with a time slice.
+            Whenever a process is preempted, whether by this function or by another caller of
+            interpreter::ProcessList::run(), a call to this function is scheduled on the game thread
+            to continue it after other pending requests have been processed.
+
             For now, this function is exported to run processes that are not managed by ScriptSide/UserSide. */
         void runProcesses();
 
@@ -224,9 +230,15 @@ namespace client { namespace si {
         /** SignalConnection for game::Session::sig_runRequest */
         afl::base::SignalConnection conn_runRequest;
 
+        /** SignalConnection for interpreter::ProcessList::sig_preempt */
+        afl::base::SignalConnection conn_preempt;
+
         /** Sender to UserSide. */
         util::RequestSender<UserSide> m_reply;
 
+        /** Sender to game thread. */
+        util::RequestSender<game::Session> m_gameSender;
+
         /** An active waitId/processGroupId association. */
         struct Wait {
             uint32_t waitId;
@@ -250,6 +262,11 @@ namespace client { namespace si {
             @param pgid    Completed process group */
         void onProcessGroupFinish(uint32_t pgid);
 
+        /** Preemption callback.
+            Schedules continuation of preempted processes.
+            Connected to interpreter::ProcessList::sig_preempt. */
+        void onPreempt();
+
         /** Look up a wait for a process group.
             @param [in] pgid Process Group Id
             @param [out] out Wait
@@ -71,20 +71,21 @@ client::si::UserSide::UserSide(ui::Root& root,
     // Create the ScriptSide
     class Task : public util::Request<game::Session> {
      public:
-        Task(util::RequestSender<UserSide> reply)
-            : m_reply(reply)
+        Task(util::RequestSender<UserSide> reply, util::RequestSender<game::Session> gameSender)
+            : m_reply(reply), m_gameSender(gameSender)
             { }
         virtual void handle(game::Session& session)
             {
                 ScriptSide* ss = session.extra().get(SCRIPTSIDE_ID);
                 if (!ss) {
-                    ss = session.extra().setNew(SCRIPTSIDE_ID, new ScriptSide(m_reply, session));
+                    ss = session.extra().setNew(SCRIPTSIDE_ID, new ScriptSide(m_reply, m_gameSender, session));
                 }
             }
      private:
         util::RequestSender<UserSide> m_reply;
+        util::RequestSender<game::Session> m_gameSender;
     };
-    m_gameSender.postNewRequest(new Task(m_receiver.getSender()));
+    m_gameSender.postNewRequest(new Task(m_receiver.getSender(), m_gameSender));
 
     // Place the Blocker
     m_blocker.setExtent(gfx::Rectangle(gfx::Point(), m_blocker.getLayoutInfo().getPreferredSize()));
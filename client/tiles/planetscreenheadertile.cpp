@@ -9,11 +9,29 @@
 #include "afl/string/format.hpp"
 #include "ui/res/resid.hpp"
 #include "game/proxy/objectlistener.hpp"
+#include "game/map/objectcursor.hpp"
+#include "game/map/objecttype.hpp"
 #include "game/map/planet.hpp"
 
 using ui::widgets::FrameGroup;
 using client::widgets::getFrameTypeFromTaskStatus;
 
+namespace {
+    /* Get image name for a planet, given its index in the cursor's object type */
+    String_t getPlanetImage(game::map::ObjectType& type, game::Id_t index)
+    {
+        int temp;
+        const game::map::Planet* p = dynamic_cast<const game::map::Planet*>(type.getObjectByIndex(index));
+        if (p == 0) {
+            return String_t();
+        } else if (p->getTemperature().get(temp)) {
+            return ui::res::makeResourceId(ui::res::PLANET, temp, p->getId());
+        } else {
+            return ui::res::PLANET;
+        }
+    }
+}
+
 client::tiles::PlanetScreenHeaderTile::PlanetScreenHeaderTile(ui::Root& root, gfx::KeyEventConsumer& kmw, bool forTask)
     : ControlScreenHeader(root, kmw),
       m_receiver(root.engine().dispatcher(), *this),
@@ -37,6 +55,9 @@ client::tiles::PlanetScreenHeaderTile::attach(game::proxy::ObjectObserver& oop)
         Job(game::Session& session, game::map::Object* obj, bool forTask)
             : m_name(obj != 0 ? obj->getName(game::PlainName, session.translator(), session.interface()) : String_t()),
               m_subtitle(),
+              m_image(),
+              m_nextImage(),
+              m_previousImage(),
               m_marked(obj != 0 && obj->isMarked()),
               m_forTask(forTask),
               m_hasMessages(false),
@@ -69,6 +90,14 @@ client::tiles::PlanetScreenHeaderTile::attach(game::proxy::ObjectObserver& oop)
                         m_image = ui::res::PLANET;
                     }
                     m_hasMessages = (!m_forTask && !p->messages().empty());
+
+                    // Images of the planets the user will most likely browse to next
+                    game::map::ObjectCursor& cursor = g->cursors().currentPlanet();
+                    game::map::ObjectType* type = cursor.getObjectType();
+                    if (type != 0 && cursor.getCurrentIndex() == p->getId()) {
+                        m_nextImage     = getPlanetImage(*type, type->findNextIndexWrap(p->getId()));
+                        m_previousImage = getPlanetImage(*type, type->findPreviousIndexWrap(p->getId()));
+                    }
                 }
             }
         void handle(ControlScreenHeader& t)
@@ -83,11 +112,15 @@ client::tiles::PlanetScreenHeaderTile::attach(game::proxy::ObjectObserver& oop)
                     t.enableButton(btnAuto, getFrameTypeFromTaskStatus(m_taskStatus));
                 }
                 t.setImage(m_image);
+                t.prefetchImage(m_nextImage);
+                t.prefetchImage(m_previousImage);
             }
      private:
         String_t m_name;
         String_t m_subtitle;
         String_t m_image;
+        String_t m_nextImage;
+        String_t m_previousImage;
         bool m_marked;
         bool m_forTask;
         bool m_hasMessages;
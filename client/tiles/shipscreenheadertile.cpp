@@ -3,6 +3,8 @@
   */
 
 #include "client/tiles/shipscreenheadertile.hpp"
+#include "game/map/objectcursor.hpp"
+#include "game/map/objecttype.hpp"
 #include "game/map/ship.hpp"
 #include "game/proxy/objectlistener.hpp"
 #include "game/game.hpp"
@@ -13,6 +15,28 @@
 using ui::widgets::FrameGroup;
 using client::widgets::getFrameTypeFromTaskStatus;
 
+namespace {
+    /* Get image name for a ship */
+    String_t getShipImage(const game::map::Ship& sh, const game::spec::ShipList& sl)
+    {
+        int hullNumber;
+        const game::spec::Hull* hull = sh.getHull().get(hullNumber) ? sl.hulls().get(hullNumber) : 0;
+        if (hull) {
+            return ui::res::makeResourceId(ui::res::SHIP, hull->getInternalPictureNumber(), hull->getId());
+        } else {
+            // Unknown or out-of-range. In any case, it's not known, so it's a nonvisual contact.
+            return RESOURCE_ID("nvc");
+        }
+    }
+
+    /* Get image name for a ship, given its index in the cursor's object type */
+    String_t getShipImage(game::map::ObjectType& type, game::Id_t index, const game::spec::ShipList& sl)
+    {
+        const game::map::Ship* sh = dynamic_cast<const game::map::Ship*>(type.getObjectByIndex(index));
+        return (sh != 0 ? getShipImage(*sh, sl) : String_t());
+    }
+}
+
 client::tiles::ShipScreenHeaderTile::ShipScreenHeaderTile(ui::Root& root, gfx::KeyEventConsumer& kmw, Kind k)
     : ControlScreenHeader(root, kmw),
       m_receiver(root.engine().dispatcher(), *this),
@@ -46,6 +70,9 @@ client::tiles::ShipScreenHeaderTile::attach(game::proxy::ObjectObserver& oop)
         Job(game::Session& session, game::map::Object* obj, Kind kind)
             : m_name(obj != 0 ? obj->getName(game::PlainName, session.translator(), session.interface()) : String_t()),
               m_subtitle(),
+              m_image(),
+              m_nextImage(),
+              m_previousImage(),
               m_marked(obj != 0 && obj->isMarked()),
               m_hasMessages(false),
               m_kind(kind),
@@ -87,13 +114,16 @@ client::tiles::ShipScreenHeaderTile::attach(game::proxy::ObjectObserver& oop)
                                                      r->hostConfiguration().getExperienceLevelName(level, session.translator()),
                                                      (hull ? hull->getName(sl->componentNamer()) : tx("ship")));
 
-                    if (hull) {
-                        m_image = ui::res::makeResourceId(ui::res::SHIP, hull->getInternalPictureNumber(), hull->getId());
-                    } else {
-                        // Unknown or out-of-range. In any case, it's not known, so it's a nonvisual contact.
-                        m_image = RESOURCE_ID("nvc");
-                    }
+                    m_image = getShipImage(*sh, *sl);
                     m_hasMessages = (m_kind == ShipScreen && !sh->messages().empty());
+
+                    // Images of the ships the user will most likely browse to next
+                    game::map::ObjectCursor& cursor = (m_kind == HistoryScreen ? g->cursors().currentHistoryShip() : g->cursors().currentShip());
+                    game::map::ObjectType* type = cursor.getObjectType();
+                    if (type != 0 && cursor.getCurrentIndex() == sh->getId()) {
+                        m_nextImage     = getShipImage(*type, type->findNextIndexWrap(sh->getId()), *sl);
+                        m_previousImage = getShipImage(*type, type->findPreviousIndexWrap(sh->getId()), *sl);
+                    }
                 }
             }
         void handle(ControlScreenHeader& t)
@@ -103,6 +133,8 @@ client::tiles::ShipScreenHeaderTile::attach(game::proxy::ObjectObserver& oop)
                 t.setHasMessages(m_hasMessages);
                 t.enableButton(btnImage, m_marked ? ui::YellowFrame : ui::NoFrame);
                 t.setImage(m_image);
+                t.prefetchImage(m_nextImage);
+                t.prefetchImage(m_previousImage);
                 if (m_kind == ShipScreen) {
                     t.enableButton(btnAuto, getFrameTypeFromTaskStatus(m_taskStatus));
                 }
@@ -114,6 +146,8 @@ client::tiles::ShipScreenHeaderTile::attach(game::proxy::ObjectObserver& oop)
         String_t m_name;
         String_t m_subtitle;
         String_t m_image;
+        String_t m_nextImage;
+        String_t m_previousImage;
         bool m_marked;
         bool m_hasMessages;
         Kind m_kind;
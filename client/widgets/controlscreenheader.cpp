@@ -9,6 +9,7 @@
 #include "afl/base/staticassert.hpp"
 #include "client/marker.hpp"
 #include "ui/layout/hbox.hpp"
+#include "ui/root.hpp"
 #include "ui/widgets/button.hpp"
 #include "util/unicodechars.hpp"
 #include "util/updater.hpp"
@@ -162,7 +163,8 @@ client::widgets::ControlScreenHeader::TitleWidget::handleMouse(gfx::Point pt, Mo
 
 
 client::widgets::ControlScreenHeader::ControlScreenHeader(ui::Root& root, gfx::KeyEventConsumer& kmw)
-    : m_deleter(),
+    : m_root(root),
+      m_deleter(),
       m_visibleButtons()
 {
     // ex WControlScreenHeaderTile::WControlScreenHeaderTile
@@ -216,6 +218,14 @@ client::widgets::ControlScreenHeader::setImage(String_t name)
     }
 }
 
+void
+client::widgets::ControlScreenHeader::prefetchImage(String_t name)
+{
+    if (!name.empty()) {
+        m_root.provider().prefetchImage(name);
+    }
+}
+
 void
 client::widgets::ControlScreenHeader::setHasMessages(bool flag)
 {
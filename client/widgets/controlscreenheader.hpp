@@ -62,6 +62,11 @@ namespace client { namespace widgets {
         void setImage(String_t name);
         void setHasMessages(bool flag);
 
+        /** Prefetch an image.
+            Use for images that will probably be shown soon, e.g. the images of the next and previous object.
+            \param name Image name */
+        void prefetchImage(String_t name);
+
         // Widget:
         virtual void draw(gfx::Canvas& can);
         virtual void handleStateChange(State st, bool enable);
@@ -77,6 +82,7 @@ namespace client { namespace widgets {
      private:
         class TitleWidget;
 
+        ui::Root& m_root;
         afl::base::Deleter m_deleter;
         ui::widgets::FrameGroup* m_frames[NUM_BUTTONS];
         // ui::widgets::StaticText* m_texts[NUM_TEXTS];
@@ -5,11 +5,14 @@
 
 #include <cstring>
 #include <algorithm>
+#include <map>
 #include "game/db/loader.hpp"
 #include "afl/base/countof.hpp"
+#include "afl/base/growablememory.hpp"
 #include "afl/base/staticassert.hpp"
 #include "afl/data/namemap.hpp"
 #include "afl/except/fileformatexception.hpp"
+#include "afl/io/internalstream.hpp"
 #include "afl/io/limitedstream.hpp"
 #include "afl/string/format.hpp"
 #include "game/db/drawingatommap.hpp"
@@ -20,6 +23,7 @@
 #include "interpreter/vmio/nullsavecontext.hpp"
 #include "interpreter/vmio/valueloader.hpp"
 #include "util/atomtable.hpp"
+#include "util/digest.hpp"
 #include "util/io.hpp"
 
 namespace {
@@ -156,6 +160,207 @@ namespace {
             }
         }
     }
+
+    /*
+     *  Index
+     *
+     *  An indexed file consists of a normal file, followed by updated records, followed by an rIndex record.
+     *  The index contains a checksum for every object; an update appends the records whose checksum changed.
+     */
+
+    /* Index: maps record type and Id to checksum */
+    typedef std::pair<uint16_t, uint16_t> IndexKey_t;
+    typedef std::map<IndexKey_t, uint32_t> Index_t;
+
+    /* Maximum size of updates, in percent of the size of the completely-written part of the file.
+       If updates grow beyond that, the file is rewritten. */
+    const uint32_t MAX_UPDATE_PERCENT = 100;
+
+    /* Check whether a changed record can be appended to the file.
+       Loading the old and the appended record must produce the same result as loading just the new one.
+       This holds for records that are merged according to their timestamps or replace previous content,
+       but not for drawings (which are added) and properties (where missing values would not be reset). */
+    bool isUpdatableRecord(uint16_t type)
+    {
+        switch (type) {
+         case dt::rPlanetHistory:
+         case dt::rShipHistory:
+         case dt::rShipTrack:
+         case dt::rMinefield:
+         case dt::rAutoBuild:
+         case dt::rShipScore:
+         case dt::rPlanetScore:
+         case dt::rUfoHistory:
+            return true;
+         default:
+            return false;
+        }
+    }
+
+    /* Get Id of a record for the index.
+       Records that are not associated with an object are numbered sequentially using counter. */
+    uint16_t getRecordId(uint16_t type, afl::base::ConstBytes_t payload, uint16_t& counter)
+    {
+        size_t offset;
+        switch (type) {
+         case dt::rPlanetHistory:
+            // Planet::planet.planetId
+            offset = 2;
+            break;
+         case dt::rShipHistory:
+         case dt::rShipTrack:
+         case dt::rShipProperty:
+         case dt::rPlanetProperty:
+         case dt::rUfoHistory:
+            // Ship::ship.shipId, ShipTrackHeader::id, PropertyHeader::id, Ufo::id
+            offset = 0;
+            break;
+         default:
+            return counter++;
+        }
+
+        dt::UInt16_t id;
+        id = 0;
+        afl::base::fromObject(id).copyFrom(payload.subrange(offset));
+        return id;
+    }
+
+    /* Add index entry.
+       Returns true if the entry is new or changed relative to the old index (if any). */
+    bool addIndexEntry(Index_t& index, const Index_t* pOldIndex, IndexKey_t key, uint32_t checksum)
+    {
+        index[key] = checksum;
+        if (pOldIndex == 0) {
+            return false;
+        }
+        Index_t::const_iterator it = pOldIndex->find(key);
+        return it == pOldIndex->end() || it->second != checksum;
+    }
+
+    /* Build index for records.
+       \param data      Records (everything after the header and property names)
+       \param index     [out] Index
+       \param pOldIndex Old index; if given, changed records are appended to updates
+       \param updates   [out] Updated records
+       \return false if a record changed that cannot be updated */
+    bool scanRecords(afl::base::ConstBytes_t data, Index_t& index, const Index_t* pOldIndex, afl::base::GrowableBytes_t& updates)
+    {
+        const util::Digest& digest = util::Digest::getDefaultInstance();
+        std::map<uint16_t, uint16_t> counters;
+        afl::base::GrowableBytes_t minefields;
+        bool ok = true;
+
+        dt::BlockHeader header;
+        while (data.size() >= sizeof(header)) {
+            afl::base::fromObject(header).copyFrom(data.split(sizeof(header)));
+            const uint16_t type = header.blockType;
+            afl::base::ConstBytes_t payload = data.split(header.size);
+
+            if (type == dt::rMinefield) {
+                // Index minefields individually; changed ones are collected into one record
+                while (payload.size() >= sizeof(dt::Minefield)) {
+                    afl::base::ConstBytes_t entry = payload.split(sizeof(dt::Minefield));
+                    dt::Minefield mf;
+                    afl::base::fromObject(mf).copyFrom(entry);
+                    if (addIndexEntry(index, pOldIndex, IndexKey_t(type, uint16_t(mf.id)), digest.add(entry, 0))) {
+                        minefields.append(entry);
+                    }
+                }
+            } else {
+                if (addIndexEntry(index, pOldIndex, IndexKey_t(type, getRecordId(type, payload, counters[type])), digest.add(payload, 0))) {
+                    if (isUpdatableRecord(type)) {
+                        updates.append(afl::base::fromObject(header));
+                        updates.append(payload);
+                    } else {
+                        ok = false;
+                    }
+                }
+            }
+        }
+
+        if (!minefields.empty()) {
+            header.blockType = dt::rMinefield;
+            header.size = static_cast<uint32_t>(minefields.size());
+            updates.append(afl::base::fromObject(header));
+            updates.append(minefields);
+        }
+        return ok;
+    }
+
+    /* Write index record. */
+    void writeIndex(afl::io::Stream& out, const Index_t& index, uint32_t baseSize)
+    {
+        RecordState rs;
+        startRecord(out, dt::rIndex, rs);
+
+        dt::IndexHeader ih;
+        ih.baseSize = baseSize;
+        ih.numEntries = static_cast<uint32_t>(index.size());
+        out.fullWrite(afl::base::fromObject(ih));
+
+        afl::base::GrowableMemory<dt::IndexEntry> entries;
+        for (Index_t::const_iterator it = index.begin(); it != index.end(); ++it) {
+            dt::IndexEntry e;
+            e.blockType = it->first.first;
+            e.id        = it->first.second;
+            e.checksum  = it->second;
+            entries.append(e);
+        }
+        out.fullWrite(entries.toBytes());
+
+        dt::UInt32_t pos;
+        pos = static_cast<uint32_t>(rs.headerPos);
+        out.fullWrite(pos.m_bytes);
+
+        endRecord(out, rs);
+    }
+
+    /* Load index record.
+       Returns false if the file has no valid index. */
+    bool loadIndex(afl::io::Stream& file, Index_t& index, uint32_t& baseSize, uint32_t& indexPos)
+    {
+        typedef afl::io::Stream::FileSize_t FileSize_t;
+
+        // Last four bytes point at the index record
+        const FileSize_t fileSize = file.getSize();
+        dt::UInt32_t rawPos;
+        if (fileSize < sizeof(dt::Header) + sizeof(rawPos)) {
+            return false;
+        }
+        file.setPos(fileSize - sizeof(rawPos));
+        if (file.read(rawPos.m_bytes) != sizeof(rawPos)) {
+            return false;
+        }
+        indexPos = rawPos;
+        if (indexPos < sizeof(dt::Header) || indexPos >= fileSize) {
+            return false;
+        }
+
+        // Index record must extend to the end of the file
+        dt::BlockHeader bh;
+        dt::IndexHeader ih;
+        file.setPos(indexPos);
+        if (file.read(afl::base::fromObject(bh)) != sizeof(bh)
+            || file.read(afl::base::fromObject(ih)) != sizeof(ih)
+            || bh.blockType != dt::rIndex
+            || FileSize_t(indexPos) + sizeof(bh) + bh.size != fileSize
+            || bh.size != sizeof(ih) + FileSize_t(sizeof(dt::IndexEntry)) * ih.numEntries + sizeof(rawPos)
+            || ih.baseSize > indexPos)
+        {
+            return false;
+        }
+
+        // Read entries
+        afl::base::GrowableMemory<dt::IndexEntry> entries;
+        entries.resize(ih.numEntries);
+        file.fullRead(entries.toBytes());
+        for (size_t i = 0, n = entries.size(); i < n; ++i) {
+            const dt::IndexEntry& e = *entries.at(i);
+            index[IndexKey_t(e.blockType, e.id)] = e.checksum;
+        }
+        baseSize = ih.baseSize;
+        return true;
+    }
 }
 
 // Constructor.
@@ -349,6 +554,10 @@ game::db::Loader::load(afl::io::Stream& in, Turn& turn, Game& game, bool acceptP
             break;
          }
 
+         case dt::rIndex:
+            // Only needed for update()
+            break;
+
          default:
             ++ignored_entries;
         }
@@ -529,6 +738,92 @@ game::db::Loader::save(afl::io::Stream& out, const Turn& turn, const Game& game,
     out.fullWrite(afl::base::fromObject(header));
 }
 
+// Save starchart database file with index.
+void
+game::db::Loader::saveIndexed(afl::io::Stream& out, const Turn& turn, const Game& game, const game::spec::ShipList& shipList)
+{
+    // Produce content in memory, to be able to index it
+    afl::io::InternalStream content;
+    save(content, turn, game, shipList);
+    const afl::base::ConstBytes_t data = content.getContent();
+    structures::Header header;
+    afl::base::fromObject(header).copyFrom(data);
+
+    Index_t index;
+    afl::base::GrowableBytes_t unused;
+    scanRecords(data.subrange(header.dataStart), index, 0, unused);
+
+    out.fullWrite(data);
+    writeIndex(out, index, static_cast<uint32_t>(out.getPos()));
+}
+
+// Update starchart database file.
+bool
+game::db::Loader::update(afl::io::Stream& file, const Turn& turn, const Game& game, const game::spec::ShipList& shipList)
+{
+    // Read existing index
+    Index_t oldIndex;
+    uint32_t baseSize = 0;
+    uint32_t indexPos = 0;
+    if (!loadIndex(file, oldIndex, baseSize, indexPos)) {
+        return false;
+    }
+
+    // Produce new content
+    afl::io::InternalStream content;
+    save(content, turn, game, shipList);
+    const afl::base::ConstBytes_t data = content.getContent();
+    structures::Header newHeader;
+    afl::base::fromObject(newHeader).copyFrom(data);
+    const size_t dataStart = newHeader.dataStart;
+
+    // Property names precede the records and cannot be updated; they must be unchanged.
+    // Of the header, only the turn number can change.
+    structures::Header oldHeader;
+    afl::base::GrowableBytes_t oldNames;
+    oldNames.resize(dataStart - sizeof(oldHeader));
+    file.setPos(0);
+    if (file.read(afl::base::fromObject(oldHeader)) != sizeof(oldHeader)
+        || file.read(oldNames) != oldNames.size())
+    {
+        return false;
+    }
+    oldHeader.turnNumber = newHeader.turnNumber;
+    if (!afl::base::fromObject(oldHeader).equalContent(afl::base::fromObject(newHeader))
+        || !oldNames.equalContent(data.subrange(sizeof(newHeader), oldNames.size())))
+    {
+        return false;
+    }
+
+    // Determine changed records
+    Index_t newIndex;
+    afl::base::GrowableBytes_t updates;
+    if (!scanRecords(data.subrange(dataStart), newIndex, &oldIndex, updates)) {
+        return false;
+    }
+
+    // Removed objects cannot be represented by an update
+    for (Index_t::const_iterator it = oldIndex.begin(); it != oldIndex.end(); ++it) {
+        if (newIndex.find(it->first) == newIndex.end()) {
+            return false;
+        }
+    }
+
+    // Compact the file if it accumulated too many updates
+    if (uint64_t(indexPos - baseSize) + updates.size() > uint64_t(baseSize) * MAX_UPDATE_PERCENT / 100) {
+        return false;
+    }
+
+    // Write header (turn number), updates, and new index.
+    // The new index has at least as many entries as the old one, so the file does not shrink.
+    file.setPos(0);
+    file.fullWrite(afl::base::fromObject(newHeader));
+    file.setPos(indexPos);
+    file.fullWrite(updates);
+    writeIndex(file, newIndex, baseSize);
+    return true;
+}
+
 inline afl::sys::LogListener&
 game::db::Loader::log()
 {
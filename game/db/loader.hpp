@@ -46,6 +46,29 @@ namespace game { namespace db {
             \param shipList Ship list (required for hull definitions / ship masses) */
         void save(afl::io::Stream& out, const Turn& turn, const Game& game, const game::spec::ShipList& shipList);
 
+        /** Save starchart database file with index.
+            Writes the same content as save(), followed by an index record that allows later updates using update().
+            The file remains readable by programs that do not know the index record.
+            \param out Stream to write to; should be positioned at the beginning of an empty file
+            \param turn Turn to save
+            \param game Game to read (required for score definitions)
+            \param shipList Ship list (required for hull definitions / ship masses) */
+        void saveIndexed(afl::io::Stream& out, const Turn& turn, const Game& game, const game::spec::ShipList& shipList);
+
+        /** Update starchart database file.
+            If the file has been written by saveIndexed(), appends only the records that changed since,
+            followed by a new index.
+            This is not possible if records have been removed or records that cannot be merged on load (drawings, properties) have changed,
+            or if the file would grow too large (compaction).
+            In this case, the file is not modified, and the caller must rewrite it using saveIndexed().
+            \param file Stream to update, opened for reading and writing
+            \param turn Turn to save
+            \param game Game to read (required for score definitions)
+            \param shipList Ship list (required for hull definitions / ship masses)
+            \retval true File has been updated
+            \retval false File cannot be updated; no change */
+        bool update(afl::io::Stream& file, const Turn& turn, const Game& game, const game::spec::ShipList& shipList);
+
      private:
         enum Scope {
             ShipScope,
@@ -59,6 +59,9 @@ namespace game { namespace db { namespace structures {
     // PCC 1.1.7+:
     const uint16_t rUfoHistory     = 12;
 
+    // c2ng:
+    const uint16_t rIndex          = 13;
+
     /// Planet history record (rPlanetHistory, 1).
     struct Planet {
         game::v3::structures::Planet planet;                    ///< Planet data.
@@ -165,6 +168,24 @@ namespace game { namespace db { namespace structures {
     };
     static_assert(sizeof(Ufo) == 94, "sizeof Ufo");
 
+    /** Index header (rIndex, 13).
+        The index is always the last record of the file.
+        It is followed by IndexHeader::numEntries IndexEntry's, and the file position of the record's BlockHeader (UInt32_t). */
+    struct IndexHeader {
+        UInt32_t    baseSize;                                   ///< Size of completely-written part of file; records after that are updates.
+        UInt32_t    numEntries;                                 ///< Number of IndexEntry's that follow.
+    };
+    static_assert(sizeof(IndexHeader) == 8, "sizeof IndexHeader");
+
+    /** Index entry (part of rIndex, 13).
+        Describes the most recent content for one object. */
+    struct IndexEntry {
+        UInt16_t    blockType;                                  ///< Record type.
+        UInt16_t    id;                                         ///< Object Id, or sequence number for records without Id.
+        UInt32_t    checksum;                                   ///< Checksum of content (util::Digest).
+    };
+    static_assert(sizeof(IndexEntry) == 8, "sizeof IndexEntry");
+
 } } }
 
 #endif
@@ -0,0 +1,364 @@
+/**
+  *  \file game/interface/snapshotsearch.cpp
+  *  \brief Snapshot-based object search
+  */
+
+#include <memory>
+#include "game/interface/snapshotsearch.hpp"
+#include "afl/base/deleter.hpp"
+#include "afl/data/stringvalue.hpp"
+#include "afl/string/parse.hpp"
+#include "afl/string/string.hpp"
+#include "interpreter/binaryexecution.hpp"
+#include "interpreter/binaryoperation.hpp"
+#include "interpreter/callablevalue.hpp"
+#include "interpreter/error.hpp"
+#include "interpreter/expr/parser.hpp"
+#include "interpreter/propertysnapshot.hpp"
+#include "interpreter/snapshotexpression.hpp"
+#include "interpreter/tokenizer.hpp"
+#include "interpreter/values.hpp"
+
+using game::Reference;
+using game::SearchQuery;
+using interpreter::PropertySnapshot;
+
+namespace {
+    /* Local variable names of CCUI$Search and the match function.
+       An unqualified identifier in the query that is not an object property would refer to these. */
+    const char*const LOCAL_NAMES[] = { "OBJ", "FLAGS", "MATCH", "OWN", "RESULT", "HASOBJECTS" };
+
+    /* Maximum number of columns to keep in a cached snapshot.
+       Each query can add columns; if it becomes too many, start over with only the current query's columns. */
+    const size_t MAX_COLUMNS = 50;
+
+    /*
+     *  Matcher: evaluates the query for one snapshot row.
+     *  Mirrors the code generated by SearchQuery::compileExpression(); all interpreter errors mean "no match".
+     */
+    class Matcher {
+     public:
+        virtual ~Matcher()
+            { }
+        virtual bool match(size_t row) const = 0;
+    };
+
+    /* Empty query: "Try Return Not IsEmpty(obj->Owner$)", else return true. */
+    class AnyMatcher : public Matcher {
+     public:
+        AnyMatcher(PropertySnapshot& snap)
+            : m_snapshot(snap), m_ownerColumn(snap.addColumn("OWNER$"))
+            { }
+        virtual bool match(size_t row) const
+            { return m_snapshot.getState(row, m_ownerColumn) != PropertySnapshot::Empty; }
+     private:
+        const PropertySnapshot& m_snapshot;
+        PropertySnapshot::Column_t m_ownerColumn;
+    };
+
+    /* Name query: Id, Name, Comment. */
+    class NameMatcher : public Matcher {
+     public:
+        NameMatcher(PropertySnapshot& snap, interpreter::World& world, const String_t& expr)
+            : m_snapshot(snap), m_world(world),
+              m_hasId(false), m_id(0), m_idColumn(snap.addColumn("ID")),
+              m_nameColumn(snap.addColumn("NAME")),
+              m_commentColumn(snap.addColumn("COMMENT")),
+              m_text(afl::string::strUCase(expr))
+            {
+                m_hasId = afl::string::strToInteger(expr, m_id)
+                    || (expr[0] == '#' && afl::string::strToInteger(expr.substr(1), m_id));
+            }
+        virtual bool match(size_t row) const
+            {
+                if (m_hasId && m_snapshot.getState(row, m_idColumn) == PropertySnapshot::Integer && m_snapshot.getInteger(row, m_idColumn) == m_id) {
+                    return true;
+                }
+                return matchText(row, m_nameColumn) || matchText(row, m_commentColumn);
+            }
+     private:
+        const PropertySnapshot& m_snapshot;
+        interpreter::World& m_world;
+        bool m_hasId;
+        int m_id;
+        PropertySnapshot::Column_t m_idColumn;
+        PropertySnapshot::Column_t m_nameColumn;
+        PropertySnapshot::Column_t m_commentColumn;
+        afl::data::StringValue m_text;
+
+        bool matchText(size_t row, PropertySnapshot::Column_t col) const
+            {
+                switch (m_snapshot.getState(row, col)) {
+                 case PropertySnapshot::Missing:
+                 case PropertySnapshot::Failed:
+                 case PropertySnapshot::Empty:
+                    return false;
+                 case PropertySnapshot::Integer:
+                 case PropertySnapshot::Other:
+                    try {
+                        std::auto_ptr<afl::data::Value> result(interpreter::executeBinaryOperation(m_world, interpreter::biFindStr_NC, m_snapshot.getValue(row, col), &m_text));
+                        return interpreter::getBooleanValue(result.get()) > 0;
+                    }
+                    catch (interpreter::Error&) {
+                        return false;
+                    }
+                }
+                return false;
+            }
+    };
+
+    /* Expression query: "With obj Do If [Not] <expr> Then Return True". */
+    class ExpressionMatcher : public Matcher {
+     public:
+        ExpressionMatcher(interpreter::SnapshotExpression* expr, bool negate)
+            : m_expression(expr), m_negate(negate)
+            { }
+        virtual bool match(size_t row) const
+            {
+                try {
+                    int result = m_expression->evaluateCondition(row);
+                    return m_negate ? result <= 0 : result > 0;
+                }
+                catch (interpreter::Error&) {
+                    return false;
+                }
+            }
+     private:
+        std::auto_ptr<interpreter::SnapshotExpression> m_expression;
+        bool m_negate;
+    };
+
+    /* Create matcher for a query. Returns null if query is not supported. */
+    Matcher* makeMatcher(const SearchQuery& q, PropertySnapshot& snap, interpreter::World& world)
+    {
+        String_t expr = afl::string::strTrim(q.getQuery());
+        if (expr.empty()) {
+            return new AnyMatcher(snap);
+        }
+        switch (q.getMatchType()) {
+         case SearchQuery::MatchName:
+            return new NameMatcher(snap, world, expr);
+
+         case SearchQuery::MatchTrue:
+         case SearchQuery::MatchFalse:
+            try {
+                interpreter::Tokenizer tok(expr);
+                afl::base::Deleter del;
+                const interpreter::expr::Node& node(interpreter::expr::Parser(tok, del).parse());
+                if (tok.getCurrentToken() != interpreter::Tokenizer::tEnd) {
+                    return 0;
+                }
+                if (interpreter::SnapshotExpression* p = interpreter::SnapshotExpression::compile(node, snap, interpreter::CompilationContext(world), LOCAL_NAMES)) {
+                    return new ExpressionMatcher(p, q.getMatchType() == SearchQuery::MatchFalse);
+                }
+            }
+            catch (interpreter::Error&) {
+                // Syntax error; let SearchQuery::compile() report it
+            }
+            return 0;
+
+         case SearchQuery::MatchLocation:
+            // Uses ObjectIsAt(), which is a function call
+            return 0;
+        }
+        return 0;
+    }
+
+    /* Check a filter property (Played, Base.YesNo).
+       Returns 1 if true, 0 if false or empty, -1 if CCUI$Search would fail. */
+    int checkFilter(const PropertySnapshot& snap, size_t row, PropertySnapshot::Column_t col)
+    {
+        switch (snap.getState(row, col)) {
+         case PropertySnapshot::Missing:
+         case PropertySnapshot::Failed:
+            return -1;
+         case PropertySnapshot::Empty:
+            return 0;
+         case PropertySnapshot::Integer:
+            return snap.getInteger(row, col) != 0;
+         case PropertySnapshot::Other:
+            return interpreter::getBooleanValue(snap.getValue(row, col)) > 0;
+        }
+        return -1;
+    }
+
+    /* Search one object type, as one "ForEach" loop of CCUI$Search.
+       Returns false if the search is not supported. */
+    bool searchType(const SearchQuery& q, interpreter::World& world, game::interface::SnapshotCache& cache, const char* globalName, Reference::Type type, bool ownOnly, bool basesOnly, game::ref::List& result, bool& hasObjects)
+    {
+        // Set up columns. Query columns first, so the matcher can pick its columns.
+        PropertySnapshot& snap = cache.getSnapshot(globalName);
+        if (snap.getNumColumns() > MAX_COLUMNS) {
+            snap.clear();
+        }
+        const size_t numCachedColumns = snap.getNumColumns();
+        std::auto_ptr<Matcher> matcher(makeMatcher(q, snap, world));
+        if (matcher.get() == 0) {
+            return false;
+        }
+        const PropertySnapshot::Column_t idColumn = snap.addColumn("ID");
+        const PropertySnapshot::Column_t playedColumn = snap.addColumn("PLAYED");
+        const PropertySnapshot::Column_t baseColumn = snap.addColumn("BASE.YESNO");
+
+        // Extract all objects, unless the cached snapshot already has them with all required columns
+        if (snap.getNumRows() == 0 || snap.getNumColumns() != numCachedColumns) {
+            snap.clearRows();
+            interpreter::CallableValue* cv = dynamic_cast<interpreter::CallableValue*>(world.getGlobalValue(globalName));
+            if (cv == 0) {
+                return false;
+            }
+            std::auto_ptr<interpreter::Context> ctx;
+            try {
+                ctx.reset(cv->makeFirstContext());
+                if (ctx.get() != 0) {
+                    do {
+                        snap.addRow(*ctx);
+                    } while (ctx->next());
+                }
+            }
+            catch (interpreter::Error&) {
+                snap.clearRows();
+                return false;
+            }
+        }
+
+        // Evaluate
+        std::vector<game::Id_t> ids;
+        for (size_t row = 0, n = snap.getNumRows(); row < n; ++row) {
+            // Filter: "If (Not own Or obj->Played) [And obj->Base.YesNo]"
+            if (ownOnly) {
+                int played = checkFilter(snap, row, playedColumn);
+                if (played < 0) {
+                    return false;
+                }
+                if (played == 0) {
+                    continue;
+                }
+            }
+            if (basesOnly) {
+                int base = checkFilter(snap, row, baseColumn);
+                if (base < 0) {
+                    return false;
+                }
+                if (base == 0) {
+                    continue;
+                }
+            }
+            hasObjects = true;
+
+            // Match
+            if (matcher->match(row)) {
+                if (snap.getState(row, idColumn) != PropertySnapshot::Integer) {
+                    return false;
+                }
+                ids.push_back(snap.getInteger(row, idColumn));
+            }
+        }
+        result.add(type, ids);
+        return true;
+    }
+}
+
+/*
+ *  SnapshotCache
+ */
+
+game::interface::SnapshotCache::SnapshotCache()
+    : m_snapshots(),
+      m_turn(),
+      conn_universeChange()
+{ }
+
+game::interface::SnapshotCache::~SnapshotCache()
+{ }
+
+void
+game::interface::SnapshotCache::setTurn(Turn* turn)
+{
+    if (turn != m_turn.get()) {
+        invalidate();
+        conn_universeChange.disconnect();
+        m_turn = turn;
+        if (turn != 0) {
+            conn_universeChange = turn->universe().sig_universeChange.add(this, &SnapshotCache::invalidate);
+        }
+    }
+}
+
+void
+game::interface::SnapshotCache::invalidate()
+{
+    for (afl::container::PtrMap<String_t, PropertySnapshot>::iterator it = m_snapshots.begin(); it != m_snapshots.end(); ++it) {
+        if (PropertySnapshot* p = it->second) {
+            p->clearRows();
+        }
+    }
+}
+
+interpreter::PropertySnapshot&
+game::interface::SnapshotCache::getSnapshot(const String_t& name)
+{
+    PropertySnapshot* p = m_snapshots[name];
+    if (p == 0) {
+        p = new PropertySnapshot();
+        m_snapshots.insertNew(name, p);
+    }
+    return *p;
+}
+
+
+/*
+ *  searchSnapshot
+ */
+
+bool
+game::interface::searchSnapshot(const SearchQuery& q, interpreter::World& world, game::ref::List& result)
+{
+    SnapshotCache cache;
+    return searchSnapshot(q, world, cache, result);
+}
+
+bool
+game::interface::searchSnapshot(const SearchQuery& q, interpreter::World& world, SnapshotCache& cache, game::ref::List& result)
+{
+    // Same order and filters as CCUI$Search
+    const SearchQuery::SearchObjects_t objs = q.getSearchObjects();
+    const bool own = q.getPlayedOnly();
+    game::ref::List list;
+    bool hasObjects = false;
+    if (objs.contains(SearchQuery::SearchPlanets)) {
+        if (!searchType(q, world, cache, "PLANET", Reference::Planet, own, false, list, hasObjects)) {
+            return false;
+        }
+    } else if (objs.contains(SearchQuery::SearchBases)) {
+        if (!searchType(q, world, cache, "PLANET", Reference::Starbase, own, true, list, hasObjects)) {
+            return false;
+        }
+    }
+    if (objs.contains(SearchQuery::SearchShips)) {
+        if (!searchType(q, world, cache, "SHIP", Reference::Ship, own, false, list, hasObjects)) {
+            return false;
+        }
+    }
+    if (objs.contains(SearchQuery::SearchUfos) && !own) {
+        if (!searchType(q, world, cache, "UFO", Reference::Ufo, false, false, list, hasObjects)) {
+            return false;
+        }
+    }
+    if (objs.contains(SearchQuery::SearchOthers) && !own) {
+        if (!searchType(q, world, cache, "MINEFIELD", Reference::Minefield, false, false, list, hasObjects)
+            || !searchType(q, world, cache, "STORM", Reference::IonStorm, false, false, list, hasObjects))
+        {
+            return false;
+        }
+    }
+
+    if (!hasObjects) {
+        // CCUI$Search produces a message in this case
+        return false;
+    }
+    for (size_t i = 0, n = list.size(); i < n; ++i) {
+        result.add(list[i]);
+    }
+    return true;
+}
@@ -0,0 +1,84 @@
+/**
+  *  \file game/interface/snapshotsearch.hpp
+  *  \brief Snapshot-based object search
+  */
+#ifndef C2NG_GAME_INTERFACE_SNAPSHOTSEARCH_HPP
+#define C2NG_GAME_INTERFACE_SNAPSHOTSEARCH_HPP
+
+#include "afl/base/ptr.hpp"
+#include "afl/base/signalconnection.hpp"
+#include "afl/container/ptrmap.hpp"
+#include "game/ref/list.hpp"
+#include "game/searchquery.hpp"
+#include "game/turn.hpp"
+#include "interpreter/propertysnapshot.hpp"
+#include "interpreter/world.hpp"
+
+namespace game { namespace interface {
+
+    /** Cache of property snapshots for searchSnapshot().
+
+        Keeps the snapshot of each object type between searches.
+        Repeated searches (e.g. search-as-you-type) therefore only extract objects again
+        if the universe has changed or a query needs properties that have not been extracted yet. */
+    class SnapshotCache {
+     public:
+        /** Constructor.
+            Makes an empty cache. */
+        SnapshotCache();
+
+        /** Destructor. */
+        ~SnapshotCache();
+
+        /** Set turn.
+            Snapshots are valid for one turn's universe.
+            If the turn differs from the previous call, the cache is invalidated.
+            While a turn is set, the cache is invalidated whenever its universe reports a change.
+            \param turn Turn (the one the object iterators refer to, i.e. Game::viewpointTurn()); can be null */
+        void setTurn(Turn* turn);
+
+        /** Invalidate.
+            Discards all extracted objects. */
+        void invalidate();
+
+        /** Get snapshot for an object type.
+            Creates an empty snapshot if none exists yet.
+            \param name Name of object type (name of global iterator, e.g. "SHIP")
+            \return snapshot */
+        interpreter::PropertySnapshot& getSnapshot(const String_t& name);
+
+     private:
+        afl::container::PtrMap<String_t, interpreter::PropertySnapshot> m_snapshots;
+        afl::base::Ptr<Turn> m_turn;
+        afl::base::SignalConnection conn_universeChange;
+    };
+
+    /** Execute a search query using property snapshots.
+
+        Produces the same result as running the code produced by SearchQuery::compile() (i.e. CCUI$Search),
+        but evaluates the query without an interpreter process.
+        For each object type, all properties required by the query are extracted once into an interpreter::PropertySnapshot,
+        and the query is evaluated on that.
+
+        Queries that cannot be evaluated this way (location queries, function calls, etc.),
+        situations where CCUI$Search would fail, and searches that find no candidate objects at all are not handled.
+        In this case, the caller must use the regular interpreter path, which will also produce the appropriate messages.
+
+        \param [in]     q      Query
+        \param [in]     world  World (provides object iterators and global values)
+        \param [in,out] cache  Snapshot cache. Snapshots are taken from here if possible, and updated as needed.
+        \param [out]    result Result list (appended to; unchanged if the function returns false)
+        \retval true  Search completed, \c result has been updated (result may be empty if no object matches)
+        \retval false Search not possible, use SearchQuery::compile() */
+    bool searchSnapshot(const SearchQuery& q, interpreter::World& world, SnapshotCache& cache, game::ref::List& result);
+
+    /** Execute a search query using property snapshots, without cache.
+        \param [in]  q      Query
+        \param [in]  world  World (provides object iterators and global values)
+        \param [out] result Result list (appended to; unchanged if the function returns false)
+        \return see searchSnapshot(const SearchQuery&, interpreter::World&, SnapshotCache&, game::ref::List&) */
+    bool searchSnapshot(const SearchQuery& q, interpreter::World& world, game::ref::List& result);
+
+} }
+
+#endif
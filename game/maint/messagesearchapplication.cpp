@@ -8,18 +8,26 @@
 
 #include "game/maint/messagesearchapplication.hpp"
 #include "afl/base/inlinememory.hpp"
+#include "afl/base/runnable.hpp"
 #include "afl/charset/codepage.hpp"
 #include "afl/charset/codepagecharset.hpp"
 #include "afl/checksums/bytesum.hpp"
 #include "afl/except/fileformatexception.hpp"
-#include "afl/except/fileproblemexception.hpp"
 #include "afl/io/archive/zipreader.hpp"
+#include "afl/io/constmemorystream.hpp"
 #include "afl/io/directory.hpp"
 #include "afl/io/directoryentry.hpp"
+#include "afl/io/filemapping.hpp"
 #include "afl/io/internalstream.hpp"
+#include "afl/io/internaltextwriter.hpp"
 #include "afl/io/limitedstream.hpp"
 #include "afl/string/format.hpp"
+#include "afl/string/parse.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/semaphore.hpp"
 #include "afl/sys/standardcommandlineparser.hpp"
+#include "afl/sys/thread.hpp"
 #include "game/playerlist.hpp"
 #include "game/v3/inboxfile.hpp"
 #include "game/v3/outboxreader.hpp"
@@ -261,6 +269,103 @@ namespace {
         return UnknownFile;
     }
 
+
+    /*************************** Literal Prefilter ***************************/
+
+    /** Literal prefilter for encoded message text.
+
+        Decoding a message (rot13, character set conversion, header tweaks) is much more expensive than
+        finding out that it does not contain the search string, which is the common case when grepping archives.
+        This scans the encoded message data for the search string directly,
+        using a Horspool search over a table that maps each encoded byte to the (case-folded) character it decodes to.
+
+        The prefilter is conservative: it may accept messages that do not match, but never rejects one that does.
+        It is therefore only enabled for search strings consisting of printable ASCII characters
+        (which the game character set maps to themselves),
+        and does not judge messages that will be re-wrapped by decodeMessage(). */
+    class Prefilter {
+     public:
+        /** Constructor.
+            \param query     Search string, upper-case if !caseSense
+            \param caseSense true for case-sensitive search
+            \param cs        Game character set */
+        Prefilter(const String_t& query, bool caseSense, afl::charset::Charset& cs);
+
+        /** Check whether encoded message data may match.
+            \param data Message data as stored in file
+            \return false if message definitely does not match */
+        bool mayMatch(afl::base::ConstBytes_t data) const;
+
+     private:
+        bool m_enabled;
+        String_t m_pattern;
+        uint8_t m_fold[256];
+        size_t m_skip[256];
+    };
+
+    Prefilter::Prefilter(const String_t& query, bool caseSense, afl::charset::Charset& cs)
+        : m_enabled(!query.empty()),
+          m_pattern(query)
+    {
+        // Verify that the query is plain, printable ASCII that is not recoded
+        for (size_t i = 0; i < query.size(); ++i) {
+            if (query[i] < 0x20 || query[i] > 0x7E) {
+                m_enabled = false;
+            }
+        }
+        afl::base::GrowableBytes_t encoded = cs.encode(afl::string::toMemory(query));
+        if (m_enabled && !afl::base::ConstBytes_t(encoded).equalContent(afl::string::toBytes(query))) {
+            m_enabled = false;
+        }
+
+        // Folding table: encoded byte -> decoded character; 0 for everything that cannot be part of a match
+        for (size_t i = 0; i < 256; ++i) {
+            uint8_t ch = uint8_t(i - 13);
+            if (ch < 0x20 || ch > 0x7E) {
+                ch = 0;
+            } else if (!caseSense && ch >= 'a' && ch <= 'z') {
+                ch = uint8_t(ch - 'a' + 'A');
+            }
+            m_fold[i] = ch;
+        }
+
+        // Skip table (indexed by folded character)
+        const size_t n = m_pattern.size();
+        for (size_t i = 0; i < 256; ++i) {
+            m_skip[i] = n;
+        }
+        for (size_t i = 0; i+1 < n; ++i) {
+            m_skip[uint8_t(m_pattern[i])] = n-1-i;
+        }
+    }
+
+    bool Prefilter::mayMatch(afl::base::ConstBytes_t data) const
+    {
+        // Re-wrapped messages drop CRs, so a match could span an encoded line break.
+        if (!m_enabled || data.find(10+13) != data.size()) {
+            return true;
+        }
+
+        const size_t n = m_pattern.size();
+        const size_t size = data.size();
+        size_t pos = 0;
+        while (pos + n <= size) {
+            const uint8_t last = m_fold[*data.at(pos + n-1)];
+            size_t i = n-1;
+            while (m_fold[*data.at(pos + i)] == uint8_t(m_pattern[i])) {
+                if (i == 0) {
+                    return true;
+                }
+                --i;
+            }
+            pos += m_skip[last];
+        }
+        return false;
+    }
+
+
+    /**************************** Message Search *****************************/
+
     struct Message {
         String_t text;
         String_t header;
@@ -274,10 +379,11 @@ namespace {
         afl::charset::Charset& cs;
         afl::io::TextWriter& out;
         afl::string::Translator& tx;
+        const Prefilter& prefilter;
 
-        Message(afl::charset::Charset& cs, afl::io::TextWriter& out, afl::string::Translator& tx)
+        Message(afl::charset::Charset& cs, afl::io::TextWriter& out, afl::string::Translator& tx, const Prefilter& prefilter)
             : turn(0), index(0), optCaseSense(false),
-              cs(cs), out(out), tx(tx)
+              cs(cs), out(out), tx(tx), prefilter(prefilter)
             { }
         void search();
     };
@@ -334,10 +440,13 @@ namespace {
     void searchInbox(Message& m, afl::io::Stream& s)
     {
         game::v3::InboxFile inbox(s, m.cs, m.tx);
+        afl::base::GrowableBytes_t data;
         for (size_t i = 0, n = inbox.getNumMessages(); i < n; ++i) {
-            m.text = inbox.loadMessage(i);
-            m.index = int(i+1);
-            m.search();
+            if (inbox.loadMessageData(i, data) && m.prefilter.mayMatch(data)) {
+                m.text = inbox.decodeMessageData(data);
+                m.index = int(i+1);
+                m.search();
+            }
         }
     }
 
@@ -392,13 +501,15 @@ namespace {
             {
                 // data contains [from, to, message...]
                 afl::base::ConstBytes_t data = trn.getCommandData(i);
-                gt::Int16_t to;
-                to = 0;
-                afl::base::fromObject(to).copyFrom(data.subrange(2, 2));
-                m.text = game::v3::decodeMessage(data.subrange(4, size), m.cs, true);
-                m.header = Format("FROM: Player %d\nTO: Player %d\n", trn.getPlayer(), int(to));
                 ++m.index;
-                m.search();
+                if (m.prefilter.mayMatch(data.subrange(4, size))) {
+                    gt::Int16_t to;
+                    to = 0;
+                    afl::base::fromObject(to).copyFrom(data.subrange(2, 2));
+                    m.text = game::v3::decodeMessage(data.subrange(4, size), m.cs, true);
+                    m.header = Format("FROM: Player %d\nTO: Player %d\n", trn.getPlayer(), int(to));
+                    m.search();
+                }
             }
         }
     }
@@ -486,6 +597,69 @@ struct game::maint::MessageSearchApplication::Job {
         { }
 };
 
+/* A file to search.
+   Each task has its own copy of the job (in particular, the character set),
+   and collects its output so it can be produced in command-line order when searching in parallel. */
+struct game::maint::MessageSearchApplication::Task {
+    String_t fileName;
+    Job job;
+    afl::io::InternalTextWriter out;
+    afl::io::InternalTextWriter err;
+    bool done;
+
+    Task(const String_t& fileName, const Job& job)
+        : fileName(fileName), job(job), out(), err(), done(false)
+        { }
+};
+
+/* Worker thread for parallel search.
+   Workers take tasks in order. A worker needs a slot to start a task;
+   the main thread releases a slot whenever it has written out a task's output.
+   This limits the amount of buffered output. */
+class game::maint::MessageSearchApplication::Worker : public afl::base::Runnable {
+ public:
+    Worker(MessageSearchApplication& parent, afl::container::PtrVector<Task>& tasks, size_t& next,
+           afl::sys::Mutex& mutex, afl::sys::Semaphore& slots, afl::sys::Semaphore& finished)
+        : m_parent(parent), m_tasks(tasks), m_next(next), m_mutex(mutex), m_slots(slots), m_finished(finished)
+        { }
+
+    virtual void run()
+        {
+            while (1) {
+                // Obtain a slot and a task
+                m_slots.wait();
+                Task* t = 0;
+                {
+                    afl::sys::MutexGuard g(m_mutex);
+                    if (m_next < m_tasks.size()) {
+                        t = m_tasks[m_next++];
+                    }
+                }
+                if (t == 0) {
+                    // No more tasks; give the slot to the next worker so it can find out, too.
+                    m_slots.post();
+                    break;
+                }
+
+                // Process it
+                m_parent.searchFile(t->fileName, t->job, t->out, t->err);
+                {
+                    afl::sys::MutexGuard g(m_mutex);
+                    t->done = true;
+                }
+                m_finished.post();
+            }
+        }
+
+ private:
+    MessageSearchApplication& m_parent;
+    afl::container::PtrVector<Task>& m_tasks;
+    size_t& m_next;
+    afl::sys::Mutex& m_mutex;
+    afl::sys::Semaphore& m_slots;
+    afl::sys::Semaphore& m_finished;
+};
+
 
 void
 game::maint::MessageSearchApplication::appMain()
@@ -494,10 +668,11 @@ game::maint::MessageSearchApplication::appMain()
 
     // Arguments
     bool hadSearchString = false;
-    bool hadFiles = false;
+    size_t numThreads = 1;
     Job job;
+    afl::container::PtrVector<Task> tasks;
 
-    // Parse and search
+    // Parse
     afl::sys::StandardCommandLineParser parser(environment().getCommandLine());
     String_t text;
     bool option;
@@ -515,6 +690,12 @@ game::maint::MessageSearchApplication::appMain()
                 if (job.charset.get() == 0) {
                     errorExit(tx("the specified character set is not known"));
                 }
+            } else if (text == "j") {
+                // Fetch number of threads
+                String_t param;
+                if (!parser.getParameter(param) || !afl::string::strToInteger(param, numThreads) || numThreads == 0) {
+                    errorExit(tx("option '-j' needs an argument (the number of files to search in parallel)"));
+                }
             } else if (text == "r") {
                 job.optFileType = ResultFile;
             } else if (text == "t") {
@@ -547,22 +728,73 @@ game::maint::MessageSearchApplication::appMain()
             job.query = text;
             hadSearchString = true;
         } else {
-            searchFile(text, job);
-            hadFiles = true;
+            tasks.pushBackNew(new Task(text, job));
         }
     }
 
     if (!hadSearchString) {
         errorExit(Format(tx("no search string specified. Use '%s -h' for help").c_str(), environment().getInvocationName()));
     }
-    if (!hadFiles) {
+    if (tasks.empty()) {
         errorExit(Format(tx("no file name specified. Use '%s -h' for help").c_str(), environment().getInvocationName()));
     }
+
+    // Search
+    if (numThreads <= 1) {
+        for (size_t i = 0, n = tasks.size(); i < n; ++i) {
+            searchFile(tasks[i]->fileName, tasks[i]->job, standardOutput(), errorOutput());
+        }
+    } else {
+        searchParallel(tasks, numThreads);
+    }
 }
 
+void
+game::maint::MessageSearchApplication::searchParallel(afl::container::PtrVector<Task>& tasks, size_t numThreads)
+{
+    // Shared state
+    size_t next = 0;
+    afl::sys::Mutex mutex;
+    afl::sys::Semaphore slots(int(2*numThreads));
+    afl::sys::Semaphore finished(0);
+
+    // Start workers
+    afl::container::PtrVector<Worker> workers;
+    afl::container::PtrVector<afl::sys::Thread> threads;
+    for (size_t i = 0; i < numThreads; ++i) {
+        Worker& w = *workers.pushBackNew(new Worker(*this, tasks, next, mutex, slots, finished));
+        threads.pushBackNew(new afl::sys::Thread("game.maint.search", w))->start();
+    }
+
+    // Produce output in order
+    for (size_t i = 0, n = tasks.size(); i < n; ++i) {
+        while (1) {
+            {
+                afl::sys::MutexGuard g(mutex);
+                if (tasks[i]->done) {
+                    break;
+                }
+            }
+            finished.wait();
+        }
+
+        standardOutput().writeText(afl::string::fromMemory(tasks[i]->out.getContent()));
+        errorOutput().writeText(afl::string::fromMemory(tasks[i]->err.getContent()));
+        {
+            afl::sys::MutexGuard g(mutex);
+            tasks.replaceElementNew(i, 0);
+        }
+        slots.post();
+    }
+
+    // Finish
+    for (size_t i = 0, n = threads.size(); i < n; ++i) {
+        threads[i]->join();
+    }
+}
 
 void
-game::maint::MessageSearchApplication::searchZip(afl::io::Stream& file, String_t fname, const Job& job)
+game::maint::MessageSearchApplication::searchZip(afl::io::Stream& file, String_t fname, const Job& job, afl::io::TextWriter& out, afl::io::TextWriter& err)
 {
     // Construct sub-job as modified version of existing job
     Job subjob(job);
@@ -584,22 +816,24 @@ game::maint::MessageSearchApplication::searchZip(afl::io::Stream& file, String_t
                 contentStream->setWritePermission(false);
                 entryStream.reset(*contentStream);
             }
-            searchStream(*entryStream, Format("%s(%s)", fname, zipEntry->getTitle()), subjob);
+            searchStream(*entryStream, Format("%s(%s)", fname, zipEntry->getTitle()), subjob, out, err);
         }
     }
 }
 
 void
-game::maint::MessageSearchApplication::searchStream(afl::io::Stream& file, const String_t& fname, const Job& job)
+game::maint::MessageSearchApplication::searchStream(afl::io::Stream& file, const String_t& fname, const Job& job, afl::io::TextWriter& out, afl::io::TextWriter& err)
 {
     afl::string::Translator& tx = translator();
 
     FileType type = job.optFileType == UnknownFile ? identifyFile(file) : job.optFileType;
 
-    Message m(*job.charset, standardOutput(), translator());
+    String_t query = job.optCaseSense ? job.query : afl::string::strUCase(job.query);
+    Prefilter prefilter(query, job.optCaseSense, *job.charset);
+    Message m(*job.charset, out, translator(), prefilter);
     m.file = fname;
     m.optCaseSense = job.optCaseSense;
-    m.query = job.optCaseSense ? job.query : afl::string::strUCase(job.query);
+    m.query = query;
 
     switch (type) {
      case TurnFile:
@@ -622,31 +856,33 @@ game::maint::MessageSearchApplication::searchStream(afl::io::Stream& file, const
         break;
      case ZipArchive:
         if (job.optAllowZip) {
-            searchZip(file, fname, job);
+            searchZip(file, fname, job, out, err);
         } else {
-            errorOutput().writeLine(Format(tx("%s: compressed file").c_str(), fname));
+            err.writeLine(Format(tx("%s: compressed file").c_str(), fname));
         }
         break;
      case UnknownFile:
         if (job.optWarnUnknown) {
-            errorOutput().writeLine(Format(tx("%s: unknown file format").c_str(), fname));
+            err.writeLine(Format(tx("%s: unknown file format").c_str(), fname));
         }
         break;
     }
 }
 
 void
-game::maint::MessageSearchApplication::searchFile(const String_t& fname, const Job& job)
+game::maint::MessageSearchApplication::searchFile(const String_t& fname, const Job& job, afl::io::TextWriter& out, afl::io::TextWriter& err)
 {
     try {
-        afl::base::Ref<afl::io::Stream> file = fileSystem().openFile(fname, afl::io::FileSystem::OpenRead);
-        searchStream(*file, fname, job);
-    }
-    catch (afl::except::FileProblemException& ex) {
-        errorOutput().writeLine(Format("%s: %s", ex.getFileName(), ex.what()));
+        // Search a memory mapping of the file.
+        // This avoids a system call for every little read; ZIP members and the message directory require many of those.
+        // The stream is allocated as a Ref<> because LimitedStream and ZipReader want one.
+        afl::base::Ref<afl::io::FileMapping> content = fileSystem().openFile(fname, afl::io::FileSystem::OpenRead)->createVirtualMapping();
+        afl::base::Ref<afl::io::ConstMemoryStream> file = *new afl::io::ConstMemoryStream(content->get());
+        searchStream(*file, fname, job, out, err);
     }
     catch (std::exception& ex) {
-        errorOutput().writeLine(Format("%s: %s", fname, ex.what()));
+        // Report errors using the file name given by the user, as the memory stream does not know it.
+        err.writeLine(Format("%s: %s", fname, ex.what()));
     }
 }
 
@@ -665,6 +901,7 @@ game::maint::MessageSearchApplication::help()
                             "Options:\n"
                             "  -c           Case-sensitive\n"
                             "  -C CHARSET   Select character set\n"
+                            "  -j N         Search N files in parallel\n"
                             "\n"
                             "Type options apply to all subsequent file names:\n"
                             "  -r           Result files\n"
@@ -5,8 +5,10 @@
 #ifndef C2NG_GAME_MAINT_MESSAGESEARCHAPPLICATION_HPP
 #define C2NG_GAME_MAINT_MESSAGESEARCHAPPLICATION_HPP
 
-#include "util/application.hpp"
+#include "afl/container/ptrvector.hpp"
 #include "afl/io/stream.hpp"
+#include "afl/io/textwriter.hpp"
+#include "util/application.hpp"
 
 namespace game { namespace maint {
 
@@ -21,9 +23,13 @@ namespace game { namespace maint {
         void appMain();
 
      private:
-        void searchZip(afl::io::Stream& file, String_t fname, const Job& job);
-        void searchStream(afl::io::Stream& file, const String_t& fname, const Job& job);
-        void searchFile(const String_t& fname, const Job& job);
+        struct Task;
+        class Worker;
+
+        void searchParallel(afl::container::PtrVector<Task>& tasks, size_t numThreads);
+        void searchZip(afl::io::Stream& file, String_t fname, const Job& job, afl::io::TextWriter& out, afl::io::TextWriter& err);
+        void searchStream(afl::io::Stream& file, const String_t& fname, const Job& job, afl::io::TextWriter& out, afl::io::TextWriter& err);
+        void searchFile(const String_t& fname, const Job& job, afl::io::TextWriter& out, afl::io::TextWriter& err);
         void help();
     };
 
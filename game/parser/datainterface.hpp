@@ -41,6 +41,9 @@ namespace game { namespace parser {
             This is used to identify lines such as "Tholians prefer deserts" in hconfig,
             and should use host names.
 
+            Strings that contain no placeholder ('%') must be returned unchanged;
+            MessageParser relies on that to pre-select templates.
+
             \param tpl String with placeholders
             \return Expanded string */
         virtual String_t expandRaceNames(String_t tpl) const = 0;
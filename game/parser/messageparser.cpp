@@ -387,7 +387,11 @@ namespace {
 
 // Default constructor.
 game::parser::MessageParser::MessageParser()
-    : m_templates()
+    : m_templates(),
+      m_genericTemplates(),
+      m_templatesByKind(),
+      m_texts(),
+      m_templateTexts()
 {
     // ex GMessageParser::GMessageParser
 }
@@ -514,6 +518,7 @@ game::parser::MessageParser::load(afl::io::Stream& file, afl::string::Translator
         }
     }
     checkTemplate(currentTemplate, tf, currentTemplateLine, tx, log);
+    buildIndex();
 }
 
 // Parse a message, main entry point.
@@ -526,15 +531,85 @@ game::parser::MessageParser::parseMessage(String_t theMessage, const DataInterfa
     MessageLines_t lines;
     splitMessage(lines, theMessage);
 
-    // Parse all templates and gather information
-    for (afl::container::PtrVector<MessageTemplate>::iterator i = m_templates.begin(); i != m_templates.end(); ++i) {
+    // Determine candidate templates
+    std::map<int32_t, std::vector<size_t> >::const_iterator kindIt = m_templatesByKind.find(getMessageHeaderInformation(lines, MsgHdrKind));
+    const std::vector<size_t>& candidates = (kindIt != m_templatesByKind.end() ? kindIt->second : m_genericTemplates);
+
+    // Status of required texts: 0=unknown, 1=present, 2=absent
+    String_t upperMessage;
+    std::vector<uint8_t> textStatus(m_texts.size());
+
+    // Parse all candidate templates and gather information
+    for (std::vector<size_t>::const_iterator i = candidates.begin(); i != candidates.end(); ++i) {
+        // Check required texts. Since no required text contains a newline, we can search the whole message instead of individual lines.
+        bool ok = true;
+        const std::vector<size_t>& texts = m_templateTexts[*i];
+        for (size_t t = 0; t < texts.size() && ok; ++t) {
+            uint8_t& status = textStatus[texts[t]];
+            if (status == 0) {
+                if (upperMessage.empty()) {
+                    upperMessage = afl::string::strUCase(theMessage);
+                }
+                status = (upperMessage.find(m_texts[texts[t]]) != String_t::npos ? 1 : 2);
+            }
+            ok = (status == 1);
+        }
+
+        // Try template
+        const MessageTemplate& tpl = *m_templates[*i];
         std::vector<String_t> values;
-        if ((*i)->match(lines, iface, values)) {
+        if (ok && tpl.match(lines, iface, values)) {
             // Matches. Produce output.
-            generateOutput(values, **i, iface, turnNr - getMessageHeaderInformation(lines, MsgHdrAge), info, tx, log);
-            if (!(*i)->getContinueFlag()) {
+            generateOutput(values, tpl, iface, turnNr - getMessageHeaderInformation(lines, MsgHdrAge), info, tx, log);
+            if (!tpl.getContinueFlag()) {
                 break;
             }
         }
     }
 }
+
+/** Build template index.
+    Must be called after changing m_templates. */
+void
+game::parser::MessageParser::buildIndex()
+{
+    m_genericTemplates.clear();
+    m_templatesByKind.clear();
+    m_texts.clear();
+    m_templateTexts.clear();
+
+    // Create a bucket for every kind
+    for (size_t i = 0, n = m_templates.size(); i < n; ++i) {
+        int32_t kind;
+        if (m_templates[i]->getRequiredKind().get(kind)) {
+            m_templatesByKind[kind];
+        }
+    }
+
+    // Distribute templates, keeping their order
+    std::map<String_t, size_t> textIndex;
+    for (size_t i = 0, n = m_templates.size(); i < n; ++i) {
+        const MessageTemplate& tpl = *m_templates[i];
+        int32_t kind;
+        if (tpl.getRequiredKind().get(kind)) {
+            m_templatesByKind[kind].push_back(i);
+        } else {
+            m_genericTemplates.push_back(i);
+            for (std::map<int32_t, std::vector<size_t> >::iterator it = m_templatesByKind.begin(); it != m_templatesByKind.end(); ++it) {
+                it->second.push_back(i);
+            }
+        }
+
+        std::vector<String_t> texts;
+        tpl.getRequiredTexts(texts);
+        m_templateTexts.push_back(std::vector<size_t>());
+        for (size_t t = 0; t < texts.size(); ++t) {
+            std::map<String_t, size_t>::iterator it = textIndex.find(texts[t]);
+            if (it == textIndex.end()) {
+                it = textIndex.insert(std::make_pair(texts[t], m_texts.size())).first;
+                m_texts.push_back(texts[t]);
+            }
+            m_templateTexts.back().push_back(it->second);
+        }
+    }
+}
@@ -5,6 +5,8 @@
 #ifndef C2NG_GAME_PARSER_MESSAGEPARSER_HPP
 #define C2NG_GAME_PARSER_MESSAGEPARSER_HPP
 
+#include <map>
+#include <vector>
 #include "afl/container/ptrvector.hpp"
 #include "afl/io/stream.hpp"
 #include "afl/string/string.hpp"
@@ -20,7 +22,13 @@ namespace game { namespace parser {
     /** Message parser.
         Used for extracting data from in-game messages.
         A MessageParser instance stores a set of templates that it applies to each messages given to it.
-        The templates are loaded from a file (msgparse.ini). */
+        The templates are loaded from a file (msgparse.ini).
+
+        To avoid trying every template on every message, load() builds an index:
+        templates are grouped by the message kind they require,
+        and each template's required texts (MessageTemplate::getRequiredTexts()) are checked
+        against the message before running the actual template.
+        This produces the same result as trying all templates in sequence. */
     class MessageParser {
      public:
         /** Default constructor.
@@ -53,6 +61,20 @@ namespace game { namespace parser {
 
      private:
         afl::container::PtrVector<MessageTemplate> m_templates;
+
+        /** Templates that do not require a message kind, in order. */
+        std::vector<size_t> m_genericTemplates;
+
+        /** Candidate templates for each message kind, in order (includes m_genericTemplates). */
+        std::map<int32_t, std::vector<size_t> > m_templatesByKind;
+
+        /** Required texts of all templates, upper-case, unique. */
+        std::vector<String_t> m_texts;
+
+        /** Required texts for each template, as indexes into m_texts. Parallel to m_templates. */
+        std::vector<std::vector<size_t> > m_templateTexts;
+
+        void buildIndex();
     };
 
 } }
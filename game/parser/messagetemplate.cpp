@@ -291,6 +291,46 @@ game::parser::MessageTemplate::getTemplateName() const
     return m_name;
 }
 
+// Get message kind required by this template.
+afl::base::Optional<int32_t>
+game::parser::MessageTemplate::getRequiredKind() const
+{
+    for (std::vector<Instruction>::const_iterator it = m_instructions.begin(); it != m_instructions.end(); ++it) {
+        if (it->opcode == iMatchKind) {
+            return int32_t(it->index);
+        }
+    }
+    return afl::base::Nothing;
+}
+
+// Get texts required by this template.
+void
+game::parser::MessageTemplate::getRequiredTexts(std::vector<String_t>& out) const
+{
+    for (std::vector<Instruction>::const_iterator it = m_instructions.begin(); it != m_instructions.end(); ++it) {
+        // iCheck must find its text, iParse/iArray must find all their literals (see matchLine, matchPart).
+        // iFail and iFind can succeed without finding their text.
+        uint8_t group = it->opcode & iMask;
+        size_t numStrings = 0;
+        if (group == iCheck) {
+            numStrings = 1;
+        } else if (group == iParse || group == iArray) {
+            numStrings = size_t(it->count) + 1;
+        } else {
+            // Not a text check
+        }
+
+        for (size_t i = 0; i < numStrings && it->index + i < m_strings.size(); ++i) {
+            // Texts containing '%' are modified by DataInterface::expandRaceNames.
+            // Texts containing '\n' cannot be found in a line.
+            const String_t& s = m_strings[it->index + i];
+            if (!s.empty() && s.find_first_of("%\n") == String_t::npos) {
+                out.push_back(strUCase(s));
+            }
+        }
+    }
+}
+
 // Match message against this template.
 bool
 game::parser::MessageTemplate::match(const MessageLines_t& message, const DataInterface& iface, std::vector<String_t>& values) const
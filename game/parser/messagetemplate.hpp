@@ -137,6 +137,20 @@ namespace game { namespace parser {
             \return message information type */
         MessageInformation::Type getMessageType() const;
 
+        /** Get message kind required by this template.
+            If the template contains a "kind" match, only messages of that kind can match.
+            This is used to pre-select templates; see MessageParser.
+            \return kind (character code), if any */
+        afl::base::Optional<int32_t> getRequiredKind() const;
+
+        /** Get texts required by this template.
+            Produces texts that every message matching this template contains within a line,
+            independant of the DataInterface (i.e. texts with race name placeholders are not reported).
+            Texts are converted to upper-case.
+            This is used to pre-select templates; see MessageParser.
+            \param [out] out Texts are appended here */
+        void getRequiredTexts(std::vector<String_t>& out) const;
+
         /** Match message against this template.
             \param message [in] Message
             \param iface [in] Data interface to produce context information
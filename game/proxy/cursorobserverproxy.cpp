@@ -4,15 +4,34 @@
   */
 
 #include "game/proxy/cursorobserverproxy.hpp"
+#include "afl/base/ref.hpp"
+#include "afl/base/refcounted.hpp"
 #include "game/map/objectobserver.hpp"
 #include "game/proxy/objectlistener.hpp"
 
+/*
+ *  Trampoline
+ *
+ *  Object changes are not reported to the listeners immediately.
+ *  Instead, onObjectChange() posts a replaceable request to the game thread,
+ *  keyed by the Trampoline, which reports the then-current object.
+ *  If a burst of changes (e.g. browsing with key repeat, or a script setting
+ *  the cursor repeatedly) is processed before that request runs,
+ *  the requests collapse into one, and listeners (which typically post to the UI)
+ *  see only the latest state.
+ *
+ *  The request refers to the Trampoline through a Backlink, which is cleared
+ *  when the Trampoline dies, so a pending notification never accesses a dead Trampoline.
+ */
+
 class game::proxy::CursorObserverProxy::Trampoline {
  public:
-    Trampoline(Session& session, std::auto_ptr<game::map::ObjectCursorFactory> f)
+    Trampoline(Session& session, util::RequestSender<Session> gameSender, std::auto_ptr<game::map::ObjectCursorFactory> f)
         : m_factory(f),
           m_observer(),
           m_session(session),
+          m_gameSender(gameSender),
+          m_backlink(*new Backlink(this)),
           conn_objectChange(),
           m_listeners()
         {
@@ -22,6 +41,9 @@ class game::proxy::CursorObserverProxy::Trampoline {
             }
         }
 
+    ~Trampoline()
+        { m_backlink->pTrampoline = 0; }
+
     void addNewListener(ObjectListener* pl)
         {
             m_listeners.pushBackNew(pl);
@@ -32,7 +54,33 @@ class game::proxy::CursorObserverProxy::Trampoline {
         }
 
  private:
+    struct Backlink : public afl::base::RefCounted {
+        Backlink(Trampoline* p)
+            : pTrampoline(p)
+            { }
+        Trampoline* pTrampoline;
+    };
+
     void onObjectChange()
+        {
+            class Task : public util::Request<Session> {
+             public:
+                Task(afl::base::Ref<Backlink> link)
+                    : m_link(link)
+                    { }
+                virtual void handle(Session&)
+                    {
+                        if (Trampoline* p = m_link->pTrampoline) {
+                            p->notifyListeners();
+                        }
+                    }
+             private:
+                afl::base::Ref<Backlink> m_link;
+            };
+            m_gameSender.postNewReplaceableRequest(new Task(m_backlink), this);
+        }
+
+    void notifyListeners()
         {
             if (m_observer.get() != 0) {
                 game::map::Object* p = m_observer->getCurrentObject();
@@ -45,6 +93,8 @@ class game::proxy::CursorObserverProxy::Trampoline {
     std::auto_ptr<game::map::ObjectCursorFactory> m_factory;
     std::auto_ptr<game::map::ObjectObserver> m_observer;
     Session& m_session;
+    util::RequestSender<Session> m_gameSender;
+    afl::base::Ref<Backlink> m_backlink;
     afl::base::SignalConnection conn_objectChange;
     afl::container::PtrVector<ObjectListener> m_listeners;
 };
@@ -53,19 +103,21 @@ class game::proxy::CursorObserverProxy::Trampoline {
 
 class game::proxy::CursorObserverProxy::TrampolineFromSession : public afl::base::Closure<Trampoline*(Session&)> {
  public:
-    TrampolineFromSession(std::auto_ptr<game::map::ObjectCursorFactory>& f)
-        : m_factory(f)
+    TrampolineFromSession(util::RequestSender<Session> gameSender, std::auto_ptr<game::map::ObjectCursorFactory>& f)
+        : m_gameSender(gameSender),
+          m_factory(f)
         { }
     virtual Trampoline* call(Session& session)
-        { return new Trampoline(session, m_factory); }
+        { return new Trampoline(session, m_gameSender, m_factory); }
  private:
+    util::RequestSender<Session> m_gameSender;
     std::auto_ptr<game::map::ObjectCursorFactory> m_factory;
 };
 
 
 
 game::proxy::CursorObserverProxy::CursorObserverProxy(util::RequestSender<Session> gameSender, std::auto_ptr<game::map::ObjectCursorFactory> f)
-    : m_trampoline(gameSender.makeTemporary(new TrampolineFromSession(f)))
+    : m_trampoline(gameSender.makeTemporary(new TrampolineFromSession(gameSender, f)))
 { }
 
 game::proxy::CursorObserverProxy::~CursorObserverProxy()
@@ -42,7 +42,7 @@ class game::proxy::MapLocationProxy::Trampoline {
     void onPositionChange(Point pt)
         {
             if (!m_inhibitPositionChange) {
-                sendPositionChange(pt);
+                sendPositionChange(pt, 0);
             }
         }
 
@@ -58,8 +58,8 @@ class game::proxy::MapLocationProxy::Trampoline {
             }
         }
 
-    void sendPositionChange(Point pt)
-        { m_reply.postRequest(&MapLocationProxy::emitPositionChange, pt); }
+    void sendPositionChange(Point pt, uint32_t requestId)
+        { m_reply.postRequest(&MapLocationProxy::emitPositionChange, pt, requestId); }
 
     void sendLocation()
         {
@@ -103,7 +103,7 @@ class game::proxy::MapLocationProxy::Trampoline {
         }
 
     template<typename T>
-    void setPosition(T t)
+    void setPosition(T t, uint32_t requestId)
         {
             if (Game* pGame = m_session.getGame().get()) {
                 m_inhibitPositionChange = true;
@@ -111,11 +111,11 @@ class game::proxy::MapLocationProxy::Trampoline {
                 m_inhibitPositionChange = false;
 
                 const Point pt = pGame->cursors().location().getPosition().orElse(Point());
-                sendPositionChange(pt);
+                sendPositionChange(pt, requestId);
             }
         }
 
-    void browse(game::map::Location::BrowseFlags_t flags)
+    void browse(game::map::Location::BrowseFlags_t flags, uint32_t requestId)
         {
             if (Game* pGame = m_session.getGame().get()) {
                 m_inhibitPositionChange = true;
@@ -123,7 +123,7 @@ class game::proxy::MapLocationProxy::Trampoline {
                 m_inhibitPositionChange = false;
 
                 const Point pt = pGame->cursors().location().getPosition().orElse(Point());
-                sendPositionChange(pt);
+                sendPositionChange(pt, requestId);
                 m_reply.postRequest(&MapLocationProxy::emitBrowseResult, pGame->cursors().location().getEffectiveReference(), pt);
             }
         }
@@ -174,7 +174,8 @@ game::proxy::MapLocationProxy::MapLocationProxy(util::RequestSender<Session> gam
       sig_positionChange(),
       m_reply(reply, *this),
       m_trampoline(gameSender.makeTemporary(new TrampolineFromSession(m_reply.getSender()))),
-      m_numOutstandingRequests(0)
+      m_lastRequest(0),
+      m_lastResponse(0)
 { }
 
 // Destructor.
@@ -192,15 +193,25 @@ game::proxy::MapLocationProxy::postQueryLocation()
 void
 game::proxy::MapLocationProxy::setPosition(game::map::Point pt)
 {
-    ++m_numOutstandingRequests;
-    m_trampoline.postRequest(&Trampoline::setPosition<Point>, pt);
+    // Scrolling produces a flood of these; each one makes the previous one obsolete.
+    class Task : public util::Request<Trampoline> {
+     public:
+        Task(Point pt, uint32_t requestId)
+            : m_point(pt), m_requestId(requestId)
+            { }
+        virtual void handle(Trampoline& tpl)
+            { tpl.setPosition(m_point, m_requestId); }
+     private:
+        Point m_point;
+        uint32_t m_requestId;
+    };
+    m_trampoline.postNewReplaceableRequest(new Task(pt, allocateRequest()), this);
 }
 
 void
 game::proxy::MapLocationProxy::browse(game::map::Location::BrowseFlags_t flags)
 {
-    ++m_numOutstandingRequests;
-    m_trampoline.postRequest(&Trampoline::browse, flags);
+    m_trampoline.postRequest(&Trampoline::browse, flags, allocateRequest());
 }
 
 afl::base::Optional<game::map::Point>
@@ -229,17 +240,26 @@ game::proxy::MapLocationProxy::getOtherPosition(WaitIndicator& ind, game::Id_t s
 void
 game::proxy::MapLocationProxy::setPosition(Reference ref)
 {
-    ++m_numOutstandingRequests;
-    m_trampoline.postRequest(&Trampoline::setPosition<Reference>, ref);
+    m_trampoline.postRequest(&Trampoline::setPosition<Reference>, ref, allocateRequest());
+}
+
+uint32_t
+game::proxy::MapLocationProxy::allocateRequest()
+{
+    ++m_lastRequest;
+    if (m_lastRequest == 0) {
+        ++m_lastRequest;
+    }
+    return m_lastRequest;
 }
 
 void
-game::proxy::MapLocationProxy::emitPositionChange(game::map::Point pt)
+game::proxy::MapLocationProxy::emitPositionChange(game::map::Point pt, uint32_t requestId)
 {
-    if (m_numOutstandingRequests > 0) {
-        --m_numOutstandingRequests;
+    if (requestId != 0) {
+        m_lastResponse = requestId;
     }
-    if (m_numOutstandingRequests == 0) {
+    if (m_lastResponse == m_lastRequest) {
         sig_positionChange.raise(pt);
     }
 }
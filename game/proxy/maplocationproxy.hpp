@@ -91,11 +91,15 @@ namespace game { namespace proxy {
         util::RequestReceiver<MapLocationProxy> m_reply;
         util::RequestSender<Trampoline> m_trampoline;
 
-        /* If we send down multiple setPosition() requests, suppress responses.
-           This is to avoid building up lag. */
-        int m_numOutstandingRequests;
-
-        void emitPositionChange(game::map::Point pt);
+        /* If we send down multiple setPosition() requests, suppress responses to all but the latest.
+           This is to avoid building up lag.
+           Requests are numbered (0 = unsolicited response); setPosition(Point) requests can be replaced in the queue
+           and therefore not all requests produce a response. */
+        uint32_t m_lastRequest;
+        uint32_t m_lastResponse;
+
+        uint32_t allocateRequest();
+        void emitPositionChange(game::map::Point pt, uint32_t requestId);
         void emitBrowseResult(Reference ref, game::map::Point pt);
     };
 
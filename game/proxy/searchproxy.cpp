@@ -7,13 +7,16 @@
 #include "afl/data/stringvalue.hpp"
 #include "afl/string/format.hpp"
 #include "afl/string/translator.hpp"
+#include "game/game.hpp"
 #include "game/interface/referencelistcontext.hpp"
+#include "game/interface/snapshotsearch.hpp"
 #include "game/proxy/waitindicator.hpp"
 #include "interpreter/process.hpp"
 
 namespace {
     struct QueryExtra : public game::Extra {
         game::SearchQuery query;
+        game::interface::SnapshotCache snapshots;
     };
     const game::ExtraIdentifier<game::Session, QueryExtra> SEARCHQUERY_ID = {{}};
 }
@@ -178,6 +181,19 @@ game::proxy::SearchProxy::search(const SearchQuery& q, bool saveQuery)
                         savedQuery(session) = m_query;
                     }
 
+                    // Try to evaluate the query without a process.
+                    // This is the common case for simple queries, and saves compiling and running CCUI$Search for every keystroke.
+                    // Objects are extracted only once and then kept until the universe changes.
+                    game::interface::SnapshotCache& cache = session.extra().create(SEARCHQUERY_ID).snapshots;
+                    Game* g = session.getGame().get();
+                    cache.setTurn(g != 0 ? &g->viewpointTurn() : 0);
+
+                    game::ref::List list;
+                    if (game::interface::searchSnapshot(m_query, session.world(), cache, list)) {
+                        Responder(m_reply, tx).signalSuccess(list);
+                        return;
+                    }
+
                     // Start search driver in a process
                     interpreter::ProcessList& processList = session.processList();
                     interpreter::Process& proc = processList.create(session.world(), tx("Search query"));
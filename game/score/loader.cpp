@@ -7,6 +7,7 @@
 #include "game/score/loader.hpp"
 #include "afl/base/growablememory.hpp"
 #include "afl/except/fileformatexception.hpp"
+#include "afl/io/internalstream.hpp"
 #include "game/score/structures.hpp"
 #include "game/score/turnscorelist.hpp"
 
@@ -234,3 +235,59 @@ game::score::Loader::save(const TurnScoreList& list, afl::io::Stream& out)
     out.setPos(start);
     out.fullWrite(afl::base::fromObject(header));
 }
+
+// Update PCC2 score file (score.cc).
+bool
+game::score::Loader::update(const TurnScoreList& list, afl::io::Stream& file)
+{
+    // Produce new content. This is cheap compared to writing it.
+    afl::io::InternalStream content;
+    save(list, content);
+    const afl::base::ConstBytes_t data = content.getContent();
+    st::ScoreHeader newHeader;
+    afl::base::fromObject(newHeader).copyFrom(data);
+    const size_t headerSize = newHeader.headerSize;
+    const size_t recordSize = sizeof(st::ScoreRecordHeader) + list.getNumScores() * st::NUM_PLAYERS * sizeof(st::Int32_t);
+    const size_t newNumEntries = newHeader.numEntries;
+
+    // Everything before the records (schema, descriptions) must be unchanged; of the header, only the number of entries can change.
+    st::ScoreHeader oldHeader;
+    afl::base::GrowableBytes_t oldDefinitions;
+    oldDefinitions.resize(headerSize - sizeof(oldHeader));
+    file.setPos(0);
+    if (file.read(afl::base::fromObject(oldHeader)) != sizeof(oldHeader)
+        || file.read(oldDefinitions) != oldDefinitions.size())
+    {
+        return false;
+    }
+    const size_t oldNumEntries = oldHeader.numEntries;
+    oldHeader.numEntries = newHeader.numEntries;
+    if (!afl::base::fromObject(oldHeader).equalContent(afl::base::fromObject(newHeader))
+        || !oldDefinitions.equalContent(data.subrange(sizeof(newHeader), oldDefinitions.size()))
+        || oldNumEntries > newNumEntries)
+    {
+        return false;
+    }
+
+    // Skip unchanged records
+    size_t index = 0;
+    afl::base::GrowableBytes_t oldRecord;
+    oldRecord.resize(recordSize);
+    while (index < oldNumEntries
+           && file.read(oldRecord) == recordSize
+           && oldRecord.equalContent(data.subrange(headerSize + index*recordSize, recordSize)))
+    {
+        ++index;
+    }
+
+    // Write remaining records and header
+    if (index < newNumEntries) {
+        file.setPos(headerSize + index*recordSize);
+        file.fullWrite(data.subrange(headerSize + index*recordSize));
+    }
+    if (oldNumEntries != newNumEntries) {
+        file.setPos(0);
+        file.fullWrite(afl::base::fromObject(newHeader));
+    }
+    return true;
+}
@@ -36,6 +36,17 @@ namespace game { namespace score {
             \param out Stream */
         void save(const TurnScoreList& list, afl::io::Stream& out);
 
+        /** Update PCC2 score file (score.cc).
+            If the file has the same schema as the TurnScoreList, writes only the turns that are new or changed.
+            Records are stored with a fixed size in turn order, so this usually appends the newest turn.
+            If the file cannot be updated (schema changed, turns removed), it is not modified,
+            and the caller must rewrite it using save().
+            \param list [in] Result
+            \param file Stream, opened for reading and writing
+            \retval true File has been updated
+            \retval false File cannot be updated; no change */
+        bool update(const TurnScoreList& list, afl::io::Stream& file);
+
      private:
         afl::string::Translator& m_translator;
         afl::charset::Charset& m_charset;
@@ -19,7 +19,8 @@ namespace game { namespace score {
         - a mapping of score types and optional descriptions to physical indexes into the TurnScore objects
         - a list of turns that needs not be exhaustive (i.e. can have gaps)
 
-        Unlike PCC 1.x, PCC2 and c2ng always read the score file into memory completely, and always write it out completely.
+        Unlike PCC 1.x, PCC2 and c2ng always read the score file into memory completely.
+        c2ng writes only changed turns if possible (Loader::update()).
         The file format has room for future expansion, so we store a flag to avoid rewriting a file that contains features we don't understand. */
     class TurnScoreList {
      public:
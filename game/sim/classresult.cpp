@@ -69,5 +69,7 @@ game::sim::ClassResult::addSameClassResult(const ClassResult& other)
     assert(isSameClass(other));
 
     m_weight += other.m_weight;
-    m_sampleBattle = other.m_sampleBattle;
+    if (other.m_sampleBattle.get() != 0) {
+        m_sampleBattle = other.m_sampleBattle;
+    }
 }
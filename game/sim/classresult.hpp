@@ -48,6 +48,7 @@ namespace game { namespace sim {
 
         /** Add new result of same class.
             Updates statistics counter accordingly.
+            The other result's sample battle replaces ours, unless it has none.
             \param other Other (newer) result
             \pre isSameClass(other) */
         void addSameClassResult(const ClassResult& other);
@@ -3,12 +3,19 @@
   *  \brief Class game::sim::ConsoleApplication
   */
 
+#include <algorithm>
 #include <cstring>
 #include "game/sim/consoleapplication.hpp"
+#include "afl/base/countof.hpp"
 #include "afl/base/optional.hpp"
 #include "afl/charset/codepage.hpp"
 #include "afl/charset/codepagecharset.hpp"
+#include "afl/charset/hexencoding.hpp"
+#include "afl/container/ptrvector.hpp"
 #include "afl/except/commandlineexception.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/internalstream.hpp"
+#include "afl/io/textreader.hpp"
 #include "afl/string/format.hpp"
 #include "afl/string/parse.hpp"
 #include "afl/sys/standardcommandlineparser.hpp"
@@ -19,16 +26,20 @@
 #include "game/sim/object.hpp"
 #include "game/sim/parallelrunner.hpp"
 #include "game/sim/planet.hpp"
+#include "game/sim/result.hpp"
 #include "game/sim/resultlist.hpp"
 #include "game/sim/run.hpp"
+#include "game/sim/runrecord.hpp"
 #include "game/sim/setup.hpp"
 #include "game/sim/ship.hpp"
 #include "game/sim/simplerunner.hpp"
 #include "game/specificationloader.hpp"
 #include "game/v3/rootloader.hpp"
 #include "util/charsetfactory.hpp"
+#include "util/process/subprocess.hpp"
 #include "util/stopsignal.hpp"
 #include "util/string.hpp"
+#include "util/stringparser.hpp"
 #include "version.hpp"
 #include "game/exception.hpp"
 
@@ -115,6 +126,86 @@ namespace {
         }
     }
 
+    /* Format simulation configuration for a worker (MainArea only). */
+    String_t formatConfiguration(const Configuration& opts)
+    {
+        return Format("config %d %d %d %d %d %d %d %d %d")
+            << int(opts.getMode())
+            << opts.getEngineShieldBonus()
+            << int(opts.hasScottyBonus())
+            << int(opts.hasRandomLeftRight())
+            << int(opts.hasHonorAlliances())
+            << int(opts.hasOnlyOneSimulation())
+            << int(opts.hasSeedControl())
+            << int(opts.hasRandomizeFCodesOnEveryFight())
+            << int(opts.getBalancingMode());
+    }
+
+    /* Parse simulation configuration produced by formatConfiguration(); StringParser positioned after "config".
+       Returns false on syntax error. */
+    bool parseConfiguration(util::StringParser& sp, Configuration& opts, const game::config::HostConfiguration& config)
+    {
+        int v[9];
+        for (size_t i = 0; i < countof(v); ++i) {
+            if (!sp.parseCharacter(' ') || !sp.parseInt(v[i])) {
+                return false;
+            }
+        }
+        if (!sp.parseEnd()
+            || v[0] < Configuration::VcrHost || v[0] > Configuration::VcrNuHost
+            || v[8] < Configuration::BalanceNone || v[8] > Configuration::BalanceMasterAtArms)
+        {
+            return false;
+        }
+        opts.setMode(Configuration::VcrMode(v[0]), 0, config);
+        opts.setEngineShieldBonus(v[1]);
+        opts.setScottyBonus(v[2] != 0);
+        opts.setRandomLeftRight(v[3] != 0);
+        opts.setHonorAlliances(v[4] != 0);
+        opts.setOnlyOneSimulation(v[5] != 0);
+        opts.setSeedControl(v[6] != 0);
+        opts.setRandomizeFCodesOnEveryFight(v[7] != 0);
+        opts.setBalancingMode(Configuration::BalancingMode(v[8]));
+        return true;
+    }
+
+    /* Run a single simulation, in the same way as Runner does.
+       The same seed and serial number produce the same result. */
+    void runOneSimulation(const game::sim::Setup& setup, uint32_t seed, size_t serial, bool recordBattles,
+                          game::sim::Setup& newState, std::vector<game::vcr::Statistic>& stats, game::sim::Result& result,
+                          const Configuration& opts, const game::Root& root, const game::spec::ShipList& shipList)
+    {
+        util::RandomNumberGenerator rng(seed ^ uint32_t(serial));
+        rng();
+        newState = setup;
+        result.init(opts, int(serial));
+        result.record_battles = recordBattles;
+        game::sim::runSimulation(newState, stats, result, opts, shipList, root.hostConfiguration(), root.flakConfiguration(), rng);
+    }
+
+    /* Quote a word for /bin/sh. */
+    String_t quoteShellWord(const String_t& word)
+    {
+        String_t result = "'";
+        for (size_t i = 0; i < word.size(); ++i) {
+            if (word[i] == '\'') {
+                result += "'\\''";
+            } else {
+                result += word[i];
+            }
+        }
+        result += "'";
+        return result;
+    }
+
+    /* Stop all workers. */
+    void stopWorkers(afl::container::PtrVector<util::process::Subprocess>& workers)
+    {
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i]->stop();
+        }
+    }
+
     void writeScalar(afl::io::TextWriter& out, String_t name, int value)
     {
         out.writeLine(Format("  %s: %d", name, value));
@@ -154,6 +245,9 @@ struct game::sim::ConsoleApplication::Parameters {
     Optional<bool> randomizeFCodesOnEveryFight;            // --random-fc
     Optional<Configuration::BalancingMode> balancingMode;  // --balance
     Optional<uint32_t> seed;                               // --seed
+    size_t numWorkers;                                     // --workers
+    std::vector<String_t> workerCommands;                  // --worker-command
+    bool workerMode;                                       // --worker
     std::vector<String_t> loadFileNames;                   // file names
 
     Parameters()
@@ -161,7 +255,7 @@ struct game::sim::ConsoleApplication::Parameters {
           numThreads(0), charsetName(), runSimCount(), runSimSeries(false),
           vcrMode(), engineShieldBonus(), scottyBonus(), randomLeftRight(),
           honorAlliances(), onlyOneSimulation(), seedControl(), randomizeFCodesOnEveryFight(),
-          balancingMode(), loadFileNames()
+          balancingMode(), seed(), numWorkers(0), workerCommands(), workerMode(false), loadFileNames()
         { }
 };
 
@@ -181,8 +275,9 @@ struct game::sim::ConsoleApplication::Session {
  *  ConsoleApplication class
  */
 
-game::sim::ConsoleApplication::ConsoleApplication(afl::sys::Environment& env, afl::io::FileSystem& fs)
+game::sim::ConsoleApplication::ConsoleApplication(afl::sys::Environment& env, afl::io::FileSystem& fs, util::process::Factory& factory)
     : Application(env, fs),
+      m_factory(factory),
       m_verbose(true)
 {
     consoleLogger().setConfiguration("*@Error=raw:*=hide", translator());
@@ -198,10 +293,14 @@ game::sim::ConsoleApplication::appMain()
     parseCommandLine(p);
 
     // Detect unintended use
-    if (p.loadFileNames.empty()) {
+    if (p.workerMode) {
+        if (!p.loadFileNames.empty() || p.hadAction) {
+            errorExit(tx("'--worker' cannot be combined with input files or actions"));
+        }
+    } else if (p.loadFileNames.empty()) {
         errorExit(tx("no input files specified"));
     }
-    if (!p.hadAction) {
+    if (!p.hadAction && !p.workerMode) {
         errorExit(tx("no action specified"));
     }
 
@@ -216,6 +315,12 @@ game::sim::ConsoleApplication::appMain()
         cs.reset(new afl::charset::CodepageCharset(afl::charset::g_codepageLatin1));
     }
 
+    // Worker: everything else comes from stdin
+    if (p.workerMode) {
+        runWorker(p, *cs);
+        return;
+    }
+
     // Load
     Setup setup;
     loadSetup(setup, *cs, p.loadFileNames);
@@ -241,7 +346,7 @@ game::sim::ConsoleApplication::appMain()
     // Sim
     if (p.runSimSeries || p.runSimCount.isValid()) {
         loadSession(session, p, *cs);
-        runSimulation(setup, session, p);
+        runSimulation(setup, session, p, *cs);
     }
 }
 
@@ -331,6 +436,16 @@ game::sim::ConsoleApplication::parseCommandLine(Parameters& p)
                     errorExit(Format(tx("invalid seed, '%s'"), param));
                 }
                 p.seed = n;
+            } else if (text == "workers") {
+                String_t param = parser.getRequiredParameter(text);
+                if (!afl::string::strToInteger(param, p.numWorkers)) {
+                    errorExit(Format(tx("invalid number of workers, '%s'"), param));
+                }
+            } else if (text == "worker-command") {
+                p.workerCommands.push_back(parser.getRequiredParameter(text));
+            } else if (text == "worker") {
+                p.workerMode = true;
+                m_verbose = false;
             } else {
                 errorExit(Format(tx("invalid option '%s' specified. Use '%s -h' for help."), text, environment().getInvocationName()));
             }
@@ -379,7 +494,13 @@ game::sim::ConsoleApplication::help()
                                                 "--[no-]seed-control\tSeed control\n"
                                                 "--[no-]random-fc\tRandom friendly codes on every fight\n"
                                                 "--balance=MODE\tSet balancing mode (none, 360, master)\n"
-                                                "--seed=N\tSet random-number seed\n"))));
+                                                "--seed=N\tSet random-number seed\n"
+                                                "\n"
+                                                "Distributed simulation:\n"
+                                                "--workers N\tRun simulations in N worker processes\n"
+                                                "--worker-command CMD\tShell command to start a worker (repeatable, "
+                                                "e.g. 'ssh HOST c2simtool'; default: this program)\n"
+                                                "--worker\tRun as worker (internal)\n"))));
     out.flush();
     exit(0);
 }
@@ -503,10 +624,8 @@ game::sim::ConsoleApplication::showSetup(const Setup& setup, const Session& sess
 }
 
 void
-game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& session, const Parameters& params)
+game::sim::ConsoleApplication::buildConfiguration(Configuration& opts, const Session& session, const Parameters& params)
 {
-    // Build configuration
-    Configuration opts;
     if (const Configuration::VcrMode* vcrMode = params.vcrMode.get()) {
         opts.setMode(*vcrMode, 0, session.root->hostConfiguration());
     }
@@ -523,7 +642,7 @@ game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& sessio
         opts.setHonorAlliances(*honorAlliances);
     }
     if (const bool* onlyOneSimulation = params.onlyOneSimulation.get()) {
-        opts.setOnlyOneSimulation(onlyOneSimulation);
+        opts.setOnlyOneSimulation(*onlyOneSimulation);
     }
     if (const bool* seedControl = params.seedControl.get()) {
         opts.setSeedControl(*seedControl);
@@ -534,11 +653,25 @@ game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& sessio
     if (const Configuration::BalancingMode* balancingMode = params.balancingMode.get()) {
         opts.setBalancingMode(*balancingMode);
     }
+}
+
+void
+game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& session, const Parameters& params, afl::charset::Charset& charset)
+{
+    // Build configuration
+    Configuration opts;
+    buildConfiguration(opts, session, params);
 
     // Build RNG
     util::RandomNumberGenerator rng(params.seed.orElse(afl::sys::Time::getTickCounter()));
     game::sim::prepareSimulation(setup, opts, rng);
 
+    // Distribute to workers?
+    if (params.numWorkers != 0 || !params.workerCommands.empty()) {
+        runDistributedSimulation(setup, opts, rng.getSeed(), session, params, charset);
+        return;
+    }
+
     // Build runner
     std::auto_ptr<Runner> runner;
     if (params.numThreads <= 1) {
@@ -573,6 +706,160 @@ game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& sessio
     showUnitResults(setup, session, runner->resultList());
 }
 
+void
+game::sim::ConsoleApplication::runDistributedSimulation(const Setup& setup, const Configuration& opts, uint32_t seed, const Session& session, const Parameters& params, afl::charset::Charset& charset)
+{
+    afl::string::Translator& tx = translator();
+    afl::io::TextWriter& out = standardOutput();
+
+    // Run first sim locally; this determines whether there are battles at all, and the series length
+    ResultList resultList;
+    Setup newState;
+    std::vector<game::vcr::Statistic> stats;
+    Result result;
+    runOneSimulation(setup, seed, 0, true, newState, stats, result, opts, *session.root, *session.shipList);
+    if (result.num_battles == 0) {
+        out.writeLine(tx("Simulation did not produce any battles."));
+        return;
+    }
+    resultList.addResult(setup, newState, stats, result);
+
+    // Same number of simulations as Runner would do
+    const size_t total = params.runSimSeries ? size_t(std::max(result.series_length, int32_t(1))) : params.runSimCount.orElse(0);
+    if (total > 1) {
+        // Worker input: configuration, seed, prepared setup.
+        // Worker i runs serial numbers 1+i, 1+i+N, 1+i+2N, ..., so results can be merged in order.
+        const size_t numWorkers = std::min(params.numWorkers != 0 ? params.numWorkers : params.workerCommands.size(), total-1);
+
+        afl::io::InternalStream setupStream;
+        Loader(charset, tx).save(setupStream, setup);
+        afl::base::ConstBytes_t setupBytes = setupStream.getContent();
+        const String_t setupLine = "setup "
+            + afl::string::fromBytes(afl::charset::HexEncoding().encode(afl::string::ConstStringMemory_t::unsafeCreate(reinterpret_cast<const char*>(setupBytes.unsafeData()), setupBytes.size())))
+            + "\n";
+
+        String_t workerArgs = " --worker";
+        if (const String_t* p = params.gameDirectoryName.get()) {
+            workerArgs += " -G " + quoteShellWord(*p);
+        }
+        if (const String_t* p = params.rootDirectoryName.get()) {
+            workerArgs += " -R " + quoteShellWord(*p);
+        }
+        if (const String_t* p = params.charsetName.get()) {
+            workerArgs += " -C " + quoteShellWord(*p);
+        }
+
+        // Start workers
+        if (m_verbose) {
+            out.writeLine(Format(tx("Starting %d worker%!1{s%}..."), numWorkers));
+            out.flush();
+        }
+        afl::container::PtrVector<util::process::Subprocess> workers;
+        for (size_t i = 0; i < numWorkers; ++i) {
+            String_t command = (params.workerCommands.empty()
+                                ? quoteShellWord(environment().getInvocationName())
+                                : params.workerCommands[i % params.workerCommands.size()]);
+            const String_t args[] = { "-c", command + workerArgs };
+            util::process::Subprocess& w = *workers.pushBackNew(m_factory.createNewProcess());
+            if (!w.start("/bin/sh", args)
+                || !w.writeLine(formatConfiguration(opts) + "\n")
+                || !w.writeLine(Format("run %d %d %d %d\n") << seed << 1+i << numWorkers << total)
+                || !w.writeLine(setupLine)
+                || !w.writeLine("end\n"))
+            {
+                stopWorkers(workers);
+                errorExit(Format(tx("unable to start worker: %s"), w.getStatus()));
+            }
+        }
+
+        // Merge results in order
+        RunRecord rec;
+        String_t line;
+        for (size_t serial = 1; serial < total; ++serial) {
+            util::process::Subprocess& w = *workers[(serial-1) % numWorkers];
+            if (!w.readLine(line)) {
+                stopWorkers(workers);
+                errorExit(Format(tx("worker terminated unexpectedly: %s"), w.getStatus()));
+            }
+            if (!rec.parse(line) || rec.getSerial() != int32_t(serial)) {
+                stopWorkers(workers);
+                errorExit(Format(tx("worker failed: %s"), afl::string::strRTrim(line)));
+            }
+            if (rec.hasBattles()) {
+                if (!rec.unpack(setup, newState, stats, result)) {
+                    stopWorkers(workers);
+                    errorExit(tx("worker result does not match simulation setup"));
+                }
+                resultList.addResult(setup, newState, stats, result);
+            }
+        }
+        stopWorkers(workers);
+    }
+
+    // Show results
+    out.writeLine(Format(tx("Results after %d simulation%!1{s%}"), resultList.getNumBattles()));
+    out.writeLine();
+    showClassResults(setup, session, resultList);
+    showUnitResults(setup, session, resultList);
+}
+
+void
+game::sim::ConsoleApplication::runWorker(const Parameters& params, afl::charset::Charset& charset)
+{
+    // Output of a worker is parsed by the coordinator; report errors only (through errorExit).
+    afl::string::Translator& tx = translator();
+    Session session;
+    loadSession(session, params, charset);
+
+    // Read job
+    Configuration opts;
+    Setup setup;
+    bool hadConfig = false, hadRun = false, hadSetup = false;
+    int64_t seed = 0, first = 0, step = 0, limit = 0;
+    Ref<afl::io::TextReader> in = environment().attachTextReader(afl::sys::Environment::Input);
+    String_t line;
+    while (in->readLine(line) && line != "end") {
+        util::StringParser sp(line);
+        bool ok;
+        if (sp.parseString("config")) {
+            ok = hadConfig = parseConfiguration(sp, opts, session.root->hostConfiguration());
+        } else if (sp.parseString("run ")) {
+            ok = hadRun = sp.parseInt64(seed)
+                && sp.parseCharacter(' ') && sp.parseInt64(first)
+                && sp.parseCharacter(' ') && sp.parseInt64(step)
+                && sp.parseCharacter(' ') && sp.parseInt64(limit)
+                && sp.parseEnd()
+                && first >= 0 && step > 0;
+        } else if (sp.parseString("setup ")) {
+            String_t data = afl::charset::HexEncoding().decode(afl::string::toBytes(sp.getRemainder()));
+            afl::io::ConstMemoryStream ms(afl::string::toBytes(data));
+            Loader(charset, tx).load(ms, setup);
+            ok = hadSetup = true;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            errorExit(Format(tx("invalid worker input, '%s'"), line));
+        }
+    }
+    if (!hadConfig || !hadRun || !hadSetup) {
+        errorExit(tx("incomplete worker input"));
+    }
+
+    // Run simulations, one RunRecord per serial number
+    afl::io::TextWriter& out = standardOutput();
+    Setup newState;
+    std::vector<game::vcr::Statistic> stats;
+    Result result;
+    RunRecord rec;
+    for (int64_t serial = first; serial < limit; serial += step) {
+        runOneSimulation(setup, uint32_t(seed), size_t(serial), false, newState, stats, result, opts, *session.root, *session.shipList);
+        rec.pack(newState, stats, result);
+        out.writeLine(rec.toString());
+    }
+    out.flush();
+}
+
 void
 game::sim::ConsoleApplication::showClassResults(const Setup& /*setup*/, const Session& session, const ResultList& resultList)
 {
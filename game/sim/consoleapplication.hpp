@@ -7,26 +7,36 @@
 
 #include "afl/charset/charset.hpp"
 #include "util/application.hpp"
+#include "util/process/factory.hpp"
 
 namespace game { namespace sim {
 
+    class Configuration;
     class Setup;
     class ResultList;
 
     /** Simulator console application.
         Provides a command-line interface to the battle simulator.
-        In particular, it replaces the "mergeccb" utility. */
+        In particular, it replaces the "mergeccb" utility.
+
+        Simulations can be distributed to worker processes, possibly on other machines ("--workers", "--worker-command").
+        The coordinator sends the prepared setup and configuration to each worker (see "--worker"),
+        the workers stream back a RunRecord for each simulation, and the coordinator merges these in order.
+        Results therefore are the same as for a single-process run with the same seed,
+        but do not include sample battles. */
     class ConsoleApplication : public util::Application {
      public:
         /** Constructor.
-            \param env Environment
-            \param fs  File system */
-        ConsoleApplication(afl::sys::Environment& env, afl::io::FileSystem& fs);
+            \param env     Environment
+            \param fs      File system
+            \param factory Subprocess factory (for starting workers) */
+        ConsoleApplication(afl::sys::Environment& env, afl::io::FileSystem& fs, util::process::Factory& factory);
 
         // Application:
         void appMain();
 
      private:
+        util::process::Factory& m_factory;
         bool m_verbose;
 
         struct Parameters;
@@ -40,7 +50,10 @@ namespace game { namespace sim {
         void loadSession(Session& session, const Parameters& params, afl::charset::Charset& charset);
         void verifySetup(const Setup& setup, const Session& session);
         void showSetup(const Setup& setup, const Session& session);
-        void runSimulation(Setup& setup, const Session& session, const Parameters& params);
+        void buildConfiguration(Configuration& opts, const Session& session, const Parameters& params);
+        void runSimulation(Setup& setup, const Session& session, const Parameters& params, afl::charset::Charset& charset);
+        void runDistributedSimulation(const Setup& setup, const Configuration& opts, uint32_t seed, const Session& session, const Parameters& params, afl::charset::Charset& charset);
+        void runWorker(const Parameters& params, afl::charset::Charset& charset);
         void showClassResults(const Setup& setup, const Session& session, const ResultList& resultList);
         void showUnitResults(const Setup& setup, const Session& session, const ResultList& resultList);
     };
@@ -64,25 +64,24 @@ game::sim::ParallelRunner::startAll()
 }
 
 bool
-game::sim::ParallelRunner::processRequest()
+game::sim::ParallelRunner::processRequest(std::auto_ptr<Job>& j)
 {
     // Fetch job
-    std::auto_ptr<Job> j;
     {
         afl::sys::MutexGuard g(m_mutex);
-        j.reset(makeJob(m_limit, *m_pStopper));
-    }
-    if (!j.get()) {
-        return false;
+        if (!makeJob(j, m_limit, *m_pStopper)) {
+            return false;
+        }
     }
 
-    // Do it
-    runJob(j.get());
+    // Do it, and put back
+    while (1) {
+        runJob(*j);
 
-    // Put back
-    {
         afl::sys::MutexGuard g(m_mutex);
-        finishJob(j.release());
+        if (finishJob(*j)) {
+            break;
+        }
     }
     return true;
 }
@@ -97,6 +96,8 @@ game::sim::ParallelRunner::stop()
 void
 game::sim::ParallelRunner::run()
 {
+    // Job object of this worker, reused for all simulations
+    std::auto_ptr<Job> j;
     while (1) {
         // Wait for control thread to give start signal
         m_startSignal.wait();
@@ -107,7 +108,7 @@ game::sim::ParallelRunner::run()
         }
 
         // Process requests
-        while (processRequest()) {
+        while (processRequest(j)) {
             // nix
         }
 
@@ -55,7 +55,7 @@ namespace game { namespace sim {
 
      private:
         void startAll();
-        bool processRequest();
+        bool processRequest(std::auto_ptr<Job>& j);
 
         // Stoppable:
         void run();
@@ -13,6 +13,7 @@ game::sim::Result::init(const Configuration& config, int this_battle_index)
     this->this_battle_weight  = 1;
     this->total_battle_weight = 1;
     this->series_length       = config.getMode() == Configuration::VcrNuHost ? 118 : 110;
+    this->num_battles         = 0;
     this->battles             = 0;
 }
 
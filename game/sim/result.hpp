@@ -22,7 +22,8 @@ namespace game { namespace sim {
         the fight with bonus has a probability of 59%; the unmodified fight appears with 41%.
         In addition, appearance of this bonus increases series length from 110 to 220.
 
-        - driver calls init to initialize parameters from configuration and set this_battle_index.
+        - driver calls init to initialize parameters from configuration and set this_battle_index;
+          optionally, turns off record_battles.
         - simulator updates this_battle_weight, total_battle_weight, series_length
           with information from the series. */
     // ex GSimBattleResult
@@ -55,16 +56,27 @@ namespace game { namespace sim {
             Used by simulator to determine where in a non-equal set we are. */
         int32_t this_battle_index;
 
-        /** Actual battle. Filled in by simulator. */
+        /** Number of battles fought.
+            Filled in by simulator, also if battles are not being recorded. */
+        int32_t num_battles;
+
+        /** Actual battle. Filled in by simulator if record_battles is set; null otherwise. */
         Database_t battles;
 
+        /** Record battles.
+            Set by driver code.
+            If false, the simulator does not create a VCR database (battles remains null);
+            use this if the result is only needed for statistics. */
+        bool record_battles;
+
         /** Constructor. */
         // FIXME: merge with init?
         Result()
-            : this_battle_weight(1), total_battle_weight(1), series_length(1), this_battle_index(0), battles()
+            : this_battle_weight(1), total_battle_weight(1), series_length(1), this_battle_index(0), num_battles(0), battles(), record_battles(true)
             { }
 
         /** Initialize.
+            Does not modify record_battles.
             \param config            Simulation configuration
             \param this_battle_index Index of the battle to be simulated, 0-based. */
         void init(const Configuration& config, int this_battle_index);
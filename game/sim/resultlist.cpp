@@ -106,6 +106,47 @@ game::sim::ResultList::addResult(const Setup& oldState, const Setup& newState, a
     ++m_numBattles;
 }
 
+// Check whether a result needs a sample battle.
+bool
+game::sim::ResultList::isSampleNeeded(const Setup& oldState, const Setup& newState, afl::base::Memory<const game::vcr::Statistic> stats, const Result& result) const
+{
+    // First result always provides all samples
+    if (m_unitResults.empty() || result.this_battle_index == 0) {
+        return true;
+    }
+
+    // New class?
+    ClassResult thisClass(newState, result);
+    bool haveThisClass = false;
+    for (ClassResults_t::const_iterator i = m_classResults.begin(); i != m_classResults.end(); ++i) {
+        if ((*i)->isSameClass(thisClass)) {
+            haveThisClass = true;
+            break;
+        }
+    }
+    if (!haveThisClass) {
+        return true;
+    }
+
+    // New extreme? Try it on a copy of each unit result.
+    for (Setup::Slot_t i = 0, n = oldState.getNumObjects(); i < n && i < m_unitResults.size(); ++i) {
+        const game::vcr::Statistic* pStat = stats.eat();
+        UnitResult unit(*m_unitResults[i]);
+        if (const Ship* oldShip = dynamic_cast<const Ship*>(oldState.getObject(i))) {
+            const Ship* newShip = dynamic_cast<const Ship*>(newState.getObject(i));
+            if (newShip != 0 && unit.addResult(*oldShip, *newShip, pStat ? *pStat : game::vcr::Statistic(), result)) {
+                return true;
+            }
+        } else if (const Planet* oldPlanet = dynamic_cast<const Planet*>(oldState.getObject(i))) {
+            const Planet* newPlanet = dynamic_cast<const Planet*>(newState.getObject(i));
+            if (newPlanet != 0 && unit.addResult(*oldPlanet, *newPlanet, pStat ? *pStat : game::vcr::Statistic(), result)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 // Get cumulative weight.
 int32_t
 game::sim::ResultList::getCumulativeWeight() const
@@ -103,6 +103,20 @@ namespace game { namespace sim {
             \param result   [in] Result meta-information provided by simulator */
         void addResult(const Setup& oldState, const Setup& newState, afl::base::Memory<const game::vcr::Statistic> stats, Result result);
 
+        /** Check whether a result needs a sample battle.
+            Determines whether addResult() would store the result's battles as a sample,
+            i.e.\ whether the result is the first one, produces a new result class, or a new minimum or maximum for a unit.
+            If this returns false, the result can be added without recording its battles (Result::record_battles).
+
+            Parameters are the same as for addResult().
+
+            \param oldState [in] Simulator input
+            \param newState [in] Simulator output
+            \param stats    [in] VCR statistics provided; array must parallel the Setup::getObject().
+            \param result   [in] Result meta-information provided by simulator
+            \return true if the result's battles would be stored */
+        bool isSampleNeeded(const Setup& oldState, const Setup& newState, afl::base::Memory<const game::vcr::Statistic> stats, const Result& result) const;
+
         /** Get cumulative weight.
             This is the sum of all weights of all simulated battles.
             \return cumulative weight */
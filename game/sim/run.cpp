@@ -22,6 +22,7 @@
 #include "game/spec/hull.hpp"
 #include "game/v3/structures.hpp"          // VCR capabilities
 #include "game/vcr/classic/algorithm.hpp"
+#include "game/vcr/classic/battle.hpp"
 #include "game/vcr/classic/database.hpp"
 #include "game/vcr/classic/nullvisualizer.hpp"
 #include "game/vcr/classic/types.hpp"
@@ -1237,8 +1238,28 @@ namespace {
         }
     }
 
+    /* Create classic VCR database to receive the battles, if the driver wants them recorded. */
+    Ptr<game::vcr::classic::Database> makeClassicDatabase(Result& result)
+    {
+        Ptr<game::vcr::classic::Database> db;
+        if (result.record_battles) {
+            db = new game::vcr::classic::Database();
+            result.battles = db;
+        }
+        return db;
+    }
+
+    /* Count a battle; add a copy to the database if battles are being recorded. */
+    void recordBattle(game::vcr::classic::Database* db, const game::vcr::classic::Battle& vcr, Result& result)
+    {
+        ++result.num_battles;
+        if (db != 0) {
+            db->addNewBattle(new game::vcr::classic::Battle(vcr));
+        }
+    }
+
     /* Make ship/ship VCR. This routine also does left/right randomisation.
-       \param [in/out]  db        Database (VCR will be appended here)
+       \param [in/out]  db        Database (VCR will be appended here); null if battles are not recorded
        \param [in/out]  leftShip  Left ship
        \param [in/out]  leftStat  Out-of-band statistic for left ship
        \param [in/out]  rightShip Right ship
@@ -1253,7 +1274,7 @@ namespace {
        \param [in/out]  rng       Random number generator
        \retval true  Call makeShipShipVcr with same parameters again (ship respawned)
        \retval false Do not call makeShipShipVcr again */
-    bool makeShipShipVcr(game::vcr::classic::Database& db,
+    bool makeShipShipVcr(game::vcr::classic::Database* db,
                          Ship& leftShip,
                          game::vcr::Statistic* leftStat,
                          Ship& rightShip,
@@ -1305,7 +1326,7 @@ namespace {
         }
 
         /* set up fight */
-        const bool first = db.getNumBattles() == 0;
+        const bool first = result.num_battles == 0;
 
         game::vcr::Object left, right;
         uint16_t seed = uint16_t(getSeed(opts, result, rng));
@@ -1363,14 +1384,15 @@ namespace {
         }
 
         /* run it */
-        game::vcr::classic::Battle* vcr = db.addNewBattle(new game::vcr::classic::Battle(left, right, seed, 0 /* sig */, 0 /* planet temp */));
+        game::vcr::classic::Battle vcr(left, right, seed, 0 /* sig */, 0 /* planet temp */);
         uint16_t cap = type == game::vcr::classic::PHost4
             ? game::v3::structures::DeathRayCapability | game::v3::structures::ExperienceCapability | game::v3::structures::BeamCapability
             : 0;
-        vcr->setType(type, cap);
+        vcr.setType(type, cap);
+        recordBattle(db, vcr, result);
 
         game::vcr::classic::NullVisualizer vis;
-        std::auto_ptr<game::vcr::classic::Algorithm> player(vcr->createAlgorithm(vis, config, list));
+        std::auto_ptr<game::vcr::classic::Algorithm> player(vcr.createAlgorithm(vis, config, list));
         checkAssertion(player.get(), "create VCR player");
         checkAssertion(player->setCapabilities(cap), "VCR player refuses capabilities");
         checkAssertion(!player->checkBattle(left, right, seed), "VCR player refuses battle");
@@ -1424,7 +1446,7 @@ namespace {
 
 
     /* Make ship/planet VCR.
-       \param [in/out]  db        Database (VCR will be appended here)
+       \param [in/out]  db        Database (VCR will be appended here); null if battles are not recorded
        \param [in/out]  leftShip  Left ship
        \param [in/out]  leftStat  Out-of-band statistic for left ship
        \param [in/out]  rightPlanet Right planet
@@ -1439,7 +1461,7 @@ namespace {
        \param [in/out]  rng       Random number generator
        \retval true  Call makeShipPlanetVcr with same parameters again (ship respawned)
        \retval false Do not call makeShipPlanetVcr again */
-    bool makeShipPlanetVcr(game::vcr::classic::Database& db,
+    bool makeShipPlanetVcr(game::vcr::classic::Database* db,
                            Ship& leftShip,
                            game::vcr::Statistic* leftStat,
                            Planet& rightPlanet,
@@ -1463,7 +1485,7 @@ namespace {
         }
 
         /* set up fight */
-        const bool first = db.getNumBattles() == 0;
+        const bool first = result.num_battles == 0;
         uint16_t seed = uint16_t(getSeed(opts, result, rng));
 
         game::vcr::Object left;
@@ -1481,14 +1503,15 @@ namespace {
 
         /* run it */
         game::vcr::Object origPlanet = right;
-        game::vcr::classic::Battle* vcr = db.addNewBattle(new game::vcr::classic::Battle(left, right, seed, 0 /* sig */, 0 /* planet temp */));
+        game::vcr::classic::Battle vcr(left, right, seed, 0 /* sig */, 0 /* planet temp */);
         uint16_t cap = type == game::vcr::classic::PHost4
             ? game::v3::structures::DeathRayCapability | game::v3::structures::ExperienceCapability | game::v3::structures::BeamCapability
             : 0;
-        vcr->setType(type, cap);
+        vcr.setType(type, cap);
+        recordBattle(db, vcr, result);
 
         game::vcr::classic::NullVisualizer vis;
-        std::auto_ptr<game::vcr::classic::Algorithm> player(vcr->createAlgorithm(vis, config, list));
+        std::auto_ptr<game::vcr::classic::Algorithm> player(vcr.createAlgorithm(vis, config, list));
         checkAssertion(player.get(), "create VCR player");
         checkAssertion(player->setCapabilities(cap), "VCR player refuses capabilities");
         checkAssertion(!player->checkBattle(left, right, seed), "VCR player refuses battle");
@@ -1632,7 +1655,7 @@ namespace {
                             const HostConfiguration& config,
                             util::RandomNumberGenerator& rng,
                             game::vcr::classic::Type type,
-                            game::vcr::classic::Database& db,
+                            game::vcr::classic::Database* db,
                             GlobalModificators& mods,
                             const std::vector<Object*>& battle_order)
     {
@@ -1651,7 +1674,7 @@ namespace {
                                                *iship, getStatistic(stats, setup, iship),
                                                game::vcr::classic::RightSide,
                                                opts, type, list, config, mods, result, rng);
-                        if (db.getNumBattles() != 0 && opts.hasOnlyOneSimulation()) {
+                        if (result.num_battles != 0 && opts.hasOnlyOneSimulation()) {
                             return true;
                         }
                     }
@@ -1670,7 +1693,7 @@ namespace {
                        const HostConfiguration& config,
                        util::RandomNumberGenerator& rng,
                        game::vcr::classic::Type type,
-                       game::vcr::classic::Database& db,
+                       game::vcr::classic::Database* db,
                        GlobalModificators& mods,
                        const std::vector<Object*>& battle_order)
     {
@@ -1704,7 +1727,7 @@ namespace {
                                                          opts, type, list, config, mods, result, rng);
                             }
                         }
-                        if (db.getNumBattles() != 0 && opts.hasOnlyOneSimulation()) {
+                        if (result.num_battles != 0 && opts.hasOnlyOneSimulation()) {
                             return true;
                         }
                     }
@@ -1725,8 +1748,7 @@ namespace {
                       util::RandomNumberGenerator& rng,
                       game::vcr::classic::Type type)
     {
-        Ptr<game::vcr::classic::Database> db = new game::vcr::classic::Database();
-        result.battles = db;
+        Ptr<game::vcr::classic::Database> db = makeClassicDatabase(result);
 
         /* compute Commander level limits */
         GlobalModificators mods;
@@ -1742,13 +1764,13 @@ namespace {
 
         /* simulate intercept-attack. */
         std::sort(battle_order.begin(), battle_order.end(), sortByIdBackwards);
-        if (doInterceptAttacks(setup, opts, result, stats, list, config, rng, type, *db, mods, battle_order)) {
+        if (doInterceptAttacks(setup, opts, result, stats, list, config, rng, type, db.get(), mods, battle_order)) {
             return;
         }
 
         /* simulate. Outer loop selects right ship, inner loop selects left ship. */
         std::sort(battle_order.begin(), battle_order.end(), sortByBattleOrderTHost);
-        if (doCombatOrder(setup, opts, result, stats, list, config, rng, type, *db, mods, battle_order)) {
+        if (doCombatOrder(setup, opts, result, stats, list, config, rng, type, db.get(), mods, battle_order)) {
             return;
         }
 
@@ -1760,12 +1782,12 @@ namespace {
                     bool loop = true;
                     while (loop) {
                         computeHelpers(mods, battle_order, leftShip, setup.getPlanet(), opts, list, config);
-                        loop = makeShipPlanetVcr(*db,
+                        loop = makeShipPlanetVcr(db.get(),
                                                  *leftShip, getStatistic(stats, setup, leftShip),
                                                  *setup.getPlanet(), getStatistic(stats, setup, setup.getPlanet()),
                                                  game::vcr::classic::LeftSide /* not relevant for Host */,
                                                  opts, type, list, config, mods, result, rng);
-                        if (db->getNumBattles() != 0 && opts.hasOnlyOneSimulation()) {
+                        if (result.num_battles != 0 && opts.hasOnlyOneSimulation()) {
                             return;
                         }
                     }
@@ -1784,8 +1806,7 @@ namespace {
                        util::RandomNumberGenerator& rng,
                        game::vcr::classic::Type type)
     {
-        Ptr<game::vcr::classic::Database> db = new game::vcr::classic::Database();
-        result.battles = db;
+        Ptr<game::vcr::classic::Database> db = makeClassicDatabase(result);
 
         /* compute Commander level limits */
         GlobalModificators mods;
@@ -1810,12 +1831,12 @@ namespace {
         std::sort(battle_order.begin(), battle_order.end(), sortByBattleOrderPHost);
 
         /* simulate intercept-attack. */
-        if (doInterceptAttacks(setup, opts, result, stats, list, config, rng, type, *db, mods, battle_order)) {
+        if (doInterceptAttacks(setup, opts, result, stats, list, config, rng, type, db.get(), mods, battle_order)) {
             goto out;
         }
 
         /* simulate. Outer loop picks aggressor, inner loop picks opponent */
-        if (doCombatOrder(setup, opts, result, stats, list, config, rng, type, *db, mods, battle_order)) {
+        if (doCombatOrder(setup, opts, result, stats, list, config, rng, type, db.get(), mods, battle_order)) {
             goto out;
         }
 
@@ -2320,8 +2341,11 @@ namespace {
                       const game::vcr::flak::Configuration& flakConfig,
                       util::RandomNumberGenerator& rng)
     {
-        afl::base::Ptr<game::vcr::flak::Database> db(new game::vcr::flak::Database());
-        result.battles = db;
+        afl::base::Ptr<game::vcr::flak::Database> db;
+        if (result.record_battles) {
+            db = new game::vcr::flak::Database();
+            result.battles = db;
+        }
 
         // Build list of ships
         std::vector<ShipInfo> ships;
@@ -2436,7 +2460,10 @@ namespace {
         }
 
         // Add battle to VCR DB
-        db->addNewBattle(new game::vcr::flak::Battle(flakSetup));
+        ++result.num_battles;
+        if (db.get() != 0) {
+            db->addNewBattle(new game::vcr::flak::Battle(flakSetup));
+        }
     }
 }
 
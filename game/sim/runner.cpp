@@ -21,9 +21,7 @@ game::sim::Runner::Job::Job(const Setup& setup,
                             const game::spec::ShipList& list,
                             const game::config::HostConfiguration& config,
                             const game::vcr::flak::Configuration& flakConfig,
-                            afl::sys::LogListener& log,
-                            util::RandomNumberGenerator& rng,
-                            size_t serial)
+                            afl::sys::LogListener& log)
     : m_setup(setup),
       m_newState(setup),
       m_options(opts),
@@ -31,17 +29,32 @@ game::sim::Runner::Job::Job(const Setup& setup,
       m_config(config),
       m_flakConfiguration(flakConfig),
       m_log(log),
-      m_rng(rng.getSeed() ^ uint32_t(serial)),
+      m_rng(0),
+      m_seed(0),
+      m_serial(0),
+      m_recordBattles(true),
       m_result(),
       m_stats()
+{ }
+
+inline void
+game::sim::Runner::Job::reset(uint32_t seed, size_t serial, bool recordBattles)
 {
-    m_rng();
-    m_result.init(opts, int(serial));
+    m_seed = seed;
+    m_serial = serial;
+    m_recordBattles = recordBattles;
 }
 
 inline void
 game::sim::Runner::Job::run()
 {
+    // Start from the template. This is also used to re-run a job, and therefore must reproduce the same result.
+    m_newState = m_setup;
+    m_rng.setSeed(m_seed);
+    m_rng();
+    m_result.init(m_options, int(m_serial));
+    m_result.record_battles = m_recordBattles;
+
     try {
         runSimulation(m_newState, m_stats, m_result, m_options, m_shipList, m_config, m_flakConfiguration, m_rng);
     }
@@ -54,16 +67,32 @@ game::sim::Runner::Job::run()
 }
 
 inline bool
-game::sim::Runner::Job::writeBack(ResultList& list) const
+game::sim::Runner::Job::hasBattles() const
 {
-    if (m_result.battles.get() == 0 || m_result.battles->getNumBattles() == 0) {
-        return false;
-    } else {
-        list.addResult(m_setup, m_newState, m_stats, m_result);
+    return m_result.num_battles != 0;
+}
+
+inline bool
+game::sim::Runner::Job::needRerun(const ResultList& list)
+{
+    // If the result is going to be kept as a sample, but we did not record it, run again with recording enabled.
+    if (!m_recordBattles && list.isSampleNeeded(m_setup, m_newState, m_stats, m_result)) {
+        m_recordBattles = true;
         return true;
+    } else {
+        return false;
     }
 }
 
+inline void
+game::sim::Runner::Job::writeBack(ResultList& list)
+{
+    list.addResult(m_setup, m_newState, m_stats, m_result);
+
+    // The battles are now shared with the ResultList; drop our reference while the caller still holds the lock.
+    m_result.battles = 0;
+}
+
 inline size_t
 game::sim::Runner::Job::getSeriesLength() const
 {
@@ -102,9 +131,11 @@ game::sim::Runner::init()
     // ex WSimResultWindow::runFirstSimulation (sort-of)
     bool ok;
     if (m_count == 0) {
-        Job j(m_setup, m_options, m_shipList, m_config, m_flakConfiguration, m_log, m_rng, 0);
+        Job j(m_setup, m_options, m_shipList, m_config, m_flakConfiguration, m_log);
+        j.reset(m_rng.getSeed(), 0, true);
         j.run();
-        if (j.writeBack(m_resultList)) {
+        if (j.hasBattles()) {
+            j.writeBack(m_resultList);
             m_count = 1;
             m_seriesLength = j.getSeriesLength();
             m_lastUpdate = afl::sys::Time::getTickCounter();
@@ -152,21 +183,30 @@ game::sim::Runner::makeFiniteLimit(size_t n) const
     return m_count + n;
 }
 
-game::sim::Runner::Job*
-game::sim::Runner::makeJob(Limit_t& limit, util::StopSignal& stopper)
+bool
+game::sim::Runner::makeJob(std::auto_ptr<Job>& p, Limit_t& limit, util::StopSignal& stopper)
 {
     if (!stopper.get() && (limit == 0 || m_count < limit)) {
-        return new Job(m_setup, m_options, m_shipList, m_config, m_flakConfiguration, m_log, m_rng, m_count++);
+        if (p.get() == 0) {
+            p.reset(new Job(m_setup, m_options, m_shipList, m_config, m_flakConfiguration, m_log));
+        }
+        const size_t serial = m_count++;
+        p->reset(m_rng.getSeed() ^ uint32_t(serial), serial, false);
+        return true;
     } else {
-        return 0;
+        return false;
     }
 }
 
-void
-game::sim::Runner::finishJob(Job* p)
+bool
+game::sim::Runner::finishJob(Job& p)
 {
-    std::auto_ptr<Job> pp(p);
-    pp->writeBack(m_resultList);
+    if (p.hasBattles()) {
+        if (p.needRerun(m_resultList)) {
+            return false;
+        }
+        p.writeBack(m_resultList);
+    }
 
     uint32_t now = afl::sys::Time::getTickCounter();
     uint32_t elapsed = now - m_lastUpdate;
@@ -174,10 +214,11 @@ game::sim::Runner::finishJob(Job* p)
         m_lastUpdate = now;
         sig_update.raise();
     }
+    return true;
 }
 
 void
-game::sim::Runner::runJob(Job* p)
+game::sim::Runner::runJob(Job& p)
 {
-    p->run();
+    p.run();
 }
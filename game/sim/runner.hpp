@@ -5,6 +5,7 @@
 #ifndef C2NG_GAME_SIM_RUNNER_HPP
 #define C2NG_GAME_SIM_RUNNER_HPP
 
+#include <memory>
 #include "afl/base/deletable.hpp"
 #include "afl/base/signal.hpp"
 #include "game/config/hostconfiguration.hpp"
@@ -69,7 +70,11 @@ namespace game { namespace sim {
 
             Implementations must repeatedly
             - call makeJob() with the given parameters
-            - if it returns non-null, call runJob(), then finishJob().
+            - if it returns true, call runJob(), then finishJob();
+              while finishJob() returns false, call runJob() and finishJob() again.
+
+            Each worker (thread) should keep its Job object and pass it to makeJob() again,
+            so the object (and the simulation state it contains) can be reused without re-allocating.
 
             If the implementation uses multiple threads,
             it must make sure that makeJob() and finishJob() are run under mutex protection;
@@ -117,22 +122,31 @@ namespace game { namespace sim {
         afl::base::Signal<void()> sig_update;
 
      protected:
-        /** Create new job.
+        /** Prepare a job.
             Call from your run(), see there.
-            \param limit   Limit
-            \param stopper Stopper
-            \return newly-allocated job; null to stop simulating. */
-        Job* makeJob(Limit_t& limit, util::StopSignal& stopper);
+            \param [in,out] p       Job. If null, a new job is allocated; otherwise, the existing job is reset for the next simulation.
+            \param [in]     limit   Limit
+            \param [in]     stopper Stopper
+            \retval true  Job is ready to run
+            \retval false Stop simulating */
+        bool makeJob(std::auto_ptr<Job>& p, Limit_t& limit, util::StopSignal& stopper);
 
         /** Finish a job.
             Call from your run(), see there.
-            \param p Job created by makeJob(), you must have called runJob(). */
-        void finishJob(Job* p);
+
+            If the job produced a result that needs to be kept as a sample battle,
+            but did not record the battle, it is not added to the result list,
+            but prepared to run again with the same parameters and battle recording enabled.
+
+            \param p Job prepared by makeJob(), you must have called runJob().
+            \retval true  Job finished
+            \retval false Job must be run again (call runJob(), then finishJob() again) */
+        bool finishJob(Job& p);
 
         /** Run a job.
             Call from your run(), see there.
-            \param p Job created by makeJob(). */
-        static void runJob(Job* p);
+            \param p Job prepared by makeJob(). */
+        static void runJob(Job& p);
 
      private:
         const Setup& m_setup;
@@ -182,19 +196,25 @@ class game::sim::Runner::Job {
     friend class Runner;
 
     inline Job(const Setup& setup, const Configuration& opts, const game::spec::ShipList& list, const game::config::HostConfiguration& config,
-               const game::vcr::flak::Configuration& flakConfig, afl::sys::LogListener& log, util::RandomNumberGenerator& rng, size_t serial);
+               const game::vcr::flak::Configuration& flakConfig, afl::sys::LogListener& log);
+    inline void reset(uint32_t seed, size_t serial, bool recordBattles);
     inline void run();
-    inline bool writeBack(ResultList& list) const;
+    inline bool hasBattles() const;
+    inline bool needRerun(const ResultList& list);
+    inline void writeBack(ResultList& list);
     inline size_t getSeriesLength() const;
 
     const Setup& m_setup;
-    Setup m_newState;
+    Setup m_newState;                            // Reset from m_setup in place for each run
     const Configuration& m_options;
     const game::spec::ShipList& m_shipList;
     const game::config::HostConfiguration& m_config;
     const game::vcr::flak::Configuration& m_flakConfiguration;
     afl::sys::LogListener& m_log;
     util::RandomNumberGenerator m_rng;
+    uint32_t m_seed;
+    size_t m_serial;
+    bool m_recordBattles;
     Result m_result;
     std::vector<game::vcr::Statistic> m_stats;
 };
@@ -0,0 +1,214 @@
+/**
+  *  \file game/sim/runrecord.cpp
+  *  \brief Class game::sim::RunRecord
+  */
+
+#include "game/sim/runrecord.hpp"
+#include "afl/string/format.hpp"
+#include "game/sim/planet.hpp"
+#include "game/sim/result.hpp"
+#include "game/sim/setup.hpp"
+#include "game/sim/ship.hpp"
+
+namespace {
+    /* Line prefix */
+    const char PREFIX = 'R';
+
+    /* Parse a (possibly negative) decimal number, preceded by a space.
+       Done by hand because records are parsed in bulk. */
+    bool parseNumber(const String_t& line, size_t& pos, int32_t& out)
+    {
+        if (pos >= line.size() || line[pos] != ' ') {
+            return false;
+        }
+        ++pos;
+
+        bool negative = false;
+        if (pos < line.size() && line[pos] == '-') {
+            negative = true;
+            ++pos;
+        }
+
+        size_t start = pos;
+        int64_t value = 0;
+        while (pos < line.size() && line[pos] >= '0' && line[pos] <= '9') {
+            value = 10*value + (line[pos] - '0');
+            if (value > 0x7FFFFFFF) {
+                return false;
+            }
+            ++pos;
+        }
+        if (pos == start) {
+            return false;
+        }
+        out = int32_t(negative ? -value : value);
+        return true;
+    }
+}
+
+// Constructor.
+game::sim::RunRecord::RunRecord()
+    : m_serial(0),
+      m_numBattles(0),
+      m_thisBattleWeight(1),
+      m_totalBattleWeight(1),
+      m_seriesLength(1),
+      m_units()
+{ }
+
+// Destructor.
+game::sim::RunRecord::~RunRecord()
+{ }
+
+// Pack a simulation result.
+void
+game::sim::RunRecord::pack(const Setup& newState, afl::base::Memory<const game::vcr::Statistic> stats, const Result& result)
+{
+    m_serial            = result.this_battle_index;
+    m_numBattles        = result.num_battles;
+    m_thisBattleWeight  = result.this_battle_weight;
+    m_totalBattleWeight = result.total_battle_weight;
+    m_seriesLength      = result.series_length;
+    m_units.clear();
+
+    // A result without battles is not accounted; no need to transfer units
+    if (m_numBattles != 0) {
+        for (Setup::Slot_t i = 0, n = newState.getNumObjects(); i < n; ++i) {
+            Unit u = Unit();
+            if (const Object* obj = newState.getObject(i)) {
+                u.owner  = obj->getOwner();
+                u.damage = obj->getDamage();
+                u.shield = obj->getShield();
+                if (const Ship* sh = dynamic_cast<const Ship*>(obj)) {
+                    u.crewOrDefense  = sh->getCrew();
+                    u.ammoOrFighters = sh->getAmmo();
+                }
+                if (const Planet* pl = dynamic_cast<const Planet*>(obj)) {
+                    u.crewOrDefense  = pl->getDefense();
+                    u.ammoOrFighters = pl->getNumBaseFighters();
+                }
+            }
+            if (const game::vcr::Statistic* st = stats.at(i)) {
+                u.minFightersAboard = st->getMinFightersAboard();
+                u.numTorpedoHits    = st->getNumTorpedoHits();
+                u.numFights         = st->getNumFights();
+            }
+            m_units.push_back(u);
+        }
+    }
+}
+
+// Unpack a simulation result.
+bool
+game::sim::RunRecord::unpack(const Setup& oldState, Setup& newState, std::vector<game::vcr::Statistic>& stats, Result& result) const
+{
+    if (oldState.getNumObjects() != m_units.size()) {
+        return false;
+    }
+
+    newState = oldState;
+    stats.clear();
+    for (Setup::Slot_t i = 0, n = newState.getNumObjects(); i < n; ++i) {
+        const Unit& u = m_units[i];
+        if (Object* obj = newState.getObject(i)) {
+            obj->setOwner(u.owner);
+            obj->setDamage(u.damage);
+            obj->setShield(u.shield);
+            if (Ship* sh = dynamic_cast<Ship*>(obj)) {
+                sh->setCrew(u.crewOrDefense);
+                sh->setAmmo(u.ammoOrFighters);
+            }
+            if (Planet* pl = dynamic_cast<Planet*>(obj)) {
+                pl->setDefense(u.crewOrDefense);
+                pl->setNumBaseFighters(u.ammoOrFighters);
+            }
+        }
+        stats.push_back(game::vcr::Statistic(u.minFightersAboard, u.numTorpedoHits, u.numFights));
+    }
+
+    result.this_battle_index   = m_serial;
+    result.num_battles         = m_numBattles;
+    result.this_battle_weight  = m_thisBattleWeight;
+    result.total_battle_weight = m_totalBattleWeight;
+    result.series_length       = m_seriesLength;
+    result.battles             = 0;
+    return true;
+}
+
+// Get serial number (Result::this_battle_index).
+int32_t
+game::sim::RunRecord::getSerial() const
+{
+    return m_serial;
+}
+
+// Check whether the simulation produced any battles.
+bool
+game::sim::RunRecord::hasBattles() const
+{
+    return m_numBattles != 0;
+}
+
+// Format as text.
+String_t
+game::sim::RunRecord::toString() const
+{
+    String_t result(1, PREFIX);
+    result += afl::string::Format(" %d %d %d %d %d %d", m_serial, m_numBattles, m_thisBattleWeight, m_totalBattleWeight, m_seriesLength, int32_t(m_units.size()));
+    for (size_t i = 0, n = m_units.size(); i < n; ++i) {
+        const Unit& u = m_units[i];
+        result += afl::string::Format(" %d %d %d %d %d %d %d %d",
+                                      u.owner, u.damage, u.shield, u.crewOrDefense, u.ammoOrFighters,
+                                      u.minFightersAboard, u.numTorpedoHits, u.numFights);
+    }
+    return result;
+}
+
+// Parse text produced by toString().
+bool
+game::sim::RunRecord::parse(const String_t& line)
+{
+    size_t pos = 0;
+    if (line.empty() || line[0] != PREFIX) {
+        return false;
+    }
+    ++pos;
+
+    int32_t numUnits = 0;
+    if (!parseNumber(line, pos, m_serial)
+        || !parseNumber(line, pos, m_numBattles)
+        || !parseNumber(line, pos, m_thisBattleWeight)
+        || !parseNumber(line, pos, m_totalBattleWeight)
+        || !parseNumber(line, pos, m_seriesLength)
+        || !parseNumber(line, pos, numUnits)
+        || numUnits < 0)
+    {
+        return false;
+    }
+
+    m_units.clear();
+    for (int32_t i = 0; i < numUnits; ++i) {
+        Unit u;
+        if (!parseNumber(line, pos, u.owner)
+            || !parseNumber(line, pos, u.damage)
+            || !parseNumber(line, pos, u.shield)
+            || !parseNumber(line, pos, u.crewOrDefense)
+            || !parseNumber(line, pos, u.ammoOrFighters)
+            || !parseNumber(line, pos, u.minFightersAboard)
+            || !parseNumber(line, pos, u.numTorpedoHits)
+            || !parseNumber(line, pos, u.numFights))
+        {
+            return false;
+        }
+        m_units.push_back(u);
+    }
+
+    // Only trailing whitespace (line terminator) permitted
+    while (pos < line.size()) {
+        if (line[pos] != '\n' && line[pos] != '\r' && line[pos] != ' ') {
+            return false;
+        }
+        ++pos;
+    }
+    return true;
+}
@@ -0,0 +1,96 @@
+/**
+  *  \file game/sim/runrecord.hpp
+  *  \brief Class game::sim::RunRecord
+  */
+#ifndef C2NG_GAME_SIM_RUNRECORD_HPP
+#define C2NG_GAME_SIM_RUNRECORD_HPP
+
+#include <vector>
+#include "afl/base/memory.hpp"
+#include "afl/base/types.hpp"
+#include "afl/string/string.hpp"
+#include "game/vcr/statistic.hpp"
+
+namespace game { namespace sim {
+
+    class Result;
+    class Setup;
+
+    /** Compact result of a single simulation run.
+        Contains everything ResultList::addResult() needs to account a simulation run,
+        except for the battles themselves, in a form that can be transferred as a single line of text.
+
+        This is used to run simulations in separate processes:
+        a worker runs the simulation, packs the result, and sends it to the coordinator which unpacks it.
+        The coordinator must have the same simulator input (Setup) as the worker.
+
+        Only state that can be changed by a simulation (owner, damage, shield, crew/defense, ammo/fighters)
+        and the VCR statistics are transferred. */
+    class RunRecord {
+     public:
+        /** Constructor.
+            Makes an empty record (serial 0, no battles). */
+        RunRecord();
+
+        /** Destructor. */
+        ~RunRecord();
+
+        /** Pack a simulation result.
+            \param newState [in] Simulator output
+            \param stats    [in] VCR statistics; array parallels Setup::getObject()
+            \param result   [in] Result meta-information provided by simulator */
+        void pack(const Setup& newState, afl::base::Memory<const game::vcr::Statistic> stats, const Result& result);
+
+        /** Unpack a simulation result.
+            Produces the parameters for ResultList::addResult().
+            The result will not contain battles.
+            \param [in]  oldState  Simulator input; must be the same as used to produce the result
+            \param [out] newState  Simulator output
+            \param [out] stats     VCR statistics
+            \param [out] result    Result meta-information
+            \retval true  Success
+            \retval false Record does not match \c oldState */
+        bool unpack(const Setup& oldState, Setup& newState, std::vector<game::vcr::Statistic>& stats, Result& result) const;
+
+        /** Get serial number (Result::this_battle_index).
+            \return serial number */
+        int32_t getSerial() const;
+
+        /** Check whether the simulation produced any battles.
+            Results without battles are not added to a ResultList.
+            \return true if battles were fought */
+        bool hasBattles() const;
+
+        /** Format as text.
+            \return single line of text, without line terminator */
+        String_t toString() const;
+
+        /** Parse text produced by toString().
+            \param line Line of text; trailing whitespace (line terminator) is ignored
+            \retval true  Success; record has been updated
+            \retval false Syntax error; record content is unspecified */
+        bool parse(const String_t& line);
+
+     private:
+        struct Unit {
+            int32_t owner;
+            int32_t damage;
+            int32_t shield;
+            int32_t crewOrDefense;
+            int32_t ammoOrFighters;
+            int32_t minFightersAboard;
+            int32_t numTorpedoHits;
+            int32_t numFights;
+        };
+
+        int32_t m_serial;
+        int32_t m_numBattles;
+        int32_t m_thisBattleWeight;
+        int32_t m_totalBattleWeight;
+        int32_t m_seriesLength;
+        std::vector<Unit> m_units;
+    };
+
+} }
+
+#endif
@@ -58,16 +58,26 @@ game::sim::Setup&
 game::sim::Setup::operator=(const Setup& other)
 {
     if (&other != this) {
-        // Clear
-        m_ships.clear();
-        m_planet.reset();
-
-        // Copy other
-        m_ships.reserve(other.m_ships.size());
-        for (Slot_t i = 0, n = other.m_ships.size(); i < n; ++i) {
+        // Ships: assign existing objects in place, then add or remove as needed.
+        // This avoids re-allocating everything when a Setup is repeatedly reset from the same template.
+        const Slot_t numShips = other.m_ships.size();
+        while (m_ships.size() > numShips) {
+            m_ships.popBack();
+        }
+        for (Slot_t i = 0, n = m_ships.size(); i < n; ++i) {
+            *m_ships[i] = *other.m_ships[i];
+        }
+        m_ships.reserve(numShips);
+        for (Slot_t i = m_ships.size(); i < numShips; ++i) {
             m_ships.pushBackNew(new Ship(*other.m_ships[i]));
         }
-        if (other.m_planet.get() != 0) {
+
+        // Planet
+        if (other.m_planet.get() == 0) {
+            m_planet.reset();
+        } else if (m_planet.get() != 0) {
+            *m_planet = *other.m_planet;
+        } else {
             m_planet.reset(new Planet(*other.m_planet));
         }
         m_structureChanged = true;
@@ -58,6 +58,9 @@ namespace game { namespace sim {
         ~Setup();
 
         /** Assign another setup.
+            Existing ship and planet objects are reused and updated in place where possible,
+            so repeatedly resetting a Setup from the same template does not allocate.
+            Pointers to objects may therefore remain valid, but refer to the new content.
             \param other Other setup */
         Setup& operator=(const Setup& other);
 
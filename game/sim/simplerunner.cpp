@@ -22,12 +22,10 @@ void
 game::sim::SimpleRunner::run(Limit_t limit, util::StopSignal& stopper)
 {
     // ex WSimResultWindow::runSimulation (sort-of)
-    while (1) {
-        std::auto_ptr<Job> p(makeJob(limit, stopper));
-        if (p.get() == 0) {
-            break;
-        }
-        runJob(p.get());
-        finishJob(p.release());
+    std::auto_ptr<Job> p;
+    while (makeJob(p, limit, stopper)) {
+        do {
+            runJob(*p);
+        } while (!finishJob(*p));
     }
 }
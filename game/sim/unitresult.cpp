@@ -108,7 +108,7 @@ game::sim::UnitResult::changeWeight(int32_t oldWeight, int32_t newWeight)
 }
 
 // Add unit result from ship.
-void
+bool
 game::sim::UnitResult::addResult(const Ship& oldShip, const Ship& newShip, const game::vcr::Statistic& stat, const Result& res)
 {
     // ex GSimResultSummary::UnitResult::addResult, ccsim.pas:ComputePerShipResult
@@ -126,32 +126,34 @@ game::sim::UnitResult::addResult(const Ship& oldShip, const Ship& newShip, const
 
     /* Statistics counters */
     // FIXME: NTP?
+    bool specimen = false;
     if (oldShip.getNumLaunchers() != 0) {
-        add(m_numTorpedoesFired, oldShip.getAmmo() - newShip.getAmmo(), res);
+        specimen |= add(m_numTorpedoesFired, oldShip.getAmmo() - newShip.getAmmo(), res);
     } else {
-        add(m_numTorpedoesFired, 0, res);
+        specimen |= add(m_numTorpedoesFired, 0, res);
     }
 
     if (oldShip.getNumBays() != 0) {
-        add(m_numFightersLost, oldShip.getAmmo() - newShip.getAmmo(), res);
+        specimen |= add(m_numFightersLost, oldShip.getAmmo() - newShip.getAmmo(), res);
     } else {
-        add(m_numFightersLost, 0, res);
+        specimen |= add(m_numFightersLost, 0, res);
     }
 
-    add(m_damage, newShip.getDamage(), res);
-    add(m_shield, newShip.getShield(), res);
-    add(m_crewLeftOrDefenseLost, newShip.getCrew(), res);
+    specimen |= add(m_damage, newShip.getDamage(), res);
+    specimen |= add(m_shield, newShip.getShield(), res);
+    specimen |= add(m_crewLeftOrDefenseLost, newShip.getCrew(), res);
 
     if (oldShip.getNumLaunchers() != 0) {
-        add(m_numTorpedoHits, stat.getNumTorpedoHits(), res);
+        specimen |= add(m_numTorpedoHits, stat.getNumTorpedoHits(), res);
     }
     if (oldShip.getNumBays() != 0) {
-        add(m_minFightersAboard, stat.getMinFightersAboard(), res);
+        specimen |= add(m_minFightersAboard, stat.getMinFightersAboard(), res);
     }
+    return specimen;
 }
 
 // Add unit result from planet.
-void
+bool
 game::sim::UnitResult::addResult(const Planet& oldPlanet, const Planet& newPlanet, const game::vcr::Statistic& stat, const Result& res)
 {
     // ex GSimResultSummary::UnitResult::addResult
@@ -169,34 +171,41 @@ game::sim::UnitResult::addResult(const Planet& oldPlanet, const Planet& newPlane
 
     /* Statistics counters */
     // FIXME: m_numTorpedoesFired
-    add(m_numFightersLost, oldPlanet.getNumBaseFighters() - newPlanet.getNumBaseFighters(), res);
-    add(m_damage, newPlanet.getDamage(), res);
-    add(m_shield, newPlanet.getShield(), res);
-    add(m_crewLeftOrDefenseLost, oldPlanet.getDefense() - newPlanet.getDefense(), res);
+    bool specimen = false;
+    specimen |= add(m_numFightersLost, oldPlanet.getNumBaseFighters() - newPlanet.getNumBaseFighters(), res);
+    specimen |= add(m_damage, newPlanet.getDamage(), res);
+    specimen |= add(m_shield, newPlanet.getShield(), res);
+    specimen |= add(m_crewLeftOrDefenseLost, oldPlanet.getDefense() - newPlanet.getDefense(), res);
 
-    add(m_numTorpedoHits,    stat.getNumTorpedoHits(),    res);
-    add(m_minFightersAboard, stat.getMinFightersAboard(), res);
+    specimen |= add(m_numTorpedoHits,    stat.getNumTorpedoHits(),    res);
+    specimen |= add(m_minFightersAboard, stat.getMinFightersAboard(), res);
+    return specimen;
 }
 
 // Add single result value.
-void
+bool
 game::sim::UnitResult::add(Item& it, int32_t value, const Result& w)
 {
     // ex GSimStatItem::add
+    bool specimen = false;
     if (w.this_battle_index == 0) {
         it.min = it.max = value;
         it.minSpecimen = it.maxSpecimen = w.battles;
+        specimen = true;
     } else {
         if (it.min > value) {
             it.min = value;
             it.minSpecimen = w.battles;
+            specimen = true;
         }
         if (it.max < value) {
             it.max = value;
             it.maxSpecimen = w.battles;
+            specimen = true;
         }
     }
     it.totalScaled += value * w.this_battle_weight;
+    return specimen;
 }
 
 // Change weight proportionally.
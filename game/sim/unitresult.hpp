@@ -65,16 +65,18 @@ namespace game { namespace sim {
             \param oldShip [in] Original ship
             \param newShip [in] Ship at end of battle
             \param stat    [in] Extra statistic from VCR
-            \param res     [in] Battle result record (needed for this_battle_index, this_battle_weight) */
-        void addResult(const Ship& oldShip, const Ship& newShip, const game::vcr::Statistic& stat, const Result& res);
+            \param res     [in] Battle result record (needed for this_battle_index, this_battle_weight)
+            \return true if res.battles was stored as a new minimum or maximum specimen */
+        bool addResult(const Ship& oldShip, const Ship& newShip, const game::vcr::Statistic& stat, const Result& res);
 
         /** Add unit result from planet.
             The first call must have res.this_battle_index=0, subsequent calls must have res.this_battle_index!=0.
             \param oldPlanet [in] Original planet
             \param newPlanet [in] Planet at end of battle
             \param stat      [in] Extra statistic from VCR
-            \param res       [in] Battle result record (needed for this_battle_index, this_battle_weight) */
-        void addResult(const Planet& oldPlanet, const Planet& newPlanet, const game::vcr::Statistic& stat, const Result& res);
+            \param res       [in] Battle result record (needed for this_battle_index, this_battle_weight)
+            \return true if res.battles was stored as a new minimum or maximum specimen */
+        bool addResult(const Planet& oldPlanet, const Planet& newPlanet, const game::vcr::Statistic& stat, const Result& res);
 
      private:
         int m_numFightsWon;                  ///< Number of times this ship survived. ex won.
@@ -88,7 +90,7 @@ namespace game { namespace sim {
         Item m_numTorpedoHits;               ///< Torps hit (ships and planets). ex torps_hit.
         Item m_minFightersAboard;            ///< Minimum fighters on unit at any one time (ships and planets). ex min_fighters_aboard.
 
-        static void add(Item& it, int32_t value, const Result& w);
+        static bool add(Item& it, int32_t value, const Result& w);
         static void changeWeight(Item& it, int32_t oldWeight, int32_t newWeight);
     };
 
@@ -107,16 +107,34 @@ void
 game::TurnLoader::saveCurrentDatabases(const Turn& turn, const Game& game, int player, const Root& root, Session& session, afl::charset::Charset& charset)
 {
     // Save starchart
+    // Update the existing file if possible; otherwise, rewrite it.
     if (game::spec::ShipList* shipList = session.getShipList().get()) {
-        afl::base::Ref<afl::io::Stream> out = root.gameDirectory().openFile(afl::string::Format("chart%d.cc", player), afl::io::FileSystem::Create);
-        game::db::Loader(charset, session.world(), session.translator()).save(*out, turn, game, *shipList);
+        const String_t fileName = afl::string::Format("chart%d.cc", player);
+        game::db::Loader loader(charset, session.world(), session.translator());
+        bool updated = false;
+        {
+            afl::base::Ptr<afl::io::Stream> file = root.gameDirectory().openFileNT(fileName, afl::io::FileSystem::OpenWrite);
+            updated = (file.get() != 0 && loader.update(*file, turn, game, *shipList));
+        }
+        if (!updated) {
+            afl::base::Ref<afl::io::Stream> out = root.gameDirectory().openFile(fileName, afl::io::FileSystem::Create);
+            loader.saveIndexed(*out, turn, game, *shipList);
+        }
     }
 
     // Save scores
     // ex saveStatisticsFile
     if (!game.scores().hasFutureFeatures()) {
-        afl::base::Ref<afl::io::Stream> out = root.gameDirectory().openFile("score.cc", afl::io::FileSystem::Create);
-        game::score::Loader(session.translator(), charset).save(game.scores(), *out);
+        game::score::Loader loader(session.translator(), charset);
+        bool updated = false;
+        {
+            afl::base::Ptr<afl::io::Stream> file = root.gameDirectory().openFileNT("score.cc", afl::io::FileSystem::OpenWrite);
+            updated = (file.get() != 0 && loader.update(game.scores(), *file));
+        }
+        if (!updated) {
+            afl::base::Ref<afl::io::Stream> out = root.gameDirectory().openFile("score.cc", afl::io::FileSystem::Create);
+            loader.save(game.scores(), *out);
+        }
     } else {
         session.log().write(afl::sys::LogListener::Warn, LOG_NAME, session.translator()("The statistics file in game directory was written by a newer version of PCC2; changes not written."));
     }
@@ -15,7 +15,7 @@
 #include "afl/string/nulltranslator.hpp"
 #include "game/exception.hpp"
 #include "game/v3/trn/turnprocessor.hpp"
-#include "game/v3/turnfile.hpp"
+#include "game/v3/turnfileview.hpp"
 #include "util/math.hpp"
 #include "util/string.hpp"
 
@@ -773,7 +773,7 @@ game::v3::check::Checker::loadTurn(const uint8_t (&rst_timestamp)[18])
     afl::string::NullTranslator tx;        // FIXME
     String_t ntrn = Format("player%d.trn", m_player);
     Ref<Stream> trn = openGameFile(ntrn);
-    TurnFile tf(cs, tx, *trn, true);
+    TurnFileView tf(trn->createVirtualMapping(), ntrn, tx, true);
 
     // Validate header info
     if (tf.getPlayer() != m_player) {
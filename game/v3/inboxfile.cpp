@@ -197,17 +197,35 @@ String_t
 game::v3::InboxFile::loadMessage(size_t index) const
 {
     // ex GInbox::loadInbox (part)
+    afl::base::GrowableBytes_t buffer;
+    if (loadMessageData(index, buffer)) {
+        return decodeMessageData(buffer);
+    } else {
+        return String_t();
+    }
+}
+
+// Load a message's raw data.
+bool
+game::v3::InboxFile::loadMessageData(size_t index, afl::base::GrowableBytes_t& out) const
+{
     if (structures::IncomingMessageHeader* mh = m_directory.at(index)) {
-        afl::base::GrowableMemory<uint8_t> buffer;
-        buffer.resize(mh->length);
+        out.resize(mh->length);
         m_file.setPos(mh->address-1);
-        m_file.fullRead(buffer);
-        return tweakIncomingHeader(decodeMessage(buffer, m_charset, true /* FIXME: getUserPreferences().RewrapMessages() */));
+        m_file.fullRead(out);
+        return true;
     } else {
-        return String_t();
+        return false;
     }
 }
 
+// Decode a message.
+String_t
+game::v3::InboxFile::decodeMessageData(afl::base::ConstBytes_t data) const
+{
+    return tweakIncomingHeader(decodeMessage(data, m_charset, true /* FIXME: getUserPreferences().RewrapMessages() */));
+}
+
 // Initialize.
 void
 game::v3::InboxFile::init(afl::string::Translator& tx)
@@ -45,6 +45,19 @@ namespace game { namespace v3 {
             \return message; empty string if number is out of range */
         String_t loadMessage(size_t index) const;
 
+        /** Load a message's raw data.
+            This will access the file and load the message without decoding it.
+            Use this to inspect the encoded message before deciding whether to decode it using decodeMessageData().
+            \param [in]  index Message number [0,getNumMessages())
+            \param [out] out   Message data
+            \return true on success, false if number is out of range */
+        bool loadMessageData(size_t index, afl::base::GrowableBytes_t& out) const;
+
+        /** Decode a message.
+            \param data Message data obtained by loadMessageData()
+            \return message, same as loadMessage() would return */
+        String_t decodeMessageData(afl::base::ConstBytes_t data) const;
+
      private:
         /** Initialize. This loads the message directory. */
         void init(afl::string::Translator& tx);
@@ -4,6 +4,7 @@
   */
 
 #include "game/v3/loader.hpp"
+#include "afl/base/growablememory.hpp"
 #include "afl/base/staticassert.hpp"
 #include "afl/except/assertionfailedexception.hpp"
 #include "afl/except/fileformatexception.hpp"
@@ -100,6 +101,18 @@ namespace {
         return s;
     }
 
+    /* Read a block of records.
+       Reading a section at once avoids the per-record overhead of the stream.
+       \param file  File to read from
+       \param out   [out] Records
+       \param count Number of records to read; negative treated as zero */
+    template<typename T>
+    void readRecords(afl::io::Stream& file, afl::base::GrowableMemory<T>& out, int count)
+    {
+        out.resize(count > 0 ? size_t(count) : 0);
+        file.fullRead(out.toBytes());
+    }
+
     /* Try to guess a game name */
     void guessGameName(game::config::StringOption& gameName, afl::io::Directory& dir, afl::charset::Charset& cs)
     {
@@ -188,10 +201,11 @@ game::v3::Loader::loadPlanets(game::map::Universe& univ, afl::io::Stream& file,
     // ex game/load.cc:loadPlanets
     m_log.write(LogListener::Debug, LOG_NAME, afl::string::Format(m_translator("Loading %d planet%!1{s%}..."), count));
     Reverter* pReverter = dynamic_cast<Reverter*>(univ.getReverter());
-    while (count > 0) {
-        gt::Planet rawPlanet;
-        file.fullRead(afl::base::fromObject(rawPlanet));
-
+    Packer packer(m_charset);
+    afl::base::GrowableMemory<gt::Planet> rawPlanets;
+    readRecords(file, rawPlanets, count);
+    for (size_t i = 0, n = rawPlanets.size(); i < n; ++i) {
+        const gt::Planet& rawPlanet = *rawPlanets.at(i);
         const int planetId = rawPlanet.planetId;
         map::Planet* p = univ.planets().get(planetId);
         if (!p) {
@@ -200,7 +214,7 @@ game::v3::Loader::loadPlanets(game::map::Universe& univ, afl::io::Stream& file,
 
         // Unpack the planet
         game::map::PlanetData planetData;
-        Packer(m_charset).unpackPlanet(planetData, rawPlanet);
+        packer.unpackPlanet(planetData, rawPlanet);
         if (mode != LoadPrevious) {
             p->addCurrentPlanetData(planetData, source);
         }
@@ -209,7 +223,6 @@ game::v3::Loader::loadPlanets(game::map::Universe& univ, afl::io::Stream& file,
                 pReverter->addPlanetData(planetId, planetData);
             }
         }
-        --count;
     }
 }
 
@@ -275,10 +288,11 @@ game::v3::Loader::loadBases(game::map::Universe& univ, afl::io::Stream& file, in
     // ex game/load.h:loadBases, ccload.pas:LoadBases
     m_log.write(LogListener::Debug, LOG_NAME, afl::string::Format(m_translator("Loading %d starbase%!1{s%}..."), count));
     Reverter* pReverter = dynamic_cast<Reverter*>(univ.getReverter());
-    while (count > 0) {
-        gt::Base rawBase;
-        file.fullRead(afl::base::fromObject(rawBase));
-
+    Packer packer(m_charset);
+    afl::base::GrowableMemory<gt::Base> rawBases;
+    readRecords(file, rawBases, count);
+    for (size_t i = 0, n = rawBases.size(); i < n; ++i) {
+        const gt::Base& rawBase = *rawBases.at(i);
         const int baseId = rawBase.baseId;
         map::Planet* p = univ.planets().get(baseId);
         if (!p) {
@@ -287,7 +301,7 @@ game::v3::Loader::loadBases(game::map::Universe& univ, afl::io::Stream& file, in
 
         // Unpack the base
         game::map::BaseData baseData;
-        Packer(m_charset).unpackBase(baseData, rawBase);
+        packer.unpackBase(baseData, rawBase);
 
         if (mode != LoadPrevious) {
             p->addCurrentBaseData(baseData, source);
@@ -297,7 +311,6 @@ game::v3::Loader::loadBases(game::map::Universe& univ, afl::io::Stream& file, in
                 pReverter->addBaseData(baseId, baseData);
             }
         }
-        --count;
     }
 }
 
@@ -349,10 +362,11 @@ game::v3::Loader::loadShips(game::map::Universe& univ, afl::io::Stream& file, in
 {
     m_log.write(LogListener::Debug, LOG_NAME, afl::string::Format(m_translator("Loading %d ship%!1{s%}..."), count));
     Reverter* pReverter = dynamic_cast<Reverter*>(univ.getReverter());
-    while (count > 0) {
-        gt::Ship rawShip;
-        file.fullRead(afl::base::fromObject(rawShip));
-
+    Packer packer(m_charset);
+    afl::base::GrowableMemory<gt::Ship> rawShips;
+    readRecords(file, rawShips, count);
+    for (size_t i = 0, n = rawShips.size(); i < n; ++i) {
+        const gt::Ship& rawShip = *rawShips.at(i);
         const int shipId = rawShip.shipId;
         map::Ship* s = univ.ships().get(shipId);
         if (!s) {
@@ -361,7 +375,7 @@ game::v3::Loader::loadShips(game::map::Universe& univ, afl::io::Stream& file, in
 
         // Unpack the ship
         map::ShipData shipData;
-        Packer(m_charset).unpackShip(shipData, rawShip, remapExplore);
+        packer.unpackShip(shipData, rawShip, remapExplore);
 
         if (mode != LoadPrevious) {
             s->addCurrentShipData(shipData, source);
@@ -371,7 +385,6 @@ game::v3::Loader::loadShips(game::map::Universe& univ, afl::io::Stream& file, in
                 pReverter->addShipData(shipId, shipData);
             }
         }
-        --count;
     }
 }
 
@@ -381,9 +394,10 @@ game::v3::Loader::loadTargets(game::map::Universe& univ, afl::io::Stream& file,
 {
     // ex game/load.cc:loadTargets, ccmain.pas:LoadTargets, ccmain.pas:LoadTargetFile
     m_log.write(LogListener::Debug, LOG_NAME, afl::string::Format(m_translator("Loading %d visual contact%!1{s%}..."), count));
-    while (count > 0) {
-        gt::ShipTarget target;
-        file.fullRead(afl::base::fromObject(target));
+    afl::base::GrowableMemory<gt::ShipTarget> targets;
+    readRecords(file, targets, count);
+    for (size_t i = 0, n = targets.size(); i < n; ++i) {
+        gt::ShipTarget& target = *targets.at(i);
 
         // Decrypt the target
         if (fmt == TargetEncrypted) {
@@ -391,8 +405,6 @@ game::v3::Loader::loadTargets(game::map::Universe& univ, afl::io::Stream& file,
         }
 
         addTarget(univ, target, source, turnNumber);
-
-        --count;
     }
 }
 
@@ -26,7 +26,11 @@ namespace game { namespace v3 {
         Conventions for v3:
         - most objects are created beforehand: ships, planets, ion storms (prepareUniverse() function)
         - data segments for those objects are loaded by individual functions. Each of those only accesses existing objects
-          and thus implicitly detects out-of-range Ids. */
+          and thus implicitly detects out-of-range Ids.
+        - sections are read as a block and decoded into the objects immediately.
+          A truncated section fails before any object of that section is modified.
+          Decoding is not deferred to first access: turn postprocessing (Universe::postprocess, message parsing)
+          visits every object right after loading anyway. */
     class Loader {
      public:
         /** Constructor.
@@ -2,20 +2,117 @@
   *  \file game/v3/trn/turnprocessor.cpp
   */
 
+#include <algorithm>
+#include <vector>
 #include "game/v3/trn/turnprocessor.hpp"
 #include "game/v3/inboxfile.hpp"
 
+using game::v3::TurnFile;
+using game::v3::TurnFileView;
+
+namespace {
+    /* Command order of a TurnFileView */
+    class CommandOrder {
+     public:
+        CommandOrder(const TurnFileView& view)
+            : m_view(view)
+            { }
+        bool operator()(size_t a, size_t b) const
+            {
+                TurnFile::CommandCode_t cca, ccb;
+                int ida, idb;
+                return m_view.getCommandCode(a, cca) && m_view.getCommandId(a, ida)
+                    && m_view.getCommandCode(b, ccb) && m_view.getCommandId(b, idb)
+                    && TurnFile::isCommandBefore(cca, ida, ccb, idb);
+            }
+     private:
+        const TurnFileView& m_view;
+    };
+
+    /* Sorted view of a TurnFileView.
+       Provides the read accessors of a TurnFile after sortCommands(), without copying the command data. */
+    class SortedView {
+     public:
+        SortedView(const TurnFileView& view)
+            : m_view(view),
+              m_order()
+            {
+                for (size_t i = 0, n = view.getNumCommands(); i < n; ++i) {
+                    m_order.push_back(i);
+                }
+                std::stable_sort(m_order.begin(), m_order.end(), CommandOrder(view));
+            }
+
+        size_t getNumCommands() const
+            { return m_order.size(); }
+        bool getCommandCode(size_t index, TurnFile::CommandCode_t& out) const
+            { return index < m_order.size() && m_view.getCommandCode(m_order[index], out); }
+        bool getCommandId(size_t index, int& out) const
+            { return index < m_order.size() && m_view.getCommandId(m_order[index], out); }
+        bool getCommandLength(size_t index, int& out) const
+            { return index < m_order.size() && m_view.getCommandLength(m_order[index], out); }
+        afl::base::ConstBytes_t getCommandData(size_t index) const
+            { return index < m_order.size() ? m_view.getCommandData(m_order[index]) : afl::base::ConstBytes_t(); }
+
+        bool getCommandType(size_t index, TurnFile::CommandType& out) const
+            {
+                TurnFile::CommandCode_t code;
+                if (getCommandCode(index, code)) {
+                    out = TurnFile::getCommandCodeType(code);
+                    return true;
+                } else {
+                    return false;
+                }
+            }
+
+        // \see TurnFile::findCommandRunLength
+        size_t findCommandRunLength(size_t index) const
+            {
+                size_t runLength = 0;
+                TurnFile::CommandType startType;
+                int startId;
+                if (getCommandType(index, startType) && getCommandId(index, startId)) {
+                    TurnFile::CommandType nextType;
+                    int nextId;
+                    do {
+                        ++runLength;
+                    } while (getCommandType(index+runLength, nextType) && getCommandId(index+runLength, nextId) && nextType == startType && nextId == startId);
+                }
+                return runLength;
+            }
+
+     private:
+        const TurnFileView& m_view;
+        std::vector<size_t> m_order;
+    };
+}
+
 game::v3::trn::TurnProcessor::TurnProcessor()
 { }
 
 game::v3::trn::TurnProcessor::~TurnProcessor()
 { }
 
+// Process a turn file.
 void
 game::v3::trn::TurnProcessor::handleTurnFile(TurnFile& f, afl::charset::Charset& charset)
 {
     f.sortCommands();
+    processCommands(f, charset);
+}
 
+// Process a read-only turn file.
+void
+game::v3::trn::TurnProcessor::handleTurnFile(const TurnFileView& f, afl::charset::Charset& charset)
+{
+    processCommands(SortedView(f), charset);
+}
+
+/* Process commands of a turn file (TurnFile or SortedView) that is in canonical order */
+template<typename File>
+void
+game::v3::trn::TurnProcessor::processCommands(const File& f, afl::charset::Charset& charset)
+{
     // Pass 1: verify commands
     for (size_t i = 0, n = f.getNumCommands(); i < n; ++i) {
         int cmdId;
@@ -7,6 +7,7 @@
 
 #include "game/v3/structures.hpp"
 #include "game/v3/turnfile.hpp"
+#include "game/v3/turnfileview.hpp"
 #include "afl/charset/charset.hpp"
 
 namespace game { namespace v3 { namespace trn {
@@ -21,8 +22,19 @@ namespace game { namespace v3 { namespace trn {
         TurnProcessor();
         virtual ~TurnProcessor();
 
+        /** Process a turn file.
+            Sorts the turn file's commands into canonical order and processes them.
+            \param f       Turn file
+            \param charset Character set */
         void handleTurnFile(TurnFile& f, afl::charset::Charset& charset);
 
+        /** Process a read-only turn file.
+            Processes the commands in the same order as handleTurnFile(TurnFile&,afl::charset::Charset&),
+            without copying the turn file.
+            \param f       Turn file
+            \param charset Character set */
+        void handleTurnFile(const TurnFileView& f, afl::charset::Charset& charset);
+
         virtual void handleInvalidCommand(int code) = 0;
         virtual void validateShip(int id) = 0;
         virtual void validatePlanet(int id) = 0;
@@ -39,6 +51,10 @@ namespace game { namespace v3 { namespace trn {
         virtual void addMessage(int to, String_t text) = 0;
         virtual void addNewPassword(const NewPassword_t& pass) = 0;
         virtual void addAllianceCommand(String_t text) = 0;
+
+     private:
+        template<typename File>
+        void processCommands(const File& f, afl::charset::Charset& charset);
     };
 
 } } }
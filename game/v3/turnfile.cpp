@@ -12,9 +12,8 @@
 #include "afl/bits/int32le.hpp"
 #include "afl/bits/pack.hpp"
 #include "afl/checksums/bytesum.hpp"
-#include "afl/except/fileformatexception.hpp"
-#include "afl/except/filetooshortexception.hpp"
 #include "game/v3/registrationkey.hpp"
+#include "game/v3/turnfileview.hpp"
 #include "util/randomnumbergenerator.hpp"
 
 namespace {
@@ -189,16 +188,6 @@ namespace {
         }
     }
 
-    // FIXME: move to afl
-    void readVector(afl::io::Stream& in, afl::base::GrowableMemory<uint8_t>& bytes)
-    {
-        uint8_t page[4096];
-        while (size_t n = in.read(page)) {
-            bytes.append(afl::base::ConstBytes_t(page).trim(n));
-        }
-    }
-
-
     /** Turn Command Comparator. */
     class CommandComparator {
      public:
@@ -212,46 +201,19 @@ namespace {
     };
 
     /** Returns true iff command at offset a precedes command at offset b.
-        Canonical command order is:
-        - for all ships, in sid order, ship commands in command code order;
-        - for all planets, in pid order, planet commands in command code order;
-        - for all bases, in bid order, base commands in command code order;
-        - messages (60);
-        - change password (61);
-        - sendback (62).
-
-        Note that this will sort undefined commands at the beginning. */
+        \see TurnFile::isCommandBefore */
     bool CommandComparator::operator()(int32_t a, int32_t b)
     {
         using game::v3::TurnFile;
         using afl::bits::Int16LE;
 
-        // Get command codes
-        int16_t cca, ccb;
-        if (!get<Int16LE>(m_turnData, a, cca) || !get<Int16LE>(m_turnData, b, ccb)) {
+        int16_t cca, ccb, ida, idb;
+        if (!get<Int16LE>(m_turnData, a, cca) || !get<Int16LE>(m_turnData, b, ccb)
+            || !get<Int16LE>(m_turnData, a+2, ida) || !get<Int16LE>(m_turnData, b+2, idb))
+        {
             return false;
         }
-
-        // Get types
-        TurnFile::CommandType typa = TurnFile::getCommandCodeType(cca);
-        TurnFile::CommandType typb = TurnFile::getCommandCodeType(ccb);
-        if (typa == typb) {
-            // types are equal
-            if (typa == TurnFile::OtherCommand) {
-                return cca < ccb;
-            } else {
-                int16_t ida, idb;
-                if (!get<Int16LE>(m_turnData, a+2, ida) || !get<Int16LE>(m_turnData, b+2, idb)) {
-                    return false;
-                } else if (ida == idb) {
-                    return cca < ccb;
-                } else {
-                    return ida < idb;
-                }
-            }
-        } else {
-            return typa < typb;
-        }
+        return TurnFile::isCommandBefore(TurnFile::CommandCode_t(cca), ida, TurnFile::CommandCode_t(ccb), idb);
     }
 }
 
@@ -291,7 +253,24 @@ game::v3::TurnFile::TurnFile(afl::charset::Charset& charset, afl::string::Transl
       m_isDirty(false)
 {
     // ex GTurnfile::GTurnfile
-    init(str, tx, fullParse);
+    init(TurnFileView(str.createVirtualMapping(), str.getName(), tx, fullParse), fullParse);
+}
+
+// Read turn file from a view.
+game::v3::TurnFile::TurnFile(afl::charset::Charset& charset, const TurnFileView& view, bool fullParse)
+    : m_charset(charset),
+      m_turnHeader(),           // zero-initializes!
+      m_taccomHeader(),
+      m_dosTrailer(),
+      m_windowsTrailer(),
+      m_data(),
+      m_offsets(),
+      m_version(CURRENT_VERSION),
+      m_features(),
+      m_turnPlacement(0),
+      m_isDirty(false)
+{
+    init(view, fullParse);
 }
 
 // Destructor.
@@ -490,39 +469,8 @@ game::v3::TurnFile::getCommandCode(size_t index, CommandCode_t& out) const
 bool
 game::v3::TurnFile::getCommandLength(size_t index, int& out) const
 {
-    CommandCode_t cmd = 0;
-    if (!getCommandCode(index, cmd)) {
-        // Command code not accessible --> length not known
-        return false;
-    } else if (cmd == tcm_SendMessage) {
-        // Sender, Receiver, Text --> 4 bytes for sender/receiver, plus length (in Id slot)
-        int id;
-        if (getCommandId(index, id)) {
-            out = id + 4;
-            return true;
-        } else {
-            return false;
-        }
-    } else if (cmd == tcm_SendBack) {
-        // Type, Size, Data --> 4 bytes, plus length
-        int16_t size;
-        const uint32_t* p = m_offsets.at(index);
-        if (p == 0) {
-            return false;
-        } else if (get<afl::bits::Int16LE>(m_data, *p + 6, size)) {
-            out = size + 4;
-            return true;
-        } else {
-            return false;
-        }
-    } else if (cmd < countof(COMMAND_DEFINITIONS)) {
-        // It's in our command definition list. We know its size if it's not UndefinedCommand.
-        if (COMMAND_DEFINITIONS[cmd].type != UndefinedCommand) {
-            out = COMMAND_DEFINITIONS[cmd].size;
-            return true;
-        } else {
-            return false;
-        }
+    if (const uint32_t* p = m_offsets.at(index)) {
+        return computeCommandLength(afl::base::ConstBytes_t(m_data).subrange(*p), out);
     } else {
         return false;
     }
@@ -680,6 +628,66 @@ game::v3::TurnFile::getCommandCodeRecordIndex(CommandCode_t code)
     }
 }
 
+// Check canonical command order.
+bool
+game::v3::TurnFile::isCommandBefore(CommandCode_t codeA, int idA, CommandCode_t codeB, int idB)
+{
+    // Codes are stored as signed 16-bit values; compare them as such
+    const int16_t cca = int16_t(codeA);
+    const int16_t ccb = int16_t(codeB);
+    const CommandType typa = getCommandCodeType(codeA);
+    const CommandType typb = getCommandCodeType(codeB);
+    if (typa != typb) {
+        return typa < typb;
+    } else if (typa == OtherCommand || idA == idB) {
+        return cca < ccb;
+    } else {
+        return idA < idB;
+    }
+}
+
+// Compute length of command data field, given the command.
+bool
+game::v3::TurnFile::computeCommandLength(afl::base::ConstBytes_t command, int& out)
+{
+    int16_t code;
+    if (!get<afl::bits::Int16LE>(command, 0, code)) {
+        // Command code not accessible --> length not known
+        return false;
+    }
+
+    const CommandCode_t cmd = CommandCode_t(code);
+    if (cmd == tcm_SendMessage) {
+        // Sender, Receiver, Text --> 4 bytes for sender/receiver, plus length (in Id slot)
+        int16_t id;
+        if (get<afl::bits::Int16LE>(command, 2, id)) {
+            out = id + 4;
+            return true;
+        } else {
+            return false;
+        }
+    } else if (cmd == tcm_SendBack) {
+        // Type, Size, Data --> 4 bytes, plus length
+        int16_t size;
+        if (get<afl::bits::Int16LE>(command, 6, size)) {
+            out = size + 4;
+            return true;
+        } else {
+            return false;
+        }
+    } else if (cmd < countof(COMMAND_DEFINITIONS)) {
+        // It's in our command definition list. We know its size if it's not UndefinedCommand.
+        if (COMMAND_DEFINITIONS[cmd].type != UndefinedCommand) {
+            out = COMMAND_DEFINITIONS[cmd].size;
+            return true;
+        } else {
+            return false;
+        }
+    } else {
+        return false;
+    }
+}
+
 
 /*
  *  Modificators
@@ -938,179 +946,39 @@ game::v3::TurnFile::charset() const
  *  Internal
  */
 
-/** Initialize by loading a stream.
-    The stream contains a full turn file (including possible Taccom data).
-    \param str Stream to read
-    \param tx Translator (for error messages)
-    \param fullParse true to read full turn, false to read only headers */
+/** Initialize from a view.
+    \param view View to copy from
+    \param fullParse true to copy full turn, false to copy only headers */
 void
-game::v3::TurnFile::init(afl::io::Stream& str, afl::string::Translator& tx, bool fullParse)
+game::v3::TurnFile::init(const TurnFileView& view, bool fullParse)
 {
     // ex GTurnfile::init
+    m_turnHeader = view.getTurnHeader();
+    m_dosTrailer = view.getDosTrailer();
+    if (view.getFeatures().contains(WinplanFeature)) {
+        m_windowsTrailer = view.getWindowsTrailer();
+        m_features += WinplanFeature;
+        m_version = view.getVersion();
+    }
+
     if (fullParse) {
-        readVector(str, m_data);
-        // FIXME: replace memcmp?
-        if (m_data.size() > sizeof(m_taccomHeader) && std::memcmp(m_data.at(0), TACCOM_MAGIC, 10) == 0) {
-            // Taccom-enhanced TRN
-            afl::base::fromObject(m_taccomHeader).copyFrom(m_data);
+        // Commands are addressed relative to the whole file; keep attachments for write()
+        m_data.append(view.getContent());
+        for (size_t i = 0, n = view.getNumCommands(); i < n; ++i) {
+            size_t pos = 0;
+            view.getCommandPosition(i, pos);
+            m_offsets.append(static_cast<uint32_t>(pos));
+        }
+        if (view.getFeatures().contains(TaccomFeature)) {
+            m_taccomHeader = view.getTaccomHeader();
             m_features += TaccomFeature;
-            parseTurnFile(str, tx, m_taccomHeader.turnAddress - 1, m_taccomHeader.turnSize);
-            for (size_t i = 0; i < structures::MAX_TRN_ATTACHMENTS; ++i) {
-                if (!afl::base::ConstBytes_t(m_taccomHeader.attachments[i].name).empty()) {
-                    // Attachment present
-                    if (m_taccomHeader.turnAddress > m_taccomHeader.attachments[i].address) {
-                        m_turnPlacement = i+1;
-                    }
-                    checkRange(str, tx, m_taccomHeader.attachments[i].address-1, m_taccomHeader.attachments[i].length);
-                }
-            }
-        } else {
-            // Normal TRN
-            parseTurnFile(str, tx, 0, m_data.size());
+            m_turnPlacement = view.getTaccomTurnPlace();
         }
     } else {
-        // Probe for taccom header
-        structures::TaccomTurnHeader tmp;
-        str.fullRead(afl::base::fromObject(tmp));
-        if (std::memcmp(tmp.magic, TACCOM_MAGIC, 10) == 0) {
-            // it's a Taccom turn
-            // FIXME: validate ranges of turnAddress/turnSize
-            parseTurnFileHeader(str, tmp.turnAddress - 1, tmp.turnSize);
-        } else {
-            // it's a real turn
-            parseTurnFileHeader(str, 0, str.getSize());
-        }
         m_isDirty = true;
     }
 }
 
-/** Check a file position.
-    Assumes file already loaded into m_data.
-    \param stream stream we're processing (for generating error messages only)
-    \param tx Translator (for error messages)
-    \param offset,length position/range to verify, zero-based
-    \throw afl::except::FileFormatException on error. */
-void
-game::v3::TurnFile::checkRange(afl::io::Stream& stream, afl::string::Translator& tx, afl::io::Stream::FileSize_t offset, afl::io::Stream::FileSize_t length)
-{
-    // ex GTurnfile::checkRange
-    if (offset > m_data.size() || length > m_data.size() - offset) {
-        throw afl::except::FileFormatException(stream, tx("Invalid file format (bad pointer)"));
-    }
-}
-
-/** Parse Turn File.
-    To be called from the constructor only (assumes most things zeroed).
-    \param stream stream we're processing (for generating error messages only)
-    \param tx Translator (for error messages)
-    \param offset Starting position into file (nonzero for Taccom).
-    \param length Length of turn data.
-    \throw afl::except::FileFormatException on error. */
-void
-game::v3::TurnFile::parseTurnFile(afl::io::Stream& stream, afl::string::Translator& tx, afl::io::Stream::FileSize_t offset, afl::io::Stream::FileSize_t length)
-{
-    // Imports
-    using afl::bits::Int32LE;
-
-    // ex GTurnfile::parseTurnfile
-    checkRange(stream, tx, offset, length);
-
-    // An estimate of the maximum valid command count.
-    // Maximum object commands are 18*999 (ships) + 15*500 (planets) + 15*500 (bases) = 32982, plus messages, password, sendfile and alliances.
-    // The main reason of this check is to avoid overflows in further checks, so we can probably safely assume no turn will contain more than a million commands.
-    // THost rejects everything that has more than 5000.
-    static const int32_t MAX_COMMANDS = 1000000;
-
-    // get a handle to the file data
-    afl::base::ConstBytes_t data(m_data);
-
-    // read & validate trn_header
-    if (length < sizeof(m_turnHeader) + sizeof(m_dosTrailer)) {
-        throw afl::except::FileTooShortException(stream);
-    }
-    afl::base::fromObject(m_turnHeader).copyFrom(data.subrange(offset));
-    if (m_turnHeader.numCommands < 0 || m_turnHeader.numCommands > MAX_COMMANDS) {
-        throw afl::except::FileFormatException(stream, tx("Invalid file format (invalid command count)"));
-    }
-    if (length < sizeof(m_turnHeader) + (m_turnHeader.numCommands != 0) + 4*m_turnHeader.numCommands + sizeof(m_dosTrailer)) {
-        throw afl::except::FileTooShortException(stream);
-    }
-
-    // read & populate command array
-    checkRange(stream, tx, sizeof(m_turnHeader)+1, 4*m_turnHeader.numCommands);
-    afl::base::ConstBytes_t offsetTable = data.subrange(offset + sizeof(m_turnHeader) + 1, 4*m_turnHeader.numCommands);
-    while (const Int32LE::Bytes_t* p = offsetTable.eatN<4>()) {
-        m_offsets.append(static_cast<uint32_t>(offset + Int32LE::unpack(*p) - 1));
-    }
-    for (size_t i = 0, n = m_offsets.size(); i < n; ++i) {
-        checkRange(stream, tx, *m_offsets.at(i), 4);      // each command is at least 4 bytes
-
-        CommandCode_t cmd;
-        if (getCommandCode(i, cmd) && cmd == tcm_SendBack) {
-            checkRange(stream, tx, *m_offsets.at(i), 8);  // getCommandLength() will refer to offset+6
-        }
-
-        int length;
-        if (getCommandLength(i, length)) {
-            checkRange(stream, tx, *m_offsets.at(i), length + 4);
-        }
-    }
-
-    // now read the trailers
-    // FIXME? In case the actual turn data contains "VER3.5nn", this will mis-interpret the turn file in the same way as host does.
-    if (length >= sizeof(m_dosTrailer) + sizeof(m_windowsTrailer) + sizeof(m_turnHeader)) {
-        afl::base::fromObject(m_windowsTrailer).copyFrom(data.subrange(offset + length - sizeof(m_dosTrailer) - sizeof(m_windowsTrailer)));
-        if (std::memcmp(m_windowsTrailer.magic, V35_MAGIC, 6) == 0) {
-            m_features += WinplanFeature;
-            if (m_windowsTrailer.magic[6] >= '0' && m_windowsTrailer.magic[6] <= '9' && m_windowsTrailer.magic[7] >= '0' && m_windowsTrailer.magic[7] <= '9') {
-                m_version = 10*(m_windowsTrailer.magic[6] - '0') + (m_windowsTrailer.magic[7] - '0');
-            }
-        }
-    }
-    if (!m_features.contains(WinplanFeature)) {
-        afl::base::fromObject(m_windowsTrailer).fill(0);
-    }
-
-    afl::base::fromObject(m_dosTrailer).copyFrom(data.subrange(offset + length - sizeof(m_dosTrailer)));
-}
-
-/** Parse headers and trailers directly from a stream.
-    \param stream Stream to read from
-    \param offset Starting position into file (nonzero for Taccom).
-    \param length Length of turn data. */
-void
-game::v3::TurnFile::parseTurnFileHeader(afl::io::Stream& stream, afl::io::Stream::FileSize_t offset, afl::io::Stream::FileSize_t length)
-{
-    // ex GTurnfile::parseTurnfileHeader
-    afl::io::Stream::FileSize_t streamSize = stream.getSize();
-    if (offset >= streamSize || length > streamSize - offset || length < sizeof(m_turnHeader) + sizeof(m_dosTrailer)) {
-        throw afl::except::FileTooShortException(stream);
-    }
-
-    // get the DOS header
-    stream.setPos(offset);
-    stream.fullRead(afl::base::fromObject(m_turnHeader));
-
-    // get the DOS trailer
-    stream.setPos(offset + length - sizeof(m_dosTrailer));
-    stream.fullRead(afl::base::fromObject(m_dosTrailer));
-
-    // get the windows trailer, if existing
-    if (length > sizeof(m_turnHeader) + sizeof(m_dosTrailer) + sizeof(m_windowsTrailer)) {
-        stream.setPos(offset + length - sizeof(m_dosTrailer) - sizeof(m_windowsTrailer));
-        stream.fullRead(afl::base::fromObject(m_windowsTrailer));
-        if (std::memcmp(m_windowsTrailer.magic, V35_MAGIC, 6) == 0) {
-            m_features += WinplanFeature;
-            if (m_windowsTrailer.magic[6] >= '0' && m_windowsTrailer.magic[6] <= '9' && m_windowsTrailer.magic[7] >= '0' && m_windowsTrailer.magic[7] <= '9') {
-                m_version = 10*(m_windowsTrailer.magic[6] - '0') + (m_windowsTrailer.magic[7] - '0');
-            }
-        }
-    }
-    if (!m_features.contains(WinplanFeature)) {
-        afl::base::fromObject(m_windowsTrailer).fill(0);
-    }
-}
-
 /** Generate turn file structure. Called by update().
     The turn must not contain any invalid commands.
     \param data buffer that will receive the turn data (initially empty)
@@ -17,6 +17,7 @@
 namespace game { namespace v3 {
 
     class RegistrationKey;
+    class TurnFileView;
 
     /** TRN Command codes.
         The names are the same as in UN-TRN, the file format list, and some utilities inspired by the above.
@@ -164,6 +165,14 @@ namespace game { namespace v3 {
             \throws FileFormatException on error. */
         TurnFile(afl::charset::Charset& charset, afl::string::Translator& tx, afl::io::Stream& stream, bool fullParse = true);
 
+        /** Read turn file from a view.
+            Construct a TurnFile from an already-parsed TurnFileView.
+            \param charset character set. Lifetime must exceed that of TurnFile.
+            \param view View. Must have been created with the same \c fullParse value.
+            \param fullParse true to copy full turn. false to copy only the turn header (this will remove all attachments and commands)
+            \post fullParse => !dirty */
+        TurnFile(afl::charset::Charset& charset, const TurnFileView& view, bool fullParse = true);
+
         /** Destructor. */
         ~TurnFile();
 
@@ -382,6 +391,31 @@ namespace game { namespace v3 {
             \return Offset; zero if not applicable */
         static size_t getCommandCodeRecordIndex(CommandCode_t code);
 
+        /** Check canonical command order.
+            Canonical command order is:
+            - for all ships, in sid order, ship commands in command code order;
+            - for all planets, in pid order, planet commands in command code order;
+            - for all bases, in bid order, base commands in command code order;
+            - messages (60);
+            - change password (61);
+            - sendback (62).
+
+            Undefined commands sort at the beginning.
+            This is the order established by sortCommands().
+            \param codeA Command code of first command
+            \param idA   Id of first command
+            \param codeB Command code of second command
+            \param idB   Id of second command
+            \return true if first command precedes second command */
+        static bool isCommandBefore(CommandCode_t codeA, int idA, CommandCode_t codeB, int idB);
+
+        /** Compute length of command data field, given the command.
+            \param command [in] Command, starting with the command code. Can be unlimited (include data following the command).
+            \param out     [out] Command length
+            \retval true Command is known, \c out was updated
+            \retval false Command is truncated or not known, \c out unchanged */
+        static bool computeCommandLength(afl::base::ConstBytes_t command, int& out);
+
         /*
          *  Modificators
          */
@@ -512,11 +546,7 @@ namespace game { namespace v3 {
         /* Internal stuff */
         bool m_isDirty;                                  ///< True if data is dirty. If false, data is a valid turn file.
 
-        // FIXME: reconsider using FileSize_t here. size_t or uint32_t should be enough.
-        void init(afl::io::Stream& str, afl::string::Translator& tx, bool fullParse);
-        void checkRange(afl::io::Stream& stream, afl::string::Translator& tx, afl::io::Stream::FileSize_t offset, afl::io::Stream::FileSize_t length);
-        void parseTurnFile(afl::io::Stream& stream, afl::string::Translator& tx, afl::io::Stream::FileSize_t offset, afl::io::Stream::FileSize_t length);
-        void parseTurnFileHeader(afl::io::Stream& stream, afl::io::Stream::FileSize_t offset, afl::io::Stream::FileSize_t length);
+        void init(const TurnFileView& view, bool fullParse);
 
         void updateTurnFile(afl::base::GrowableMemory<uint8_t>& data, afl::base::GrowableMemory<uint32_t>& offsets);
         void makeCommands(int id, int low, int up, afl::base::ConstBytes_t oldObject, afl::base::ConstBytes_t newObject);
@@ -0,0 +1,337 @@
+/**
+  *  \file game/v3/turnfileview.cpp
+  *  \brief Class game::v3::TurnFileView
+  */
+
+#include <cstring>
+#include "game/v3/turnfileview.hpp"
+#include "afl/bits/int16le.hpp"
+#include "afl/bits/int32le.hpp"
+#include "afl/except/fileformatexception.hpp"
+#include "afl/except/filetooshortexception.hpp"
+
+namespace {
+    const char TACCOM_MAGIC[] = "NCC1701AD9";
+    const char V35_MAGIC[] = "VER3.5";
+
+    /* An estimate of the maximum valid command count.
+       Maximum object commands are 18*999 (ships) + 15*500 (planets) + 15*500 (bases) = 32982, plus messages, password, sendfile and alliances.
+       The main reason of this check is to avoid overflows in further checks, so we can probably safely assume no turn will contain more than a million commands.
+       THost rejects everything that has more than 5000. */
+    const int32_t MAX_COMMANDS = 1000000;
+
+    bool getWord(afl::base::ConstBytes_t data, size_t offset, int16_t& out)
+    {
+        data.split(offset);
+        if (const afl::bits::Int16LE::Bytes_t* p = data.eatN<2>()) {
+            out = afl::bits::Int16LE::unpack(*p);
+            return true;
+        } else {
+            return false;
+        }
+    }
+}
+
+// Constructor.
+game::v3::TurnFileView::TurnFileView(afl::base::Ref<afl::io::FileMapping> mapping, const String_t& fileName, afl::string::Translator& tx, bool fullParse)
+    : m_mapping(mapping.asPtr()),
+      m_content(mapping->get()),
+      m_turnHeader(),
+      m_taccomHeader(),
+      m_dosTrailer(),
+      m_windowsTrailer(),
+      m_version(0),
+      m_features(),
+      m_turnPlacement(0),
+      m_turnOffset(0),
+      m_commandTable()
+{
+    init(fileName, tx, fullParse);
+}
+
+// Constructor.
+game::v3::TurnFileView::TurnFileView(afl::base::ConstBytes_t data, const String_t& fileName, afl::string::Translator& tx, bool fullParse)
+    : m_mapping(),
+      m_content(data),
+      m_turnHeader(),
+      m_taccomHeader(),
+      m_dosTrailer(),
+      m_windowsTrailer(),
+      m_version(0),
+      m_features(),
+      m_turnPlacement(0),
+      m_turnOffset(0),
+      m_commandTable()
+{
+    init(fileName, tx, fullParse);
+}
+
+// Destructor.
+game::v3::TurnFileView::~TurnFileView()
+{ }
+
+// Get player number.
+int
+game::v3::TurnFileView::getPlayer() const
+{
+    return m_turnHeader.playerId;
+}
+
+// Get turn timestamp.
+game::Timestamp
+game::v3::TurnFileView::getTimestamp() const
+{
+    return Timestamp(m_turnHeader.timestamp);
+}
+
+// Get feature flags.
+game::v3::TurnFile::FeatureSet_t
+game::v3::TurnFileView::getFeatures() const
+{
+    return m_features;
+}
+
+// Get sub-version of turn file.
+int
+game::v3::TurnFileView::getVersion() const
+{
+    return m_version;
+}
+
+// Get relative position of turn data in Taccom file.
+size_t
+game::v3::TurnFileView::getTaccomTurnPlace() const
+{
+    return m_turnPlacement;
+}
+
+// Get turn header.
+const game::v3::structures::TurnHeader&
+game::v3::TurnFileView::getTurnHeader() const
+{
+    return m_turnHeader;
+}
+
+// Get Taccom header.
+const game::v3::structures::TaccomTurnHeader&
+game::v3::TurnFileView::getTaccomHeader() const
+{
+    return m_taccomHeader;
+}
+
+// Get DOS (v3.0) trailer.
+const game::v3::structures::TurnDosTrailer&
+game::v3::TurnFileView::getDosTrailer() const
+{
+    return m_dosTrailer;
+}
+
+// Get Windows (v3.5) trailer.
+const game::v3::structures::TurnWindowsTrailer&
+game::v3::TurnFileView::getWindowsTrailer() const
+{
+    return m_windowsTrailer;
+}
+
+// Get complete file content.
+afl::base::ConstBytes_t
+game::v3::TurnFileView::getContent() const
+{
+    return m_content;
+}
+
+// Get number of commands.
+size_t
+game::v3::TurnFileView::getNumCommands() const
+{
+    return m_commandTable.size() / 4;
+}
+
+// Get position of a command in the file.
+bool
+game::v3::TurnFileView::getCommandPosition(size_t index, size_t& out) const
+{
+    afl::base::ConstBytes_t entry = m_commandTable.subrange(4*index);
+    if (const afl::bits::Int32LE::Bytes_t* p = entry.eatN<4>()) {
+        // Pointers are 1-based and relative to the start of the turn. parseCommands() rejects pointers below 1.
+        out = m_turnOffset + static_cast<uint32_t>(afl::bits::Int32LE::unpack(*p)) - 1;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+// Get command code.
+bool
+game::v3::TurnFileView::getCommandCode(size_t index, CommandCode_t& out) const
+{
+    size_t pos;
+    int16_t result;
+    if (getCommandPosition(index, pos) && getWord(m_content, pos, result)) {
+        out = CommandCode_t(result);
+        return true;
+    } else {
+        return false;
+    }
+}
+
+// Get command Id field.
+bool
+game::v3::TurnFileView::getCommandId(size_t index, int& out) const
+{
+    size_t pos;
+    int16_t result;
+    if (getCommandPosition(index, pos) && getWord(m_content, pos + 2, result)) {
+        out = result;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+// Get length of command data field.
+bool
+game::v3::TurnFileView::getCommandLength(size_t index, int& out) const
+{
+    size_t pos;
+    if (getCommandPosition(index, pos)) {
+        return TurnFile::computeCommandLength(m_content.subrange(pos), out);
+    } else {
+        return false;
+    }
+}
+
+// Get command data.
+afl::base::ConstBytes_t
+game::v3::TurnFileView::getCommandData(size_t index) const
+{
+    size_t pos;
+    if (getCommandPosition(index, pos)) {
+        return m_content.subrange(pos + 4);
+    } else {
+        return afl::base::ConstBytes_t();
+    }
+}
+
+/** Parse the file.
+    To be called from the constructor only (assumes most things zeroed).
+    \param fileName File name (for error messages)
+    \param tx Translator (for error messages)
+    \param fullParse true to validate commands and attachments
+    \throw afl::except::FileFormatException on error */
+void
+game::v3::TurnFileView::init(const String_t& fileName, afl::string::Translator& tx, bool fullParse)
+{
+    // ex GTurnfile::init, GTurnfile::parseTurnfile, GTurnfile::parseTurnfileHeader
+    size_t length = m_content.size();
+    if (m_content.size() > sizeof(m_taccomHeader) && std::memcmp(m_content.at(0), TACCOM_MAGIC, 10) == 0) {
+        // Taccom-enhanced TRN
+        afl::base::fromObject(m_taccomHeader).copyFrom(m_content);
+        m_features += TurnFile::TaccomFeature;
+        if (m_taccomHeader.turnAddress < 1 || m_taccomHeader.turnSize < 0) {
+            throw afl::except::FileFormatException(fileName, tx("Invalid file format (bad pointer)"));
+        }
+        m_turnOffset = size_t(m_taccomHeader.turnAddress - 1);
+        length = size_t(m_taccomHeader.turnSize);
+        checkRange(fileName, tx, m_turnOffset, length);
+
+        if (fullParse) {
+            for (size_t i = 0; i < structures::MAX_TRN_ATTACHMENTS; ++i) {
+                if (!afl::base::ConstBytes_t(m_taccomHeader.attachments[i].name).empty()) {
+                    // Attachment present
+                    const int32_t address = m_taccomHeader.attachments[i].address;
+                    const int32_t size = m_taccomHeader.attachments[i].length;
+                    if (address < 1 || size < 0) {
+                        throw afl::except::FileFormatException(fileName, tx("Invalid file format (bad pointer)"));
+                    }
+                    if (m_taccomHeader.turnAddress > address) {
+                        m_turnPlacement = i+1;
+                    }
+                    checkRange(fileName, tx, size_t(address - 1), size_t(size));
+                }
+            }
+        }
+    }
+
+    // read header and DOS trailer
+    if (length < sizeof(m_turnHeader) + sizeof(m_dosTrailer)) {
+        throw afl::except::FileTooShortException(fileName);
+    }
+    afl::base::ConstBytes_t turnData = m_content.subrange(m_turnOffset, length);
+    afl::base::fromObject(m_turnHeader).copyFrom(turnData);
+    afl::base::fromObject(m_dosTrailer).copyFrom(turnData.subrange(length - sizeof(m_dosTrailer)));
+
+    // read the Windows trailer, if any
+    // FIXME? In case the actual turn data contains "VER3.5nn", this will mis-interpret the turn file in the same way as host does.
+    if (length >= sizeof(m_dosTrailer) + sizeof(m_windowsTrailer) + sizeof(m_turnHeader)) {
+        afl::base::fromObject(m_windowsTrailer).copyFrom(turnData.subrange(length - sizeof(m_dosTrailer) - sizeof(m_windowsTrailer)));
+        if (std::memcmp(m_windowsTrailer.magic, V35_MAGIC, 6) == 0) {
+            m_features += TurnFile::WinplanFeature;
+            if (m_windowsTrailer.magic[6] >= '0' && m_windowsTrailer.magic[6] <= '9' && m_windowsTrailer.magic[7] >= '0' && m_windowsTrailer.magic[7] <= '9') {
+                m_version = 10*(m_windowsTrailer.magic[6] - '0') + (m_windowsTrailer.magic[7] - '0');
+            }
+        }
+    }
+    if (!m_features.contains(TurnFile::WinplanFeature)) {
+        afl::base::fromObject(m_windowsTrailer).fill(0);
+    }
+
+    if (fullParse) {
+        parseCommands(fileName, tx, length);
+    }
+}
+
+/** Check a file position.
+    \param fileName File name (for error messages)
+    \param tx Translator (for error messages)
+    \param offset,length position/range to verify, zero-based
+    \throw afl::except::FileFormatException on error. */
+void
+game::v3::TurnFileView::checkRange(const String_t& fileName, afl::string::Translator& tx, size_t offset, size_t length) const
+{
+    // ex GTurnfile::checkRange
+    if (offset > m_content.size() || length > m_content.size() - offset) {
+        throw afl::except::FileFormatException(fileName, tx("Invalid file format (bad pointer)"));
+    }
+}
+
+/** Validate command pointer table and commands.
+    \param fileName File name (for error messages)
+    \param tx Translator (for error messages)
+    \param length Length of turn data
+    \throw afl::except::FileFormatException on error. */
+void
+game::v3::TurnFileView::parseCommands(const String_t& fileName, afl::string::Translator& tx, size_t length)
+{
+    const int32_t numCommands = m_turnHeader.numCommands;
+    if (numCommands < 0 || numCommands > MAX_COMMANDS) {
+        throw afl::except::FileFormatException(fileName, tx("Invalid file format (invalid command count)"));
+    }
+
+    const size_t tableSize = 4*size_t(numCommands);
+    if (length < sizeof(m_turnHeader) + (numCommands != 0) + tableSize + sizeof(m_dosTrailer)) {
+        throw afl::except::FileTooShortException(fileName);
+    }
+    m_commandTable = m_content.subrange(m_turnOffset + sizeof(m_turnHeader) + 1, tableSize);
+
+    for (size_t i = 0, n = getNumCommands(); i < n; ++i) {
+        const afl::bits::Int32LE::Bytes_t* p = m_commandTable.subrange(4*i).eatN<4>();
+        if (p == 0 || afl::bits::Int32LE::unpack(*p) < 1) {
+            throw afl::except::FileFormatException(fileName, tx("Invalid file format (bad pointer)"));
+        }
+
+        size_t pos = 0;
+        getCommandPosition(i, pos);
+        checkRange(fileName, tx, pos, 4);          // each command is at least 4 bytes
+
+        CommandCode_t cmd;
+        if (getCommandCode(i, cmd) && cmd == tcm_SendBack) {
+            checkRange(fileName, tx, pos, 8);      // getCommandLength() will refer to offset+6
+        }
+
+        int cmdLength;
+        if (getCommandLength(i, cmdLength)) {
+            checkRange(fileName, tx, pos, size_t(cmdLength) + 4);
+        }
+    }
+}
@@ -0,0 +1,178 @@
+/**
+  *  \file game/v3/turnfileview.hpp
+  *  \brief Class game::v3::TurnFileView
+  */
+#ifndef C2NG_GAME_V3_TURNFILEVIEW_HPP
+#define C2NG_GAME_V3_TURNFILEVIEW_HPP
+
+#include "afl/base/memory.hpp"
+#include "afl/base/ptr.hpp"
+#include "afl/base/ref.hpp"
+#include "afl/io/filemapping.hpp"
+#include "afl/string/string.hpp"
+#include "afl/string/translator.hpp"
+#include "game/timestamp.hpp"
+#include "game/v3/structures.hpp"
+#include "game/v3/turnfile.hpp"
+
+namespace game { namespace v3 {
+
+    /** Read-only view of a turn file.
+
+        This class validates a turn file image in memory and provides access to its headers and commands,
+        without copying the command data.
+        It is intended for users that only need to inspect a turn file,
+        such as the host turn submission, turn checkers, or dumpers.
+        TurnFile uses it to parse a turn file before copying it into its own (modifiable) buffers.
+
+        The turn file image can be provided as a FileMapping (which is kept alive by the TurnFileView),
+        or as a plain memory descriptor (which must outlive the TurnFileView).
+
+        In header-only mode, only the turn header and trailers are validated and available;
+        getNumCommands() will report zero commands.
+
+        Command indexes and data refer to the turn file as stored;
+        in particular, deleted or invalid commands are not filtered. */
+    class TurnFileView {
+     public:
+        typedef TurnFile::CommandCode_t CommandCode_t;
+
+        /** Constructor.
+            \param mapping   File content. TurnFileView keeps a reference.
+            \param fileName  File name (for error messages)
+            \param tx        Translator (for error messages)
+            \param fullParse true to validate and provide access to commands; false to read only the turn header
+            \throws afl::except::FileFormatException on error */
+        TurnFileView(afl::base::Ref<afl::io::FileMapping> mapping, const String_t& fileName, afl::string::Translator& tx, bool fullParse = true);
+
+        /** Constructor.
+            \param data      File content. Must outlive the TurnFileView.
+            \param fileName  File name (for error messages)
+            \param tx        Translator (for error messages)
+            \param fullParse true to validate and provide access to commands; false to read only the turn header
+            \throws afl::except::FileFormatException on error */
+        TurnFileView(afl::base::ConstBytes_t data, const String_t& fileName, afl::string::Translator& tx, bool fullParse = true);
+
+        /** Destructor. */
+        ~TurnFileView();
+
+
+        /*
+         *  Header accessors
+         */
+
+        /** Get player number.
+            \return player number */
+        int getPlayer() const;
+
+        /** Get turn timestamp.
+            \return timestamp */
+        Timestamp getTimestamp() const;
+
+        /** Get feature flags.
+            \return feature flags */
+        TurnFile::FeatureSet_t getFeatures() const;
+
+        /** Get sub-version of turn file.
+            Only valid for Winplan turns (getFeatures().contains(WinplanFeature)).
+            \return sub-version */
+        int getVersion() const;
+
+        /** Get relative position of turn data in Taccom file.
+            \return Number of attachment slots that precede the turn file data.
+            Only valid in full-parse mode. */
+        size_t getTaccomTurnPlace() const;
+
+        /** Get turn header.
+            \return header */
+        const structures::TurnHeader& getTurnHeader() const;
+
+        /** Get Taccom header.
+            Only valid if the TaccomFeature is active; zero otherwise.
+            \return header */
+        const structures::TaccomTurnHeader& getTaccomHeader() const;
+
+        /** Get DOS (v3.0) trailer.
+            \return trailer */
+        const structures::TurnDosTrailer& getDosTrailer() const;
+
+        /** Get Windows (v3.5) trailer.
+            Only valid if the WinplanFeature is active; zero otherwise.
+            \return trailer */
+        const structures::TurnWindowsTrailer& getWindowsTrailer() const;
+
+        /** Get complete file content.
+            \return file content, including Taccom headers and attachments */
+        afl::base::ConstBytes_t getContent() const;
+
+
+        /*
+         *  Command accessors
+         */
+
+        /** Get number of commands.
+            \return number of commands; zero in header-only mode */
+        size_t getNumCommands() const;
+
+        /** Get position of a command in the file.
+            \param index [in] Command index, [0,getNumCommands())
+            \param out   [out] Command position as 0-based index into getContent()
+            \retval true Valid request, \c out was updated
+            \retval false Invalid request (index out of range), \c out unchanged */
+        bool getCommandPosition(size_t index, size_t& out) const;
+
+        /** Get command code.
+            \param index [in] Command index, [0,getNumCommands())
+            \param out   [out] Command code
+            \retval true Valid request, \c out was updated
+            \retval false Invalid request, \c out unchanged
+            \see TurnFile::getCommandCode */
+        bool getCommandCode(size_t index, CommandCode_t& out) const;
+
+        /** Get command Id field.
+            \param index [in] Command index, [0,getNumCommands())
+            \param out   [out] Id field
+            \retval true Valid request, \c out was updated
+            \retval false Invalid request, \c out unchanged
+            \see TurnFile::getCommandId */
+        bool getCommandId(size_t index, int& out) const;
+
+        /** Get length of command data field.
+            \param index [in] Command index, [0,getNumCommands())
+            \param out   [out] Command length
+            \retval true Valid request, \c out was updated
+            \retval false Invalid request or unknown command, \c out unchanged
+            \see TurnFile::getCommandLength */
+        bool getCommandLength(size_t index, int& out) const;
+
+        /** Get command data.
+            This returns a memory descriptor to the command data <b>and everything that follows</b>,
+            pointing into the file content.
+            \param index [in] Command index, [0,getNumCommands())
+            \return Command data; empty on error
+            \see TurnFile::getCommandData */
+        afl::base::ConstBytes_t getCommandData(size_t index) const;
+
+     private:
+        afl::base::Ptr<afl::io::FileMapping> m_mapping;  ///< Mapping that provides m_content, if any.
+        afl::base::ConstBytes_t m_content;               ///< File content.
+
+        structures::TurnHeader m_turnHeader;
+        structures::TaccomTurnHeader m_taccomHeader;
+        structures::TurnDosTrailer m_dosTrailer;
+        structures::TurnWindowsTrailer m_windowsTrailer;
+        int m_version;
+        TurnFile::FeatureSet_t m_features;
+        size_t m_turnPlacement;
+
+        size_t m_turnOffset;                             ///< Position of turn data in m_content (nonzero for Taccom).
+        afl::base::ConstBytes_t m_commandTable;          ///< Command pointer table; empty in header-only mode.
+
+        void init(const String_t& fileName, afl::string::Translator& tx, bool fullParse);
+        void checkRange(const String_t& fileName, afl::string::Translator& tx, size_t offset, size_t length) const;
+        void parseCommands(const String_t& fileName, afl::string::Translator& tx, size_t length);
+    };
+
+} }
+
+#endif
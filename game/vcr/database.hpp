@@ -27,6 +27,12 @@ namespace game { namespace vcr {
             \param nr Number, [0,getNumBattles()) */
         virtual Battle* getBattle(size_t nr) = 0;
 
+        /** Get number of battles that can be used at the same time.
+            A database that decodes battles on demand may discard a battle when other battles are accessed.
+            Pointers returned by getBattle() for this many different battles are guaranteed to be valid at the same time.
+            \return number of battles; default: unlimited */
+        virtual size_t getMaxLiveBattles() const;
+
         /** Save VCR in binary format.
             \param out    Stream
             \param first  First battle to save
@@ -38,4 +44,10 @@ namespace game { namespace vcr {
 
 } }
 
+inline size_t
+game::vcr::Database::getMaxLiveBattles() const
+{
+    return size_t(-1);
+}
+
 #endif
@@ -121,8 +121,7 @@ namespace {
 
 game::vcr::flak::Battle::Battle(std::auto_ptr<Setup> setup)
     : m_setup(setup),
-      m_after(),
-      m_haveAfter(false)
+      m_result()
 { }
 
 size_t
@@ -138,10 +137,10 @@ game::vcr::flak::Battle::getObject(size_t slot, bool after) const
     // ex FlakVcrEntry::getObject
     if (after) {
         // After
-        if (slot >= m_after.size()) {
+        if (m_result.get() == 0 || slot >= m_result->after.size()) {
             return 0;
         } else {
-            return m_after[slot];
+            return m_result->after[slot];
         }
     } else {
         // Before
@@ -197,8 +196,9 @@ game::vcr::flak::Battle::prepareResult(const game::config::HostConfiguration& co
                                        int resultLevel)
 {
     // ex FlakVcrEntry::prepareResult
-    if ((resultLevel & ~NeedQuickOutcome) != 0 && !m_haveAfter) {
+    if ((resultLevel & ~NeedQuickOutcome) != 0 && m_result.get() == 0) {
         // Play the fight
+        afl::base::Ptr<Result> result = new Result();
         if (m_setup->getNumFleets() != 0) {
             NullVisualizer vis;
             GameEnvironment env(config, shipList.beams(), shipList.launchers());
@@ -209,11 +209,11 @@ game::vcr::flak::Battle::prepareResult(const game::config::HostConfiguration& co
 
             // Build the result
             for (size_t i = 0, n = m_setup->getNumShips(); i < n; ++i) {
-                Object& obj = *m_after.pushBackNew(new Object(m_setup->getShipByIndex(i)));
+                Object& obj = *result->after.pushBackNew(new Object(m_setup->getShipByIndex(i)));
                 algo.copyResult(i, obj);
             }
         }
-        m_haveAfter = true;
+        m_result = result;
     }
 }
 
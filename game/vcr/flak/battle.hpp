@@ -6,6 +6,8 @@
 #define C2NG_GAME_VCR_FLAK_BATTLE_HPP
 
 #include <memory>
+#include "afl/base/ptr.hpp"
+#include "afl/base/refcounted.hpp"
 #include "afl/container/ptrvector.hpp"
 #include "game/vcr/battle.hpp"
 #include "game/vcr/flak/object.hpp"
@@ -18,6 +20,13 @@ namespace game { namespace vcr { namespace flak {
         This stores a Setup and will, on demand, play that using the Algorithm. */
     class Battle : public game::vcr::Battle {
      public:
+        /** Battle result.
+            Produced by prepareResult(); contains the state of all ships after the fight.
+            A battle that has not been fought (no fleets) has an empty result. */
+        struct Result : public afl::base::RefCounted {
+            afl::container::PtrVector<Object> after;
+        };
+
         /** Constructor.
             \param setup Setup, must not be null */
         Battle(std::auto_ptr<Setup> setup);
@@ -48,11 +57,20 @@ namespace game { namespace vcr { namespace flak {
 
         const Setup& setup() const;
 
+        /** Get result.
+            \return result computed by prepareResult() (or set by setResult()); null if none */
+        afl::base::Ptr<Result> getResult() const;
+
+        /** Set result.
+            Use to give a battle a result that was previously computed for the same setup,
+            e.g. when a database decodes a battle again after having discarded it.
+            \param result Result, must have been obtained by getResult() on a battle with the same setup; can be null */
+        void setResult(afl::base::Ptr<Result> result);
+
      private:
         std::auto_ptr<Setup> m_setup;
 
-        afl::container::PtrVector<Object> m_after;
-        bool m_haveAfter;
+        afl::base::Ptr<Result> m_result;
     };
 
 } } }
@@ -63,4 +81,16 @@ game::vcr::flak::Battle::setup() const
     return *m_setup;
 }
 
+inline afl::base::Ptr<game::vcr::flak::Battle::Result>
+game::vcr::flak::Battle::getResult() const
+{
+    return m_result;
+}
+
+inline void
+game::vcr::flak::Battle::setResult(afl::base::Ptr<Result> result)
+{
+    m_result = result;
+}
+
 #endif
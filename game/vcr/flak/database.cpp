@@ -3,13 +3,40 @@
   *  \brief Class game::vcr::flak::Database
   */
 
+#include <algorithm>
 #include <cstring>
 #include "game/vcr/flak/database.hpp"
-#include "game/vcr/flak/structures.hpp"
 #include "afl/except/fileformatexception.hpp"
+#include "afl/except/filetooshortexception.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "game/vcr/flak/structures.hpp"
+
+namespace {
+    /* Number of decoded battles to keep */
+    const size_t CACHE_SIZE = 20;
+
+    /* DoS protection/avoid unbounded allocation: assume a maximum-size battle with 1000 ships, 1000 fleets
+       - header                                             4 bytes
+       - 1000 fleets x 24 bytes                         24000 bytes
+       - 1000 ships x 56 bytes                          56000 bytes
+       - 1000 x 1000 attack list entries x 4 bytes    4000000 bytes
+       = total                                        4080004 bytes */
+    const uint32_t MAX_SHIPS = 1000;
+    const uint32_t MAX_SIZE
+        = sizeof(game::vcr::flak::structures::Fleet) * MAX_SHIPS
+        + sizeof(game::vcr::flak::structures::Ship)  * MAX_SHIPS
+        + 4 * MAX_SHIPS * MAX_SHIPS
+        + 4;
+}
 
 game::vcr::flak::Database::Database()
-    : m_battles()
+    : m_battles(),
+      m_records(),
+      m_cache(),
+      m_data(),
+      m_fileName(),
+      m_charset(),
+      m_timestamp()
 {
     // ex GFlakVcrDatabase::GFlakVcrDatabase
 }
@@ -31,10 +58,41 @@ game::vcr::flak::Database::load(afl::io::Stream& file, afl::charset::Charset& ch
         throw afl::except::FileFormatException(file, tx("Unsupported file format version"));
     }
 
-    m_timestamp = header.timestamp;
-
+    // Map remainder of file and build index.
+    // ex GFlakVcrDatabase::readOneBattle (size check)
+    afl::base::Ref<afl::io::FileMapping> data = file.createVirtualMapping();
+    const afl::base::ConstBytes_t bytes = data->get();
+    std::vector<Record> records;
+    size_t pos = 0;
     for (int i = 0, n = header.num_battles; i < n; ++i) {
-        addNewBattle(readOneBattle(file, charset, tx));
+        // First word is size
+        afl::bits::Value<afl::bits::UInt32LE> rawSize;
+        if (bytes.size() - pos < sizeof(rawSize)) {
+            throw afl::except::FileTooShortException(file.getName());
+        }
+        afl::base::fromObject(rawSize).copyFrom(bytes.subrange(pos));
+        const uint32_t size = rawSize;
+        if (size > MAX_SIZE) {
+            throw afl::except::FileFormatException(file, tx("Battle too large"));
+        }
+        if (size < sizeof(rawSize)) {
+            throw afl::except::FileFormatException(file, tx("Invalid file format"));
+        }
+        if (bytes.size() - pos < size) {
+            throw afl::except::FileTooShortException(file.getName());
+        }
+        records.push_back(Record(pos, size));
+        pos += size;
+    }
+
+    // Success; commit
+    m_timestamp = header.timestamp;
+    m_data = data.asPtr();
+    m_fileName = file.getName();
+    m_charset.reset(charset.clone());
+    for (size_t i = 0; i < records.size(); ++i) {
+        m_battles.pushBackNew(0);
+        m_records.push_back(records[i]);
     }
 }
 
@@ -49,6 +107,7 @@ game::vcr::flak::Battle*
 game::vcr::flak::Database::addNewBattle(Battle* battle)
 {
     // ex GFlakVcrDatabase::addBattle
+    m_records.push_back(Record(0, 0));
     return m_battles.pushBackNew(battle);
 }
 
@@ -65,12 +124,25 @@ game::vcr::flak::Database::getBattle(size_t nr)
 {
     // ex GFlakVcrDatabase::getBattle
     if (nr < m_battles.size()) {
-        return m_battles[nr];
+        if (m_records[nr].size == 0) {
+            return m_battles[nr];
+        } else if (Battle* b = m_battles[nr]) {
+            touchBattle(nr);
+            return b;
+        } else {
+            return decodeBattle(nr);
+        }
     } else {
         return 0;
     }
 }
 
+size_t
+game::vcr::flak::Database::getMaxLiveBattles() const
+{
+    return CACHE_SIZE;
+}
+
 void
 game::vcr::flak::Database::save(afl::io::Stream& out, size_t first, size_t num, const game::config::HostConfiguration& /*config*/, afl::charset::Charset& cs)
 {
@@ -90,9 +162,12 @@ game::vcr::flak::Database::save(afl::io::Stream& out, size_t first, size_t num,
     header.reserved        = 0;
     out.fullWrite(afl::base::fromObject(header));
 
-    // Content
+    // Content. Records from the file are copied as-is, without decoding them.
     for (size_t i = 0; i < num; ++i) {
-        if (Battle* b = getBattle(first + i)) {
+        const Record& r = m_records[first + i];
+        if (r.size != 0 && m_data.get() != 0) {
+            out.fullWrite(m_data->get().subrange(r.pos, r.size));
+        } else if (Battle* b = m_battles[first + i]) {
             afl::base::GrowableBytes_t data;
             b->setup().save(data, cs);
             out.fullWrite(data);
@@ -101,42 +176,48 @@ game::vcr::flak::Database::save(afl::io::Stream& out, size_t first, size_t num,
 }
 
 game::vcr::flak::Battle*
-game::vcr::flak::Database::readOneBattle(afl::io::Stream& file, afl::charset::Charset& charset, afl::string::Translator& tx)
+game::vcr::flak::Database::decodeBattle(size_t nr)
 {
-    // ex GFlakVcrDatabase::readOneBattle
-    // First word is size
-    afl::base::GrowableBytes_t data;
-    data.resize(4);
-    file.fullRead(data);
-
-    afl::bits::Value<afl::bits::UInt32LE> rawSize;
-    afl::base::fromObject(rawSize).copyFrom(data);
-    const uint32_t size = rawSize;
-
-    // DoS protection/avoid unbounded allocation: assume a maximum-size battle with 1000 ships, 1000 fleets
-    // - header                                             4 bytes
-    // - 1000 fleets x 24 bytes                         24000 bytes
-    // - 1000 ships x 56 bytes                          56000 bytes
-    // - 1000 x 1000 attack list entries x 4 bytes    4000000 bytes
-    // = total                                        4080004 bytes
-    const uint32_t MAX_SHIPS = 1000;
-    const uint32_t MAX_SIZE
-        = sizeof(structures::Fleet) * MAX_SHIPS
-        + sizeof(structures::Ship)  * MAX_SHIPS
-        + 4 * MAX_SHIPS * MAX_SHIPS
-        + 4;
-    if (size > MAX_SIZE) {
-        throw afl::except::FileFormatException(file, tx("Battle too large"));
+    const Record& r = m_records[nr];
+    if (m_data.get() == 0 || m_charset.get() == 0) {
+        return 0;
     }
 
-    // Read content
-    data.resize(size);
-    file.fullRead(data.subrange(4));
+    // Build the setup. Structure was validated during load(), so errors here are content errors.
+    // Caller cannot handle those; report as missing battle.
+    std::auto_ptr<Setup> setup(new Setup());
+    try {
+        afl::string::NullTranslator tx;
+        setup->load(m_fileName, m_data->get().subrange(r.pos, r.size), *m_charset, tx);
+    }
+    catch (std::exception&) {
+        return 0;
+    }
 
-    // Build the setup (this may throw)
-    std::auto_ptr<Setup> result(new Setup());
-    result->load(file.getName(), data, charset, tx);
+    // Remember it, evicting the least-recently used one.
+    // The result of an evicted battle is kept, so it need not be computed again.
+    Battle* result = new Battle(setup);
+    result->setResult(r.result);
+    m_battles.replaceElementNew(nr, result);
+    m_cache.push_back(nr);
+    if (m_cache.size() > CACHE_SIZE) {
+        const size_t evict = m_cache.front();
+        if (Battle* b = m_battles[evict]) {
+            m_records[evict].result = b->getResult();
+        }
+        m_battles.replaceElementNew(evict, 0);
+        m_cache.erase(m_cache.begin());
+    }
+    return result;
+}
 
-    // Convert to battle
-    return new Battle(result);
+void
+game::vcr::flak::Database::touchBattle(size_t nr)
+{
+    // Move to end of m_cache (most-recently used)
+    std::vector<size_t>::iterator it = std::find(m_cache.begin(), m_cache.end(), nr);
+    if (it != m_cache.end()) {
+        m_cache.erase(it);
+        m_cache.push_back(nr);
+    }
 }
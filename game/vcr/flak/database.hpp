@@ -5,7 +5,11 @@
 #ifndef C2NG_GAME_VCR_FLAK_DATABASE_HPP
 #define C2NG_GAME_VCR_FLAK_DATABASE_HPP
 
+#include <memory>
+#include <vector>
+#include "afl/base/ptr.hpp"
 #include "afl/container/ptrvector.hpp"
+#include "afl/io/filemapping.hpp"
 #include "afl/io/stream.hpp"
 #include "game/timestamp.hpp"
 #include "game/vcr/database.hpp"
@@ -13,15 +17,27 @@
 
 namespace game { namespace vcr { namespace flak {
 
-    /** Implementation of VCR database for FLAK. */
+    /** Implementation of VCR database for FLAK.
+
+        FLAK battles can be large, and a turn can have many of them.
+        Therefore, load() does not decode battles; it only maps the file and indexes the records.
+        Battles are decoded on demand by getBattle(), and only a limited number of decoded battles is kept.
+        A pointer returned by getBattle() therefore remains valid only until a few more battles are accessed;
+        users must not keep it for longer.
+        Results computed by Battle::prepareResult() survive discarding the battle:
+        the database keeps them and gives them to the battle when it is decoded again.
+
+        Battles added using addNewBattle() are kept permanently. */
     class Database : public game::vcr::Database {
      public:
         Database();
         ~Database();
 
         /** Load from file.
+            Validates the file structure and builds an index, but does not yet decode the battles.
+            A battle that cannot be decoded will later be reported as null by getBattle().
             \param file     File to read
-            \param charset  Game character set
+            \param charset  Game character set (will be copied)
             \param tx       Translator (for error messages)
             \throw afl::except::FileFormatException, afl::except::FileProblemException */
         void load(afl::io::Stream& file, afl::charset::Charset& charset, afl::string::Translator& tx);
@@ -38,13 +54,43 @@ namespace game { namespace vcr { namespace flak {
         // game::vcr::Database methods:
         virtual size_t getNumBattles() const;
         virtual Battle* getBattle(size_t nr);
+        virtual size_t getMaxLiveBattles() const;
         virtual void save(afl::io::Stream& out, size_t first, size_t num, const game::config::HostConfiguration& config, afl::charset::Charset& cs);
 
      private:
+        /** Location of a battle record in m_data. Size 0 for battles added with addNewBattle().
+            Also keeps the result of a discarded battle. */
+        struct Record {
+            size_t pos;
+            size_t size;
+            afl::base::Ptr<Battle::Result> result;
+            Record(size_t pos, size_t size)
+                : pos(pos), size(size), result()
+                { }
+        };
+
+        /** Battles. Null for records that have not yet been decoded (or have been evicted). */
         afl::container::PtrVector<Battle> m_battles;
+
+        /** Records, same index as m_battles. */
+        std::vector<Record> m_records;
+
+        /** Indexes of decoded records, least-recently used first. */
+        std::vector<size_t> m_cache;
+
+        /** File content. */
+        afl::base::Ptr<afl::io::FileMapping> m_data;
+
+        /** File name (for error messages). */
+        String_t m_fileName;
+
+        /** Character set for decoding records. */
+        std::auto_ptr<afl::charset::Charset> m_charset;
+
         Timestamp m_timestamp;
 
-        static Battle* readOneBattle(afl::io::Stream& file, afl::charset::Charset& charset, afl::string::Translator& tx);
+        Battle* decodeBattle(size_t nr);
+        void touchBattle(size_t nr);
     };
 
 } } }
@@ -6,6 +6,7 @@
 #include "game/vcr/overview.hpp"
 #include "afl/string/format.hpp"
 #include "game/vcr/object.hpp"
+#include "game/vcr/resultpreparer.hpp"
 
 namespace {
     struct SortGroups {
@@ -37,16 +38,23 @@ namespace {
     }
 }
 
-game::vcr::Overview::Overview(Database& battles, const game::config::HostConfiguration& config, const game::spec::ShipList& shipList)
+game::vcr::Overview::Overview(Database& battles, const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, size_t numThreads)
     : m_battles(battles),
       m_config(config),
       m_shipList(shipList),
+      m_numThreads(numThreads),
       m_units(),
       m_groupCounter(0)
 {
-    for (size_t i = 0, n = battles.getNumBattles(); i < n; ++i) {
-        if (Battle* b = battles.getBattle(i)) {
-            addBattle(*b, i);
+    // Compute results in parallel, one batch at a time, then process that batch
+    ResultPreparer prep(config, shipList, Battle::NeedQuickOutcome, numThreads);
+    const size_t batchSize = ResultPreparer::getBatchSize(battles);
+    for (size_t first = 0, n = battles.getNumBattles(); first < n; first += batchSize) {
+        prep.prepare(battles, first, batchSize);
+        for (size_t i = first; i < n && i < first + batchSize; ++i) {
+            if (Battle* b = battles.getBattle(i)) {
+                addBattle(*b, i);
+            }
         }
     }
     finish();
@@ -66,10 +74,15 @@ void
 game::vcr::Overview::buildScoreSummary(ScoreSummary& out)
 {
     const size_t numBattles = m_battles.getNumBattles();
+    const size_t batchSize = ResultPreparer::getBatchSize(m_battles);
+    ResultPreparer prep(m_config, m_shipList, Battle::NeedCompleteResult, m_numThreads);
     out.players.clear();
     out.scores.setAll(Score());
     out.numBattles = numBattles;
     for (size_t battleNr = 0; battleNr < numBattles; ++battleNr) {
+        if (battleNr % batchSize == 0) {
+            prep.prepare(m_battles, battleNr, batchSize);
+        }
         if (Battle* b = m_battles.getBattle(battleNr)) {
             b->prepareResult(m_config, m_shipList, Battle::NeedCompleteResult);
             for (size_t i = 0, numObjects = b->getNumObjects(); i < numObjects; ++i) {
@@ -118,8 +118,9 @@ namespace game { namespace vcr {
         /** Constructor.
             \param battles       Battles (non-const because this will compute battle results)
             \param config        Host configuration
-            \param shipList      Ship list */
-        Overview(Database& battles, const game::config::HostConfiguration& config, const game::spec::ShipList& shipList);
+            \param shipList      Ship list
+            \param numThreads    Number of threads to use for computing battle results (see ResultPreparer) */
+        Overview(Database& battles, const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, size_t numThreads);
         ~Overview();
 
         /** Build diagram.
@@ -137,6 +138,7 @@ namespace game { namespace vcr {
         Database& m_battles;
         const game::config::HostConfiguration& m_config;
         const game::spec::ShipList& m_shipList;
+        const size_t m_numThreads;
 
         // Status:
         std::vector<Item> m_units;
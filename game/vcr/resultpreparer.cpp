@@ -0,0 +1,258 @@
+/**
+  *  \file game/vcr/resultpreparer.cpp
+  *  \brief Class game::vcr::ResultPreparer
+  */
+
+#include <algorithm>
+#include <vector>
+#include "game/vcr/resultpreparer.hpp"
+#include "afl/base/stoppable.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/semaphore.hpp"
+#include "afl/sys/thread.hpp"
+#include "game/vcr/battle.hpp"
+
+namespace {
+    /* Maximum number of battles to fetch from the database at once.
+       The actual batch is further limited by Database::getMaxLiveBattles(). */
+    const size_t BATCH_SIZE = 16;
+
+    /* Prepare one battle.
+       A battle that fails is left unprepared; whoever asks for its result will repeat the attempt and see the error.
+       In particular, an exception must not escape a worker thread, and must not abort a batch in the control thread. */
+    void prepareBattle(game::vcr::Battle& b, const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, int resultLevel)
+    {
+        try {
+            b.prepareResult(config, shipList, resultLevel);
+        }
+        catch (...) {
+        }
+    }
+}
+
+/*
+ *  Worker pool.
+ *
+ *  For each batch, the control thread starts all threads, processes battles itself, and waits for all threads to finish
+ *  (same protocol as game::sim::ParallelRunner).
+ */
+
+class game::vcr::ResultPreparer::Pool : private afl::base::Stoppable {
+ public:
+    Pool(const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, int resultLevel, size_t numWorkers);
+    ~Pool();
+
+    void processBatch(const std::vector<Battle*>& battles);
+    void processBattles();
+
+ private:
+    class BatchGuard;
+
+    const game::config::HostConfiguration& m_config;
+    const game::spec::ShipList& m_shipList;
+    const int m_resultLevel;
+
+    afl::sys::Mutex m_mutex;
+    const std::vector<Battle*>* m_pBattles;
+    size_t m_next;
+    bool m_terminate;
+
+    afl::container::PtrVector<afl::sys::Thread> m_threads;
+    afl::sys::Semaphore m_startSignal;
+    afl::sys::Semaphore m_stopSignal;
+
+    void startAll();
+    Battle* getNextBattle();
+
+    // Stoppable:
+    void run();
+    void stop();
+};
+
+game::vcr::ResultPreparer::Pool::Pool(const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, int resultLevel, size_t numWorkers)
+    : m_config(config),
+      m_shipList(shipList),
+      m_resultLevel(resultLevel),
+      m_mutex(),
+      m_pBattles(0),
+      m_next(0),
+      m_terminate(false),
+      m_threads(),
+      m_startSignal(0),
+      m_stopSignal(0)
+{
+    for (size_t i = 0; i < numWorkers; ++i) {
+        m_threads.pushBackNew(new afl::sys::Thread("game.vcr.prepare", *this))->start();
+    }
+}
+
+game::vcr::ResultPreparer::Pool::~Pool()
+{
+    Pool::stop();
+    for (size_t i = 0, n = m_threads.size(); i < n; ++i) {
+        m_threads[i]->join();
+    }
+}
+
+/* Guard for a running batch.
+   Whatever happens in the control thread, waits for all workers to come to rest
+   and withdraws the battle list, so no worker can access it after processBatch() returns. */
+class game::vcr::ResultPreparer::Pool::BatchGuard {
+ public:
+    BatchGuard(Pool& pool)
+        : m_pool(pool)
+        { }
+    ~BatchGuard()
+        {
+            {
+                afl::sys::MutexGuard g(m_pool.m_mutex);
+                m_pool.m_next = m_pool.m_pBattles->size();
+            }
+            for (size_t i = 0, n = m_pool.m_threads.size(); i < n; ++i) {
+                m_pool.m_stopSignal.wait();
+            }
+            afl::sys::MutexGuard g(m_pool.m_mutex);
+            m_pool.m_pBattles = 0;
+        }
+ private:
+    Pool& m_pool;
+};
+
+void
+game::vcr::ResultPreparer::Pool::processBatch(const std::vector<Battle*>& battles)
+{
+    {
+        afl::sys::MutexGuard g(m_mutex);
+        m_pBattles = &battles;
+        m_next = 0;
+    }
+
+    // Start workers, and help them.
+    // The guard waits for all threads to come to rest, also if we are left by an exception.
+    startAll();
+    BatchGuard guard(*this);
+    processBattles();
+}
+
+void
+game::vcr::ResultPreparer::Pool::processBattles()
+{
+    while (Battle* b = getNextBattle()) {
+        prepareBattle(*b, m_config, m_shipList, m_resultLevel);
+    }
+}
+
+void
+game::vcr::ResultPreparer::Pool::startAll()
+{
+    for (size_t i = 0, n = m_threads.size(); i < n; ++i) {
+        m_startSignal.post();
+    }
+}
+
+game::vcr::Battle*
+game::vcr::ResultPreparer::Pool::getNextBattle()
+{
+    afl::sys::MutexGuard g(m_mutex);
+    while (m_pBattles != 0 && m_next < m_pBattles->size()) {
+        if (Battle* b = (*m_pBattles)[m_next++]) {
+            return b;
+        }
+    }
+    return 0;
+}
+
+void
+game::vcr::ResultPreparer::Pool::run()
+{
+    while (1) {
+        // Wait for control thread to give start signal
+        m_startSignal.wait();
+
+        // Termination check?
+        {
+            afl::sys::MutexGuard g(m_mutex);
+            if (m_terminate) {
+                break;
+            }
+        }
+
+        // Process battles
+        processBattles();
+
+        // Signal control thread that we stop
+        m_stopSignal.post();
+    }
+}
+
+void
+game::vcr::ResultPreparer::Pool::stop()
+{
+    {
+        afl::sys::MutexGuard g(m_mutex);
+        m_terminate = true;
+    }
+    startAll();
+}
+
+
+/*
+ *  ResultPreparer
+ */
+
+// Constructor.
+game::vcr::ResultPreparer::ResultPreparer(const game::config::HostConfiguration& config,
+                                          const game::spec::ShipList& shipList,
+                                          int resultLevel,
+                                          size_t numThreads)
+    : m_config(config),
+      m_shipList(shipList),
+      m_resultLevel(resultLevel),
+      m_pool()
+{
+    // The calling thread counts as a worker; more workers than battles per batch make no sense.
+    if (numThreads > 1) {
+        m_pool.reset(new Pool(config, shipList, resultLevel, std::min(numThreads, BATCH_SIZE) - 1));
+    }
+}
+
+// Destructor.
+game::vcr::ResultPreparer::~ResultPreparer()
+{ }
+
+// Prepare results.
+void
+game::vcr::ResultPreparer::prepare(Database& db, size_t first, size_t num)
+{
+    const size_t numBattles = db.getNumBattles();
+    const size_t limit = (first < numBattles ? first + std::min(num, numBattles - first) : first);
+    if (m_pool.get() == 0) {
+        // Single-threaded
+        for (size_t i = first; i < limit; ++i) {
+            if (Battle* b = db.getBattle(i)) {
+                prepareBattle(*b, m_config, m_shipList, m_resultLevel);
+            }
+        }
+    } else {
+        // Multi-threaded
+        const size_t batchSize = getBatchSize(db);
+        std::vector<Battle*> batch;
+        for (size_t i = first; i < limit; i += batchSize) {
+            // Fetch battles in this thread; Database is not thread-safe
+            batch.clear();
+            for (size_t j = i; j < limit && j < i + batchSize; ++j) {
+                batch.push_back(db.getBattle(j));
+            }
+            m_pool->processBatch(batch);
+        }
+    }
+}
+
+// Get batch size.
+size_t
+game::vcr::ResultPreparer::getBatchSize(const Database& db)
+{
+    return std::max(size_t(1), std::min(BATCH_SIZE, db.getMaxLiveBattles()));
+}
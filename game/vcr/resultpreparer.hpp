@@ -0,0 +1,69 @@
+/**
+  *  \file game/vcr/resultpreparer.hpp
+  *  \brief Class game::vcr::ResultPreparer
+  */
+#ifndef C2NG_GAME_VCR_RESULTPREPARER_HPP
+#define C2NG_GAME_VCR_RESULTPREPARER_HPP
+
+#include <memory>
+#include "afl/base/uncopyable.hpp"
+#include "game/config/hostconfiguration.hpp"
+#include "game/spec/shiplist.hpp"
+#include "game/vcr/database.hpp"
+
+namespace game { namespace vcr {
+
+    /** Parallel preparation of battle results.
+        Calls Battle::prepareResult() for many battles, using multiple threads.
+        This is equivalent to (but faster than) calling prepareResult() for each battle in sequence,
+        and should be used by operations that need results for many battles (e.g. Overview).
+
+        Each battle is processed by exactly one thread.
+        If preparing a battle fails with an exception, that battle is left unprepared and the others are processed normally;
+        a later call to one of the battle's result functions repeats the computation and reports the error.
+        Worker threads access the configuration and ship list read-only;
+        the calling thread is blocked in prepare() until all battles are processed, so these must not change in the meantime.
+        Threads live as long as the ResultPreparer lives.
+
+        Databases that decode battles on demand (game::vcr::flak::Database) keep only a limited number of battles
+        (Database::getMaxLiveBattles()).
+        Callers that want to use the results should therefore process battles in chunks of at most getBatchSize(),
+        and use the results before preparing the next chunk. */
+    class ResultPreparer : private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            \param config      Host configuration
+            \param shipList    Ship list
+            \param resultLevel Result level to prepare (Battle::NeedQuickOutcome, Battle::NeedCompleteResult)
+            \param numThreads  Number of threads to use (including the calling thread); 0 or 1 to run everything in the calling thread */
+        ResultPreparer(const game::config::HostConfiguration& config,
+                       const game::spec::ShipList& shipList,
+                       int resultLevel,
+                       size_t numThreads);
+
+        /** Destructor.
+            Stops all threads. */
+        ~ResultPreparer();
+
+        /** Prepare results.
+            \param db     Database
+            \param first  First battle index
+            \param num    Number of battles */
+        void prepare(Database& db, size_t first, size_t num);
+
+        /** Get batch size.
+            \param db Database
+            \return Number of battles to process at once; never more than the database guarantees to keep (Database::getMaxLiveBattles()) */
+        static size_t getBatchSize(const Database& db);
+
+     private:
+        class Pool;
+        const game::config::HostConfiguration& m_config;
+        const game::spec::ShipList& m_shipList;
+        const int m_resultLevel;
+        std::auto_ptr<Pool> m_pool;
+    };
+
+} }
+
+#endif
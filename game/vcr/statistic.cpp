@@ -14,6 +14,13 @@ game::vcr::Statistic::Statistic()
       m_numFights(0)
 { }
 
+// Construct from values.
+game::vcr::Statistic::Statistic(int minFightersAboard, int numTorpedoHits, int numFights)
+    : m_minFightersAboard(minFightersAboard),
+      m_numTorpedoHits(numTorpedoHits),
+      m_numFights(numFights)
+{ }
+
 // Initialize from VCR participant.
 void
 game::vcr::Statistic::init(const Object& obj, int numFights)
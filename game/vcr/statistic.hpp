@@ -20,6 +20,13 @@ namespace game { namespace vcr {
         /** Default constructor. */
         Statistic();
 
+        /** Construct from values.
+            Use to restore a statistic that has been transferred in serialized form.
+            \param minFightersAboard Minimum fighters aboard (see getMinFightersAboard())
+            \param numTorpedoHits    Number of torpedo hits (see getNumTorpedoHits())
+            \param numFights         Number of fights (see getNumFights()) */
+        Statistic(int minFightersAboard, int numTorpedoHits, int numFights);
+
         /** Initialize from VCR participant.
 
             Use numFights=0 to initialize for tracking a running total;
@@ -23,6 +23,10 @@ gfx::NullResourceProvider::getImage(String_t /*name*/, bool* status)
     return 0;
 }
 
+void
+gfx::NullResourceProvider::prefetchImage(String_t /*name*/)
+{ }
+
 afl::base::Ref<gfx::Font>
 gfx::NullResourceProvider::getFont(FontRequest /*req*/)
 {
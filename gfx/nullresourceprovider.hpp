@@ -20,6 +20,7 @@ namespace gfx {
 
         // ResourceProvider:
         virtual afl::base::Ptr<Canvas> getImage(String_t name, bool* status = 0);
+        virtual void prefetchImage(String_t name);
         virtual afl::base::Ref<Font> getFont(FontRequest req);
 
      private:
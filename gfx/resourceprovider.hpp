@@ -41,6 +41,17 @@ namespace gfx {
             \return image, if any */
         virtual afl::base::Ptr<Canvas> getImage(String_t name, bool* status = 0) = 0;
 
+        /** Prefetch an image.
+            Initiates loading of an image that is likely to be needed soon,
+            for example, the picture of the next object in a list.
+            Prefetches have lower priority than getImage() requests.
+            When the image becomes available, sig_imageChange is raised as usual.
+
+            This method shall not block.
+
+            \param name [in] Image identifier */
+        virtual void prefetchImage(String_t name) = 0;
+
         /** Get a font.
             This method shall return a font that best satisfies the given font request.
             Multiple calls with the same request should return the same instance of the font (sharing).
@@ -9,6 +9,7 @@
 #include "afl/charset/utf8.hpp"
 #include "afl/data/booleanvalue.hpp"
 #include "afl/data/floatvalue.hpp"
+#include "afl/data/integervalue.hpp"
 #include "afl/data/scalarvalue.hpp"
 #include "afl/data/stringvalue.hpp"
 #include "afl/data/visitor.hpp"
@@ -51,6 +52,7 @@ namespace {
     struct ArithmeticPair {
         int32_t ia, ib;         ///< Operands for integer arithmetic.
         double fa, fb;          ///< Operands for float arithmetic.
+        bool intA;              ///< For ariInt: true if first operand is an IntegerValue (not a bool).
     };
 
     /** Check arguments for arithmetic.
@@ -144,6 +146,12 @@ namespace {
                     VInt v(m_pair, iv);
                     v.visit(m_b);
                     m_result = v.get();
+                    m_pair.intA = true;
+                }
+            virtual void visitBoolean(bool bv)
+                {
+                    visitInteger(bv);
+                    m_pair.intA = false;
                 }
             virtual void visitFloat(double fv)
                 {
@@ -173,6 +181,7 @@ namespace {
             return ariNull;
 
         // Check a for numericness
+        pair.intA = dynamic_cast<const afl::data::IntegerValue*>(a) != 0;
         if (const afl::data::ScalarValue* iv = dynamic_cast<const afl::data::ScalarValue*>(a))
             pair.ia = iv->getValue();
         else if (const afl::data::FloatValue* fv = dynamic_cast<const afl::data::FloatValue*>(a))
@@ -1100,6 +1109,74 @@ interpreter::executeBinaryOperation(World& world, uint8_t op, const afl::data::V
     }
 }
 
+// Execute binary operation in place.
+bool
+interpreter::executeBinaryOperationInPlace(uint8_t op, afl::data::Value* a, const afl::data::Value* b)
+{
+    // Only an integer and an integer (or bool); these produce an integer result for the operations below.
+    // Everything else (floats, strings, null, errors) goes through the regular path.
+    // Use the same visitor as the regular path; only IntegerValue reports itself as integer,
+    // so a can then be modified as one.
+    ArithmeticPair pair;
+    if (checkArithmetic(pair, a, b) != ariInt || !pair.intA) {
+        return false;
+    }
+    afl::data::IntegerValue* ia = static_cast<afl::data::IntegerValue*>(a);
+
+    // Compute in 64 bits; operations that would overflow take the regular path.
+    const int64_t va = pair.ia;
+    const int64_t vb = pair.ib;
+    int64_t result;
+    switch (op) {
+     case biAdd:
+        result = va + vb;
+        break;
+     case biSub:
+        result = va - vb;
+        break;
+     case biMult:
+        result = va * vb;
+        break;
+     case biDivide:
+        if (vb == 0 || va % vb != 0) {
+            return false;
+        }
+        result = va / vb;
+        break;
+     case biIntegerDivide:
+        if (vb == 0) {
+            return false;
+        }
+        result = va / vb;
+        break;
+     case biRemainder:
+        if (vb == 0) {
+            return false;
+        }
+        result = va % vb;
+        break;
+     case biBitAnd:
+        result = va & vb;
+        break;
+     case biBitOr:
+        result = va | vb;
+        break;
+     case biBitXor:
+        result = va ^ vb;
+        break;
+     default:
+        return false;
+    }
+
+    // IntegerValue can only be modified by adding
+    const int64_t delta = result - va;
+    if (result < INT32_MIN || result > INT32_MAX || delta < INT32_MIN || delta > INT32_MAX) {
+        return false;
+    }
+    ia->add(int32_t(delta));
+    return true;
+}
+
 // Execute a comparison operation.
 int
 interpreter::executeComparison(uint8_t op, const afl::data::Value* a, const afl::data::Value* b)
@@ -19,6 +19,17 @@ namespace interpreter {
         \return New value to push on value stack */
     afl::data::Value* executeBinaryOperation(World& world, uint8_t op, const afl::data::Value* a, const afl::data::Value* b);
 
+    /** Execute binary operation in place.
+        For integer arithmetic, modifies the first operand to hold the result instead of allocating a new value.
+        This is possible if the first operand is owned by the caller (e.g. a temporary on the value stack),
+        and the result has the same type.
+        \param op Operation (see BinaryOperation; appears typed as uint8_t in bytecode)
+        \param a  First operand; will be modified
+        \param b  Second operand
+        \retval true  Operation performed; \c a now holds the same result executeBinaryOperation() would have produced
+        \retval false Operation cannot be performed in place; \c a is unchanged, use executeBinaryOperation() */
+    bool executeBinaryOperationInPlace(uint8_t op, afl::data::Value* a, const afl::data::Value* b);
+
     /** Execute a comparison operation.
         \param op Operation (see BinaryOperation; appears typed as uint8_t in bytecode)
         \param a,b User-supplied arguments taken from value stack
@@ -519,6 +519,8 @@ interpreter::BytecodeObject::append(const BytecodeObject& other)
          case Opcode::maFusedBinary:
          case Opcode::maFusedComparison2:
          case Opcode::maInplaceUnary:
+         case Opcode::maFusedMove:
+         case Opcode::maFusedCondJump:
             // Handle scope
             switch (Opcode::Scope(o.minor)) {
              case Opcode::sNamedVariable:
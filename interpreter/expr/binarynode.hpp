@@ -35,6 +35,21 @@ namespace interpreter { namespace expr {
         bool is(BinaryOperation op) const
             { return m_op == op; }
 
+        /** Get operation.
+            @return opcode */
+        BinaryOperation getOperation() const
+            { return m_op; }
+
+        /** Get left (first) operand.
+            @return operand */
+        const Node& getLeft() const
+            { return m_left; }
+
+        /** Get right (second) operand.
+            @return operand */
+        const Node& getRight() const
+            { return m_right; }
+
      private:
         BinaryOperation m_op;
         const Node& m_left;
@@ -34,6 +34,22 @@ namespace interpreter { namespace expr {
             @param del Deleter to hold potentially created new nodes */
         const Node& convertToAssignment(afl::base::Deleter& del) const;
 
+        /** Get operation.
+            @param cc Compilation context (determines case sensitivity)
+            @return minor opcode as it would be generated by compileValue() */
+        uint8_t getOperation(const CompilationContext& cc) const
+            { return cc.hasFlag(CompilationContext::CaseBlind) ? uint8_t(m_minor+1) : m_minor; }
+
+        /** Get left (first) operand.
+            @return operand */
+        const Node& getLeft() const
+            { return m_left; }
+
+        /** Get right (second) operand.
+            @return operand */
+        const Node& getRight() const
+            { return m_right; }
+
      private:
         uint8_t m_minor;
         const Node& m_left;
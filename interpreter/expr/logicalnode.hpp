@@ -28,6 +28,26 @@ namespace interpreter { namespace expr {
         void compileEffect(BytecodeObject& bco, const CompilationContext& cc) const;
         void compileCondition(BytecodeObject& bco, const CompilationContext& cc, BytecodeObject::Label_t ift, BytecodeObject::Label_t iff) const;
 
+        /** Get minor opcode for shortcut jump.
+            @return opcode (jIfFalse, etc.) */
+        uint8_t getShortcutJump() const
+            { return m_shortcutJump; }
+
+        /** Get binary operation.
+            @return opcode (biAnd, etc.) */
+        BinaryOperation getOperation() const
+            { return m_binaryOp; }
+
+        /** Get left (first) operand.
+            @return operand */
+        const Node& getLeft() const
+            { return m_left; }
+
+        /** Get right (second) operand.
+            @return operand */
+        const Node& getRight() const
+            { return m_right; }
+
      private:
         uint8_t m_shortcutJump;
         BinaryOperation m_binaryOp : 8;
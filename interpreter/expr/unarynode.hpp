@@ -34,6 +34,16 @@ namespace interpreter { namespace expr {
         bool is(UnaryOperation op) const
             { return m_op == op; }
 
+        /** Get operation.
+            @return opcode */
+        UnaryOperation getOperation() const
+            { return m_op; }
+
+        /** Get operand.
+            @return operand */
+        const Node& getArgument() const
+            { return m_arg; }
+
      private:
         UnaryOperation m_op;
         const Node& m_arg;
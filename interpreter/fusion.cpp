@@ -39,6 +39,26 @@ namespace {
             && (op.minor & interpreter::Opcode::jPopAlways) != 0;
     }
 
+    /** Check for pop into local variable. */
+    bool isPopLocal(const interpreter::Opcode& op)
+    {
+        return op.is(interpreter::Opcode::maPop)
+            && op.minor == interpreter::Opcode::sLocal;
+    }
+
+    /** Check for push that can be moved directly into a variable: direct storage class or immediate. */
+    bool isMovablePush(const interpreter::Opcode& op)
+    {
+        return op.major == interpreter::Opcode::maPush
+            && (op.minor == interpreter::Opcode::sLocal
+                || op.minor == interpreter::Opcode::sStatic
+                || op.minor == interpreter::Opcode::sShared
+                || op.minor == interpreter::Opcode::sNamedShared
+                || op.minor == interpreter::Opcode::sLiteral
+                || op.minor == interpreter::Opcode::sInteger
+                || op.minor == interpreter::Opcode::sBoolean);
+    }
+
     /** Check for direct storage class, i.e. storage classes that directly
         refer to a data segment that can provide/take values with defined ownership semantics. */
     bool isDirectStorageClass(const interpreter::Opcode& op)
@@ -93,6 +113,8 @@ LocalTracer::isOverwrittenLocal(interpreter::BytecodeObject::PC_t pc, uint16_t a
          case interpreter::Opcode::maFusedBinary:
          case interpreter::Opcode::maFusedComparison2:
          case interpreter::Opcode::maInplaceUnary:
+         case interpreter::Opcode::maFusedMove:
+         case interpreter::Opcode::maFusedCondJump:
             /* Accept only pushloc for different locals, or literals */
             if ((op.minor == interpreter::Opcode::sLocal && op.arg != address)
                 || op.minor == interpreter::Opcode::sLiteral
@@ -233,6 +255,25 @@ interpreter::fuseInstructions(BytecodeObject& bco)
             if (isConditionalJump(me) && isComparison(prev)) {
                 prev.major = interpreter::Opcode::maFusedComparison;
             }
+
+            /* push + jXXp -> fusedcondjump */
+            if (isConditionalJump(me)
+                && (me.minor & interpreter::Opcode::jAlways) != 0
+                && (me.minor & interpreter::Opcode::jAlways) != interpreter::Opcode::jAlways
+                && prev.major == interpreter::Opcode::maPush
+                && isDirectStorageClass(prev))
+            {
+                prev.major = interpreter::Opcode::maFusedCondJump;
+            }
+            break;
+
+         case interpreter::Opcode::maPop:
+            /* push + poploc -> fusedmove (but not for "a := a") */
+            if (isPopLocal(me) && isMovablePush(prev)
+                && !(prev.minor == interpreter::Opcode::sLocal && prev.arg == me.arg))
+            {
+                prev.major = interpreter::Opcode::maFusedMove;
+            }
             break;
 
          case interpreter::Opcode::maFusedComparison:
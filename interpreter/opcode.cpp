@@ -205,6 +205,20 @@ interpreter::Opcode::getDisassemblyTemplate() const
         tpl += formatEnum(minor, SCOPE_ARGS);
         break;
 
+     case maFusedMove:
+        tpl += "push";
+        tpl += formatScope(minor);
+        tpl += "(p)\t";
+        tpl += formatEnum(minor, SCOPE_ARGS);
+        break;
+
+     case maFusedCondJump:
+        tpl += "push";
+        tpl += formatScope(minor);
+        tpl += "(j)\t";
+        tpl += formatEnum(minor, SCOPE_ARGS);
+        break;
+
      default:
         tpl += "unknown?\t%u";
         break;
@@ -240,6 +254,8 @@ interpreter::Opcode::getExternalMajor() const
         return maBinary;
 
      case maInplaceUnary:
+     case maFusedMove:
+     case maFusedCondJump:
         return maPush;
     }
     return major;
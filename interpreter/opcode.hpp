@@ -48,7 +48,9 @@ namespace interpreter {
             maFusedBinary,             ///< Fused binary. maPush + maBinary.
             maFusedComparison,         ///< Fused comparison + jump. maBinary + maJump.
             maFusedComparison2,        ///< Fused push + comparison + jump. maPush + maBinary + maJump.
-            maInplaceUnary             ///< In-place unary. Destructive push + unary.
+            maInplaceUnary,            ///< In-place unary. Destructive push + unary.
+            maFusedMove,               ///< Fused move. maPush + maPop (to local).
+            maFusedCondJump            ///< Fused conditional jump. maPush + conditional maJump with pop.
         };
 
         /** Scope. Used as minor opcode for Push, Pop, Store, Dim. This defines the interpretation of arg. */
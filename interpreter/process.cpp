@@ -647,10 +647,10 @@ interpreter::Process::addTraceTo(Error& err) const
 
 // Run process (set state to Running).
 void
-interpreter::Process::run()
+interpreter::Process::run(uint32_t maxInstructions)
 {
     // ex IntExecutionContext::run()
-    // unsigned counter = 0;
+    uint32_t counter = 0;
     logProcessState("run");
 
     // Notify observers.
@@ -676,11 +676,12 @@ interpreter::Process::run()
             // We no longer distinguish those.
             handleException(e.what(), String_t());
         }
-        // FIXME: port this
-        // if (++counter == 10000) {
-        //     counter = 0;
-        //     checkForBreak();
-        // }
+        // Instruction budget exhausted: stop here, process remains Running.
+        // (PCC2 used a similar counter to check for user break.)
+        if (maxInstructions != 0 && m_state == Running && ++counter >= maxInstructions) {
+            logProcessState("preempt");
+            return;
+        }
     }
     logProcessState("end");
 }
@@ -783,9 +784,14 @@ interpreter::Process::executeInstruction()
             checkStack(2);
             afl::data::Value* a = valueStack.top(1);
             afl::data::Value* b = valueStack.top(0);
-            afl::data::Value* result = executeBinaryOperation(m_world, op.minor, a, b);
-            valueStack.popBackN(2);
-            valueStack.pushBackNew(result);
+            if (executeBinaryOperationInPlace(op.minor, a, b)) {
+                // Result has been stored in a, which is owned by the stack
+                valueStack.popBack();
+            } else {
+                afl::data::Value* result = executeBinaryOperation(m_world, op.minor, a, b);
+                valueStack.popBackN(2);
+                valueStack.pushBackNew(result);
+            }
         }
         break;
 
@@ -793,9 +799,11 @@ interpreter::Process::executeInstruction()
         /* Unary operations */
         {
             checkStack(1);
-            afl::data::Value* result = executeUnaryOperation(m_world, op.minor, valueStack.top(0));
-            valueStack.popBack();
-            valueStack.pushBackNew(result);
+            if (!executeUnaryOperationInPlace(op.minor, valueStack.top(0))) {
+                afl::data::Value* result = executeUnaryOperation(m_world, op.minor, valueStack.top(0));
+                valueStack.popBack();
+                valueStack.pushBackNew(result);
+            }
         }
         break;
 
@@ -1328,9 +1336,12 @@ interpreter::Process::executeInstruction()
             checkStack(1);
             afl::data::Value* a = valueStack.top(0);
             afl::data::Value* b = getReferencedValue(op);
-            afl::data::Value* result = executeBinaryOperation(m_world, (*f.bco)(f.pc).minor, a, b);
-            valueStack.popBack();
-            valueStack.pushBackNew(result);
+            uint8_t minor = (*f.bco)(f.pc).minor;
+            if (!executeBinaryOperationInPlace(minor, a, b)) {
+                afl::data::Value* result = executeBinaryOperation(m_world, minor, a, b);
+                valueStack.popBack();
+                valueStack.pushBackNew(result);
+            }
             ++f.pc;
         } else {
             handleInvalidOpcode();
@@ -1411,6 +1422,53 @@ interpreter::Process::executeInstruction()
         }
         break;
 
+     case Opcode::maFusedMove:
+        /* push + poploc: copy directly, without going through the stack */
+        if (f.pc < f.bco->getNumInstructions()) {
+            const Opcode& next = (*f.bco)(f.pc);
+            switch (op.minor) {
+             case Opcode::sInteger:
+                f.localValues.setNew(next.arg, makeIntegerValue(int16_t(op.arg)));
+                break;
+             case Opcode::sBoolean:
+                f.localValues.setNew(next.arg, makeBooleanValue(int16_t(op.arg)));
+                break;
+             default:
+             {
+                 // A self-assignment is a no-op (and must not clone a value that is being replaced)
+                 afl::data::Value* v = getReferencedValue(op);
+                 if (v != f.localValues[next.arg]) {
+                     f.localValues.set(next.arg, v);
+                 }
+                 break;
+             }
+            }
+            ++f.pc;
+        } else {
+            handleInvalidOpcode();
+        }
+        break;
+
+     case Opcode::maFusedCondJump:
+        /* push + jXXp: test value in place */
+        if (f.pc < f.bco->getNumInstructions()) {
+            const Opcode& next = (*f.bco)(f.pc);
+            int cond = getBooleanValue(getReferencedValue(op));
+            int mask = (cond < 0 ? Opcode::jIfEmpty
+                        : cond > 0 ? Opcode::jIfTrue
+                        : Opcode::jIfFalse);
+            if ((next.minor & mask) != 0) {
+                // Perform the jump
+                f.pc = f.bco->getJumpTarget(next.minor, next.arg);
+            } else {
+                // Skip the jump
+                ++f.pc;
+            }
+        } else {
+            handleInvalidOpcode();
+        }
+        break;
+
      default:
         handleInvalidOpcode();
     }
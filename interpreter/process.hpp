@@ -380,8 +380,14 @@ namespace interpreter {
             - Terminated
             - Failed
             - Suspended
-            - Waiting */
-        void run();
+            - Waiting
+
+            If an instruction budget is given, also returns after executing that many instructions,
+            leaving the process in state Running (preempted).
+            Calling run() again continues it.
+
+            \param maxInstructions Maximum number of instructions to execute; 0 for no limit */
+        void run(uint32_t maxInstructions = 0);
 
         /** Execute a single instruction.
             Does not catch errors; caller needs to do that. */
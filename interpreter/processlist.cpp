@@ -20,7 +20,9 @@
   *  This does not support user-defined functions; we therefore do not support that either.
   */
 
+#include <algorithm>
 #include "interpreter/processlist.hpp"
+#include "afl/sys/time.hpp"
 #include "interpreter/process.hpp"
 #include "interpreter/world.hpp"
 
@@ -62,7 +64,10 @@ interpreter::ProcessList::ProcessList()
     : m_processes(),
       m_processGroupId(0),
       m_processId(0),
-      m_running(false)
+      m_running(false),
+      m_timeSlice(0),
+      m_lastRunDuration(0),
+      m_maxRunDuration(0)
 { }
 
 // Destructor.
@@ -292,9 +297,15 @@ interpreter::ProcessList::run()
     // We must avoid being called recursively, i.e. if a process causes ProcessList::run to be called again.
     if (!m_running) {
         m_running = true;
+        const uint32_t startTime = afl::sys::Time::getTickCounter();
+        bool preempted = false;
         try {
-            while (Process* proc = findRunningProcess()) {
-                proc->run();
+            while (!preempted) {
+                Process* proc = findRunningProcess();
+                if (proc == 0) {
+                    break;
+                }
+                proc->run(m_timeSlice);
                 sig_processStateChange.raise(*proc, false);
 
                 bool handled = false;
@@ -313,8 +324,17 @@ interpreter::ProcessList::run()
                     handled = true;
                     break;
 
-                 case Process::Runnable:
                  case Process::Running:
+                    if (m_timeSlice != 0) {
+                        // Preempted. Let others of the same priority go first, and return to caller.
+                        moveToEndOfPriority(*proc);
+                        preempted = true;
+                        handled = true;
+                        break;
+                    }
+                    // Without time slice, this is the same as Runnable
+                    /* FALLTHROUGH */
+                 case Process::Runnable:
                     // run() should not exit with a process in this state.
                     // Mark it failed and proceed with the process group.
                     proc->setState(Process::Failed);
@@ -354,9 +374,51 @@ interpreter::ProcessList::run()
             m_running = false;
             throw;
         }
+        m_lastRunDuration = afl::sys::Time::getTickCounter() - startTime;
+        m_maxRunDuration = std::max(m_maxRunDuration, m_lastRunDuration);
+
+        // Tell whoever is in charge of continuing; do this last so that a listener can call run() again.
+        if (preempted) {
+            sig_preempt.raise();
+        }
     }
 }
 
+// Set time slice.
+void
+interpreter::ProcessList::setTimeSlice(uint32_t numInstructions)
+{
+    m_timeSlice = numInstructions;
+}
+
+// Get time slice.
+uint32_t
+interpreter::ProcessList::getTimeSlice() const
+{
+    return m_timeSlice;
+}
+
+// Check for running processes.
+bool
+interpreter::ProcessList::hasRunningProcesses() const
+{
+    return findRunningProcess() != 0;
+}
+
+// Get duration of last run() call.
+uint32_t
+interpreter::ProcessList::getLastRunDuration() const
+{
+    return m_lastRunDuration;
+}
+
+// Get maximum duration of a run() call.
+uint32_t
+interpreter::ProcessList::getMaxRunDuration() const
+{
+    return m_maxRunDuration;
+}
+
 // Terminate all processes.
 void
 interpreter::ProcessList::terminateAllProcesses()
@@ -494,3 +556,19 @@ interpreter::ProcessList::findRunningProcess() const
     }
     return 0;
 }
+
+void
+interpreter::ProcessList::moveToEndOfPriority(const Process& proc)
+{
+    // Locate the process
+    size_t pos = 0;
+    while (pos < m_processes.size() && &proc != m_processes[pos]) {
+        ++pos;
+    }
+
+    // Move it behind all processes with the same priority
+    while (pos+1 < m_processes.size() && m_processes[pos+1]->getPriority() <= proc.getPriority()) {
+        m_processes.swapElements(pos, pos+1);
+        ++pos;
+    }
+}
@@ -157,9 +157,39 @@ namespace interpreter {
         /** Run selected processes.
             Runs as many processes as it possibly can, in priority order:
             - processes started with startProcessGroup()
-            - processes that got selected because their predecessor in their process group terminated */
+            - processes that got selected because their predecessor in their process group terminated
+
+            If a time slice has been configured (setTimeSlice()), a process that exceeds its slice is preempted:
+            it remains in state Running, is moved behind all other processes of the same priority,
+            and run() returns to give the caller a chance to do other work.
+            In this case, hasRunningProcesses() returns true, and sig_preempt is raised;
+            its listener is responsible for calling run() again later.
+            Callers therefore need not check for preemption themselves.
+            Successive calls run the processes of one priority round-robin. */
         void run();
 
+        /** Set time slice.
+            \param numInstructions Maximum number of instructions a process executes before being preempted; 0 to disable preemption (default) */
+        void setTimeSlice(uint32_t numInstructions);
+
+        /** Get time slice.
+            \return time slice, see setTimeSlice() */
+        uint32_t getTimeSlice() const;
+
+        /** Check for running processes.
+            \return true if there are processes in state Running, i.e. run() has work to do */
+        bool hasRunningProcesses() const;
+
+        /** Get duration of last run() call.
+            This is the time the caller was blocked executing scripts,
+            i.e. the latency imposed on other requests waiting for the caller.
+            \return duration in milliseconds */
+        uint32_t getLastRunDuration() const;
+
+        /** Get maximum duration of a run() call.
+            \return duration in milliseconds, see getLastRunDuration() */
+        uint32_t getMaxRunDuration() const;
+
         /** Terminate all processes.
             Marks all processes terminated, excluding frozen ones. Call removeTerminatedProcesses() to actually remove the objects.
 
@@ -209,12 +239,20 @@ namespace interpreter {
             \param willDelete Whether process will be deleted */
         afl::base::Signal<void(const Process&, bool)> sig_processStateChange;
 
+        /** Signal: processes were preempted.
+            Raised at the end of a run() call that returned with processes still in state Running
+            because they exceeded their time slice (setTimeSlice()).
+            Whoever configured the time slice should listen on this signal and schedule another run(). */
+        afl::base::Signal<void()> sig_preempt;
+
      private:
         /** Allocate a process Id. */
         uint32_t allocateProcessId();
 
         Process* findRunningProcess() const;
 
+        void moveToEndOfPriority(const Process& proc);
+
         /** Process list. */
         Vector_t m_processes;
 
@@ -226,6 +264,15 @@ namespace interpreter {
 
         /** Marker for recursive invocation. */
         bool m_running;
+
+        /** Time slice (instructions); 0 if disabled. */
+        uint32_t m_timeSlice;
+
+        /** Duration of last run() call (milliseconds). */
+        uint32_t m_lastRunDuration;
+
+        /** Maximum duration of a run() call (milliseconds). */
+        uint32_t m_maxRunDuration;
     };
 
 }
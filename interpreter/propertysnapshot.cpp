@@ -0,0 +1,203 @@
+/**
+  *  \file interpreter/propertysnapshot.cpp
+  *  \brief Class interpreter::PropertySnapshot
+  */
+
+#include <memory>
+#include "interpreter/propertysnapshot.hpp"
+#include "afl/data/visitor.hpp"
+#include "interpreter/error.hpp"
+#include "interpreter/values.hpp"
+
+namespace {
+    /* Classify a value into a cell state. */
+    class Classifier : public afl::data::Visitor {
+     public:
+        Classifier()
+            : m_state(interpreter::PropertySnapshot::Empty), m_value(0)
+            { }
+        virtual void visitString(const String_t& /*str*/)
+            { m_state = interpreter::PropertySnapshot::Other; }
+        virtual void visitInteger(int32_t iv)
+            { m_state = interpreter::PropertySnapshot::Integer; m_value = iv; }
+        virtual void visitFloat(double /*fv*/)
+            { m_state = interpreter::PropertySnapshot::Other; }
+        virtual void visitBoolean(bool bv)
+            { visitInteger(bv); }
+        virtual void visitHash(const afl::data::Hash& /*hv*/)
+            { m_state = interpreter::PropertySnapshot::Other; }
+        virtual void visitVector(const afl::data::Vector& /*vv*/)
+            { m_state = interpreter::PropertySnapshot::Other; }
+        virtual void visitOther(const afl::data::Value& /*other*/)
+            { m_state = interpreter::PropertySnapshot::Other; }
+        virtual void visitNull()
+            { m_state = interpreter::PropertySnapshot::Empty; }
+        virtual void visitError(const String_t& /*source*/, const String_t& /*str*/)
+            { m_state = interpreter::PropertySnapshot::Other; }
+
+        interpreter::PropertySnapshot::State getState() const
+            { return m_state; }
+        int32_t getValue() const
+            { return m_value; }
+
+     private:
+        interpreter::PropertySnapshot::State m_state;
+        int32_t m_value;
+    };
+}
+
+// Constructor.
+interpreter::PropertySnapshot::PropertySnapshot()
+    : m_columns(),
+      m_numRows(0)
+{ }
+
+// Destructor.
+interpreter::PropertySnapshot::~PropertySnapshot()
+{ }
+
+// Add a column.
+interpreter::PropertySnapshot::Column_t
+interpreter::PropertySnapshot::addColumn(const String_t& name)
+{
+    for (size_t i = 0, n = m_columns.size(); i < n; ++i) {
+        if (m_columns[i]->name == name) {
+            return i;
+        }
+    }
+    m_columns.pushBackNew(new Column(name));
+    return m_columns.size() - 1;
+}
+
+// Get number of columns.
+size_t
+interpreter::PropertySnapshot::getNumColumns() const
+{
+    return m_columns.size();
+}
+
+// Get name of a column.
+const String_t&
+interpreter::PropertySnapshot::getColumnName(Column_t col) const
+{
+    return m_columns[col]->name;
+}
+
+// Add a row.
+void
+interpreter::PropertySnapshot::addRow(Context& ctx)
+{
+    for (size_t i = 0, n = m_columns.size(); i < n; ++i) {
+        Column& c = *m_columns[i];
+
+        // Catch up if column was added late
+        while (c.states.size() < m_numRows) {
+            c.values.pushBackNew(0);
+            c.integers.push_back(0);
+            c.states.push_back(Missing);
+        }
+
+        // Obtain value
+        std::auto_ptr<afl::data::Value> value;
+        State state = Missing;
+        try {
+            Context::PropertyIndex_t index;
+            if (Context::PropertyAccessor* acc = ctx.lookup(c.name, index)) {
+                value.reset(acc->get(index));
+                state = Empty;
+            }
+        }
+        catch (Error& e) {
+            value.reset(makeStringValue(e.what()));
+            state = Failed;
+        }
+
+        // Classify and store
+        int32_t iv = 0;
+        if (state == Empty) {
+            Classifier cl;
+            cl.visit(value.get());
+            state = cl.getState();
+            iv = cl.getValue();
+        }
+        c.values.pushBackNew(value.release());
+        c.integers.push_back(iv);
+        c.states.push_back(static_cast<uint8_t>(state));
+    }
+    ++m_numRows;
+}
+
+// Get number of rows.
+size_t
+interpreter::PropertySnapshot::getNumRows() const
+{
+    return m_numRows;
+}
+
+// Get state of a cell.
+interpreter::PropertySnapshot::State
+interpreter::PropertySnapshot::getState(size_t row, Column_t col) const
+{
+    if (const Column* c = getColumn(row, col)) {
+        return static_cast<State>(c->states[row]);
+    } else {
+        return Missing;
+    }
+}
+
+// Get value of a cell.
+const afl::data::Value*
+interpreter::PropertySnapshot::getValue(size_t row, Column_t col) const
+{
+    if (const Column* c = getColumn(row, col)) {
+        return c->values[row];
+    } else {
+        return 0;
+    }
+}
+
+// Get integer value of a cell.
+int32_t
+interpreter::PropertySnapshot::getInteger(size_t row, Column_t col) const
+{
+    if (const Column* c = getColumn(row, col)) {
+        return c->integers[row];
+    } else {
+        return 0;
+    }
+}
+
+// Remove all rows.
+void
+interpreter::PropertySnapshot::clearRows()
+{
+    for (size_t i = 0, n = m_columns.size(); i < n; ++i) {
+        Column& c = *m_columns[i];
+        c.values.clear();
+        c.integers.clear();
+        c.states.clear();
+    }
+    m_numRows = 0;
+}
+
+// Remove all rows and columns.
+void
+interpreter::PropertySnapshot::clear()
+{
+    m_columns.clear();
+    m_numRows = 0;
+}
+
+/** Get column, with range check.
+    \param row Row index
+    \param col Column index
+    \return column; null if either index is out of range */
+const interpreter::PropertySnapshot::Column*
+interpreter::PropertySnapshot::getColumn(size_t row, Column_t col) const
+{
+    if (col < m_columns.size() && row < m_columns[col]->states.size()) {
+        return m_columns[col];
+    } else {
+        return 0;
+    }
+}
@@ -0,0 +1,118 @@
+/**
+  *  \file interpreter/propertysnapshot.hpp
+  *  \brief Class interpreter::PropertySnapshot
+  */
+#ifndef C2NG_INTERPRETER_PROPERTYSNAPSHOT_HPP
+#define C2NG_INTERPRETER_PROPERTYSNAPSHOT_HPP
+
+#include <vector>
+#include "afl/base/types.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/data/segment.hpp"
+#include "afl/data/value.hpp"
+#include "afl/string/string.hpp"
+#include "interpreter/context.hpp"
+
+namespace interpreter {
+
+    /** Columnar snapshot of object properties.
+
+        A PropertySnapshot stores the values of a set of properties (columns) for a set of objects (rows).
+        Each row is extracted from a Context once, by looking up each column's property by name,
+        as a script "With" statement would do.
+        Evaluating expressions over the snapshot (SnapshotExpression) then does not need to look up properties again.
+
+        In addition to the value, each cell records its state.
+        Integer (and boolean) values are additionally stored in native form to allow evaluation without dynamic type checks. */
+    class PropertySnapshot {
+     public:
+        /** Column index. */
+        typedef size_t Column_t;
+
+        /** State of a cell. */
+        enum State {
+            Missing,            ///< Property does not exist on this object (lookup failed).
+            Failed,             ///< Property exists, but reading it failed (threw an interpreter::Error).
+            Empty,              ///< Property value is empty.
+            Integer,            ///< Property value is an integer or boolean; getInteger() is valid.
+            Other               ///< Property value is something else (string, float, object).
+        };
+
+        /** Constructor.
+            Makes an empty snapshot. */
+        PropertySnapshot();
+
+        /** Destructor. */
+        ~PropertySnapshot();
+
+        /** Add a column.
+            If a column of the same name already exists, returns that.
+            Columns should be added before rows; rows added before a column are reported as Missing for it.
+            \param name Property name (upper-case)
+            \return column index */
+        Column_t addColumn(const String_t& name);
+
+        /** Get number of columns.
+            \return number of columns */
+        size_t getNumColumns() const;
+
+        /** Get name of a column.
+            \param col Column index [0,getNumColumns())
+            \return name */
+        const String_t& getColumnName(Column_t col) const;
+
+        /** Add a row.
+            Extracts all column values from the given context's current object.
+            \param ctx Context */
+        void addRow(Context& ctx);
+
+        /** Get number of rows.
+            \return number of rows */
+        size_t getNumRows() const;
+
+        /** Get state of a cell.
+            \param row Row index [0,getNumRows())
+            \param col Column index [0,getNumColumns())
+            \return state; Missing if index out of range */
+        State getState(size_t row, Column_t col) const;
+
+        /** Get value of a cell.
+            \param row Row index [0,getNumRows())
+            \param col Column index [0,getNumColumns())
+            \return value, owned by PropertySnapshot; null if state is Missing or Empty.
+            For state Failed, a string containing the error message. */
+        const afl::data::Value* getValue(size_t row, Column_t col) const;
+
+        /** Get integer value of a cell.
+            \param row Row index [0,getNumRows())
+            \param col Column index [0,getNumColumns())
+            \return value; 0 if state is not Integer */
+        int32_t getInteger(size_t row, Column_t col) const;
+
+        /** Remove all rows.
+            Columns remain. */
+        void clearRows();
+
+        /** Remove all rows and columns. */
+        void clear();
+
+     private:
+        struct Column {
+            String_t name;
+            afl::data::Segment values;
+            std::vector<int32_t> integers;
+            std::vector<uint8_t> states;
+
+            explicit Column(const String_t& name)
+                : name(name), values(), integers(), states()
+                { }
+        };
+        afl::container::PtrVector<Column> m_columns;
+        size_t m_numRows;
+
+        const Column* getColumn(size_t row, Column_t col) const;
+    };
+
+}
+
+#endif
@@ -0,0 +1,415 @@
+/**
+  *  \file interpreter/snapshotexpression.cpp
+  *  \brief Class interpreter::SnapshotExpression
+  */
+
+#include "interpreter/snapshotexpression.hpp"
+#include "interpreter/binaryexecution.hpp"
+#include "interpreter/binaryoperation.hpp"
+#include "interpreter/context.hpp"
+#include "interpreter/error.hpp"
+#include "interpreter/expr/binarynode.hpp"
+#include "interpreter/expr/casenode.hpp"
+#include "interpreter/expr/identifiernode.hpp"
+#include "interpreter/expr/literalnode.hpp"
+#include "interpreter/expr/logicalnode.hpp"
+#include "interpreter/expr/unarynode.hpp"
+#include "interpreter/unaryexecution.hpp"
+#include "interpreter/unaryoperation.hpp"
+#include "interpreter/values.hpp"
+#include "interpreter/world.hpp"
+
+using afl::data::Value;
+using interpreter::PropertySnapshot;
+
+/** Node of the evaluation tree.
+    Items do not have side-effects; an item can therefore be evaluated multiple times with identical result. */
+class interpreter::SnapshotExpression::Item : public afl::base::Deletable {
+ public:
+    /** Get value.
+        \param row Row
+        \return newly-allocated value; null if empty */
+    virtual Value* getValue(size_t row) const = 0;
+
+    /** Get value as condition.
+        \param row Row
+        \return -1 if empty, 0 if false, 1 if true */
+    virtual int getCondition(size_t row) const
+        {
+            std::auto_ptr<Value> v(getValue(row));
+            return getBooleanValue(v.get());
+        }
+
+    /** Get value as integer, if possible without allocating.
+        Booleans are reported as 0/1.
+        \param [in]  row Row
+        \param [out] out Result
+        \return true if value is integer or boolean and was produced; false to use getValue() */
+    virtual bool getInteger(size_t /*row*/, int32_t& /*out*/) const
+        { return false; }
+};
+
+namespace {
+    using interpreter::Error;
+    using interpreter::SnapshotExpression;
+
+    /* Check for integer or boolean value. */
+    bool getScalar(const Value* value, int32_t& out)
+    {
+        if (const afl::data::ScalarValue* sv = dynamic_cast<const afl::data::ScalarValue*>(value)) {
+            out = sv->getValue();
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    /*
+     *  Literal
+     */
+    class LiteralItem : public SnapshotExpression::Item {
+     public:
+        LiteralItem(Value* value)
+            : m_value(value)
+            { }
+        virtual Value* getValue(size_t /*row*/) const
+            { return afl::data::Value::cloneOf(m_value.get()); }
+        virtual int getCondition(size_t /*row*/) const
+            { return interpreter::getBooleanValue(m_value.get()); }
+        virtual bool getInteger(size_t /*row*/, int32_t& out) const
+            { return getScalar(m_value.get(), out); }
+     private:
+        std::auto_ptr<Value> m_value;
+    };
+
+    /*
+     *  Identifier (snapshot column)
+     */
+    class ColumnItem : public SnapshotExpression::Item {
+     public:
+        ColumnItem(const PropertySnapshot& snapshot, PropertySnapshot::Column_t column, Value* global, bool hasGlobal)
+            : m_snapshot(snapshot), m_column(column), m_global(global), m_hasGlobal(hasGlobal)
+            { }
+        virtual Value* getValue(size_t row) const
+            {
+                switch (m_snapshot.getState(row, m_column)) {
+                 case PropertySnapshot::Missing:
+                    if (!m_hasGlobal) {
+                        throw Error::unknownIdentifier(m_snapshot.getColumnName(m_column));
+                    }
+                    return afl::data::Value::cloneOf(m_global.get());
+
+                 case PropertySnapshot::Failed:
+                    throw Error(interpreter::toString(m_snapshot.getValue(row, m_column), false));
+
+                 case PropertySnapshot::Empty:
+                    return 0;
+
+                 case PropertySnapshot::Integer:
+                 case PropertySnapshot::Other:
+                    return afl::data::Value::cloneOf(m_snapshot.getValue(row, m_column));
+                }
+                return 0;
+            }
+        virtual bool getInteger(size_t row, int32_t& out) const
+            {
+                if (m_snapshot.getState(row, m_column) == PropertySnapshot::Integer) {
+                    out = m_snapshot.getInteger(row, m_column);
+                    return true;
+                } else {
+                    return false;
+                }
+            }
+     private:
+        const PropertySnapshot& m_snapshot;
+        PropertySnapshot::Column_t m_column;
+        std::auto_ptr<Value> m_global;
+        bool m_hasGlobal;
+    };
+
+    /*
+     *  Unary operation
+     */
+    class UnaryItem : public SnapshotExpression::Item {
+     public:
+        UnaryItem(interpreter::World& world, uint8_t op, const Item& arg)
+            : m_world(world), m_op(op), m_arg(arg)
+            { }
+        virtual Value* getValue(size_t row) const
+            {
+                switch (m_op) {
+                 case interpreter::unNot:
+                 case interpreter::unBool: {
+                    int c = getCondition(row);
+                    return c < 0 ? 0 : interpreter::makeBooleanValue(c);
+                 }
+                 default: {
+                    std::auto_ptr<Value> arg(m_arg.getValue(row));
+                    return interpreter::executeUnaryOperation(m_world, m_op, arg.get());
+                 }
+                }
+            }
+        virtual int getCondition(size_t row) const
+            {
+                switch (m_op) {
+                 case interpreter::unNot: {
+                    int c = m_arg.getCondition(row);
+                    return c < 0 ? c : !c;
+                 }
+                 case interpreter::unBool:
+                    return m_arg.getCondition(row);
+                 default:
+                    return Item::getCondition(row);
+                }
+            }
+     private:
+        interpreter::World& m_world;
+        uint8_t m_op;
+        const Item& m_arg;
+    };
+
+    /*
+     *  Binary operation
+     */
+    class BinaryItem : public SnapshotExpression::Item {
+     public:
+        BinaryItem(interpreter::World& world, uint8_t op, const Item& left, const Item& right)
+            : m_world(world), m_op(op), m_left(left), m_right(right)
+            { }
+        virtual Value* getValue(size_t row) const
+            {
+                int32_t a, b;
+                if (isComparison() && m_left.getInteger(row, a) && m_right.getInteger(row, b)) {
+                    return interpreter::makeBooleanValue(compare(a, b));
+                }
+                std::auto_ptr<Value> va(m_left.getValue(row));
+                std::auto_ptr<Value> vb(m_right.getValue(row));
+                return interpreter::executeBinaryOperation(m_world, m_op, va.get(), vb.get());
+            }
+        virtual int getCondition(size_t row) const
+            {
+                int32_t a, b;
+                if (isComparison() && m_left.getInteger(row, a) && m_right.getInteger(row, b)) {
+                    return compare(a, b);
+                }
+                return Item::getCondition(row);
+            }
+        virtual bool getInteger(size_t row, int32_t& out) const
+            {
+                int32_t a, b;
+                if (isComparison() && m_left.getInteger(row, a) && m_right.getInteger(row, b)) {
+                    out = compare(a, b);
+                    return true;
+                }
+                return false;
+            }
+     private:
+        interpreter::World& m_world;
+        uint8_t m_op;
+        const Item& m_left;
+        const Item& m_right;
+
+        bool isComparison() const
+            { return m_op >= interpreter::biCompareEQ && m_op <= interpreter::biCompareGT_NC; }
+
+        int compare(int32_t a, int32_t b) const
+            {
+                // Case-blind and case-sensitive versions behave identically for integers
+                switch (m_op) {
+                 case interpreter::biCompareEQ: case interpreter::biCompareEQ_NC: return a == b;
+                 case interpreter::biCompareNE: case interpreter::biCompareNE_NC: return a != b;
+                 case interpreter::biCompareLE: case interpreter::biCompareLE_NC: return a <= b;
+                 case interpreter::biCompareLT: case interpreter::biCompareLT_NC: return a < b;
+                 case interpreter::biCompareGE: case interpreter::biCompareGE_NC: return a >= b;
+                 case interpreter::biCompareGT: case interpreter::biCompareGT_NC: return a > b;
+                }
+                return 0;
+            }
+    };
+
+    /*
+     *  Logical operation (And, Or, Xor)
+     *
+     *  Same semantics as LogicalNode::compileValue():
+     *  left operand is converted to bool (except for Xor),
+     *  right operand is only evaluated if the left one does not determine the result.
+     */
+    class LogicalItem : public SnapshotExpression::Item {
+     public:
+        LogicalItem(uint8_t op, const Item& left, const Item& right)
+            : m_op(op), m_left(left), m_right(right)
+            { }
+        virtual Value* getValue(size_t row) const
+            {
+                int c = getCondition(row);
+                return c < 0 ? 0 : interpreter::makeBooleanValue(c);
+            }
+        virtual int getCondition(size_t row) const
+            {
+                int a = m_left.getCondition(row);
+                switch (m_op) {
+                 case interpreter::biAnd:
+                    if (a == 0) {
+                        return 0;
+                    } else {
+                        int b = m_right.getCondition(row);
+                        return b == 0 ? 0 : (a < 0 || b < 0) ? -1 : 1;
+                    }
+                 case interpreter::biOr:
+                    if (a > 0) {
+                        return 1;
+                    } else {
+                        int b = m_right.getCondition(row);
+                        return b > 0 ? 1 : (a < 0 || b < 0) ? -1 : 0;
+                    }
+                 case interpreter::biXor:
+                    if (a < 0) {
+                        return -1;
+                    } else {
+                        int b = m_right.getCondition(row);
+                        return b < 0 ? -1 : (a != b);
+                    }
+                }
+                return -1;
+            }
+     private:
+        uint8_t m_op;
+        const Item& m_left;
+        const Item& m_right;
+    };
+
+
+    /*
+     *  Compiler
+     */
+    class Compiler {
+     public:
+        Compiler(afl::container::PtrVector<SnapshotExpression::Item>& items, PropertySnapshot& snapshot, const interpreter::CompilationContext& cc, afl::base::Memory<const char*const> excludedNames)
+            : m_items(items), m_snapshot(snapshot), m_compilationContext(cc), m_excludedNames(excludedNames)
+            { }
+
+        const SnapshotExpression::Item* compile(const interpreter::expr::Node& node);
+
+     private:
+        afl::container::PtrVector<SnapshotExpression::Item>& m_items;
+        PropertySnapshot& m_snapshot;
+        const interpreter::CompilationContext& m_compilationContext;
+        afl::base::Memory<const char*const> m_excludedNames;
+
+        const SnapshotExpression::Item* add(SnapshotExpression::Item* p)
+            { return m_items.pushBackNew(p); }
+        const SnapshotExpression::Item* compileIdentifier(const String_t& name);
+        bool isExcluded(const String_t& name) const;
+    };
+}
+
+const SnapshotExpression::Item*
+Compiler::compile(const interpreter::expr::Node& node)
+{
+    using namespace interpreter::expr;
+    interpreter::World& world = m_compilationContext.world();
+    if (const IdentifierNode* in = dynamic_cast<const IdentifierNode*>(&node)) {
+        return compileIdentifier(in->getIdentifier());
+    } else if (const LiteralNode* ln = dynamic_cast<const LiteralNode*>(&node)) {
+        return add(new LiteralItem(afl::data::Value::cloneOf(ln->getValue())));
+    } else if (const UnaryNode* un = dynamic_cast<const UnaryNode*>(&node)) {
+        const SnapshotExpression::Item* arg = compile(un->getArgument());
+        return arg != 0 ? add(new UnaryItem(world, un->getOperation(), *arg)) : 0;
+    } else if (const BinaryNode* bn = dynamic_cast<const BinaryNode*>(&node)) {
+        const SnapshotExpression::Item* left = compile(bn->getLeft());
+        const SnapshotExpression::Item* right = left != 0 ? compile(bn->getRight()) : 0;
+        return right != 0 ? add(new BinaryItem(world, bn->getOperation(), *left, *right)) : 0;
+    } else if (const CaseNode* cn = dynamic_cast<const CaseNode*>(&node)) {
+        const SnapshotExpression::Item* left = compile(cn->getLeft());
+        const SnapshotExpression::Item* right = left != 0 ? compile(cn->getRight()) : 0;
+        return right != 0 ? add(new BinaryItem(world, cn->getOperation(m_compilationContext), *left, *right)) : 0;
+    } else if (const LogicalNode* lo = dynamic_cast<const LogicalNode*>(&node)) {
+        const SnapshotExpression::Item* left = compile(lo->getLeft());
+        const SnapshotExpression::Item* right = left != 0 ? compile(lo->getRight()) : 0;
+        return right != 0 ? add(new LogicalItem(lo->getOperation(), *left, *right)) : 0;
+    } else {
+        // Function call, member reference, assignment, sequence: not supported
+        return 0;
+    }
+}
+
+const SnapshotExpression::Item*
+Compiler::compileIdentifier(const String_t& name)
+{
+    if (isExcluded(name)) {
+        return 0;
+    }
+
+    // Resolve global fallback, as Process::lookup() would do after failing to find the object property.
+    // Global contexts are searched last-to-first, same as in a process.
+    const afl::container::PtrVector<interpreter::Context>& globals = m_compilationContext.world().globalContexts();
+    std::auto_ptr<Value> global;
+    bool hasGlobal = false;
+    for (size_t i = globals.size(); i > 0 && !hasGlobal; --i) {
+        if (interpreter::Context* ctx = globals[i-1]) {
+            interpreter::Context::PropertyIndex_t index;
+            if (interpreter::Context::PropertyAccessor* acc = ctx->lookup(name, index)) {
+                try {
+                    global.reset(acc->get(index));
+                    hasGlobal = true;
+                }
+                catch (Error&) {
+                    // Cannot evaluate now; let the interpreter deal with it
+                    return 0;
+                }
+            }
+        }
+    }
+
+    return add(new ColumnItem(m_snapshot, m_snapshot.addColumn(name), global.release(), hasGlobal));
+}
+
+bool
+Compiler::isExcluded(const String_t& name) const
+{
+    afl::base::Memory<const char*const> names = m_excludedNames;
+    while (const char*const* p = names.eat()) {
+        if (name == *p) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+// Compile an expression.
+interpreter::SnapshotExpression*
+interpreter::SnapshotExpression::compile(const expr::Node& node, PropertySnapshot& snapshot, const CompilationContext& cc, afl::base::Memory<const char*const> excludedNames)
+{
+    std::auto_ptr<SnapshotExpression> result(new SnapshotExpression());
+    result->m_root = Compiler(result->m_items, snapshot, cc, excludedNames).compile(node);
+    if (result->m_root == 0) {
+        return 0;
+    }
+    return result.release();
+}
+
+// Constructor.
+interpreter::SnapshotExpression::SnapshotExpression()
+    : m_items(),
+      m_root(0)
+{ }
+
+// Destructor.
+interpreter::SnapshotExpression::~SnapshotExpression()
+{ }
+
+// Evaluate expression.
+afl::data::Value*
+interpreter::SnapshotExpression::evaluate(size_t row) const
+{
+    return m_root->getValue(row);
+}
+
+// Evaluate expression as condition.
+int
+interpreter::SnapshotExpression::evaluateCondition(size_t row) const
+{
+    return m_root->getCondition(row);
+}
@@ -0,0 +1,75 @@
+/**
+  *  \file interpreter/snapshotexpression.hpp
+  *  \brief Class interpreter::SnapshotExpression
+  */
+#ifndef C2NG_INTERPRETER_SNAPSHOTEXPRESSION_HPP
+#define C2NG_INTERPRETER_SNAPSHOTEXPRESSION_HPP
+
+#include <memory>
+#include "afl/base/deletable.hpp"
+#include "afl/base/memory.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/data/value.hpp"
+#include "interpreter/compilationcontext.hpp"
+#include "interpreter/expr/node.hpp"
+#include "interpreter/propertysnapshot.hpp"
+
+namespace interpreter {
+
+    /** Expression evaluated over a PropertySnapshot.
+
+        A SnapshotExpression evaluates an expression tree for rows of a PropertySnapshot,
+        with the same result as evaluating it in a "With" statement for the respective object,
+        but without creating a process and without looking up properties by name for every object.
+
+        Only side-effect free expressions consisting of identifiers, literals, unary, binary, comparison and logical operators are supported.
+        Everything else (function calls, member references, assignments, etc.) is rejected by compile(),
+        and must be evaluated using the regular interpreter.
+
+        Identifiers are resolved as follows:
+        - if the object has the property, its value is used (snapshot column);
+        - otherwise, the value of a global variable is used (looked up once in World::globalContexts()).
+          Names that may be shadowed by local variables of the caller must be passed to compile() as excluded names;
+          expressions using them are rejected.
+
+        Comparisons and logical operations of integer (and boolean) values are evaluated natively without allocating values. */
+    class SnapshotExpression : public afl::base::Deletable, private afl::base::Uncopyable {
+     public:
+        /** Node of the evaluation tree. */
+        class Item;
+
+        /** Compile an expression.
+            Columns for all identifiers used by the expression are added to the snapshot.
+            \param node          Expression tree (must remain valid only during the call)
+            \param snapshot      Snapshot (must out-live the SnapshotExpression)
+            \param cc            Compilation context (provides case-sensitivity flag and world)
+            \param excludedNames Names that cannot be resolved from the snapshot
+            \return newly-allocated SnapshotExpression; null if the expression is not supported */
+        static SnapshotExpression* compile(const expr::Node& node, PropertySnapshot& snapshot, const CompilationContext& cc, afl::base::Memory<const char*const> excludedNames);
+
+        /** Destructor. */
+        ~SnapshotExpression();
+
+        /** Evaluate expression.
+            \param row Row index
+            \return newly-allocated value; null if result is empty
+            \throw Error on error (same as the interpreter) */
+        afl::data::Value* evaluate(size_t row) const;
+
+        /** Evaluate expression as condition.
+            \param row Row index
+            \return result as per getBooleanValue(): -1 if empty, 0 if false, 1 if true
+            \throw Error on error (same as the interpreter) */
+        int evaluateCondition(size_t row) const;
+
+     private:
+        SnapshotExpression();
+
+        afl::container::PtrVector<Item> m_items;
+        const Item* m_root;
+    };
+
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include "afl/charset/utf8.hpp"
 #include "afl/charset/utf8reader.hpp"
 #include "afl/data/floatvalue.hpp"
+#include "afl/data/integervalue.hpp"
 #include "afl/data/scalarvalue.hpp"
 #include "afl/data/stringvalue.hpp"
 #include "afl/data/visitor.hpp"
@@ -20,6 +21,7 @@
 #include "interpreter/error.hpp"
 #include "interpreter/filevalue.hpp"
 #include "interpreter/keymapvalue.hpp"
+#include "interpreter/unaryoperation.hpp"
 #include "interpreter/values.hpp"
 #include "interpreter/world.hpp"
 #include "util/math.hpp"
@@ -665,3 +667,45 @@ interpreter::executeUnaryOperation(World& world, uint8_t op, const afl::data::Va
         throw Error::internalError("invalid unary operation");
     }
 }
+
+// Execute unary operation in place.
+bool
+interpreter::executeUnaryOperationInPlace(uint8_t op, afl::data::Value* arg)
+{
+    // Only integers; everything else (including bool, which produces a new integer) goes through the regular path.
+    afl::data::IntegerValue* iv = dynamic_cast<afl::data::IntegerValue*>(arg);
+    if (iv == 0) {
+        return false;
+    }
+
+    // Compute in 64 bits; operations that would overflow take the regular path.
+    const int64_t value = iv->getValue();
+    int64_t result;
+    switch (op) {
+     case unNeg:
+        result = -value;
+        break;
+     case unPos:
+        result = value;
+        break;
+     case unInc:
+        result = value + 1;
+        break;
+     case unDec:
+        result = value - 1;
+        break;
+     case unBitNot:
+        result = ~value;
+        break;
+     default:
+        return false;
+    }
+
+    // IntegerValue can only be modified by adding
+    const int64_t delta = result - value;
+    if (result < INT32_MIN || result > INT32_MAX || delta < INT32_MIN || delta > INT32_MAX) {
+        return false;
+    }
+    iv->add(int32_t(delta));
+    return true;
+}
@@ -19,6 +19,14 @@ namespace interpreter {
         \return New value to push on value stack */
     afl::data::Value* executeUnaryOperation(World& world, uint8_t op, const afl::data::Value* arg);
 
+    /** Execute unary operation in place.
+        For integer arithmetic, modifies the argument to hold the result instead of allocating a new value.
+        \param op Operation (see UnaryOperation; appears typed as uint8_t in bytecode)
+        \param arg Argument, owned by caller (e.g. a temporary on the value stack); will be modified
+        \retval true  Operation performed; \c arg now holds the same result executeUnaryOperation() would have produced
+        \retval false Operation cannot be performed in place; \c arg is unchanged, use executeUnaryOperation() */
+    bool executeUnaryOperationInPlace(uint8_t op, afl::data::Value* arg);
+
 }
 
 #endif
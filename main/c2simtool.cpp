@@ -7,10 +7,19 @@
 #include "afl/io/filesystem.hpp"
 #include "afl/sys/environment.hpp"
 
+#ifdef TARGET_OS_POSIX
+# include "util/process/posixfactory.hpp"
+typedef util::process::PosixFactory SubprocessFactory_t;
+#else
+// Non-functional fallback for non-POSIX; distributed simulation will not work
+# include "util/process/nullfactory.hpp"
+typedef util::process::NullFactory SubprocessFactory_t;
+#endif
+
 int main(int, char** argv)
 {
     afl::sys::Environment& env = afl::sys::Environment::getInstance(argv);
     afl::io::FileSystem& fs = afl::io::FileSystem::getInstance();
-    return game::sim::ConsoleApplication(env, fs).run();
+    SubprocessFactory_t factory;
+    return game::sim::ConsoleApplication(env, fs, factory).run();
 }
-
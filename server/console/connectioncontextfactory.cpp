@@ -11,20 +11,29 @@
 #include "server/types.hpp"
 #include "server/ports.hpp"
 
+namespace {
+    /* Check whether a command changes connection state (i.e. it is USER). */
+    bool isConnectionStateCommand(const afl::data::Segment& seg)
+    {
+        return seg.size() > 0
+            && afl::string::strCaseCompare(server::toString(seg[0]), "USER") == 0;
+    }
+}
+
 class server::console::ConnectionContextFactory::Impl : public Context {
  public:
-    explicit Impl(String_t name, afl::net::resp::Client& client);
+    explicit Impl(ConnectionContextFactory& parent);
     virtual bool call(const String_t& cmd, interpreter::Arguments args, Parser& parser, std::auto_ptr<afl::data::Value>& result);
     virtual String_t getName();
 
  private:
-    String_t m_name;
+    ConnectionContextFactory& m_parent;
     afl::net::resp::Client& m_client;
 };
 
-server::console::ConnectionContextFactory::Impl::Impl(String_t name, afl::net::resp::Client& client)
-    : m_name(name),
-      m_client(client)
+server::console::ConnectionContextFactory::Impl::Impl(ConnectionContextFactory& parent)
+    : m_parent(parent),
+      m_client(parent.getClient())
 { }
 
 bool
@@ -57,6 +66,7 @@ server::console::ConnectionContextFactory::Impl::call(const String_t& cmd, inter
         }
         uint32_t endTicks = afl::sys::Time::getTickCounter();
         uint32_t elapsed = endTicks - startTicks;
+        m_parent.updateConnectionState(seg);
 
         // Return
         result.reset(makeStringValue(afl::string::Format("%d.%03d seconds (%d ms per iteration)", elapsed / 1000, elapsed % 1000, elapsed / n)));
@@ -85,23 +95,37 @@ server::console::ConnectionContextFactory::Impl::call(const String_t& cmd, inter
     //     if (client.maybeReconnect(host, port)) {
     //         std::cout << "(auto-reconnecting to " << host << ":" << port << "...)\n";
     //     }
-    result.reset(m_client.call(seg));
+    if (m_parent.m_pipeline.isActive()) {
+        // Defer to end of pipeline; result will be reported there.
+        // Commands that change connection state cannot be pipelined, because pipelined commands are spread over multiple connections.
+        if (isConnectionStateCommand(seg)) {
+            throw std::runtime_error(afl::string::Format("\"%s\" cannot be used in a pipeline", toString(seg[0])));
+        }
+        m_parent.m_pipeline.add(m_parent, seg);
+    } else {
+        result.reset(m_client.call(seg));
+        m_parent.updateConnectionState(seg);
+    }
     return true;
 }
 
 String_t
 server::console::ConnectionContextFactory::Impl::getName()
 {
-    return m_name;
+    return m_parent.m_name;
 }
 
 /************************ ConnectionContextFactory ***********************/
 
-server::console::ConnectionContextFactory::ConnectionContextFactory(String_t name, uint16_t defaultPort, afl::net::NetworkStack& stack)
+server::console::ConnectionContextFactory::ConnectionContextFactory(String_t name, uint16_t defaultPort, afl::net::NetworkStack& stack, Pipeline& pipeline)
     : m_name(name),
       m_address(DEFAULT_ADDRESS, defaultPort),
       m_networkStack(stack),
-      m_client()
+      m_pipeline(pipeline),
+      m_client(),
+      m_pipelineClients(),
+      m_pipelineUsers(),
+      m_user()
 {
     // ex ConnectionContext::ConnectionContext
 }
@@ -117,11 +141,7 @@ server::console::ConnectionContextFactory::getCommandName()
 server::console::Context*
 server::console::ConnectionContextFactory::create()
 {
-    if (m_client.get() == 0) {
-        // FIXME: std::cout << "(connecting to " << host << ":" << port << "...)\n";
-        m_client.reset(new afl::net::resp::Client(m_networkStack, m_address));
-    }
-    return new Impl(m_name, *m_client);
+    return new Impl(*this);
 }
 
 bool
@@ -138,3 +158,49 @@ server::console::ConnectionContextFactory::handleConfiguration(const String_t& k
         return false;
     }
 }
+
+String_t
+server::console::ConnectionContextFactory::getName()
+{
+    return m_name;
+}
+
+afl::net::CommandHandler&
+server::console::ConnectionContextFactory::getConnection(size_t index)
+{
+    // Connection 0 is the regular one; additional connections are kept for further pipelines
+    if (index == 0) {
+        return getClient();
+    }
+    while (m_pipelineClients.size() < index) {
+        m_pipelineClients.pushBackNew(new afl::net::resp::Client(m_networkStack, m_address));
+        m_pipelineUsers.push_back(String_t());
+    }
+
+    // Give the connection the same state as the regular one, so commands behave the same on every connection
+    afl::net::resp::Client& client = *m_pipelineClients[index-1];
+    String_t& user = m_pipelineUsers[index-1];
+    if (user != m_user) {
+        client.callVoid(afl::data::Segment().pushBackString("USER").pushBackString(m_user));
+        user = m_user;
+    }
+    return client;
+}
+
+void
+server::console::ConnectionContextFactory::updateConnectionState(const afl::data::Segment& seg)
+{
+    if (isConnectionStateCommand(seg)) {
+        m_user = (seg.size() > 1 ? toString(seg[1]) : String_t());
+    }
+}
+
+afl::net::resp::Client&
+server::console::ConnectionContextFactory::getClient()
+{
+    if (m_client.get() == 0) {
+        // FIXME: std::cout << "(connecting to " << host << ":" << port << "...)\n";
+        m_client.reset(new afl::net::resp::Client(m_networkStack, m_address));
+    }
+    return *m_client;
+}
@@ -5,29 +5,44 @@
 #define C2NG_SERVER_CONSOLE_CONNECTIONCONTEXTFACTORY_HPP
 
 #include <memory>
+#include <vector>
 #include "server/console/contextfactory.hpp"
+#include "afl/container/ptrvector.hpp"
 #include "afl/net/name.hpp"
 #include "afl/net/resp/client.hpp"
 #include "afl/net/networkstack.hpp"
+#include "server/console/pipeline.hpp"
 
 namespace server { namespace console {
 
-    class ConnectionContextFactory : public ContextFactory {
+    class ConnectionContextFactory : public ContextFactory, public Pipeline::Target {
      public:
-        ConnectionContextFactory(String_t name, uint16_t defaultPort, afl::net::NetworkStack& stack);
+        ConnectionContextFactory(String_t name, uint16_t defaultPort, afl::net::NetworkStack& stack, Pipeline& pipeline);
         ~ConnectionContextFactory();
 
+        // ContextFactory:
         virtual String_t getCommandName();
         virtual Context* create();
         virtual bool handleConfiguration(const String_t& key, const String_t& value);
 
+        // Pipeline::Target:
+        virtual String_t getName();
+        virtual afl::net::CommandHandler& getConnection(size_t index);
+
      private:
         class Impl;
 
         String_t m_name;
         afl::net::Name m_address;
         afl::net::NetworkStack& m_networkStack;
+        Pipeline& m_pipeline;
         std::auto_ptr<afl::net::resp::Client> m_client;
+        afl::container::PtrVector<afl::net::resp::Client> m_pipelineClients;
+        std::vector<String_t> m_pipelineUsers;   // USER set on each of m_pipelineClients
+        String_t m_user;                         // USER set on m_client; empty for admin
+
+        afl::net::resp::Client& getClient();
+        void updateConnectionState(const afl::data::Segment& seg);
     };
 
 } }
@@ -3,15 +3,18 @@
   *  \brief Class server::console::ConsoleApplication
   */
 
+#include <algorithm>
 #include "server/console/consoleapplication.hpp"
 #include "afl/base/optional.hpp"
 #include "afl/data/access.hpp"
 #include "afl/data/vector.hpp"
+#include "afl/data/vectorvalue.hpp"
 #include "afl/data/visitor.hpp"
 #include "afl/io/stream.hpp"
 #include "afl/io/textfile.hpp"
 #include "afl/io/textwriter.hpp"
 #include "afl/string/format.hpp"
+#include "afl/string/parse.hpp"
 #include "afl/sys/standardcommandlineparser.hpp"
 #include "interpreter/values.hpp"
 #include "server/console/arcanecommandhandler.hpp"
@@ -41,6 +44,10 @@
 using afl::string::Format;
 
 namespace {
+    /* Number of connections per service for "pipeline" */
+    const int32_t DEFAULT_PIPELINE_CONNECTIONS = 4;
+    const int32_t MAX_PIPELINE_CONNECTIONS = 100;
+
     String_t quoteString(String_t s)
     {
         String_t result = "\"";
@@ -138,6 +145,7 @@ server::console::ConsoleApplication::ConsoleApplication(afl::sys::Environment& e
     : Application(env, fs),
       ConfigurationHandler(log(), "console"),
       m_networkStack(net),
+      m_pipeline(),
       m_environment(),
       m_contextStack(),
       m_macros(m_environment)
@@ -146,15 +154,15 @@ server::console::ConsoleApplication::ConsoleApplication(afl::sys::Environment& e
     m_contextStack.pushBackNew(new RootContext(*this));
 
     // Available contexts
-    m_availableContexts.pushBackNew(new ConnectionContextFactory("doc", DOC_PORT, m_networkStack));
-    m_availableContexts.pushBackNew(new ConnectionContextFactory("file", FILE_PORT, m_networkStack));
-    m_availableContexts.pushBackNew(new ConnectionContextFactory("format", FORMAT_PORT, m_networkStack));
-    m_availableContexts.pushBackNew(new ConnectionContextFactory("host", HOST_PORT, m_networkStack));
-    m_availableContexts.pushBackNew(new ConnectionContextFactory("hostfile", HOSTFILE_PORT, m_networkStack));
-    m_availableContexts.pushBackNew(new ConnectionContextFactory("mailout", MAILOUT_PORT, m_networkStack));
-    m_availableContexts.pushBackNew(new ConnectionContextFactory("redis", DB_PORT, m_networkStack));
-    m_availableContexts.pushBackNew(new ConnectionContextFactory("talk", TALK_PORT, m_networkStack));
-    m_availableContexts.pushBackNew(new ConnectionContextFactory("user", USER_PORT, m_networkStack));
+    m_availableContexts.pushBackNew(new ConnectionContextFactory("doc", DOC_PORT, m_networkStack, m_pipeline));
+    m_availableContexts.pushBackNew(new ConnectionContextFactory("file", FILE_PORT, m_networkStack, m_pipeline));
+    m_availableContexts.pushBackNew(new ConnectionContextFactory("format", FORMAT_PORT, m_networkStack, m_pipeline));
+    m_availableContexts.pushBackNew(new ConnectionContextFactory("host", HOST_PORT, m_networkStack, m_pipeline));
+    m_availableContexts.pushBackNew(new ConnectionContextFactory("hostfile", HOSTFILE_PORT, m_networkStack, m_pipeline));
+    m_availableContexts.pushBackNew(new ConnectionContextFactory("mailout", MAILOUT_PORT, m_networkStack, m_pipeline));
+    m_availableContexts.pushBackNew(new ConnectionContextFactory("redis", DB_PORT, m_networkStack, m_pipeline));
+    m_availableContexts.pushBackNew(new ConnectionContextFactory("talk", TALK_PORT, m_networkStack, m_pipeline));
+    m_availableContexts.pushBackNew(new ConnectionContextFactory("user", USER_PORT, m_networkStack, m_pipeline));
     m_availableContexts.pushBackNew(new RouterContextFactory("router", m_networkStack));
 
     // Be quiet by default.
@@ -453,5 +461,69 @@ server::console::ConsoleApplication::call(const String_t& cmd, interpreter::Argu
         return call(toString(args.getNext()), args, parser, suppressedResult);
     }
 
+    if (cmd == "pipeline") {
+        /* @q pipeline [CONNECTIONS:Int] BODY:Code (Global Console Command)
+           Execute commands pipelined.
+           Executes BODY, but does not send service commands (redis, host, etc.) immediately.
+           Instead, they are collected and sent when BODY has finished,
+           using CONNECTIONS parallel connections per service (default: 4).
+           This is much faster than waiting for each command's reply individually,
+           and is intended for mass operations such as
+           <pre>pipeline {foreach g {host gamestat $g} 1 2 3 4 5}</pre>
+           Note that service commands within BODY therefore must be independent of each other:
+           they produce no result while BODY executes, and are executed in unspecified order.
+           Commands whose result is needed (e.g. to produce the list for a foreach loop) must be executed outside the pipeline.
+           Router commands are not pipelined.
+
+           Pipelined commands are spread over multiple connections.
+           A "user" context set on a service before the pipeline applies to all its connections,
+           but commands that change connection state ("user") cannot be used within the pipeline.
+
+           Errors are reported per command.
+           If BODY fails, no commands are sent.
+           Returns a list of all commands' results, in command order;
+           use "silent pipeline ..." to suppress this output.
+           @since PCC2 2.41.2 */
+        args.checkArgumentCount(1, 2);
+        int32_t numConnections = DEFAULT_PIPELINE_CONNECTIONS;
+        if (args.getNumArgs() > 1) {
+            if (!afl::string::strToInteger(toString(args.getNext()), numConnections) || numConnections <= 0 || numConnections > MAX_PIPELINE_CONNECTIONS) {
+                throw std::runtime_error("Invalid number of connections");
+            }
+        }
+        String_t body = toString(args.getNext());
+
+        // Nested pipeline just adds to the outer one
+        if (m_pipeline.isActive()) {
+            std::auto_ptr<afl::data::Value> tmp;
+            parser.evaluateString(body, tmp);
+            return true;
+        }
+
+        // Collect commands
+        m_pipeline.start();
+        try {
+            std::auto_ptr<afl::data::Value> tmp;
+            parser.evaluateString(body, tmp);
+        }
+        catch (...) {
+            m_pipeline.cancel();
+            throw;
+        }
+
+        // Execute
+        afl::data::Segment results;
+        afl::data::StringList_t errors;
+        Pipeline::Statistics st = m_pipeline.execute(numConnections, results, errors);
+        for (size_t i = 0; i < errors.size(); ++i) {
+            parser.terminal().printError(errors[i]);
+        }
+        parser.terminal().printMessage(Format("%d command%!1{s%}, %d error%!1{s%}, %d.%03d seconds, %d commands/second",
+                                              st.numCommands, st.numErrors, st.elapsedTime / 1000, st.elapsedTime % 1000,
+                                              st.numCommands * 1000 / std::max(st.elapsedTime, uint32_t(1))));
+        result.reset(new afl::data::VectorValue(afl::data::Vector::create(results)));
+        return true;
+    }
+
     return m_contextStack.back()->call(cmd, args, parser, result);
 }
@@ -16,6 +16,7 @@
 #include "server/console/dumbterminal.hpp"
 #include "server/console/environment.hpp"
 #include "server/console/macrocommandhandler.hpp"
+#include "server/console/pipeline.hpp"
 #include "server/types.hpp"
 #include "util/application.hpp"
 
@@ -75,6 +76,10 @@ namespace server { namespace console {
         /** Network stack instance. */
         afl::net::tunnel::TunnelableNetworkStack m_networkStack;
 
+        /** Command pipeline.
+            (Must be before m_availableContexts which refer to it.) */
+        Pipeline m_pipeline;
+
         /** Available Contexts.
             (Must be before m_contextStack to satisfy the guarantee that Context objects don't outlive their ContextFactory.) */
         afl::container::PtrVector<ContextFactory> m_availableContexts;
@@ -0,0 +1,195 @@
+/**
+  *  \file server/console/pipeline.cpp
+  *  \brief Class server::console::Pipeline
+  */
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include "server/console/pipeline.hpp"
+#include "afl/base/stoppable.hpp"
+#include "afl/string/format.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/thread.hpp"
+#include "afl/sys/time.hpp"
+#include "server/types.hpp"
+
+/*
+ *  Command: a collected command, and its result.
+ *  Between start and end of execute(), each Command is accessed by only one Worker.
+ */
+struct server::console::Pipeline::Command {
+    size_t targetIndex;
+    afl::data::Segment command;
+    std::auto_ptr<afl::data::Value> result;
+    String_t error;
+    bool failed;
+
+    Command(size_t index, afl::data::Segment& cmd)
+        : targetIndex(index), command(), result(), error(), failed(false)
+        { command.swap(cmd); }
+};
+
+/*
+ *  Worker: executes commands on one set of connections (one per target) until no more commands remain.
+ *
+ *  The thread calling execute() acts as the first Worker itself;
+ *  each additional set of connections gets its own thread.
+ */
+class server::console::Pipeline::Worker : public afl::base::Stoppable {
+ public:
+    Worker(Pipeline& parent)
+        : m_parent(parent), m_connections()
+        { }
+
+    void addConnection(afl::net::CommandHandler& conn)
+        { m_connections.push_back(&conn); }
+
+    virtual void run()
+        {
+            while (Command* p = m_parent.getNextCommand()) {
+                try {
+                    p->result.reset(m_connections[p->targetIndex]->call(p->command));
+                }
+                catch (std::exception& e) {
+                    p->error = e.what();
+                    p->failed = true;
+                }
+            }
+        }
+    virtual void stop()
+        { }
+
+ private:
+    Pipeline& m_parent;
+    std::vector<afl::net::CommandHandler*> m_connections;
+};
+
+
+// Constructor.
+server::console::Pipeline::Pipeline()
+    : m_commands(),
+      m_targets(),
+      m_active(false),
+      m_mutex(),
+      m_nextCommand(0)
+{ }
+
+// Destructor.
+server::console::Pipeline::~Pipeline()
+{ }
+
+// Start collecting commands.
+void
+server::console::Pipeline::start()
+{
+    m_active = true;
+}
+
+// Check whether pipeline is active.
+bool
+server::console::Pipeline::isActive() const
+{
+    return m_active;
+}
+
+// Add a command.
+void
+server::console::Pipeline::add(Target& target, afl::data::Segment& command)
+{
+    m_commands.pushBackNew(new Command(getTargetIndex(target), command));
+}
+
+// Discard all collected commands and end pipeline mode.
+void
+server::console::Pipeline::cancel()
+{
+    m_commands.clear();
+    m_targets.clear();
+    m_active = false;
+}
+
+// Get number of collected commands.
+size_t
+server::console::Pipeline::getNumCommands() const
+{
+    return m_commands.size();
+}
+
+// Execute all collected commands and end pipeline mode.
+server::console::Pipeline::Statistics
+server::console::Pipeline::execute(size_t numConnections, afl::data::Segment& results, afl::data::StringList_t& errors)
+{
+    Statistics stats;
+    try {
+        // Do not create more connections than needed
+        numConnections = std::max(size_t(1), std::min(numConnections, m_commands.size()));
+
+        // Set up workers; connections are established here, in a single thread
+        afl::container::PtrVector<Worker> workers;
+        for (size_t i = 0; i < numConnections; ++i) {
+            Worker& w = *workers.pushBackNew(new Worker(*this));
+            for (size_t t = 0; t < m_targets.size(); ++t) {
+                w.addConnection(m_targets[t]->getConnection(i));
+            }
+        }
+
+        // Execute
+        uint32_t startTicks = afl::sys::Time::getTickCounter();
+        m_nextCommand = 0;
+        {
+            afl::container::PtrVector<afl::sys::Thread> threads;
+            for (size_t i = 1; i < workers.size(); ++i) {
+                threads.pushBackNew(new afl::sys::Thread("console.pipeline", *workers[i]))->start();
+            }
+            workers[0]->run();
+            for (size_t i = 0; i < threads.size(); ++i) {
+                threads[i]->join();
+            }
+        }
+        stats.elapsedTime = afl::sys::Time::getTickCounter() - startTicks;
+
+        // Produce output in order
+        for (size_t i = 0; i < m_commands.size(); ++i) {
+            Command& c = *m_commands[i];
+            if (c.failed) {
+                String_t verb = c.command.size() > 0 ? toString(c.command[0]) : String_t();
+                errors.push_back(afl::string::Format("#%d (%s %s): %s", i+1, m_targets[c.targetIndex]->getName(), verb, c.error));
+                ++stats.numErrors;
+            }
+            results.pushBackNew(c.result.release());
+        }
+        stats.numCommands = m_commands.size();
+    }
+    catch (...) {
+        cancel();
+        throw;
+    }
+    cancel();
+    return stats;
+}
+
+// Get index of a target into m_targets, adding it if needed.
+size_t
+server::console::Pipeline::getTargetIndex(Target& target)
+{
+    for (size_t i = 0; i < m_targets.size(); ++i) {
+        if (m_targets[i] == &target) {
+            return i;
+        }
+    }
+    m_targets.push_back(&target);
+    return m_targets.size() - 1;
+}
+
+// Get next command to execute (called by Worker).
+server::console::Pipeline::Command*
+server::console::Pipeline::getNextCommand()
+{
+    afl::sys::MutexGuard g(m_mutex);
+    if (m_nextCommand < m_commands.size()) {
+        return m_commands[m_nextCommand++];
+    } else {
+        return 0;
+    }
+}
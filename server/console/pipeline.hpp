@@ -0,0 +1,112 @@
+/**
+  *  \file server/console/pipeline.hpp
+  *  \brief Class server::console::Pipeline
+  */
+#ifndef C2NG_SERVER_CONSOLE_PIPELINE_HPP
+#define C2NG_SERVER_CONSOLE_PIPELINE_HPP
+
+#include <vector>
+#include "afl/base/types.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/data/segment.hpp"
+#include "afl/data/stringlist.hpp"
+#include "afl/net/commandhandler.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/string/string.hpp"
+
+namespace server { namespace console {
+
+    /** Pipelined command execution.
+
+        While a pipeline is active, service commands are not executed immediately, but collected.
+        execute() then sends all collected commands at once, using multiple connections per service in parallel,
+        and reports results and errors in command order.
+        This avoids waiting for a round-trip for each individual command.
+
+        Commands in a pipeline must therefore be independent of each other;
+        their relative execution order is not specified. */
+    class Pipeline {
+     public:
+        /** Command target.
+            Represents a service that can receive pipelined commands. */
+        class Target {
+         public:
+            virtual ~Target()
+                { }
+
+            /** Get name of service (for messages).
+                \return name */
+            virtual String_t getName() = 0;
+
+            /** Get connection.
+                Each index must produce a different connection;
+                the same index must produce the same connection each time.
+                Called from the thread calling Pipeline::execute() only;
+                the connection will then be used by a single worker thread.
+                \param index Index, [0, numConnections)
+                \return connection */
+            virtual afl::net::CommandHandler& getConnection(size_t index) = 0;
+        };
+
+        /** Execution statistics. */
+        struct Statistics {
+            size_t numCommands;        ///< Number of commands executed.
+            size_t numErrors;          ///< Number of commands that failed.
+            uint32_t elapsedTime;      ///< Elapsed time in milliseconds.
+            Statistics()
+                : numCommands(0), numErrors(0), elapsedTime(0)
+                { }
+        };
+
+        /** Constructor.
+            Makes an inactive pipeline. */
+        Pipeline();
+
+        /** Destructor. */
+        ~Pipeline();
+
+        /** Start collecting commands. */
+        void start();
+
+        /** Check whether pipeline is active.
+            \return true if start() has been called and commands are being collected */
+        bool isActive() const;
+
+        /** Add a command.
+            \param target  Target service; must outlive the Pipeline
+            \param command Command. Content will be taken over; command will be empty afterwards. */
+        void add(Target& target, afl::data::Segment& command);
+
+        /** Discard all collected commands and end pipeline mode. */
+        void cancel();
+
+        /** Get number of collected commands.
+            \return number */
+        size_t getNumCommands() const;
+
+        /** Execute all collected commands and end pipeline mode.
+            \param [in]  numConnections Number of connections to use per service (at least 1)
+            \param [out] results        Results, one per command, in command order (null for failed commands)
+            \param [out] errors         Error messages, one per failed command, in command order
+            \return statistics
+            \throw std::exception if a connection cannot be established; in this case, no commands are executed */
+        Statistics execute(size_t numConnections, afl::data::Segment& results, afl::data::StringList_t& errors);
+
+     private:
+        struct Command;
+        class Worker;
+
+        afl::container::PtrVector<Command> m_commands;
+        std::vector<Target*> m_targets;
+        bool m_active;
+
+        afl::sys::Mutex m_mutex;
+        size_t m_nextCommand;
+
+        size_t getTargetIndex(Target& target);
+        Command* getNextCommand();
+    };
+
+} }
+
+#endif
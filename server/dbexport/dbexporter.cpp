@@ -3,8 +3,11 @@
   *  \brief Function server::dbexport::exportDatabase
   */
 
+#include <algorithm>
 #include <stdexcept>
 #include "server/dbexport/dbexporter.hpp"
+#include "afl/base/stoppable.hpp"
+#include "afl/container/ptrvector.hpp"
 #include "afl/data/access.hpp"
 #include "afl/data/segment.hpp"
 #include "afl/data/stringlist.hpp"
@@ -14,6 +17,8 @@
 #include "afl/net/redis/stringlistkey.hpp"
 #include "afl/net/redis/stringsetkey.hpp"
 #include "afl/string/format.hpp"
+#include "afl/sys/semaphore.hpp"
+#include "afl/sys/thread.hpp"
 
 using afl::net::redis::HashKey;
 using afl::net::redis::Key;
@@ -86,6 +91,13 @@ namespace {
     };
 
 
+    /* Number of keys to process at once.
+       This is the granularity of output and of distribution to connections. */
+    const size_t BATCH_SIZE = 100;
+
+    /* "COUNT" hint for SCAN. */
+    const int32_t SCAN_COUNT = 1000;
+
     /** Get keys matching a wildcard (redis KEYS command).
         The redis client does not have a direct mapping for the "keys" command, so we need our own version.
         \param dbConnection Database to work on
@@ -98,71 +110,261 @@ namespace {
         std::sort(keys.begin(), keys.end());
     }
 
-    /** Export a database subtree.
-        \param out Output receiver
+    /** Get next batch of keys matching a wildcard (redis SCAN command).
+        Unlike KEYS, this does not block the database for the whole keyspace.
+        A key may be reported more than once.
         \param dbConnection Database to work on
-        \param match Wildcard to match keys to export */
-    void exportSubtree(afl::io::TextWriter& out, afl::net::CommandHandler& dbConnection, String_t match)
+        \param cursor [in/out] Cursor; start with "0"
+        \param match Wildcard
+        \param keys [out] List of keys, sorted
+        \return true if there are more keys (cursor is not "0") */
+    bool scanKeys(afl::net::CommandHandler& dbConnection, String_t& cursor, const String_t& match, afl::data::StringList_t& keys)
     {
-        afl::data::StringList_t keys;
-        getKeys(dbConnection, match, keys);
-        for (size_t i = 0; i < keys.size(); ++i) {
-            const String_t& name = keys[i];
-            switch (Key(dbConnection, name).getType()) {
-             case Key::None:
-                out.writeLine(Format("# warning: key %s got deleted during export", quoteConsoleString(name)));
-                break;
-             case Key::String:
-                out.writeLine(Format("silent redis set   %-30s %s",
+        std::auto_ptr<afl::data::Value> val(dbConnection.call(afl::data::Segment().pushBackString("SCAN").pushBackString(cursor)
+                                                              .pushBackString("MATCH").pushBackString(match)
+                                                              .pushBackString("COUNT").pushBackInteger(SCAN_COUNT)));
+        afl::data::Access a(val);
+        cursor = a[0].toString();
+        keys.clear();
+        a[1].toStringList(keys);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return cursor != "0";
+    }
+
+    /** Export a single key.
+        \param out [out] Output lines are appended here
+        \param dbConnection Database to work on
+        \param name Key name
+        \param repeatable true to produce output that can be repeated for the same key (delete lists before re-creating them) */
+    void exportKey(afl::data::StringList_t& out, afl::net::CommandHandler& dbConnection, const String_t& name, bool repeatable)
+    {
+        switch (Key(dbConnection, name).getType()) {
+         case Key::None:
+            out.push_back(Format("# warning: key %s got deleted during export", quoteConsoleString(name)));
+            break;
+         case Key::String:
+            out.push_back(Format("silent redis set   %-30s %s",
+                                 quoteConsoleString(name),
+                                 quoteConsoleString(StringKey(dbConnection, name).get())));
+            break;
+         case Key::List: {
+            afl::data::StringList_t values;
+            StringListKey(dbConnection, name).getAll(values);
+            if (repeatable) {
+                out.push_back(Format("silent redis del   %s", quoteConsoleString(name)));
+            }
+            for (size_t j = 0; j < values.size(); ++j) {
+                out.push_back(Format("silent redis rpush %-30s %s",
                                      quoteConsoleString(name),
-                                     quoteConsoleString(StringKey(dbConnection, name).get())));
-                break;
-             case Key::List: {
-                afl::data::StringList_t values;
-                StringListKey(dbConnection, name).getAll(values);
-                for (size_t j = 0; j < values.size(); ++j) {
-                    out.writeLine(Format("silent redis rpush %-30s %s",
-                                         quoteConsoleString(name),
-                                         quoteConsoleString(values[j])));
+                                     quoteConsoleString(values[j])));
+            }
+            break;
+         }
+         case Key::Set: {
+            afl::data::StringList_t values;
+            StringSetKey(dbConnection, name).getAll(values);
+            std::sort(values.begin(), values.end());
+            for (size_t j = 0; j < values.size(); ++j) {
+                out.push_back(Format("silent redis sadd  %-30s %s",
+                                     quoteConsoleString(name),
+                                     quoteConsoleString(values[j])));
+            }
+            break;
+         }
+         case Key::Hash: {
+            afl::data::StringList_t values;
+            HashKey(dbConnection, name).getAll(values);
+
+            // Sort for reproducability!
+            std::vector<size_t> indexes;
+            for (size_t j = 0; j+1 < values.size(); j += 2) {
+                indexes.push_back(j);
+            }
+            std::sort(indexes.begin(), indexes.end(), IndirectSorter(values));
+
+            // Output
+            for (size_t j = 0; j < indexes.size(); ++j) {
+                out.push_back(Format("silent redis hset  %-30s %s %s",
+                                     quoteConsoleString(name),
+                                     quoteConsoleString(values[indexes[j]]),
+                                     quoteConsoleString(values[indexes[j]+1])));
+            }
+            break;
+         }
+         case Key::ZSet:
+         case Key::Unknown:
+            out.push_back(Format("# warning: key %s has an unsupported type", quoteConsoleString(name)));
+            break;
+        }
+    }
+
+    /*
+     *  Fetcher: exports a slice of a batch of keys using one database connection.
+     *
+     *  The control thread processes the first slice itself;
+     *  each additional connection has a thread that waits for a start signal, processes its slice, and signals completion.
+     */
+    class Fetcher : public afl::base::Stoppable {
+     public:
+        Fetcher(afl::net::CommandHandler& dbConnection)
+            : m_dbConnection(dbConnection), m_repeatable(false),
+              m_pKeys(0), m_first(0), m_last(0),
+              m_output(), m_error(), m_failed(false), m_terminate(false),
+              m_startSignal(0), m_stopSignal(0)
+            { }
+
+        void setSlice(const afl::data::StringList_t& keys, size_t first, size_t last, bool repeatable)
+            {
+                m_repeatable = repeatable;
+                m_pKeys = &keys;
+                m_first = first;
+                m_last = last;
+                m_output.clear();
+            }
+
+        void fetch()
+            {
+                try {
+                    for (size_t i = m_first; i < m_last; ++i) {
+                        exportKey(m_output, m_dbConnection, (*m_pKeys)[i], m_repeatable);
+                    }
                 }
-                break;
-             }
-             case Key::Set: {
-                afl::data::StringList_t values;
-                StringSetKey(dbConnection, name).getAll(values);
-                std::sort(values.begin(), values.end());
-                for (size_t j = 0; j < values.size(); ++j) {
-                    out.writeLine(Format("silent redis sadd  %-30s %s",
-                                         quoteConsoleString(name),
-                                         quoteConsoleString(values[j])));
+                catch (std::exception& e) {
+                    m_error = e.what();
+                    m_failed = true;
                 }
-                break;
-             }
-             case Key::Hash: {
-                afl::data::StringList_t values;
-                HashKey(dbConnection, name).getAll(values);
-
-                // Sort for reproducability!
-                std::vector<size_t> indexes;
-                for (size_t j = 0; j+1 < values.size(); j += 2) {
-                    indexes.push_back(j);
+            }
+
+        void start()
+            { m_startSignal.post(); }
+
+        void wait()
+            { m_stopSignal.wait(); }
+
+        void write(afl::io::TextWriter& out)
+            {
+                if (m_failed) {
+                    throw std::runtime_error(m_error);
                 }
-                std::sort(indexes.begin(), indexes.end(), IndirectSorter(values));
-
-                // Output
-                for (size_t j = 0; j < indexes.size(); ++j) {
-                    out.writeLine(Format("silent redis hset  %-30s %s %s",
-                                         quoteConsoleString(name),
-                                         quoteConsoleString(values[indexes[j]]),
-                                         quoteConsoleString(values[indexes[j]+1])));
+                for (size_t i = 0; i < m_output.size(); ++i) {
+                    out.writeLine(m_output[i]);
+                }
+                m_output.clear();
+            }
+
+        // Stoppable:
+        virtual void run()
+            {
+                while (1) {
+                    m_startSignal.wait();
+                    if (m_terminate) {
+                        break;
+                    }
+                    fetch();
+                    m_stopSignal.post();
                 }
-                break;
-             }
-             case Key::ZSet:
-             case Key::Unknown:
-                out.writeLine(Format("# warning: key %s has an unsupported type", quoteConsoleString(name)));
-                break;
             }
+        virtual void stop()
+            {
+                m_terminate = true;
+                m_startSignal.post();
+            }
+
+     private:
+        afl::net::CommandHandler& m_dbConnection;
+        bool m_repeatable;
+        const afl::data::StringList_t* m_pKeys;
+        size_t m_first;
+        size_t m_last;
+        afl::data::StringList_t m_output;
+        String_t m_error;
+        bool m_failed;
+        bool m_terminate;
+        afl::sys::Semaphore m_startSignal;
+        afl::sys::Semaphore m_stopSignal;
+    };
+
+    /*
+     *  Exporter: exports lists of keys in batches, distributing each batch to all connections.
+     *  Output is produced in key order, after each batch.
+     */
+    class Exporter {
+     public:
+        Exporter(afl::io::TextWriter& out, afl::base::Memory<afl::net::CommandHandler*const> dbConnections)
+            : m_out(out), m_fetchers(), m_threads()
+            {
+                while (afl::net::CommandHandler*const* p = dbConnections.eat()) {
+                    Fetcher& f = *m_fetchers.pushBackNew(new Fetcher(**p));
+                    if (m_fetchers.size() > 1) {
+                        m_threads.pushBackNew(new afl::sys::Thread("dbexport.fetch", f))->start();
+                    }
+                }
+            }
+
+        ~Exporter()
+            {
+                for (size_t i = 1; i < m_fetchers.size(); ++i) {
+                    m_fetchers[i]->stop();
+                }
+                for (size_t i = 0; i < m_threads.size(); ++i) {
+                    m_threads[i]->join();
+                }
+            }
+
+        void exportKeys(const afl::data::StringList_t& keys, bool repeatable)
+            {
+                for (size_t pos = 0; pos < keys.size(); pos += BATCH_SIZE) {
+                    exportBatch(keys, pos, std::min(keys.size(), pos + BATCH_SIZE), repeatable);
+                }
+            }
+
+     private:
+        afl::io::TextWriter& m_out;
+        afl::container::PtrVector<Fetcher> m_fetchers;
+        afl::container::PtrVector<afl::sys::Thread> m_threads;
+
+        void exportBatch(const afl::data::StringList_t& keys, size_t first, size_t last, bool repeatable)
+            {
+                // Shard batch into contiguous slices, one per connection
+                const size_t n = m_fetchers.size();
+                for (size_t i = 0; i < n; ++i) {
+                    m_fetchers[i]->setSlice(keys, first + (last - first) * i / n, first + (last - first) * (i+1) / n, repeatable);
+                }
+                for (size_t i = 1; i < n; ++i) {
+                    m_fetchers[i]->start();
+                }
+                m_fetchers[0]->fetch();
+                for (size_t i = 1; i < n; ++i) {
+                    m_fetchers[i]->wait();
+                }
+
+                // Produce output in order
+                for (size_t i = 0; i < n; ++i) {
+                    m_fetchers[i]->write(m_out);
+                }
+            }
+    };
+
+    /** Export a database subtree.
+        \param exporter Exporter
+        \param dbConnection Database to work on (for obtaining key names)
+        \param match Wildcard to match keys to export
+        \param useScan true to use SCAN instead of KEYS.
+                       Output is produced per SCAN batch, in repeatable form, because SCAN may report a key twice. */
+    void exportSubtree(Exporter& exporter, afl::net::CommandHandler& dbConnection, String_t match, bool useScan)
+    {
+        afl::data::StringList_t keys;
+        if (useScan) {
+            String_t cursor = "0";
+            bool more;
+            do {
+                more = scanKeys(dbConnection, cursor, match, keys);
+                exporter.exportKeys(keys, true);
+            } while (more);
+        } else {
+            getKeys(dbConnection, match, keys);
+            exporter.exportKeys(keys, false);
         }
     }
 }
@@ -173,15 +375,35 @@ server::dbexport::exportDatabase(afl::io::TextWriter& out,
                                  afl::net::CommandHandler& dbConnection,
                                  afl::sys::CommandLineParser& commandLine,
                                  afl::string::Translator& tx)
+{
+    afl::net::CommandHandler*const p = &dbConnection;
+    exportDatabase(out, afl::base::Memory<afl::net::CommandHandler*const>::fromSingleObject(p), commandLine, tx);
+}
+
+// Export database, using multiple connections.
+void
+server::dbexport::exportDatabase(afl::io::TextWriter& out,
+                                 afl::base::Memory<afl::net::CommandHandler*const> dbConnections,
+                                 afl::sys::CommandLineParser& commandLine,
+                                 afl::string::Translator& tx)
 {
     // ex planetscentral/dbexport/exdb.cc:doDatabaseExport
+    afl::net::CommandHandler*const* pFirst = dbConnections.at(0);
+    if (pFirst == 0) {
+        throw std::runtime_error(tx("no database connection"));
+    }
+
     bool withDelete = false;
+    bool useScan = false;
+    Exporter exporter(out, dbConnections);
     String_t p;
     bool opt;
     while (commandLine.getNext(opt, p)) {
         if (opt) {
             if (p == "delete") {
                 withDelete = true;
+            } else if (p == "scan") {
+                useScan = true;
             } else {
                 throw std::runtime_error(tx("invalid option specified"));
             }
@@ -189,7 +411,7 @@ server::dbexport::exportDatabase(afl::io::TextWriter& out,
             if (withDelete) {
                 out.writeLine(Format("redis keys %s | silent noerror redis del", quoteConsoleString(p)));
             }
-            exportSubtree(out, dbConnection, p);
+            exportSubtree(exporter, **pFirst, p, useScan);
         }
     }
 }
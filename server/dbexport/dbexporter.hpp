@@ -5,6 +5,7 @@
 #ifndef C2NG_SERVER_DBEXPORT_DBEXPORTER_HPP
 #define C2NG_SERVER_DBEXPORT_DBEXPORTER_HPP
 
+#include "afl/base/memory.hpp"
 #include "afl/io/textwriter.hpp"
 #include "afl/net/commandhandler.hpp"
 #include "afl/string/translator.hpp"
@@ -13,6 +14,14 @@
 namespace server { namespace dbexport {
 
     /** Export database.
+
+        Options (from command line):
+        - "--delete": emit commands to delete the wildcards' keys before restoring them
+        - "--scan": obtain keys with SCAN instead of KEYS.
+          This does not block the database, and does not need to hold all key names in memory.
+          Output is not sorted globally, and lists are deleted before being re-created
+          (SCAN may report a key twice).
+
         \param out          Output receiver
         \param dbConnection Database connection
         \param commandLine  Command line, parsed for options and values to export.
@@ -22,6 +31,19 @@ namespace server { namespace dbexport {
                         afl::sys::CommandLineParser& commandLine,
                         afl::string::Translator& tx);
 
+    /** Export database, using multiple connections.
+        Keys are processed in batches; each batch is split among the connections, which fetch values in parallel.
+        The first connection is also used to obtain key names.
+        Output is the same as for a single connection.
+        \param out           Output receiver
+        \param dbConnections Database connections (at least one). Each one is used by a separate thread.
+        \param commandLine   Command line, parsed for options and values to export.
+        \param tx            Translator (for error messages/exceptions) */
+    void exportDatabase(afl::io::TextWriter& out,
+                        afl::base::Memory<afl::net::CommandHandler*const> dbConnections,
+                        afl::sys::CommandLineParser& commandLine,
+                        afl::string::Translator& tx);
+
 } }
 
 #endif
@@ -3,10 +3,12 @@
   *  \brief Class server::dbexport::ExportApplication
   */
 
+#include <vector>
 #include "server/dbexport/exportapplication.hpp"
 #include "afl/base/optional.hpp"
 #include "afl/net/resp/client.hpp"
 #include "afl/string/format.hpp"
+#include "afl/string/parse.hpp"
 #include "afl/sys/longcommandlineparser.hpp"
 #include "server/dbexport/dbexporter.hpp"
 #include "server/ports.hpp"
@@ -38,12 +40,18 @@ server::dbexport::ExportApplication::appMain()
     String_t p;
     bool opt;
     afl::base::Optional<String_t> command;
+    size_t numConnections = 1;
     while (commandLineParser.getNext(opt, p)) {
         if (opt) {
             if (p == "h" || p == "help") {
                 help();
             } else if (p == "log") {
                 consoleLogger().setConfiguration(commandLineParser.getRequiredParameter("log"), tx);
+            } else if (p == "connections") {
+                String_t param = commandLineParser.getRequiredParameter(p);
+                if (!afl::string::strToInteger(param, numConnections) || numConnections == 0) {
+                    errorExit(Format(tx("invalid number of connections, '%s'").c_str(), param));
+                }
             } else if (handleCommandLineOption(p, commandLineParser)) {
                 // ok
             } else {
@@ -67,7 +75,11 @@ server::dbexport::ExportApplication::appMain()
     // Do it [exception protection provided by caller, Application]
     afl::base::Deleter del;
     if (*pCommand == "db") {
-        exportDatabase(standardOutput(), createClient(del, m_dbAddress), commandLineParser, tx);
+        std::vector<afl::net::CommandHandler*> connections;
+        for (size_t i = 0; i < numConnections; ++i) {
+            connections.push_back(&createClient(del, m_dbAddress));
+        }
+        exportDatabase(standardOutput(), connections, commandLineParser, tx);
     } else {
         errorExit(Format(tx("unknown command: \"%s\"").c_str(), *pCommand));
     }
@@ -100,10 +112,13 @@ server::dbexport::ExportApplication::help()
                             "Options:\n"
                             "  --config=FILE       Set path to config file\n"
                             "  --log=CONFIG        Set logger configuration\n"
+                            "  --connections=N     Use N database connections\n"
                             "  -DKEY=VALUE         Override config file entry\n"
                             "\n"
                             "Commands:\n"
-                            "  db [--delete] WILDCARD...     export database keys\n"
+                            "  db [--delete] [--scan] WILDCARD...\n"
+                            "                      export database keys\n"
+                            "                      (--scan: use SCAN, avoids blocking the database)\n"
                             "\n"
                             "This utility creates c2console (*.con) scripts to restore\n"
                             "a particular situation / set of data in the same or another\n"
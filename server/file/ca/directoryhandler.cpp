@@ -335,3 +335,16 @@ server::file::ca::DirectoryHandler::removeDirectory(String_t name)
 {
     m_content->removeDirectoryEntry(name, IsDirectory);
 }
+
+bool
+server::file::ca::DirectoryHandler::getTotals(int32_t& numFiles, int32_t& totalKBytes)
+{
+    // Tree objects are immutable, so totals stored for our Id remain valid.
+    return m_content->store().getTreeTotals(m_content->getId(), numFiles, totalKBytes);
+}
+
+void
+server::file::ca::DirectoryHandler::setTotals(int32_t numFiles, int32_t totalKBytes)
+{
+    m_content->store().setTreeTotals(m_content->getId(), numFiles, totalKBytes);
+}
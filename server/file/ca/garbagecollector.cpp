@@ -15,6 +15,38 @@ using afl::sys::LogListener;
 
 namespace {
     const char*const LOG_NAME = "file.ca";
+
+    /* Number of first-byte directories */
+    const size_t NUM_PREFIXES = 256;
+
+    /* Collect stored disk usage totals of trees that are not being kept */
+    class UsageCollector : public server::file::DirectoryHandler::Callback {
+     public:
+        UsageCollector(const std::set<server::file::ca::ObjectId>& objectsToKeep, LogListener& log)
+            : m_objectsToKeep(objectsToKeep), m_log(log), m_filesToDelete()
+            { }
+        virtual void addItem(const server::file::DirectoryHandler::Info& info)
+            {
+                server::file::ca::ObjectId id = server::file::ca::ObjectId::fromHex(info.name);
+                if (info.type == server::file::DirectoryHandler::IsFile && id.toHex() == info.name) {
+                    if (m_objectsToKeep.find(id) == m_objectsToKeep.end()) {
+                        m_filesToDelete.push_back(info.name);
+                    }
+                } else {
+                    m_log.write(LogListener::Warn, LOG_NAME, Format("usage/%s: unrecognized file, ignoring", info.name));
+                }
+            }
+        void removeGarbageFiles(server::file::DirectoryHandler& hdl)
+            {
+                for (size_t i = 0, n = m_filesToDelete.size(); i < n; ++i) {
+                    hdl.removeFile(m_filesToDelete[i]);
+                }
+            }
+     private:
+        const std::set<server::file::ca::ObjectId>& m_objectsToKeep;
+        LogListener& m_log;
+        std::vector<String_t> m_filesToDelete;
+    };
 }
 
 server::file::ca::GarbageCollector::GarbageCollector(ObjectStore& objStore, afl::sys::LogListener& log)
@@ -111,7 +143,7 @@ server::file::ca::GarbageCollector::removeGarbageObjects()
         // Fail-safe! Must not remove anything in this case.
         // User should not have called this; try to give him a hint to not call us again.
         return false;
-    } else if (m_nextPrefixToCheck < 256) {
+    } else if (m_nextPrefixToCheck < NUM_PREFIXES) {
         // Check one prefix
         class Collector : public DirectoryHandler::Callback {
          public:
@@ -170,6 +202,21 @@ server::file::ca::GarbageCollector::removeGarbageObjects()
             }
         }
 
+        ++m_nextPrefixToCheck;
+        return true;
+    } else if (m_nextPrefixToCheck == NUM_PREFIXES) {
+        // Remove stored disk usage totals of trees that no longer exist
+        if (DirectoryHandler* hdl = m_objectStore.getUsageDirectory()) {
+            try {
+                UsageCollector c(m_objectsToKeep, m_log);
+                hdl->readContent(c);
+                c.removeGarbageFiles(*hdl);
+            }
+            catch (std::exception& e) {
+                m_log.write(LogListener::Warn, LOG_NAME, "usage: error cleaning up", e);
+            }
+        }
+
         ++m_nextPrefixToCheck;
         return true;
     } else {
@@ -73,6 +73,7 @@ namespace server { namespace file { namespace ca {
 
         /** Main sequence: remove garbage objects.
             If there are still objects to remove, pick some and remove them.
+            Stored disk usage totals (ObjectStore::setTreeTotals()) of trees that are removed are removed as well.
             @retval true  Made some progress
             @retval false No more objects to remove */
         bool removeGarbageObjects();
@@ -11,6 +11,8 @@
 #include "afl/io/internalfilemapping.hpp"
 #include "afl/string/format.hpp"
 #include "afl/string/hex.hpp"
+#include "afl/string/parse.hpp"
+#include "afl/string/string.hpp"
 #include "server/errors.hpp"
 #include "server/file/ca/commit.hpp"
 #include "server/file/ca/directoryentry.hpp"
@@ -31,6 +33,10 @@ namespace {
 
     const char KEYWORDS[][8] = { "blob ", "tree ", "commit " };
 
+    /* Name of directory containing tree totals (see ObjectStore::setTreeTotals).
+       This is not a valid first-byte directory name, and thus ignored by git. */
+    const char USAGE_DIRECTORY[] = "c2usage";
+
     int hexValue(char c)
     {
         if (c >= '0' && c <= '9') {
@@ -114,7 +120,8 @@ server::file::ca::ObjectStore::ObjectStore(DirectoryHandler& dir)
     : m_directory(dir),
       m_subdirectories(),
       m_refCounter(new InternalReferenceCounter()),
-      m_cache(new InternalObjectCache())
+      m_cache(new InternalObjectCache()),
+      m_usageDirectory()
 {
     readDirectory();
 }
@@ -262,6 +269,16 @@ server::file::ca::ObjectStore::unlinkObject(Type type, const ObjectId& id)
 
             // Remove from cache
             m_cache->removeObject(id);
+
+            // Remove stored totals
+            if (type == TreeObject && m_usageDirectory.get() != 0) {
+                try {
+                    m_usageDirectory->removeFile(id.toHex());
+                }
+                catch (std::exception&) {
+                    // No totals stored for this tree
+                }
+            }
         }
     }
 }
@@ -277,6 +294,49 @@ server::file::ca::ObjectStore::getObjectDirectory(size_t prefix)
     }
 }
 
+// Get directory containing stored disk usage totals.
+server::file::DirectoryHandler*
+server::file::ca::ObjectStore::getUsageDirectory()
+{
+    return m_usageDirectory.get();
+}
+
+// Get stored disk usage totals for a tree.
+bool
+server::file::ca::ObjectStore::getTreeTotals(const ObjectId& id, int32_t& numFiles, int32_t& totalKBytes)
+{
+    if (m_usageDirectory.get() == 0) {
+        return false;
+    }
+
+    afl::base::Ptr<afl::io::FileMapping> map;
+    try {
+        map = m_usageDirectory->getFileByName(id.toHex()).asPtr();
+    }
+    catch (std::exception&) {
+        // File open failed, assume no totals stored
+        return false;
+    }
+
+    // Format is "<numFiles> <totalKBytes>"
+    const String_t text = afl::string::strTrim(afl::string::fromBytes(map->get()));
+    const String_t::size_type n = text.find(' ');
+    return n != String_t::npos
+        && afl::string::strToInteger(text.substr(0, n), numFiles)
+        && afl::string::strToInteger(text.substr(n+1), totalKBytes);
+}
+
+// Store disk usage totals for a tree.
+void
+server::file::ca::ObjectStore::setTreeTotals(const ObjectId& id, int32_t numFiles, int32_t totalKBytes)
+{
+    if (m_usageDirectory.get() == 0) {
+        DirectoryHandler::Info info = m_directory.createDirectory(USAGE_DIRECTORY);
+        m_usageDirectory.reset(m_directory.getDirectory(info));
+    }
+    m_usageDirectory->createFile(id.toHex(), afl::string::toBytes(afl::string::Format("%d %d\n", numFiles, totalKBytes)));
+}
+
 /** Load an object, internal.
     \param id Object Id
     \param expectedType Expected type
@@ -401,6 +461,8 @@ server::file::ca::ObjectStore::readDirectory()
                     if (a >= 0 && b >= 0) {
                         m_parent.m_subdirectories.replaceElementNew(16*a+b, m_parent.m_directory.getDirectory(info));
                     }
+                } else if (info.name == USAGE_DIRECTORY && info.type == DirectoryHandler::IsDirectory) {
+                    m_parent.m_usageDirectory.reset(m_parent.m_directory.getDirectory(info));
                 }
             }
      private:
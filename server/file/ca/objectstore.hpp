@@ -112,6 +112,29 @@ namespace server { namespace file { namespace ca {
             \return DirectoryHandler if one exists, null if this directory does not exist (=has no objects) */
         DirectoryHandler* getObjectDirectory(size_t prefix);
 
+        /** Get directory containing stored disk usage totals.
+            Files in this directory are named after the tree they describe (see setTreeTotals()).
+            \return DirectoryHandler if one exists, null if this directory does not exist (=no totals stored) */
+        DirectoryHandler* getUsageDirectory();
+
+        /** Get stored disk usage totals for a tree.
+            \param [in]  id          Tree Id
+            \param [out] numFiles    Number of files and directories
+            \param [out] totalKBytes Disk usage in kilobytes
+            \return true if totals have been stored for this tree, false if not
+            \see server::file::DirectoryHandler::getTotals */
+        bool getTreeTotals(const ObjectId& id, int32_t& numFiles, int32_t& totalKBytes);
+
+        /** Store disk usage totals for a tree.
+            Because a tree's content cannot change, totals remain valid as long as the tree exists.
+            They are stored in a separate directory next to the first-byte directories,
+            and removed when the tree is removed by unlinkObject().
+            \param id          Tree Id
+            \param numFiles    Number of files and directories
+            \param totalKBytes Disk usage in kilobytes
+            \see server::file::DirectoryHandler::setTotals */
+        void setTreeTotals(const ObjectId& id, int32_t numFiles, int32_t totalKBytes);
+
      private:
         bool loadObject(const ObjectId& id, Type expectedType, size_t* pSize, afl::base::Ptr<afl::io::FileMapping>* pContent);
         void readDirectory();
@@ -128,6 +151,9 @@ namespace server { namespace file { namespace ca {
 
         // Cache
         std::auto_ptr<ObjectCache> m_cache;
+
+        // DirectoryHandler for stored tree totals. Null if none have been stored yet.
+        std::auto_ptr<DirectoryHandler> m_usageDirectory;
     };
 
 } } }
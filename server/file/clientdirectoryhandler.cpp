@@ -127,6 +127,17 @@ server::file::ClientDirectoryHandler::copyFile(ReadOnlyDirectoryHandler& source,
     }
 }
 
+bool
+server::file::ClientDirectoryHandler::getTotals(int32_t& /*numFiles*/, int32_t& /*totalKBytes*/)
+{
+    // The other side may be modified by others, so we cannot store totals.
+    return false;
+}
+
+void
+server::file::ClientDirectoryHandler::setTotals(int32_t /*numFiles*/, int32_t /*totalKBytes*/)
+{ }
+
 String_t
 server::file::ClientDirectoryHandler::makePath(String_t userPath)
 {
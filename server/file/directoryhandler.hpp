@@ -83,6 +83,35 @@ namespace server { namespace file {
             \param name Name of subdirectory to remove
             \throw std::runtime_error on errors (conditions and exception type depending on actual derived class) */
         virtual void removeDirectory(String_t name) = 0;
+
+
+        /*
+         *  Disk Usage
+         */
+
+        /** Get stored disk usage totals of this directory.
+            This is an optional function.
+
+            A storage that can identify a directory's content (e.g. content-addressable storage)
+            can remember totals stored with setTotals(),
+            so that they need not be recomputed by reading the whole directory tree.
+
+            It is therefore safe to always return false.
+
+            \param [out] numFiles    Number of files and directories in this tree, including this directory
+            \param [out] totalKBytes Disk usage of this tree in kilobytes (see DirectoryItem::computeTotals())
+            \retval true totals are known; output parameters have been set
+            \retval false totals are not known */
+        virtual bool getTotals(int32_t& numFiles, int32_t& totalKBytes) = 0;
+
+        /** Store disk usage totals of this directory.
+            This is an optional function; see getTotals().
+            Totals refer to the current content of the directory;
+            a DirectoryHandler that cannot tell whether they are still valid later should ignore this call.
+            \param numFiles    Number of files and directories in this tree, including this directory
+            \param totalKBytes Disk usage of this tree in kilobytes
+            \throw std::runtime_error on errors (conditions and exception type depending on actual derived class) */
+        virtual void setTotals(int32_t numFiles, int32_t totalKBytes) = 0;
     };
 
 } }
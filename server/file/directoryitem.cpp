@@ -29,6 +29,9 @@ server::file::DirectoryItem::DirectoryItem(String_t name, DirectoryItem* parent,
       m_files(),
       m_hasUnknownContent(false),
       m_wasRead(false),
+      m_hasTotals(false),
+      m_totalFiles(0),
+      m_totalKBytes(0),
       m_owner(),
       m_controlInfo(),
       m_gameStatus()
@@ -123,6 +126,9 @@ server::file::DirectoryItem::forgetContent(Root& root)
         m_owner.clear();
         m_controlInfo.clear();
         m_gameStatus.reset();
+
+        // Underlying storage may have changed
+        invalidateTotals();
     }
 }
 
@@ -232,8 +238,10 @@ server::file::DirectoryItem::createFile(const String_t& fileName, afl::base::Con
 
     // Update content
     if (FileItem* it = findFile(fileName)) {
+        adjustTotals(0, getFileKBytes(info) - getFileKBytes(it->getInfo()));
         it->setInfo(info);
     } else {
+        adjustTotals(1, getFileKBytes(info));
         m_files.pushBackNew(new FileItem(info));
     }
 }
@@ -252,8 +260,10 @@ server::file::DirectoryItem::copyFile(DirectoryItem& sourceDirectory, FileItem&
         // Copy succeeded; update status
         m_gameStatus.reset();
         if (FileItem* it = findFile(fileName)) {
+            adjustTotals(0, getFileKBytes(*p) - getFileKBytes(it->getInfo()));
             it->setInfo(*p);
         } else {
+            adjustTotals(1, getFileKBytes(*p));
             m_files.pushBackNew(new FileItem(*p));
         }
         return true;
@@ -275,7 +285,14 @@ server::file::DirectoryItem::createDirectory(const String_t& dirName)
 
     // Create
     DirectoryHandler::Info info = m_handler->createDirectory(dirName);
-    return m_subdirectories.pushBackNew(new DirectoryItem(dirName, this, std::auto_ptr<DirectoryHandler>(m_handler->getDirectory(info))));
+    DirectoryItem* result = m_subdirectories.pushBackNew(new DirectoryItem(dirName, this, std::auto_ptr<DirectoryHandler>(m_handler->getDirectory(info))));
+
+    // A new directory counts as one file and one kilobyte, see computeTotals()
+    adjustTotals(1, 1);
+    result->m_hasTotals = true;
+    result->m_totalFiles = 1;
+    result->m_totalKBytes = 1;
+    return result;
 }
 
 // Remove an item.
@@ -283,18 +300,31 @@ void
 server::file::DirectoryItem::removeItem(Root& root, Item* it)
 {
     // ex UserDirectory::removeEntry
-    // FIXME: This is a very simple implementation.
-    // A more clever implementation would remove \c it from \c m_subdirectories or \c m_files
-    // instead of forgetting the whole directory.
-
     // This readContent() should not be necessary because /it/ can only be valid if readContent() has already been called, but it does not hurt.
     readContent(root);
 
-    if (dynamic_cast<FileItem*>(it) != 0) {
+    if (FileItem* fi = dynamic_cast<FileItem*>(it)) {
         // It's a file.
+        size_t index = 0;
+        while (index < m_files.size() && m_files[index] != fi) {
+            ++index;
+        }
+        if (index >= m_files.size()) {
+            throw std::runtime_error(PERMISSION_DENIED);
+        }
         m_handler->removeFile(it->getName());
+        adjustTotals(-1, -getFileKBytes(fi->getInfo()));
+        m_files.erase(m_files.begin() + index);
     } else if (DirectoryItem* ud = dynamic_cast<DirectoryItem*>(it)) {
         // It's a directory.
+        size_t index = 0;
+        while (index < m_subdirectories.size() && m_subdirectories[index] != ud) {
+            ++index;
+        }
+        if (index >= m_subdirectories.size()) {
+            throw std::runtime_error(PERMISSION_DENIED);
+        }
+
         // Check whether it contains anything.
         ud->readContent(root);
         if (ud->getNumDirectories() != 0 || ud->getNumFiles() != 0) {
@@ -306,17 +336,17 @@ server::file::DirectoryItem::removeItem(Root& root, Item* it)
         // Remove content (metadata file). Throws if this is not possible.
         ud->removeSystemContent(root);
 
-        // Remove the subdirectory itself.
+        // Remove the subdirectory itself. An empty directory counts as one file and one kilobyte.
         m_handler->removeDirectory(it->getName());
+        adjustTotals(-1, -1);
+        m_subdirectories.erase(m_subdirectories.begin() + index);
     } else {
         // What is it?
         throw std::runtime_error(PERMISSION_DENIED);
     }
 
-    // When we're here, the item has been successfully removed.
-    // For simplicity, forget cached information.
-    // This will invalidate /it/.
-    forgetContent(root);
+    // When we're here, the item has been successfully removed, and /it/ is invalid.
+    m_gameStatus.reset();
 }
 
 void
@@ -324,6 +354,14 @@ server::file::DirectoryItem::removeUserContent(Root& root)
 {
     // ex UserDirectory::removeAllEntries
     readContent(root);
+
+    // Determine current usage, to update cached totals afterwards.
+    // This is only needed if this directory or a parent has cached totals.
+    const bool updateTotals = hasCachedTotals();
+    int32_t numFiles = 0, totalKBytes = 0;
+    if (updateTotals) {
+        countTotals(root, numFiles, totalKBytes);
+    }
     try {
         for (size_t i = 0, n = m_files.size(); i < n; ++i) {
             m_handler->removeFile(m_files[i]->getName());
@@ -343,7 +381,14 @@ server::file::DirectoryItem::removeUserContent(Root& root)
         forgetContent(root);
         throw;
     }
-    forgetContent(root);
+
+    // Success: only this (now empty) directory remains, counting as one file and one kilobyte.
+    m_subdirectories.clear();
+    m_files.clear();
+    m_gameStatus.reset();
+    if (updateTotals) {
+        adjustTotals(1 - numFiles, 1 - totalKBytes);
+    }
 }
 
 // Get directory property.
@@ -455,21 +500,36 @@ void
 server::file::DirectoryItem::computeTotals(Root& root, int32_t& numFiles, int32_t& totalKBytes)
 {
     // ex UserDirectory::computeTotals
-    // Count ourselves
-    ++numFiles;
-    ++totalKBytes;
+    if (!m_hasTotals) {
+        if (!m_handler->getTotals(m_totalFiles, m_totalKBytes)) {
+            // Count ourselves
+            int32_t myFiles = 1;
+            int32_t myKBytes = 1;
+
+            // Count content
+            readContent(root);
+            for (size_t i = 0, n = m_subdirectories.size(); i < n; ++i) {
+                m_subdirectories[i]->computeTotals(root, myFiles, myKBytes);
+            }
+            for (size_t i = 0, n = m_files.size(); i < n; ++i) {
+                ++myFiles;
+                myKBytes += getFileKBytes(m_files[i]->getInfo());
+            }
 
-    // Count content
-    readContent(root);
-    for (size_t i = 0, n = m_subdirectories.size(); i < n; ++i) {
-        m_subdirectories[i]->computeTotals(root, numFiles, totalKBytes);
-    }
-    for (size_t i = 0, n = m_files.size(); i < n; ++i) {
-        ++numFiles;
-        if (const int32_t* pSize = m_files[i]->getInfo().size.get()) {
-            totalKBytes += (*pSize + 1023) / 1024;
+            // Remember in underlying storage. Failure to do so is not fatal.
+            try {
+                m_handler->setTotals(myFiles, myKBytes);
+            }
+            catch (std::exception& e) {
+                root.log().write(afl::sys::LogListener::Warn, LOG_NAME, m_handler->getName(), e);
+            }
+            m_totalFiles = myFiles;
+            m_totalKBytes = myKBytes;
         }
+        m_hasTotals = true;
     }
+    numFiles += m_totalFiles;
+    totalKBytes += m_totalKBytes;
 }
 
 /** Load control file. */
@@ -557,6 +617,71 @@ server::file::DirectoryItem::removeSystemContent(Root& root)
     }
 }
 
+/** Adjust cached disk usage after a modification.
+    Applies the change to this directory and all parents that have cached totals.
+    Parents must be updated even if this directory has no cached totals,
+    because they may have computed theirs before this DirectoryItem was (re-)created.
+    \param numFiles Change to number of files
+    \param kBytes   Change to disk usage */
+void
+server::file::DirectoryItem::adjustTotals(int32_t numFiles, int32_t kBytes)
+{
+    for (DirectoryItem* p = this; p != 0; p = p->m_parent) {
+        if (p->m_hasTotals) {
+            p->m_totalFiles += numFiles;
+            p->m_totalKBytes += kBytes;
+        }
+    }
+}
+
+/** Invalidate cached disk usage of this directory and all parents. */
+void
+server::file::DirectoryItem::invalidateTotals()
+{
+    for (DirectoryItem* p = this; p != 0; p = p->m_parent) {
+        p->m_hasTotals = false;
+    }
+}
+
+/** Check whether this directory or a parent has cached disk usage. */
+bool
+server::file::DirectoryItem::hasCachedTotals() const
+{
+    for (const DirectoryItem* p = this; p != 0; p = p->m_parent) {
+        if (p->m_hasTotals) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Count disk usage of this directory.
+    Like computeTotals(), but does not cache or store the result.
+    Use for content that is about to be removed. */
+void
+server::file::DirectoryItem::countTotals(Root& root, int32_t& numFiles, int32_t& totalKBytes)
+{
+    int32_t myFiles, myKBytes;
+    if (m_hasTotals) {
+        numFiles += m_totalFiles;
+        totalKBytes += m_totalKBytes;
+    } else if (m_handler->getTotals(myFiles, myKBytes)) {
+        numFiles += myFiles;
+        totalKBytes += myKBytes;
+    } else {
+        ++numFiles;
+        ++totalKBytes;
+        readContent(root);
+        for (size_t i = 0, n = m_subdirectories.size(); i < n; ++i) {
+            m_subdirectories[i]->countTotals(root, numFiles, totalKBytes);
+        }
+        for (size_t i = 0, n = m_files.size(); i < n; ++i) {
+            ++numFiles;
+            totalKBytes += getFileKBytes(m_files[i]->getInfo());
+        }
+    }
+}
+
 /** Convert string into Permissions_t.
     Invalid permissions will be removed. */
 server::file::DirectoryItem::Permissions_t
@@ -597,3 +722,14 @@ server::file::DirectoryItem::getStringFromPermissions(Permissions_t p)
     }
     return result;
 }
+
+/** Get disk usage of a file, in kilobytes. */
+int32_t
+server::file::DirectoryItem::getFileKBytes(const DirectoryHandler::Info& info)
+{
+    if (const int32_t* pSize = info.size.get()) {
+        return (*pSize + 1023) / 1024;
+    } else {
+        return 0;
+    }
+}
@@ -227,6 +227,11 @@ namespace server { namespace file {
 
         /** Compute disk usage totals.
             The used resources are added to the parameters, recursively.
+
+            Totals are computed once (or taken from the DirectoryHandler, see DirectoryHandler::getTotals()),
+            and then cached and updated by all modifications made through this DirectoryItem,
+            so repeated calls do not need to visit the directory tree again.
+
             \param [in]  root        Server root
             \param [out] numFiles    Number of files and directories
             \param [out] totalKBytes Disk usage of files, rounding up to full kilobytes for each file */
@@ -246,6 +251,11 @@ namespace server { namespace file {
         // Status
         bool m_wasRead;
 
+        // Cached disk usage (computeTotals()); valid if m_hasTotals
+        bool m_hasTotals;
+        int32_t m_totalFiles;
+        int32_t m_totalKBytes;
+
         String_t m_owner;
         ControlInfo_t m_controlInfo;
 
@@ -258,9 +268,15 @@ namespace server { namespace file {
 
         void removeSystemContent(Root& root);
 
+        void adjustTotals(int32_t numFiles, int32_t kBytes);
+        void invalidateTotals();
+        bool hasCachedTotals() const;
+        void countTotals(Root& root, int32_t& numFiles, int32_t& totalKBytes);
+
         // Utilities
         static Permissions_t getPermissionsFromString(const String_t& str);
         static String_t getStringFromPermissions(Permissions_t p);
+        static int32_t getFileKBytes(const DirectoryHandler::Info& info);
     };
 
 } }
@@ -124,3 +124,14 @@ server::file::FileSystemHandler::removeDirectory(String_t name)
 {
     m_fileSystem.openDirectory(m_name)->erase(name);
 }
+
+bool
+server::file::FileSystemHandler::getTotals(int32_t& /*numFiles*/, int32_t& /*totalKBytes*/)
+{
+    // We cannot tell whether the directory was modified since totals were stored.
+    return false;
+}
+
+void
+server::file::FileSystemHandler::setTotals(int32_t /*numFiles*/, int32_t /*totalKBytes*/)
+{ }
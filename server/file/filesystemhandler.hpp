@@ -26,6 +26,8 @@ namespace server { namespace file {
         virtual DirectoryHandler* getDirectory(const Info& info);
         virtual Info createDirectory(String_t name);
         virtual void removeDirectory(String_t name);
+        virtual bool getTotals(int32_t& numFiles, int32_t& totalKBytes);
+        virtual void setTotals(int32_t numFiles, int32_t totalKBytes);
 
      private:
         afl::io::FileSystem& m_fileSystem;
@@ -129,6 +129,17 @@ server::file::InternalDirectoryHandler::copyFile(ReadOnlyDirectoryHandler& /*sou
     return afl::base::Nothing;
 }
 
+bool
+server::file::InternalDirectoryHandler::getTotals(int32_t& /*numFiles*/, int32_t& /*totalKBytes*/)
+{
+    // Content is in memory anyway; no point in storing totals.
+    return false;
+}
+
+void
+server::file::InternalDirectoryHandler::setTotals(int32_t /*numFiles*/, int32_t /*totalKBytes*/)
+{ }
+
 server::file::InternalDirectoryHandler::File*
 server::file::InternalDirectoryHandler::findFile(const String_t& name)
 {
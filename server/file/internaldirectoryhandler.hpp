@@ -59,6 +59,8 @@ namespace server { namespace file {
         virtual Info createDirectory(String_t name);
         virtual void removeDirectory(String_t name);
         virtual afl::base::Optional<Info> copyFile(ReadOnlyDirectoryHandler& source, const Info& sourceInfo, String_t name);
+        virtual bool getTotals(int32_t& numFiles, int32_t& totalKBytes);
+        virtual void setTotals(int32_t numFiles, int32_t totalKBytes);
 
         /** Find file, given a name.
             \param name Name to find
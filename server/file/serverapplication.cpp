@@ -46,6 +46,8 @@ namespace {
         virtual DirectoryHandler* getDirectory(const Info& info);
         virtual Info createDirectory(String_t name);
         virtual void removeDirectory(String_t name);
+        virtual bool getTotals(int32_t& numFiles, int32_t& totalKBytes);
+        virtual void setTotals(int32_t numFiles, int32_t totalKBytes);
      private:
         server::file::DirectoryHandler& m_impl;
     };
@@ -111,6 +113,18 @@ ProxyDirectoryHandler::removeDirectory(String_t name)
     m_impl.removeDirectory(name);
 }
 
+bool
+ProxyDirectoryHandler::getTotals(int32_t& numFiles, int32_t& totalKBytes)
+{
+    return m_impl.getTotals(numFiles, totalKBytes);
+}
+
+void
+ProxyDirectoryHandler::setTotals(int32_t numFiles, int32_t totalKBytes)
+{
+    m_impl.setTotals(numFiles, totalKBytes);
+}
+
 /************************* ServerApplication *************************/
 
 server::file::ServerApplication::ServerApplication(afl::sys::Environment& env, afl::io::FileSystem& fs, afl::net::NetworkStack& net, afl::async::Interrupt& intr)
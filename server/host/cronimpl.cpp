@@ -676,4 +676,7 @@ server::host::computeGameTimes(const int32_t now, Root& root, const int32_t game
             computeGameHostTimes(now, root, gameId, sch);
         }
     }
+
+    // This may have updated nextHostTime, which is part of the cached game description.
+    root.arbiter().markModified(gameId);
 }
@@ -959,11 +959,6 @@ server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser,
         }
     }
 
-    // Play status
-    if (!forUser.empty()) {
-        result.userPlays = userReferenceCounters().intField(forUser).get() > 0;
-    }
-
     // Scores
     if (verbose && (state == HostGame::Running || state == HostGame::Finished)) {
         String_t scoredesc = m_game.hashKey("scores").stringField("score").get();
@@ -1029,8 +1024,23 @@ server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser,
         result.forumId = forumId().get();
     }
 
+    // Play status, ranks
+    describeUserStatus(result, forUser, otherUser);
+
+    return result;
+}
+
+// Describe user-dependant status.
+void
+server::host::Game::describeUserStatus(server::interface::HostGame::Info& result, String_t forUser, String_t otherUser)
+{
+    // Play status
+    if (!forUser.empty()) {
+        result.userPlays = userReferenceCounters().intField(forUser).get() > 0;
+    }
+
     // Ranks
-    if (state == HostGame::Finished && (!forUser.empty() || !otherUser.empty())) {
+    if (result.state == HostGame::Finished && (!forUser.empty() || !otherUser.empty())) {
         for (int i = 1; i <= NUM_PLAYERS; ++i) {
             Slot s = getSlot(i);
             if (s.slotStatus().get() != 0) {
@@ -1046,8 +1056,6 @@ server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser,
             }
         }
     }
-
-    return result;
 }
 
 // Describe a slot.
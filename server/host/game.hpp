@@ -447,6 +447,15 @@ namespace server { namespace host {
             \return description */
         server::interface::HostGame::Info describe(bool verbose, String_t forUser, String_t otherUser, Root& root);
 
+        /** Describe user-dependant status.
+            Fills in the non-verbose user-dependant values (play status, ranks) of a game description.
+            describe() includes this information; this function is used to complete a cached description
+            that has been produced with empty user names.
+            \param result    [in/out] Description, produced by describe(); state must be set
+            \param forUser   user who is requesting this information
+            \param otherUser user whose game list we are requesting */
+        void describeUserStatus(server::interface::HostGame::Info& result, String_t forUser, String_t otherUser);
+
         /** Describe a slot.
             This function creates a user-dependant view (joinability),
             but otherwise assumes the user has read access.
@@ -9,7 +9,9 @@
 
 // Constructor.
 server::host::GameArbiter::GameArbiter()
-    : m_lockedGames()
+    : m_lockedGames(),
+      m_modificationCounters(),
+      m_globalModificationCounter(0)
 { }
 
 // Destructor.
@@ -59,10 +61,34 @@ server::host::GameArbiter::unlock(int32_t gameId, Intent i)
      case Critical:
      case Host:
         m_lockedGames.erase(gameId);
+        markModified(gameId);
         break;
     }
 }
 
+// Report modification of a game.
+void
+server::host::GameArbiter::markModified(int32_t gameId)
+{
+    ++m_modificationCounters[gameId];
+}
+
+// Report modification of all games.
+void
+server::host::GameArbiter::markAllModified()
+{
+    ++m_globalModificationCounter;
+}
+
+// Get modification counter of a game.
+uint32_t
+server::host::GameArbiter::getModificationCounter(int32_t gameId) const
+{
+    // Both counters only increase, so their sum changes whenever either changes.
+    std::map<int32_t, uint32_t>::const_iterator it = m_modificationCounters.find(gameId);
+    return m_globalModificationCounter + (it != m_modificationCounters.end() ? it->second : 0);
+}
+
 // Constructor.
 server::host::GameArbiter::Guard::Guard(GameArbiter& a, int32_t gameId, Intent i)
     : m_arbiter(a),
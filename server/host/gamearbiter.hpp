@@ -5,6 +5,7 @@
 #ifndef C2NG_SERVER_HOST_GAMEARBITER_HPP
 #define C2NG_SERVER_HOST_GAMEARBITER_HPP
 
+#include <map>
 #include <set>
 #include "afl/base/uncopyable.hpp"
 #include "afl/base/types.hpp"
@@ -22,7 +23,11 @@ namespace server { namespace host {
         During host run, some commands are accepted (such as fetching data),
         others are rejected (such as uploading a turn file).
 
-        GameArbiter manages the list of currently locked games. */
+        GameArbiter manages the list of currently locked games.
+
+        In addition, it counts modifications to games, to allow caching information about games.
+        Releasing a Critical or Host lock counts as a modification;
+        modifications outside such a lock need to be reported using markModified(). */
     class GameArbiter {
      public:
         enum Intent {
@@ -63,8 +68,24 @@ namespace server { namespace host {
             \param i Intent (same as for lock()) */
         void unlock(int32_t gameId, Intent i);
 
+        /** Report modification of a game.
+            \param gameId Game Id */
+        void markModified(int32_t gameId);
+
+        /** Report modification of all games.
+            Use for changes to global data that affects games, such as tool definitions. */
+        void markAllModified();
+
+        /** Get modification counter of a game.
+            The counter increases whenever the game is modified.
+            \param gameId Game Id
+            \return counter */
+        uint32_t getModificationCounter(int32_t gameId) const;
+
      private:
         std::set<int32_t> m_lockedGames;
+        std::map<int32_t, uint32_t> m_modificationCounters;
+        uint32_t m_globalModificationCounter;
     };
 
 
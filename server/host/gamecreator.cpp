@@ -11,6 +11,7 @@
 #include "afl/net/redis/subtree.hpp"
 #include "afl/string/format.hpp"
 #include "server/host/game.hpp"
+#include "server/host/gameindex.hpp"
 #include "server/host/root.hpp"
 #include "server/host/schedule.hpp"
 #include "server/interface/baseclient.hpp"
@@ -141,6 +142,9 @@ server::host::GameCreator::initializeGame(int32_t gameId)
         h.intField("slot").set(1);  // Slot is open
         h.intField("turn").set(0);  // Turn is missing
     }
+
+    // Index
+    GameIndex(m_root).update(gameId);
 }
 
 // Copy a game.
@@ -203,6 +207,9 @@ server::host::GameCreator::copyGame(int32_t srcId, int32_t dstId)
     // Copy tools
     copyTools(src, dst, m_root.toolRoot());
 
+    // Index
+    GameIndex(m_root).update(dstId);
+
     // Do not copy state. This is set by finishNewGame.
     // Do not copy type. This is set by finishNewGame.
     // Do not copy owner.
@@ -0,0 +1,159 @@
+/**
+  *  \file server/host/gameindex.cpp
+  *  \brief Class server::host::GameIndex
+  */
+
+#include <algorithm>
+#include "server/host/gameindex.hpp"
+#include "afl/base/countof.hpp"
+#include "afl/data/integerlist.hpp"
+#include "afl/data/stringlist.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/integerkey.hpp"
+#include "afl/net/redis/stringfield.hpp"
+#include "afl/net/redis/stringsetkey.hpp"
+#include "afl/net/redis/subtree.hpp"
+#include "server/host/root.hpp"
+
+namespace {
+    /* Index format version. Increase when the format changes, to force a rebuild. */
+    const int32_t INDEX_VERSION = 1;
+
+    /* Indexed settings */
+    const char*const INDEXED_SETTINGS[] = { "host", "shiplist", "master", "copyOf" };
+}
+
+// Constructor.
+server::host::GameIndex::GameIndex(Root& root)
+    : m_root(root)
+{ }
+
+// Check whether index is valid.
+bool
+server::host::GameIndex::isValid()
+{
+    return m_root.gameRoot().subtree("index").intKey("version").get() == INDEX_VERSION;
+}
+
+// Make sure index is valid.
+void
+server::host::GameIndex::ensureValid()
+{
+    if (!isValid()) {
+        rebuild();
+    }
+}
+
+// Rebuild the complete index.
+void
+server::host::GameIndex::rebuild()
+{
+    // Drop previous content.
+    // Sets are found through the per-game records; this also catches stale entries of a previous partial build.
+    afl::data::IntegerList_t games;
+    m_root.gameRoot().intSetKey("all").getAll(games);
+    for (size_t i = 0; i < games.size(); ++i) {
+        afl::net::redis::Subtree game(m_root.gameRoot().subtree(games[i]));
+        for (size_t j = 0; j < countof(INDEXED_SETTINGS); ++j) {
+            String_t value = game.hashKey("indexed").stringField(INDEXED_SETTINGS[j]).get();
+            if (!value.empty()) {
+                bySetting(INDEXED_SETTINGS[j], value).remove();
+            }
+        }
+        afl::data::StringList_t tools;
+        game.stringSetKey("indexedTools").getAll(tools);
+        for (size_t j = 0; j < tools.size(); ++j) {
+            byTool(tools[j]).remove();
+        }
+        game.hashKey("indexed").remove();
+        game.stringSetKey("indexedTools").remove();
+    }
+
+    // Build new content
+    for (size_t i = 0; i < games.size(); ++i) {
+        updateGame(games[i]);
+    }
+    m_root.gameRoot().subtree("index").intKey("version").set(INDEX_VERSION);
+}
+
+// Update a game's index entries.
+void
+server::host::GameIndex::update(int32_t gameId)
+{
+    if (isValid()) {
+        updateGame(gameId);
+    }
+}
+
+// Check whether a setting is indexed.
+bool
+server::host::GameIndex::isIndexedSetting(const String_t& name)
+{
+    for (size_t i = 0; i < countof(INDEXED_SETTINGS); ++i) {
+        if (name == INDEXED_SETTINGS[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Access games by setting.
+afl::net::redis::IntegerSetKey
+server::host::GameIndex::bySetting(const String_t& name, const String_t& value)
+{
+    return m_root.gameRoot().subtree("index").subtree(name).intSetKey(value);
+}
+
+// Access games by tool.
+afl::net::redis::IntegerSetKey
+server::host::GameIndex::byTool(const String_t& toolId)
+{
+    return m_root.gameRoot().subtree("index").subtree("tool").intSetKey(toolId);
+}
+
+/** Update a game's index entries (unconditionally).
+    Compares the game's current settings and tools to the values it is indexed under, and moves it between sets as needed.
+    \param gameId Game Id */
+void
+server::host::GameIndex::updateGame(int32_t gameId)
+{
+    afl::net::redis::Subtree game(m_root.gameRoot().subtree(gameId));
+    afl::net::redis::HashKey indexed(game.hashKey("indexed"));
+
+    // Settings
+    for (size_t i = 0; i < countof(INDEXED_SETTINGS); ++i) {
+        const char*const name = INDEXED_SETTINGS[i];
+        const String_t oldValue = indexed.stringField(name).get();
+        const String_t newValue = game.hashKey("settings").stringField(name).get();
+        if (oldValue != newValue) {
+            if (!oldValue.empty()) {
+                bySetting(name, oldValue).remove(gameId);
+            }
+            if (!newValue.empty()) {
+                bySetting(name, newValue).add(gameId);
+                indexed.stringField(name).set(newValue);
+            } else {
+                indexed.field(name).remove();
+            }
+        }
+    }
+
+    // Tools
+    afl::data::StringList_t oldTools, newTools;
+    game.stringSetKey("indexedTools").getAll(oldTools);
+    game.stringSetKey("tools").getAll(newTools);
+    std::sort(oldTools.begin(), oldTools.end());
+    std::sort(newTools.begin(), newTools.end());
+    for (size_t i = 0; i < oldTools.size(); ++i) {
+        if (!std::binary_search(newTools.begin(), newTools.end(), oldTools[i])) {
+            byTool(oldTools[i]).remove(gameId);
+            game.stringSetKey("indexedTools").remove(oldTools[i]);
+        }
+    }
+    for (size_t i = 0; i < newTools.size(); ++i) {
+        if (!std::binary_search(oldTools.begin(), oldTools.end(), newTools[i])) {
+            byTool(newTools[i]).add(gameId);
+            game.stringSetKey("indexedTools").add(newTools[i]);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/**
+  *  \file server/host/gameindex.hpp
+  *  \brief Class server::host::GameIndex
+  */
+#ifndef C2NG_SERVER_HOST_GAMEINDEX_HPP
+#define C2NG_SERVER_HOST_GAMEINDEX_HPP
+
+#include "afl/base/types.hpp"
+#include "afl/net/redis/integersetkey.hpp"
+#include "afl/string/string.hpp"
+
+namespace server { namespace host {
+
+    class Root;
+
+    /** Secondary indexes for game lists.
+
+        Game lists can be filtered by host, ship list, master, copy source, and tool.
+        To avoid checking every game individually, GameIndex maintains one set of game Ids per value
+        (e.g. "all games using host X").
+
+        Database layout:
+        - game:index:version (int): set if index has been built
+        - game:index:<setting>:<value> (intset): games having the given setting
+          (<setting> is "host", "shiplist", "master", "copyOf")
+        - game:index:tool:<tool> (intset): games using the given tool
+        - game:<gid>:indexed (hash): values this game is currently indexed under
+        - game:<gid>:indexedTools (stringset): tools this game is currently indexed under
+
+        The index is built on first use (see ensureValid()).
+        After a game's settings or tools change, call update() to adjust its index entries.
+        If the database is modified externally, removing game:index:version causes the index to be rebuilt. */
+    class GameIndex {
+     public:
+        /** Constructor.
+            \param root Service root */
+        explicit GameIndex(Root& root);
+
+        /** Check whether index is valid.
+            \return true if index has been built */
+        bool isValid();
+
+        /** Make sure index is valid.
+            If the index has not been built yet, builds it. */
+        void ensureValid();
+
+        /** Rebuild the complete index. */
+        void rebuild();
+
+        /** Update a game's index entries.
+            Call after changing a game's indexed settings or tools.
+            Does nothing if the index has not been built yet.
+            \param gameId Game Id */
+        void update(int32_t gameId);
+
+        /** Check whether a setting is indexed.
+            \param name Setting name (game:<gid>:settings key)
+            \return true if games can be looked up using bySetting() */
+        static bool isIndexedSetting(const String_t& name);
+
+        /** Access games by setting.
+            \param name  Setting name; must satisfy isIndexedSetting()
+            \param value Value
+            \return set of games */
+        afl::net::redis::IntegerSetKey bySetting(const String_t& name, const String_t& value);
+
+        /** Access games by tool.
+            \param toolId Tool Id
+            \return set of games */
+        afl::net::redis::IntegerSetKey byTool(const String_t& toolId);
+
+     private:
+        Root& m_root;
+
+        void updateGame(int32_t gameId);
+    };
+
+} }
+
+#endif
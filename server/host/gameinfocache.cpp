@@ -0,0 +1,43 @@
+/**
+  *  \file server/host/gameinfocache.cpp
+  *  \brief Class server::host::GameInfoCache
+  */
+
+#include "server/host/gameinfocache.hpp"
+
+// Constructor.
+server::host::GameInfoCache::GameInfoCache()
+    : m_entries()
+{ }
+
+// Destructor.
+server::host::GameInfoCache::~GameInfoCache()
+{ }
+
+// Look up a game.
+const server::host::GameInfoCache::Info_t*
+server::host::GameInfoCache::get(int32_t gameId, uint32_t counter) const
+{
+    std::map<int32_t, Entry>::const_iterator it = m_entries.find(gameId);
+    if (it != m_entries.end() && it->second.counter == counter) {
+        return &it->second.info;
+    } else {
+        return 0;
+    }
+}
+
+// Store a game description.
+void
+server::host::GameInfoCache::put(int32_t gameId, uint32_t counter, const Info_t& info)
+{
+    Entry& e = m_entries[gameId];
+    e.counter = counter;
+    e.info = info;
+}
+
+// Discard all entries.
+void
+server::host::GameInfoCache::clear()
+{
+    m_entries.clear();
+}
@@ -0,0 +1,55 @@
+/**
+  *  \file server/host/gameinfocache.hpp
+  *  \brief Class server::host::GameInfoCache
+  */
+#ifndef C2NG_SERVER_HOST_GAMEINFOCACHE_HPP
+#define C2NG_SERVER_HOST_GAMEINFOCACHE_HPP
+
+#include <map>
+#include "afl/base/types.hpp"
+#include "server/interface/hostgame.hpp"
+
+namespace server { namespace host {
+
+    /** Cache for game descriptions.
+        Stores the result of non-verbose, user-independent Game::describe() calls,
+        so that game lists do not need to re-read all game properties from the database each time.
+
+        Each entry is tagged with the game's modification counter (GameArbiter::getModificationCounter()) at the time it was produced;
+        an entry is only returned if the counter is still the same. */
+    class GameInfoCache {
+     public:
+        typedef server::interface::HostGame::Info Info_t;
+
+        /** Constructor. Makes an empty cache. */
+        GameInfoCache();
+
+        /** Destructor. */
+        ~GameInfoCache();
+
+        /** Look up a game.
+            \param gameId  Game Id
+            \param counter Current modification counter
+            \return cached description; null if none or out-of-date */
+        const Info_t* get(int32_t gameId, uint32_t counter) const;
+
+        /** Store a game description.
+            \param gameId  Game Id
+            \param counter Modification counter at the time the description was produced
+            \param info    Description */
+        void put(int32_t gameId, uint32_t counter, const Info_t& info);
+
+        /** Discard all entries. */
+        void clear();
+
+     private:
+        struct Entry {
+            uint32_t counter;
+            Info_t info;
+        };
+        std::map<int32_t, Entry> m_entries;
+    };
+
+} }
+
+#endif
@@ -3,6 +3,8 @@
   *  \brief Class server::host::HostGame
   */
 
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
 #include "server/host/hostgame.hpp"
 #include "afl/net/redis/hashkey.hpp"
@@ -16,6 +18,7 @@
 #include "server/host/exec.hpp"
 #include "server/host/game.hpp"
 #include "server/host/gamecreator.hpp"
+#include "server/host/gameindex.hpp"
 #include "server/host/rank/victory.hpp"
 #include "server/host/root.hpp"
 #include "server/host/session.hpp"
@@ -25,6 +28,27 @@
 #include "server/interface/filebaseclient.hpp"
 #include "server/interface/hosttool.hpp"
 
+namespace {
+    /* Intersect candidate list with a game index set.
+       \param key            Index set
+       \param candidates     [in/out] Sorted list of candidate game Ids
+       \param haveCandidates [in/out] true if candidates is valid; false if there are no restrictions yet */
+    void intersectIndex(afl::net::redis::IntegerSetKey key, afl::data::IntegerList_t& candidates, bool& haveCandidates)
+    {
+        afl::data::IntegerList_t list;
+        key.getAll(list);
+        std::sort(list.begin(), list.end());
+        if (!haveCandidates) {
+            candidates.swap(list);
+            haveCandidates = true;
+        } else {
+            afl::data::IntegerList_t result;
+            std::set_intersection(candidates.begin(), candidates.end(), list.begin(), list.end(), std::back_inserter(result));
+            candidates.swap(result);
+        }
+    }
+}
+
 server::host::HostGame::HostGame(const Session& session, Root& root)
     : m_session(session),
       m_root(root)
@@ -141,6 +165,7 @@ server::host::HostGame::setName(int32_t gameId, String_t name)
     m_session.checkPermission(game, Game::AdminPermission);
 
     game.setName(name, m_root.getForum());
+    m_root.arbiter().markModified(gameId);
 }
 
 server::interface::HostGame::Info
@@ -164,8 +189,24 @@ server::host::HostGame::getInfos(const Filter& filter, bool verbose, std::vector
     // ex planetscentral/host/cmdgame.h:doListGames
     afl::data::IntegerList_t list;
     listGames(filter, list);
+
+    const String_t otherUser = filter.requiredUser.orElse(String_t());
+    GameInfoCache& cache = m_root.gameInfoCache();
     for (size_t i = 0, n = list.size(); i < n; ++i) {
-        result.push_back(Game(m_root, list[i], Game::NoExistanceCheck).describe(verbose, m_session.getUser(), filter.requiredUser.orElse(String_t()), m_root));
+        Game game(m_root, list[i], Game::NoExistanceCheck);
+        if (verbose) {
+            result.push_back(game.describe(verbose, m_session.getUser(), otherUser, m_root));
+        } else {
+            // Non-verbose information is cached; only the user-dependant part is computed each time
+            const uint32_t counter = m_root.arbiter().getModificationCounter(list[i]);
+            const Info* p = cache.get(list[i], counter);
+            if (p == 0) {
+                cache.put(list[i], counter, game.describe(false, String_t(), String_t(), m_root));
+                p = cache.get(list[i], counter);
+            }
+            result.push_back(*p);
+            game.describeUserStatus(result.back(), m_session.getUser(), otherUser);
+        }
     }
 }
 
@@ -229,11 +270,18 @@ server::host::HostGame::setConfig(int32_t gameId, const afl::data::StringList_t&
     }
 
     // Execute
+    bool indexChanged = false;
     for (size_t i = 0, n = keyValues.size(); i+1 < n; i += 2) {
         game.setConfig(keyValues[i], keyValues[i+1]);
+        if (GameIndex::isIndexedSetting(keyValues[i])) {
+            indexChanged = true;
+        }
     }
     game.clearCache();
     m_root.invalidateGameData(gameId);
+    if (indexChanged) {
+        GameIndex(m_root).update(gameId);
+    }
 
     // Set status bits
     if (endChanged && !endSet) {
@@ -628,16 +676,50 @@ server::host::HostGame::listGames(const Filter& filter, afl::data::IntegerList_t
     const String_t* requiredMaster   = filter.requiredMaster.get();
     const int32_t* requiredCopyOf    = filter.requiredCopyOf.get();
 
+    // Use secondary indexes where possible.
+    // Empty values (and copyOf=0) match games that do not have the setting at all; those are not indexed and need to be checked individually.
+    const bool indexHost     = (requiredHost     != 0 && !requiredHost->empty());
+    const bool indexTool     = (requiredTool     != 0 && !requiredTool->empty());
+    const bool indexShipList = (requiredShipList != 0 && !requiredShipList->empty());
+    const bool indexMaster   = (requiredMaster   != 0 && !requiredMaster->empty());
+    const bool indexCopyOf   = (requiredCopyOf   != 0 && *requiredCopyOf != 0);
+
+    afl::data::IntegerList_t candidates;
+    bool haveCandidates = false;
+    if (indexHost || indexTool || indexShipList || indexMaster || indexCopyOf) {
+        GameIndex index(m_root);
+        index.ensureValid();
+        if (indexHost) {
+            intersectIndex(index.bySetting("host", *requiredHost), candidates, haveCandidates);
+        }
+        if (indexShipList) {
+            intersectIndex(index.bySetting("shiplist", *requiredShipList), candidates, haveCandidates);
+        }
+        if (indexMaster) {
+            intersectIndex(index.bySetting("master", *requiredMaster), candidates, haveCandidates);
+        }
+        if (indexCopyOf) {
+            intersectIndex(index.bySetting("copyOf", afl::string::Format("%d", *requiredCopyOf)), candidates, haveCandidates);
+        }
+        if (indexTool) {
+            intersectIndex(index.byTool(*requiredTool), candidates, haveCandidates);
+        }
+    }
+
     for (size_t i = 0; i < games.size(); ++i) {
+        if (haveCandidates && !std::binary_search(candidates.begin(), candidates.end(), games[i])) {
+            continue;
+        }
+
         Game game(m_root, games[i], Game::NoExistanceCheck);
         if ((!needPermissionCheck || game.hasPermission(m_session.getUser(), Game::ReadPermission))
             && (!needTypeCheck || formatType(game.getType()) == typeLimit)
             && (!needStateCheck || formatState(game.getState()) == stateLimit)
-            && (!requiredHost || game.settings().stringField("host").get() == *requiredHost)
-            && (!requiredShipList || game.settings().stringField("shiplist").get() == *requiredShipList)
-            && (!requiredMaster || game.settings().stringField("master").get() == *requiredMaster)
-            && (!requiredCopyOf || game.getConfigInt("copyOf") == *requiredCopyOf)
-            && (!requiredTool || game.tools().contains(*requiredTool)))
+            && (!requiredHost || indexHost || game.settings().stringField("host").get() == *requiredHost)
+            && (!requiredShipList || indexShipList || game.settings().stringField("shiplist").get() == *requiredShipList)
+            && (!requiredMaster || indexMaster || game.settings().stringField("master").get() == *requiredMaster)
+            && (!requiredCopyOf || indexCopyOf || game.getConfigInt("copyOf") == *requiredCopyOf)
+            && (!requiredTool || indexTool || game.tools().contains(*requiredTool)))
         {
             result.push_back(games[i]);
         }
@@ -684,6 +766,7 @@ server::host::HostGame::addRemoveTool(int32_t gameId, String_t toolId, bool add)
         }
         game.clearCache();
         m_root.invalidateGameData(gameId);
+        GameIndex(m_root).update(gameId);
         game.configChanged().set(1);
     }
 
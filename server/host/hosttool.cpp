@@ -160,6 +160,7 @@ server::host::HostTool::add(String_t id, String_t path, String_t program, String
         if (m_area == ShipList) {
             m_root.invalidateShipListData(id);
         }
+        m_root.arbiter().markAllModified();
     }
 }
 
@@ -176,6 +177,7 @@ server::host::HostTool::set(String_t id, String_t key, String_t value)
     if (m_area == ShipList) {
         m_root.invalidateShipListData(id);
     }
+    m_root.arbiter().markAllModified();
 }
 
 String_t
@@ -207,6 +209,7 @@ server::host::HostTool::remove(String_t id)
     if (m_area == ShipList) {
         m_root.invalidateShipListData(id);
     }
+    m_root.arbiter().markAllModified();
 
     return result;
 }
@@ -254,6 +257,7 @@ server::host::HostTool::copy(String_t sourceId, String_t destinationId)
     if (m_area == ShipList) {
         m_root.invalidateShipListData(destinationId);
     }
+    m_root.arbiter().markAllModified();
 }
 
 void
@@ -298,6 +302,7 @@ server::host::HostTool::clearDifficulty(String_t id)
     afl::net::redis::HashKey tool(m_tree.byName(id));
     tool.field("difficulty").remove();
     tool.field("useDifficulty").remove();
+    m_root.arbiter().markAllModified();
 }
 
 int32_t
@@ -328,6 +333,7 @@ server::host::HostTool::setDifficulty(String_t id, afl::base::Optional<int32_t>
 
     tool.intField("difficulty").set(actualValue);
     tool.intField("useDifficulty").set(use);
+    m_root.arbiter().markAllModified();
 
     return actualValue;
 }
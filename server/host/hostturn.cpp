@@ -8,13 +8,12 @@
 #include "afl/charset/codepage.hpp"
 #include "afl/charset/codepagecharset.hpp"
 #include "afl/data/stringlist.hpp"
-#include "afl/io/constmemorystream.hpp"
 #include "afl/io/directoryentry.hpp"
 #include "afl/net/redis/stringfield.hpp"
 #include "afl/string/format.hpp"
 #include "afl/string/nulltranslator.hpp"
 #include "game/v3/registrationkey.hpp"
-#include "game/v3/turnfile.hpp"
+#include "game/v3/turnfileview.hpp"
 #include "server/errors.hpp"
 #include "server/host/exporter.hpp"
 #include "server/host/game.hpp"
@@ -65,7 +64,7 @@ namespace server { namespace host { namespace {
             && sch.getHostDelay() >= 5;
     }
 
-    void rememberKey(Root& root, String_t userId, int32_t gameId, const game::v3::TurnFile& trn)
+    void rememberKey(Root& root, String_t userId, int32_t gameId, const game::v3::TurnFileView& trn)
     {
         game::v3::RegistrationKey key(std::auto_ptr<afl::charset::Charset>(new afl::charset::CodepageCharset(afl::charset::g_codepageLatin1)));
         key.unpackFromBytes(afl::base::fromObject(trn.getDosTrailer().registrationKey));
@@ -90,13 +89,12 @@ server::host::HostTurn::submit(const String_t& blob,
 {
     // ex doTurnUpload
 
-    // Parse the turn file and complete the parameters
-    std::auto_ptr<game::v3::TurnFile> trn;
-    afl::charset::CodepageCharset charset(afl::charset::g_codepageLatin1);
+    // Parse the turn file and complete the parameters.
+    // We only need the header; the view refers to the blob directly without copying it.
+    std::auto_ptr<game::v3::TurnFileView> trn;
     try {
-        afl::io::ConstMemoryStream ms(afl::string::toBytes(blob));
         afl::string::NullTranslator tx;
-        trn.reset(new game::v3::TurnFile(charset, tx, ms, false));
+        trn.reset(new game::v3::TurnFileView(afl::string::toBytes(blob), "<blob>", tx, false));
     }
     catch (std::exception& e) {
         m_root.log().write(afl::sys::LogListener::Warn, LOG_NAME, afl::string::Format("Turn fails to parse: %s", e.what()));
@@ -59,6 +59,7 @@ server::host::Root::Root(afl::net::CommandHandler& db,
       m_userFile(userFile),
       m_mailQueue(mailQueue),
       m_arbiter(),
+      m_gameInfoCache(),
       m_checkturnRunner(checkturnRunner),
       m_fileSystem(fs),
       m_pTalkListener(0),
@@ -155,6 +156,12 @@ server::host::Root::arbiter()
     return m_arbiter;
 }
 
+server::host::GameInfoCache&
+server::host::Root::gameInfoCache()
+{
+    return m_gameInfoCache;
+}
+
 const server::host::Configuration&
 server::host::Root::config() const
 {
@@ -204,6 +211,7 @@ server::host::Root::getCron()
 void
 server::host::Root::handleGameChange(int32_t gameId)
 {
+    m_arbiter.markModified(gameId);
     if (Cron* p = getCron()) {
         p->handleGameChange(gameId);
     }
@@ -213,7 +221,7 @@ void
 server::host::Root::invalidateGameData(int32_t gameId)
 {
     // xref HostSpecificationImpl::getGameData
-    (void) gameId;
+    m_arbiter.markModified(gameId);
     m_specPublisher.invalidateCache();
 }
 
@@ -16,6 +16,7 @@
 #include "server/common/root.hpp"
 #include "server/host/configuration.hpp"
 #include "server/host/gamearbiter.hpp"
+#include "server/host/gameinfocache.hpp"
 #include "server/host/spec/publisherimpl.hpp"
 #include "server/interface/mailqueue.hpp"
 #include "server/interface/sessionrouter.hpp"
@@ -117,6 +118,10 @@ namespace server { namespace host {
             \return GameArbiter */
         GameArbiter& arbiter();
 
+        /** Access cache of game descriptions.
+            \return cache */
+        GameInfoCache& gameInfoCache();
+
         /** Access configuration.
             \return configuration */
         const Configuration& config() const;
@@ -152,12 +157,12 @@ namespace server { namespace host {
         Cron* getCron();
 
         /** Handle change to game.
-            Forwards the request to scheduler, if any.
+            Forwards the request to scheduler, if any, and reports the modification to the GameArbiter.
             \param gameId Game Id */
         void handleGameChange(int32_t gameId);
 
         /** Invalidate game data.
-            Discards cached ship list data for the game.
+            Discards cached ship list data and description for the game.
             If that data is requested again, it is reloaded.
             \param gameId Game Id */
         void invalidateGameData(int32_t gameId);
@@ -225,6 +230,7 @@ namespace server { namespace host {
         server::interface::MailQueue& m_mailQueue;
 
         GameArbiter m_arbiter;
+        GameInfoCache m_gameInfoCache;
 
         util::ProcessRunner& m_checkturnRunner;
         afl::io::FileSystem& m_fileSystem;
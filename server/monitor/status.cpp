@@ -4,10 +4,13 @@
   */
 
 #include "server/monitor/status.hpp"
+#include "afl/base/stoppable.hpp"
 #include "afl/except/commandlineexception.hpp"
 #include "afl/string/format.hpp"
 #include "afl/string/parse.hpp"
 #include "afl/sys/mutexguard.hpp"
+#include "afl/sys/thread.hpp"
+#include "server/monitor/statusobserver.hpp"
 #include "server/monitor/timeserieswriter.hpp"
 #include "server/monitor/timeseriesloader.hpp"
 
@@ -28,8 +31,134 @@ namespace {
         }
         return "?";
     }
+
+    /* Result to report for an observer that did not respond */
+    Observer::Result getFailureResult(Observer& obs)
+    {
+        return Observer::Result(dynamic_cast<server::monitor::StatusObserver*>(&obs) != 0 ? Observer::Broken : Observer::Unknown, 0);
+    }
 }
 
+/******************************** Probe ********************************/
+
+/* A Probe runs one Observer's check() in its own thread.
+   start() triggers a check; getResult() retrieves the result.
+   A probe that is still busy from a previous round (hung observer) cannot be started again. */
+class server::monitor::Status::Probe : public afl::base::Stoppable {
+ public:
+    Probe(Status& parent, Observer& observer);
+    ~Probe();
+
+    bool start(uint32_t round);
+    bool getResult(uint32_t round, Observer::Result& result);
+
+    virtual void run();
+    virtual void stop();
+
+ private:
+    Status& m_parent;
+    Observer& m_observer;
+
+    afl::sys::Semaphore m_wake;             ///< Wake the thread. Posted by start() and stop().
+    afl::sys::Mutex m_mutex;                ///< Mutex protecting all of the following variables.
+    bool m_stopRequest;                     ///< Set to true to stop the thread.
+    bool m_busy;                            ///< true if a check has been started and not yet completed.
+    uint32_t m_round;                       ///< Round of most recent start().
+    uint32_t m_resultRound;                 ///< Round of m_result.
+    Observer::Result m_result;              ///< Result of most recent completed check.
+
+    afl::sys::Thread m_thread;
+};
+
+server::monitor::Status::Probe::Probe(Status& parent, Observer& observer)
+    : m_parent(parent),
+      m_observer(observer),
+      m_wake(0),
+      m_mutex(),
+      m_stopRequest(false),
+      m_busy(false),
+      m_round(0),
+      m_resultRound(0),
+      m_result(),
+      m_thread("monitor.probe", *this)
+{
+    m_thread.start();
+}
+
+server::monitor::Status::Probe::~Probe()
+{
+    m_thread.join();
+}
+
+/* Start a check. Returns false if the previous check is still running. */
+bool
+server::monitor::Status::Probe::start(uint32_t round)
+{
+    afl::sys::MutexGuard g(m_mutex);
+    if (m_busy) {
+        return false;
+    }
+    m_busy = true;
+    m_round = round;
+    m_wake.post();
+    return true;
+}
+
+/* Get result of a check. Returns false if no result is available for the given round. */
+bool
+server::monitor::Status::Probe::getResult(uint32_t round, Observer::Result& result)
+{
+    afl::sys::MutexGuard g(m_mutex);
+    if (m_busy || m_resultRound != round) {
+        return false;
+    }
+    result = m_result;
+    return true;
+}
+
+void
+server::monitor::Status::Probe::run()
+{
+    while (1) {
+        m_wake.wait();
+        uint32_t round;
+        {
+            afl::sys::MutexGuard g(m_mutex);
+            if (m_stopRequest) {
+                break;
+            }
+            round = m_round;
+        }
+
+        Observer::Result result;
+        try {
+            result = m_observer.check();
+        }
+        catch (std::exception& e) {
+            m_parent.log().write(afl::sys::LogListener::Warn, LOG_NAME, m_observer.getName(), e);
+            result = Observer::Result(Observer::Broken, 0);
+        }
+
+        {
+            afl::sys::MutexGuard g(m_mutex);
+            m_result = result;
+            m_resultRound = round;
+            m_busy = false;
+        }
+        m_parent.m_done.post();
+    }
+}
+
+void
+server::monitor::Status::Probe::stop()
+{
+    afl::sys::MutexGuard g(m_mutex);
+    m_stopRequest = true;
+    m_wake.post();
+}
+
+/******************************** Status *******************************/
+
 server::monitor::Status::Status()
     : m_log(),
       m_mutex(),
@@ -37,11 +166,22 @@ server::monitor::Status::Status()
       m_timeSeries(),
       m_status(),
       m_statusTime(),
-      m_maxTimePoints(2000)
+      m_maxTimePoints(TimeSeries::DEFAULT_SIZE),
+      m_timeout(10000),
+      m_probes(),
+      m_done(0),
+      m_round(0)
 { }
 
 server::monitor::Status::~Status()
-{ }
+{
+    // Stop all probes before the observers die.
+    // Note that this will wait for hung checks to complete.
+    for (size_t i = 0, n = m_probes.size(); i < n; ++i) {
+        m_probes[i]->stop();
+    }
+    m_probes.clear();
+}
 
 void
 server::monitor::Status::addNewObserver(Observer* p)
@@ -65,7 +205,8 @@ server::monitor::Status::handleConfiguration(const String_t& key, const String_t
         /* @q Monitor.History:Int (Config)
            History depth.
            Load-average and latency probes will keep a history of this many values.
-           When the history exceeds the limit, older values will be removed by averaging them.
+           The most recent values are kept at full resolution,
+           older values are kept at successively reduced resolution by averaging them.
            @since PCC2 2.40.3 */
         int n;
         if (afl::string::strToInteger(value, n) && n > 0) {
@@ -75,32 +216,82 @@ server::monitor::Status::handleConfiguration(const String_t& key, const String_t
             throw afl::except::CommandLineException(afl::string::Format("Invalid number for '%s'", key));
         }
     }
+    if (key == "MONITOR.TIMEOUT") {
+        /* @q Monitor.Timeout:Int (Config)
+           Time to wait for probes, in seconds.
+           All services are checked in parallel.
+           A service that does not respond within this time is reported as broken.
+           @since PCC2 2.41.2 */
+        int n;
+        if (afl::string::strToInteger(value, n) && n > 0) {
+            setTimeout(afl::sys::Timeout_t(n) * 1000);
+            result = true;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid number for '%s'", key));
+        }
+    }
     return result;
 }
 
 void
 server::monitor::Status::update()
 {
-    // Determine new status. Be careful to not hold a mutex while doing so.
-    std::vector<Observer::Result> newStatus;
-    for (size_t i = 0, n = getNumObservers(); i < n; ++i) {
-        Observer::Result newItem;
-        if (Observer* p = getObserverByIndex(i)) {
-            try {
-                newItem = p->check();
+    // Start all probes. Be careful to not hold a mutex while waiting for them.
+    // A probe that is still busy from a previous round is hung; do not wait for it.
+    const uint32_t round = ++m_round;
+    const size_t numObservers = getNumObservers();
+    std::vector<Observer::Result> newStatus(numObservers);
+    std::vector<bool> haveResult(numObservers);
+    size_t numPending = numObservers;
+    for (size_t i = 0; i < numObservers; ++i) {
+        if (i >= m_probes.size()) {
+            Observer* p = getObserverByIndex(i);
+            m_probes.pushBackNew(p != 0 ? new Probe(*this, *p) : 0);
+        }
+        if (Probe* p = m_probes[i]) {
+            if (!p->start(round)) {
+                Observer* obs = getObserverByIndex(i);
+                log().write(afl::sys::LogListener::Warn, LOG_NAME, Format("%s: previous check still running", obs->getName()));
+                newStatus[i] = getFailureResult(*obs);
+                haveResult[i] = true;
+                --numPending;
             }
-            catch (std::exception& e) {
-                log().write(afl::sys::LogListener::Warn, LOG_NAME, p->getName(), e);
-                newItem = Observer::Result(Observer::Broken, 0);
+        }
+    }
+
+    // Wait for results, until deadline
+    const uint32_t startTime = afl::sys::Time::getTickCounter();
+    while (1) {
+        for (size_t i = 0; i < numObservers; ++i) {
+            if (!haveResult[i]) {
+                Probe* p = m_probes[i];
+                if (p == 0 || p->getResult(round, newStatus[i])) {
+                    haveResult[i] = true;
+                    --numPending;
+                }
             }
         }
-        newStatus.push_back(newItem);
+
+        const uint32_t elapsed = afl::sys::Time::getTickCounter() - startTime;
+        if (numPending == 0 || elapsed >= m_timeout) {
+            break;
+        }
+        m_done.wait(m_timeout - elapsed);
+    }
+
+    // Report late observers
+    for (size_t i = 0; i < numObservers; ++i) {
+        if (!haveResult[i]) {
+            Observer* p = getObserverByIndex(i);
+            log().write(afl::sys::LogListener::Warn, LOG_NAME, Format("%s: no response within %d ms", p->getName(), m_timeout));
+            newStatus[i] = getFailureResult(*p);
+        }
     }
 
     // Update status atomically
     afl::sys::MutexGuard g(m_mutex);
     while (m_timeSeries.size() < newStatus.size()) {
-        m_timeSeries.pushBackNew(new TimeSeries());
+        m_timeSeries.pushBackNew(new TimeSeries(m_maxTimePoints));
     }
     m_statusTime = afl::sys::Time::getCurrentTime();
     for (size_t i = 0, n = newStatus.size(); i < n; ++i) {
@@ -114,13 +305,16 @@ server::monitor::Status::update()
         m_timeSeries[i]->add(m_statusTime,
                              (newStatus[i].status == Observer::Value || newStatus[i].status == Observer::Running),
                              newStatus[i].value);
-        if (m_timeSeries[i]->size() > m_maxTimePoints) {
-            m_timeSeries[i]->compact(0, m_maxTimePoints/2, 2);
-        }
     }
     m_status.swap(newStatus);
 }
 
+void
+server::monitor::Status::setTimeout(afl::sys::Timeout_t timeout)
+{
+    m_timeout = timeout;
+}
+
 String_t
 server::monitor::Status::render(afl::sys::Time& time) const
 {
@@ -196,7 +390,7 @@ server::monitor::Status::load(afl::io::Stream& file)
     afl::sys::MutexGuard g(m_mutex);
     TimeSeriesLoader r;
     while (m_timeSeries.size() < m_observers.size()) {
-        m_timeSeries.pushBackNew(new TimeSeries());
+        m_timeSeries.pushBackNew(new TimeSeries(m_maxTimePoints));
     }
     for (size_t i = 0, n = m_observers.size(); i < n; ++i) {
         if (m_observers[i] != 0 && m_timeSeries[i] != 0) {
@@ -8,7 +8,9 @@
 #include "afl/container/ptrvector.hpp"
 #include "afl/sys/log.hpp"
 #include "afl/sys/mutex.hpp"
+#include "afl/sys/semaphore.hpp"
 #include "afl/sys/time.hpp"
+#include "afl/sys/types.hpp"
 #include "server/monitor/observer.hpp"
 #include "server/monitor/timeseries.hpp"
 #include "afl/io/stream.hpp"
@@ -18,7 +20,12 @@ namespace server { namespace monitor {
     /** Manager for multiple observers.
         Provides a thread-safe interface to access the status of a system defined as multiple Observer instances.
         This allows the server thread to obtain a valid status rendering at any time,
-        while performing updates from another thread. */
+        while performing updates from another thread.
+
+        Each Observer is checked by an own probe thread, so all observers are checked in parallel.
+        update() waits for the results up to a configurable timeout.
+        An observer that does not produce a result within that time will be reported as Broken (StatusObserver)
+        or Unknown (other observers); its probe is not restarted until its check completes. */
     class Status {
      public:
         /** Default constructor.
@@ -41,10 +48,15 @@ namespace server { namespace monitor {
         bool handleConfiguration(const String_t& key, const String_t& value);
 
         /** Update the contained status.
-            Calls all Observer's checkStatus() methods in sequence.
+            Calls all Observer's check() methods in parallel, and waits for them to complete,
+            but at most for the configured timeout (see setTimeout()).
             Until this method completes, render() will return the old status. */
         void update();
 
+        /** Set timeout for update().
+            \param timeout Timeout in milliseconds */
+        void setTimeout(afl::sys::Timeout_t timeout);
+
         /** Return textual rendering of the service status.
             \param time [out] Associated timestamp
             \return HTML rendering */
@@ -68,6 +80,9 @@ namespace server { namespace monitor {
         afl::sys::Log& log();
 
      private:
+        class Probe;
+        friend class Probe;
+
         afl::sys::Log m_log;                                ///< Log node.
 
         mutable afl::sys::Mutex m_mutex;                    ///< Mutex protecting the following variables.
@@ -77,6 +92,11 @@ namespace server { namespace monitor {
         afl::sys::Time m_statusTime;                        ///< Time of status check.
 
         size_t m_maxTimePoints;
+        afl::sys::Timeout_t m_timeout;                      ///< Timeout for update(), milliseconds.
+
+        afl::container::PtrVector<Probe> m_probes;          ///< Probes, by index. Used by update() only.
+        afl::sys::Semaphore m_done;                         ///< Posted by a probe after completing a check.
+        uint32_t m_round;                                   ///< Counter for update() invocations, to identify probe results.
 
         /* Accessor methods, private because there is no public need so far */
         size_t getNumObservers();
@@ -101,8 +101,8 @@ namespace {
 
 }
 
-server::monitor::TimeSeries::TimeSeries()
-    : m_items()
+server::monitor::TimeSeries::TimeSeries(size_t maxSize)
+    : m_levelSize(std::max(size_t(2), maxSize / NUM_LEVELS))
 { }
 
 server::monitor::TimeSeries::~TimeSeries()
@@ -111,22 +111,27 @@ server::monitor::TimeSeries::~TimeSeries()
 void
 server::monitor::TimeSeries::add(afl::sys::Time time, bool valid, int32_t value)
 {
-    m_items.push_back(Item(time, valid, value));
+    addToLevel(0, Item(time, valid, value));
 }
 
 size_t
 server::monitor::TimeSeries::size() const
 {
-    return m_items.size();
+    size_t result = 0;
+    for (size_t i = 0; i < NUM_LEVELS; ++i) {
+        result += m_levels[i].count;
+    }
+    return result;
 }
 
 bool
 server::monitor::TimeSeries::get(size_t index, afl::sys::Time& timeOut, bool& validOut, int32_t& valueOut) const
 {
-    if (index < m_items.size()) {
-        timeOut  = m_items[index].time;
-        validOut = m_items[index].valid;
-        valueOut = m_items[index].value;
+    if (index < size()) {
+        const Item& it = at(index);
+        timeOut  = it.time;
+        validOut = it.valid;
+        valueOut = it.value;
         return true;
     } else {
         return false;
@@ -148,68 +153,6 @@ server::monitor::TimeSeries::get(size_t index, afl::sys::Time& timeOut, int32_t&
     }
 }
 
-void
-server::monitor::TimeSeries::compact(size_t start, size_t count, size_t factor)
-{
-    // Limit start
-    if (start >= m_items.size()) {
-        return;
-    }
-
-    // Prepare input
-    size_t in = start;
-    size_t limit = start + std::min(count, m_items.size() - start);
-
-    // Prepare output
-    size_t out = start;
-
-    // Read elements
-    while (in < limit) {
-        // Read first element
-        const afl::sys::Time startTime = m_items[in].time;
-        int32_t numValid = 0;
-        int32_t numTimes = 1;
-        int64_t sumValues = 0;
-        afl::sys::Duration sumDurations;
-        if (m_items[in].valid) {
-            ++numValid;
-            sumValues += m_items[in].value;
-        }
-        ++in;
-
-        // Read following elements
-        for (size_t i = 1; i < factor; ++i) {
-            if (in < limit) {
-                sumDurations += m_items[in].time - startTime;
-                if (m_items[in].valid) {
-                    ++numValid;
-                    sumValues += m_items[in].value;
-                }
-                ++numTimes;
-                ++in;
-            } else {
-                break;
-            }
-        }
-
-        // Produce output
-        m_items[out].time = startTime + afl::sys::Duration::fromMilliseconds(sumDurations.getMilliseconds() / numTimes);
-        if (numValid > 0) {
-            m_items[out].valid = true;
-            m_items[out].value = int32_t(sumValues / numValid);
-        } else {
-            m_items[out].valid = false;
-            m_items[out].value = 0;
-        }
-        ++out;
-    }
-
-    // Remove unused values
-    if (in != out) {
-        m_items.erase(m_items.begin() + out, m_items.begin() + in);
-    }
-}
-
 String_t
 server::monitor::TimeSeries::render(int width, int height) const
 {
@@ -249,23 +192,24 @@ server::monitor::TimeSeries::render(int width, int height) const
         .render();
 
     // Quick exit on empty graph
-    if (m_items.empty()) {
+    const size_t n = size();
+    if (n == 0) {
         return result;
     }
 
     // Determine width
-    const size_t n = m_items.size();
     const size_t scaleX = std::max(size_t(10), n);
 
     // Render time labels
-    int numTimeLabels = std::min(width / LABEL_SPACING, int(m_items.size()));
+    const afl::sys::Time lastTime = at(n-1).time;
+    int numTimeLabels = std::min(width / LABEL_SPACING, int(n));
     for (int i = 0; i < numTimeLabels; ++i) {
-        size_t index = m_items.size()-1 - (i * int(m_items.size()) / numTimeLabels);
-        if (index < m_items.size()) {
+        size_t index = n-1 - (i * int(n) / numTimeLabels);
+        if (index < n) {
             result += Format("<text x=\"%d\" y=\"%d\" text-anchor=\"end\" transform=\"rotate(-90 %0$d,%d)\" class=\"axes\">%s</text>\n",
                              CHART_LEFT + ((CHART_RIGHT - CHART_LEFT) * int(index) / int(scaleX)),
                              LABEL_Y,
-                             getAgeName((m_items.back().time - m_items[index].time).getMilliseconds()));
+                             getAgeName((lastTime - at(index).time).getMilliseconds()));
         }
     }
 
@@ -281,9 +225,10 @@ server::monitor::TimeSeries::render(int width, int height) const
             ++end;
         }
         for (size_t i = start; i < end; ++i) {
-            if (m_items[i].valid) {
+            const Item& it = at(i);
+            if (it.valid) {
                 int x = CHART_LEFT + ((CHART_RIGHT - CHART_LEFT) * int(i) / int(scaleX));
-                int y = CHART_BOTTOM - ((CHART_BOTTOM - CHART_TOP) * (m_items[i].value - min) / (max - min));
+                int y = CHART_BOTTOM - ((CHART_BOTTOM - CHART_TOP) * (it.value - min) / (max - min));
                 if (pathLength == 0) {
                     path.move(x, y);
                 } else {
@@ -312,10 +257,11 @@ server::monitor::TimeSeries::getMinMax(int32_t& min, int32_t& max) const
 {
     int32_t min_ = 0;
     int32_t max_ = 1;
-    for (size_t i = 0, n = m_items.size(); i < n; ++i) {
-        if (m_items[i].valid) {
-            min_ = std::min(min_, m_items[i].value);
-            max_ = std::max(max_, m_items[i].value);
+    for (size_t i = 0, n = size(); i < n; ++i) {
+        const Item& it = at(i);
+        if (it.valid) {
+            min_ = std::min(min_, it.value);
+            max_ = std::max(max_, it.value);
         }
     }
     min = min_;
@@ -327,14 +273,14 @@ server::monitor::TimeSeries::findLimit(size_t top) const
 {
     if (top >= 2) {
         // Compute acceptable range for top element
-        int64_t delta = (m_items[top-1].time - m_items[top-2].time).getMilliseconds();
+        int64_t delta = (at(top-1).time - at(top-2).time).getMilliseconds();
         int64_t maxDelta = (delta+1) + (delta/3);
         int64_t minDelta = 2*delta/3;
 
         // Find lower limit
         size_t limit = top-2;
         while (limit > 0) {
-            int64_t newDelta = (m_items[limit].time - m_items[limit-1].time).getMilliseconds();
+            int64_t newDelta = (at(limit).time - at(limit-1).time).getMilliseconds();
             if (newDelta < minDelta || newDelta > maxDelta) {
                 break;
             }
@@ -346,3 +292,53 @@ server::monitor::TimeSeries::findLimit(size_t top) const
         return 0;
     }
 }
+
+/* Add an item to a level. If the level is full, its two oldest items are merged into the next level. */
+void
+server::monitor::TimeSeries::addToLevel(size_t level, const Item& item)
+{
+    Level& lv = m_levels[level];
+    if (lv.items.empty()) {
+        lv.items.resize(m_levelSize);
+    }
+    if (lv.count == m_levelSize) {
+        const Item& a = lv.items[lv.first];
+        const Item& b = lv.items[(lv.first + 1) % m_levelSize];
+        if (level+1 < NUM_LEVELS) {
+            Item merged(a.time + afl::sys::Duration::fromMilliseconds((b.time - a.time).getMilliseconds() / 2), false, 0);
+            int32_t numValid = 0;
+            int64_t sumValues = 0;
+            if (a.valid) {
+                ++numValid;
+                sumValues += a.value;
+            }
+            if (b.valid) {
+                ++numValid;
+                sumValues += b.value;
+            }
+            if (numValid > 0) {
+                merged.valid = true;
+                merged.value = int32_t(sumValues / numValid);
+            }
+            addToLevel(level+1, merged);
+        }
+        lv.first = (lv.first + 2) % m_levelSize;
+        lv.count -= 2;
+    }
+    lv.items[(lv.first + lv.count) % m_levelSize] = item;
+    ++lv.count;
+}
+
+/* Access item by index, 0=oldest. Index must be valid. */
+const server::monitor::TimeSeries::Item&
+server::monitor::TimeSeries::at(size_t index) const
+{
+    // Oldest items are in the highest level
+    size_t level = NUM_LEVELS;
+    while (level > 1 && index >= m_levels[level-1].count) {
+        index -= m_levels[level-1].count;
+        --level;
+    }
+    const Level& lv = m_levels[level-1];
+    return lv.items[(lv.first + index) % m_levelSize];
+}
@@ -9,9 +9,24 @@
 
 namespace server { namespace monitor {
 
+    /** Time series of observer results.
+
+        Storage is a fixed-size multi-resolution ring buffer.
+        Newest values are stored at full resolution.
+        When a level fills up, its two oldest values are averaged into one value of the next level;
+        values falling off the last level are discarded.
+        Thus, memory usage and rendering time are bounded, while still covering a long history. */
     class TimeSeries {
      public:
-        TimeSeries();
+        /** Number of resolution levels. */
+        static const size_t NUM_LEVELS = 8;
+
+        /** Default number of values. */
+        static const size_t DEFAULT_SIZE = 2000;
+
+        /** Constructor.
+            \param maxSize Maximum number of values to keep (total for all levels) */
+        explicit TimeSeries(size_t maxSize = DEFAULT_SIZE);
 
         ~TimeSeries();
 
@@ -23,8 +38,6 @@ namespace server { namespace monitor {
 
         bool get(size_t index, afl::sys::Time& timeOut, int32_t& valueOut) const;
 
-        void compact(size_t start, size_t count, size_t factor);
-
         String_t render(int width, int height) const;
 
      private:
@@ -33,12 +46,30 @@ namespace server { namespace monitor {
             bool valid;
             int32_t value;
 
+            Item()
+                : time(), valid(false), value(0)
+                { }
             Item(afl::sys::Time time, bool valid, int32_t value)
                 : time(time), valid(valid), value(value)
                 { }
         };
 
-        std::vector<Item> m_items;
+        /** One resolution level; a ring buffer. */
+        struct Level {
+            std::vector<Item> items;     ///< Storage, m_levelSize elements.
+            size_t first;                ///< Index of oldest element.
+            size_t count;                ///< Number of elements.
+
+            Level()
+                : items(), first(0), count(0)
+                { }
+        };
+
+        size_t m_levelSize;
+        Level m_levels[NUM_LEVELS];
+
+        void addToLevel(size_t level, const Item& item);
+        const Item& at(size_t index) const;
 
         void getMinMax(int32_t& min, int32_t& max) const;
 
@@ -0,0 +1,150 @@
+/**
+  *  \file server/play/changetracker.cpp
+  *  \brief Class server::play::ChangeTracker
+  */
+
+#include "server/play/changetracker.hpp"
+#include "afl/sys/time.hpp"
+#include "game/map/anyplanettype.hpp"
+#include "game/map/anyshiptype.hpp"
+#include "game/map/planet.hpp"
+#include "game/map/ship.hpp"
+#include "game/map/universe.hpp"
+#include "game/turn.hpp"
+
+namespace {
+    /* Epochs stay below this limit, leaving room for 2^30 versions within a signed 32-bit JSON integer */
+    const uint32_t MAX_EPOCH = 0x40000000;
+}
+
+// Constructor.
+server::play::ChangeTracker::ChangeTracker()
+    : m_game(),
+      conn_preUpdate(),
+      m_version(makeEpoch(this)),
+      m_baseVersion(m_version)
+{ }
+
+// Constructor with given epoch.
+server::play::ChangeTracker::ChangeTracker(Version_t epoch)
+    : m_game(),
+      conn_preUpdate(),
+      m_version(epoch),
+      m_baseVersion(epoch)
+{ }
+
+// Destructor.
+server::play::ChangeTracker::~ChangeTracker()
+{ }
+
+// Synchronize with session.
+void
+server::play::ChangeTracker::update(game::Session& session)
+{
+    const afl::base::Ptr<game::Game>& g = session.getGame();
+    if (g.get() != m_game.get()) {
+        // New game: everything we know is void
+        m_game = g;
+        conn_preUpdate.disconnect();
+        for (size_t i = 0; i < NUM_KINDS; ++i) {
+            m_items[i].clear();
+        }
+        m_baseVersion = ++m_version;
+        if (g.get() != 0) {
+            conn_preUpdate = g->currentTurn().universe().sig_preUpdate.add(this, &ChangeTracker::onPreUpdate);
+            onPreUpdate();
+        }
+    }
+    session.notifyListeners();
+}
+
+// Get current version.
+server::play::ChangeTracker::Version_t
+server::play::ChangeTracker::getVersion() const
+{
+    return m_version;
+}
+
+// Get changed objects.
+bool
+server::play::ChangeTracker::getChanges(Kind kind, Version_t since, std::vector<game::Id_t>& out) const
+{
+    if (since < m_baseVersion || since > m_version) {
+        return false;
+    }
+
+    const std::vector<Item>& items = m_items[kind];
+    for (size_t i = 0, n = items.size(); i < n; ++i) {
+        if (items[i].version > since) {
+            out.push_back(game::Id_t(i));
+        }
+    }
+    return true;
+}
+
+/** Make an epoch (initial version number).
+    Mixes wall-clock time, tick counter and instance address, so that different processes
+    (and different trackers within one process) start at different, far-apart points.
+    \param instance Instance address
+    \return epoch in range [1, MAX_EPOCH) */
+server::play::ChangeTracker::Version_t
+server::play::ChangeTracker::makeEpoch(const void* instance)
+{
+    uint32_t x = uint32_t(afl::sys::Time::getCurrentTime().getUnixTime())
+        ^ (afl::sys::Time::getTickCounter() << 10)
+        ^ uint32_t(reinterpret_cast<size_t>(instance));
+    x ^= x >> 16;
+    x *= 0x7FEB352DU;
+    x ^= x >> 15;
+    x *= 0x846CA68BU;
+    x ^= x >> 16;
+    x %= MAX_EPOCH;
+    return x == 0 ? 1 : x;
+}
+
+/** Handle universe change notification.
+    Called before the objects' dirty flags are reset; records all dirty objects with a new version number. */
+void
+server::play::ChangeTracker::onPreUpdate()
+{
+    if (m_game.get() == 0) {
+        return;
+    }
+    game::map::Universe& univ = m_game->currentTurn().universe();
+
+    bool changed = false;
+    for (game::Id_t i = 1, n = univ.ships().size(); i <= n; ++i) {
+        changed |= checkObject(Ships, i, univ.ships().get(i), univ.allShips().getObjectByIndex(i) != 0);
+    }
+    for (game::Id_t i = 1, n = univ.planets().size(); i <= n; ++i) {
+        changed |= checkObject(Planets, i, univ.planets().get(i), univ.allPlanets().getObjectByIndex(i) != 0);
+    }
+    if (changed) {
+        ++m_version;
+    }
+}
+
+/** Check one object.
+    If the object changed, stamps it with the next version number.
+    \param kind    Kind of object list
+    \param id      Object Id
+    \param obj     Object (null if none)
+    \param present true if object is reported in the list
+    \return true if object changed */
+bool
+server::play::ChangeTracker::checkObject(Kind kind, game::Id_t id, const game::map::Object* obj, bool present)
+{
+    std::vector<Item>& items = m_items[kind];
+    if (size_t(id) >= items.size()) {
+        items.resize(id + 1);
+    }
+
+    Item& it = items[id];
+    if (it.present != present || (obj != 0 && obj->isDirty())) {
+        it.present = present;
+        it.version = m_version + 1;
+        return true;
+    } else {
+        return false;
+    }
+}
@@ -0,0 +1,101 @@
+/**
+  *  \file server/play/changetracker.hpp
+  *  \brief Class server::play::ChangeTracker
+  */
+#ifndef C2NG_SERVER_PLAY_CHANGETRACKER_HPP
+#define C2NG_SERVER_PLAY_CHANGETRACKER_HPP
+
+#include <vector>
+#include "afl/base/ptr.hpp"
+#include "afl/base/signalconnection.hpp"
+#include "afl/base/types.hpp"
+#include "game/game.hpp"
+#include "game/session.hpp"
+#include "game/types.hpp"
+
+namespace server { namespace play {
+
+    /** Change tracker for object lists.
+
+        Assigns a version number to each ship and planet, allowing a client that already has an object list
+        to request only the objects that changed since its version (see DeltaPacker).
+
+        ChangeTracker observes the universe's change notification (Universe::sig_preUpdate)
+        and records the objects that are dirty at that time, or whose existence changed.
+        Each batch of changes produces a new version number.
+
+        ChangeTracker can only report changes that happened while it was attached to the current game.
+        If the game is replaced, or a client provides a version number that we did not produce,
+        getChanges() reports that the client needs a full list.
+
+        Version numbers start at a per-instance epoch, not at 1.
+        A client that reconnects to a new server process therefore presents a version that the new tracker
+        has (with high probability) not produced, and receives a full list instead of a wrong delta. */
+    class ChangeTracker {
+     public:
+        /** Version number. */
+        typedef uint32_t Version_t;
+
+        /** Kind of object list. */
+        enum Kind {
+            Ships,
+            Planets
+        };
+        static const size_t NUM_KINDS = 2;
+
+        /** Constructor.
+            Makes a tracker that is not attached to any game.
+            Its version numbers start at an epoch derived from the current time and this instance. */
+        ChangeTracker();
+
+        /** Constructor with given epoch.
+            Makes a tracker that is not attached to any game.
+            \param epoch First version number (nonzero, below 2^30) */
+        explicit ChangeTracker(Version_t epoch);
+
+        /** Destructor. */
+        ~ChangeTracker();
+
+        /** Synchronize with session.
+            Attaches to the session's current game (restarting tracking if it changed),
+            and processes pending changes by calling Session::notifyListeners().
+            \param session Session */
+        void update(game::Session& session);
+
+        /** Get current version.
+            \return version number */
+        Version_t getVersion() const;
+
+        /** Get changed objects.
+            \param [in]  kind  Kind of object list
+            \param [in]  since Version the client has
+            \param [out] out   Ids of objects that changed after version \c since (appended, in increasing order)
+            \retval true  Success
+            \retval false Changes cannot be determined; client needs a full list */
+        bool getChanges(Kind kind, Version_t since, std::vector<game::Id_t>& out) const;
+
+     private:
+        /** Per-object state. */
+        struct Item {
+            Version_t version;
+            bool present;
+            Item()
+                : version(0), present(false)
+                { }
+        };
+
+        afl::base::Ptr<game::Game> m_game;
+        afl::base::SignalConnection conn_preUpdate;
+        Version_t m_version;
+        Version_t m_baseVersion;
+        std::vector<Item> m_items[NUM_KINDS];
+
+        static Version_t makeEpoch(const void* instance);
+
+        void onPreUpdate();
+        bool checkObject(Kind kind, game::Id_t id, const game::map::Object* obj, bool present);
+    };
+
+} }
+
+#endif
@@ -6,6 +6,7 @@
 #include "afl/charset/charset.hpp"
 #include "afl/charset/codepage.hpp"
 #include "afl/charset/codepagecharset.hpp"
+#include "afl/data/stringlist.hpp"
 #include "afl/net/line/linesink.hpp"
 #include "afl/net/url.hpp"
 #include "afl/string/format.hpp"
@@ -26,21 +27,50 @@
 #include "server/play/mainpacker.hpp"
 #include "server/ports.hpp"
 #include "util/charsetfactory.hpp"
+#include "util/directorysnapshot.hpp"
 #include "util/messagecollector.hpp"
 #include "util/string.hpp"
 #include "version.hpp"
 
 using afl::string::Format;
 
+namespace {
+    /* Parameter list received in pool mode, presented as a command line. */
+    class ArgumentList : public afl::base::Enumerator<String_t> {
+     public:
+        ArgumentList(const afl::data::StringList_t& args)
+            : m_args(args), m_index(0)
+            { }
+        virtual bool getNextElement(String_t& result)
+            {
+                if (m_index < m_args.size()) {
+                    result = m_args[m_index++];
+                    return true;
+                } else {
+                    return false;
+                }
+            }
+     private:
+        afl::data::StringList_t m_args;
+        size_t m_index;
+    };
+}
+
 struct server::play::ConsoleApplication::Parameters {
     afl::base::Optional<String_t> arg_gamedir;  // -G
     afl::base::Optional<String_t> arg_rootdir;  // -R
+    afl::base::Optional<String_t> arg_snapshot;       // -S
+    afl::base::Optional<String_t> arg_makeSnapshot;   // -M
+    afl::base::Ptr<afl::io::Directory> poolSnapshot;  // -S given to --pool, loaded in advance
     std::auto_ptr<afl::charset::Charset> gameCharset;
     int playerNumber;
 
     Parameters()
         : arg_gamedir(),
           arg_rootdir(),
+          arg_snapshot(),
+          arg_makeSnapshot(),
+          poolSnapshot(),
           gameCharset(new afl::charset::CodepageCharset(afl::charset::g_codepageLatin1)),
           playerNumber(0)
         { }
@@ -58,72 +88,94 @@ server::play::ConsoleApplication::appMain()
     afl::string::Translator& tx = translator();
 
     // Parameters
-    Parameters params;
+    Parameters poolParams;
+    bool poolMode = parseCommandLine(poolParams, environment().getCommandLine());
 
-    // Parser
-    afl::sys::StandardCommandLineParser commandLine(environment().getCommandLine());
-    String_t p;
-    bool opt;
-    while (commandLine.getNext(opt, p)) {
-        if (opt) {
-            if (p == "h" || p == "help") {
-                help();
-            } else if (p == "C") {
-                // character set
-                if (afl::charset::Charset* cs = util::CharsetFactory().createCharset(commandLine.getRequiredParameter(p))) {
-                    params.gameCharset.reset(cs);
-                } else {
-                    errorExit(tx("the specified character set is not known"));
-                }
-            } else if (p == "R" || p == "W") {
-                // session conflict management; skip those
-                commandLine.getRequiredParameter(p);
-            } else if (p == "D") {
-                // property
-                String_t key = commandLine.getRequiredParameter(p);
-                String_t value;
-                String_t::size_type eq = key.find('=');
-                if (eq != String_t::npos) {
-                    value.assign(key, eq+1, String_t::npos);
-                    key.erase(eq);
-                }
-                m_properties[key] = value;
-            } else {
-                errorExit(Format(tx("invalid option '%s' specified. Use '%s -h' for help."), p, environment().getInvocationName()));
-            }
-        } else {
-            int n;
-            if (afl::string::strToInteger(p, n) && n > 0 && n <= game::MAX_PLAYERS) {
-                if (params.playerNumber != 0) {
-                    errorExit(tx("only one player number allowed"));
-                }
-                params.playerNumber = n;
-            } else if (!params.arg_gamedir.isValid()) {
-                params.arg_gamedir = p;
-            } else if (!params.arg_rootdir.isValid()) {
-                params.arg_rootdir = p;
-            } else {
-                errorExit(tx("too many arguments"));
-            }
-        }
+    afl::base::Ref<afl::io::TextReader> reader = environment().attachTextReader(afl::sys::Environment::Input);
+
+    if (!poolMode) {
+        runSession(poolParams, *reader);
+        return;
     }
 
-    if (params.playerNumber == 0) {
-        errorExit(tx("missing player number"));
+    // Pool mode: map the specification snapshot now, so it is ready when a session is assigned.
+    // It serves as default specification directory; the session's parameters can still name a different one.
+    // Everything else (specification objects, turn) depends on the game directory and is loaded after assignment.
+    // c2play-server does not run script code, so there is no interpreter state to prepare.
+    String_t poolSnapshotName;
+    afl::base::Ptr<afl::io::Directory> poolSnapshot;
+    if (poolParams.arg_snapshot.get(poolSnapshotName)) {
+        poolSnapshot = loadSnapshot(poolSnapshotName).asPtr();
     }
 
-    String_t gameDir;
-    if (!params.arg_gamedir.get(gameDir)) {
-        errorExit(tx("missing directory name"));
+    // Serve sessions until the router discards us.
+    // A session that ends with QUIT returns the process to the pool (see server::router::Session::recycle());
+    // everything belonging to that session is destroyed before the next one starts.
+    while (1) {
+        standardOutput().writeLine("101 ready");
+        standardOutput().flush();
+
+        afl::data::StringList_t args;
+        if (!readPoolAssignment(*reader, args)) {
+            // Router discarded us
+            return;
+        }
+
+        // Parameters: pool parameters, plus the assigned ones
+        Parameters params;
+        m_properties.clear();
+        parseCommandLine(params, environment().getCommandLine());
+        params.arg_snapshot = afl::base::Nothing;
+        params.poolSnapshot = poolSnapshot;
+        if (parseCommandLine(params, afl::base::Ref<afl::base::Enumerator<String_t> >(*new ArgumentList(args)))) {
+            errorExit(tx("too many arguments"));
+        }
+
+        if (!runSession(params, *reader)) {
+            return;
+        }
     }
+}
+
+// Run a session. Returns true if the session ended with QUIT, false if the input was closed.
+bool
+server::play::ConsoleApplication::runSession(const Parameters& params, afl::io::TextReader& reader)
+{
+    afl::string::Translator& tx = translator();
 
     // Central logger
     util::MessageCollector logCollector;
 
-    // Make a session
+    // Make a session.
     game::Session session(tx, fileSystem());
     session.log().addListener(logCollector);
 
+    String_t snapshotName;
+    if (params.arg_makeSnapshot.get(snapshotName)) {
+        // Snapshot mode: ROOTDIR is the only parameter
+        if (params.playerNumber != 0 || params.arg_rootdir.isValid()) {
+            errorExit(tx("too many arguments"));
+        }
+        afl::io::FileSystem& fs = fileSystem();
+        String_t defaultRoot = fs.makePathName(fs.makePathName(environment().getInstallationDirectoryName(), "share"), "specs");
+        util::DirectorySnapshot::save(*fs.openDirectory(params.arg_gamedir.orElse(defaultRoot)), *fs.openFile(snapshotName, afl::io::FileSystem::Create));
+        standardOutput().writeLine("100 snapshot created");
+        return false;
+    }
+
+    if (params.arg_snapshot.isValid() && params.arg_rootdir.isValid()) {
+        errorExit(tx("-S cannot be combined with ROOTDIR"));
+    }
+
+    if (params.playerNumber == 0) {
+        errorExit(tx("missing player number"));
+    }
+
+    String_t gameDir;
+    if (!params.arg_gamedir.get(gameDir)) {
+        errorExit(tx("missing directory name"));
+    }
+
     // Check game data
     afl::base::Ptr<game::Root> root = loadRoot(gameDir, params, session.log());
     if (root.get() == 0 || root->getTurnLoader().get() == 0) {
@@ -172,17 +224,16 @@ server::play::ConsoleApplication::appMain()
         afl::io::TextWriter& m_out;
     };
 
-    afl::base::Ref<afl::io::TextReader> reader = environment().attachTextReader(afl::sys::Environment::Input);
-
     Sink sink(standardOutput());
     GameAccess impl(session, logCollector);
     server::interface::GameAccessServer server(impl);
     bool stop = server.handleOpening(sink);
+    bool quit = false;
     while (!stop) {
         standardOutput().flush();
         String_t line;
-        if (reader->readLine(line)) {
-            stop = server.handleLine(line, sink);
+        if (reader.readLine(line)) {
+            stop = quit = server.handleLine(line, sink);
         } else {
             server.handleConnectionClose();
             stop = true;
@@ -190,6 +241,95 @@ server::play::ConsoleApplication::appMain()
     }
 
     impl.save();
+    if (quit) {
+        // Confirm to router that session data is saved
+        standardOutput().writeLine("100 session closed");
+        standardOutput().flush();
+    }
+    return quit;
+}
+
+// Parse command line into parameters. Returns true if pool mode was requested.
+bool
+server::play::ConsoleApplication::parseCommandLine(Parameters& params, afl::base::Ref<afl::base::Enumerator<String_t> > args)
+{
+    afl::string::Translator& tx = translator();
+    afl::sys::StandardCommandLineParser commandLine(args);
+    String_t p;
+    bool opt;
+    bool poolMode = false;
+    while (commandLine.getNext(opt, p)) {
+        if (opt) {
+            if (p == "h" || p == "help") {
+                help();
+            } else if (p == "pool") {
+                // pool mode
+                poolMode = true;
+            } else if (p == "C") {
+                // character set
+                if (afl::charset::Charset* cs = util::CharsetFactory().createCharset(commandLine.getRequiredParameter(p))) {
+                    params.gameCharset.reset(cs);
+                } else {
+                    errorExit(tx("the specified character set is not known"));
+                }
+            } else if (p == "S") {
+                // specification snapshot
+                params.arg_snapshot = commandLine.getRequiredParameter(p);
+            } else if (p == "M") {
+                // make specification snapshot
+                params.arg_makeSnapshot = commandLine.getRequiredParameter(p);
+            } else if (p == "R" || p == "W") {
+                // session conflict management; skip those
+                commandLine.getRequiredParameter(p);
+            } else if (p == "D") {
+                // property
+                String_t key = commandLine.getRequiredParameter(p);
+                String_t value;
+                String_t::size_type eq = key.find('=');
+                if (eq != String_t::npos) {
+                    value.assign(key, eq+1, String_t::npos);
+                    key.erase(eq);
+                }
+                m_properties[key] = value;
+            } else {
+                errorExit(Format(tx("invalid option '%s' specified. Use '%s -h' for help."), p, environment().getInvocationName()));
+            }
+        } else {
+            int n;
+            if (afl::string::strToInteger(p, n) && n > 0 && n <= game::MAX_PLAYERS) {
+                if (params.playerNumber != 0) {
+                    errorExit(tx("only one player number allowed"));
+                }
+                params.playerNumber = n;
+            } else if (!params.arg_gamedir.isValid()) {
+                params.arg_gamedir = p;
+            } else if (!params.arg_rootdir.isValid()) {
+                params.arg_rootdir = p;
+            } else {
+                errorExit(tx("too many arguments"));
+            }
+        }
+    }
+    return poolMode;
+}
+
+// Read parameters assigned by router in pool mode. Returns false if the router closed the connection instead.
+bool
+server::play::ConsoleApplication::readPoolAssignment(afl::io::TextReader& reader, afl::data::StringList_t& args)
+{
+    // Expect "START <n>", followed by n lines containing one parameter each
+    String_t line;
+    size_t n;
+    if (!reader.readLine(line) || line.compare(0, 6, "START ", 6) != 0 || !afl::string::strToInteger(line.substr(6), n)) {
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (!reader.readLine(line)) {
+            return false;
+        }
+        args.push_back(line);
+    }
+    return true;
 }
 
 void
@@ -199,8 +339,11 @@ server::play::ConsoleApplication::help()
     const String_t options =
         util::formatOptions(tx("Options:\n"
                                "-Ccs\tSet game character set\n"
+                               "-Sfile\tUse specification snapshot instead of ROOTDIR\n"
+                               "-Mfile\tCreate specification snapshot of ROOTDIR and exit\n"
                                "-Rkey, -Wkey\tIgnored; used for session conflict resolution\n"
-                               "-Dkey=value\tDefine a property\n"));
+                               "-Dkey=value\tDefine a property\n"
+                               "--pool\tStart idle; wait for parameters from router\n"));
 
     afl::io::TextWriter& out = standardOutput();
     out.writeLine(Format(tx("PCC2 Play Server v%s - (c) 2019-2024 Stefan Reuther").c_str(), PCC2_VERSION));
@@ -208,6 +351,8 @@ server::play::ConsoleApplication::help()
     out.writeLine(Format(tx("Usage:\n"
                             "  %s [-h]\n"
                             "  %$0s [-OPTIONS] PLAYER GAMEDIR [ROOTDIR]\n"
+                            "  %$0s -Mfile [ROOTDIR]\n"
+                            "  %$0s --pool [-OPTIONS]\n"
                             "\n"
                             "GAMEDIR can be a local directory, or c2file://USER@HOST:PORT/DIR.\n\n"
                             "%s"
@@ -224,14 +369,24 @@ server::play::ConsoleApplication::loadRoot(const String_t& gameDir, const Parame
     afl::io::FileSystem& fs = fileSystem();
     afl::string::Translator& tx = translator();
     String_t defaultRoot = fs.makePathName(fs.makePathName(environment().getInstallationDirectoryName(), "share"), "specs");
-    afl::base::Ref<afl::io::Directory> rootDir = fs.openDirectory(params.arg_rootdir.orElse(defaultRoot));
+
+    // Specification directory: explicit snapshot, explicit ROOTDIR, pool snapshot, default
+    String_t snapshotName;
+    afl::base::Ptr<afl::io::Directory> rootDir;
+    if (params.arg_snapshot.get(snapshotName)) {
+        rootDir = loadSnapshot(snapshotName).asPtr();
+    } else if (params.arg_rootdir.isValid() || params.poolSnapshot.get() == 0) {
+        rootDir = fs.openDirectory(params.arg_rootdir.orElse(defaultRoot)).asPtr();
+    } else {
+        rootDir = params.poolSnapshot;
+    }
 
     // Try to parse as URL
     afl::net::Url url;
     if (url.parse(gameDir)) {
         if (url.getScheme() == "c2file") {
             afl::base::Ref<server::play::fs::Session> session(server::play::fs::Session::create(m_network, url.getName(afl::string::Format("%d", FILE_PORT)), url.getUser()));
-            return session->createRoot(url.getPath(), tx, log, m_nullFileSystem, rootDir, *params.gameCharset);
+            return session->createRoot(url.getPath(), tx, log, m_nullFileSystem, *rootDir, *params.gameCharset);
         }
     }
 
@@ -239,10 +394,17 @@ server::play::ConsoleApplication::loadRoot(const String_t& gameDir, const Parame
     // The FileSystem instance is used for accessing backups according to path names generated from configuration.
     // Although, as far as I can tell, these configuration items (Backup.Turn etc.) cannot be accessed in a c2play-server instance,
     // we block this possible hole by passing a NullFileSystem.
-    game::v3::RootLoader loader(rootDir, 0 /* profile */, 0 /* callback */, tx, log, m_nullFileSystem);
+    game::v3::RootLoader loader(*rootDir, 0 /* profile */, 0 /* callback */, tx, log, m_nullFileSystem);
 
     // Check game data
     // FIXME: load correct config!
     const game::config::UserConfiguration uc;
     return loader.load(fs.openDirectory(gameDir), *params.gameCharset, uc, false);
 }
+
+// Load a specification snapshot (-S).
+afl::base::Ref<afl::io::Directory>
+server::play::ConsoleApplication::loadSnapshot(const String_t& fileName)
+{
+    return util::DirectorySnapshot::load(fileSystem().openFile(fileName, afl::io::FileSystem::OpenRead)->createVirtualMapping(), fileName, translator());
+}
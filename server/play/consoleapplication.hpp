@@ -5,7 +5,12 @@
 #define C2NG_SERVER_PLAY_CONSOLEAPPLICATION_HPP
 
 #include <map>
+#include "afl/base/enumerator.hpp"
 #include "afl/base/ptr.hpp"
+#include "afl/base/ref.hpp"
+#include "afl/data/stringlist.hpp"
+#include "afl/io/directory.hpp"
+#include "afl/io/textreader.hpp"
 #include "afl/io/nullfilesystem.hpp"
 #include "afl/net/networkstack.hpp"
 #include "game/root.hpp"
@@ -23,12 +28,16 @@ namespace server { namespace play {
         struct Parameters;
 
         void help();
+        bool parseCommandLine(Parameters& params, afl::base::Ref<afl::base::Enumerator<String_t> > args);
+        bool readPoolAssignment(afl::io::TextReader& reader, afl::data::StringList_t& args);
+        bool runSession(const Parameters& params, afl::io::TextReader& reader);
 
         afl::net::NetworkStack& m_network;
         std::map<String_t, String_t> m_properties;
         afl::io::NullFileSystem m_nullFileSystem;
 
         afl::base::Ptr<game::Root> loadRoot(const String_t& gameDir, const Parameters& params, afl::sys::LogListener& log);
+        afl::base::Ref<afl::io::Directory> loadSnapshot(const String_t& fileName);
     };
 
 } }
@@ -0,0 +1,65 @@
+/**
+  *  \file server/play/deltapacker.cpp
+  *  \brief Class server::play::DeltaPacker
+  */
+
+#include "server/play/deltapacker.hpp"
+#include "afl/data/hash.hpp"
+#include "afl/data/hashvalue.hpp"
+#include "afl/data/vector.hpp"
+#include "afl/data/vectorvalue.hpp"
+#include "server/types.hpp"
+
+// Constructor.
+server::play::DeltaPacker::DeltaPacker(const ChangeTracker* tracker, ChangeTracker::Kind kind, ChangeTracker::Version_t since)
+    : m_tracker(tracker),
+      m_kind(kind),
+      m_since(since)
+{ }
+
+// Build value.
+server::Value_t*
+server::play::DeltaPacker::buildValue() const
+{
+    if (m_tracker == 0) {
+        return buildFullList();
+    }
+
+    afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
+    hv->setNew("VERSION", makeIntegerValue(m_tracker->getVersion()));
+
+    // Try delta. A delta entry is about twice the size of a full entry (Id, and array overhead),
+    // so give up if more than half of the objects changed.
+    const game::Id_t maxId = getMaxId();
+    std::vector<game::Id_t> ids;
+    if (m_tracker->getChanges(m_kind, m_since, ids) && ids.size() <= size_t(maxId) / 2) {
+        afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
+        for (size_t i = 0, n = ids.size(); i < n; ++i) {
+            afl::base::Ref<afl::data::Vector> pair(afl::data::Vector::create());
+            pair->pushBackInteger(ids[i]);
+            pair->pushBackNew(ids[i] <= maxId ? buildObject(ids[i]) : 0);
+            vv->pushBackNew(new afl::data::VectorValue(pair));
+        }
+        hv->setNew("FULL", makeIntegerValue(0));
+        hv->setNew("CHANGED", new afl::data::VectorValue(vv));
+    } else {
+        hv->setNew("FULL", makeIntegerValue(1));
+        hv->setNew("DATA", buildFullList());
+    }
+    return new afl::data::HashValue(hv);
+}
+
+/** Build full list.
+    \return newly-allocated array indexed by Id */
+server::Value_t*
+server::play::DeltaPacker::buildFullList() const
+{
+    afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
+
+    // Note: iteration starts at 0 so JSON can be indexed with Ids
+    vv->pushBackNew(0);
+    for (game::Id_t i = 1, n = getMaxId(); i <= n; ++i) {
+        vv->pushBackNew(buildObject(i));
+    }
+    return new afl::data::VectorValue(vv);
+}
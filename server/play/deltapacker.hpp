@@ -0,0 +1,57 @@
+/**
+  *  \file server/play/deltapacker.hpp
+  *  \brief Class server::play::DeltaPacker
+  */
+#ifndef C2NG_SERVER_PLAY_DELTAPACKER_HPP
+#define C2NG_SERVER_PLAY_DELTAPACKER_HPP
+
+#include "server/play/changetracker.hpp"
+#include "server/play/packer.hpp"
+
+namespace server { namespace play {
+
+    /** Base class for an object list that supports delta transmission.
+
+        Without a ChangeTracker, produces an array indexed by object Id (index 0 is null),
+        containing one entry per object (null for objects that do not exist).
+
+        With a ChangeTracker and the version the client has, produces a hash:
+        - VERSION: current version; the client uses this as the base for its next request
+        - FULL: 1 if this is a full list, 0 if this is a delta
+        - DATA (full list only): array indexed by object Id, as above
+        - CHANGED (delta only): array of [Id, value] pairs, value is null for objects that no longer exist
+
+        A full list is sent if the tracker cannot provide the changes,
+        or if the delta would not be smaller than the full list. */
+    class DeltaPacker : public Packer {
+     public:
+        /** Constructor.
+            \param tracker ChangeTracker; null to always produce a plain array
+            \param kind    Kind of object list
+            \param since   Version the client has (ignored if tracker is null) */
+        DeltaPacker(const ChangeTracker* tracker, ChangeTracker::Kind kind, ChangeTracker::Version_t since);
+
+        // Packer:
+        virtual Value_t* buildValue() const;
+
+     protected:
+        /** Get highest object Id.
+            \return Id */
+        virtual game::Id_t getMaxId() const = 0;
+
+        /** Build value for one object.
+            \param id Object Id [1,getMaxId()]
+            \return newly-allocated value; null if object does not exist */
+        virtual Value_t* buildObject(game::Id_t id) const = 0;
+
+     private:
+        const ChangeTracker* m_tracker;
+        ChangeTracker::Kind m_kind;
+        ChangeTracker::Version_t m_since;
+
+        Value_t* buildFullList() const;
+    };
+
+} }
+
+#endif
@@ -10,6 +10,7 @@
 #include "afl/string/format.hpp"
 #include "game/actions/preconditions.hpp"
 #include "server/errors.hpp"
+#include "server/play/changetracker.hpp"
 #include "server/play/basichullfunctionpacker.hpp"
 #include "server/play/beampacker.hpp"
 #include "server/play/commandhandler.hpp"
@@ -50,7 +51,8 @@ using game::actions::mustHaveShipList;
 server::play::GameAccess::GameAccess(game::Session& session, util::MessageCollector& console)
     : m_session(session),
       m_console(console),
-      m_lastMessage(0)
+      m_lastMessage(0),
+      m_changeTracker()
 { }
 
 void
@@ -96,6 +98,8 @@ server::play::GameAccess::getStatus()
 server::Value_t*
 server::play::GameAccess::get(String_t objName)
 {
+    m_changeTracker.update(m_session);
+
     util::StringParser p(objName);
     if (p.parseString("obj/")) {
         return getObject(p);
@@ -148,6 +152,7 @@ server::play::GameAccess::post(String_t objName, const Value_t* value)
     }
 
     // Generate output
+    m_changeTracker.update(m_session);
     return result.buildValue();
 }
 
@@ -203,10 +208,18 @@ server::play::GameAccess::createPacker(util::StringParser& p)
     // ex server/getobj.cc:createWriter
     game::Session& session = m_session;
     int n;
+    bool isDelta;
+    ChangeTracker::Version_t version;
     if (p.parseString("shipxy")) {
-        return new ShipXYPacker(session);
+        if (!parseVersion(p, isDelta, version)) {
+            return 0;
+        }
+        return isDelta ? new ShipXYPacker(session, m_changeTracker, version) : new ShipXYPacker(session);
     } else if (p.parseString("planetxy")) {
-        return new PlanetXYPacker(session);
+        if (!parseVersion(p, isDelta, version)) {
+            return 0;
+        }
+        return isDelta ? new PlanetXYPacker(session, m_changeTracker, version) : new PlanetXYPacker(session);
     } else if (p.parseString("main")) {
         return new MainPacker(session);
     } else if (p.parseString("player")) {
@@ -254,6 +267,23 @@ server::play::GameAccess::createPacker(util::StringParser& p)
     }
 }
 
+bool
+server::play::GameAccess::parseVersion(util::StringParser& p, bool& isDelta, ChangeTracker::Version_t& version)
+{
+    // Optional "@N" suffix
+    int n;
+    if (!p.parseCharacter('@')) {
+        isDelta = false;
+        return true;
+    } else if (p.parseInt(n)) {
+        isDelta = true;
+        version = n < 0 ? 0 : ChangeTracker::Version_t(n);
+        return true;
+    } else {
+        return false;
+    }
+}
+
 server::play::Packer*
 server::play::GameAccess::createQueryPacker(util::StringParser& p, game::Session& session)
 {
@@ -8,6 +8,7 @@
 #include <map>
 #include "server/interface/gameaccess.hpp"
 #include "game/session.hpp"
+#include "server/play/changetracker.hpp"
 #include "util/messagecollector.hpp"
 #include "util/stringparser.hpp"
 
@@ -17,7 +18,10 @@ namespace server { namespace play {
     class CommandHandler;
 
     /** Implementation of GameAccess interface.
-        Published properties of a game::Session. */
+        Published properties of a game::Session.
+
+        Object lists "shipxy" and "planetxy" can be requested as "shipxy@N", "planetxy@N",
+        to receive only the changes since version N (see DeltaPacker). */
     class GameAccess : public server::interface::GameAccess {
      public:
         /** Constructor.
@@ -35,11 +39,13 @@ namespace server { namespace play {
         game::Session& m_session;
         util::MessageCollector& m_console;
         util::MessageCollector::MessageNumber_t m_lastMessage;
+        ChangeTracker m_changeTracker;
 
         Value_t* getObject(util::StringParser& p);
         Value_t* getQuery(util::StringParser& p);
 
         Packer* createPacker(util::StringParser& p);
+        bool parseVersion(util::StringParser& p, bool& isDelta, ChangeTracker::Version_t& version);
         static Packer* createQueryPacker(util::StringParser& p, game::Session& session);
         static CommandHandler* createCommandHandler(util::StringParser& p, game::Session& session);
     };
@@ -4,18 +4,29 @@
 #ifndef C2NG_SERVER_PLAY_PLANETXYPACKER_HPP
 #define C2NG_SERVER_PLAY_PLANETXYPACKER_HPP
 
-#include "server/play/packer.hpp"
+#include "server/play/deltapacker.hpp"
 #include "game/session.hpp"
 
 namespace server { namespace play {
 
-    class PlanetXYPacker : public Packer {
+    class PlanetXYPacker : public DeltaPacker {
      public:
+        /** Constructor for full list.
+            \param session Session */
         PlanetXYPacker(game::Session& session);
 
-        Value_t* buildValue() const;
+        /** Constructor for delta list.
+            \param session Session
+            \param tracker ChangeTracker
+            \param since   Version the client has */
+        PlanetXYPacker(game::Session& session, const ChangeTracker& tracker, ChangeTracker::Version_t since);
+
         String_t getName() const;
 
+     protected:
+        game::Id_t getMaxId() const;
+        Value_t* buildObject(game::Id_t id) const;
+
      private:
         game::Session& m_session;
     };
@@ -5,8 +5,6 @@
 #include "server/play/shipxypacker.hpp"
 #include "afl/data/hash.hpp"
 #include "afl/data/hashvalue.hpp"
-#include "afl/data/vector.hpp"
-#include "afl/data/vectorvalue.hpp"
 #include "game/actions/preconditions.hpp"
 #include "game/game.hpp"
 #include "game/interface/shipcontext.hpp"
@@ -14,40 +12,50 @@
 #include "game/turn.hpp"
 
 server::play::ShipXYPacker::ShipXYPacker(game::Session& session)
-    : m_session(session)
+    : DeltaPacker(0, ChangeTracker::Ships, 0),
+      m_session(session)
 { }
 
+server::play::ShipXYPacker::ShipXYPacker(game::Session& session, const ChangeTracker& tracker, ChangeTracker::Version_t since)
+    : DeltaPacker(&tracker, ChangeTracker::Ships, since),
+      m_session(session)
+{ }
+
+String_t
+server::play::ShipXYPacker::getName() const
+{
+    return "shipxy";
+}
+
+game::Id_t
+server::play::ShipXYPacker::getMaxId() const
+{
+    // Check all preconditions here, so we fail even if there are no ships
+    game::actions::mustHaveRoot(m_session);
+    game::actions::mustHaveShipList(m_session);
+    return game::actions::mustHaveGame(m_session).currentTurn().universe().ships().size();
+}
+
 server::Value_t*
-server::play::ShipXYPacker::buildValue() const
+server::play::ShipXYPacker::buildObject(game::Id_t id) const
 {
-    // ex ServerShipxyWriter::write
+    // ex ServerShipxyWriter::write (part)
     game::Game& g = game::actions::mustHaveGame(m_session);
     game::Turn& t = g.currentTurn();
     game::Root& r = game::actions::mustHaveRoot(m_session);
     game::spec::ShipList& sl = game::actions::mustHaveShipList(m_session);
 
-    afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
-    game::map::AnyShipType& ty(t.universe().allShips());
-    for (int i = 0, n = t.universe().ships().size(); i <= n; ++i) {
-        if (ty.getObjectByIndex(i) != 0) {
-            afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
-            game::interface::ShipContext ctx(i, m_session, r, g, g.currentTurn(), sl);
-            addValue(*hv, ctx, "LOC.X", "X");
-            addValue(*hv, ctx, "LOC.Y", "Y");
-            addValue(*hv, ctx, "MASS", "MASS");
-            addValue(*hv, ctx, "NAME", "NAME");
-            addValue(*hv, ctx, "OWNER$", "OWNER");
-            addValue(*hv, ctx, "PLAYED", "PLAYED");
-            vv->pushBackNew(new afl::data::HashValue(hv));
-        } else {
-            vv->pushBackNew(0);
-        }
+    if (t.universe().allShips().getObjectByIndex(id) != 0) {
+        afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
+        game::interface::ShipContext ctx(id, m_session, r, g, t, sl);
+        addValue(*hv, ctx, "LOC.X", "X");
+        addValue(*hv, ctx, "LOC.Y", "Y");
+        addValue(*hv, ctx, "MASS", "MASS");
+        addValue(*hv, ctx, "NAME", "NAME");
+        addValue(*hv, ctx, "OWNER$", "OWNER");
+        addValue(*hv, ctx, "PLAYED", "PLAYED");
+        return new afl::data::HashValue(hv);
+    } else {
+        return 0;
     }
-    return new afl::data::VectorValue(vv);
-}
-
-String_t
-server::play::ShipXYPacker::getName() const
-{
-    return "shipxy";
 }
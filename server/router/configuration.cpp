@@ -10,5 +10,7 @@ server::router::Configuration::Configuration()
       normalTimeout(10000),
       virginTimeout(60),
       maxSessions(10),
-      newSessionsWin(false)
+      newSessionsWin(false),
+      poolSize(0),
+      specSnapshot()
 { }
@@ -29,6 +29,14 @@ namespace server { namespace router {
 
         /** true if new sessions displace old ones (Router.NewSessionsWin). */
         bool newSessionsWin;               // ex arg_newsessionswin
+
+        /** Number of idle pre-started server processes to keep (Router.PoolSize).
+            Pooled processes count against maxSessions. */
+        size_t poolSize;
+
+        /** Specification snapshot file (Router.SpecSnapshot).
+            If nonempty, the router creates it at startup, and passes it to pooled processes ("-S"). */
+        String_t specSnapshot;
     };
 
 } }
@@ -8,6 +8,7 @@
 #include "server/router/session.hpp"
 #include "server/errors.hpp"
 #include "afl/string/format.hpp"
+#include "util/process/subprocess.hpp"
 
 namespace {
     const char*const LOG_NAME = "router";
@@ -22,11 +23,14 @@ server::router::Root::Root(util::process::Factory& factory,
       m_generator(gen),
       m_pFileBase(pFileBase),
       m_config(config),
-      m_sessions()
+      m_sessions(),
+      m_pool()
 { }
 
 server::router::Root::~Root()
-{ }
+{
+    stopAllSessions();
+}
 
 afl::sys::Log&
 server::router::Root::log()
@@ -68,10 +72,14 @@ server::router::Root::createSession(afl::base::Memory<const String_t> args)
     }
 
     // Start the session
-    if (!p->start(m_config.serverPath)) {
+    if (!startSession(*p)) {
         throw std::runtime_error(CANNOT_START_SESSION);
     }
-    return *m_sessions.pushBackNew(p.release());
+    Session& result = *m_sessions.pushBackNew(p.release());
+
+    // Replace the pooled process we may have used
+    fillPool();
+    return result;
 }
 
 void
@@ -123,7 +131,13 @@ server::router::Root::removeExpiredSessions()
                     const int64_t expired = (now - ps->getLastAccessTime()).getMilliseconds() / 1000;
                     if (expired >= timeout) {
                         m_log.write(afl::sys::LogListener::Info, LOG_NAME, afl::string::Format("session %d timed out", ps->getId()));
-                        ps->stop();
+                        if (m_pool.size() < m_config.poolSize) {
+                            if (util::process::Subprocess* p = ps->recycle().release()) {
+                                m_pool.pushBackNew(p);
+                            }
+                        } else {
+                            ps->stop();
+                        }
                     }
                 }
             }
@@ -140,6 +154,9 @@ server::router::Root::removeExpiredSessions()
             ++in;
         }
         m_sessions.resize(out);
+
+        // Pass 3: replenish pool
+        fillPool();
     }
     catch (std::exception& e)
     {
@@ -157,4 +174,98 @@ server::router::Root::stopAllSessions()
         }
     }
     m_sessions.clear();
+
+    for (size_t i = 0, n = m_pool.size(); i < n; ++i) {
+        if (util::process::Subprocess* p = m_pool[i]) {
+            p->stop();
+        }
+    }
+    m_pool.clear();
+}
+
+void
+server::router::Root::fillPool()
+{
+    // Remove dead processes
+    size_t in = 0, out = 0;
+    while (in < m_pool.size()) {
+        if (m_pool[in] != 0 && m_pool[in]->isActive()) {
+            m_pool.swapElements(in, out);
+            ++out;
+        }
+        ++in;
+    }
+    m_pool.resize(out);
+
+    // Start new ones. Do not wait for them to come up; that is checked when a process is assigned to a session.
+    while (m_pool.size() < m_config.poolSize && m_sessions.size() + m_pool.size() < m_config.maxSessions) {
+        std::auto_ptr<util::process::Subprocess> p(m_factory.createNewProcess());
+        String_t args[] = { "--pool", "-S", m_config.specSnapshot };
+        afl::base::Memory<const String_t> argList(args);
+        if (m_config.specSnapshot.empty()) {
+            argList.trim(1);
+        }
+        if (!p->start(m_config.serverPath, argList)) {
+            m_log.write(afl::sys::LogListener::Warn, LOG_NAME, afl::string::Format("pool process failed to start: %s", p->getStatus()));
+            break;
+        }
+        m_pool.pushBackNew(p.release());
+    }
+}
+
+bool
+server::router::Root::createSpecSnapshot()
+{
+    if (m_config.specSnapshot.empty()) {
+        return false;
+    }
+
+    // Server reports success with a "100" line, and exits.
+    std::auto_ptr<util::process::Subprocess> p(m_factory.createNewProcess());
+    String_t args[] = { "-M", m_config.specSnapshot };
+    bool ok = false;
+    if (p->start(m_config.serverPath, args)) {
+        String_t line;
+        while (p->readLine(line)) {
+            if (line.compare(0, 3, "100", 3) == 0) {
+                ok = true;
+            }
+        }
+        p->stop();
+    }
+
+    if (ok) {
+        m_log.write(afl::sys::LogListener::Info, LOG_NAME, afl::string::Format("created specification snapshot '%s'", m_config.specSnapshot));
+    } else {
+        m_log.write(afl::sys::LogListener::Warn, LOG_NAME, afl::string::Format("unable to create specification snapshot '%s': %s", m_config.specSnapshot, p->getStatus()));
+        m_config.specSnapshot.clear();
+    }
+    return ok;
+}
+
+size_t
+server::router::Root::getPoolSize() const
+{
+    return m_pool.size();
+}
+
+bool
+server::router::Root::startSession(Session& s)
+{
+    // Try pooled processes first; a process that fails to take the session is discarded.
+    // If the session itself fails, report that immediately instead of trying (and using up) more processes.
+    // Sessions whose parameters cannot be passed to a pooled process are started normally.
+    if (s.canStartFromPool()) {
+        while (!m_pool.empty()) {
+            switch (s.start(std::auto_ptr<util::process::Subprocess>(m_pool.extractLast()))) {
+             case Session::PoolStarted:
+                return true;
+             case Session::PoolSessionFailed:
+                return false;
+             case Session::PoolProcessFailed:
+                break;
+            }
+        }
+    }
+    return s.start(m_config.serverPath);
 }
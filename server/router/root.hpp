@@ -42,6 +42,22 @@ namespace server { namespace router {
 
         void stopAllSessions();
 
+        /** Fill the process pool.
+            Starts server processes in pool mode until Configuration::poolSize idle processes are available,
+            as long as the total number of sessions and idle processes does not exceed Configuration::maxSessions.
+            Processes that have died are removed. */
+        void fillPool();
+
+        /** Create specification snapshot.
+            If Configuration::specSnapshot is set, runs the server to create that file ("-M").
+            On failure, the snapshot is disabled, and pooled processes are started without it.
+            \return true if snapshot was created */
+        bool createSpecSnapshot();
+
+        /** Get number of idle processes in pool.
+            \return number of processes */
+        size_t getPoolSize() const;
+
      private:
         afl::sys::Log m_log;
 
@@ -54,6 +70,10 @@ namespace server { namespace router {
         Configuration m_config;
 
         Sessions_t m_sessions;
+
+        afl::container::PtrVector<util::process::Subprocess> m_pool;
+
+        bool startSession(Session& s);
     };
 
 } }
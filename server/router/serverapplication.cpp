@@ -100,6 +100,8 @@ server::router::ServerApplication::serverMain()
     // Set up root (global data)
     Root root(m_factory, *m_generator, m_config, pFileBase);
     root.log().addListener(log());
+    root.createSpecSnapshot();
+    root.fillPool();
 
     // Protocol Handler
     SessionRouter impl(root);
@@ -187,6 +189,32 @@ server::router::ServerApplication::handleConfiguration(const String_t& key, cons
             throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
         }
         return true;
+    } else if (key == "ROUTER.POOLSIZE") {
+        /* @q Router.PoolSize:Int (Config)
+           Number of idle %c2server (c2play-server) processes to keep running.
+           A new session is assigned to such a pre-started process, saving the process startup time.
+           Idle processes count against {Router.MaxSessions}, but are not subject to timeouts.
+           When a session started from the pool times out, its process saves the session, discards it,
+           and returns to the pool if there is room.
+           0 (default) disables the pool.
+           @since PCC2 2.40.13 */
+        size_t n;
+        if (afl::string::strToInteger(value, n)) {
+            m_config.poolSize = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
+    } else if (key == "ROUTER.SPECSNAPSHOT") {
+        /* @q Router.SpecSnapshot:Str (Config)
+           File name of a specification snapshot.
+           If set, the router creates this file at startup from the default specification directory of %c2server (c2play-server),
+           and pooled processes (see {Router.PoolSize}) map it before being assigned a session.
+           Sessions that specify their own specification directory do not use it.
+           Specification files in the game directory still take precedence over the snapshot.
+           @since PCC2 2.40.13 */
+        m_config.specSnapshot = value;
+        return true;
     } else if (key == "ROUTER.FILENOTIFY") {
         /* @q Router.FileNotify:Str (Config)
            If "y" or "1", the {SAVE (Router Command)|SAVE} command will notify the {File (Service)|file server}. */
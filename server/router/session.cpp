@@ -71,6 +71,8 @@ server::router::Session::Session(util::process::Factory& factory, afl::base::Mem
       m_lastAccessTime(afl::sys::Time::getCurrentTime()),
       m_isModified(false),
       m_isUsed(false),
+      m_isPooled(false),
+      m_factory(factory),
       m_process(factory.createNewProcess())
 {
     // ex RouterSession::RouterSession, parseArgs
@@ -174,30 +176,67 @@ server::router::Session::checkConflict(const String_t& query, bool queryIsWild)
 bool
 server::router::Session::start(const String_t& serverPath)
 {
-    logCommandLine();
+    logCommandLine("starting");
+    m_isPooled = false;
     bool ok = m_process->start(serverPath, m_args);
     if (ok) {
-        // Wait for child to start up. It will write a "hello" message with a "100" code, or some error messages.
-        String_t greeting;
-        if (readLine(greeting) && greeting.compare(0, 3, "100", 3) == 0) {
-            // Looks like a success message
-            logProcess(afl::sys::LogListener::Info, "started");
-        } else {
-            // Looks like a failure message
-            logProcess(afl::sys::LogListener::Warn, "failed to start");
-            do {
-                util::removeTrailingCharacter(greeting, '\n');
-                m_log.write(afl::sys::LogListener::Trace, LOG_NAME, greeting);
-            } while (readLine(greeting));
-            stop();
-            ok = false;
-        }
+        ok = waitForGreeting();
     } else {
         m_log.write(afl::sys::LogListener::Warn, LOG_NAME, afl::string::Format("[%s] failed to start: %s", m_id, m_process->getStatus()));
     }
     return ok;
 }
 
+// Check whether this session can be started using a pre-started process.
+bool
+server::router::Session::canStartFromPool() const
+{
+    for (size_t i = 0, n = m_args.size(); i < n; ++i) {
+        if (m_args[i].find_first_of("\r\n") != String_t::npos) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Start this session using a pre-started process.
+server::router::Session::PoolResult
+server::router::Session::start(std::auto_ptr<util::process::Subprocess> process)
+{
+    stop();
+    m_process = process;
+    m_isPooled = true;
+    logCommandLine("starting from pool");
+
+    // A line break in a parameter would break the framing and allow injecting commands.
+    if (!canStartFromPool()) {
+        logProcess(afl::sys::LogListener::Warn, "parameters cannot be passed to pooled process");
+        stop();
+        return PoolSessionFailed;
+    }
+
+    // Pooled process announces itself with "101", then expects "START <n>" followed by n parameters, one per line.
+    String_t line;
+    if (!readLine(line) || line.compare(0, 3, "101", 3) != 0) {
+        logProcess(afl::sys::LogListener::Warn, "pooled process not ready");
+        stop();
+        return PoolProcessFailed;
+    }
+    String_t command = afl::string::Format("START %d\n", m_args.size());
+    for (size_t i = 0, n = m_args.size(); i < n; ++i) {
+        command += m_args[i];
+        command += "\n";
+    }
+    if (!m_process->writeLine(command)) {
+        logProcess(afl::sys::LogListener::Warn, "write error (parameters)");
+        stop();
+        return PoolProcessFailed;
+    }
+
+    // The process has accepted the parameters; failure from now on is caused by the session.
+    return waitForGreeting() ? PoolStarted : PoolSessionFailed;
+}
+
 // Stop this session.
 void
 server::router::Session::stop()
@@ -212,6 +251,29 @@ server::router::Session::stop()
     }
 }
 
+// Stop this session, keeping the process for reuse if possible.
+std::auto_ptr<util::process::Subprocess>
+server::router::Session::recycle()
+{
+    // A pooled process saves upon QUIT, confirms with "100", and returns to pool mode (which will announce itself with "101").
+    std::auto_ptr<util::process::Subprocess> result;
+    if (m_isPooled && m_process->isActive()) {
+        logProcess(afl::sys::LogListener::Info, "recycling...");
+        String_t line;
+        if (m_process->writeLine("QUIT\n") && readLine(line) && line.compare(0, 3, "100", 3) == 0) {
+            notifyFileServer();
+            result = m_process;
+            m_process.reset(m_factory.createNewProcess());
+        } else {
+            logProcess(afl::sys::LogListener::Warn, "process cannot be recycled");
+        }
+    }
+    if (result.get() == 0) {
+        stop();
+    }
+    return result;
+}
+
 // Save this session.
 void
 server::router::Session::save(bool notify)
@@ -276,9 +338,9 @@ server::router::Session::talk(String_t command)
 }
 
 void
-server::router::Session::logCommandLine()
+server::router::Session::logCommandLine(const char* how)
 {
-    String_t msg = afl::string::Format("[%s] starting:", m_id);
+    String_t msg = afl::string::Format("[%s] %s:", m_id, how);
     for (size_t i = 0, n = m_args.size(); i < n; ++i) {
         msg += " ";
         msg += m_args[i];
@@ -310,6 +372,27 @@ server::router::Session::readLine(String_t& line)
     return m_process->readLine(line);
 }
 
+bool
+server::router::Session::waitForGreeting()
+{
+    // Wait for child to start up. It will write a "hello" message with a "100" code, or some error messages.
+    String_t greeting;
+    if (readLine(greeting) && greeting.compare(0, 3, "100", 3) == 0) {
+        // Looks like a success message
+        logProcess(afl::sys::LogListener::Info, "started");
+        return true;
+    } else {
+        // Looks like a failure message
+        logProcess(afl::sys::LogListener::Warn, "failed to start");
+        do {
+            util::removeTrailingCharacter(greeting, '\n');
+            m_log.write(afl::sys::LogListener::Trace, LOG_NAME, greeting);
+        } while (readLine(greeting));
+        stop();
+        return false;
+    }
+}
+
 void
 server::router::Session::readResponse(String_t& header, String_t& body)
 {
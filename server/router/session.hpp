@@ -80,9 +80,39 @@ namespace server { namespace router {
             \return true if session started successfully (process started; greeting received) */
         bool start(const String_t& serverPath);
 
+        /** Result of starting a session using a pre-started process. */
+        enum PoolResult {
+            PoolStarted,                 ///< Session started successfully (parameters accepted; greeting received).
+            PoolProcessFailed,           ///< Process did not accept a session (not ready, write error); another process can be tried.
+            PoolSessionFailed            ///< Session did not start (e.g. invalid parameters); another process will not help.
+        };
+
+        /** Check whether this session can be started using a pre-started process.
+            The parameters are passed to the process one per line, and therefore must not contain line breaks.
+            \return true if start(std::auto_ptr<util::process::Subprocess>) can be used */
+        bool canStartFromPool() const;
+
+        /** Start this session using a pre-started process.
+            The process must have been started in pool mode ("--pool", see Root::fillPool()).
+            It receives this session's parameters, and then proceeds like a regular start.
+            On success, the session takes over the process;
+            a session started this way can be restarted using start() as usual.
+            On failure, the process is stopped.
+            \param process Process (must be active)
+            \return result */
+        PoolResult start(std::auto_ptr<util::process::Subprocess> process);
+
         /** Stop this session. */
         void stop();
 
+        /** Stop this session, keeping the process for reuse.
+            If this session was started from a pooled process, asks the process to save and end the session,
+            upon which it returns to pool mode and can be passed to start(std::auto_ptr<util::process::Subprocess>) of another session.
+            Otherwise, or if that fails, the session is stopped normally.
+            In either case, the session is inactive afterwards.
+            \return process for reuse; null if none */
+        std::auto_ptr<util::process::Subprocess> recycle();
+
         /** Save this session.
             Submits a SAVE command to the server process.
             \param notify Notify file server */
@@ -101,15 +131,18 @@ namespace server { namespace router {
         afl::sys::Time m_lastAccessTime; // ex last_access
         bool m_isModified;               // ex used
         bool m_isUsed;                   // ex modified
+        bool m_isPooled;
 
+        util::process::Factory& m_factory;
         std::auto_ptr<util::process::Subprocess> m_process;
 
-        void logCommandLine();
+        void logCommandLine(const char* how);
         void logProcess(afl::sys::LogListener::Level level, const String_t& msg);
         void logProcess(afl::sys::LogListener::Level level, const String_t& msg, uint32_t pid);
 
         void setLastAccessTime();
         bool readLine(String_t& line);
+        bool waitForGreeting();
         void readResponse(String_t& header, String_t& body);
         void notifyFileServer();
         void handleError(const char* reason);
@@ -61,6 +61,26 @@ server::talk::CommandHandler::handleCommand(const String_t& upcasedCommand, inte
         result.reset(makeStringValue(getHelp(afl::string::strUCase(toString(args.getNext())))));
         ok = true;
     }
+    if (!ok && upcasedCommand == "SORTCACHEFLUSH") {
+        /* @q SORTCACHEFLUSH [fid:FID...] (Talk Command)
+           Discard cached sorted forum/thread listings, causing them to be rebuilt from the database on next use.
+           Use after modifying forums in the database without going through c2talk.
+           Without parameter, discards all listings; otherwise, discards listings of the given forums.
+           Requires admin permissions.
+           @retval Str "OK". */
+        if (!m_session.isAdmin()) {
+            throw std::runtime_error(PERMISSION_DENIED);
+        }
+        if (args.getNumArgs() == 0) {
+            m_root.sortCache().clear();
+        } else {
+            while (args.getNumArgs() > 0) {
+                m_root.sortCache().invalidate(toInteger(args.getNext()));
+            }
+        }
+        result.reset(makeStringValue("OK"));
+        ok = true;
+    }
     if (!ok && upcasedCommand == "USER") {
         /* @q USER user:UID (Talk Command)
            Set context (caller) for following commands on this connection. */
@@ -270,6 +290,7 @@ server::talk::CommandHandler::getHelp(String_t topic) const
         return "Commands:\n"
             "HELP [<topic>]\n"
             "PING\n"
+            "SORTCACHEFLUSH [<fid>...]\n"
             "USER <uid>\n"
             "FOLDER->\n"
             "FORUM->\n"
@@ -0,0 +1,215 @@
+/**
+  *  \file server/talk/notifier.cpp
+  *  \brief Class server::talk::Notifier
+  */
+
+#include "server/talk/notifier.hpp"
+#include "afl/base/stoppable.hpp"
+#include "afl/string/format.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/thread.hpp"
+#include "server/interface/mailqueueclient.hpp"
+#include "server/talk/forum.hpp"
+#include "server/talk/message.hpp"
+#include "server/talk/notify.hpp"
+#include "server/talk/permissionchecker.hpp"
+#include "server/talk/root.hpp"
+#include "server/talk/topic.hpp"
+
+namespace {
+    const char*const LOG_NAME = "talk.notify";
+}
+
+/******************************** Worker *******************************/
+
+class server::talk::Notifier::Worker : public afl::base::Stoppable {
+ public:
+    Worker(Notifier& parent, afl::net::CommandHandler& mail);
+    ~Worker();
+
+    virtual void run();
+    virtual void stop();
+
+ private:
+    void processBatch(const std::vector<int32_t>& messageIds);
+
+    Notifier& m_parent;
+    server::interface::MailQueueClient m_mailQueue;
+    afl::sys::Thread m_thread;
+};
+
+server::talk::Notifier::Worker::Worker(Notifier& parent, afl::net::CommandHandler& mail)
+    : m_parent(parent),
+      m_mailQueue(mail),
+      m_thread("talk.notify", *this)
+{
+    m_thread.start();
+}
+
+server::talk::Notifier::Worker::~Worker()
+{
+    m_thread.join();
+}
+
+void
+server::talk::Notifier::Worker::run()
+{
+    int32_t forumId;
+    std::vector<int32_t> messageIds;
+    while (m_parent.getWork(forumId, messageIds)) {
+        processBatch(messageIds);
+        m_parent.finishWork(forumId);
+        messageIds.clear();
+    }
+}
+
+void
+server::talk::Notifier::Worker::stop()
+{
+    m_parent.requestStop();
+}
+
+/* Process a batch of messages from one forum. */
+void
+server::talk::Notifier::Worker::processBatch(const std::vector<int32_t>& messageIds)
+{
+    // Permission checker is shared by the batch.
+    // Messages of a forum typically have the same permissions and watchers.
+    Root& root = m_parent.m_root;
+    PermissionChecker checker(root);
+    for (size_t i = 0, n = messageIds.size(); i < n; ++i) {
+        try {
+            Message msg(root, messageIds[i]);
+            if (msg.exists()) {
+                Topic topic(root, msg.topicId().get());
+                Forum forum(root, topic.forumId().get());
+                notifyMessage(msg, topic, forum, root, checker, m_mailQueue);
+            }
+        }
+        catch (std::exception& e) {
+            root.log().write(afl::sys::LogListener::Warn, LOG_NAME, afl::string::Format("Failed to send notifications for message %d", messageIds[i]), e);
+        }
+    }
+}
+
+/******************************* Notifier ******************************/
+
+// Constructor.
+server::talk::Notifier::Notifier(Root& root)
+    : m_root(root),
+      m_workers(),
+      m_wake(0),
+      m_idle(0),
+      m_mutex(),
+      m_stopRequest(false),
+      m_numIdleWaiters(0),
+      m_forumQueue(),
+      m_pendingMessages(),
+      m_busyForums()
+{ }
+
+// Destructor.
+server::talk::Notifier::~Notifier()
+{
+    requestStop();
+    m_workers.clear();
+}
+
+// Add a worker thread.
+void
+server::talk::Notifier::addWorker(afl::net::CommandHandler& mail)
+{
+    m_workers.pushBackNew(new Worker(*this, mail));
+}
+
+// Queue a forum message for notification.
+void
+server::talk::Notifier::notifyMessage(int32_t forumId, int32_t messageId)
+{
+    afl::sys::MutexGuard g(m_mutex);
+    std::vector<int32_t>& msgs = m_pendingMessages[forumId];
+    if (msgs.empty()) {
+        m_forumQueue.push_back(forumId);
+        m_wake.post();
+    }
+    msgs.push_back(messageId);
+}
+
+// Wait until all queued notifications have been processed.
+void
+server::talk::Notifier::waitIdle()
+{
+    {
+        afl::sys::MutexGuard g(m_mutex);
+        if (isIdle()) {
+            return;
+        }
+        ++m_numIdleWaiters;
+    }
+    m_idle.wait();
+}
+
+/* Get next batch of work: all pending messages of a forum that is not currently being processed.
+   Blocks until work is available. Returns false if the worker shall stop. */
+bool
+server::talk::Notifier::getWork(int32_t& forumId, std::vector<int32_t>& messageIds)
+{
+    while (1) {
+        m_wake.wait();
+
+        afl::sys::MutexGuard g(m_mutex);
+        for (std::list<int32_t>::iterator it = m_forumQueue.begin(); it != m_forumQueue.end(); ++it) {
+            if (m_busyForums.find(*it) == m_busyForums.end()) {
+                forumId = *it;
+                messageIds.swap(m_pendingMessages[forumId]);
+                m_pendingMessages.erase(forumId);
+                m_forumQueue.erase(it);
+                m_busyForums.insert(forumId);
+                return true;
+            }
+        }
+
+        // Nothing to do for us. Forums being processed by another worker will re-post m_wake when done.
+        if (m_stopRequest) {
+            // Pass stop request on to next worker
+            m_wake.post();
+            return false;
+        }
+    }
+}
+
+/* Mark forum as no longer being processed. */
+void
+server::talk::Notifier::finishWork(int32_t forumId)
+{
+    afl::sys::MutexGuard g(m_mutex);
+    m_busyForums.erase(forumId);
+    if (m_pendingMessages.find(forumId) != m_pendingMessages.end()) {
+        // Messages were queued while we were working
+        m_wake.post();
+    }
+    if (isIdle()) {
+        while (m_numIdleWaiters > 0) {
+            --m_numIdleWaiters;
+            m_idle.post();
+        }
+    }
+}
+
+/* Request workers to stop after processing all pending work. */
+void
+server::talk::Notifier::requestStop()
+{
+    afl::sys::MutexGuard g(m_mutex);
+    if (!m_stopRequest) {
+        m_stopRequest = true;
+        m_wake.post();
+    }
+}
+
+/* Check for idle state. Caller must hold m_mutex. */
+bool
+server::talk::Notifier::isIdle() const
+{
+    return m_forumQueue.empty() && m_busyForums.empty();
+}
@@ -0,0 +1,91 @@
+/**
+  *  \file server/talk/notifier.hpp
+  *  \brief Class server::talk::Notifier
+  */
+#ifndef C2NG_SERVER_TALK_NOTIFIER_HPP
+#define C2NG_SERVER_TALK_NOTIFIER_HPP
+
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+#include "afl/base/types.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/net/commandhandler.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/semaphore.hpp"
+
+namespace server { namespace talk {
+
+    class Root;
+
+    /** Background processing of forum message notifications.
+        Sending notifications for a forum message requires checking permissions and profile settings of all watchers,
+        which can take a while for popular forums.
+        Notifier takes this work off the command that posts the message.
+
+        <b>Operation</b>
+
+        Posting a message queues its Id (see notifyMessage(Message&,Topic&,Forum&,Root&)).
+        Worker threads pick up all queued messages of one forum as a batch,
+        and process it using a common PermissionChecker.
+        Messages of one forum are processed in order, by one worker at a time.
+        Messages are re-read from the database when being processed;
+        messages deleted in the meantime are not notified.
+
+        <b>Mutual Exclusion</b>
+
+        Worker threads access the database through Root.
+        The database CommandHandler is expected to be multithread-safe.
+        Each worker has its own mail queue connection, because message composition is stateful.
+
+        Explicit protection is required only for Notifier's own members. */
+    class Notifier : private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            \param root Service root; must live longer than Notifier instance */
+        explicit Notifier(Root& root);
+
+        /** Destructor.
+            Processes all pending notifications and stops the workers. */
+        ~Notifier();
+
+        /** Add a worker thread.
+            \param mail Mail queue connection for this worker; must live longer than Notifier instance */
+        void addWorker(afl::net::CommandHandler& mail);
+
+        /** Queue a forum message for notification.
+            \param forumId Forum Id
+            \param messageId Message Id */
+        void notifyMessage(int32_t forumId, int32_t messageId);
+
+        /** Wait until all queued notifications have been processed.
+            Requires at least one worker. */
+        void waitIdle();
+
+     private:
+        class Worker;
+        friend class Worker;
+
+        bool getWork(int32_t& forumId, std::vector<int32_t>& messageIds);
+        void finishWork(int32_t forumId);
+        void requestStop();
+        bool isIdle() const;
+
+        Root& m_root;
+        afl::container::PtrVector<Worker> m_workers;
+
+        afl::sys::Semaphore m_wake;                       ///< Wake workers. Posted for each forum added to m_forumQueue, or for stop request.
+        afl::sys::Semaphore m_idle;                       ///< Wake waitIdle(). Posted once per m_numIdleWaiters when becoming idle.
+        afl::sys::Mutex m_mutex;                          ///< Mutex protecting all of the following variables.
+        bool m_stopRequest;                               ///< Set to true to stop workers once the queue is empty.
+        int m_numIdleWaiters;                             ///< Number of threads blocked in waitIdle().
+        std::list<int32_t> m_forumQueue;                  ///< Forums with pending messages, in order of first message.
+        std::map<int32_t, std::vector<int32_t> > m_pendingMessages;  ///< Pending messages by forum.
+        std::set<int32_t> m_busyForums;                   ///< Forums currently being processed by a worker.
+    };
+
+} }
+
+#endif
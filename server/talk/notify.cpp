@@ -7,6 +7,8 @@
 #include "afl/data/stringlist.hpp"
 #include "server/talk/forum.hpp"
 #include "server/talk/message.hpp"
+#include "server/talk/notifier.hpp"
+#include "server/talk/permissionchecker.hpp"
 #include "server/talk/render/context.hpp"
 #include "server/talk/render/options.hpp"
 #include "server/talk/render/render.hpp"
@@ -18,12 +20,23 @@
 
 using afl::data::StringList_t;
 
+// Notify a forum message.
 void
 server::talk::notifyMessage(Message& msg, Topic& topic, Forum& forum, Root& root)
 {
-    // ex planetscentral/talk/notify.h:notifyMessage
-    server::interface::MailQueue& mq = root.mailQueue();
+    if (Notifier* n = root.getNotifier()) {
+        n->notifyMessage(forum.getId(), msg.getId());
+    } else {
+        PermissionChecker checker(root);
+        notifyMessage(msg, topic, forum, root, checker, root.mailQueue());
+    }
+}
 
+// Notify a forum message, immediately.
+void
+server::talk::notifyMessage(Message& msg, Topic& topic, Forum& forum, Root& root, PermissionChecker& checker, server::interface::MailQueue& mq)
+{
+    // ex planetscentral/talk/notify.h:notifyMessage
     // Get sender
     const String_t author = msg.author().get();
 
@@ -44,9 +57,9 @@ server::talk::notifyMessage(Message& msg, Topic& topic, Forum& forum, Root& root
     StringList_t groupReceivers;
     StringList_t individualReceivers;
     for (StringList_t::size_type i = 0; i < topicWatchers.size(); ++i) {
-        if (topicWatchers[i] != author && root.checkUserPermission(readPermissions, topicWatchers[i])) {
+        if (topicWatchers[i] != author && checker.check(readPermissions, topicWatchers[i])) {
             User u(root, topicWatchers[i]);
-            if (u.isWatchIndividual()) {
+            if (checker.isWatchIndividual(topicWatchers[i])) {
                 individualReceivers.push_back("user:" + topicWatchers[i]);
             } else if (u.notifiedTopics().add(topic.getId())) {
                 groupReceivers.push_back("user:" + topicWatchers[i]);
@@ -97,10 +110,10 @@ server::talk::notifyMessage(Message& msg, Topic& topic, Forum& forum, Root& root
     for (StringList_t::size_type i = 0; i < forumWatchers.size(); ++i) {
         if (forumWatchers[i] != author
             && !std::binary_search(topicWatchers.begin(), topicWatchers.end(), forumWatchers[i])
-            && root.checkUserPermission(readPermissions, forumWatchers[i]))
+            && checker.check(readPermissions, forumWatchers[i]))
         {
             User u(root, forumWatchers[i]);
-            if (u.isWatchIndividual()) {
+            if (checker.isWatchIndividual(forumWatchers[i])) {
                 individualReceivers.push_back("user:" + forumWatchers[i]);
             } else if (u.notifiedForums().add(forum.getId())) {
                 groupReceivers.push_back("user:" + forumWatchers[i]);
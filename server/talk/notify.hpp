@@ -5,23 +5,37 @@
 #define C2NG_SERVER_TALK_NOTIFY_HPP
 
 #include "afl/data/stringlist.hpp"
+#include "server/interface/mailqueue.hpp"
 
 namespace server { namespace talk {
 
     class Forum;
     class Message;
+    class PermissionChecker;
     class Root;
     class Topic;
     class UserPM;
 
     /** Notify a forum message.
         Sends mail to all users observing this topic or forum.
+        If root has a Notifier, the notification is queued to be sent in the background;
+        otherwise, it is sent immediately.
         \param msg Forum message
         \param topic Containing topic
         \param forum Containing forum
         \param root Service root */
     void notifyMessage(Message& msg, Topic& topic, Forum& forum, Root& root);
 
+    /** Notify a forum message, immediately.
+        Sends mail to all users observing this topic or forum.
+        \param msg Forum message
+        \param topic Containing topic
+        \param forum Containing forum
+        \param root Service root
+        \param checker Permission checker (caches permission and profile lookups)
+        \param mq Mail queue to send notifications on */
+    void notifyMessage(Message& msg, Topic& topic, Forum& forum, Root& root, PermissionChecker& checker, server::interface::MailQueue& mq);
+
 
     /** Notify a private message.
         \param msg Private message
@@ -0,0 +1,138 @@
+/**
+  *  \file server/talk/permissionchecker.cpp
+  *  \brief Class server::talk::PermissionChecker
+  */
+
+#include <memory>
+#include "server/talk/permissionchecker.hpp"
+#include "afl/net/redis/field.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "server/talk/root.hpp"
+#include "server/talk/user.hpp"
+#include "server/types.hpp"
+
+// Constructor.
+server::talk::PermissionChecker::PermissionChecker(Root& root)
+    : m_root(root),
+      m_expressions(),
+      m_profileValues(),
+      m_gameMembers()
+{ }
+
+// Destructor.
+server::talk::PermissionChecker::~PermissionChecker()
+{ }
+
+// Check a user's permissions.
+bool
+server::talk::PermissionChecker::check(const String_t& privString, const String_t& user)
+{
+    if (privString.empty()) {
+        return false;
+    }
+
+    // First item that matches decides
+    const Expression_t& expr = compile(privString);
+    for (size_t i = 0, n = expr.size(); i < n; ++i) {
+        const Item& it = expr[i];
+        switch (it.kind) {
+         case All:
+            return it.result;
+         case Profile:
+            if (getProfileInteger(user, it.arg) > 0) {
+                return it.result;
+            }
+            break;
+         case UserId:
+            if (it.arg == user) {
+                return it.result;
+            }
+            break;
+         case Game:
+            if (isGameMember(it.arg, user)) {
+                return it.result;
+            }
+            break;
+        }
+    }
+    return false;
+}
+
+// Get integer value from user profile.
+int32_t
+server::talk::PermissionChecker::getProfileInteger(const String_t& user, const String_t& key)
+{
+    const Key_t k(user, key);
+    std::map<Key_t, int32_t>::const_iterator it = m_profileValues.find(k);
+    if (it != m_profileValues.end()) {
+        return it->second;
+    }
+
+    std::auto_ptr<afl::data::Value> value(User(m_root, user).getProfileRaw(key));
+    const int32_t result = toInteger(value.get());
+    m_profileValues.insert(std::make_pair(k, result));
+    return result;
+}
+
+// Check whether user wants individual notifications.
+bool
+server::talk::PermissionChecker::isWatchIndividual(const String_t& user)
+{
+    // Unset means no, see User::isWatchIndividual
+    return getProfileInteger(user, "talkwatchindividual") > 0;
+}
+
+/* Parse a privilege string into a list of items, or return the cached result */
+const server::talk::PermissionChecker::Expression_t&
+server::talk::PermissionChecker::compile(const String_t& privString)
+{
+    std::map<String_t, Expression_t>::iterator it = m_expressions.find(privString);
+    if (it != m_expressions.end()) {
+        return it->second;
+    }
+
+    Expression_t& expr = m_expressions[privString];
+    String_t::size_type pos = 0;
+    while (1) {
+        String_t::size_type end = privString.find(',', pos);
+        String_t me = privString.substr(pos, end == String_t::npos ? String_t::npos : end - pos);
+
+        bool result = true;
+        if (me.size() > 0 && me[0] == '-') {
+            result = false;
+            me.erase(0, 1);
+        }
+        if (me == "all") {
+            expr.push_back(Item(result, All, String_t()));
+        } else if (me.size() > 2 && me.compare(0, 2, "p:", 2) == 0) {
+            expr.push_back(Item(result, Profile, me.substr(2)));
+        } else if (me.size() > 2 && me.compare(0, 2, "u:", 2) == 0) {
+            expr.push_back(Item(result, UserId, me.substr(2)));
+        } else if (me.size() > 2 && me.compare(0, 2, "g:", 2) == 0) {
+            expr.push_back(Item(result, Game, me.substr(2)));
+        } else {
+            // Unknown privilege token; never matches, so no need to store it
+        }
+
+        if (end == String_t::npos) {
+            break;
+        }
+        pos = end + 1;
+    }
+    return expr;
+}
+
+/* Check game membership, cached */
+bool
+server::talk::PermissionChecker::isGameMember(const String_t& gameId, const String_t& user)
+{
+    const Key_t k(gameId, user);
+    std::map<Key_t, bool>::const_iterator it = m_gameMembers.find(k);
+    if (it != m_gameMembers.end()) {
+        return it->second;
+    }
+
+    const bool result = m_root.gameRoot().subtree(gameId).hashKey("users").field(user).exists();
+    m_gameMembers.insert(std::make_pair(k, result));
+    return result;
+}
@@ -0,0 +1,82 @@
+/**
+  *  \file server/talk/permissionchecker.hpp
+  *  \brief Class server::talk::PermissionChecker
+  */
+#ifndef C2NG_SERVER_TALK_PERMISSIONCHECKER_HPP
+#define C2NG_SERVER_TALK_PERMISSIONCHECKER_HPP
+
+#include <map>
+#include <vector>
+#include "afl/base/types.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/string/string.hpp"
+
+namespace server { namespace talk {
+
+    class Root;
+
+    /** Cached permission checker.
+        Evaluates privilege strings with the same rules as Root::checkUserPermission(),
+        but keeps parsed privilege strings as well as profile and game membership lookups.
+        This speeds up checking many users against few privilege strings, as needed for notifications.
+
+        Because results are cached, a PermissionChecker should be short-lived
+        (e.g. one batch of notifications), so that it picks up profile changes. */
+    class PermissionChecker : private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            \param root Service root */
+        explicit PermissionChecker(Root& root);
+
+        /** Destructor. */
+        ~PermissionChecker();
+
+        /** Check a user's permissions.
+            \param privString Privilege string, see Root::checkUserPermission()
+            \param user User to check privileges for
+            \return true if user has requested permissions */
+        bool check(const String_t& privString, const String_t& user);
+
+        /** Get integer value from user profile.
+            Same as User::getProfileRaw(), interpreted as integer.
+            \param user User Id
+            \param key Profile key
+            \return value (0 if not set) */
+        int32_t getProfileInteger(const String_t& user, const String_t& key);
+
+        /** Check whether user wants individual notifications.
+            Same as User::isWatchIndividual().
+            \param user User Id
+            \return flag */
+        bool isWatchIndividual(const String_t& user);
+
+     private:
+        enum Kind {
+            All,                // "all"
+            Profile,            // "p:XX"
+            UserId,             // "u:XX"
+            Game                // "g:XX"
+        };
+        struct Item {
+            bool result;
+            Kind kind;
+            String_t arg;
+            Item(bool result, Kind kind, const String_t& arg)
+                : result(result), kind(kind), arg(arg)
+                { }
+        };
+        typedef std::vector<Item> Expression_t;
+        typedef std::pair<String_t, String_t> Key_t;
+
+        Root& m_root;
+        std::map<String_t, Expression_t> m_expressions;
+        std::map<Key_t, int32_t> m_profileValues;
+        std::map<Key_t, bool> m_gameMembers;
+
+        const Expression_t& compile(const String_t& privString);
+        bool isGameMember(const String_t& gameId, const String_t& user);
+    };
+
+} }
+
+#endif
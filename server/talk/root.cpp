@@ -3,11 +3,9 @@
   *  \brief Class server::talk::Root
   */
 
-#include <memory>
 #include "server/talk/root.hpp"
-#include "server/talk/user.hpp"
+#include "server/talk/permissionchecker.hpp"
 #include "server/types.hpp"
-#include "afl/net/redis/field.hpp"
 #include "afl/sys/time.hpp"
 
 namespace {
@@ -33,7 +31,9 @@ server::talk::Root::Root(afl::net::CommandHandler& db, afl::net::CommandHandler&
       m_linkFormatter(),
       m_db(db),
       m_mailQueue(mail),
-      m_config(config)
+      m_config(config),
+      m_sortCache(),
+      m_notifier(0)
 { }
 
 // Destructor.
@@ -75,6 +75,13 @@ server::talk::Root::config() const
     return m_config;
 }
 
+// Access cache of sorted listings.
+server::talk::SortCache&
+server::talk::Root::sortCache()
+{
+    return m_sortCache;
+}
+
 // Access mail queue service.
 server::interface::MailQueue&
 server::talk::Root::mailQueue()
@@ -82,6 +89,20 @@ server::talk::Root::mailQueue()
     return m_mailQueue;
 }
 
+// Attach notifier.
+void
+server::talk::Root::setNotifier(Notifier* p)
+{
+    m_notifier = p;
+}
+
+// Get notifier.
+server::talk::Notifier*
+server::talk::Root::getNotifier() const
+{
+    return m_notifier;
+}
+
 // Get current time.
 server::Time_t
 server::talk::Root::getTime()
@@ -188,43 +209,6 @@ server::talk::Root::rfcMessageIdRoot()
 bool
 server::talk::Root::checkUserPermission(String_t privString, String_t user)
 {
-    if (privString.empty()) {
-        return false;
-    }
-
-    // Process
-    // FIXME: implement using StringParser
-    do {
-        String_t me(afl::string::strFirst(privString, ","));
-        bool result = true;
-        if (me.size() > 0 && me[0] == '-') {
-            // Invert result
-            result = false;
-            me.erase(0, 1);
-        }
-        if (me == "all") {
-            // blanket permission
-            return result;
-        } else if (me.size() > 2 && me.compare(0, 2, "p:", 2) == 0) {
-            // check profile permission
-            std::auto_ptr<afl::data::Value> value(User(*this, user).getProfileRaw(me.substr(2)));
-            if (toInteger(value.get()) > 0) {
-                return result;
-            }
-        } else if (me.size() > 2 && me.compare(0, 2, "u:", 2) == 0) {
-            // check user name
-            if (me.compare(2, String_t::npos, user) == 0) {
-                return result;
-            }
-        } else if (me.size() > 2 && me.compare(0, 2, "g:", 2) == 0) {
-            // check game membership
-            if (gameRoot().subtree(me.substr(2)).hashKey("users").field(user).exists()) {
-                return result;
-            }
-        } else {
-            // unknown privilege token
-        }
-    } while (afl::string::strRemove(privString, ","));
-    return false;
+    return PermissionChecker(*this).check(privString, user);
 }
 
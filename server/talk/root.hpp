@@ -13,12 +13,15 @@
 #include "server/talk/configuration.hpp"
 #include "server/talk/inlinerecognizer.hpp"
 #include "server/talk/linkformatter.hpp"
+#include "server/talk/sortcache.hpp"
 #include "server/types.hpp"
 #include "util/syntax/keywordtable.hpp"
 #include "server/common/root.hpp"
 
 namespace server { namespace talk {
 
+    class Notifier;
+
     /** A talk server's root state.
         Contains global configuration and state objects.
         Root is shared between all connections.
@@ -68,10 +71,24 @@ namespace server { namespace talk {
             \return configuration */
         const Configuration& config() const;
 
+        /** Access cache of sorted listings.
+            \return cache */
+        SortCache& sortCache();
+
         /** Access mail queue service.
             \return mail queue service */
         server::interface::MailQueue& mailQueue();
 
+        /** Attach notifier.
+            If a notifier is attached, forum message notifications are processed in the background by it.
+            Otherwise, they are processed synchronously.
+            \param p Notifier; null to detach. Must out-live the Root or be detached before destruction. */
+        void setNotifier(Notifier* p);
+
+        /** Get notifier.
+            \return notifier set using setNotifier(); null if none */
+        Notifier* getNotifier() const;
+
         /** Get current time.
             The time is specified in minutes-since-epoch.
             \return time */
@@ -124,6 +141,10 @@ namespace server { namespace talk {
         server::interface::MailQueueClient m_mailQueue;
 
         Configuration m_config;
+
+        SortCache m_sortCache;
+
+        Notifier* m_notifier;
     };
 
 } }
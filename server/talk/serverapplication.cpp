@@ -5,13 +5,16 @@
 
 #include "server/talk/serverapplication.hpp"
 #include "afl/async/controller.hpp"
+#include "afl/except/commandlineexception.hpp"
 #include "afl/net/resp/protocolhandler.hpp"
 #include "afl/net/server.hpp"
 #include "afl/string/format.hpp"
+#include "afl/string/parse.hpp"
 #include "afl/sys/thread.hpp"
 #include "server/common/sessionprotocolhandlerfactory.hpp"
 #include "server/ports.hpp"
 #include "server/talk/commandhandler.hpp"
+#include "server/talk/notifier.hpp"
 #include "server/talk/root.hpp"
 #include "server/talk/session.hpp"
 #include "util/string.hpp"
@@ -30,6 +33,7 @@ server::talk::ServerApplication::ServerApplication(afl::sys::Environment& env, a
       m_mailAddress(DEFAULT_ADDRESS, MAILOUT_PORT),
       m_keywordTableName(),
       m_config(),
+      m_numNotifyThreads(2),
       m_interrupt(intr)
 { }
 
@@ -59,6 +63,15 @@ server::talk::ServerApplication::serverMain()
         root.keywordTable().load(*fileSystem().openFile(m_keywordTableName, afl::io::FileSystem::OpenRead), log());
     }
 
+    // Notification workers. Each one needs its own mail connection.
+    Notifier notifier(root);
+    for (int i = 0; i < m_numNotifyThreads; ++i) {
+        notifier.addWorker(createClient(m_mailAddress, del, true));
+    }
+    if (m_numNotifyThreads > 0) {
+        root.setNotifier(&notifier);
+    }
+
     // Protocol Handler
     server::common::SessionProtocolHandlerFactory<Root, Session, afl::net::resp::ProtocolHandler, CommandHandler> factory(root);
 
@@ -78,6 +91,7 @@ server::talk::ServerApplication::serverMain()
     log().write(afl::sys::LogListener::Info, LOG_NAME, "Received stop signal, shutting down.");
     server.stop();
     serverThread.join();
+    root.setNotifier(0);
 }
 
 bool
@@ -99,6 +113,17 @@ server::talk::ServerApplication::handleConfiguration(const String_t& key, const
            Ignored in c2ng/c2talk-server for compatibility reasons.
            Number of threads (=maximum number of parallel connections) */
         return true;
+    } else if (key == "TALK.NOTIFYTHREADS") {
+        /* @q Talk.NotifyThreads:Int (Config)
+           Number of threads sending forum notifications in the background (default: 2).
+           If set to 0, notifications are sent synchronously when a message is posted. */
+        int n;
+        if (afl::string::strToInteger(value, n) && n >= 0) {
+            m_numNotifyThreads = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
     } else if (key == "TALK.MSGID") {
         /* @q Talk.MsgID:Str (Config)
            Suffix for creating NNTP Message-IDs.
@@ -43,6 +43,7 @@ namespace server { namespace talk {
 
         String_t m_keywordTableName;
         Configuration m_config;
+        int m_numNotifyThreads;
 
         afl::async::Interrupt& m_interrupt;
     };
@@ -0,0 +1,141 @@
+/**
+  *  \file server/talk/sortcache.cpp
+  *  \brief Class server::talk::SortCache
+  */
+
+#include <algorithm>
+#include "server/talk/sortcache.hpp"
+#include "afl/data/vector.hpp"
+#include "afl/data/vectorvalue.hpp"
+#include "afl/net/redis/sortoperation.hpp"
+#include "server/talk/sorter.hpp"
+#include "server/talk/talkforum.hpp"
+
+const size_t server::talk::SortCache::DEFAULT_MAX_ENTRIES;
+
+// Compare cache keys.
+bool
+server::talk::SortCache::Key::operator<(const Key& other) const
+{
+    if (scope != other.scope) {
+        return scope < other.scope;
+    }
+    if (keyName != other.keyName) {
+        return keyName < other.keyName;
+    }
+    return sortKey < other.sortKey;
+}
+
+// Constructor.
+server::talk::SortCache::SortCache(size_t maxEntries)
+    : m_entries(),
+      m_maxEntries(maxEntries),
+      m_useCounter(0)
+{ }
+
+// Destructor.
+server::talk::SortCache::~SortCache()
+{ }
+
+// Execute list operation.
+afl::data::Value*
+server::talk::SortCache::executeListOperation(int32_t scope, const ListParameters& params, afl::net::redis::IntegerSetKey key, const Sorter& sorter)
+{
+    switch (params.mode) {
+     case ListParameters::WantAll:
+     case ListParameters::WantRange: {
+        const afl::data::IntegerList_t& list = getList(scope, key, params.sortKey.get(), sorter);
+
+        // Determine range. Same behaviour as SORT LIMIT: negative start is treated as 0, negative count means everything.
+        size_t start = 0, end = list.size();
+        if (params.mode == ListParameters::WantRange) {
+            start = std::min(size_t(std::max(params.start, int32_t(0))), end);
+            if (params.count >= 0) {
+                end = start + std::min(size_t(params.count), end - start);
+            }
+        }
+
+        afl::data::Vector::Ref_t vv(afl::data::Vector::create());
+        for (size_t i = start; i < end; ++i) {
+            vv->pushBackInteger(list[i]);
+        }
+        return new afl::data::VectorValue(vv);
+     }
+
+     case ListParameters::WantMemberCheck:
+     case ListParameters::WantSize:
+        return TalkForum::executeListOperation(params, key, sorter);
+    }
+    return 0;
+}
+
+// Invalidate a scope.
+void
+server::talk::SortCache::invalidate(int32_t scope)
+{
+    // Entries are sorted by scope first, so everything we need to delete is in one block
+    Map_t::iterator first = m_entries.lower_bound(Key(scope, String_t(), String_t()));
+    Map_t::iterator last = first;
+    while (last != m_entries.end() && last->first.scope == scope) {
+        ++last;
+    }
+    m_entries.erase(first, last);
+}
+
+// Invalidate everything.
+void
+server::talk::SortCache::clear()
+{
+    m_entries.clear();
+}
+
+// Get number of cached lists.
+size_t
+server::talk::SortCache::getNumEntries() const
+{
+    return m_entries.size();
+}
+
+/** Get sorted list, from cache or database.
+    \param scope   Forum Id
+    \param key     Set to list
+    \param sortKey Sort key, null for default order
+    \param sorter  Sorter to apply sort keys
+    \return list */
+const afl::data::IntegerList_t&
+server::talk::SortCache::getList(int32_t scope, afl::net::redis::IntegerSetKey key, const String_t* sortKey, const Sorter& sorter)
+{
+    const Key k(scope, key.getName(), sortKey != 0 ? *sortKey : String_t());
+    Map_t::iterator it = m_entries.find(k);
+    if (it == m_entries.end()) {
+        // Not cached. Sort into a local list first, so an invalid sort key does not leave an empty entry.
+        afl::data::IntegerList_t list;
+        afl::net::redis::SortOperation op(key.sort());
+        if (sortKey != 0) {
+            sorter.applySortKey(op, *sortKey);
+        }
+        op.getResult(list);
+
+        expire();
+        it = m_entries.insert(std::make_pair(k, Entry())).first;
+        it->second.list.swap(list);
+    }
+    it->second.lastUse = ++m_useCounter;
+    return it->second.list;
+}
+
+/** Make room for a new entry.
+    Discards least-recently-used entries until the cache has room for one more. */
+void
+server::talk::SortCache::expire()
+{
+    while (!m_entries.empty() && m_entries.size() >= m_maxEntries) {
+        Map_t::iterator oldest = m_entries.begin();
+        for (Map_t::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) {
+                oldest = it;
+            }
+        }
+        m_entries.erase(oldest);
+    }
+}
@@ -0,0 +1,98 @@
+/**
+  *  \file server/talk/sortcache.hpp
+  *  \brief Class server::talk::SortCache
+  */
+#ifndef C2NG_SERVER_TALK_SORTCACHE_HPP
+#define C2NG_SERVER_TALK_SORTCACHE_HPP
+
+#include <map>
+#include "afl/data/integerlist.hpp"
+#include "afl/data/value.hpp"
+#include "afl/net/redis/integersetkey.hpp"
+#include "server/interface/talkforum.hpp"
+
+namespace server { namespace talk {
+
+    class Sorter;
+
+    /** Cache of sorted forum/thread listings.
+
+        Listing a forum's threads or posts in a particular order requires a SORT operation on the database,
+        which needs to look up one hash field per list element.
+        For big forums, this is the majority of work for each page view.
+        SortCache keeps the result of such sorts (the complete sorted list of Ids),
+        so that subsequent page views only need to pick the requested range.
+
+        Each cache entry belongs to a scope, which is the Id of the forum containing the list.
+        All operations that modify a forum's lists or sort keys (post, edit, move, delete, sticky)
+        must call invalidate() for that forum.
+        Lists not associated with a forum shall not be cached.
+
+        The cache holds a limited number of entries; the least-recently used ones are discarded when needed. */
+    class SortCache {
+     public:
+        typedef server::interface::TalkForum::ListParameters ListParameters;
+
+        /** Default maximum number of lists to keep. */
+        static const size_t DEFAULT_MAX_ENTRIES = 200;
+
+        /** Constructor.
+            \param maxEntries Maximum number of lists to keep */
+        explicit SortCache(size_t maxEntries = DEFAULT_MAX_ENTRIES);
+
+        /** Destructor. */
+        ~SortCache();
+
+        /** Execute list operation.
+            Equivalent to TalkForum::executeListOperation(), but uses the cache for WantAll and WantRange.
+            \param scope  Forum Id
+            \param params List parameters
+            \param key    Set to list
+            \param sorter Sorter to apply sort keys
+            \return newly-allocated result */
+        afl::data::Value* executeListOperation(int32_t scope, const ListParameters& params, afl::net::redis::IntegerSetKey key, const Sorter& sorter);
+
+        /** Invalidate a scope.
+            Discards all lists belonging to the given forum.
+            \param scope Forum Id */
+        void invalidate(int32_t scope);
+
+        /** Invalidate everything. */
+        void clear();
+
+        /** Get number of cached lists.
+            \return number */
+        size_t getNumEntries() const;
+
+     private:
+        struct Entry {
+            afl::data::IntegerList_t list;
+            uint32_t lastUse;
+            Entry()
+                : list(), lastUse(0)
+                { }
+        };
+
+        /* Cache key: scope, database key name, sort key */
+        struct Key {
+            int32_t scope;
+            String_t keyName;
+            String_t sortKey;
+            Key(int32_t scope, const String_t& keyName, const String_t& sortKey)
+                : scope(scope), keyName(keyName), sortKey(sortKey)
+                { }
+            bool operator<(const Key& other) const;
+        };
+        typedef std::map<Key, Entry> Map_t;
+
+        Map_t m_entries;
+        size_t m_maxEntries;
+        uint32_t m_useCounter;
+
+        const afl::data::IntegerList_t& getList(int32_t scope, afl::net::redis::IntegerSetKey key, const String_t* sortKey, const Sorter& sorter);
+        void expire();
+    };
+
+} }
+
+#endif
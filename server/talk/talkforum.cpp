@@ -156,7 +156,7 @@ server::talk::TalkForum::getThreads(int32_t fid, const ListParameters& params)
         throw std::runtime_error(FORUM_NOT_FOUND);
     }
 
-    return executeListOperation(params, f.topics(), Topic::TopicSorter(m_root));
+    return m_root.sortCache().executeListOperation(fid, params, f.topics(), Topic::TopicSorter(m_root));
 }
 
 afl::data::Value*
@@ -168,7 +168,7 @@ server::talk::TalkForum::getStickyThreads(int32_t fid, const ListParameters& par
         throw std::runtime_error(FORUM_NOT_FOUND);
     }
 
-    return executeListOperation(params, f.stickyTopics(), Topic::TopicSorter(m_root));
+    return m_root.sortCache().executeListOperation(fid, params, f.stickyTopics(), Topic::TopicSorter(m_root));
 }
 
 afl::data::Value*
@@ -180,7 +180,7 @@ server::talk::TalkForum::getPosts(int32_t fid, const ListParameters& params)
         throw std::runtime_error(FORUM_NOT_FOUND);
     }
 
-    return executeListOperation(params, f.messages(), Message::MessageSorter(m_root));
+    return m_root.sortCache().executeListOperation(fid, params, f.messages(), Message::MessageSorter(m_root));
 }
 
 int32_t
@@ -69,6 +69,7 @@ server::talk::TalkPost::create(int32_t forumId, String_t subject, String_t text,
     }
 
     // All preconditions fulfilled, operate!
+    m_root.sortCache().invalidate(forumId);
     const int32_t mid = ++m_root.lastMessageId();
     const int32_t tid = ++m_root.lastTopicId();
 
@@ -167,6 +168,7 @@ server::talk::TalkPost::reply(int32_t parentPostId, String_t subject, String_t t
     m_session.checkPermission(answerperm, m_root);
 
     // All preconditions fulfilled, operate!
+    m_root.sortCache().invalidate(fid);
     const int32_t mid = ++m_root.lastMessageId();
     const int32_t time = m_root.getTime();
     Message msg(m_root, mid);
@@ -226,13 +228,14 @@ server::talk::TalkPost::edit(int32_t postId, String_t subject, String_t text)
     }
 
     // Update message
+    Topic topic(m_root, msg.topicId().get());
+    m_root.sortCache().invalidate(topic.forumId().get());
     const int32_t time = m_root.getTime();
     msg.subject().set(subject);
     msg.text().set(text);
     msg.editTime().set(time);
 
     // Update topic
-    Topic topic(m_root, msg.topicId().get());
     topic.lastTime().set(time);
     if (postId == topic.firstPostingId().get()) {
         topic.subject().set(subject);
@@ -346,6 +349,7 @@ server::talk::TalkPost::remove(int32_t postId)
         }
 
         // Do it
+        m_root.sortCache().invalidate(msg.topic(m_root).forumId().get());
         msg.remove(m_root);
         return 1;
     } else {
@@ -57,7 +57,7 @@ server::talk::TalkThread::getPosts(int32_t threadId, const ListParameters& param
         throw std::runtime_error(TOPIC_NOT_FOUND);
     }
 
-    return TalkForum::executeListOperation(params, t.messages(), Message::MessageSorter(m_root));
+    return m_root.sortCache().executeListOperation(t.forumId().get(), params, t.messages(), Message::MessageSorter(m_root));
 }
 
 void
@@ -73,6 +73,7 @@ server::talk::TalkThread::setSticky(int32_t threadId, bool flag)
     m_session.checkPermission(t.forum(m_root).deletePermissions().get(), m_root);
 
     // Execute
+    m_root.sortCache().invalidate(t.forumId().get());
     t.setSticky(m_root, flag);
 }
 
@@ -130,6 +131,10 @@ server::talk::TalkThread::moveToForum(int32_t threadId, int32_t forumId)
         m_session.checkPermission(dst.writePermissions().get(), m_root);
     }
 
+    // Both forums' listings change
+    m_root.sortCache().invalidate(src.getId());
+    m_root.sortCache().invalidate(forumId);
+
     // Do it. Actual forum move is trivial, but we must update all sequence numbers and change
     // all message Ids for the NNTP side.
     afl::data::IntegerList_t posts;
@@ -193,6 +198,7 @@ server::talk::TalkThread::remove(int32_t threadId)
         }
 
         // Do it
+        m_root.sortCache().invalidate(f.getId());
         t.remove(m_root);
         result = true;
     }
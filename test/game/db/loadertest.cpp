@@ -5,6 +5,7 @@
 
 #include "game/db/loader.hpp"
 
+#include "afl/base/growablememory.hpp"
 #include "afl/charset/codepage.hpp"
 #include "afl/charset/codepagecharset.hpp"
 #include "afl/io/constmemorystream.hpp"
@@ -522,6 +523,17 @@ namespace {
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
         0xff, 0xff, 0xff
     };
+
+    void prepareTurn(game::Turn& t)
+    {
+        t.setTurnNumber(7);
+        for (int i = 1; i <= 900; ++i) {
+            t.universe().ships().create(i);
+        }
+        for (int i = 1; i <= 500; ++i) {
+            t.universe().planets().create(i);
+        }
+    }
 }
 
 
@@ -679,3 +691,62 @@ AFL_TEST("game.db.Loader", a)
     a.check("121. file size", out.getSize() >= sizeof(FILE_DATA) - 10);
     a.check("122. file size", out.getSize() <= sizeof(FILE_DATA) + 10);
 }
+
+/** Test saveIndexed(), update(). */
+AFL_TEST("game.db.Loader:update", a)
+{
+    // Environment
+    afl::charset::CodepageCharset cs(afl::charset::g_codepage437);
+    afl::sys::Log log;
+    afl::io::NullFileSystem fs;
+    afl::string::NullTranslator tx;
+    interpreter::World world(log, tx, fs);
+    game::spec::ShipList sl;
+    game::test::initDefaultShipList(sl);
+    game::Game g;
+    game::Turn t;
+    prepareTurn(t);
+
+    game::db::Loader testee(cs, world, tx);
+    afl::io::ConstMemoryStream inputStream(FILE_DATA);
+    testee.load(inputStream, t, g, true);
+
+    // A file without index cannot be updated
+    afl::io::InternalStream classic;
+    testee.save(classic, t, g, sl);
+    a.checkEqual("01. update", testee.update(classic, t, g, sl), false);
+
+    // Save with index
+    afl::io::InternalStream file;
+    testee.saveIndexed(file, t, g, sl);
+    a.check("11. file size", file.getSize() > classic.getSize());
+    afl::base::GrowableBytes_t orig;
+    orig.append(file.getContent());
+
+    // Update without change does not change the file
+    a.checkEqual("21. update", testee.update(file, t, g, sl), true);
+    a.checkEqualContent("22. content", file.getContent(), orig);
+
+    // Change autobuild settings; update appends data
+    t.universe().planets().get(100)->setAutobuildGoal(game::FactoryBuilding, 77);
+    a.checkEqual("31. update", testee.update(file, t, g, sl), true);
+    a.check("32. file size", file.getSize() > orig.size());
+
+    // Reload
+    {
+        game::Game g2;
+        game::Turn t2;
+        prepareTurn(t2);
+        file.setPos(0);
+        testee.load(file, t2, g2, false);
+        a.checkEqual("41. getAutobuildGoal", t2.universe().planets().get(100)->getAutobuildGoal(game::FactoryBuilding), 77);
+        a.checkEqual("42. getFriendlyCode", t2.universe().planets().get(96)->getFriendlyCode().orElse(""), "157");
+    }
+
+    // Add a drawing; cannot be updated
+    afl::base::GrowableBytes_t updated;
+    updated.append(file.getContent());
+    t.universe().drawings().addNew(new game::map::Drawing(game::map::Point(1000, 1000), game::map::Drawing::MarkerDrawing));
+    a.checkEqual("51. update", testee.update(file, t, g, sl), false);
+    a.checkEqualContent("52. content", file.getContent(), updated);
+}
@@ -0,0 +1,164 @@
+/**
+  *  \file test/game/interface/snapshotsearchtest.cpp
+  *  \brief Test for game::interface::searchSnapshot
+  */
+
+#include "game/interface/snapshotsearch.hpp"
+
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/game.hpp"
+#include "game/map/ship.hpp"
+#include "game/map/universe.hpp"
+#include "game/session.hpp"
+#include "game/spec/shiplist.hpp"
+#include "game/test/root.hpp"
+#include "game/turn.hpp"
+
+using game::Reference;
+using game::SearchQuery;
+using game::interface::searchSnapshot;
+
+namespace {
+    struct Environment {
+        afl::string::NullTranslator tx;
+        afl::io::NullFileSystem fs;
+        game::Session session;
+
+        Environment()
+            : tx(), fs(), session(tx, fs)
+            {
+                session.setRoot(game::test::makeRoot(game::HostVersion()).asPtr());
+                session.setGame(new game::Game());
+                session.setShipList(new game::spec::ShipList());
+            }
+    };
+
+    void addShipXY(game::Session& session, game::Id_t id)
+    {
+        game::map::Ship& sh = *session.getGame()->currentTurn().universe().ships().create(id);
+        sh.addShipXYData(game::map::Point(1000, 1000), 1, 100, game::PlayerSet_t(2));
+        sh.internalCheck(game::PlayerSet_t(2), 10);
+    }
+
+    SearchQuery::SearchObjects_t ships()
+    {
+        return SearchQuery::SearchObjects_t(SearchQuery::SearchShips);
+    }
+}
+
+/** Test successful searches.
+    A: create universe with two ships. Search with different query types.
+    E: correct result */
+AFL_TEST("game.interface.SnapshotSearch:success", a)
+{
+    Environment env;
+    addShipXY(env.session, 100);
+    addShipXY(env.session, 200);
+
+    // Expression
+    {
+        game::ref::List list;
+        a.check("01. searchSnapshot", searchSnapshot(SearchQuery(SearchQuery::MatchTrue, ships(), "Id > 150"), env.session.world(), list));
+        a.checkEqual("02. size", list.size(), 1U);
+        a.checkEqual("03. item", list[0], Reference(Reference::Ship, 200));
+    }
+
+    // Negated expression
+    {
+        game::ref::List list;
+        a.check("11. searchSnapshot", searchSnapshot(SearchQuery(SearchQuery::MatchFalse, ships(), "Id > 150"), env.session.world(), list));
+        a.checkEqual("12. size", list.size(), 1U);
+        a.checkEqual("13. item", list[0], Reference(Reference::Ship, 100));
+    }
+
+    // Name/Id
+    {
+        game::ref::List list;
+        a.check("21. searchSnapshot", searchSnapshot(SearchQuery(SearchQuery::MatchName, ships(), "#100"), env.session.world(), list));
+        a.checkEqual("22. size", list.size(), 1U);
+        a.checkEqual("23. item", list[0], Reference(Reference::Ship, 100));
+    }
+
+    // No match is a valid result
+    {
+        game::ref::List list;
+        a.check("31. searchSnapshot", searchSnapshot(SearchQuery(SearchQuery::MatchTrue, ships(), "Id > 1000"), env.session.world(), list));
+        a.checkEqual("32. size", list.size(), 0U);
+    }
+}
+
+/** Test unsupported searches.
+    A: create universe with a ship. Search with queries that need the interpreter.
+    E: searchSnapshot() returns false, list unchanged */
+AFL_TEST("game.interface.SnapshotSearch:unsupported", a)
+{
+    Environment env;
+    addShipXY(env.session, 100);
+
+    game::ref::List list;
+    a.check("01. location", !searchSnapshot(SearchQuery(SearchQuery::MatchLocation, ships(), "1000,1000"), env.session.world(), list));
+    a.check("02. function", !searchSnapshot(SearchQuery(SearchQuery::MatchTrue, ships(), "Len(Name) > 0"), env.session.world(), list));
+    a.check("03. syntax",   !searchSnapshot(SearchQuery(SearchQuery::MatchTrue, ships(), "Id >"), env.session.world(), list));
+
+    // No candidate objects: CCUI$Search produces the message
+    SearchQuery q(SearchQuery::MatchTrue, ships(), "Id > 0");
+    q.setPlayedOnly(true);
+    a.check("11. played", !searchSnapshot(q, env.session.world(), list));
+    a.check("12. ufos",   !searchSnapshot(SearchQuery(SearchQuery::MatchTrue, SearchQuery::SearchObjects_t(SearchQuery::SearchUfos), "Id > 0"), env.session.world(), list));
+
+    a.checkEqual("21. size", list.size(), 0U);
+}
+
+/** Test cache.
+    A: create universe with two ships. Search using a SnapshotCache. Add a ship without notifying, search again; then notify.
+    E: objects are extracted once and re-extracted when the universe changes or new properties are needed */
+AFL_TEST("game.interface.SnapshotSearch:cache", a)
+{
+    Environment env;
+    addShipXY(env.session, 100);
+    addShipXY(env.session, 200);
+
+    game::Turn& turn = env.session.getGame()->viewpointTurn();
+    game::interface::SnapshotCache cache;
+    cache.setTurn(&turn);
+
+    // Initial search
+    {
+        game::ref::List list;
+        a.check("01. searchSnapshot", searchSnapshot(SearchQuery(SearchQuery::MatchTrue, ships(), "Id > 150"), env.session.world(), cache, list));
+        a.checkEqual("02. size", list.size(), 1U);
+        a.checkEqual("03. rows", cache.getSnapshot("SHIP").getNumRows(), 2U);
+    }
+
+    // Add a ship without notification: cached snapshot is used
+    addShipXY(env.session, 300);
+    {
+        game::ref::List list;
+        a.check("11. searchSnapshot", searchSnapshot(SearchQuery(SearchQuery::MatchTrue, ships(), "Id > 120"), env.session.world(), cache, list));
+        a.checkEqual("12. size", list.size(), 1U);
+    }
+
+    // Query that needs a new property: objects are extracted again
+    {
+        game::ref::List list;
+        a.check("21. searchSnapshot", searchSnapshot(SearchQuery(SearchQuery::MatchTrue, ships(), "Id > 150 And Owner$ = 1"), env.session.world(), cache, list));
+        a.checkEqual("22. size", list.size(), 2U);
+        a.checkEqual("23. rows", cache.getSnapshot("SHIP").getNumRows(), 3U);
+    }
+
+    // Universe change invalidates
+    turn.universe().ships().get(300)->markDirty();
+    turn.universe().notifyListeners();
+    a.checkEqual("31. rows", cache.getSnapshot("SHIP").getNumRows(), 0U);
+    {
+        game::ref::List list;
+        a.check("32. searchSnapshot", searchSnapshot(SearchQuery(SearchQuery::MatchTrue, ships(), "Id > 150"), env.session.world(), cache, list));
+        a.checkEqual("33. size", list.size(), 2U);
+    }
+
+    // Different turn invalidates
+    cache.setTurn(0);
+    a.checkEqual("41. rows", cache.getSnapshot("SHIP").getNumRows(), 0U);
+}
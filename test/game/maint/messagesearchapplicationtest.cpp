@@ -0,0 +1,293 @@
+/**
+  *  \file test/game/maint/messagesearchapplicationtest.cpp
+  *  \brief Test for game::maint::MessageSearchApplication
+  */
+
+#include "game/maint/messagesearchapplication.hpp"
+
+#include <set>
+#include <vector>
+#include "afl/charset/codepage.hpp"
+#include "afl/charset/codepagecharset.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/internalfilesystem.hpp"
+#include "afl/io/internalstream.hpp"
+#include "afl/string/format.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/sys/internalenvironment.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/v3/inboxfile.hpp"
+
+using afl::base::GrowableBytes_t;
+using afl::io::FileSystem;
+using afl::string::Format;
+
+namespace {
+    /* Messages for the tests, in Latin-1.
+       '\n' is a regular (CR) line break, '|' is a Winplan (LF) line break, '^' is a NUL byte. */
+    const char*const MESSAGES[] = {
+        "(-r1000)<< Sub Space Message >>\n"
+        "FROM: Southern United Planets\n"
+        "TO: Southern United Planets\n"
+        "\n"
+        "<CC: 6 11\n"
+        "Attack at Dawn, Planet #42!\n"
+        "   ",
+        "Hello World\n"
+        "The Quick Brown Fox jumps over the lazy dog.\n",
+        "(-r2000)<<< Data Transmission >>>\n"
+        "FROM: Host\n"
+        "\n"
+        "This is a Winplan|message that was|wrapped by the client",
+        "Starship Enterprise^garbage Zebra\n"
+        "Zebra after garbage",
+        "Gr\xF6\xDF" "e und Ma\xDF\n"
+        "xyz-XYZ",
+    };
+
+    /* Encode a message in the inbox format */
+    void encodeMessage(GrowableBytes_t& out, const char* text)
+    {
+        while (char ch = *text++) {
+            uint8_t byte;
+            switch (ch) {
+             case '\n': byte = 13; break;
+             case '|':  byte = 10; break;
+             case '^':  byte = 0;  break;
+             default:   byte = uint8_t(ch); break;
+            }
+            out.append(uint8_t(byte + 13));
+        }
+    }
+
+    /* Create an inbox file (MDATA) from a list of messages */
+    GrowableBytes_t makeInbox(afl::base::Memory<const char*const> messages)
+    {
+        GrowableBytes_t texts;
+        GrowableBytes_t header;
+        const size_t n = messages.size();
+        header.append(uint8_t(n & 255));
+        header.append(uint8_t(n >> 8));
+
+        while (const char*const* p = messages.eat()) {
+            size_t pos = texts.size();
+            encodeMessage(texts, *p);
+
+            uint32_t address = uint32_t(2 + 6*n + pos + 1);
+            uint16_t length = uint16_t(texts.size() - pos);
+            header.append(uint8_t(address & 255));
+            header.append(uint8_t((address >> 8) & 255));
+            header.append(uint8_t((address >> 16) & 255));
+            header.append(uint8_t(address >> 24));
+            header.append(uint8_t(length & 255));
+            header.append(uint8_t(length >> 8));
+        }
+        header.append(texts);
+        return header;
+    }
+
+    /* Decode all messages of an inbox file without any prefiltering; this is what a search must find */
+    std::vector<String_t> decodeInbox(afl::base::ConstBytes_t data)
+    {
+        afl::charset::CodepageCharset cs(afl::charset::g_codepageLatin1);
+        afl::string::NullTranslator tx;
+        afl::io::ConstMemoryStream s(data);
+        game::v3::InboxFile inbox(s, cs, tx);
+
+        std::vector<String_t> result;
+        for (size_t i = 0, n = inbox.getNumMessages(); i < n; ++i) {
+            result.push_back(inbox.loadMessage(i));
+        }
+        return result;
+    }
+
+    struct Environment {
+        afl::io::InternalFileSystem fs;
+        afl::sys::InternalEnvironment env;
+        afl::base::Ref<afl::io::InternalStream> output;
+        afl::base::Ref<afl::io::InternalStream> error;
+
+        Environment()
+            : fs(), env(),
+              output(*new afl::io::InternalStream()),
+              error(*new afl::io::InternalStream())
+            {
+                env.setChannelStream(afl::sys::Environment::Output, output.asPtr());
+                env.setChannelStream(afl::sys::Environment::Error, error.asPtr());
+            }
+    };
+
+    void runApplication(Environment& env, const afl::data::StringList_t& args)
+    {
+        env.env.setCommandLine(args);
+        game::maint::MessageSearchApplication(env.env, env.fs).run();
+    }
+
+    String_t getContent(afl::io::InternalStream& s)
+    {
+        String_t result;
+        afl::base::ConstBytes_t bytes = s.getContent();
+        while (const uint8_t* p = bytes.eat()) {
+            if (*p != '\r') {
+                result.append(1, char(*p));
+            }
+        }
+        return result;
+    }
+
+    /* Extract the message dividers from an output */
+    String_t getDividers(const String_t& output)
+    {
+        String_t result;
+        String_t::size_type pos = 0;
+        while (pos < output.size()) {
+            String_t::size_type end = output.find('\n', pos);
+            if (end == String_t::npos) {
+                end = output.size();
+            }
+            if (output.compare(pos, 12, "--- Message ") == 0) {
+                result.append(output, pos, end - pos + 1);
+            }
+            pos = end + 1;
+        }
+        return result;
+    }
+
+    /* Check whether a string qualifies as a query derived from message text */
+    bool isPlainQuery(const String_t& q)
+    {
+        if (q.empty() || q[0] == '-') {
+            return false;
+        }
+        for (size_t i = 0; i < q.size(); ++i) {
+            if (uint8_t(q[i]) < 0x20 || uint8_t(q[i]) > 0x7E) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    String_t swapCase(const String_t& q)
+    {
+        String_t result = q;
+        for (size_t i = 0; i < result.size(); ++i) {
+            char& ch = result[i];
+            if (ch >= 'a' && ch <= 'z') {
+                ch = char(ch - 'a' + 'A');
+            } else if (ch >= 'A' && ch <= 'Z') {
+                ch = char(ch - 'A' + 'a');
+            }
+        }
+        return result;
+    }
+}
+
+/** Test that the literal prefilter never rejects a matching message.
+    A: create an inbox with messages exercising all decoding special cases (header tweaks, trailing blanks, Winplan line breaks, NUL garbage, Latin-1).
+       Search for every short substring of the decoded messages, unchanged and with swapped case, with and without '-c'.
+    E: output lists exactly the messages whose decoded text contains the search string */
+AFL_TEST("game.maint.MessageSearchApplication:prefilter", a)
+{
+    GrowableBytes_t inbox = makeInbox(MESSAGES);
+    const std::vector<String_t> texts = decodeInbox(inbox);
+    a.checkEqual("01. getNumMessages", texts.size(), size_t(5));
+
+    // Collect queries
+    std::set<String_t> queries;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        for (size_t pos = 0; pos < texts[i].size(); ++pos) {
+            for (size_t len = 1; len <= 5; ++len) {
+                String_t q = texts[i].substr(pos, len);
+                if (isPlainQuery(q)) {
+                    queries.insert(q);
+                    queries.insert(swapCase(q));
+                }
+            }
+        }
+    }
+    queries.insert("Universal");
+    queries.insert("CC: 6");
+    queries.insert("Winplan message");
+    queries.insert("gr\xC3\xB6\xC3\x9F" "e");
+    queries.insert("Ma\xC3\x9F");
+    a.check("02. queries", queries.size() > 500);
+
+    // Search
+    for (std::set<String_t>::const_iterator it = queries.begin(); it != queries.end(); ++it) {
+        for (int caseSense = 0; caseSense < 2; ++caseSense) {
+            const String_t& q = *it;
+            String_t expect;
+            for (size_t i = 0; i < texts.size(); ++i) {
+                bool match = caseSense
+                    ? texts[i].find(q) != String_t::npos
+                    : afl::string::strUCase(texts[i]).find(afl::string::strUCase(q)) != String_t::npos;
+                if (match) {
+                    expect += Format("--- Message %d (inbox.dat) ---\n", i+1);
+                }
+            }
+
+            Environment env;
+            env.fs.openFile("inbox.dat", FileSystem::Create)->fullWrite(inbox);
+            afl::data::StringList_t args;
+            if (caseSense) {
+                args.push_back("-c");
+            }
+            args.push_back("-m");
+            args.push_back(q);
+            args.push_back("inbox.dat");
+            runApplication(env, args);
+
+            a(Format("%s, %s", q, caseSense ? "case-sensitive" : "case-insensitive"))
+                .checkEqual("03. output", getDividers(getContent(*env.output)), expect);
+        }
+    }
+}
+
+/** Test parallel search.
+    A: search multiple inboxes, an unknown file and a missing file, with '-j 1' and '-j 3'.
+    E: output and error output identical, in command-line order */
+AFL_TEST("game.maint.MessageSearchApplication:parallel", a)
+{
+    static const char*const FILES[] = { "a.dat", "b.dat", "unknown.dat", "c.dat", "missing.dat", "d.dat", "e.dat" };
+
+    String_t output[2], error[2];
+    for (int pass = 0; pass < 2; ++pass) {
+        Environment env;
+        env.fs.openFile("a.dat", FileSystem::Create)->fullWrite(makeInbox(MESSAGES));
+        env.fs.openFile("b.dat", FileSystem::Create)->fullWrite(makeInbox(afl::base::Memory<const char*const>(MESSAGES).subrange(1, 2)));
+        env.fs.openFile("unknown.dat", FileSystem::Create)->fullWrite(afl::string::toBytes("whatever"));
+        env.fs.openFile("c.dat", FileSystem::Create)->fullWrite(makeInbox(afl::base::Memory<const char*const>(MESSAGES).subrange(2)));
+        env.fs.openFile("d.dat", FileSystem::Create)->fullWrite(makeInbox(afl::base::Memory<const char*const>(MESSAGES).subrange(0, 2)));
+        env.fs.openFile("e.dat", FileSystem::Create)->fullWrite(makeInbox(afl::base::Memory<const char*const>(MESSAGES).subrange(4)));
+
+        afl::data::StringList_t args;
+        args.push_back("-j");
+        args.push_back(pass == 0 ? "1" : "3");
+        args.push_back("a");
+        for (size_t i = 0; i < sizeof(FILES)/sizeof(FILES[0]); ++i) {
+            args.push_back(FILES[i]);
+        }
+        runApplication(env, args);
+
+        output[pass] = getContent(*env.output);
+        error[pass] = getContent(*env.error);
+    }
+
+    a.checkEqual("01. dividers", getDividers(output[0]),
+                 "--- Message 1 (a.dat) ---\n"
+                 "--- Message 2 (a.dat) ---\n"
+                 "--- Message 3 (a.dat) ---\n"
+                 "--- Message 4 (a.dat) ---\n"
+                 "--- Message 5 (a.dat) ---\n"
+                 "--- Message 1 (b.dat) ---\n"
+                 "--- Message 2 (b.dat) ---\n"
+                 "--- Message 1 (c.dat) ---\n"
+                 "--- Message 2 (c.dat) ---\n"
+                 "--- Message 3 (c.dat) ---\n"
+                 "--- Message 1 (d.dat) ---\n"
+                 "--- Message 2 (d.dat) ---\n"
+                 "--- Message 1 (e.dat) ---\n");
+    a.check("02. error", error[0].find("unknown.dat") < error[0].find("missing.dat"));
+    a.checkEqual("03. output", output[1], output[0]);
+    a.checkEqual("04. error", error[1], error[0]);
+}
@@ -717,3 +717,69 @@ AFL_TEST("game.parser.MessageParser:marker", a)
     a.checkEqual("18. mi_DrawingShape", getValue<game::parser::MessageIntegerValue_t>(*info[0], game::parser::mi_DrawingShape, "shape"), 3);
     a.checkEqual("19. mi_Color",        getValue<game::parser::MessageIntegerValue_t>(*info[0], game::parser::mi_Color, "color"), 5);
 }
+
+/** Test template selection.
+    Templates are pre-selected by kind and required texts; this must not change the order in which templates are tried. */
+AFL_TEST("game.parser.MessageParser:selection", a)
+{
+    const char* FILE =
+        "config,A\n"
+        "  kind   = h\n"
+        "  check  = Alpha\n"
+        "  values = a\n"
+        "  assign = Which\n"
+        "  continue = yes\n"
+        "\n"
+        "config,Generic\n"
+        "  check  = Beta\n"
+        "  values = g\n"
+        "  assign = Which2\n"
+        "\n"
+        "config,B\n"
+        "  kind   = h\n"
+        "  check  = Beta\n"
+        "  values = b\n"
+        "  assign = Which2\n";
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    afl::io::ConstMemoryStream ms(afl::string::toBytes(FILE));
+
+    game::parser::MessageParser testee;
+    AFL_CHECK_SUCCEEDS(a("01. load"), testee.load(ms, tx, log));
+    a.checkEqual("02. getNumTemplates", testee.getNumTemplates(), 3U);
+    MockDataInterface ifc;
+
+    // Kind h, both texts: A (continue), then Generic (stop)
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        testee.parseMessage("(-h000) test\nalpha\nbeta\n", ifc, 30, info, tx, log);
+        a.checkEqual("11. size", info.size(), 1U);
+        a.checkEqual("12. WHICH",  getValue<game::parser::MessageConfigurationValue_t>(*info[0], "WHICH",  "Which"),  "a");
+        a.checkEqual("13. WHICH2", getValue<game::parser::MessageConfigurationValue_t>(*info[0], "WHICH2", "Which2"), "g");
+    }
+
+    // Kind h, only Alpha: A only
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        testee.parseMessage("(-h000) test\nalpha\n", ifc, 30, info, tx, log);
+        a.checkEqual("21. size", info.size(), 1U);
+        a.checkEqual("22. WHICH", getValue<game::parser::MessageConfigurationValue_t>(*info[0], "WHICH", "Which"), "a");
+        AFL_CHECK_THROWS(a("23. WHICH2"), getValue<game::parser::MessageConfigurationValue_t>(*info[0], "WHICH2", "Which2"), std::runtime_error);
+    }
+
+    // Other kind: Generic only
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        testee.parseMessage("(-x000) test\nalpha\nbeta\n", ifc, 30, info, tx, log);
+        a.checkEqual("31. size", info.size(), 1U);
+        a.checkEqual("32. WHICH2", getValue<game::parser::MessageConfigurationValue_t>(*info[0], "WHICH2", "Which2"), "g");
+        AFL_CHECK_THROWS(a("33. WHICH"), getValue<game::parser::MessageConfigurationValue_t>(*info[0], "WHICH", "Which"), std::runtime_error);
+    }
+
+    // No header
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        testee.parseMessage("alpha\n", ifc, 30, info, tx, log);
+        a.checkEqual("41. size", info.size(), 0U);
+    }
+}
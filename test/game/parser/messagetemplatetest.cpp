@@ -867,3 +867,30 @@ AFL_TEST("game.parser.MessageTemplate:match:iArray:fixed-position", a)
         a.check("21. match", !testee.match(m, MockDataInterface(), result));
     }
 }
+
+/** Test getRequiredKind(), getRequiredTexts(). */
+AFL_TEST("game.parser.MessageTemplate:requirements", a)
+{
+    game::parser::MessageTemplate testee(game::parser::MessageInformation::Ship, "foo");
+    testee.addMatchInstruction(testee.iMatchSubId, 'x');
+    testee.addMatchInstruction(testee.iMatchKind, 'h');
+    testee.addCheckInstruction(testee.iCheck + testee.sAny, 0, "Check this");
+    testee.addCheckInstruction(testee.iFail + testee.sAny, 0, "not this");
+    testee.addCheckInstruction(testee.iFind + testee.sAny, 0, "maybe this");
+    testee.addCheckInstruction(testee.iCheck + testee.sAny, 0, "%1 are cool");
+    testee.addCheckInstruction(testee.iParse + testee.sRelative, 1, "Id $ at ($,$)");
+    testee.addVariables("Id, X, Y");
+
+    int32_t kind = 0;
+    a.check("01. getRequiredKind", testee.getRequiredKind().get(kind));
+    a.checkEqual("02. kind", kind, 'h');
+
+    std::vector<String_t> texts;
+    testee.getRequiredTexts(texts);
+    a.checkEqual("11. size", texts.size(), 5U);
+    a.checkEqual("12. text", texts[0], "CHECK THIS");
+    a.checkEqual("13. text", texts[1], "ID ");
+    a.checkEqual("14. text", texts[2], " AT (");
+    a.checkEqual("15. text", texts[3], ",");
+    a.checkEqual("16. text", texts[4], ")");
+}
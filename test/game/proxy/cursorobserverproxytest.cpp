@@ -79,3 +79,52 @@ AFL_TEST("game.proxy.CursorObserverProxy", a)
     a.check("01. wait", sem.wait(1000));
     a.checkEqual("02. result", result, "Xaver");
 }
+
+/** Test coalescing of changes.
+    A: create a universe with two objects, and a CursorObserverProxy. Add an observer. Change the cursor repeatedly in one game-side request.
+    E: observer must see only the final object. */
+AFL_TEST("game.proxy.CursorObserverProxy:coalesce", a)
+{
+    // Environment
+    game::test::SessionThread s;
+
+    Ptr<Game> g = new Game();
+    for (int i = 1; i <= 2; ++i) {
+        IonStorm& obj = *g->currentTurn().universe().ionStorms().create(i);
+        obj.setName(i == 1 ? "Ann" : "Bob");
+        obj.setPosition(game::map::Point(1000, 2000));
+        obj.setRadius(300);
+        obj.setVoltage(50);
+    }
+    g->cursors().currentIonStorm().setCurrentIndex(1);
+    s.session().setGame(g);
+
+    // Tester
+    afl::sys::Semaphore sem(0);
+    String_t result;
+
+    game::proxy::CursorObserverProxy testee(s.gameSender(), std::auto_ptr<game::map::ObjectCursorFactory>(new CursorFactory()));
+    testee.addNewListener(new Listener(a, sem, result));
+    a.check("01. wait", sem.wait(1000));
+    a.checkEqual("02. result", result, "Ann");
+
+    // Browse back and forth
+    class Task : public util::Request<game::Session> {
+     public:
+        virtual void handle(game::Session& session)
+            {
+                game::map::ObjectCursor& c = session.getGame()->cursors().currentIonStorm();
+                c.setCurrentIndex(2);
+                c.setCurrentIndex(1);
+                c.setCurrentIndex(2);
+            }
+    };
+    s.gameSender().postNewRequest(new Task());
+
+    // Must see exactly one change
+    a.check("11. wait", sem.wait(1000));
+    a.checkEqual("12. result", result, "Bob");
+    s.sync();
+    s.sync();
+    a.check("13. wait", !sem.wait(0));
+}
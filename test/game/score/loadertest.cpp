@@ -444,3 +444,75 @@ AFL_TEST("game.score.Loader:save", a)
     a.checkEqual("75. baseSlot",      p->get(baseSlot,      9).orElse(-1), 4);
     a.checkEqual("76. pbpSlot",       p->get(pbpSlot,       9).orElse(-1), 1114);
 }
+
+/** Test update(): new turn is appended, result is identical to save(). */
+AFL_TEST("game.score.Loader:update:append", a)
+{
+    afl::string::NullTranslator tx;
+    afl::charset::Utf8Charset cs;
+    game::score::Loader testee(tx, cs);
+
+    game::score::TurnScoreList list;
+    game::score::TurnScore::Slot_t slot = list.addSlot(game::score::ScoreId_Planets);
+    list.addTurn(10, game::Timestamp(2020, 1, 10, 12, 0, 0)).set(slot, 1, 5);
+    list.addTurn(11, game::Timestamp(2020, 1, 11, 12, 0, 0)).set(slot, 1, 6);
+
+    afl::io::InternalStream file;
+    testee.save(list, file);
+
+    // Add a turn and update
+    list.addTurn(12, game::Timestamp(2020, 1, 12, 12, 0, 0)).set(slot, 1, 7);
+    a.checkEqual("01. update", testee.update(list, file), true);
+
+    // Verify
+    afl::io::InternalStream expect;
+    testee.save(list, expect);
+    a.checkEqualContent("11. content", file.getContent(), expect.getContent());
+}
+
+/** Test update(): changed turn is rewritten. */
+AFL_TEST("game.score.Loader:update:change", a)
+{
+    afl::string::NullTranslator tx;
+    afl::charset::Utf8Charset cs;
+    game::score::Loader testee(tx, cs);
+
+    game::score::TurnScoreList list;
+    game::score::TurnScore::Slot_t slot = list.addSlot(game::score::ScoreId_Planets);
+    list.addTurn(10, game::Timestamp(2020, 1, 10, 12, 0, 0)).set(slot, 1, 5);
+    list.addTurn(11, game::Timestamp(2020, 1, 11, 12, 0, 0)).set(slot, 1, 6);
+
+    afl::io::InternalStream file;
+    testee.save(list, file);
+
+    // Change a turn and update
+    list.addTurn(10, game::Timestamp(2020, 1, 10, 12, 0, 0)).set(slot, 2, 9);
+    a.checkEqual("01. update", testee.update(list, file), true);
+
+    // Verify
+    afl::io::InternalStream expect;
+    testee.save(list, expect);
+    a.checkEqualContent("11. content", file.getContent(), expect.getContent());
+}
+
+/** Test update(): changed schema cannot be updated. */
+AFL_TEST("game.score.Loader:update:schema", a)
+{
+    afl::string::NullTranslator tx;
+    afl::charset::Utf8Charset cs;
+    game::score::Loader testee(tx, cs);
+
+    game::score::TurnScoreList list;
+    game::score::TurnScore::Slot_t slot = list.addSlot(game::score::ScoreId_Planets);
+    list.addTurn(10, game::Timestamp(2020, 1, 10, 12, 0, 0)).set(slot, 1, 5);
+
+    afl::io::InternalStream file;
+    testee.save(list, file);
+    afl::io::InternalStream orig;
+    testee.save(list, orig);
+
+    // Add a score and update
+    list.addDescription(game::score::TurnScoreList::Description("Test", 77, 0, -1));
+    a.checkEqual("01. update", testee.update(list, file), false);
+    a.checkEqualContent("02. content", file.getContent(), orig.getContent());
+}
@@ -17,6 +17,7 @@
 #include "game/map/ship.hpp"
 #include "game/map/ufo.hpp"
 #include "game/map/universe.hpp"
+#include "game/test/counter.hpp"
 #include "game/test/registrationkey.hpp"
 #include "game/test/root.hpp"
 #include "game/test/specificationloader.hpp"
@@ -254,6 +255,55 @@ AFL_TEST("game.Session:tasks", a)
     a.checkEqual("24. getTaskStatus", testee.getTaskStatus(p, interpreter::Process::pkBaseTask, true),    game::Session::NoTask);
 }
 
+/** Test releaseAutoTaskEditor() with a time slice.
+    A: configure a time slice; release an auto task whose CC$AUTOEXEC exceeds it.
+    E: process is preempted, and sig_preempt tells the scheduler to continue it */
+AFL_TEST("game.Session:releaseAutoTaskEditor:preempt", a)
+{
+    afl::io::NullFileSystem fs;
+    afl::string::NullTranslator tx;
+    game::Session testee(tx, fs);
+    testee.setRoot(game::test::makeRoot(game::HostVersion()).asPtr());
+    afl::base::Ptr<game::Game> g = new game::Game();
+    game::map::Planet* p = g->currentTurn().universe().planets().create(17);
+    testee.setGame(g);
+
+    interpreter::ProcessList& pl = testee.processList();
+    pl.setTimeSlice(5);
+    game::test::Counter counter;
+    pl.sig_preempt.add(&counter, &game::test::Counter::increment);
+
+    // CC$AUTOEXEC mock that needs more than one time slice before suspending
+    interpreter::BCORef_t bco = interpreter::BytecodeObject::create(true);
+    bco->addArgument("A", false);
+    for (int i = 0; i < 10; ++i) {
+        bco->addInstruction(interpreter::Opcode::maPush, interpreter::Opcode::sInteger, 0);
+        bco->addInstruction(interpreter::Opcode::maStack, interpreter::Opcode::miStackDrop, 1);
+    }
+    bco->addInstruction(interpreter::Opcode::maSpecial, interpreter::Opcode::miSpecialSuspend, 0);
+    testee.world().setNewGlobalValue("CC$AUTOEXEC", new interpreter::SubroutineValue(bco));
+
+    // Create and release auto task
+    afl::base::Ptr<interpreter::TaskEditor> editor = testee.getAutoTaskEditor(17, interpreter::Process::pkPlanetTask, true);
+    a.checkNonNull("01. getAutoTaskEditor", editor.get());
+    String_t command[] = { "whatever" };
+    editor->addAtEnd(command);
+    editor->setPC(0);
+    testee.releaseAutoTaskEditor(editor);
+
+    // Process has been preempted, and the listener has been told
+    a.check("11. hasRunningProcesses", pl.hasRunningProcesses());
+    a.checkEqual("12. counter", counter.get(), 1);
+
+    // Continuing (as the listener would) finishes it
+    while (pl.hasRunningProcesses() && counter.get() < 100) {
+        pl.run();
+    }
+    a.check("21. hasRunningProcesses", !pl.hasRunningProcesses());
+    a.check("22. counter", counter.get() > 1);
+    a.checkEqual("23. getTaskStatus", testee.getTaskStatus(p, interpreter::Process::pkPlanetTask, false), game::Session::ActiveTask);
+}
+
 /** Test file character set handling. */
 AFL_TEST("game.Session:charset", a)
 {
@@ -97,3 +97,22 @@ AFL_TEST("game.sim.ClassResult:multiple", a)
     a.checkEqual("42. getWeight", cr2.getWeight(), 1);
     a.checkEqual("43. getSampleBattle", cr1.getSampleBattle().get(), res2.battles.get());
 }
+
+/** Test addSameClassResult() with a result that has no sample battle.
+    A: add result without battle to a result with battle.
+    E: sample battle retained */
+AFL_TEST("game.sim.ClassResult:no-sample", a)
+{
+    game::sim::Setup setup;
+    setup.addShip()->setOwner(4);
+
+    game::sim::Result res1; res1.battles = new game::vcr::classic::Database();
+    game::sim::Result res2;
+
+    game::sim::ClassResult cr1(setup, res1);
+    game::sim::ClassResult cr2(setup, res2);
+    cr1.addSameClassResult(cr2);
+
+    a.checkEqual("01. getWeight", cr1.getWeight(), 2);
+    a.checkEqual("02. getSampleBattle", cr1.getSampleBattle().get(), res1.battles.get());
+}
@@ -0,0 +1,354 @@
+/**
+  *  \file test/game/sim/consoleapplicationtest.cpp
+  *  \brief Test for game::sim::ConsoleApplication
+  */
+
+#include "game/sim/consoleapplication.hpp"
+
+#include "afl/charset/codepage.hpp"
+#include "afl/charset/codepagecharset.hpp"
+#include "afl/data/stringlist.hpp"
+#include "afl/io/internalfilesystem.hpp"
+#include "afl/io/internalstream.hpp"
+#include "afl/string/format.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/sys/internalenvironment.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/sim/loader.hpp"
+#include "game/sim/setup.hpp"
+#include "game/sim/ship.hpp"
+#include "game/test/files.hpp"
+#include "util/process/factory.hpp"
+#include "util/process/nullfactory.hpp"
+#include "util/process/subprocess.hpp"
+
+using afl::io::FileSystem;
+using game::sim::Ship;
+
+namespace {
+    String_t getContent(afl::io::InternalStream& s)
+    {
+        String_t result;
+        afl::base::ConstBytes_t bytes = s.getContent();
+        while (const uint8_t* p = bytes.eat()) {
+            if (*p != '\r') {
+                result.append(1, char(*p));
+            }
+        }
+        return result;
+    }
+
+    /* Split a command produced for /bin/sh into words. Handles single quotes only. */
+    afl::data::StringList_t splitShellWords(const String_t& command)
+    {
+        afl::data::StringList_t result;
+        String_t word;
+        bool haveWord = false, quoted = false;
+        for (size_t i = 0; i < command.size(); ++i) {
+            char ch = command[i];
+            if (ch == '\'') {
+                quoted = !quoted;
+                haveWord = true;
+            } else if (ch == ' ' && !quoted) {
+                if (haveWord) {
+                    result.push_back(word);
+                }
+                word.clear();
+                haveWord = false;
+            } else {
+                word += ch;
+                haveWord = true;
+            }
+        }
+        if (haveWord) {
+            result.push_back(word);
+        }
+        return result;
+    }
+
+    class WorkerFactory;
+
+    /* Worker process.
+       Instead of starting a process, runs a ConsoleApplication in worker mode on the collected input when output is first requested. */
+    class WorkerProcess : public util::process::Subprocess {
+     public:
+        WorkerProcess(WorkerFactory& parent)
+            : m_parent(parent), m_active(false), m_started(false), m_args(), m_input(), m_output(), m_outputPos(0)
+            { }
+        virtual bool isActive() const
+            { return m_active; }
+        virtual uint32_t getProcessId() const
+            { return 0; }
+        virtual bool start(const String_t& path, afl::base::Memory<const String_t> args);
+        virtual bool stop()
+            {
+                m_active = false;
+                return true;
+            }
+        virtual bool writeLine(const String_t& line)
+            {
+                m_input += line;
+                return m_active;
+            }
+        virtual bool readLine(String_t& result);
+        virtual String_t getStatus() const
+            { return String_t(); }
+
+     private:
+        WorkerFactory& m_parent;
+        bool m_active;
+        bool m_started;
+        afl::data::StringList_t m_args;
+        String_t m_input;
+        String_t m_output;
+        size_t m_outputPos;
+    };
+
+    /* Factory for WorkerProcess.
+       Records the command lines and input of all workers. */
+    class WorkerFactory : public util::process::Factory {
+     public:
+        WorkerFactory(afl::io::FileSystem& fs)
+            : fs(fs), commands(), inputs()
+            { }
+        virtual util::process::Subprocess* createNewProcess()
+            { return new WorkerProcess(*this); }
+
+        afl::io::FileSystem& fs;
+        afl::data::StringList_t commands;
+        afl::data::StringList_t inputs;
+    };
+
+    bool WorkerProcess::start(const String_t& path, afl::base::Memory<const String_t> args)
+    {
+        if (path != "/bin/sh" || args.size() != 2 || *args.at(0) != "-c") {
+            return false;
+        }
+
+        // Worker command line: everything after the command name
+        const String_t& cmd = *args.at(1);
+        m_parent.commands.push_back(cmd);
+        m_args = splitShellWords(cmd);
+        if (!m_args.empty()) {
+            m_args.erase(m_args.begin());
+        }
+        m_active = true;
+        m_started = false;
+        m_input.clear();
+        m_output.clear();
+        m_outputPos = 0;
+        return true;
+    }
+
+    bool WorkerProcess::readLine(String_t& result)
+    {
+        if (!m_active) {
+            return false;
+        }
+        if (!m_started) {
+            // Run worker
+            m_started = true;
+            m_parent.inputs.push_back(m_input);
+
+            afl::sys::InternalEnvironment env;
+            afl::base::Ref<afl::io::InternalStream> in = *new afl::io::InternalStream();
+            afl::base::Ref<afl::io::InternalStream> out = *new afl::io::InternalStream();
+            in->fullWrite(afl::string::toBytes(m_input));
+            in->setPos(0);
+            env.setCommandLine(m_args);
+            env.setChannelStream(afl::sys::Environment::Input, in.asPtr());
+            env.setChannelStream(afl::sys::Environment::Output, out.asPtr());
+            env.setChannelStream(afl::sys::Environment::Error, out.asPtr());
+
+            util::process::NullFactory factory;
+            game::sim::ConsoleApplication(env, m_parent.fs, factory).run();
+            m_output = getContent(*out);
+        }
+
+        // Produce a line
+        if (m_outputPos >= m_output.size()) {
+            return false;
+        }
+        size_t end = m_output.find('\n', m_outputPos);
+        end = (end == String_t::npos ? m_output.size() : end+1);
+        result.assign(m_output, m_outputPos, end - m_outputPos);
+        m_outputPos = end;
+        return true;
+    }
+
+    struct Environment {
+        afl::io::InternalFileSystem fs;
+        afl::sys::InternalEnvironment env;
+        afl::base::Ref<afl::io::InternalStream> output;
+        WorkerFactory factory;
+
+        Environment()
+            : fs(), env(),
+              output(*new afl::io::InternalStream()),
+              factory(fs)
+            {
+                env.setChannelStream(afl::sys::Environment::Output, output.asPtr());
+                env.setChannelStream(afl::sys::Environment::Error, output.asPtr());
+            }
+    };
+
+    /* Create specification files and a simulation setup.
+       The setup consists of two custom ships of different owners that fight each other. */
+    void prepare(Environment& env)
+    {
+        env.fs.createDirectory("/spec");
+        env.fs.openFile("/spec/beamspec.dat", FileSystem::Create)->fullWrite(game::test::getDefaultBeams());
+        env.fs.openFile("/spec/torpspec.dat", FileSystem::Create)->fullWrite(game::test::getDefaultTorpedoes());
+        env.fs.openFile("/spec/engspec.dat",  FileSystem::Create)->fullWrite(game::test::getDefaultEngines());
+        env.fs.openFile("/spec/hullspec.dat", FileSystem::Create)->fullWrite(game::test::getDefaultHulls());
+        env.fs.openFile("/spec/truehull.dat", FileSystem::Create)->fullWrite(game::test::getDefaultHullAssignments());
+        env.fs.openFile("/spec/race.nm",      FileSystem::Create)->fullWrite(game::test::getDefaultRaceNames());
+        env.fs.createDirectory("/game");
+
+        game::sim::Setup setup;
+        for (int i = 1; i <= 2; ++i) {
+            Ship* sh = setup.addShip();
+            sh->setId(i);
+            sh->setName(i == 1 ? "Attacker" : "Defender");
+            sh->setFriendlyCode("???");
+            sh->setOwner(i);
+            sh->setHullTypeOnly(0);
+            sh->setMass(150);
+            sh->setCrew(200);
+            sh->setShield(100);
+            sh->setDamage(0);
+            sh->setBeamType(5);
+            sh->setNumBeams(4);
+            sh->setEngineType(9);
+            sh->setAggressiveness(Ship::agg_Kill);
+        }
+
+        afl::charset::CodepageCharset cs(afl::charset::g_codepageLatin1);
+        afl::string::NullTranslator tx;
+        game::sim::Loader(cs, tx).save(*env.fs.openFile("/sim.ccb", FileSystem::Create), setup);
+    }
+
+    String_t run(Environment& env, const afl::data::StringList_t& args)
+    {
+        afl::data::StringList_t list;
+        list.push_back("-q");
+        list.push_back("-G");
+        list.push_back("/game");
+        list.push_back("-R");
+        list.push_back("/spec");
+        list.insert(list.end(), args.begin(), args.end());
+        list.push_back("/sim.ccb");
+        env.env.setCommandLine(list);
+        game::sim::ConsoleApplication(env.env, env.fs, env.factory).run();
+        return getContent(*env.output);
+    }
+
+    /* Get the "onlyOneSimulation" flag from the configuration sent to a worker */
+    String_t getOnlyOneFlag(const String_t& input)
+    {
+        afl::data::StringList_t words = splitShellWords(input.substr(0, input.find('\n')));
+        return words.size() == 10 && words[0] == "config" ? words[6] : String_t("?");
+    }
+}
+
+/** Test "--one" option.
+    A: run distributed simulation with "--one", "--one=no", "--no-one", and no option.
+    E: worker receives configuration with the correct flag */
+AFL_TEST("game.sim.ConsoleApplication:option:one", a)
+{
+    static const char*const OPTIONS[][2] = {
+        { "--one",     "1" },
+        { "--one=yes", "1" },
+        { "--one=no",  "0" },
+        { "--no-one",  "0" },
+        { 0,           "0" },
+    };
+    for (size_t i = 0; i < sizeof(OPTIONS)/sizeof(OPTIONS[0]); ++i) {
+        afl::test::Assert aa = a(OPTIONS[i][0] != 0 ? OPTIONS[i][0] : "default");
+        Environment env;
+        prepare(env);
+
+        afl::data::StringList_t args;
+        args.push_back("--run");
+        args.push_back("2");
+        args.push_back("--seed");
+        args.push_back("1");
+        args.push_back("--workers");
+        args.push_back("1");
+        if (OPTIONS[i][0] != 0) {
+            args.push_back(OPTIONS[i][0]);
+        }
+        run(env, args);
+
+        aa.checkEqual("01. inputs", env.factory.inputs.size(), 1U);
+        aa.checkEqual("02. flag", getOnlyOneFlag(env.factory.inputs[0]), OPTIONS[i][1]);
+    }
+}
+
+/** Test distributed simulation.
+    A: run 12 simulations locally, and distributed to 3 workers, with the same seed.
+    E: same output; workers receive their share of the serial numbers */
+AFL_TEST("game.sim.ConsoleApplication:workers", a)
+{
+    afl::data::StringList_t args;
+    args.push_back("--run");
+    args.push_back("12");
+    args.push_back("--seed");
+    args.push_back("77");
+
+    // Local
+    Environment localEnv;
+    prepare(localEnv);
+    String_t localOutput = run(localEnv, args);
+    a.check("01. results", localOutput.find("Results after 12 simulations") != String_t::npos);
+    a.checkEqual("02. commands", localEnv.factory.commands.size(), 0U);
+
+    // Distributed
+    Environment distEnv;
+    prepare(distEnv);
+    args.push_back("--workers");
+    args.push_back("3");
+    String_t distOutput = run(distEnv, args);
+    a.checkEqual("11. output", distOutput, localOutput);
+
+    // Workers
+    a.checkEqual("21. commands", distEnv.factory.commands.size(), 3U);
+    a.checkEqual("22. inputs",   distEnv.factory.inputs.size(), 3U);
+    for (size_t i = 0; i < 3; ++i) {
+        afl::test::Assert aa = a(afl::string::Format("worker %d", i));
+        aa.check("31. command", distEnv.factory.commands[i].find(" --worker -G '/game' -R '/spec'") != String_t::npos);
+        aa.check("32. input",   distEnv.factory.inputs[i].find(afl::string::Format(" %d 3 12\n", i+1)) != String_t::npos);
+        aa.check("33. input",   distEnv.factory.inputs[i].find("\nsetup ") != String_t::npos);
+    }
+}
+
+/** Test distributed simulation with explicit worker commands.
+    A: run 5 simulations distributed to two "--worker-command"s.
+    E: same output as local simulation; workers are started with the given commands */
+AFL_TEST("game.sim.ConsoleApplication:worker-command", a)
+{
+    afl::data::StringList_t args;
+    args.push_back("--run");
+    args.push_back("5");
+    args.push_back("--seed");
+    args.push_back("4711");
+
+    // Local
+    Environment localEnv;
+    prepare(localEnv);
+    String_t localOutput = run(localEnv, args);
+
+    // Distributed
+    Environment distEnv;
+    prepare(distEnv);
+    args.push_back("--worker-command");
+    args.push_back("first");
+    args.push_back("--worker-command");
+    args.push_back("second");
+    String_t distOutput = run(distEnv, args);
+    a.checkEqual("01. output", distOutput, localOutput);
+
+    a.checkEqual("11. commands", distEnv.factory.commands.size(), 2U);
+    a.checkEqual("12. command",  distEnv.factory.commands[0].substr(0, 15), "first --worker ");
+    a.checkEqual("13. command",  distEnv.factory.commands[1].substr(0, 16), "second --worker ");
+}
@@ -381,3 +381,60 @@ AFL_TEST("game.sim.ResultList:toString", a)
         a.checkDifferent("01", game::sim::toString(static_cast<game::sim::ResultList::UnitInfo::Type>(i), tx), "");
     }
 }
+
+/** Test isSampleNeeded().
+    A: add results, check isSampleNeeded() for various cases.
+    E: true for first result, new class, new extreme; false otherwise */
+AFL_TEST("game.sim.ResultList:isSampleNeeded", a)
+{
+    game::sim::ResultList testee;
+
+    Setup before;
+    addShip(a, before, 7, 0, 10);
+    addShip(a, before, 2, 0, 70);
+
+    Setup after;
+    addShip(a, after, 7, 20, 10);
+    addShip(a, after, 0, 100, 0);
+
+    Statistic stats[] = {
+        makeStatistic(5),
+        makeStatistic(15),
+    };
+
+    // First result always needs a sample
+    game::sim::Result result1 = makeResult(0);
+    a.checkEqual("01. isSampleNeeded", testee.isSampleNeeded(before, after, stats, result1), true);
+    testee.addResult(before, after, stats, result1);
+
+    // Identical result does not
+    game::sim::Result result2 = makeResult(1);
+    a.checkEqual("11. isSampleNeeded", testee.isSampleNeeded(before, after, stats, result2), false);
+
+    // Result without battles does not overwrite samples
+    result2.battles = 0;
+    testee.addResult(before, after, stats, result2);
+    a.checkEqual("12. getNumBattles", testee.getNumBattles(), 2U);
+    a.checkEqual("13. getSampleBattle", testee.getClassResult(0)->getSampleBattle().get(), result1.battles.get());
+    a.checkEqual("14. maxSpecimen", testee.getUnitResult(0)->getDamage().maxSpecimen.get(), result1.battles.get());
+
+    // New extreme: more damage
+    {
+        Setup after2(after);
+        after2.getShip(0)->setDamage(30);
+        a.checkEqual("21. isSampleNeeded", testee.isSampleNeeded(before, after2, stats, makeResult(2)), true);
+    }
+
+    // New class: ship survives
+    {
+        Setup after3(after);
+        after3.getShip(1)->setOwner(2);
+        after3.getShip(1)->setDamage(100);
+        a.checkEqual("31. isSampleNeeded", testee.isSampleNeeded(before, after3, stats, makeResult(3)), true);
+    }
+
+    // isSampleNeeded did not modify anything
+    a.checkEqual("41. getNumBattles", testee.getNumBattles(), 2U);
+    a.checkEqual("42. getNumClassResults", testee.getNumClassResults(), 1U);
+    a.checkEqual("43. max", testee.getUnitResult(0)->getDamage().max, 20);
+}
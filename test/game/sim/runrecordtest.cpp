@@ -0,0 +1,164 @@
+/**
+  *  \file test/game/sim/runrecordtest.cpp
+  *  \brief Test for game::sim::RunRecord
+  */
+
+#include "game/sim/runrecord.hpp"
+
+#include "afl/test/testrunner.hpp"
+#include "game/sim/planet.hpp"
+#include "game/sim/result.hpp"
+#include "game/sim/setup.hpp"
+#include "game/sim/ship.hpp"
+
+using game::sim::Planet;
+using game::sim::Result;
+using game::sim::RunRecord;
+using game::sim::Setup;
+using game::sim::Ship;
+using game::vcr::Statistic;
+
+namespace {
+    void prepare(Setup& setup)
+    {
+        Ship* sh = setup.addShip();
+        sh->setId(10);
+        sh->setOwner(3);
+        sh->setCrew(200);
+        sh->setNumLaunchers(4);
+        sh->setTorpedoType(5);
+        sh->setAmmo(50);
+        sh->setFriendlyCode("abc");
+
+        Ship* sh2 = setup.addShip();
+        sh2->setId(20);
+        sh2->setOwner(4);
+        sh2->setCrew(100);
+        sh2->setNumBays(3);
+        sh2->setAmmo(30);
+
+        Planet* pl = setup.addPlanet();
+        pl->setId(30);
+        pl->setOwner(5);
+        pl->setDefense(60);
+        pl->setNumBaseFighters(20);
+    }
+}
+
+/** Test round-trip: pack, format, parse, unpack.
+    A: pack a simulation result, transfer it as text.
+    E: unpacked state and statistics match the original result; unchanged properties are taken from the input. */
+AFL_TEST("game.sim.RunRecord:round-trip", a)
+{
+    Setup oldState;
+    prepare(oldState);
+
+    // Simulation result
+    Setup newState(oldState);
+    newState.getShip(0)->setDamage(30);
+    newState.getShip(0)->setShield(0);
+    newState.getShip(0)->setCrew(150);
+    newState.getShip(0)->setAmmo(22);
+    newState.getShip(1)->setOwner(3);
+    newState.getShip(1)->setAmmo(0);
+    newState.getPlanet()->setDefense(12);
+    newState.getPlanet()->setNumBaseFighters(7);
+    newState.getPlanet()->setShield(-1);
+
+    std::vector<Statistic> stats;
+    stats.push_back(Statistic(0, 17, 1));
+    stats.push_back(Statistic(4, 0, 2));
+    stats.push_back(Statistic(7, 0, 1));
+
+    Result res;
+    res.this_battle_index = 77;
+    res.num_battles = 2;
+    res.this_battle_weight = 59;
+    res.total_battle_weight = 100;
+    res.series_length = 220;
+
+    // Pack
+    RunRecord rec;
+    rec.pack(newState, stats, res);
+    a.checkEqual("01. getSerial", rec.getSerial(), 77);
+    a.check("02. hasBattles", rec.hasBattles());
+
+    // Transfer
+    RunRecord rec2;
+    a.check("11. parse", rec2.parse(rec.toString() + "\n"));
+    a.checkEqual("12. getSerial", rec2.getSerial(), 77);
+    a.checkEqual("13. toString", rec2.toString(), rec.toString());
+
+    // Unpack
+    Setup outState;
+    std::vector<Statistic> outStats;
+    Result outResult;
+    a.check("21. unpack", rec2.unpack(oldState, outState, outStats, outResult));
+    a.checkEqual("22. getNumShips", outState.getNumShips(), 2U);
+    a.checkEqual("23. damage", outState.getShip(0)->getDamage(), 30);
+    a.checkEqual("24. crew", outState.getShip(0)->getCrew(), 150);
+    a.checkEqual("25. ammo", outState.getShip(0)->getAmmo(), 22);
+    a.checkEqual("26. fcode", outState.getShip(0)->getFriendlyCode(), "abc");
+    a.checkEqual("27. owner", outState.getShip(1)->getOwner(), 3);
+    a.checkEqual("28. ammo", outState.getShip(1)->getAmmo(), 0);
+    a.checkEqual("29. id", outState.getShip(1)->getId(), 20);
+    a.check("30. planet", outState.getPlanet() != 0);
+    a.checkEqual("31. defense", outState.getPlanet()->getDefense(), 12);
+    a.checkEqual("32. fighters", outState.getPlanet()->getNumBaseFighters(), 7);
+    a.checkEqual("33. shield", outState.getPlanet()->getShield(), -1);
+
+    a.checkEqual("41. stats", outStats.size(), 3U);
+    a.checkEqual("42. torps", outStats[0].getNumTorpedoHits(), 17);
+    a.checkEqual("43. fighters", outStats[1].getMinFightersAboard(), 4);
+    a.checkEqual("44. fights", outStats[1].getNumFights(), 2);
+
+    a.checkEqual("51. this_battle_index", outResult.this_battle_index, 77);
+    a.checkEqual("52. num_battles", outResult.num_battles, 2);
+    a.checkEqual("53. this_battle_weight", outResult.this_battle_weight, 59);
+    a.checkEqual("54. total_battle_weight", outResult.total_battle_weight, 100);
+    a.checkEqual("55. series_length", outResult.series_length, 220);
+    a.checkNull("56. battles", outResult.battles.get());
+}
+
+/** Test record without battles.
+    A: pack a result that has no battles.
+    E: record is transferred, does not report battles, cannot be unpacked into the setup. */
+AFL_TEST("game.sim.RunRecord:no-battles", a)
+{
+    Setup oldState;
+    prepare(oldState);
+
+    Result res;
+    res.this_battle_index = 5;
+    res.num_battles = 0;
+
+    RunRecord rec;
+    rec.pack(oldState, afl::base::Nothing, res);
+
+    RunRecord rec2;
+    a.check("01. parse", rec2.parse(rec.toString()));
+    a.checkEqual("02. getSerial", rec2.getSerial(), 5);
+    a.check("03. hasBattles", !rec2.hasBattles());
+
+    Setup outState;
+    std::vector<Statistic> outStats;
+    Result outResult;
+    a.check("11. unpack", !rec2.unpack(oldState, outState, outStats, outResult));
+}
+
+/** Test parsing errors.
+    A: parse invalid lines.
+    E: parse() reports failure. */
+AFL_TEST("game.sim.RunRecord:parse:error", a)
+{
+    RunRecord rec;
+    a.check("01. empty",     !rec.parse(""));
+    a.check("02. prefix",    !rec.parse("X 1 0 1 1 1 0"));
+    a.check("03. short",     !rec.parse("R 1 0 1 1 1"));
+    a.check("04. units",     !rec.parse("R 1 1 1 1 1 1 3 0 0 0 0 0 0"));
+    a.check("05. garbage",   !rec.parse("R 1 0 1 1 1 0 x"));
+    a.check("06. overflow",  !rec.parse("R 99999999999 0 1 1 1 0"));
+    a.check("07. message",   !rec.parse("c2simtool: no game data found"));
+    a.check("08. negative",  rec.parse("R 1 1 1 1 1 1 3 -5 0 -1 0 0 0 0"));
+    a.check("09. valid",     rec.parse("R 1 0 1 1 1 0\r\n"));
+}
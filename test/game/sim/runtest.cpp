@@ -274,6 +274,34 @@ AFL_TEST("game.sim.Run:VcrHost", a)
     a.checkEqual("44. getOwner",  s2->getOwner(), 11);
 }
 
+/** Test Host simulation without battle recording.
+    A: prepare two ships, Host simulation, record_battles=false.
+    E: same result as "game.sim.Run:VcrHost", but no VCR database created */
+AFL_TEST("game.sim.Run:VcrHost:no-record", a)
+{
+    // Environment
+    TestHarness h;
+    setDeterministicConfig(h.opts, h.config, game::sim::Configuration::VcrHost, game::sim::Configuration::BalanceNone);
+
+    // Setup
+    Ship* s1 = addOutrider(a, h.setup, 1, 12, h.list);
+    Ship* s2 = addOutrider(a, h.setup, 2, 11, h.list);
+    h.result.init(h.opts, 0);
+    h.result.record_battles = false;
+
+    // Do it
+    game::sim::runSimulation(h.setup, h.stats, h.result, h.opts, h.list, h.config, h.flakConfiguration, h.rng);
+
+    // Verify result
+    a.checkNull ("01. battles",     h.result.battles.get());
+    a.checkEqual("02. num_battles", h.result.num_battles, 1);
+
+    a.checkEqual("11. getDamage", s1->getDamage(), 107);
+    a.checkEqual("12. getCrew",   s1->getCrew(), 103);
+    a.checkEqual("13. getDamage", s2->getDamage(), 82);
+    a.checkEqual("14. getCrew",   s2->getCrew(), 121);
+}
+
 /** Test basic Host simulation, big ships.
     A: prepare two ships, Host simulation.
     E: expected results and metadata produced (verified against PCC2 playvcr). */
@@ -1802,6 +1830,34 @@ AFL_TEST("game.sim.Run:VcrFLAK", a)
     a.checkEqual("44. getOwner",  s2->getOwner(), 0);
 }
 
+/** Test FLAK simulation without battle recording.
+    A: prepare two ships, FLAK simulation, record_battles=false.
+    E: same result as "game.sim.Run:VcrFLAK", but no VCR database created */
+AFL_TEST("game.sim.Run:VcrFLAK:no-record", a)
+{
+    // Environment
+    TestHarness h;
+    setDeterministicConfig(h.opts, h.config, game::sim::Configuration::VcrFLAK, game::sim::Configuration::BalanceNone);
+
+    // Setup
+    Ship* s1 = addOutrider(a, h.setup, 1, 12, h.list);
+    Ship* s2 = addOutrider(a, h.setup, 2, 11, h.list);
+    h.result.init(h.opts, 0);
+    h.result.record_battles = false;
+
+    // Do it
+    game::sim::runSimulation(h.setup, h.stats, h.result, h.opts, h.list, h.config, h.flakConfiguration, h.rng);
+
+    // Verify result
+    a.checkNull ("01. battles",     h.result.battles.get());
+    a.checkEqual("02. num_battles", h.result.num_battles, 1);
+
+    a.checkEqual("11. getDamage", s1->getDamage(), 71);
+    a.checkEqual("12. getCrew",   s1->getCrew(), 131);
+    a.checkEqual("13. getDamage", s2->getDamage(), 103);
+    a.checkEqual("14. getCrew",   s2->getCrew(), 109);
+}
+
 /** Test basic FLAK simulation, with ESB.
     A: prepare two ships, FLAK simulation.
     E: expected results and metadata produced. This is a regression test to ensure constant behaviour. */
@@ -942,3 +942,45 @@ AFL_TEST("game.sim.Setup:getInvolvedPlayers", a)
     a.checkEqual("01. getInvolvedPlayers", testee.getInvolvedPlayers(),   game::PlayerSet_t() + 1 + 2 + 4 + 7);
     a.checkEqual("02. getInvolvedTeams",   testee.getInvolvedTeams(team), game::PlayerSet_t() + 1         + 7 + 9);
 }
+
+/** Test assignment.
+    A: assign setups of same and different structure.
+    E: content copied; existing objects reused */
+AFL_TEST("game.sim.Setup:assign", a)
+{
+    Setup tpl;
+    tpl.addShip()->setId(10);
+    tpl.addShip()->setId(20);
+    tpl.addPlanet()->setId(30);
+
+    // Initial assignment
+    Setup testee;
+    testee = tpl;
+    a.checkEqual("01. getNumShips", testee.getNumShips(), 2U);
+    a.checkEqual("02. hasPlanet",   testee.hasPlanet(), true);
+    a.checkDifferent("03. getShip", testee.getShip(0), tpl.getShip(0));
+    Ship* sh0 = testee.getShip(0);
+    Planet* pl = testee.getPlanet();
+
+    // Modify and assign again: objects are reused
+    sh0->setId(99);
+    pl->setId(77);
+    testee = tpl;
+    a.checkEqual("11. getShip", testee.getShip(0), sh0);
+    a.checkEqual("12. getId",   sh0->getId(), 10);
+    a.checkEqual("13. getPlanet", testee.getPlanet(), pl);
+    a.checkEqual("14. getId",   pl->getId(), 30);
+
+    // Structure change
+    Setup other;
+    other.addShip()->setId(5);
+    testee = other;
+    a.checkEqual("21. getNumShips", testee.getNumShips(), 1U);
+    a.checkEqual("22. getId",       testee.getShip(0)->getId(), 5);
+    a.checkEqual("23. hasPlanet",   testee.hasPlanet(), false);
+
+    testee = tpl;
+    a.checkEqual("31. getNumShips", testee.getNumShips(), 2U);
+    a.checkEqual("32. getId",       testee.getShip(1)->getId(), 20);
+    a.checkEqual("33. getId",       testee.getPlanet()->getId(), 30);
+}
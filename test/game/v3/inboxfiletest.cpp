@@ -227,6 +227,13 @@ AFL_TEST("game.v3.InboxFile:loadMessage", a)
                  "external player utilities and can\n"
                  "be safely ignored.");
     a.checkEqual("05. loadMessage", testee.loadMessage(3), "");
+
+    // Raw access
+    afl::base::GrowableBytes_t data;
+    a.check("11. loadMessageData", testee.loadMessageData(1, data));
+    a.checkEqual("12. size", data.size(), 0xA0U);
+    a.checkEqual("13. decodeMessageData", testee.decodeMessageData(data), testee.loadMessage(1));
+    a.check("14. loadMessageData", !testee.loadMessageData(3, data));
 }
 
 /** Test inbox file errors.
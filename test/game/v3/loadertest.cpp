@@ -7,6 +7,7 @@
 
 #include "afl/charset/utf8charset.hpp"
 #include "afl/except/fileformatexception.hpp"
+#include "afl/except/fileproblemexception.hpp"
 #include "afl/io/constmemorystream.hpp"
 #include "afl/io/internaldirectory.hpp"
 #include "afl/io/internalfilesystem.hpp"
@@ -549,6 +550,114 @@ AFL_TEST("game.v3.Loader:loadBases", a)
     }
 }
 
+/** Test loadTargets().
+    Load two plaintext targets.
+    Ships must be updated; all data must be consumed. */
+AFL_TEST("game.v3.Loader:loadTargets", a)
+{
+    game::v3::structures::ShipTarget data[2];
+    afl::base::fromObject(data).fill(0);
+    data[0].shipId = 5;
+    data[0].owner = 3;
+    data[0].hullType = 15;
+    data[0].heading = -1;
+    data[1].shipId = 7;
+    data[1].owner = 4;
+    data[1].hullType = 16;
+    data[1].heading = -1;
+
+    afl::charset::Utf8Charset cs;
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    game::map::Universe univ;
+    afl::io::ConstMemoryStream ms(afl::base::fromObject(data));
+
+    game::v3::Loader testee(cs, tx, log);
+    testee.prepareUniverse(univ);
+    AFL_CHECK_SUCCEEDS(a("01. loadTargets"), testee.loadTargets(univ, ms, 2, game::v3::Loader::TargetPlaintext, game::PlayerSet_t(4), 10));
+
+    a.checkEqual("11. getOwner", univ.ships().get(5)->getOwner().orElse(0), 3);
+    a.checkEqual("12. getHull",  univ.ships().get(5)->getHull().orElse(0), 15);
+    a.checkEqual("13. getOwner", univ.ships().get(7)->getOwner().orElse(0), 4);
+    a.checkEqual("14. getHull",  univ.ships().get(7)->getHull().orElse(0), 16);
+    a.checkEqual("15. getPos",   ms.getPos(), sizeof(data));
+}
+
+/** Test loading a truncated section.
+    Sections are read as a block before being decoded.
+    A truncated file must fail, without modifying any object. */
+AFL_TEST("game.v3.Loader:truncated", a)
+{
+    afl::charset::Utf8Charset cs;
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    game::v3::Loader testee(cs, tx, log);
+
+    // Planets: two records, three expected
+    {
+        game::v3::structures::Planet data[2];
+        afl::base::fromObject(data).fill(0);
+        data[0].planetId = 20;
+        data[0].owner = 4;
+        data[1].planetId = 30;
+        data[1].owner = 4;
+
+        game::map::Universe univ;
+        testee.prepareUniverse(univ);
+        afl::io::ConstMemoryStream ms(afl::base::fromObject(data));
+        AFL_CHECK_THROWS(a("01. loadPlanets"), testee.loadPlanets(univ, ms, 3, game::v3::Loader::LoadCurrent, game::PlayerSet_t(4)), afl::except::FileProblemException);
+        a.check("02. planet", !univ.planets().get(20)->getOwner().isValid());
+    }
+
+    // Ships: one and a half records
+    {
+        game::v3::structures::Ship data[2];
+        afl::base::fromObject(data).fill(0);
+        data[0].shipId = 65;
+        data[0].owner = 10;
+
+        game::map::Universe univ;
+        testee.prepareUniverse(univ);
+        afl::io::ConstMemoryStream ms(afl::base::fromObject(data).trim(sizeof(data[0]) * 3/2));
+        AFL_CHECK_THROWS(a("11. loadShips"), testee.loadShips(univ, ms, 2, game::v3::Loader::LoadCurrent, false, game::PlayerSet_t(10)), afl::except::FileProblemException);
+        a.check("12. ship", !univ.ships().get(65)->getOwner().isValid());
+    }
+
+    // Targets: one record, minus one byte
+    {
+        game::v3::structures::ShipTarget data;
+        afl::base::fromObject(data).fill(0);
+        data.shipId = 5;
+        data.owner = 3;
+
+        game::map::Universe univ;
+        testee.prepareUniverse(univ);
+        afl::io::ConstMemoryStream ms(afl::base::fromObject(data).trim(sizeof(data) - 1));
+        AFL_CHECK_THROWS(a("21. loadTargets"), testee.loadTargets(univ, ms, 1, game::v3::Loader::TargetPlaintext, game::PlayerSet_t(4), 10), afl::except::FileProblemException);
+        a.check("22. ship", !univ.ships().get(5)->getOwner().isValid());
+    }
+}
+
+/** Test loading empty sections.
+    A zero or negative count must not read anything. */
+AFL_TEST("game.v3.Loader:empty", a)
+{
+    afl::charset::Utf8Charset cs;
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    game::v3::Loader testee(cs, tx, log);
+    game::map::Universe univ;
+    testee.prepareUniverse(univ);
+
+    static const uint8_t DATA[] = { 1, 2, 3 };
+    afl::io::ConstMemoryStream ms(DATA);
+    AFL_CHECK_SUCCEEDS(a("01. loadPlanets"), testee.loadPlanets(univ, ms, 0, game::v3::Loader::LoadCurrent, game::PlayerSet_t(4)));
+    AFL_CHECK_SUCCEEDS(a("02. loadBases"),   testee.loadBases(univ, ms, -1, game::v3::Loader::LoadCurrent, game::PlayerSet_t(4)));
+    AFL_CHECK_SUCCEEDS(a("03. loadShips"),   testee.loadShips(univ, ms, 0, game::v3::Loader::LoadCurrent, false, game::PlayerSet_t(4)));
+    AFL_CHECK_SUCCEEDS(a("04. loadTargets"), testee.loadTargets(univ, ms, -5, game::v3::Loader::TargetEncrypted, game::PlayerSet_t(4), 10));
+    a.checkEqual("05. getPos", ms.getPos(), 0U);
+}
+
 /** Test loadTurnfile(), success case.
     Prepare a universe with three objects.
     Load a turn file refering to the three objects.
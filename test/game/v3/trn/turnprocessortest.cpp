@@ -0,0 +1,104 @@
+/**
+  *  \file test/game/v3/trn/turnprocessortest.cpp
+  *  \brief Test for game::v3::trn::TurnProcessor
+  */
+
+#include "game/v3/trn/turnprocessor.hpp"
+
+#include "afl/charset/codepage.hpp"
+#include "afl/charset/codepagecharset.hpp"
+#include "afl/checksums/bytesum.hpp"
+#include "afl/io/internalstream.hpp"
+#include "afl/string/format.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/timestamp.hpp"
+
+using afl::charset::Charset;
+using afl::string::Format;
+using game::v3::TurnFile;
+using game::v3::TurnFileView;
+
+namespace {
+    /* TurnProcessor that records all callbacks */
+    class Recorder : public game::v3::trn::TurnProcessor {
+     public:
+        virtual void handleInvalidCommand(int code)
+            { m_log += Format("invalid %d\n", code); }
+        virtual void validateShip(int id)
+            { m_log += Format("validateShip %d\n", id); }
+        virtual void validatePlanet(int id)
+            { m_log += Format("validatePlanet %d\n", id); }
+        virtual void validateBase(int id)
+            { m_log += Format("validateBase %d\n", id); }
+
+        virtual void getShipData(int /*id*/, Ship_t& out, Charset& /*charset*/)
+            { afl::base::fromObject(out).fill(0); }
+        virtual void getPlanetData(int /*id*/, Planet_t& out, Charset& /*charset*/)
+            { afl::base::fromObject(out).fill(0); }
+        virtual void getBaseData(int /*id*/, Base_t& out, Charset& /*charset*/)
+            { afl::base::fromObject(out).fill(0); }
+
+        virtual void storeShipData(int id, const Ship_t& in, Charset& /*charset*/)
+            { m_log += Format("ship %d: %d\n", id, checksum(afl::base::fromObject(in))); }
+        virtual void storePlanetData(int id, const Planet_t& in, Charset& /*charset*/)
+            { m_log += Format("planet %d: %d\n", id, checksum(afl::base::fromObject(in))); }
+        virtual void storeBaseData(int id, const Base_t& in, Charset& /*charset*/)
+            { m_log += Format("base %d: %d\n", id, checksum(afl::base::fromObject(in))); }
+
+        virtual void addMessage(int to, String_t text)
+            { m_log += Format("message %d: %s\n", to, text); }
+        virtual void addNewPassword(const NewPassword_t& /*pass*/)
+            { m_log += "password\n"; }
+        virtual void addAllianceCommand(String_t text)
+            { m_log += Format("allies %s\n", text); }
+
+        const String_t& getLog() const
+            { return m_log; }
+
+     private:
+        static uint32_t checksum(afl::base::ConstBytes_t data)
+            { return afl::checksums::ByteSum().add(data, 0); }
+
+        String_t m_log;
+    };
+}
+
+/** Test processing a TurnFileView.
+    A: create a turn file with unsorted commands. Process it as TurnFile and as TurnFileView.
+    E: both produce the same callbacks, in canonical order */
+AFL_TEST("game.v3.trn.TurnProcessor:handleTurnFile:view", a)
+{
+    // Create turn file
+    afl::charset::CodepageCharset cs(afl::charset::g_codepage437);
+    afl::string::NullTranslator tx;
+    game::Timestamp ts(2000, 12, 24, 18, 30, 0);
+    TurnFile trn(cs, 7, ts);
+
+    static const uint8_t WORD_ARG[] = {7,0};
+    static const uint8_t MSG_ARG[] = {'h','i'};
+    trn.addCommand(game::v3::tcm_BaseChangeMission, 50, WORD_ARG);
+    trn.addCommand(game::v3::tcm_ShipChangeMission, 100, WORD_ARG);
+    trn.addCommand(game::v3::tcm_ShipChangeSpeed, 1, WORD_ARG);
+    trn.sendMessageData(7, 5, MSG_ARG);
+    trn.addCommand(game::v3::tcm_PlanetChangeFactories, 30, WORD_ARG);
+    trn.addCommand(game::v3::tcm_ShipChangeMission, 1, WORD_ARG);
+    trn.update();
+
+    afl::io::InternalStream s;
+    trn.write(s);
+
+    // Process as TurnFileView
+    Recorder viewRecorder;
+    TurnFileView view(s.getContent(), "player7.trn", tx);
+    viewRecorder.handleTurnFile(view, cs);
+
+    // Process as TurnFile
+    Recorder fileRecorder;
+    fileRecorder.handleTurnFile(trn, cs);
+
+    a.checkEqual("01. log", viewRecorder.getLog(), fileRecorder.getLog());
+    a.checkEqual("02. log", viewRecorder.getLog().substr(0, 30), "validateShip 1\nvalidateShip 1\n");
+    a.check("03. order", viewRecorder.getLog().find("ship 100") < viewRecorder.getLog().find("planet 30"));
+    a.check("04. order", viewRecorder.getLog().find("base 50") < viewRecorder.getLog().find("message 5: hi"));
+}
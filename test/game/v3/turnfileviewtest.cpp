@@ -0,0 +1,149 @@
+/**
+  *  \file test/game/v3/turnfileviewtest.cpp
+  *  \brief Test for game::v3::TurnFileView
+  */
+
+#include "game/v3/turnfileview.hpp"
+
+#include "afl/charset/codepage.hpp"
+#include "afl/charset/codepagecharset.hpp"
+#include "afl/except/fileformatexception.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/internalstream.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/test/testrunner.hpp"
+
+using afl::base::ConstBytes_t;
+using afl::charset::CodepageCharset;
+using afl::except::FileFormatException;
+using afl::io::ConstMemoryStream;
+using afl::io::InternalStream;
+using afl::string::NullTranslator;
+using game::Timestamp;
+using game::v3::TurnFile;
+using game::v3::TurnFileView;
+
+namespace {
+    /* Create a turn file with a FC change, a message, and the given features. */
+    void makeTurn(InternalStream& out, TurnFile::FeatureSet_t features)
+    {
+        CodepageCharset cs(afl::charset::g_codepage437);
+        TurnFile trn(cs, 3, Timestamp(2000, 12, 24, 18, 30, 0));
+        trn.setFeatures(features);
+
+        static const uint8_t FC[] = { 'a','b','c' };
+        trn.addCommand(game::v3::tcm_ShipChangeFc, 77, FC);
+
+        static const uint8_t MSG[] = { 'h','i' };
+        trn.sendMessageData(3, 5, MSG);
+
+        trn.update();
+        trn.write(out);
+    }
+}
+
+/** Test viewing a turn file.
+    A: create a turn file using TurnFile; create a TurnFileView for it.
+    E: headers and commands correctly reported, command data refers to the original file content */
+AFL_TEST("game.v3.TurnFileView:basics", a)
+{
+    InternalStream file;
+    makeTurn(file, TurnFile::FeatureSet_t(TurnFile::WinplanFeature));
+
+    NullTranslator tx;
+    TurnFileView testee(file.getContent(), "t.trn", tx);
+
+    a.checkEqual("01. getPlayer",      testee.getPlayer(), 3);
+    a.checkEqual("02. getTimestamp",   testee.getTimestamp().getTimestampAsString(), "12-24-200018:30:00");
+    a.checkEqual("03. getFeatures",    testee.getFeatures(), TurnFile::FeatureSet_t(TurnFile::WinplanFeature));
+    a.checkEqual("04. getNumCommands", testee.getNumCommands(), 2U);
+    a.checkEqual("05. getContent",     testee.getContent().size(), file.getContent().size());
+
+    // First command
+    TurnFile::CommandCode_t code;
+    int id, length;
+    a.check("11. getCommandCode",   testee.getCommandCode(0, code));
+    a.checkEqual("12. code",        code, uint32_t(game::v3::tcm_ShipChangeFc));
+    a.check("13. getCommandId",     testee.getCommandId(0, id));
+    a.checkEqual("14. id",          id, 77);
+    a.check("15. getCommandLength", testee.getCommandLength(0, length));
+    a.checkEqual("16. length",      length, 3);
+
+    ConstBytes_t data = testee.getCommandData(0);
+    a.checkEqual("21. data", afl::string::fromBytes(data.trim(3)), "abc");
+    // - data starts after header (28), padding (1), pointers (2*4), command code and Id (4)
+    a.check("22. data pointer", data.unsafeData() == file.getContent().subrange(41).unsafeData());
+
+    // Second command
+    a.check("31. getCommandCode",   testee.getCommandCode(1, code));
+    a.checkEqual("32. code",        code, uint32_t(game::v3::tcm_SendMessage));
+    a.check("33. getCommandLength", testee.getCommandLength(1, length));
+    a.checkEqual("34. length",      length, 6);
+
+    // Out of range
+    size_t pos;
+    a.check("41. getCommandCode",     !testee.getCommandCode(2, code));
+    a.check("42. getCommandPosition", !testee.getCommandPosition(2, pos));
+    a.check("43. getCommandData",     testee.getCommandData(2).empty());
+}
+
+/** Test header-only mode.
+    A: create a turn file; create a header-only TurnFileView for it.
+    E: headers correctly reported, no commands */
+AFL_TEST("game.v3.TurnFileView:header-only", a)
+{
+    InternalStream file;
+    makeTurn(file, TurnFile::FeatureSet_t());
+
+    NullTranslator tx;
+    TurnFileView testee(file.getContent(), "t.trn", tx, false);
+
+    a.checkEqual("01. getPlayer",      testee.getPlayer(), 3);
+    a.checkEqual("02. getFeatures",    testee.getFeatures(), TurnFile::FeatureSet_t());
+    a.checkEqual("03. getNumCommands", testee.getNumCommands(), 0U);
+    a.checkEqual("04. numCommands",    testee.getTurnHeader().numCommands, 2);
+}
+
+/** Test constructing from a FileMapping, and a TurnFile from the view.
+    A: create a turn file; create a TurnFileView from a mapping; create a TurnFile from the view.
+    E: TurnFile has same content as original file */
+AFL_TEST("game.v3.TurnFileView:mapping", a)
+{
+    InternalStream file;
+    makeTurn(file, TurnFile::FeatureSet_t(TurnFile::WinplanFeature));
+
+    NullTranslator tx;
+    ConstMemoryStream ms(file.getContent());
+    TurnFileView view(ms.createVirtualMapping(), ms.getName(), tx);
+
+    CodepageCharset cs(afl::charset::g_codepage437);
+    TurnFile copy(cs, view);
+    a.checkEqual("01. getNumCommands", copy.getNumCommands(), 2U);
+    a.checkEqual("02. getVersion",     copy.getVersion(), view.getVersion());
+
+    InternalStream out;
+    copy.write(out);
+    a.checkEqualContent("11. content", out.getContent(), file.getContent());
+}
+
+/** Test error handling.
+    A: create views of damaged files.
+    E: FileFormatException */
+AFL_TEST("game.v3.TurnFileView:error", a)
+{
+    InternalStream file;
+    makeTurn(file, TurnFile::FeatureSet_t());
+    NullTranslator tx;
+
+    // Truncated header
+    AFL_CHECK_THROWS(a("01. truncated"), TurnFileView(file.getContent().trim(10), "t.trn", tx), FileFormatException);
+
+    // Command count too large
+    afl::base::GrowableBytes_t copy;
+    copy.append(file.getContent());
+    *copy.at(5) = 0x70;
+    AFL_CHECK_THROWS(a("11. command count"), TurnFileView(ConstBytes_t(copy), "t.trn", tx), FileFormatException);
+
+    // Header-only does not look at commands
+    AFL_CHECK_SUCCEEDS(a("21. header-only"), TurnFileView(ConstBytes_t(copy), "t.trn", tx, false));
+}
@@ -7,11 +7,14 @@
 
 #include "afl/charset/codepage.hpp"
 #include "afl/charset/codepagecharset.hpp"
+#include "afl/except/fileproblemexception.hpp"
 #include "afl/io/constmemorystream.hpp"
 #include "afl/io/internalstream.hpp"
 #include "afl/string/nulltranslator.hpp"
 #include "afl/test/testrunner.hpp"
 #include "game/config/hostconfiguration.hpp"
+#include "game/spec/shiplist.hpp"
+#include "game/test/shiplist.hpp"
 
 namespace {
     // FLAK0 flak.hst
@@ -455,3 +458,93 @@ AFL_TEST("game.vcr.flak.Database", a)
     a.checkEqual("31. save size", out.getContent().size(), sizeof(FILE_CONTENT));
     a.checkEqualContent("32. content", out.getContent().subrange(SKIP), afl::base::ConstBytes_t(FILE_CONTENT).subrange(SKIP));
 }
+
+/** Test partial save and repeated access.
+    Battles are decoded on demand; saving must reproduce the records without needing the battles. */
+AFL_TEST("game.vcr.flak.Database:save:partial", a)
+{
+    game::vcr::flak::Database testee;
+    game::config::HostConfiguration config;
+    afl::io::ConstMemoryStream ms(FILE_CONTENT);
+    afl::charset::CodepageCharset cs(afl::charset::g_codepageLatin1);
+    afl::string::NullTranslator tx;
+    testee.load(ms, cs, tx);
+
+    // Access battles repeatedly; must produce consistent results
+    for (int i = 0; i < 3; ++i) {
+        a.checkNonNull("01. getBattle", testee.getBattle(2));
+        a.checkEqual("02. getNumObjects", testee.getBattle(2)->getNumObjects(), 8U);
+    }
+    a.checkNull("03. getBattle", testee.getBattle(3));
+
+    // Save battles 1+2 into new database
+    afl::io::InternalStream out;
+    testee.save(out, 1, 2, config, cs);
+    out.setPos(0);
+
+    game::vcr::flak::Database copy;
+    AFL_CHECK_SUCCEEDS(a("11. load"), copy.load(out, cs, tx));
+    a.checkEqual("12. getNumBattles", copy.getNumBattles(), 2U);
+    a.checkEqual("13. getNumObjects", copy.getBattle(1)->getNumObjects(), 8U);
+    a.checkEqual("14. getObject",     copy.getBattle(1)->getObject(7, false)->getName(), "Grautvornix");
+}
+
+/** Test loading a truncated file.
+    Must be rejected by load(), even though battles are not decoded yet. */
+AFL_TEST("game.vcr.flak.Database:load:truncated", a)
+{
+    game::vcr::flak::Database testee;
+    afl::base::ConstBytes_t content(FILE_CONTENT);
+    content.trim(sizeof(FILE_CONTENT) - 10);
+    afl::io::ConstMemoryStream ms(content);
+    afl::charset::CodepageCharset cs(afl::charset::g_codepageLatin1);
+    afl::string::NullTranslator tx;
+    AFL_CHECK_THROWS(a, testee.load(ms, cs, tx), afl::except::FileProblemException);
+    a.checkEqual("getNumBattles", testee.getNumBattles(), 0U);
+}
+
+/** Test that results survive eviction.
+    A: load a file with many battles. Prepare the result of one battle, then access enough other battles to evict it.
+    E: when the battle is accessed again, its result is still available. */
+AFL_TEST("game.vcr.flak.Database:evict:result", a)
+{
+    // Make a file containing 10 copies of each battle from FILE_CONTENT
+    const size_t HEADER = sizeof(game::vcr::flak::structures::Header);
+    afl::base::GrowableBytes_t content;
+    content.append(afl::base::ConstBytes_t(FILE_CONTENT).trim(HEADER));
+    *content.at(14) = 30;
+    for (int i = 0; i < 10; ++i) {
+        content.append(afl::base::ConstBytes_t(FILE_CONTENT).subrange(HEADER));
+    }
+
+    game::vcr::flak::Database testee;
+    afl::io::ConstMemoryStream ms(content);
+    afl::charset::CodepageCharset cs(afl::charset::g_codepageLatin1);
+    afl::string::NullTranslator tx;
+    testee.load(ms, cs, tx);
+    a.checkEqual("01. getNumBattles", testee.getNumBattles(), 30U);
+
+    // Prepare result
+    game::config::HostConfiguration config;
+    game::spec::ShipList shipList;
+    game::test::initStandardBeams(shipList);
+    game::test::initStandardTorpedoes(shipList);
+    game::vcr::flak::Battle* b = testee.getBattle(2);
+    a.checkNonNull("11. getBattle", b);
+    b->prepareResult(config, shipList, game::vcr::Battle::NeedCompleteResult);
+    a.checkNonNull("12. getObject", b->getObject(7, true));
+    const int damage = b->getObject(7, true)->getDamage();
+    game::vcr::flak::Battle::Result* result = b->getResult().get();
+
+    // Access all other battles
+    for (size_t i = 3; i < 30; ++i) {
+        a.checkNonNull("21. getBattle", testee.getBattle(i));
+    }
+
+    // Access original battle again
+    b = testee.getBattle(2);
+    a.checkNonNull("31. getBattle", b);
+    a.checkEqual("32. getResult", b->getResult().get(), result);
+    a.checkNonNull("33. getObject", b->getObject(7, true));
+    a.checkEqual("34. getDamage", b->getObject(7, true)->getDamage(), damage);
+}
@@ -117,7 +117,7 @@ AFL_TEST("game.vcr.Overview:buildDiagram", a)
         ->setType(game::vcr::classic::Host, 0);
 
     // Testee
-    game::vcr::Overview ov(db, config, shipList);
+    game::vcr::Overview ov(db, config, shipList, 1);
 
     game::vcr::Overview::Diagram diag;
     ov.buildDiagram(diag, players, tx);
@@ -195,7 +195,7 @@ AFL_TEST("game.vcr.Overview:buildDiagram:kill", a)
         ->setType(game::vcr::classic::Host, 0);
 
     // Testee
-    game::vcr::Overview ov(db, config, shipList);
+    game::vcr::Overview ov(db, config, shipList, 1);
 
     game::vcr::Overview::Diagram diag;
     ov.buildDiagram(diag, players, tx);
@@ -236,7 +236,7 @@ AFL_TEST("game.vcr.Overview:buildDiagram:stalemate", a)
         ->setType(game::vcr::classic::Host, 0);
 
     // Testee
-    game::vcr::Overview ov(db, config, shipList);
+    game::vcr::Overview ov(db, config, shipList, 1);
 
     game::vcr::Overview::Diagram diag;
     ov.buildDiagram(diag, players, tx);
@@ -274,7 +274,7 @@ AFL_TEST("game.vcr.Overview:buildScoreSummary:kill", a)
         ->setType(game::vcr::classic::Host, 0);
 
     // Testee
-    game::vcr::Overview ov(db, config, shipList);
+    game::vcr::Overview ov(db, config, shipList, 1);
 
     game::vcr::Overview::ScoreSummary sum;
     ov.buildScoreSummary(sum);
@@ -0,0 +1,170 @@
+/**
+  *  \file test/game/vcr/resultpreparertest.cpp
+  *  \brief Test for game::vcr::ResultPreparer
+  */
+
+#include "game/vcr/resultpreparer.hpp"
+
+#include <stdexcept>
+#include "afl/string/format.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/test/shiplist.hpp"
+#include "game/vcr/battle.hpp"
+#include "game/vcr/classic/battle.hpp"
+#include "game/vcr/classic/database.hpp"
+
+namespace {
+    game::vcr::Object makeShip(int id, int owner, int mass, int numBeams)
+    {
+        game::vcr::Object r;
+        r.setMass(mass);
+        r.setShield(100);
+        r.setDamage(0);
+        r.setCrew(100);
+        r.setId(id);
+        r.setOwner(owner);
+        r.setNumBeams(numBeams);
+        r.setBeamType(numBeams != 0 ? 5 : 0);
+        r.setName(afl::string::Format("S%d", id));
+        return r;
+    }
+
+    void addBattles(game::vcr::classic::Database& db, int n)
+    {
+        for (int i = 0; i < n; ++i) {
+            db.addNewBattle(new game::vcr::classic::Battle(makeShip(i, 1, 100 + i, 2), makeShip(1000+i, 2, 200, 1 + i%5), uint16_t(i+1), 0, 0))
+                ->setType(game::vcr::classic::Host, 0);
+        }
+    }
+
+    /* Database that claims to keep only a few battles */
+    class SmallDatabase : public game::vcr::classic::Database {
+     public:
+        virtual size_t getMaxLiveBattles() const
+            { return 3; }
+    };
+
+    /* Battle that fails to prepare its result */
+    class FailingBattle : public game::vcr::classic::Battle {
+     public:
+        FailingBattle(const game::vcr::Object& left, const game::vcr::Object& right)
+            : Battle(left, right, 1, 0, 0)
+            { }
+        virtual void prepareResult(const game::config::HostConfiguration& /*config*/, const game::spec::ShipList& /*shipList*/, int /*resultLevel*/)
+            { throw std::runtime_error("boom"); }
+    };
+
+    void verifySame(afl::test::Assert a, game::vcr::Database& single, game::vcr::Database& multi)
+    {
+        a.checkEqual("getNumBattles", single.getNumBattles(), multi.getNumBattles());
+        for (size_t i = 0, n = single.getNumBattles(); i < n; ++i) {
+            for (size_t side = 0; side < 2; ++side) {
+                const game::vcr::Object* s = single.getBattle(i)->getObject(side, true);
+                const game::vcr::Object* m = multi.getBattle(i)->getObject(side, true);
+                a.checkNonNull("single", s);
+                a.checkNonNull("multi", m);
+                a.checkEqual("name",   s->getName(),   m->getName());
+                a.checkEqual("damage", s->getDamage(), m->getDamage());
+                a.checkEqual("crew",   s->getCrew(),   m->getCrew());
+                a.checkEqual("shield", s->getShield(), m->getShield());
+            }
+        }
+    }
+}
+
+/** Test prepare(), multi-threaded.
+    A: prepare results for a database using one and multiple threads.
+    E: same results */
+AFL_TEST("game.vcr.ResultPreparer:prepare", a)
+{
+    game::config::HostConfiguration config;
+    game::spec::ShipList shipList;
+    game::test::initStandardBeams(shipList);
+    game::test::initStandardTorpedoes(shipList);
+
+    game::vcr::classic::Database single;
+    addBattles(single, 50);
+    game::vcr::ResultPreparer(config, shipList, game::vcr::Battle::NeedCompleteResult, 1).prepare(single, 0, 50);
+
+    game::vcr::classic::Database multi;
+    addBattles(multi, 50);
+    game::vcr::ResultPreparer(config, shipList, game::vcr::Battle::NeedCompleteResult, 4).prepare(multi, 0, 50);
+
+    verifySame(a, single, multi);
+    a.checkEqual("01. name", single.getBattle(49)->getObject(1, true)->getName(), "S1049");
+}
+
+/** Test prepare(), range handling.
+    A: prepare out-of-range battles.
+    E: no crash; battles in range are prepared */
+AFL_TEST("game.vcr.ResultPreparer:prepare:range", a)
+{
+    game::config::HostConfiguration config;
+    game::spec::ShipList shipList;
+    game::test::initStandardBeams(shipList);
+    game::test::initStandardTorpedoes(shipList);
+
+    game::vcr::classic::Database db;
+    addBattles(db, 3);
+
+    game::vcr::ResultPreparer testee(config, shipList, game::vcr::Battle::NeedQuickOutcome, 3);
+    AFL_CHECK_SUCCEEDS(a("01. prepare"), testee.prepare(db, 5, 10));
+    AFL_CHECK_SUCCEEDS(a("02. prepare"), testee.prepare(db, 1, size_t(-1)));
+    a.checkEqual("03. name", db.getBattle(2)->getObject(0, true)->getName(), "S2");
+    a.checkEqual("04. name", db.getBattle(0)->getObject(0, true)->getName(), "");
+}
+
+/** Test getBatchSize().
+    A: determine batch size for databases with and without limit. Prepare results for the limited database.
+    E: batch size does not exceed the database's limit; results are complete */
+AFL_TEST("game.vcr.ResultPreparer:getBatchSize", a)
+{
+    game::config::HostConfiguration config;
+    game::spec::ShipList shipList;
+    game::test::initStandardBeams(shipList);
+    game::test::initStandardTorpedoes(shipList);
+
+    game::vcr::classic::Database single;
+    addBattles(single, 10);
+    a.checkGreaterThan("01. unlimited", game::vcr::ResultPreparer::getBatchSize(single), 3U);
+    game::vcr::ResultPreparer(config, shipList, game::vcr::Battle::NeedCompleteResult, 1).prepare(single, 0, 10);
+
+    SmallDatabase multi;
+    addBattles(multi, 10);
+    a.checkEqual("11. limited", game::vcr::ResultPreparer::getBatchSize(multi), 3U);
+    game::vcr::ResultPreparer(config, shipList, game::vcr::Battle::NeedCompleteResult, 4).prepare(multi, 0, 10);
+
+    verifySame(a, single, multi);
+}
+
+/** Test prepare() with failing battles.
+    A: prepare results for a database where some battles throw, using one and multiple threads.
+    E: prepare() completes; all other battles are prepared; ResultPreparer can be reused and destroyed normally */
+AFL_TEST("game.vcr.ResultPreparer:prepare:exception", a)
+{
+    game::config::HostConfiguration config;
+    game::spec::ShipList shipList;
+    game::test::initStandardBeams(shipList);
+    game::test::initStandardTorpedoes(shipList);
+
+    for (size_t numThreads = 1; numThreads <= 4; numThreads += 3) {
+        afl::test::Assert aa(a(afl::string::Format("%d threads", numThreads)));
+        game::vcr::classic::Database db;
+        for (int i = 0; i < 40; ++i) {
+            if (i % 7 == 3) {
+                db.addNewBattle(new FailingBattle(makeShip(i, 1, 100, 2), makeShip(1000+i, 2, 200, 1)))
+                    ->setType(game::vcr::classic::Host, 0);
+            } else {
+                db.addNewBattle(new game::vcr::classic::Battle(makeShip(i, 1, 100 + i, 2), makeShip(1000+i, 2, 200, 1 + i%5), uint16_t(i+1), 0, 0))
+                    ->setType(game::vcr::classic::Host, 0);
+            }
+        }
+
+        game::vcr::ResultPreparer testee(config, shipList, game::vcr::Battle::NeedCompleteResult, numThreads);
+        AFL_CHECK_SUCCEEDS(aa("01. prepare"), testee.prepare(db, 0, 40));
+        AFL_CHECK_SUCCEEDS(aa("02. prepare"), testee.prepare(db, 0, 40));
+        aa.checkEqual("03. name", db.getBattle(39)->getObject(1, true)->getName(), "S1039");
+        aa.checkEqual("04. name", db.getBattle(2)->getObject(0, true)->getName(), "S2");
+        aa.checkEqual("05. name", db.getBattle(3)->getObject(0, true)->getName(), "");
+    }
+}
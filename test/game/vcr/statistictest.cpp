@@ -55,3 +55,14 @@ AFL_TEST("game.vcr.Statistic:sequence", a)
     a.checkEqual("22. getNumTorpedoHits", t.getNumTorpedoHits(), 4);
     a.checkEqual("23. getNumFights", t.getNumFights(), 2);
 }
+
+/** Test construction from values.
+    A: create a Statistic object with values.
+    E: "inquiry" calls report these values. */
+AFL_TEST("game.vcr.Statistic:values", a)
+{
+    game::vcr::Statistic t(7, 12, 3);
+    a.checkEqual("01. getMinFightersAboard", t.getMinFightersAboard(), 7);
+    a.checkEqual("02. getNumTorpedoHits", t.getNumTorpedoHits(), 12);
+    a.checkEqual("03. getNumFights", t.getNumFights(), 3);
+}
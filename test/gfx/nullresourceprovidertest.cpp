@@ -15,6 +15,7 @@ AFL_TEST("gfx.NullResourceProvider", a)
     bool flag = false;
     a.checkNull("01. getImage", testee.getImage("x", &flag).get());
     a.check("02. getImage", flag);
+    AFL_CHECK_SUCCEEDS(a("03. prefetchImage"), testee.prefetchImage("x"));
 
     // Font request
     afl::base::Ref<gfx::Font> f = testee.getFont(gfx::FontRequest());
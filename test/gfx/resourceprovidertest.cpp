@@ -13,6 +13,8 @@ AFL_TEST_NOARG("gfx.ResourceProvider")
      public:
         virtual afl::base::Ptr<gfx::Canvas> getImage(String_t /*name*/, bool* /*status*/)
             { return 0; }
+        virtual void prefetchImage(String_t /*name*/)
+            { }
         virtual afl::base::Ref<gfx::Font> getFont(gfx::FontRequest /*req*/)
             { throw "egal"; }
     };
@@ -1244,3 +1244,88 @@ AFL_TEST("interpreter.BinaryExecution:bad-types:compare", a)
     AFL_CHECK_THROWS(a("31. error+int"), h.exec(interpreter::biCompareEQ, addr(ErrorValue("a", "b")), addr(IntegerValue(1))), interpreter::Error);
     AFL_CHECK_THROWS(a("32. int+error"), h.exec(interpreter::biCompareEQ, addr(IntegerValue(1)), addr(ErrorValue("a", "b"))), interpreter::Error);
 }
+
+/** Test executeBinaryOperationInPlace(): result must be identical to executeBinaryOperation(). */
+AFL_TEST("interpreter.BinaryExecution:executeBinaryOperationInPlace", a)
+{
+    using interpreter::executeBinaryOperationInPlace;
+    static const uint8_t OPS[] = {
+        interpreter::biAdd, interpreter::biSub, interpreter::biMult, interpreter::biDivide,
+        interpreter::biIntegerDivide, interpreter::biRemainder,
+        interpreter::biBitAnd, interpreter::biBitOr, interpreter::biBitXor,
+    };
+    static const int32_t VALUES[] = { 0, 1, -1, 3, 7, -12, 100000, 0x7FFFFFFF, -0x7FFFFFFF-1 };
+
+    TestHarness h;
+    for (size_t op = 0; op < sizeof(OPS)/sizeof(OPS[0]); ++op) {
+        for (size_t i = 0; i < sizeof(VALUES)/sizeof(VALUES[0]); ++i) {
+            for (size_t j = 0; j < sizeof(VALUES)/sizeof(VALUES[0]); ++j) {
+                IntegerValue orig(VALUES[i]);
+                IntegerValue ia(VALUES[i]);
+                IntegerValue ib(VALUES[j]);
+                if (executeBinaryOperationInPlace(OPS[op], &ia, &ib)) {
+                    h.exec(OPS[op], &orig, &ib);
+                    a.checkEqual("01. result", ia.getValue(), h.toInteger());
+                } else {
+                    a.checkEqual("02. unchanged", ia.getValue(), VALUES[i]);
+                }
+            }
+        }
+    }
+
+    // Regular cases are handled in place
+    {
+        IntegerValue ia(20);
+        IntegerValue ib(3);
+        a.check("11. add", executeBinaryOperationInPlace(interpreter::biAdd, &ia, &ib));
+        a.checkEqual("12. value", ia.getValue(), 23);
+    }
+    {
+        IntegerValue ia(20);
+        BooleanValue ib(true);
+        a.check("13. sub bool", executeBinaryOperationInPlace(interpreter::biSub, &ia, &ib));
+        a.checkEqual("14. value", ia.getValue(), 19);
+    }
+
+    // Cases not handled in place
+    {
+        // Overflow
+        IntegerValue ia(0x7FFFFFFF);
+        IntegerValue ib(1);
+        a.check("21. overflow", !executeBinaryOperationInPlace(interpreter::biAdd, &ia, &ib));
+    }
+    {
+        // Division producing float
+        IntegerValue ia(7);
+        IntegerValue ib(2);
+        a.check("22. divide", !executeBinaryOperationInPlace(interpreter::biDivide, &ia, &ib));
+    }
+    {
+        // Division by zero (regular path reports the error)
+        IntegerValue ia(7);
+        IntegerValue ib(0);
+        a.check("23. div zero", !executeBinaryOperationInPlace(interpreter::biIntegerDivide, &ia, &ib));
+    }
+    {
+        // Float
+        IntegerValue ia(7);
+        FloatValue fb(2.5);
+        a.check("24. float", !executeBinaryOperationInPlace(interpreter::biAdd, &ia, &fb));
+        FloatValue fa(7);
+        IntegerValue ib(2);
+        a.check("25. float", !executeBinaryOperationInPlace(interpreter::biAdd, &fa, &ib));
+    }
+    {
+        // Null, bool
+        IntegerValue ia(7);
+        a.check("26. null", !executeBinaryOperationInPlace(interpreter::biAdd, &ia, 0));
+        BooleanValue ba(true);
+        a.check("27. bool", !executeBinaryOperationInPlace(interpreter::biAdd, &ba, &ia));
+    }
+    {
+        // Comparison
+        IntegerValue ia(7);
+        IntegerValue ib(2);
+        a.check("28. compare", !executeBinaryOperationInPlace(interpreter::biCompareEQ, &ia, &ib));
+    }
+}
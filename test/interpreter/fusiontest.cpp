@@ -317,6 +317,116 @@ AFL_TEST("interpreter.Fusion:fused:pushloc+compare+jump", a)
     a.check("insn 1", isInstruction(bco(1), Opcode::maFusedComparison, interpreter::biCompareEQ, 0));
 }
 
+/*
+ *  Test fusion push+pop.
+ */
+
+// pushglob + poploc -> fusedmove
+AFL_TEST("interpreter.Fusion:fused:pushglob+poploc", a)
+{
+    BytecodeObject bco;
+    bco.addInstruction(Opcode::maPush, Opcode::sShared, 4);
+    bco.addInstruction(Opcode::maPop,  Opcode::sLocal, 7);
+
+    fuseInstructions(bco);
+
+    a.checkEqual("getNumInstructions", bco.getNumInstructions(), 2U);
+    a.check("insn 0", isInstruction(bco(0), Opcode::maFusedMove, Opcode::sShared, 4));
+    a.check("insn 1", isInstruction(bco(1), Opcode::maPop,       Opcode::sLocal, 7));
+}
+
+// pushint + poploc -> fusedmove
+AFL_TEST("interpreter.Fusion:fused:pushint+poploc", a)
+{
+    BytecodeObject bco;
+    bco.addInstruction(Opcode::maPush, Opcode::sInteger, 1);
+    bco.addInstruction(Opcode::maPop,  Opcode::sLocal, 7);
+
+    fuseInstructions(bco);
+
+    a.check("insn 0", isInstruction(bco(0), Opcode::maFusedMove, Opcode::sInteger, 1));
+}
+
+// pushloc + poploc (same) -> not fused
+AFL_TEST("interpreter.Fusion:kept:pushloc+poploc:same", a)
+{
+    BytecodeObject bco;
+    bco.addInstruction(Opcode::maPush, Opcode::sLocal, 7);
+    bco.addInstruction(Opcode::maPop,  Opcode::sLocal, 7);
+
+    fuseInstructions(bco);
+
+    a.check("insn 0", isInstruction(bco(0), Opcode::maPush, Opcode::sLocal, 7));
+}
+
+// pushvar + poploc -> not fused
+AFL_TEST("interpreter.Fusion:kept:pushvar+poploc", a)
+{
+    BytecodeObject bco;
+    bco.addInstruction(Opcode::maPush, Opcode::sNamedVariable, 0);
+    bco.addInstruction(Opcode::maPop,  Opcode::sLocal, 7);
+
+    fuseInstructions(bco);
+
+    a.check("insn 0", isInstruction(bco(0), Opcode::maPush, Opcode::sNamedVariable, 0));
+}
+
+// pushloc + popglob -> not fused
+AFL_TEST("interpreter.Fusion:kept:pushloc+popglob", a)
+{
+    BytecodeObject bco;
+    bco.addInstruction(Opcode::maPush, Opcode::sLocal, 7);
+    bco.addInstruction(Opcode::maPop,  Opcode::sShared, 3);
+
+    fuseInstructions(bco);
+
+    a.check("insn 0", isInstruction(bco(0), Opcode::maPush, Opcode::sLocal, 7));
+}
+
+/*
+ *  Test fusion push+jump.
+ */
+
+// pushloc + jfep -> fusedcondjump
+AFL_TEST("interpreter.Fusion:fused:pushloc+jump", a)
+{
+    BytecodeObject bco;
+    bco.addInstruction(Opcode::maPush, Opcode::sLocal, 7);
+    bco.addInstruction(Opcode::maJump, Opcode::jIfFalse | Opcode::jIfEmpty | Opcode::jPopAlways, 3);
+    bco.addInstruction(Opcode::maPush, Opcode::sInteger, 42);
+
+    fuseInstructions(bco);
+
+    a.checkEqual("getNumInstructions", bco.getNumInstructions(), 3U);
+    a.check("insn 0", isInstruction(bco(0), Opcode::maFusedCondJump, Opcode::sLocal, 7));
+}
+
+// pushloc + jt (no pop) -> not fused
+AFL_TEST("interpreter.Fusion:kept:pushloc+jump:nopop", a)
+{
+    BytecodeObject bco;
+    bco.addInstruction(Opcode::maPush, Opcode::sLocal, 7);
+    bco.addInstruction(Opcode::maJump, Opcode::jIfTrue, 3);
+    bco.addInstruction(Opcode::maPush, Opcode::sInteger, 42);
+
+    fuseInstructions(bco);
+
+    a.check("insn 0", isInstruction(bco(0), Opcode::maPush, Opcode::sLocal, 7));
+}
+
+// pushloc + jp (unconditional) -> not fused
+AFL_TEST("interpreter.Fusion:kept:pushloc+jump:always", a)
+{
+    BytecodeObject bco;
+    bco.addInstruction(Opcode::maPush, Opcode::sLocal, 7);
+    bco.addInstruction(Opcode::maJump, Opcode::jAlways | Opcode::jPopAlways, 3);
+    bco.addInstruction(Opcode::maPush, Opcode::sInteger, 42);
+
+    fuseInstructions(bco);
+
+    a.check("insn 0", isInstruction(bco(0), Opcode::maPush, Opcode::sLocal, 7));
+}
+
 /*
  *  Test miscellaneous. boundary cases.
  */
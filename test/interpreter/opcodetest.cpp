@@ -496,3 +496,37 @@ AFL_TEST("interpreter.Opcode:unknown", a)
     a.checkEqual("11. getExternalMajor",       aa.getExternalMajor(), 77);
     a.checkEqual("12. getDisassemblyTemplate", aa.getDisassemblyTemplate(), "unknown?\t%u");
 }
+
+/** Test fused move. */
+AFL_TEST("interpreter.Opcode:maFusedMove", a)
+{
+    // pushint(p) [=first part of fused push+pop]
+    Opcode aa = make(Opcode::maFusedMove, Opcode::sInteger, 3);
+    a.check("01. maPush",                     !aa.is(Opcode::maPush));
+    a.check("02. maFusedMove",                 aa.is(Opcode::maFusedMove));
+    a.check("03. isJumpOrCatch",              !aa.isJumpOrCatch());
+    a.check("04. isRegularJump",              !aa.isRegularJump());
+    a.check("05. isLabel",                    !aa.isLabel());
+    a.checkEqual("06. getExternalMajor",       aa.getExternalMajor(), Opcode::maPush);
+    a.checkEqual("07. getDisassemblyTemplate", aa.getDisassemblyTemplate(), "pushint(p)\t%d");
+
+    // Out-of-range
+    a.checkEqual("21. out-of-range", make(Opcode::maFusedMove, 222, 0).getDisassemblyTemplate(), "push?(p)\t?");
+}
+
+/** Test fused conditional jump. */
+AFL_TEST("interpreter.Opcode:maFusedCondJump", a)
+{
+    // pushloc(j) [=first part of fused push+jump]
+    Opcode aa = make(Opcode::maFusedCondJump, Opcode::sLocal, 3);
+    a.check("01. maPush",                     !aa.is(Opcode::maPush));
+    a.check("02. maFusedCondJump",             aa.is(Opcode::maFusedCondJump));
+    a.check("03. isJumpOrCatch",              !aa.isJumpOrCatch());
+    a.check("04. isRegularJump",              !aa.isRegularJump());
+    a.check("05. isLabel",                    !aa.isLabel());
+    a.checkEqual("06. getExternalMajor",       aa.getExternalMajor(), Opcode::maPush);
+    a.checkEqual("07. getDisassemblyTemplate", aa.getDisassemblyTemplate(), "pushloc(j)\t%L");
+
+    // Out-of-range
+    a.checkEqual("21. out-of-range", make(Opcode::maFusedCondJump, 222, 0).getDisassemblyTemplate(), "push?(j)\t?");
+}
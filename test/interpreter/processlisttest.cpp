@@ -890,3 +890,160 @@ AFL_TEST("interpreter.ProcessList:findProcessByObject", a)
     // Will no longer find the process
     a.checkNull("31. findProcessByObject pkDefault", testee.findProcessByObject(&obj, Process::pkDefault));
 }
+
+/** Test time slicing.
+    Processes of the same priority must be run round-robin, and run() must return after preempting one. */
+AFL_TEST("interpreter.ProcessList:setTimeSlice", a)
+{
+    afl::sys::Log log;
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    interpreter::World world(log, tx, fs);
+
+    interpreter::ProcessList testee;
+    testee.setTimeSlice(3);
+    a.checkEqual("01. getTimeSlice", testee.getTimeSlice(), 3U);
+
+    // Two processes in separate process groups, each executing 10 instructions
+    BCORef_t bco = interpreter::BytecodeObject::create(true);
+    for (int i = 0; i < 10; ++i) {
+        bco->addInstruction(Opcode::maPush, Opcode::sInteger, 0);
+    }
+    Process& p1 = testee.create(world, "1");
+    Process& p2 = testee.create(world, "2");
+    p1.pushFrame(bco, false);
+    p2.pushFrame(bco, false);
+
+    uint32_t pg1 = testee.allocateProcessGroup();
+    uint32_t pg2 = testee.allocateProcessGroup();
+    testee.resumeProcess(p1, pg1);
+    testee.resumeProcess(p2, pg2);
+    testee.startProcessGroup(pg1);
+    testee.startProcessGroup(pg2);
+
+    // First run: p1 gets preempted and moves to the back
+    testee.run();
+    a.checkEqual("11. p1 state", p1.getState(), Process::Running);
+    a.checkEqual("12. p2 state", p2.getState(), Process::Running);
+    a.check("13. hasRunningProcesses", testee.hasRunningProcesses());
+    a.checkEqual("14. list item", testee.getProcessList()[0], &p2);
+    a.checkEqual("15. list item", testee.getProcessList()[1], &p1);
+
+    // Second run: p2's turn
+    testee.run();
+    a.checkEqual("21. list item", testee.getProcessList()[0], &p1);
+    a.checkEqual("22. list item", testee.getProcessList()[1], &p2);
+
+    // Run to completion
+    int n = 2;
+    while (testee.hasRunningProcesses() && n < 100) {
+        testee.run();
+        ++n;
+    }
+    a.checkEqual("31. p1 state", p1.getState(), Process::Ended);
+    a.checkEqual("32. p2 state", p2.getState(), Process::Ended);
+    a.check("33. run count", n > 6);
+    a.check("34. run count", n < 100);
+}
+
+/** Test time slicing, with different priorities.
+    A preempted process must not overtake a process with higher priority. */
+AFL_TEST("interpreter.ProcessList:setTimeSlice:priority", a)
+{
+    afl::sys::Log log;
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    interpreter::World world(log, tx, fs);
+
+    interpreter::ProcessList testee;
+    testee.setTimeSlice(2);
+
+    BCORef_t bco = interpreter::BytecodeObject::create(true);
+    for (int i = 0; i < 4; ++i) {
+        bco->addInstruction(Opcode::maPush, Opcode::sInteger, 0);
+    }
+    Process& p1 = testee.create(world, "1");
+    Process& p2 = testee.create(world, "2");
+    p2.setPriority(60);
+    testee.handlePriorityChange(p2);
+    p1.pushFrame(bco, false);
+    p2.pushFrame(bco, false);
+
+    uint32_t pg1 = testee.allocateProcessGroup();
+    uint32_t pg2 = testee.allocateProcessGroup();
+    testee.resumeProcess(p1, pg1);
+    testee.resumeProcess(p2, pg2);
+    testee.startProcessGroup(pg1);
+    testee.startProcessGroup(pg2);
+
+    // p1 keeps running until it finishes; p2 does not get a turn before
+    testee.run();
+    a.checkEqual("01. list item", testee.getProcessList()[0], &p1);
+    a.checkEqual("02. p1 state", p1.getState(), Process::Running);
+    testee.run();
+    testee.run();
+    a.checkEqual("03. p1 state", p1.getState(), Process::Ended);
+    a.checkEqual("04. p2 state", p2.getState(), Process::Running);
+}
+
+/** Test preemption signal.
+    A: run processes with and without time slice, with a listener on sig_preempt that continues execution.
+    E: signal raised only for runs that preempted a process; continuing from the listener runs processes to completion */
+AFL_TEST("interpreter.ProcessList:sig_preempt", a)
+{
+    afl::sys::Log log;
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    interpreter::World world(log, tx, fs);
+
+    class Listener : public afl::base::Closure<void()> {
+     public:
+        Listener(interpreter::ProcessList& list, Counter& counter)
+            : m_list(list), m_counter(counter)
+            { }
+        virtual void call()
+            {
+                m_counter.increment();
+                m_list.run();
+            }
+     private:
+        interpreter::ProcessList& m_list;
+        Counter& m_counter;
+    };
+
+    interpreter::ProcessList testee;
+    Counter counter;
+    testee.sig_preempt.addNewClosure(new Listener(testee, counter));
+
+    BCORef_t bco = interpreter::BytecodeObject::create(true);
+    for (int i = 0; i < 10; ++i) {
+        bco->addInstruction(Opcode::maPush, Opcode::sInteger, 0);
+    }
+
+    // Without time slice: no signal
+    {
+        Process& p = testee.create(world, "1");
+        p.pushFrame(bco, false);
+        uint32_t pg = testee.allocateProcessGroup();
+        testee.resumeProcess(p, pg);
+        testee.startProcessGroup(pg);
+        testee.run();
+        a.checkEqual("01. state", p.getState(), Process::Ended);
+        a.checkEqual("02. counter", counter.get(), 0);
+        testee.removeTerminatedProcesses();
+    }
+
+    // With time slice: caller does not need to care; listener continues the process
+    {
+        testee.setTimeSlice(3);
+        Process& p = testee.create(world, "2");
+        p.pushFrame(bco, false);
+        uint32_t pg = testee.allocateProcessGroup();
+        testee.resumeProcess(p, pg);
+        testee.startProcessGroup(pg);
+        testee.run();
+        a.checkEqual("11. state", p.getState(), Process::Ended);
+        a.check("12. counter", counter.get() >= 3);
+        a.check("13. hasRunningProcesses", !testee.hasRunningProcesses());
+    }
+}
@@ -632,6 +632,8 @@ AFL_TEST("interpreter.Process:run:invalid", a)
         { Opcode::maFusedComparison,  interpreter::biCompareEQ, 0, "short fused comparison" },
         { Opcode::maFusedComparison2, Opcode::sLiteral,         0, "short fused comparison(2)" },
         { Opcode::maInplaceUnary,     Opcode::sLocal,           0, "short inplace unary" },
+        { Opcode::maFusedMove,        Opcode::sLiteral,         0, "short fused move" },
+        { Opcode::maFusedCondJump,    Opcode::sLiteral,         0, "short fused conditional jump" },
     };
 
     // Invalid push
@@ -3324,6 +3326,96 @@ AFL_TEST("interpreter.Process:run:inplace-unary", a)
     }
 }
 
+/** Test instruction: fused move (push + poploc). */
+AFL_TEST("interpreter.Process:run:fused-move", a)
+{
+    // From global
+    {
+        BCORef_t bco = makeBCO();
+        bco->addInstruction(Opcode::maFusedMove, Opcode::sShared, 55);
+        bco->addInstruction(Opcode::maPop, Opcode::sLocal, 3);
+        bco->addInstruction(Opcode::maPush, Opcode::sLocal, 3);
+
+        Environment env;
+        env.world.globalValues().setNew(55, interpreter::makeIntegerValue(17));
+        runBCO(env, bco);
+
+        a.checkEqual("01. getState", env.proc.getState(), Process::Ended);
+        a.checkEqual("02. getStackSize", env.proc.getStackSize(), 1U);
+        a.checkEqual("03. result", toInteger(env), 17);
+    }
+
+    // Integer immediate
+    {
+        BCORef_t bco = makeBCO();
+        bco->addInstruction(Opcode::maFusedMove, Opcode::sInteger, 42);
+        bco->addInstruction(Opcode::maPop, Opcode::sLocal, 3);
+        bco->addInstruction(Opcode::maPush, Opcode::sLocal, 3);
+
+        Environment env;
+        runBCO(env, bco);
+
+        a.checkEqual("11. getState", env.proc.getState(), Process::Ended);
+        a.checkEqual("12. getStackSize", env.proc.getStackSize(), 1U);
+        a.checkEqual("13. result", toInteger(env), 42);
+    }
+
+    // Self-assignment
+    {
+        BCORef_t bco = makeBCO();
+        bco->addInstruction(Opcode::maFusedMove, Opcode::sLocal, 3);
+        bco->addInstruction(Opcode::maPop, Opcode::sLocal, 3);
+        bco->addInstruction(Opcode::maPush, Opcode::sLocal, 3);
+
+        Environment env;
+        Process::Frame& frame = env.proc.pushFrame(bco, true);
+        frame.localValues.setNew(3, interpreter::makeIntegerValue(9));
+        env.proc.run();
+
+        a.checkEqual("21. getState", env.proc.getState(), Process::Ended);
+        a.checkEqual("22. result", toInteger(env), 9);
+    }
+}
+
+/** Test instruction: fused conditional jump (push + jXXp). */
+AFL_TEST("interpreter.Process:run:fused-condjump", a)
+{
+    BCORef_t bco = makeBCO();
+    bco->addInstruction(Opcode::maFusedCondJump, Opcode::sShared, 55);
+    bco->addInstruction(Opcode::maJump, Opcode::jIfFalse | Opcode::jIfEmpty | Opcode::jPopAlways, 3);
+    bco->addInstruction(Opcode::maPush, Opcode::sInteger, 42);
+
+    // True: jump not taken
+    {
+        Environment env;
+        env.world.globalValues().setNew(55, interpreter::makeIntegerValue(1));
+        runBCO(env, bco);
+
+        a.checkEqual("01. getState", env.proc.getState(), Process::Ended);
+        a.checkEqual("02. getStackSize", env.proc.getStackSize(), 1U);
+        a.checkEqual("03. result", toInteger(env), 42);
+    }
+
+    // False: jump taken
+    {
+        Environment env;
+        env.world.globalValues().setNew(55, interpreter::makeIntegerValue(0));
+        runBCO(env, bco);
+
+        a.checkEqual("11. getState", env.proc.getState(), Process::Ended);
+        a.checkEqual("12. getStackSize", env.proc.getStackSize(), 0U);
+    }
+
+    // Empty: jump taken
+    {
+        Environment env;
+        runBCO(env, bco);
+
+        a.checkEqual("21. getState", env.proc.getState(), Process::Ended);
+        a.checkEqual("22. getStackSize", env.proc.getStackSize(), 0U);
+    }
+}
+
 // Test onContextEntered(), onContextLeft().
 AFL_TEST("interpreter.Process:context-callback", a)
 {
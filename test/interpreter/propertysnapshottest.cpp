@@ -0,0 +1,148 @@
+/**
+  *  \file test/interpreter/propertysnapshottest.cpp
+  *  \brief Test for interpreter::PropertySnapshot
+  */
+
+#include "interpreter/propertysnapshot.hpp"
+
+#include "afl/data/namemap.hpp"
+#include "afl/string/format.hpp"
+#include "afl/test/testrunner.hpp"
+#include "interpreter/error.hpp"
+#include "interpreter/singlecontext.hpp"
+#include "interpreter/values.hpp"
+
+using interpreter::PropertySnapshot;
+
+namespace {
+    /* Object with properties ID (integer), NAME (string), FLAG (boolean), EMPTY (null), FAIL (throws) */
+    class ObjectContext : public interpreter::SingleContext, public interpreter::Context::ReadOnlyAccessor {
+     public:
+        explicit ObjectContext(int id)
+            : m_id(id), m_names()
+            {
+                m_names.add("ID");
+                m_names.add("NAME");
+                m_names.add("FLAG");
+                m_names.add("EMPTY");
+                m_names.add("FAIL");
+            }
+
+        // Context:
+        virtual interpreter::Context::PropertyAccessor* lookup(const afl::data::NameQuery& name, PropertyIndex_t& result)
+            {
+                afl::data::NameMap::Index_t ix = m_names.getIndexByName(name);
+                if (ix != afl::data::NameMap::nil) {
+                    result = ix;
+                    return this;
+                } else {
+                    return 0;
+                }
+            }
+        virtual afl::data::Value* get(PropertyIndex_t index)
+            {
+                switch (index) {
+                 case 0: return interpreter::makeIntegerValue(m_id);
+                 case 1: return interpreter::makeStringValue(afl::string::Format("n%d", m_id));
+                 case 2: return interpreter::makeBooleanValue(m_id % 2);
+                 case 3: return 0;
+                 default: throw interpreter::Error("boom");
+                }
+            }
+        virtual ObjectContext* clone() const
+            { return new ObjectContext(m_id); }
+        virtual afl::base::Deletable* getObject()
+            { return 0; }
+        virtual void enumProperties(interpreter::PropertyAcceptor& /*acceptor*/) const
+            { }
+
+        // BaseValue:
+        virtual String_t toString(bool /*readable*/) const
+            { return "#<object>"; }
+        virtual void store(interpreter::TagNode& out, afl::io::DataSink& aux, interpreter::SaveContext& ctx) const
+            { rejectStore(out, aux, ctx); }
+
+     private:
+        int m_id;
+        afl::data::NameMap m_names;
+    };
+}
+
+/** Test extracting values.
+    A: create snapshot with some columns; add rows.
+    E: correct states and values reported */
+AFL_TEST("interpreter.PropertySnapshot:basics", a)
+{
+    PropertySnapshot testee;
+    PropertySnapshot::Column_t id    = testee.addColumn("ID");
+    PropertySnapshot::Column_t name  = testee.addColumn("NAME");
+    PropertySnapshot::Column_t flag  = testee.addColumn("FLAG");
+    PropertySnapshot::Column_t empty = testee.addColumn("EMPTY");
+    PropertySnapshot::Column_t fail  = testee.addColumn("FAIL");
+    PropertySnapshot::Column_t miss  = testee.addColumn("MISSING");
+
+    a.checkEqual("01. getNumColumns", testee.getNumColumns(), 6U);
+    a.checkEqual("02. addColumn",     testee.addColumn("NAME"), name);
+    a.checkEqual("03. getNumColumns", testee.getNumColumns(), 6U);
+    a.checkEqual("04. getColumnName", testee.getColumnName(flag), "FLAG");
+
+    ObjectContext c1(7), c2(12);
+    testee.addRow(c1);
+    testee.addRow(c2);
+    a.checkEqual("11. getNumRows", testee.getNumRows(), 2U);
+
+    // Integer
+    a.checkEqual("21. state",      testee.getState(0, id), PropertySnapshot::Integer);
+    a.checkEqual("22. getInteger", testee.getInteger(0, id), 7);
+    a.checkEqual("23. getInteger", testee.getInteger(1, id), 12);
+    a.checkEqual("24. getValue",   interpreter::toString(testee.getValue(1, id), false), "12");
+
+    // String
+    a.checkEqual("31. state",      testee.getState(0, name), PropertySnapshot::Other);
+    a.checkEqual("32. getValue",   interpreter::toString(testee.getValue(0, name), false), "n7");
+    a.checkEqual("33. getInteger", testee.getInteger(0, name), 0);
+
+    // Boolean
+    a.checkEqual("41. state",      testee.getState(0, flag), PropertySnapshot::Integer);
+    a.checkEqual("42. getInteger", testee.getInteger(0, flag), 1);
+    a.checkEqual("43. getInteger", testee.getInteger(1, flag), 0);
+
+    // Empty, failed, missing
+    a.checkEqual("51. state",    testee.getState(0, empty), PropertySnapshot::Empty);
+    a.checkNull ("52. getValue", testee.getValue(0, empty));
+    a.checkEqual("53. state",    testee.getState(0, fail), PropertySnapshot::Failed);
+    a.checkEqual("54. getValue", interpreter::toString(testee.getValue(0, fail), false), "boom");
+    a.checkEqual("55. state",    testee.getState(1, miss), PropertySnapshot::Missing);
+    a.checkNull ("56. getValue", testee.getValue(1, miss));
+
+    // Out of range
+    a.checkEqual("61. state",    testee.getState(2, id), PropertySnapshot::Missing);
+    a.checkEqual("62. state",    testee.getState(0, 99), PropertySnapshot::Missing);
+    a.checkNull ("63. getValue", testee.getValue(2, id));
+}
+
+/** Test adding columns late, and clearing rows.
+    A: add a column after adding rows; clear rows.
+    E: existing rows report Missing for new column; clearRows() keeps columns */
+AFL_TEST("interpreter.PropertySnapshot:late-column", a)
+{
+    PropertySnapshot testee;
+    PropertySnapshot::Column_t id = testee.addColumn("ID");
+
+    ObjectContext c1(3);
+    testee.addRow(c1);
+
+    PropertySnapshot::Column_t name = testee.addColumn("NAME");
+    a.checkEqual("01. state", testee.getState(0, name), PropertySnapshot::Missing);
+
+    ObjectContext c2(4);
+    testee.addRow(c2);
+    a.checkEqual("11. state",      testee.getState(0, name), PropertySnapshot::Missing);
+    a.checkEqual("12. state",      testee.getState(1, name), PropertySnapshot::Other);
+    a.checkEqual("13. getInteger", testee.getInteger(1, id), 4);
+
+    testee.clearRows();
+    a.checkEqual("21. getNumRows",    testee.getNumRows(), 0U);
+    a.checkEqual("22. getNumColumns", testee.getNumColumns(), 2U);
+    a.checkEqual("23. state",         testee.getState(0, id), PropertySnapshot::Missing);
+}
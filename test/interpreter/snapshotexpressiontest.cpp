@@ -0,0 +1,239 @@
+/**
+  *  \file test/interpreter/snapshotexpressiontest.cpp
+  *  \brief Test for interpreter::SnapshotExpression
+  */
+
+#include "interpreter/snapshotexpression.hpp"
+
+#include <memory>
+#include "afl/base/deleter.hpp"
+#include "afl/data/namemap.hpp"
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/string/format.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/sys/log.hpp"
+#include "afl/test/testrunner.hpp"
+#include "interpreter/error.hpp"
+#include "interpreter/expr/parser.hpp"
+#include "interpreter/singlecontext.hpp"
+#include "interpreter/tokenizer.hpp"
+#include "interpreter/values.hpp"
+#include "interpreter/world.hpp"
+
+using interpreter::PropertySnapshot;
+using interpreter::SnapshotExpression;
+
+namespace {
+    /* Object with properties ID (integer), NAME (string), FLAG (boolean), EMPTY (null), FAIL (throws) */
+    class ObjectContext : public interpreter::SingleContext, public interpreter::Context::ReadOnlyAccessor {
+     public:
+        explicit ObjectContext(int id)
+            : m_id(id), m_names()
+            {
+                m_names.add("ID");
+                m_names.add("NAME");
+                m_names.add("FLAG");
+                m_names.add("EMPTY");
+                m_names.add("FAIL");
+            }
+
+        // Context:
+        virtual interpreter::Context::PropertyAccessor* lookup(const afl::data::NameQuery& name, PropertyIndex_t& result)
+            {
+                afl::data::NameMap::Index_t ix = m_names.getIndexByName(name);
+                if (ix != afl::data::NameMap::nil) {
+                    result = ix;
+                    return this;
+                } else {
+                    return 0;
+                }
+            }
+        virtual afl::data::Value* get(PropertyIndex_t index)
+            {
+                switch (index) {
+                 case 0: return interpreter::makeIntegerValue(m_id);
+                 case 1: return interpreter::makeStringValue(afl::string::Format("n%d", m_id));
+                 case 2: return interpreter::makeBooleanValue(m_id % 2);
+                 case 3: return 0;
+                 default: throw interpreter::Error("boom");
+                }
+            }
+        virtual ObjectContext* clone() const
+            { return new ObjectContext(m_id); }
+        virtual afl::base::Deletable* getObject()
+            { return 0; }
+        virtual void enumProperties(interpreter::PropertyAcceptor& /*acceptor*/) const
+            { }
+
+        // BaseValue:
+        virtual String_t toString(bool /*readable*/) const
+            { return "#<object>"; }
+        virtual void store(interpreter::TagNode& out, afl::io::DataSink& aux, interpreter::SaveContext& ctx) const
+            { rejectStore(out, aux, ctx); }
+
+     private:
+        int m_id;
+        afl::data::NameMap m_names;
+    };
+
+    /* A simple replacement for GlobalContext */
+    class SimpleGlobalContext : public interpreter::SingleContext, public interpreter::Context::ReadOnlyAccessor {
+     public:
+        SimpleGlobalContext(interpreter::World& w)
+            : m_world(w)
+            { }
+
+        // Context:
+        virtual interpreter::Context::PropertyAccessor* lookup(const afl::data::NameQuery& name, PropertyIndex_t& result)
+            {
+                afl::data::NameMap::Index_t ix = m_world.globalPropertyNames().getIndexByName(name);
+                if (ix != afl::data::NameMap::nil) {
+                    result = ix;
+                    return this;
+                } else {
+                    return 0;
+                }
+            }
+        virtual afl::data::Value* get(PropertyIndex_t index)
+            { return afl::data::Value::cloneOf(m_world.globalValues().get(index)); }
+        virtual SimpleGlobalContext* clone() const
+            { return new SimpleGlobalContext(m_world); }
+        virtual afl::base::Deletable* getObject()
+            { return 0; }
+        virtual void enumProperties(interpreter::PropertyAcceptor& /*acceptor*/) const
+            { }
+
+        // BaseValue:
+        virtual String_t toString(bool /*readable*/) const
+            { return "#<global>"; }
+        virtual void store(interpreter::TagNode& out, afl::io::DataSink& aux, interpreter::SaveContext& ctx) const
+            { rejectStore(out, aux, ctx); }
+
+     private:
+        interpreter::World& m_world;
+    };
+
+    const char*const EXCLUDED[] = { "OBJ" };
+
+    struct Environment {
+        afl::sys::Log log;
+        afl::string::NullTranslator tx;
+        afl::io::NullFileSystem fs;
+        interpreter::World world;
+        PropertySnapshot snapshot;
+
+        Environment()
+            : log(), tx(), fs(), world(log, tx, fs), snapshot()
+            {
+                world.addNewGlobalContext(new SimpleGlobalContext(world));
+                world.setNewGlobalValue("GV", interpreter::makeIntegerValue(42));
+                world.setNewGlobalValue("ID", interpreter::makeIntegerValue(99));
+            }
+    };
+
+    /* Compile an expression; returns null if not supported. */
+    SnapshotExpression* compile(Environment& env, const char* expr)
+    {
+        interpreter::Tokenizer tok(expr);
+        afl::base::Deleter del;
+        const interpreter::expr::Node& node(interpreter::expr::Parser(tok, del).parse());
+        return SnapshotExpression::compile(node, env.snapshot, interpreter::CompilationContext(env.world), EXCLUDED);
+    }
+
+    /* Compile expression and evaluate as condition for rows 3 and 4. Returns both results as string. */
+    String_t conditions(afl::test::Assert a, const char* expr)
+    {
+        Environment env;
+        std::auto_ptr<SnapshotExpression> testee(compile(env, expr));
+        a.checkNonNull("compile", testee.get());
+
+        ObjectContext c1(3), c2(4);
+        env.snapshot.addRow(c1);
+        env.snapshot.addRow(c2);
+        return afl::string::Format("%d,%d", testee->evaluateCondition(0), testee->evaluateCondition(1));
+    }
+}
+
+/** Test comparisons and logic.
+    A: compile various expressions, evaluate as conditions.
+    E: results as the interpreter would produce them */
+AFL_TEST("interpreter.SnapshotExpression:condition", a)
+{
+    // Integer fast path
+    a.checkEqual("01", conditions(a("01"), "ID > 3"), "0,1");
+    a.checkEqual("02", conditions(a("02"), "ID = 3"), "1,0");
+    a.checkEqual("03", conditions(a("03"), "ID <> 3 And ID < 10"), "0,1");
+    a.checkEqual("04", conditions(a("04"), "FLAG"), "1,0");
+    a.checkEqual("05", conditions(a("05"), "FLAG = True"), "1,0");
+    a.checkEqual("06", conditions(a("06"), "Not FLAG Or ID = 3"), "1,1");
+
+    // Strings, case-blind comparison
+    a.checkEqual("11", conditions(a("11"), "NAME = 'N3'"), "1,0");
+    a.checkEqual("12", conditions(a("12"), "NAME # 'x' = 'n4x'"), "0,1");
+
+    // Empty: three-valued logic
+    a.checkEqual("21", conditions(a("21"), "EMPTY = 1"), "-1,-1");
+    a.checkEqual("22", conditions(a("22"), "Not EMPTY"), "-1,-1");
+    a.checkEqual("23", conditions(a("23"), "EMPTY Or ID = 3"), "1,-1");
+    a.checkEqual("24", conditions(a("24"), "EMPTY And ID = 3"), "-1,0");
+    a.checkEqual("25", conditions(a("25"), "EMPTY Xor True"), "-1,-1");
+    a.checkEqual("26", conditions(a("26"), "FLAG Xor True"), "0,1");
+
+    // Shortcut evaluation does not evaluate failing properties
+    a.checkEqual("31", conditions(a("31"), "ID < 10 Or FAIL"), "1,1");
+
+    // Globals are used only if the object does not have the property
+    a.checkEqual("41", conditions(a("41"), "GV = 42"), "1,1");
+    a.checkEqual("42", conditions(a("42"), "ID = 99"), "0,0");
+}
+
+/** Test evaluation of values.
+    A: compile arithmetic expressions, evaluate.
+    E: correct values */
+AFL_TEST("interpreter.SnapshotExpression:value", a)
+{
+    Environment env;
+    std::auto_ptr<SnapshotExpression> testee(compile(env, "ID * 10 + GV"));
+    a.checkNonNull("01. compile", testee.get());
+
+    ObjectContext c1(3);
+    env.snapshot.addRow(c1);
+
+    std::auto_ptr<afl::data::Value> result(testee->evaluate(0));
+    a.checkEqual("11. evaluate", interpreter::toString(result.get(), false), "72");
+}
+
+/** Test errors.
+    A: evaluate expressions referring to failing or unknown properties.
+    E: interpreter::Error thrown */
+AFL_TEST("interpreter.SnapshotExpression:error", a)
+{
+    Environment env;
+    std::auto_ptr<SnapshotExpression> unknown(compile(env, "ZZ = 1"));
+    std::auto_ptr<SnapshotExpression> failing(compile(env, "FAIL = 1"));
+    std::auto_ptr<SnapshotExpression> type(compile(env, "NAME + 1"));
+    a.checkNonNull("01. compile", unknown.get());
+    a.checkNonNull("02. compile", failing.get());
+    a.checkNonNull("03. compile", type.get());
+
+    ObjectContext c1(3);
+    env.snapshot.addRow(c1);
+
+    AFL_CHECK_THROWS(a("11. unknown"), unknown->evaluateCondition(0), interpreter::Error);
+    AFL_CHECK_THROWS(a("12. failing"), failing->evaluateCondition(0), interpreter::Error);
+    AFL_CHECK_THROWS(a("13. type"),    type->evaluate(0), interpreter::Error);
+}
+
+/** Test unsupported expressions.
+    A: compile expressions that cannot be evaluated on a snapshot.
+    E: compile() returns null */
+AFL_TEST("interpreter.SnapshotExpression:unsupported", a)
+{
+    Environment env;
+    a.checkNull("01. function",   compile(env, "Len(NAME) = 2"));
+    a.checkNull("02. user call",  compile(env, "Foo(1)"));
+    a.checkNull("03. member",     compile(env, "OBJ->NAME"));
+    a.checkNull("04. excluded",   compile(env, "OBJ = 1"));
+    a.checkNull("05. assignment", compile(env, "ID := 1"));
+    a.checkNull("06. sequence",   compile(env, "ID; 1"));
+}
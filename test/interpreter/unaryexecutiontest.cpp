@@ -1133,3 +1133,42 @@ AFL_TEST("interpreter.UnaryExecution:bad-types", a)
     AFL_CHECK_THROWS(a("03. Subr"),   p.reset(executeUnaryOperation(h.world, interpreter::unNeg, addr(SubroutineValue(BytecodeObject::create(false))))), interpreter::Error);
     AFL_CHECK_THROWS(a("04. Error"),  p.reset(executeUnaryOperation(h.world, interpreter::unNeg, addr(afl::data::ErrorValue("a", "b")))),                interpreter::Error);
 }
+
+/** Test executeUnaryOperationInPlace(): result must be identical to executeUnaryOperation(). */
+AFL_TEST("interpreter.UnaryExecution:executeUnaryOperationInPlace", a)
+{
+    using interpreter::executeUnaryOperationInPlace;
+    static const uint8_t OPS[] = { interpreter::unNeg, interpreter::unPos, interpreter::unInc, interpreter::unDec, interpreter::unBitNot };
+    static const int32_t VALUES[] = { 0, 1, -1, 42, -0x7FFFFFFF, 0x7FFFFFFF, -0x7FFFFFFF-1 };
+
+    TestHarness h;
+    for (size_t op = 0; op < sizeof(OPS)/sizeof(OPS[0]); ++op) {
+        for (size_t i = 0; i < sizeof(VALUES)/sizeof(VALUES[0]); ++i) {
+            IntegerValue iv(VALUES[i]);
+            if (executeUnaryOperationInPlace(OPS[op], &iv)) {
+                IntegerValue orig(VALUES[i]);
+                std::auto_ptr<Value> result(executeUnaryOperation(h.world, OPS[op], &orig));
+                IntegerValue* resultIV = dynamic_cast<IntegerValue*>(result.get());
+                a.checkNonNull("01. type", resultIV);
+                a.checkEqual("02. value", iv.getValue(), resultIV->getValue());
+            } else {
+                a.checkEqual("03. unchanged", iv.getValue(), VALUES[i]);
+            }
+        }
+    }
+
+    // Regular case
+    IntegerValue iv(10);
+    a.check("11. inc", executeUnaryOperationInPlace(interpreter::unInc, &iv));
+    a.checkEqual("12. value", iv.getValue(), 11);
+
+    // Not handled in place: overflow, other types, other operations
+    IntegerValue big(0x7FFFFFFF);
+    a.check("21. overflow", !executeUnaryOperationInPlace(interpreter::unInc, &big));
+    BooleanValue bv(true);
+    a.check("22. bool", !executeUnaryOperationInPlace(interpreter::unNeg, &bv));
+    FloatValue fv(2.5);
+    a.check("23. float", !executeUnaryOperationInPlace(interpreter::unNeg, &fv));
+    a.check("24. null", !executeUnaryOperationInPlace(interpreter::unNeg, 0));
+    a.check("25. not", !executeUnaryOperationInPlace(interpreter::unNot, &iv));
+}
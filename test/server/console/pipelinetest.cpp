@@ -0,0 +1,147 @@
+/**
+  *  \file test/server/console/pipelinetest.cpp
+  *  \brief Test for server::console::Pipeline
+  */
+
+#include <stdexcept>
+#include "server/console/pipeline.hpp"
+
+#include "afl/container/ptrvector.hpp"
+#include "afl/data/access.hpp"
+#include "afl/string/format.hpp"
+#include "afl/test/testrunner.hpp"
+#include "server/types.hpp"
+
+namespace {
+    /* Connection: returns "<prefix>:<command>", fails for command "fail" */
+    class Connection : public afl::net::CommandHandler {
+     public:
+        Connection(String_t prefix)
+            : m_prefix(prefix)
+            { }
+        virtual Value_t* call(const Segment_t& command)
+            {
+                String_t verb = server::toString(command[0]);
+                if (verb == "fail") {
+                    throw std::runtime_error("boom");
+                }
+                return server::makeStringValue(m_prefix + ":" + verb);
+            }
+        virtual void callVoid(const Segment_t& command)
+            { delete call(command); }
+     private:
+        String_t m_prefix;
+    };
+
+    /* Target: creates Connections on demand */
+    class Target : public server::console::Pipeline::Target {
+     public:
+        Target(String_t name)
+            : m_name(name), m_connections()
+            { }
+        virtual String_t getName()
+            { return m_name; }
+        virtual afl::net::CommandHandler& getConnection(size_t index)
+            {
+                while (m_connections.size() <= index) {
+                    m_connections.pushBackNew(new Connection(m_name));
+                }
+                return *m_connections[index];
+            }
+        size_t getNumConnections() const
+            { return m_connections.size(); }
+     private:
+        String_t m_name;
+        afl::container::PtrVector<Connection> m_connections;
+    };
+
+    void addCommand(server::console::Pipeline& p, Target& t, String_t verb)
+    {
+        afl::data::Segment seg;
+        seg.pushBackString(verb);
+        p.add(t, seg);
+        // seg is now empty
+    }
+}
+
+/** Test normal execution: results in order, errors reported per command. */
+AFL_TEST("server.console.Pipeline:execute", a)
+{
+    Target ta("a"), tb("b");
+    server::console::Pipeline testee;
+    a.check("01. isActive", !testee.isActive());
+
+    testee.start();
+    a.check("11. isActive", testee.isActive());
+    for (int i = 0; i < 20; ++i) {
+        addCommand(testee, (i % 2) == 0 ? ta : tb, i == 7 ? String_t("fail") : afl::string::Format("c%d", i));
+    }
+    a.checkEqual("12. getNumCommands", testee.getNumCommands(), 20U);
+
+    afl::data::Segment results;
+    afl::data::StringList_t errors;
+    server::console::Pipeline::Statistics st = testee.execute(3, results, errors);
+
+    a.checkEqual("21. numCommands", st.numCommands, 20U);
+    a.checkEqual("22. numErrors",   st.numErrors, 1U);
+    a.check("23. isActive", !testee.isActive());
+    a.checkEqual("24. getNumCommands", testee.getNumCommands(), 0U);
+
+    a.checkEqual("31. results", results.size(), 20U);
+    a.checkEqual("32. result", afl::data::Access(results[0]).toString(), "a:c0");
+    a.checkEqual("33. result", afl::data::Access(results[1]).toString(), "b:c1");
+    a.checkEqual("34. result", afl::data::Access(results[18]).toString(), "a:c18");
+    a.checkNull ("35. result", results[7]);
+
+    a.checkEqual("41. errors", errors.size(), 1U);
+    a.checkEqual("42. error", errors[0], "#8 (b fail): boom");
+
+    a.checkEqual("51. connections", ta.getNumConnections(), 3U);
+    a.checkEqual("52. connections", tb.getNumConnections(), 3U);
+}
+
+/** Test that no more connections than commands are used. */
+AFL_TEST("server.console.Pipeline:few-commands", a)
+{
+    Target t("t");
+    server::console::Pipeline testee;
+    testee.start();
+    addCommand(testee, t, "x");
+
+    afl::data::Segment results;
+    afl::data::StringList_t errors;
+    server::console::Pipeline::Statistics st = testee.execute(10, results, errors);
+
+    a.checkEqual("01. numCommands", st.numCommands, 1U);
+    a.checkEqual("02. connections", t.getNumConnections(), 1U);
+    a.checkEqual("03. result", afl::data::Access(results[0]).toString(), "t:x");
+}
+
+/** Test empty pipeline. */
+AFL_TEST("server.console.Pipeline:empty", a)
+{
+    server::console::Pipeline testee;
+    testee.start();
+
+    afl::data::Segment results;
+    afl::data::StringList_t errors;
+    server::console::Pipeline::Statistics st = testee.execute(4, results, errors);
+
+    a.checkEqual("01. numCommands", st.numCommands, 0U);
+    a.checkEqual("02. results", results.size(), 0U);
+    a.checkEqual("03. errors", errors.size(), 0U);
+}
+
+/** Test cancel(). */
+AFL_TEST("server.console.Pipeline:cancel", a)
+{
+    Target t("t");
+    server::console::Pipeline testee;
+    testee.start();
+    addCommand(testee, t, "x");
+    testee.cancel();
+
+    a.check("01. isActive", !testee.isActive());
+    a.checkEqual("02. getNumCommands", testee.getNumCommands(), 0U);
+    a.checkEqual("03. connections", t.getNumConnections(), 0U);
+}
@@ -5,10 +5,16 @@
 
 #include "server/dbexport/dbexporter.hpp"
 
+#include <algorithm>
+#include <memory>
 #include <stdexcept>
+#include "afl/data/access.hpp"
 #include "afl/data/segment.hpp"
+#include "afl/data/vector.hpp"
+#include "afl/data/vectorvalue.hpp"
 #include "afl/io/internaltextwriter.hpp"
 #include "afl/net/redis/internaldatabase.hpp"
+#include "afl/string/format.hpp"
 #include "afl/string/nulltranslator.hpp"
 #include "afl/sys/commandlineparser.hpp"
 #include "afl/test/testrunner.hpp"
@@ -25,7 +31,10 @@ namespace {
             {
                 if (const char*const* p = m_args.eat()) {
                     text = *p;
-                    option = false;
+                    option = (text.size() > 2 && text.compare(0, 2, "--") == 0);
+                    if (option) {
+                        text.erase(0, 2);
+                    }
                     return true;
                 } else {
                     return false;
@@ -46,6 +55,62 @@ namespace {
     const char*const DEFAULT_ARGS[] = {
         "*"
     };
+
+    const char*const SCAN_ARGS[] = {
+        "--scan",
+        "*"
+    };
+
+    /* Database that implements SCAN on top of KEYS.
+       Returns (up to) four keys per call, the first of which repeats the last key of the previous call,
+       to exercise SCAN's "a key may be returned multiple times" property. */
+    class ScanningDatabase : public afl::net::CommandHandler {
+     public:
+        ScanningDatabase(afl::net::CommandHandler& db)
+            : m_db(db), m_numScans(0)
+            { }
+        Value_t* call(const Segment_t& cmd)
+            {
+                if (cmd.size() == 6 && afl::data::Access(cmd[0]).toString() == "SCAN") {
+                    ++m_numScans;
+
+                    afl::data::StringList_t keys;
+                    std::auto_ptr<afl::data::Value> v(m_db.call(Segment().pushBackString("KEYS").pushBackString(afl::data::Access(cmd[3]).toString())));
+                    afl::data::Access(v).toStringList(keys);
+                    std::sort(keys.begin(), keys.end());
+
+                    size_t cursor = afl::data::Access(cmd[1]).toInteger();
+                    size_t next = cursor + 3;
+                    afl::data::Vector::Ref_t batch = afl::data::Vector::create();
+                    for (size_t i = (cursor > 0 ? cursor-1 : 0); i < next && i < keys.size(); ++i) {
+                        batch->pushBackString(keys[i]);
+                    }
+
+                    afl::data::Vector::Ref_t result = afl::data::Vector::create();
+                    result->pushBackString(afl::string::Format("%d", next >= keys.size() ? 0 : next));
+                    result->pushBackNew(new afl::data::VectorValue(batch));
+                    return new afl::data::VectorValue(result);
+                } else {
+                    return m_db.call(cmd);
+                }
+            }
+        void callVoid(const Segment_t& cmd)
+            { delete call(cmd); }
+        int getNumScans() const
+            { return m_numScans; }
+     private:
+        afl::net::CommandHandler& m_db;
+        int m_numScans;
+    };
+
+    /* Populate a database for the multi-connection test. */
+    void populate(afl::net::CommandHandler& db)
+    {
+        for (int i = 0; i < 250; ++i) {
+            db.callVoid(Segment().pushBackString("set").pushBackString(afl::string::Format("s:%03d", i)).pushBackInteger(i));
+            db.callVoid(Segment().pushBackString("rpush").pushBackString(afl::string::Format("l:%03d", i)).pushBackInteger(i).pushBackInteger(i+1));
+        }
+    }
 }
 
 /** Simple test. This is just a litmus test, for coverage and for testing basic layout.
@@ -202,3 +267,62 @@ AFL_TEST("server.dbexport.DBExporter:many-hashes", a)
     server::dbexport::exportDatabase(t, db, c, tx);
     a.checkGreaterThan("result size", t.getContent().size(), 50000U);
 }
+
+/** Test export using SCAN.
+    A: create database. Export with "--scan" option, using a database that reports a key twice.
+    E: all keys exported, in batches; lists are deleted before being re-created. */
+AFL_TEST("server.dbexport.DBExporter:scan", a)
+{
+    afl::string::NullTranslator tx;
+    afl::net::redis::InternalDatabase db;
+    db.callVoid(Segment().pushBackString("set").pushBackString("a").pushBackInteger(1));
+    db.callVoid(Segment().pushBackString("set").pushBackString("b").pushBackInteger(2));
+    db.callVoid(Segment().pushBackString("set").pushBackString("c").pushBackInteger(3));
+    db.callVoid(Segment().pushBackString("set").pushBackString("d").pushBackInteger(4));
+    db.callVoid(Segment().pushBackString("set").pushBackString("e").pushBackInteger(5));
+    db.callVoid(Segment().pushBackString("rpush").pushBackString("l").pushBackString("x").pushBackString("y"));
+    ScanningDatabase sdb(db);
+
+    afl::io::InternalTextWriter t;
+    CommandLineParserMock c(SCAN_ARGS);
+
+    server::dbexport::exportDatabase(t, sdb, c, tx);
+
+    a.checkEqual("01. result", afl::string::fromMemory(t.getContent()),
+                 "silent redis set   a                              1\n"
+                 "silent redis set   b                              2\n"
+                 "silent redis set   c                              3\n"
+                 "silent redis set   c                              3\n"
+                 "silent redis set   d                              4\n"
+                 "silent redis set   e                              5\n"
+                 "silent redis del   l\n"
+                 "silent redis rpush l                              x\n"
+                 "silent redis rpush l                              y\n");
+    a.checkEqual("02. getNumScans", sdb.getNumScans(), 2);
+}
+
+/** Test export using multiple connections.
+    A: create identical databases. Export using one and using three connections.
+    E: same output. */
+AFL_TEST("server.dbexport.DBExporter:connections", a)
+{
+    afl::string::NullTranslator tx;
+    afl::net::redis::InternalDatabase db1, db2, db3;
+    populate(db1);
+    populate(db2);
+    populate(db3);
+
+    // Single connection
+    afl::io::InternalTextWriter t1;
+    CommandLineParserMock c1(DEFAULT_ARGS);
+    server::dbexport::exportDatabase(t1, db1, c1, tx);
+
+    // Multiple connections
+    afl::io::InternalTextWriter t3;
+    CommandLineParserMock c3(DEFAULT_ARGS);
+    afl::net::CommandHandler*const dbs[] = { &db1, &db2, &db3 };
+    server::dbexport::exportDatabase(t3, dbs, c3, tx);
+
+    a.checkGreaterThan("01. size", t1.getContent().size(), 30000U);
+    a.checkEqual("02. result", afl::string::fromMemory(t3.getContent()), afl::string::fromMemory(t1.getContent()));
+}
@@ -46,6 +46,10 @@ namespace {
                 m_store.unlinkObject(ObjectStore::TreeObject, m_id);
                 m_id = newId;
             }
+
+        const ObjectId& getId() const
+            { return m_id; }
+
      private:
         ObjectId m_id;
         ObjectStore& m_store;
@@ -352,3 +356,43 @@ AFL_TEST("server.file.ca.DirectoryHandler:copyFile", a)
         a.check("22. copyFile", !other.copyFile(testee, aa, "x").isValid());
     }
 }
+
+/** Test getTotals(), setTotals(). */
+AFL_TEST("server.file.ca.DirectoryHandler:totals", a)
+{
+    // Create test setup
+    server::file::InternalDirectoryHandler::Directory rootDir("");
+    server::file::InternalDirectoryHandler rootHandler("root", rootDir);
+    ObjectStore store(rootHandler);
+    afl::base::Ref<RootReferenceUpdater> ref(*new RootReferenceUpdater(ObjectId::nil, store));
+
+    // Testee
+    server::file::ca::DirectoryHandler testee(store, ObjectId::nil, "root", ref);
+    static const uint8_t CONTENT[] = {'a'};
+    testee.createFile("a", CONTENT);
+
+    // Initially, no totals
+    int32_t numFiles = 0, totalKBytes = 0;
+    a.check("01. getTotals", !testee.getTotals(numFiles, totalKBytes));
+
+    // Store and retrieve
+    testee.setTotals(2, 3);
+    a.check("11. getTotals", testee.getTotals(numFiles, totalKBytes));
+    a.checkEqual("12. numFiles", numFiles, 2);
+    a.checkEqual("13. totalKBytes", totalKBytes, 3);
+
+    // Totals are persistent
+    const ObjectId firstId = ref->getId();
+    {
+        ObjectStore otherStore(rootHandler);
+        int32_t otherFiles = 0, otherKBytes = 0;
+        a.check("21. getTreeTotals", otherStore.getTreeTotals(firstId, otherFiles, otherKBytes));
+        a.checkEqual("22. numFiles", otherFiles, 2);
+        a.checkEqual("23. totalKBytes", otherKBytes, 3);
+    }
+
+    // Modifying the directory produces a new tree without totals; previous tree's totals are removed with it
+    testee.createFile("b", CONTENT);
+    a.check("31. getTotals", !testee.getTotals(numFiles, totalKBytes));
+    a.check("32. getTreeTotals", !store.getTreeTotals(firstId, numFiles, totalKBytes));
+}
@@ -335,3 +335,40 @@ AFL_TEST("server.file.ca.GarbageCollector:error:missing-tree", a)
         a.checkEqual("21. getNumObjectsRemoved", testee.getNumObjectsRemoved(), 1U);
     }
 }
+
+/** Test removal of stored disk usage totals.
+    A: create some files. Store totals for the root tree and for a nonexistant tree. Run GC.
+    E: totals for the nonexistant tree removed, totals for the root tree kept. */
+AFL_TEST("server.file.ca.GarbageCollector:totals", a)
+{
+    // Storage
+    server::file::InternalDirectoryHandler::Directory rootDir("");
+    server::file::InternalDirectoryHandler rootHandler("root", rootDir);
+    createSomeFiles(a, rootHandler);
+
+    const server::file::ca::ObjectId garbageId = server::file::ca::ObjectId::fromHex("0123456789abcdef0123456789abcdef01234567");
+
+    // Garbage collector
+    {
+        afl::sys::Log log;
+        server::file::ca::Root t(rootHandler);
+        const server::file::ca::ObjectId treeId = t.objectStore().getCommit(t.getMasterCommitId());
+        t.objectStore().setTreeTotals(treeId, 4, 5);
+        t.objectStore().setTreeTotals(garbageId, 7, 8);
+
+        server::file::ca::GarbageCollector testee(t.objectStore(), log);
+        runGC(a, t, testee);
+
+        a.checkEqual("01. getNumErrors", testee.getNumErrors(), 0U);
+        a.checkEqual("02. getNumObjectsRemoved", testee.getNumObjectsRemoved(), 0U);
+
+        int32_t numFiles = 0, totalKBytes = 0;
+        a.check("11. getTreeTotals", t.objectStore().getTreeTotals(treeId, numFiles, totalKBytes));
+        a.checkEqual("12. numFiles", numFiles, 4);
+        a.checkEqual("13. totalKBytes", totalKBytes, 5);
+        a.check("14. getTreeTotals", !t.objectStore().getTreeTotals(garbageId, numFiles, totalKBytes));
+    }
+
+    // Verify content
+    checkFileContent(a, rootHandler, "text", "text");
+}
@@ -51,6 +51,10 @@ namespace {
             { return m_impl->createDirectory(name); }
         virtual void removeDirectory(String_t name)
             { m_impl->removeDirectory(name); }
+        virtual bool getTotals(int32_t& numFiles, int32_t& totalKBytes)
+            { return m_impl->getTotals(numFiles, totalKBytes); }
+        virtual void setTotals(int32_t numFiles, int32_t totalKBytes)
+            { m_impl->setTotals(numFiles, totalKBytes); }
      private:
         size_t& m_count;
         std::auto_ptr<DirectoryHandler> m_impl;
@@ -33,6 +33,10 @@ AFL_TEST_NOARG("server.file.DirectoryHandler")
             { return Info(); }
         virtual void removeDirectory(String_t /*name*/)
             { }
+        virtual bool getTotals(int32_t& /*numFiles*/, int32_t& /*totalKBytes*/)
+            { return false; }
+        virtual void setTotals(int32_t /*numFiles*/, int32_t /*totalKBytes*/)
+            { }
     };
     Tester t;
 }
@@ -1139,6 +1139,70 @@ AFL_TEST("server.file.FileBase:getDiskUsage", a)
     AFL_CHECK_THROWS_CODE(a("83. getDiskUsage"), testee.getDiskUsage("listable/f"), "405");
 }
 
+/** Test getDiskUsage(), incremental update. */
+AFL_TEST("server.file.FileBase:getDiskUsage:update", a)
+{
+    using server::interface::FileBase;
+
+    Testbench tb;
+    server::file::FileBase testee(tb.session, tb.root);
+    testee.createDirectory("u");
+    testee.putFile("u/a", String_t(2000, 'a'));
+
+    // Initial computation
+    FileBase::Usage u = testee.getDiskUsage("u");
+    a.checkEqual("01. numItems", u.numItems, 2);
+    a.checkEqual("02. totalKBytes", u.totalKBytes, 3);
+
+    // Create directory
+    testee.createDirectory("u/s");
+    u = testee.getDiskUsage("u");
+    a.checkEqual("11. numItems", u.numItems, 3);
+    a.checkEqual("12. totalKBytes", u.totalKBytes, 4);
+
+    // Create file in subdirectory
+    testee.putFile("u/s/b", String_t(5000, 'b'));
+    u = testee.getDiskUsage("u");
+    a.checkEqual("21. numItems", u.numItems, 4);
+    a.checkEqual("22. totalKBytes", u.totalKBytes, 9);
+
+    // Overwrite file
+    testee.putFile("u/s/b", "b");
+    u = testee.getDiskUsage("u");
+    a.checkEqual("31. numItems", u.numItems, 4);
+    a.checkEqual("32. totalKBytes", u.totalKBytes, 5);
+
+    // Copy file
+    testee.copyFile("u/a", "u/s/c");
+    u = testee.getDiskUsage("u");
+    a.checkEqual("41. numItems", u.numItems, 5);
+    a.checkEqual("42. totalKBytes", u.totalKBytes, 7);
+
+    // Remove files
+    testee.removeFile("u/s/b");
+    testee.removeFile("u/a");
+    u = testee.getDiskUsage("u");
+    a.checkEqual("51. numItems", u.numItems, 3);
+    a.checkEqual("52. totalKBytes", u.totalKBytes, 4);
+
+    u = testee.getDiskUsage("u/s");
+    a.checkEqual("61. numItems", u.numItems, 2);
+    a.checkEqual("62. totalKBytes", u.totalKBytes, 3);
+
+    // Remove directory
+    testee.removeDirectory("u/s");
+    u = testee.getDiskUsage("u");
+    a.checkEqual("71. numItems", u.numItems, 1);
+    a.checkEqual("72. totalKBytes", u.totalKBytes, 1);
+
+    // Result matches a fresh computation
+    testee.putFile("u/x", String_t(1025, 'x'));
+    testee.forgetDirectory("u");
+    u = testee.getDiskUsage("u");
+    a.checkEqual("81. numItems", u.numItems, 2);
+    a.checkEqual("82. totalKBytes", u.totalKBytes, 3);
+}
+
 /** Test putFile. */
 AFL_TEST("server.file.FileBase:putFile", a)
 {
@@ -37,6 +37,10 @@ AFL_TEST("server.file.Root", a)
             { return Info(); }
         virtual void removeDirectory(String_t /*name*/)
             { }
+        virtual bool getTotals(int32_t& /*numFiles*/, int32_t& /*totalKBytes*/)
+            { return false; }
+        virtual void setTotals(int32_t /*numFiles*/, int32_t /*totalKBytes*/)
+            { }
     };
     server::file::DirectoryItem item("(root)", 0, std::auto_ptr<server::file::DirectoryHandler>(new NullDirectoryHandler()));
 
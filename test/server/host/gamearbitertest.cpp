@@ -53,3 +53,32 @@ AFL_TEST("server.host.GameArbiter:Guard", a)
         AFL_CHECK_THROWS(a, server::host::GameArbiter::Guard(testee, 17, server::host::GameArbiter::Host), std::runtime_error);
     }
 }
+
+/** Test modification counters.
+    A: lock and unlock games with different intents; report modifications.
+    E: counter changes after every modification, and only for the affected game */
+AFL_TEST("server.host.GameArbiter:getModificationCounter", a)
+{
+    server::host::GameArbiter testee;
+    const uint32_t c10 = testee.getModificationCounter(10);
+    const uint32_t c20 = testee.getModificationCounter(20);
+
+    // Simple access does not modify
+    { server::host::GameArbiter::Guard g(testee, 10, server::host::GameArbiter::Simple); }
+    a.checkEqual("01. simple", testee.getModificationCounter(10), c10);
+
+    // Critical access modifies
+    { server::host::GameArbiter::Guard g(testee, 10, server::host::GameArbiter::Critical); }
+    const uint32_t c10b = testee.getModificationCounter(10);
+    a.checkDifferent("11. critical", c10b, c10);
+    a.checkEqual("12. other", testee.getModificationCounter(20), c20);
+
+    // Explicit report
+    testee.markModified(20);
+    a.checkDifferent("21. markModified", testee.getModificationCounter(20), c20);
+    a.checkEqual("22. other", testee.getModificationCounter(10), c10b);
+
+    // Global report
+    testee.markAllModified();
+    a.checkDifferent("31. markAllModified", testee.getModificationCounter(10), c10b);
+}
@@ -0,0 +1,136 @@
+/**
+  *  \file test/server/host/gameindextest.cpp
+  *  \brief Test for server::host::GameIndex
+  */
+
+#include "server/host/gameindex.hpp"
+
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/net/nullcommandhandler.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/integersetkey.hpp"
+#include "afl/net/redis/internaldatabase.hpp"
+#include "afl/net/redis/stringfield.hpp"
+#include "afl/net/redis/stringsetkey.hpp"
+#include "afl/string/format.hpp"
+#include "afl/test/testrunner.hpp"
+#include "server/host/configuration.hpp"
+#include "server/host/root.hpp"
+#include "server/interface/mailqueueclient.hpp"
+#include "util/processrunner.hpp"
+
+using afl::net::redis::HashKey;
+using afl::net::redis::IntegerSetKey;
+using afl::net::redis::StringSetKey;
+using server::host::GameIndex;
+
+namespace {
+    struct Environment {
+        afl::net::redis::InternalDatabase db;
+        afl::net::NullCommandHandler null;
+        server::interface::MailQueueClient mail;
+        util::ProcessRunner runner;
+        afl::io::NullFileSystem fs;
+        server::host::Root root;
+
+        Environment()
+            : db(), null(), mail(null), runner(), fs(),
+              root(db, null, null, mail, runner, fs, server::host::Configuration())
+            { }
+    };
+
+    void addGame(afl::net::CommandHandler& db, int32_t gameId, String_t host, String_t tool)
+    {
+        IntegerSetKey(db, "game:all").add(gameId);
+        HashKey(db, afl::string::Format("game:%d:settings", gameId)).stringField("host").set(host);
+        StringSetKey(db, afl::string::Format("game:%d:tools", gameId)).add(tool);
+    }
+}
+
+/** Test building the index.
+    A: create games in database. Call ensureValid().
+    E: index sets contain the expected games */
+AFL_TEST("server.host.GameIndex:rebuild", a)
+{
+    Environment env;
+    addGame(env.db, 1, "H", "T");
+    addGame(env.db, 2, "H", "U");
+    addGame(env.db, 3, "P", "T");
+
+    GameIndex testee(env.root);
+    a.check("01. isValid", !testee.isValid());
+    testee.ensureValid();
+    a.check("02. isValid", testee.isValid());
+
+    a.checkEqual("11. host H", testee.bySetting("host", "H").size(), 2);
+    a.checkEqual("12. host P", testee.bySetting("host", "P").size(), 1);
+    a.check     ("13. host P", testee.bySetting("host", "P").contains(3));
+    a.checkEqual("14. tool T", testee.byTool("T").size(), 2);
+    a.check     ("15. tool U", testee.byTool("U").contains(2));
+    a.checkEqual("16. master", testee.bySetting("master", "").size(), 0);
+
+    // Rebuilding produces the same result
+    testee.rebuild();
+    a.checkEqual("21. host H", testee.bySetting("host", "H").size(), 2);
+    a.checkEqual("22. tool T", testee.byTool("T").size(), 2);
+}
+
+/** Test updating the index.
+    A: build index. Change a game's settings and tools; call update().
+    E: game moved to new sets */
+AFL_TEST("server.host.GameIndex:update", a)
+{
+    Environment env;
+    addGame(env.db, 1, "H", "T");
+    addGame(env.db, 2, "H", "U");
+
+    GameIndex testee(env.root);
+    testee.ensureValid();
+
+    // Change game 1
+    HashKey(env.db, "game:1:settings").stringField("host").set("P");
+    HashKey(env.db, "game:1:settings").stringField("copyOf").set("2");
+    StringSetKey(env.db, "game:1:tools").remove("T");
+    StringSetKey(env.db, "game:1:tools").add("U");
+    testee.update(1);
+
+    a.checkEqual("01. host H",   testee.bySetting("host", "H").size(), 1);
+    a.check     ("02. host P",   testee.bySetting("host", "P").contains(1));
+    a.check     ("03. copyOf",   testee.bySetting("copyOf", "2").contains(1));
+    a.checkEqual("04. tool T",   testee.byTool("T").size(), 0);
+    a.checkEqual("05. tool U",   testee.byTool("U").size(), 2);
+
+    // Remove a setting
+    HashKey(env.db, "game:1:settings").field("copyOf").remove();
+    testee.update(1);
+    a.checkEqual("11. copyOf",   testee.bySetting("copyOf", "2").size(), 0);
+}
+
+/** Test update() on an index that has not been built.
+    A: create game; call update() without building the index.
+    E: nothing is indexed; ensureValid() later builds complete index */
+AFL_TEST("server.host.GameIndex:update:invalid", a)
+{
+    Environment env;
+    addGame(env.db, 1, "H", "T");
+    addGame(env.db, 2, "H", "U");
+
+    GameIndex testee(env.root);
+    testee.update(1);
+    a.check("01. isValid", !testee.isValid());
+    a.checkEqual("02. host H", testee.bySetting("host", "H").size(), 0);
+
+    testee.ensureValid();
+    a.checkEqual("11. host H", testee.bySetting("host", "H").size(), 2);
+}
+
+/** Test isIndexedSetting(). */
+AFL_TEST("server.host.GameIndex:isIndexedSetting", a)
+{
+    a.check("01", GameIndex::isIndexedSetting("host"));
+    a.check("02", GameIndex::isIndexedSetting("shiplist"));
+    a.check("03", GameIndex::isIndexedSetting("master"));
+    a.check("04", GameIndex::isIndexedSetting("copyOf"));
+    a.check("05", !GameIndex::isIndexedSetting("description"));
+    a.check("06", !GameIndex::isIndexedSetting("tool"));
+}
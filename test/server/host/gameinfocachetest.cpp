@@ -0,0 +1,40 @@
+/**
+  *  \file test/server/host/gameinfocachetest.cpp
+  *  \brief Test for server::host::GameInfoCache
+  */
+
+#include "server/host/gameinfocache.hpp"
+
+#include "afl/test/testrunner.hpp"
+
+using server::host::GameInfoCache;
+
+/** Test basic operation.
+    A: store and retrieve descriptions with different counters.
+    E: description only returned for matching counter */
+AFL_TEST("server.host.GameInfoCache:basics", a)
+{
+    GameInfoCache testee;
+    a.checkNull("01. get", testee.get(1, 0));
+
+    GameInfoCache::Info_t info;
+    info.gameId = 1;
+    info.name = "One";
+    testee.put(1, 5, info);
+
+    const GameInfoCache::Info_t* p = testee.get(1, 5);
+    a.checkNonNull("11. get", p);
+    a.checkEqual("12. name", p->name, "One");
+    a.checkNull("13. get", testee.get(1, 6));
+    a.checkNull("14. get", testee.get(2, 5));
+
+    // Replace
+    info.name = "Uno";
+    testee.put(1, 6, info);
+    a.checkNull("21. get", testee.get(1, 5));
+    a.checkEqual("22. name", testee.get(1, 6)->name, "Uno");
+
+    // Clear
+    testee.clear();
+    a.checkNull("31. get", testee.get(1, 6));
+}
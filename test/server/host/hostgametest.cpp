@@ -409,6 +409,39 @@ AFL_TEST("server.host.HostGame:getInfo", a)
     }
 }
 
+/** Test getInfos(), cached descriptions.
+    A: create game. Call getInfos(); modify game; call getInfos() again.
+    E: second call reports modified data */
+AFL_TEST("server.host.HostGame:getInfos:cache", a)
+{
+    TestHarness h;
+    h.addDefaultTools();
+    server::host::Session session;
+    server::host::HostGame testee(session, h.root());
+
+    a.checkEqual("01. createNewGame", testee.createNewGame(), 1);
+    AFL_CHECK_SUCCEEDS(a("02. setName"), testee.setName(1, "One"));
+
+    {
+        std::vector<HostGame::Info> result;
+        AFL_CHECK_SUCCEEDS(a("11. getInfos"), testee.getInfos(HostGame::Filter(), false, result));
+        a.checkEqual("12. size", result.size(), 1U);
+        a.checkEqual("13. name", result[0].name, "One");
+        a.checkEqual("14. state", result[0].state, HostGame::Preparing);
+    }
+
+    AFL_CHECK_SUCCEEDS(a("21. setName"), testee.setName(1, "Uno"));
+    AFL_CHECK_SUCCEEDS(a("22. setState"), testee.setState(1, HostGame::Joining));
+
+    {
+        std::vector<HostGame::Info> result;
+        AFL_CHECK_SUCCEEDS(a("31. getInfos"), testee.getInfos(HostGame::Filter(), false, result));
+        a.checkEqual("32. size", result.size(), 1U);
+        a.checkEqual("33. name", result[0].name, "Uno");
+        a.checkEqual("34. state", result[0].state, HostGame::Joining);
+    }
+}
+
 /** Test setConfig, simple. */
 AFL_TEST("server.host.HostGame:setConfig", a)
 {
@@ -5,6 +5,8 @@
 
 #include "server/monitor/status.hpp"
 
+#include "afl/sys/semaphore.hpp"
+#include "afl/sys/time.hpp"
 #include "afl/test/testrunner.hpp"
 #include "server/monitor/statusobserver.hpp"
 
@@ -29,6 +31,54 @@ namespace {
         String_t m_name;
         Status m_status;
     };
+
+    /* Observer that blocks until released */
+    class HangingObserver : public server::monitor::Observer {
+     public:
+        HangingObserver(String_t name, afl::sys::Semaphore& sem)
+            : m_name(name),
+              m_semaphore(sem)
+            { }
+        String_t getName()
+            { return m_name; }
+        String_t getId()
+            { return "ID"; }
+        String_t getUnit()
+            { return "unit"; }
+        bool handleConfiguration(const String_t& /*key*/, const String_t& /*value*/)
+            { return false; }
+        Result check()
+            {
+                m_semaphore.wait();
+                return Result(Value, 9);
+            }
+     private:
+        String_t m_name;
+        afl::sys::Semaphore& m_semaphore;
+    };
+
+    /* Status observer that blocks until released */
+    class HangingStatusObserver : public server::monitor::StatusObserver {
+     public:
+        HangingStatusObserver(String_t name, afl::sys::Semaphore& sem)
+            : m_name(name),
+              m_semaphore(sem)
+            { }
+        String_t getName()
+            { return m_name; }
+        String_t getId()
+            { return "ID"; }
+        bool handleConfiguration(const String_t& /*key*/, const String_t& /*value*/)
+            { return false; }
+        Status checkStatus()
+            {
+                m_semaphore.wait();
+                return Running;
+            }
+     private:
+        String_t m_name;
+        afl::sys::Semaphore& m_semaphore;
+    };
 }
 
 /** Test default-initialized (empty) Status. */
@@ -117,3 +167,74 @@ AFL_TEST("server.monitor.Status:multiple", a)
                  "        <span class=\"status\">unknown</span>\n"
                  "      </div>\n");
 }
+
+/** Test hanging observers.
+    A hanging observer must not block the others, and is reported according to its type. */
+AFL_TEST("server.monitor.Status:timeout", a)
+{
+    afl::sys::Semaphore sem(0);
+    server::monitor::Status testee;
+    testee.setTimeout(100);
+    testee.addNewObserver(new TestObserver("A", TestObserver::Running));
+    testee.addNewObserver(new HangingStatusObserver("B", sem));
+    testee.addNewObserver(new HangingObserver("C", sem));
+    testee.addNewObserver(new TestObserver("D", TestObserver::Value));
+
+    // Update twice; second time, the hung observers are not restarted
+    testee.update();
+    testee.update();
+
+    // Verify
+    afl::sys::Time time;
+    a.checkEqual("01. render", testee.render(time),
+                 "      <div class=\"service active-service\" id=\"service0\">\n"
+                 "        <h2>A</h2>\n"
+                 "        <span class=\"status\">active</span>\n"
+                 "        <span class=\"latency\">7&nbsp;ms</span>\n"
+                 "      </div>\n"
+                 "      <div class=\"service broken-service\" id=\"service1\">\n"
+                 "        <h2>B</h2>\n"
+                 "        <span class=\"status\">broken</span>\n"
+                 "      </div>\n"
+                 "      <div class=\"service unknown-service\" id=\"service2\">\n"
+                 "        <h2>C</h2>\n"
+                 "        <span class=\"status\">unknown</span>\n"
+                 "      </div>\n"
+                 "      <div class=\"service active-service\" id=\"service3\">\n"
+                 "        <h2>D</h2>\n"
+                 "        <span class=\"value\">7&nbsp;unit</span>\n"
+                 "      </div>\n");
+
+    // Release the observers so Status can be destroyed
+    sem.post();
+    sem.post();
+}
+
+/** Test hung observers in a later round.
+    An observer whose previous check is still running must not delay the update. */
+AFL_TEST("server.monitor.Status:hung", a)
+{
+    afl::sys::Semaphore sem(0);
+    server::monitor::Status testee;
+    testee.addNewObserver(new TestObserver("A", TestObserver::Running));
+    testee.addNewObserver(new HangingStatusObserver("B", sem));
+
+    // First round: B times out
+    testee.setTimeout(100);
+    testee.update();
+
+    // Second round: B is known to hang, so we do not wait for it, even with a long timeout
+    testee.setTimeout(60000);
+    uint32_t startTime = afl::sys::Time::getTickCounter();
+    testee.update();
+    uint32_t elapsed = afl::sys::Time::getTickCounter() - startTime;
+    a.checkLessThan("01. elapsed", elapsed, 30000U);
+
+    afl::sys::Time time;
+    String_t result = testee.render(time);
+    a.check("11. broken", result.find("broken-service") != String_t::npos);
+    a.check("12. active", result.find("active-service") != String_t::npos);
+
+    // Release the observer so Status can be destroyed
+    sem.post();
+}
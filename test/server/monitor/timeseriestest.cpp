@@ -45,60 +45,97 @@ AFL_TEST("server.monitor.TimeSeries:basics", a)
     a.checkEqual("62. get", t.get(4, timeOut, valueOut), false);
 }
 
-/** Test compact(). */
-AFL_TEST("server.monitor.TimeSeries:compact", a)
+/** Test multi-resolution storage. */
+AFL_TEST("server.monitor.TimeSeries:levels", a)
 {
-    // Create 2000 elements
-    server::monitor::TimeSeries t;
-    for (int i = 1; i <= 2000; ++i) {
+    // 32 elements: 8 levels of 4 elements
+    server::monitor::TimeSeries t(32);
+    for (int i = 1; i <= 32; ++i) {
         t.add(afl::sys::Time::fromUnixTime(i), true, i);
     }
 
-    // Compact down to 1500
-    t.compact(0, 1000, 2);
+    // Verify: newest 4 elements at full resolution, older ones averaged
+    // - level 0: 29,30,31,32
+    // - level 1: 21,23,25,27
+    // - level 2: 10,14,18
+    // - level 3: 4
+    a.checkEqual("01. size", t.size(), 12U);
+
+    static const int32_t EXPECT[] = { 4, 10, 14, 18, 21, 23, 25, 27, 29, 30, 31, 32 };
+    for (size_t i = 0; i < 12; ++i) {
+        afl::sys::Time timeOut;
+        int32_t valueOut;
+        a.checkEqual("11. get", t.get(i, timeOut, valueOut), true);
+        a.checkEqual("12. valueOut", valueOut, EXPECT[i]);
+    }
 
-    // Verify
-    a.checkEqual("01. size", t.size(), 1500U);
+    // Time of merged element is average of its inputs
+    afl::sys::Time timeOut;
+    int32_t valueOut;
+    a.checkEqual("21. get", t.get(4, timeOut, valueOut), true);
+    a.checkEqual("22. time", (timeOut - afl::sys::Time::fromUnixTime(0)).getMilliseconds(), 21500);
+    a.checkEqual("23. get", t.get(11, timeOut, valueOut), true);
+    a.checkEqual("24. time", timeOut.getUnixTime(), 32);
+}
 
+/** Test that size is bounded. */
+AFL_TEST("server.monitor.TimeSeries:bounded", a)
+{
+    server::monitor::TimeSeries t(32);
+    for (int i = 1; i <= 100000; ++i) {
+        t.add(afl::sys::Time::fromUnixTime(i), (i % 3) != 0, i);
+        a.checkLessEqual("01. size", t.size(), 32U);
+    }
+
+    // Oldest element is still old, newest is current
     afl::sys::Time timeOut;
+    bool validOut;
     int32_t valueOut;
-    a.checkEqual("11. get", t.get(1499, timeOut, valueOut), true);
-    a.checkEqual("12. getUnixTime", timeOut.getUnixTime(), 2000);
-    a.checkEqual("13. valueOut", valueOut, 2000);
+    a.checkEqual("11. get", t.get(0, timeOut, validOut, valueOut), true);
+    a.checkLessThan("12. time", timeOut.getUnixTime(), 99500);
+    a.checkEqual("13. get", t.get(t.size()-1, timeOut, validOut, valueOut), true);
+    a.checkEqual("14. time", timeOut.getUnixTime(), 100000);
+    a.checkEqual("15. valid", validOut, true);
+    a.checkEqual("16. value", valueOut, 100000);
+}
 
-    a.checkEqual("21. get", t.get(500, timeOut, valueOut), true);
-    a.checkEqual("22. getUnixTime", timeOut.getUnixTime(), 1001);
-    a.checkEqual("23. valueOut", valueOut, 1001);
+/** Test merging of invalid values. */
+AFL_TEST("server.monitor.TimeSeries:invalid", a)
+{
+    // Level size 2
+    server::monitor::TimeSeries t(16);
+    t.add(afl::sys::Time::fromUnixTime(10), false, 1);
+    t.add(afl::sys::Time::fromUnixTime(20), false, 2);
+    t.add(afl::sys::Time::fromUnixTime(30), true, 3);
+    t.add(afl::sys::Time::fromUnixTime(40), false, 4);
+    t.add(afl::sys::Time::fromUnixTime(50), true, 5);
+    t.add(afl::sys::Time::fromUnixTime(60), true, 6);
+
+    // Level 0: 50,60; level 1: (10,20)=invalid, (30,40)=3
+    a.checkEqual("01. size", t.size(), 4U);
 
-    a.checkEqual("31. get", t.get(0, timeOut, valueOut), true);
-    a.checkEqual("32. getUnixTime", timeOut.getUnixTime(), 1);
-    a.checkEqual("33. valueOut", valueOut, 1);
+    afl::sys::Time timeOut;
+    bool validOut;
+    int32_t valueOut;
+    a.checkEqual("11. get", t.get(0, timeOut, validOut, valueOut), true);
+    a.checkEqual("12. time", timeOut.getUnixTime(), 15);
+    a.checkEqual("13. valid", validOut, false);
 
-    a.checkEqual("41. get", t.get(100, timeOut, valueOut), true);
-    a.checkEqual("42. getUnixTime", timeOut.getUnixTime(), 201);
-    a.checkEqual("43. valueOut", valueOut, 201);
+    a.checkEqual("21. get", t.get(1, timeOut, validOut, valueOut), true);
+    a.checkEqual("22. time", timeOut.getUnixTime(), 35);
+    a.checkEqual("23. valid", validOut, true);
+    a.checkEqual("24. value", valueOut, 3);
 }
 
 /** Test render(). */
 AFL_TEST("server.monitor.TimeSeries:render", a)
 {
-    // Create 2000 elements
+    // Create 2000 elements. This will fill 4 levels.
     server::monitor::TimeSeries t;
-    int counter = 0;
-    for (int i = 0; i < 2000; ++i) {
-        ++counter;
-        t.add(afl::sys::Time::fromUnixTime(counter), true, counter);
-    }
-
-    // Compact three times, always fill up again
-    for (int q = 0; q < 3; ++q) {
-        t.compact(0, 1000, 2);
-        for (int i = 0; i < 500; ++i) {
-            ++counter;
-            t.add(afl::sys::Time::fromUnixTime(counter), true, counter);
-        }
+    for (int i = 1; i <= 2000; ++i) {
+        t.add(afl::sys::Time::fromUnixTime(i), true, i);
     }
-    a.checkEqual("01. size", t.size(), 2000U);
+    a.checkEqual("01. size", t.size(), 780U);
 
     // Render
     String_t result = t.render(500, 500);
@@ -0,0 +1,130 @@
+/**
+  *  \file test/server/play/changetrackertest.cpp
+  *  \brief Test for server::play::ChangeTracker
+  */
+
+#include "server/play/changetracker.hpp"
+
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/game.hpp"
+#include "game/map/ship.hpp"
+#include "game/map/universe.hpp"
+#include "game/session.hpp"
+#include "game/turn.hpp"
+
+using server::play::ChangeTracker;
+
+namespace {
+    void addShip(game::Game& g, game::Id_t id)
+    {
+        game::map::Ship& sh = *g.currentTurn().universe().ships().create(id);
+        sh.addShipXYData(game::map::Point(1000, 1000+id), 1, 100, game::PlayerSet_t(2));
+        sh.internalCheck(game::PlayerSet_t(2), 10);
+    }
+}
+
+/** Test normal operation: changes are reported with increasing versions. */
+AFL_TEST("server.play.ChangeTracker:normal", a)
+{
+    afl::io::NullFileSystem fs;
+    afl::string::NullTranslator tx;
+    game::Session session(tx, fs);
+    afl::base::Ptr<game::Game> g = new game::Game();
+    for (game::Id_t i = 1; i <= 5; ++i) {
+        addShip(*g, i);
+    }
+    session.setGame(g);
+
+    ChangeTracker testee;
+    testee.update(session);
+    const ChangeTracker::Version_t v1 = testee.getVersion();
+
+    // Nothing changed since v1
+    std::vector<game::Id_t> ids;
+    a.check("01. getChanges", testee.getChanges(ChangeTracker::Ships, v1, ids));
+    a.checkEqual("02. size", ids.size(), 0U);
+
+    // Modify two ships
+    g->currentTurn().universe().ships().get(2)->setName("two");
+    g->currentTurn().universe().ships().get(4)->setName("four");
+    testee.update(session);
+    const ChangeTracker::Version_t v2 = testee.getVersion();
+    a.check("11. version", v2 > v1);
+
+    ids.clear();
+    a.check("12. getChanges", testee.getChanges(ChangeTracker::Ships, v1, ids));
+    a.checkEqual("13. size", ids.size(), 2U);
+    a.checkEqual("14. id", ids[0], 2);
+    a.checkEqual("15. id", ids[1], 4);
+
+    ids.clear();
+    a.check("21. getChanges", testee.getChanges(ChangeTracker::Ships, v2, ids));
+    a.checkEqual("22. size", ids.size(), 0U);
+
+    ids.clear();
+    a.check("31. getChanges", testee.getChanges(ChangeTracker::Planets, v1, ids));
+    a.checkEqual("32. size", ids.size(), 0U);
+
+    // Unknown versions
+    a.check("41. getChanges", !testee.getChanges(ChangeTracker::Ships, v2+1, ids));
+    a.check("42. getChanges", !testee.getChanges(ChangeTracker::Ships, 0, ids));
+}
+
+/** Test replacing the game: old versions become invalid. */
+AFL_TEST("server.play.ChangeTracker:new-game", a)
+{
+    afl::io::NullFileSystem fs;
+    afl::string::NullTranslator tx;
+    game::Session session(tx, fs);
+    afl::base::Ptr<game::Game> g = new game::Game();
+    addShip(*g, 1);
+    session.setGame(g);
+
+    ChangeTracker testee;
+    testee.update(session);
+    const ChangeTracker::Version_t v1 = testee.getVersion();
+
+    afl::base::Ptr<game::Game> g2 = new game::Game();
+    addShip(*g2, 1);
+    session.setGame(g2);
+    testee.update(session);
+
+    std::vector<game::Id_t> ids;
+    a.check("01. getChanges", !testee.getChanges(ChangeTracker::Ships, v1, ids));
+    a.check("02. version", testee.getVersion() > v1);
+}
+
+/** Test version from another tracker instance (e.g. before a server restart).
+    A: serve a version from one tracker; present it to a different tracker on the same game.
+    E: stale version is not accepted; client needs a full list */
+AFL_TEST("server.play.ChangeTracker:stale-token", a)
+{
+    afl::io::NullFileSystem fs;
+    afl::string::NullTranslator tx;
+    game::Session session(tx, fs);
+    afl::base::Ptr<game::Game> g = new game::Game();
+    addShip(*g, 1);
+    session.setGame(g);
+
+    // Explicit epochs
+    ChangeTracker first(1000);
+    first.update(session);
+    const ChangeTracker::Version_t v1 = first.getVersion();
+    a.check("01. version", v1 >= 1000);
+
+    ChangeTracker second(5000000);
+    second.update(session);
+    std::vector<game::Id_t> ids;
+    a.check("11. getChanges", !second.getChanges(ChangeTracker::Ships, v1, ids));
+    a.check("12. getChanges", second.getChanges(ChangeTracker::Ships, second.getVersion(), ids));
+
+    // Default epochs differ between instances, and fit into a JSON integer
+    ChangeTracker third, fourth;
+    third.update(session);
+    fourth.update(session);
+    a.checkDifferent("21. version", third.getVersion(), fourth.getVersion());
+    a.check("22. version", third.getVersion() < 0x7FFFFFFF);
+    a.check("23. getChanges", !fourth.getChanges(ChangeTracker::Ships, third.getVersion(), ids));
+}
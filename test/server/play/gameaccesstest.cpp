@@ -7,12 +7,17 @@
 
 #include "afl/data/access.hpp"
 #include "afl/io/nullfilesystem.hpp"
+#include "afl/string/format.hpp"
 #include "afl/string/nulltranslator.hpp"
 #include "afl/test/testrunner.hpp"
+#include "game/game.hpp"
+#include "game/map/ship.hpp"
+#include "game/map/universe.hpp"
 #include "game/session.hpp"
 #include "game/spec/shiplist.hpp"
 #include "game/test/root.hpp"
 #include "game/test/shiplist.hpp"
+#include "game/turn.hpp"
 #include "util/messagecollector.hpp"
 
 using afl::data::Access;
@@ -174,3 +179,53 @@ AFL_TEST("server.play.GameAccess:get:multiple", a)
     a.checkNonNull("02", ap("hull1").getValue());
     a.checkNonNull("03", ap("engine").getValue());
 }
+
+/** Test get(), delta ship list.
+    A: create game with ships. 'GET obj/shipxy@0', modify a ship, 'GET obj/shipxy@N'.
+    E: first request produces full list, second request produces only the modified ship */
+AFL_TEST("server.play.GameAccess:get:obj/shipxy@N", a)
+{
+    Environment env;
+    afl::base::Ptr<game::Game> g = new game::Game();
+    env.session.setGame(g);
+    for (int i = 1; i <= 4; ++i) {
+        game::map::Ship& sh = *g->currentTurn().universe().ships().create(i);
+        sh.addShipXYData(game::map::Point(1000, 1000+i), 1, 100, game::PlayerSet_t(2));
+        sh.internalCheck(game::PlayerSet_t(2), 10);
+    }
+
+    // Full list
+    std::auto_ptr<server::Value_t> result(env.testee.get("obj/shipxy@0"));
+    Access ap(result.get());
+    a.checkEqual("01. FULL", ap("shipxy")("FULL").toInteger(), 1);
+    a.checkEqual("02. DATA", ap("shipxy")("DATA").getArraySize(), 5U);
+    a.checkEqual("03. Y",    ap("shipxy")("DATA")[3]("Y").toInteger(), 1003);
+    int32_t version = ap("shipxy")("VERSION").toInteger();
+
+    // No change
+    std::auto_ptr<server::Value_t> result1(env.testee.get(afl::string::Format("obj/shipxy@%d", version)));
+    Access ap1(result1.get());
+    a.checkEqual("11. FULL",    ap1("shipxy")("FULL").toInteger(), 0);
+    a.checkEqual("12. CHANGED", ap1("shipxy")("CHANGED").getArraySize(), 0U);
+    a.checkEqual("13. VERSION", ap1("shipxy")("VERSION").toInteger(), version);
+
+    // Modify a ship
+    g->currentTurn().universe().ships().get(3)->setName("Three");
+    std::auto_ptr<server::Value_t> result2(env.testee.get(afl::string::Format("obj/shipxy@%d", version)));
+    Access ap2(result2.get());
+    a.checkEqual("21. FULL",    ap2("shipxy")("FULL").toInteger(), 0);
+    a.checkEqual("22. CHANGED", ap2("shipxy")("CHANGED").getArraySize(), 1U);
+    a.checkEqual("23. Id",      ap2("shipxy")("CHANGED")[0][0].toInteger(), 3);
+    a.checkEqual("24. NAME",    ap2("shipxy")("CHANGED")[0][1]("NAME").toString(), "Three");
+    a.check     ("25. VERSION", ap2("shipxy")("VERSION").toInteger() > version);
+
+    // Plain request still produces plain list
+    std::auto_ptr<server::Value_t> result3(env.testee.get("obj/shipxy"));
+    Access ap3(result3.get());
+    a.checkEqual("31. plain", ap3("shipxy").getArraySize(), 5U);
+
+    // Unknown version produces full list
+    std::auto_ptr<server::Value_t> result4(env.testee.get("obj/shipxy@99999"));
+    Access ap4(result4.get());
+    a.checkEqual("41. FULL", ap4("shipxy")("FULL").toInteger(), 1);
+}
@@ -15,4 +15,6 @@ AFL_TEST("server.router.Configuration:init", a)
     a.check("03", testee.virginTimeout > 0);
     a.check("04", testee.maxSessions > 0);
     a.check("05", !testee.newSessionsWin);
+    a.checkEqual("06", testee.poolSize, 0U);
+    a.checkEqual("07", testee.specSnapshot, "");
 }
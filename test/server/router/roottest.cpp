@@ -20,6 +20,8 @@ namespace {
      */
 
     uint32_t globalCounter = 0;
+    uint32_t numPoolStarts = 0;
+    String_t lastCommandLine;
 
     class SubprocessMock : public util::process::Subprocess {
      public:
@@ -30,9 +32,19 @@ namespace {
             { return m_isActive; }
         virtual uint32_t getProcessId() const
             { return m_processId; }
-        virtual bool start(const String_t& /*path*/, afl::base::Memory<const String_t> /*args*/)
+        virtual bool start(const String_t& /*path*/, afl::base::Memory<const String_t> args)
             {
-                m_replies.push("100 hi there\n");
+                lastCommandLine.clear();
+                for (size_t i = 0; i < args.size(); ++i) {
+                    lastCommandLine += (i == 0 ? "" : " ");
+                    lastCommandLine += *args.at(i);
+                }
+                const String_t* p = args.at(0);
+                m_replies.push(p != 0 && *p == "--pool"
+                               ? "101 ready\n"
+                               : lastCommandLine.find("bad") != String_t::npos
+                               ? "400 bad parameter\n"
+                               : "100 hi there\n");
                 m_processId = ++globalCounter;
                 m_isActive = true;
                 return true;
@@ -42,8 +54,20 @@ namespace {
                 m_isActive = false;
                 return true;
             }
-        virtual bool writeLine(const String_t& /*line*/)
-            { return false; }
+        virtual bool writeLine(const String_t& line)
+            {
+                if (line.compare(0, 6, "START ", 6) == 0) {
+                    ++numPoolStarts;
+                    m_replies.push(line.find("bad") != String_t::npos ? "400 bad parameter\n" : "100 hi there\n");
+                    return true;
+                }
+                if (line == "QUIT\n") {
+                    m_replies.push("100 session closed\n");
+                    m_replies.push("101 ready\n");
+                    return true;
+                }
+                return false;
+            }
         virtual bool readLine(String_t& result)
             {
                 if (m_replies.empty()) {
@@ -231,3 +255,183 @@ AFL_TEST("server.router.Root:restart", a)
 
     a.checkDifferent("21. pid", pid1, pid2);
 }
+
+/** Test process pool.
+    A: create a Root with a pool. Start sessions.
+    E: sessions are started from pool; pool is refilled within maxSessions limit. */
+AFL_TEST("server.router.Root:pool", a)
+{
+    // Environment
+    FactoryMock factory;
+    server::common::NumericalIdGenerator gen;
+    server::router::Configuration config;
+    config.maxSessions = 3;
+    config.poolSize = 2;
+
+    // Testee
+    server::router::Root testee(factory, gen, config, 0);
+    testee.fillPool();
+    a.checkEqual("01. getPoolSize", testee.getPoolSize(), 2U);
+
+    // Start a session: pool is refilled
+    server::router::Session& s1 = testee.createSession(afl::base::Nothing);
+    a.check("11. isActive", s1.isActive());
+    a.checkEqual("12. getPoolSize", testee.getPoolSize(), 2U);
+
+    // Start another: pool is limited by maxSessions
+    server::router::Session& s2 = testee.createSession(afl::base::Nothing);
+    a.check("21. isActive", s2.isActive());
+    a.checkEqual("22. getPoolSize", testee.getPoolSize(), 1U);
+
+    server::router::Session& s3 = testee.createSession(afl::base::Nothing);
+    a.check("31. isActive", s3.isActive());
+    a.checkEqual("32. getPoolSize", testee.getPoolSize(), 0U);
+
+    // Limit reached
+    AFL_CHECK_THROWS(a("41. createSession overflow"), testee.createSession(afl::base::Nothing), std::exception);
+
+    // Stopping a session makes room for a pooled process again
+    s1.stop();
+    testee.removeExpiredSessions();
+    a.checkEqual("51. sessions", testee.sessions().size(), 2U);
+    a.checkEqual("52. getPoolSize", testee.getPoolSize(), 1U);
+
+    // Stop everything
+    testee.stopAllSessions();
+    a.checkEqual("61. getPoolSize", testee.getPoolSize(), 0U);
+}
+
+/** Test specification snapshot.
+    A: create a Root with a pool and a specification snapshot. Create the snapshot and fill the pool.
+    E: snapshot is created by the server; pooled processes receive it. */
+AFL_TEST("server.router.Root:createSpecSnapshot", a)
+{
+    // Environment
+    FactoryMock factory;
+    server::common::NumericalIdGenerator gen;
+    server::router::Configuration config;
+    config.poolSize = 1;
+    config.specSnapshot = "snap.bin";
+
+    // Testee
+    server::router::Root testee(factory, gen, config, 0);
+    a.check("01. createSpecSnapshot", testee.createSpecSnapshot());
+    a.checkEqual("02. command", lastCommandLine, "-M snap.bin");
+
+    testee.fillPool();
+    a.checkEqual("11. getPoolSize", testee.getPoolSize(), 1U);
+    a.checkEqual("12. command", lastCommandLine, "--pool -S snap.bin");
+}
+
+/** Test specification snapshot, not configured.
+    A: create a Root with a pool, but no specification snapshot. Create the snapshot and fill the pool.
+    E: no snapshot created; pooled processes are started without one. */
+AFL_TEST("server.router.Root:createSpecSnapshot:none", a)
+{
+    // Environment
+    FactoryMock factory;
+    server::common::NumericalIdGenerator gen;
+    server::router::Configuration config;
+    config.poolSize = 1;
+
+    // Testee
+    server::router::Root testee(factory, gen, config, 0);
+    a.check("01. createSpecSnapshot", !testee.createSpecSnapshot());
+
+    testee.fillPool();
+    a.checkEqual("11. getPoolSize", testee.getPoolSize(), 1U);
+    a.checkEqual("12. command", lastCommandLine, "--pool");
+}
+
+/** Test recycling of pooled processes.
+    A: create a Root with a pool. Start a session from the pool and let it time out.
+    E: the session's process is returned to the pool instead of starting a new one. */
+AFL_TEST("server.router.Root:pool:recycle", a)
+{
+    // Environment
+    FactoryMock factory;
+    server::common::NumericalIdGenerator gen;
+    server::router::Configuration config;
+    config.maxSessions = 2;
+    config.poolSize = 2;
+    config.virginTimeout = 0;
+
+    // Testee
+    server::router::Root testee(factory, gen, config, 0);
+    testee.fillPool();
+    a.checkEqual("01. getPoolSize", testee.getPoolSize(), 2U);
+
+    // Start a session: pool is refilled only up to maxSessions
+    server::router::Session& s = testee.createSession(afl::base::Nothing);
+    a.check("11. isActive", s.isActive());
+    a.checkEqual("12. getPoolSize", testee.getPoolSize(), 1U);
+
+    // Session times out; process goes back to pool
+    uint32_t counter = globalCounter;
+    testee.removeExpiredSessions();
+    a.checkEqual("21. sessions", testee.sessions().size(), 0U);
+    a.checkEqual("22. getPoolSize", testee.getPoolSize(), 2U);
+    a.checkEqual("23. no new process", globalCounter, counter);
+
+    // Process can be used again
+    server::router::Session& s2 = testee.createSession(afl::base::Nothing);
+    a.check("31. isActive", s2.isActive());
+    a.checkEqual("32. getPoolSize", testee.getPoolSize(), 1U);
+}
+
+/** Test session failure with process pool.
+    A: create a Root with a pool. Start a session with parameters the server rejects.
+    E: session fails; only one pooled process is used up. */
+AFL_TEST("server.router.Root:pool:session-failure", a)
+{
+    // Environment
+    FactoryMock factory;
+    server::common::NumericalIdGenerator gen;
+    server::router::Configuration config;
+    config.maxSessions = 5;
+    config.poolSize = 3;
+
+    // Testee
+    server::router::Root testee(factory, gen, config, 0);
+    testee.fillPool();
+    a.checkEqual("01. getPoolSize", testee.getPoolSize(), 3U);
+
+    // Start a bad session
+    String_t args[] = { "bad" };
+    AFL_CHECK_THROWS(a("11. createSession"), testee.createSession(args), std::exception);
+    a.checkEqual("12. sessions", testee.sessions().size(), 0U);
+    a.checkEqual("13. getPoolSize", testee.getPoolSize(), 2U);
+
+    // Good session can still use the pool
+    uint32_t counter = globalCounter;
+    server::router::Session& s = testee.createSession(afl::base::Nothing);
+    a.check("21. isActive", s.isActive());
+    a.checkEqual("22. processes", globalCounter, counter + 2);   // session uses pool; two processes to refill it
+}
+
+/** Test line breaks in parameters with process pool.
+    A: create a Root with a pool. Start a session with a parameter containing a line break.
+    E: session is not started from the pool (which would break the parameter framing), but normally. */
+AFL_TEST("server.router.Root:pool:line-break", a)
+{
+    // Environment
+    FactoryMock factory;
+    server::common::NumericalIdGenerator gen;
+    server::router::Configuration config;
+    config.maxSessions = 5;
+    config.poolSize = 1;
+
+    // Testee
+    server::router::Root testee(factory, gen, config, 0);
+    testee.fillPool();
+    a.checkEqual("01. getPoolSize", testee.getPoolSize(), 1U);
+
+    // Start session
+    uint32_t starts = numPoolStarts;
+    String_t args[] = { "-Wfoo", "x\nSAVE", "y\rz" };
+    server::router::Session& s = testee.createSession(args);
+    a.check("11. isActive", s.isActive());
+    a.checkEqual("12. numPoolStarts", numPoolStarts, starts);
+    a.checkEqual("13. command", lastCommandLine, "-Wfoo x\nSAVE y\rz");
+    a.checkEqual("14. getPoolSize", testee.getPoolSize(), 1U);
+}
@@ -37,6 +37,8 @@ AFL_TEST("server.talk.CommandHandler", a)
     // - Basic commands
     a.checkEqual("01. ping", testee.callString(Segment().pushBackString("PING")), "PONG");
     a.check("02. help", testee.callString(Segment().pushBackString("HELP")).size() > 20U);
+    a.checkEqual("03. sortcacheflush", testee.callString(Segment().pushBackString("SORTCACHEFLUSH")), "OK");
+    a.checkEqual("04. sortcacheflush", testee.callString(Segment().pushBackString("SORTCACHEFLUSH").pushBackInteger(1)), "OK");
 
     // - Syntax
     a.checkEqual("11. syntaxget", testee.callString(Segment().pushBackString("SYNTAXGET").pushBackString("KEYWORD")), "Info");
@@ -0,0 +1,107 @@
+/**
+  *  \file test/server/talk/notifiertest.cpp
+  *  \brief Test for server::talk::Notifier
+  */
+
+#include "server/talk/notifier.hpp"
+
+#include "afl/net/nullcommandhandler.hpp"
+#include "afl/net/redis/internaldatabase.hpp"
+#include "afl/test/commandhandler.hpp"
+#include "afl/test/testrunner.hpp"
+#include "server/talk/forum.hpp"
+#include "server/talk/message.hpp"
+#include "server/talk/root.hpp"
+#include "server/talk/session.hpp"
+#include "server/talk/talkpost.hpp"
+#include "server/talk/user.hpp"
+
+namespace {
+    const int32_t FORUM_ID = 42;
+
+    void prepareForum(server::talk::Root& root)
+    {
+        // Forum
+        root.allForums().add(FORUM_ID);
+        server::talk::Forum f(root, FORUM_ID);
+        f.name().set("Foorum");
+        f.writePermissions().set("all");
+        f.readPermissions().set("-u:c,all");
+
+        // Watchers: "a" gets notified, "b" is the author, "c" has no permission
+        static const char*const USERS[] = { "a", "b", "c" };
+        for (size_t i = 0; i < sizeof(USERS)/sizeof(USERS[0]); ++i) {
+            server::talk::User(root, USERS[i]).watchedForums().add(FORUM_ID);
+            f.watchers().add(USERS[i]);
+        }
+    }
+}
+
+/** Test normal operation: posting queues the notification, worker sends it. */
+AFL_TEST("server.talk.Notifier:post", a)
+{
+    afl::net::NullCommandHandler nullMail;
+    afl::net::redis::InternalDatabase db;
+    server::talk::Root root(db, nullMail, server::talk::Configuration());
+    prepareForum(root);
+
+    // Post two messages while no worker is running
+    server::talk::Notifier testee(root);
+    root.setNotifier(&testee);
+
+    server::talk::Session session;
+    session.setUser("b");
+    server::talk::TalkPost post(session, root);
+    int32_t m1 = post.create(FORUM_ID, "subj", "forum:text", server::talk::TalkPost::CreateOptions());
+    int32_t m2 = post.reply(m1, "re: subj", "forum:more", server::talk::TalkPost::ReplyOptions());
+    a.checkDifferent("01. create", m1, 0);
+    a.checkDifferent("02. reply", m2, 0);
+
+    // Start worker. First message produces a notification; second one is suppressed because "a" is already notified.
+    afl::test::CommandHandler mq(a);
+    mq.expectCall("MAIL, talk-forum");
+    mq.provideNewResult(0);
+    mq.expectCall("PARAM, forum, Foorum");
+    mq.provideNewResult(0);
+    mq.expectCall("PARAM, subject, subj");
+    mq.provideNewResult(0);
+    mq.expectCall("PARAM, posturl, talk/thread.cgi/1-subj#p1");
+    mq.provideNewResult(0);
+    mq.expectCall("SEND, user:a");
+    mq.provideNewResult(0);
+
+    testee.addWorker(mq);
+    testee.waitIdle();
+    mq.checkFinish();
+
+    root.setNotifier(0);
+}
+
+/** Test that deleted messages are skipped. */
+AFL_TEST("server.talk.Notifier:deleted", a)
+{
+    afl::net::NullCommandHandler nullMail;
+    afl::net::redis::InternalDatabase db;
+    server::talk::Root root(db, nullMail, server::talk::Configuration());
+    prepareForum(root);
+
+    server::talk::Notifier testee(root);
+    testee.notifyMessage(FORUM_ID, 77);
+
+    afl::test::CommandHandler mq(a);
+    testee.addWorker(mq);
+    testee.addWorker(mq);
+    testee.waitIdle();
+    mq.checkFinish();
+}
+
+/** Test waitIdle() on an empty queue. */
+AFL_TEST_NOARG("server.talk.Notifier:idle")
+{
+    afl::net::NullCommandHandler nullMail;
+    afl::net::redis::InternalDatabase db;
+    server::talk::Root root(db, nullMail, server::talk::Configuration());
+
+    server::talk::Notifier testee(root);
+    testee.waitIdle();
+}
@@ -0,0 +1,81 @@
+/**
+  *  \file test/server/talk/permissioncheckertest.cpp
+  *  \brief Test for server::talk::PermissionChecker
+  */
+
+#include "server/talk/permissionchecker.hpp"
+
+#include "afl/data/segment.hpp"
+#include "afl/net/nullcommandhandler.hpp"
+#include "afl/net/redis/internaldatabase.hpp"
+#include "afl/test/testrunner.hpp"
+#include "server/talk/root.hpp"
+
+using afl::data::Segment;
+
+/** Test check(). Same cases as Root::checkUserPermission(). */
+AFL_TEST("server.talk.PermissionChecker:check", a)
+{
+    afl::net::redis::InternalDatabase db;
+    db.callVoid(Segment().pushBackString("hset").pushBackString("default:profile").pushBackString("defProfile1").pushBackString("1"));
+    db.callVoid(Segment().pushBackString("hset").pushBackString("default:profile").pushBackString("defProfile0").pushBackString("0"));
+    db.callVoid(Segment().pushBackString("hset").pushBackString("default:profile").pushBackString("bothProfile1").pushBackString("0"));
+    db.callVoid(Segment().pushBackString("hset").pushBackString("user:1003:profile").pushBackString("userProfile1").pushBackString("1"));
+    db.callVoid(Segment().pushBackString("hset").pushBackString("user:1003:profile").pushBackString("bothProfile1").pushBackString("1"));
+    db.callVoid(Segment().pushBackString("hset").pushBackString("game:42:users").pushBackString("1003").pushBackString("0"));
+
+    afl::net::NullCommandHandler null;
+    server::talk::Root root(db, null, server::talk::Configuration());
+    server::talk::PermissionChecker testee(root);
+
+    a.check("01",  testee.check("all", "1003"));
+    a.check("02", !testee.check("-all", "1003"));
+    a.check("11",  testee.check("p:defProfile1", "1003"));
+    a.check("12", !testee.check("p:defProfile0", "1003"));
+    a.check("13",  testee.check("p:userProfile1", "1003"));
+    a.check("14",  testee.check("p:bothProfile1", "1003"));
+    a.check("15", !testee.check("p:bothProfile1", "1004"));
+    a.check("21",  testee.check("g:42", "1003"));
+    a.check("22", !testee.check("g:42", "1004"));
+    a.check("31",  testee.check("u:1003", "1003"));
+    a.check("32", !testee.check("u:1003", "1004"));
+
+    a.check("41", !testee.check("-all,all", "1003"));
+    a.check("42",  testee.check("u:1003,-all", "1003"));
+    a.check("43",  testee.check("-p:defProfile0,whatever,all", "1003"));
+    a.check("44", !testee.check("u:1003,-all", "1004"));
+
+    a.check("51", !testee.check("", "1003"));
+    a.check("52", !testee.check("-", "1003"));
+    a.check("53", !testee.check(",", "1003"));
+    a.check("54", !testee.check("p:,u:,g:", "1003"));
+}
+
+/** Test that lookups are cached. */
+AFL_TEST("server.talk.PermissionChecker:cache", a)
+{
+    afl::net::redis::InternalDatabase db;
+    db.callVoid(Segment().pushBackString("hset").pushBackString("user:1003:profile").pushBackString("talkwatchindividual").pushBackString("1"));
+    db.callVoid(Segment().pushBackString("hset").pushBackString("user:1003:profile").pushBackString("spam").pushBackString("1"));
+
+    afl::net::NullCommandHandler null;
+    server::talk::Root root(db, null, server::talk::Configuration());
+    server::talk::PermissionChecker testee(root);
+    a.check("01. check", testee.check("-p:spam,all", "1004"));
+    a.check("02. check", !testee.check("-p:spam,all", "1003"));
+    a.check("03. isWatchIndividual", testee.isWatchIndividual("1003"));
+    a.check("04. isWatchIndividual", !testee.isWatchIndividual("1004"));
+
+    // Change profile. Existing checker still reports the old values.
+    db.callVoid(Segment().pushBackString("hdel").pushBackString("user:1003:profile").pushBackString("talkwatchindividual"));
+    db.callVoid(Segment().pushBackString("hdel").pushBackString("user:1003:profile").pushBackString("spam"));
+    a.check("11. check", !testee.check("-p:spam,all", "1003"));
+    a.check("12. isWatchIndividual", testee.isWatchIndividual("1003"));
+    a.checkEqual("13. getProfileInteger", testee.getProfileInteger("1003", "spam"), 1);
+
+    // New checker reports new values
+    server::talk::PermissionChecker other(root);
+    a.check("21. check", other.check("-p:spam,all", "1003"));
+    a.check("22. isWatchIndividual", !other.isWatchIndividual("1003"));
+    a.checkEqual("23. getProfileInteger", other.getProfileInteger("1003", "spam"), 0);
+}
@@ -0,0 +1,271 @@
+/**
+  *  \file test/server/talk/sortcachetest.cpp
+  *  \brief Test for server::talk::SortCache
+  */
+
+#include "server/talk/sortcache.hpp"
+
+#include "afl/data/access.hpp"
+#include "afl/net/nullcommandhandler.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/integerfield.hpp"
+#include "afl/net/redis/integersetkey.hpp"
+#include "afl/net/redis/internaldatabase.hpp"
+#include "afl/net/redis/sortoperation.hpp"
+#include "afl/string/format.hpp"
+#include "afl/test/testrunner.hpp"
+#include "server/talk/configuration.hpp"
+#include "server/talk/root.hpp"
+#include "server/talk/session.hpp"
+#include "server/talk/sorter.hpp"
+#include "server/talk/talkforum.hpp"
+#include "server/talk/talkpost.hpp"
+#include "server/talk/talkthread.hpp"
+#include <memory>
+
+using afl::data::Access;
+using afl::net::redis::HashKey;
+using afl::net::redis::IntegerSetKey;
+using afl::net::redis::InternalDatabase;
+using server::talk::SortCache;
+
+namespace {
+    class TestSorter : public server::talk::Sorter {
+     public:
+        virtual void applySortKey(afl::net::redis::SortOperation& op, const String_t& keyName) const
+            {
+                if (keyName == "boom") {
+                    throw std::runtime_error("boom");
+                } else {
+                    op.by("item:*->" + keyName);
+                }
+            }
+    };
+
+    /* Create a set with items 1..n; field "v" sorts them in reverse order. */
+    void prepare(InternalDatabase& db, const String_t& name, int n)
+    {
+        IntegerSetKey key(db, name);
+        for (int i = 1; i <= n; ++i) {
+            key.add(i);
+            HashKey(db, afl::string::Format("item:%d", i)).intField("v").set(100 - i);
+        }
+    }
+}
+
+/** Test list operations.
+    A: create a set. Execute list operations.
+    E: correct results, consistent with TalkForum::executeListOperation() */
+AFL_TEST("server.talk.SortCache:list", a)
+{
+    InternalDatabase db;
+    prepare(db, "s", 5);
+    TestSorter sorter;
+    SortCache testee;
+    IntegerSetKey key(db, "s");
+
+    // Default order
+    {
+        SortCache::ListParameters p;
+        std::auto_ptr<afl::data::Value> result(testee.executeListOperation(1, p, key, sorter));
+        a.checkEqual("01. size",  Access(result).getArraySize(), 5U);
+        a.checkEqual("02. first", Access(result)[0].toInteger(), 1);
+        a.checkEqual("03. last",  Access(result)[4].toInteger(), 5);
+    }
+
+    // Sorted
+    {
+        SortCache::ListParameters p;
+        p.sortKey = String_t("v");
+        std::auto_ptr<afl::data::Value> result(testee.executeListOperation(1, p, key, sorter));
+        a.checkEqual("11. size",  Access(result).getArraySize(), 5U);
+        a.checkEqual("12. first", Access(result)[0].toInteger(), 5);
+        a.checkEqual("13. last",  Access(result)[4].toInteger(), 1);
+    }
+
+    // Range
+    {
+        SortCache::ListParameters p;
+        p.mode = p.WantRange;
+        p.start = 1;
+        p.count = 2;
+        p.sortKey = String_t("v");
+        std::auto_ptr<afl::data::Value> result(testee.executeListOperation(1, p, key, sorter));
+        a.checkEqual("21. size",  Access(result).getArraySize(), 2U);
+        a.checkEqual("22. first", Access(result)[0].toInteger(), 4);
+        a.checkEqual("23. last",  Access(result)[1].toInteger(), 3);
+    }
+
+    // Range exceeding end
+    {
+        SortCache::ListParameters p;
+        p.mode = p.WantRange;
+        p.start = 3;
+        p.count = 10;
+        std::auto_ptr<afl::data::Value> result(testee.executeListOperation(1, p, key, sorter));
+        a.checkEqual("31. size",  Access(result).getArraySize(), 2U);
+        a.checkEqual("32. first", Access(result)[0].toInteger(), 4);
+    }
+
+    // Range completely after end
+    {
+        SortCache::ListParameters p;
+        p.mode = p.WantRange;
+        p.start = 30;
+        p.count = 10;
+        std::auto_ptr<afl::data::Value> result(testee.executeListOperation(1, p, key, sorter));
+        a.checkEqual("41. size",  Access(result).getArraySize(), 0U);
+    }
+
+    // Size, member check
+    {
+        SortCache::ListParameters p;
+        p.mode = p.WantSize;
+        std::auto_ptr<afl::data::Value> result(testee.executeListOperation(1, p, key, sorter));
+        a.checkEqual("51. size",  Access(result).toInteger(), 5);
+    }
+    {
+        SortCache::ListParameters p;
+        p.mode = p.WantMemberCheck;
+        p.item = 3;
+        std::auto_ptr<afl::data::Value> result(testee.executeListOperation(1, p, key, sorter));
+        a.checkEqual("52. member", Access(result).toInteger(), 1);
+    }
+
+    // Two lists cached
+    a.checkEqual("61. getNumEntries", testee.getNumEntries(), 2U);
+
+    // Error
+    {
+        SortCache::ListParameters p;
+        p.sortKey = String_t("boom");
+        AFL_CHECK_THROWS(a("71. bad sort key"), testee.executeListOperation(1, p, key, sorter), std::runtime_error);
+        a.checkEqual("72. getNumEntries", testee.getNumEntries(), 2U);
+    }
+}
+
+/** Test invalidation.
+    A: list a set. Modify the database. List again, before and after invalidate().
+    E: cached result until invalidate(); only the given scope is invalidated */
+AFL_TEST("server.talk.SortCache:invalidate", a)
+{
+    InternalDatabase db;
+    prepare(db, "s", 3);
+    prepare(db, "t", 3);
+    TestSorter sorter;
+    SortCache testee;
+
+    SortCache::ListParameters p;
+    std::auto_ptr<afl::data::Value> result;
+    result.reset(testee.executeListOperation(1, p, IntegerSetKey(db, "s"), sorter));
+    result.reset(testee.executeListOperation(2, p, IntegerSetKey(db, "t"), sorter));
+    a.checkEqual("01. getNumEntries", testee.getNumEntries(), 2U);
+
+    // Modify; cached result does not change
+    IntegerSetKey(db, "s").add(7);
+    result.reset(testee.executeListOperation(1, p, IntegerSetKey(db, "s"), sorter));
+    a.checkEqual("11. size", Access(result).getArraySize(), 3U);
+
+    // Invalidate other scope; no change
+    testee.invalidate(2);
+    a.checkEqual("21. getNumEntries", testee.getNumEntries(), 1U);
+    result.reset(testee.executeListOperation(1, p, IntegerSetKey(db, "s"), sorter));
+    a.checkEqual("22. size", Access(result).getArraySize(), 3U);
+
+    // Invalidate correct scope
+    testee.invalidate(1);
+    a.checkEqual("31. getNumEntries", testee.getNumEntries(), 0U);
+    result.reset(testee.executeListOperation(1, p, IntegerSetKey(db, "s"), sorter));
+    a.checkEqual("32. size", Access(result).getArraySize(), 4U);
+
+    // Clear
+    testee.clear();
+    a.checkEqual("41. getNumEntries", testee.getNumEntries(), 0U);
+}
+
+/** Test size limit.
+    A: create cache with limit 2. List three sets.
+    E: least-recently used list is discarded */
+AFL_TEST("server.talk.SortCache:limit", a)
+{
+    InternalDatabase db;
+    prepare(db, "s", 3);
+    prepare(db, "t", 3);
+    prepare(db, "u", 3);
+    TestSorter sorter;
+    SortCache testee(2);
+
+    SortCache::ListParameters p;
+    std::auto_ptr<afl::data::Value> result;
+    result.reset(testee.executeListOperation(1, p, IntegerSetKey(db, "s"), sorter));
+    result.reset(testee.executeListOperation(1, p, IntegerSetKey(db, "t"), sorter));
+    result.reset(testee.executeListOperation(1, p, IntegerSetKey(db, "s"), sorter));
+    result.reset(testee.executeListOperation(1, p, IntegerSetKey(db, "u"), sorter));
+    a.checkEqual("01. getNumEntries", testee.getNumEntries(), 2U);
+
+    // Modify all sets. "t" has been discarded, so its change is visible; "s" is still cached.
+    IntegerSetKey(db, "s").add(7);
+    IntegerSetKey(db, "t").add(7);
+    result.reset(testee.executeListOperation(1, p, IntegerSetKey(db, "s"), sorter));
+    a.checkEqual("11. size", Access(result).getArraySize(), 3U);
+    result.reset(testee.executeListOperation(1, p, IntegerSetKey(db, "t"), sorter));
+    a.checkEqual("12. size", Access(result).getArraySize(), 4U);
+}
+
+/** Test integration with talk commands.
+    A: create forum and postings; list them sorted; add, edit, move postings.
+    E: listings reflect all changes */
+AFL_TEST("server.talk.SortCache:integration", a)
+{
+    using server::talk::TalkForum;
+    using server::talk::TalkPost;
+    using server::talk::TalkThread;
+
+    InternalDatabase db;
+    afl::net::NullCommandHandler mq;
+    server::talk::Root root(db, mq, server::talk::Configuration());
+    server::talk::Session session;
+    session.setUser("u");
+
+    // Forums
+    server::talk::Session rootSession;
+    const String_t config[] = { "name", "f", "readperm", "all", "writeperm", "all", "deleteperm", "all" };
+    a.checkEqual("01. add", TalkForum(rootSession, root).add(config), 1);
+    a.checkEqual("02. add", TalkForum(rootSession, root).add(config), 2);
+
+    // Postings
+    int32_t p1 = TalkPost(session, root).create(1, "b", "text:1", TalkPost::CreateOptions());
+    int32_t p2 = TalkPost(session, root).create(1, "c", "text:2", TalkPost::CreateOptions());
+
+    TalkForum::ListParameters params;
+    params.sortKey = String_t("SUBJECT");
+    std::auto_ptr<afl::data::Value> result;
+    result.reset(TalkForum(session, root).getPosts(1, params));
+    a.checkEqual("11. size",  Access(result).getArraySize(), 2U);
+    a.checkEqual("12. first", Access(result)[0].toInteger(), p1);
+
+    // New posting
+    int32_t p3 = TalkPost(session, root).create(1, "a", "text:3", TalkPost::CreateOptions());
+    result.reset(TalkForum(session, root).getPosts(1, params));
+    a.checkEqual("21. size",  Access(result).getArraySize(), 3U);
+    a.checkEqual("22. first", Access(result)[0].toInteger(), p3);
+
+    // Edit
+    TalkPost(session, root).edit(p2, "0", "text:2");
+    result.reset(TalkForum(session, root).getPosts(1, params));
+    a.checkEqual("31. first", Access(result)[0].toInteger(), p2);
+
+    // Move
+    TalkThread(rootSession, root).moveToForum(TalkPost(session, root).getInfo(p2).threadId, 2);
+    result.reset(TalkForum(session, root).getPosts(1, params));
+    a.checkEqual("41. size",  Access(result).getArraySize(), 2U);
+    a.checkEqual("42. first", Access(result)[0].toInteger(), p3);
+    result.reset(TalkForum(session, root).getPosts(2, params));
+    a.checkEqual("43. size",  Access(result).getArraySize(), 1U);
+
+    // Remove
+    TalkPost(rootSession, root).remove(p3);
+    result.reset(TalkForum(session, root).getPosts(1, params));
+    a.checkEqual("51. size",  Access(result).getArraySize(), 1U);
+    a.checkEqual("52. first", Access(result)[0].toInteger(), p1);
+}
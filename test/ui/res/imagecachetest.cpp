@@ -0,0 +1,111 @@
+/**
+  *  \file test/ui/res/imagecachetest.cpp
+  *  \brief Test for ui::res::ImageCache
+  */
+
+#include "ui/res/imagecache.hpp"
+
+#include "afl/test/testrunner.hpp"
+#include "gfx/palettizedpixmap.hpp"
+#include "gfx/rgbapixmap.hpp"
+
+using afl::base::Ptr;
+using gfx::Canvas;
+using ui::res::ImageCache;
+
+namespace {
+    Ptr<Canvas> makeImage(int w, int h)
+    {
+        return gfx::RGBAPixmap::create(w, h)->makeCanvas().asPtr();
+    }
+}
+
+/** Test basic operation.
+    A: add some images, look them up.
+    E: images found; negative entries reported as such */
+AFL_TEST("ui.res.ImageCache:basics", a)
+{
+    ImageCache testee;
+    Ptr<Canvas> img = makeImage(10, 10);
+    testee.put("a", img);
+    testee.put("b", 0);
+
+    Ptr<Canvas> result;
+    a.check("01. get a", testee.get("a", result));
+    a.checkEqual("02. result", result.get(), img.get());
+    a.check("03. get b", testee.get("b", result));
+    a.checkNull("04. result", result.get());
+    a.check("05. get c", !testee.get("c", result));
+
+    a.check("11. contains", testee.contains("a"));
+    a.check("12. contains", !testee.contains("c"));
+    a.checkEqual("13. getNumEntries", testee.getNumEntries(), 2U);
+    a.checkGreaterThan("14. getSize", testee.getSize(), 400U);
+
+    testee.clear();
+    a.checkEqual("21. getNumEntries", testee.getNumEntries(), 0U);
+    a.checkEqual("22. getSize", testee.getSize(), 0U);
+    a.check("23. contains", !testee.contains("a"));
+}
+
+/** Test size computation. */
+AFL_TEST("ui.res.ImageCache:getImageSize", a)
+{
+    a.checkEqual("01. null", ImageCache::getImageSize(0), 0U);
+    a.checkEqual("02. rgba", ImageCache::getImageSize(makeImage(10, 20).get()), 800U);
+    a.checkEqual("03. pal",  ImageCache::getImageSize(gfx::PalettizedPixmap::create(10, 20)->makeCanvas().asPtr().get()), 200U);
+}
+
+/** Test discarding.
+    A: set limit that fits about two images. Add three, with a lookup in between.
+    E: least-recently used image is discarded */
+AFL_TEST("ui.res.ImageCache:limit", a)
+{
+    // Each image is 40000 bytes
+    ImageCache testee(100000);
+    testee.put("a", makeImage(100, 100));
+    testee.put("b", makeImage(100, 100));
+
+    // Use a; now b is least-recently used
+    Ptr<Canvas> result;
+    a.check("01. get", testee.get("a", result));
+
+    // Add c; b is discarded
+    testee.put("c", makeImage(100, 100));
+    a.check("11. a", testee.contains("a"));
+    a.check("12. b", !testee.contains("b"));
+    a.check("13. c", testee.contains("c"));
+    a.checkLessEqual("14. getSize", testee.getSize(), 100000U);
+
+    // Reduce limit; only most-recent remains
+    testee.setLimit(50000);
+    a.checkEqual("21. getNumEntries", testee.getNumEntries(), 1U);
+    a.check("22. c", testee.contains("c"));
+
+    // Oversize image is kept until next insertion
+    testee.put("d", makeImage(200, 200));
+    a.checkEqual("31. getNumEntries", testee.getNumEntries(), 1U);
+    a.check("32. d", testee.contains("d"));
+    testee.put("e", 0);
+    a.check("33. d", !testee.contains("d"));
+    a.check("34. e", testee.contains("e"));
+}
+
+/** Test replacing an entry.
+    A: add entry twice with different images.
+    E: second image reported, size accounted only once */
+AFL_TEST("ui.res.ImageCache:replace", a)
+{
+    ImageCache testee;
+    testee.put("a", makeImage(100, 100));
+    size_t size = testee.getSize();
+
+    Ptr<Canvas> img = makeImage(100, 100);
+    testee.put("a", img);
+    a.checkEqual("01. getSize", testee.getSize(), size);
+    a.checkEqual("02. getNumEntries", testee.getNumEntries(), 1U);
+
+    Ptr<Canvas> result;
+    a.check("11. get", testee.get("a", result));
+    a.checkEqual("12. result", result.get(), img.get());
+}
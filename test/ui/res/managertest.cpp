@@ -5,8 +5,13 @@
 
 #include "ui/res/manager.hpp"
 
+#include "afl/base/runnable.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/sys/semaphore.hpp"
+#include "afl/sys/thread.hpp"
 #include "afl/test/testrunner.hpp"
 #include "gfx/rgbapixmap.hpp"
+#include "ui/res/imageloader.hpp"
 #include "ui/res/provider.hpp"
 
 namespace {
@@ -121,3 +126,110 @@ AFL_TEST("ui.res.Manager:removeProvidersByKey", a)
     can->getPixels(gfx::Point(0, 0), tmp);
     a.checkEqual("14. color a", tmp[0], COLORQUAD_FROM_RGB(4,4,4));
 }
+
+/** Test removal of providers while a load is in progress.
+    A: add a provider that removes itself from the manager during loadImage().
+    E: load completes normally; provider is gone afterwards */
+AFL_TEST("ui.res.Manager:remove-during-load", a)
+{
+    class SelfRemovingProvider : public ui::res::Provider {
+     public:
+        SelfRemovingProvider(bool& alive)
+            : m_alive(alive)
+            { m_alive = true; }
+        ~SelfRemovingProvider()
+            { m_alive = false; }
+        virtual afl::base::Ptr<gfx::Canvas> loadImage(String_t /*name*/, ui::res::Manager& mgr)
+            {
+                mgr.removeProvidersByKey("x");
+                return gfx::RGBAPixmap::create(1, 1)->makeCanvas().asPtr();
+            }
+        virtual bool isThreadSafe() const
+            { return true; }
+     private:
+        bool& m_alive;
+    };
+
+    bool alive = false;
+    ui::res::Manager t;
+    t.addNewProvider(new SelfRemovingProvider(alive), "x");
+    a.check("01. alive", alive);
+
+    afl::base::Ptr<gfx::Canvas> can = t.loadImage("a");
+    a.checkNonNull("11. loadImage", can.get());
+    a.check("12. alive", !alive);
+
+    can = t.loadImage("a");
+    a.checkNull("21. loadImage", can.get());
+}
+
+/** Test decoding with a provider that is not thread-safe.
+    A: add a non-thread-safe provider and an image loader that blocks until released. Load images from two threads.
+    E: both decodes are in progress at the same time; both loads succeed */
+AFL_TEST("ui.res.Manager:loadImage:concurrent-decode", a)
+{
+    class BlockingImageLoader : public ui::res::ImageLoader {
+     public:
+        BlockingImageLoader(afl::sys::Semaphore& entered, afl::sys::Semaphore& release)
+            : m_entered(entered), m_release(release)
+            { }
+        virtual afl::base::Ptr<gfx::Canvas> loadImage(afl::io::Stream& in)
+            {
+                uint8_t tmp[10];
+                if (in.read(tmp) != 3) {
+                    return 0;
+                }
+                m_entered.post();
+                m_release.wait();
+                return gfx::RGBAPixmap::create(1, 1)->makeCanvas().asPtr();
+            }
+     private:
+        afl::sys::Semaphore& m_entered;
+        afl::sys::Semaphore& m_release;
+    };
+    class FileProvider : public ui::res::Provider {
+     public:
+        virtual afl::base::Ptr<gfx::Canvas> loadImage(String_t /*name*/, ui::res::Manager& mgr)
+            {
+                afl::io::ConstMemoryStream s(afl::string::toBytes("img"));
+                return mgr.loadImage(s, *this);
+            }
+    };
+    class Loader : public afl::base::Runnable {
+     public:
+        Loader(ui::res::Manager& mgr)
+            : m_manager(mgr), m_result()
+            { }
+        virtual void run()
+            { m_result = m_manager.loadImage("a"); }
+        bool hasResult() const
+            { return m_result.get() != 0; }
+     private:
+        ui::res::Manager& m_manager;
+        afl::base::Ptr<gfx::Canvas> m_result;
+    };
+
+    afl::sys::Semaphore entered(0), release(0);
+    ui::res::Manager t;
+    t.addNewImageLoader(new BlockingImageLoader(entered, release));
+    t.addNewProvider(new FileProvider(), "a");
+
+    Loader r1(t), r2(t);
+    afl::sys::Thread t1("TestUiResManager1", r1);
+    afl::sys::Thread t2("TestUiResManager2", r2);
+    t1.start();
+    t2.start();
+
+    // Both threads must reach the decoder; if the provider's lock were held while decoding, the second one could not.
+    bool ok1 = entered.wait(10000);
+    bool ok2 = entered.wait(10000);
+    release.post();
+    release.post();
+    t1.join();
+    t2.join();
+
+    a.check("01. first decode", ok1);
+    a.check("02. second decode", ok2);
+    a.check("03. result 1", r1.hasResult());
+    a.check("04. result 2", r2.hasResult());
+}
@@ -26,6 +26,7 @@ AFL_TEST("ui.res.Provider:basics", a)
 
     // Methods
     a.check("01", !ui::res::Provider::graphicsSuffixes().empty());
+    a.check("02", !t.isThreadSafe());
 }
 
 /** Interface test. */
@@ -0,0 +1,93 @@
+/**
+  *  \file test/util/directorysnapshottest.cpp
+  *  \brief Test for util::DirectorySnapshot
+  */
+
+#include "util/directorysnapshot.hpp"
+
+#include "afl/except/fileformatexception.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/filesystem.hpp"
+#include "afl/io/internaldirectory.hpp"
+#include "afl/io/internalstream.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/test/testrunner.hpp"
+
+using afl::base::Ref;
+using afl::io::ConstMemoryStream;
+using afl::io::Directory;
+using afl::io::FileSystem;
+using afl::io::InternalDirectory;
+using afl::io::InternalStream;
+using afl::string::NullTranslator;
+
+/** Test save and load.
+    A: create a directory with some files; save it; load the result.
+    E: loaded directory has same files with same content */
+AFL_TEST("util.DirectorySnapshot:basics", a)
+{
+    Ref<InternalDirectory> in = InternalDirectory::create("in");
+    in->addStream("beamspec.dat", *new ConstMemoryStream(afl::string::toBytes("beams")));
+    in->addStream("race.nm", *new ConstMemoryStream(afl::string::toBytes("races!")));
+    in->addStream("empty.txt", *new ConstMemoryStream(afl::base::ConstBytes_t()));
+
+    InternalStream snap;
+    AFL_CHECK_SUCCEEDS(a("01. save"), util::DirectorySnapshot::save(*in, snap));
+
+    NullTranslator tx;
+    ConstMemoryStream ms(snap.getContent());
+    Ref<Directory> out = util::DirectorySnapshot::load(ms.createVirtualMapping(), "snap", tx);
+
+    Ref<afl::io::Stream> s1 = out->openFile("beamspec.dat", FileSystem::OpenRead);
+    a.checkEqual("11. content", afl::string::fromBytes(s1->createVirtualMapping()->get()), "beams");
+    Ref<afl::io::Stream> s2 = out->openFile("race.nm", FileSystem::OpenRead);
+    a.checkEqual("12. content", afl::string::fromBytes(s2->createVirtualMapping()->get()), "races!");
+    Ref<afl::io::Stream> s3 = out->openFile("empty.txt", FileSystem::OpenRead);
+    a.checkEqual("13. size", s3->getSize(), 0U);
+
+    a.checkNull("21. missing", out->openFileNT("hullspec.dat", FileSystem::OpenRead).get());
+}
+
+/** Test error handling.
+    A: load invalid snapshots.
+    E: FileFormatException */
+AFL_TEST("util.DirectorySnapshot:error", a)
+{
+    NullTranslator tx;
+
+    // Too short
+    {
+        ConstMemoryStream ms(afl::string::toBytes("CCsnap"));
+        AFL_CHECK_THROWS(a("01. short"), util::DirectorySnapshot::load(ms.createVirtualMapping(), "snap", tx), afl::except::FileFormatException);
+    }
+
+    // Bad signature
+    {
+        static const uint8_t DATA[] = { 'C','C','s','n','a','q',0x1A,0x01, 0,0,0,0 };
+        ConstMemoryStream ms(DATA);
+        AFL_CHECK_THROWS(a("11. signature"), util::DirectorySnapshot::load(ms.createVirtualMapping(), "snap", tx), afl::except::FileFormatException);
+    }
+
+    // Entry count too large
+    {
+        static const uint8_t DATA[] = { 'C','C','s','n','a','p',0x1A,0x01, 1,0,0,0 };
+        ConstMemoryStream ms(DATA);
+        AFL_CHECK_THROWS(a("21. count"), util::DirectorySnapshot::load(ms.createVirtualMapping(), "snap", tx), afl::except::FileFormatException);
+    }
+
+    // Entry out of range
+    {
+        static const uint8_t DATA[] = { 'C','C','s','n','a','p',0x1A,0x01, 1,0,0,0,
+                                        28,0,0,0, 1,0,0,0, 29,0,0,0, 100,0,0,0,
+                                        'x' };
+        ConstMemoryStream ms(DATA);
+        AFL_CHECK_THROWS(a("31. range"), util::DirectorySnapshot::load(ms.createVirtualMapping(), "snap", tx), afl::except::FileFormatException);
+    }
+
+    // Empty snapshot is valid
+    {
+        static const uint8_t DATA[] = { 'C','C','s','n','a','p',0x1A,0x01, 0,0,0,0 };
+        ConstMemoryStream ms(DATA);
+        AFL_CHECK_SUCCEEDS(a("41. empty"), util::DirectorySnapshot::load(ms.createVirtualMapping(), "snap", tx));
+    }
+}
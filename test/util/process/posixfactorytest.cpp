@@ -109,6 +109,99 @@ AFL_TEST("util.process.PosixFactory:basics", a)
 #endif
 }
 
+/** Test reading multiple lines produced at once.
+    Lines must be returned one at a time, with partial lines and carriage returns handled. */
+AFL_TEST("util.process.PosixFactory:multi-line", a)
+{
+#if TARGET_OS_POSIX
+    util::process::PosixFactory testee;
+    std::auto_ptr<util::process::Subprocess> p(testee.createNewProcess());
+    a.check("01. get", p.get());
+
+    const String_t args[] = {
+        "-c",
+        "printf 'one\\ntwo\\r\\nthree\\n'; read a; printf 'four\\nfive'"
+    };
+    a.check("11. start", p->start("/bin/sh", args));
+
+    String_t result;
+    a.check("21. readLine", p->readLine(result));
+    a.checkEqual("22. result", result, "one\n");
+    a.check("23. readLine", p->readLine(result));
+    a.checkEqual("24. result", result, "two\n");
+    a.check("25. readLine", p->readLine(result));
+    a.checkEqual("26. result", result, "three\n");
+
+    a.check("31. writeLine", p->writeLine("go\n"));
+    a.check("32. readLine", p->readLine(result));
+    a.checkEqual("33. result", result, "four\n");
+    a.check("34. readLine", !p->readLine(result));
+
+    a.check("41. stop", p->stop());
+#endif
+}
+
+/** Test reading a line that spans multiple reads.
+    The line is longer than the read buffer and must be returned in one piece. */
+AFL_TEST("util.process.PosixFactory:long-line", a)
+{
+#if TARGET_OS_POSIX
+    util::process::PosixFactory testee;
+    std::auto_ptr<util::process::Subprocess> p(testee.createNewProcess());
+    a.check("01. get", p.get());
+
+    const String_t args[] = {
+        "-c",
+        "i=0; while [ $i -lt 1000 ]; do printf 'abcdefghij'; i=$((i+1)); done; printf '\\r\\nend\\n'"
+    };
+    a.check("11. start", p->start("/bin/sh", args));
+
+    String_t result;
+    a.check("21. readLine", p->readLine(result));
+    a.checkEqual("22. size", result.size(), 10001U);
+    a.checkEqual("23. start", result.substr(0, 20), "abcdefghijabcdefghij");
+    a.checkEqual("24. end", result.substr(9990), "abcdefghij\n");
+    a.check("25. readLine", p->readLine(result));
+    a.checkEqual("26. result", result, "end\n");
+    a.check("27. readLine", !p->readLine(result));
+
+    a.check("31. stop", p->stop());
+#endif
+}
+
+/** Test restarting a process.
+    Data that was read ahead from the previous process must not be returned for the new one. */
+AFL_TEST("util.process.PosixFactory:restart", a)
+{
+#if TARGET_OS_POSIX
+    util::process::PosixFactory testee;
+    std::auto_ptr<util::process::Subprocess> p(testee.createNewProcess());
+    a.check("01. get", p.get());
+
+    const String_t args1[] = {
+        "-c",
+        "printf 'one\\ntwo\\n'; read a"
+    };
+    a.check("11. start", p->start("/bin/sh", args1));
+
+    String_t result;
+    a.check("12. readLine", p->readLine(result));
+    a.checkEqual("13. result", result, "one\n");
+    a.check("14. stop", p->stop());
+    a.check("15. readLine", !p->readLine(result));
+
+    const String_t args2[] = {
+        "-c",
+        "printf 'three\\n'"
+    };
+    a.check("21. start", p->start("/bin/sh", args2));
+    a.check("22. readLine", p->readLine(result));
+    a.checkEqual("23. result", result, "three\n");
+    a.check("24. readLine", !p->readLine(result));
+    a.check("25. stop", p->stop());
+#endif
+}
+
 /** Test pipe stress. */
 AFL_TEST("util.process.PosixFactory:error:pipe-stress-1", a)
 {
@@ -5,6 +5,7 @@
 
 #include "util/requestthread.hpp"
 
+#include "afl/container/ptrvector.hpp"
 #include "afl/string/nulltranslator.hpp"
 #include "afl/sys/log.hpp"
 #include "afl/sys/semaphore.hpp"
@@ -41,3 +42,119 @@ AFL_TEST("util.RequestThread", a)
         }
     }
 }
+
+namespace {
+    /* Runnable that appends a character to a string.
+       Strings are only modified in the worker thread, and only read after synchronisation. */
+    class Appender : public afl::base::Runnable {
+     public:
+        Appender(String_t& out, char ch, afl::sys::Semaphore* sem = 0)
+            : m_out(out), m_char(ch), m_semaphore(sem)
+            { }
+        virtual void run()
+            {
+                m_out += m_char;
+                if (m_semaphore != 0) {
+                    m_semaphore->post();
+                }
+            }
+     private:
+        String_t& m_out;
+        char m_char;
+        afl::sys::Semaphore* m_semaphore;
+    };
+
+    /* Runnable that blocks the worker thread until released. */
+    class Blocker : public afl::base::Runnable {
+     public:
+        Blocker(afl::sys::Semaphore& started, afl::sys::Semaphore& release)
+            : m_started(started), m_release(release)
+            { }
+        virtual void run()
+            {
+                m_started.post();
+                m_release.wait();
+            }
+     private:
+        afl::sys::Semaphore& m_started;
+        afl::sys::Semaphore& m_release;
+    };
+}
+
+/** Test postNewRunnables().
+    A: post a list of runnables.
+    E: all executed in order; list is emptied */
+AFL_TEST("util.RequestThread:postNewRunnables", a)
+{
+    afl::sys::Log log;
+    afl::string::NullTranslator tx;
+    util::RequestThread testee(a.getLocation(), log, tx);
+
+    String_t result;
+    afl::sys::Semaphore sem(0);
+    afl::container::PtrVector<afl::base::Runnable> list;
+    list.pushBackNew(new Appender(result, 'a'));
+    list.pushBackNew(new Appender(result, 'b'));
+    list.pushBackNew(new Appender(result, 'c', &sem));
+    testee.postNewRunnables(list);
+    a.checkEqual("01. list", list.size(), 0U);
+
+    sem.wait();
+    a.checkEqual("11. result", result, "abc");
+}
+
+/** Test postNewReplaceableRunnable().
+    A: block worker. Post a sequence of replaceable and normal runnables.
+    E: directly-consecutive runnables with same key are collapsed to the latest one; order is otherwise unchanged */
+AFL_TEST("util.RequestThread:postNewReplaceableRunnable", a)
+{
+    afl::sys::Log log;
+    afl::string::NullTranslator tx;
+    util::RequestThread testee(a.getLocation(), log, tx);
+
+    String_t result;
+    afl::sys::Semaphore started(0), release(0), done(0);
+    int k1, k2;
+
+    testee.postNewRunnable(new Blocker(started, release));
+    started.wait();
+
+    testee.postNewReplaceableRunnable(new Appender(result, 'a'), &k1);
+    testee.postNewReplaceableRunnable(new Appender(result, 'b'), &k1);   // replaces a
+    testee.postNewReplaceableRunnable(new Appender(result, 'c'), &k2);
+    testee.postNewReplaceableRunnable(new Appender(result, 'd'), &k2);   // replaces c
+    testee.postNewRunnable(new Appender(result, 'e'));
+    testee.postNewReplaceableRunnable(new Appender(result, 'f'), &k2);   // does not replace e
+    testee.postNewReplaceableRunnable(new Appender(result, 'g'), 0);
+    testee.postNewReplaceableRunnable(new Appender(result, 'h', &done), 0);
+
+    release.post();
+    done.wait();
+    a.checkEqual("01. result", result, "bdefgh");
+}
+
+/** Test wait time measurement.
+    A: post a request that blocks the thread, and another request behind it.
+    E: getMaxWaitTime() reports the time the second request waited */
+AFL_TEST("util.RequestThread:getMaxWaitTime", a)
+{
+    afl::sys::Log log;
+    afl::string::NullTranslator tx;
+    util::RequestThread testee(a.getLocation(), log, tx);
+    a.checkEqual("01. getMaxWaitTime", testee.getMaxWaitTime(), 0U);
+
+    class Blocker : public afl::base::Runnable {
+     public:
+        virtual void run()
+            { afl::sys::Thread::sleep(100); }
+    };
+
+    String_t out;
+    afl::sys::Semaphore sem(0);
+    testee.postNewRunnable(new Blocker());
+    testee.postNewRunnable(new Appender(out, 'a', &sem));
+    sem.wait();
+
+    a.checkEqual("11. out", out, "a");
+    a.check("12. getMaxWaitTime", testee.getMaxWaitTime() >= 50);
+}
@@ -13,6 +13,7 @@ build_test_app('processrunner', ['gamelib', 'afl']);
 build_test_app('testvcr',       ['gamelib', 'afl']);
 build_test_app('testflak',      ['gamelib', 'afl']);
 build_test_app('msgparse',      ['gamelib', 'afl']);
+build_test_app('scriptbench',   ['gamelib', 'afl']);
 build_test_app('ui_root',       ['guilib', 'gamelib', 'afl']);
 build_test_app('threed',        ['guilib', 'gamelib', 'afl']);
 build_test_app('threedmodel',   ['guilib', 'gamelib', 'afl']);
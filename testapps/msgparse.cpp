@@ -12,6 +12,7 @@
 #include "game/parser/datainterface.hpp"
 #include "game/parser/messageinformation.hpp"
 #include "afl/string/parse.hpp"
+#include "afl/sys/time.hpp"
 
 namespace {
     class Logger : public afl::sys::LogListener {
@@ -83,6 +84,11 @@ namespace {
     int turnNumber = 1;
     int playerNumber = 1;
 
+    // Benchmark mode: number of repetitions (0=normal mode), number of messages parsed, total time
+    int benchmarkRepeat = 0;
+    int benchmarkMessages = 0;
+    uint32_t benchmarkTime = 0;
+
     bool strStartsWith(const String_t& big, const char* small)
     {
         // FIXME: should be in library
@@ -131,6 +137,16 @@ namespace {
 
         DataInterface iface(playerNumber);
         afl::container::PtrVector<game::parser::MessageInformation> result;
+        if (benchmarkRepeat > 0) {
+            uint32_t start = afl::sys::Time::getTickCounter();
+            for (int i = 0; i < benchmarkRepeat; ++i) {
+                result.clear();
+                parser.parseMessage(message, iface, turnNumber, result, tx, logger);
+            }
+            benchmarkTime += afl::sys::Time::getTickCounter() - start;
+            benchmarkMessages += benchmarkRepeat;
+            return;
+        }
         parser.parseMessage(message, iface, turnNumber, result, tx, logger);
 
         std::cout << "--- Parsed Message:\n"
@@ -187,6 +203,11 @@ int main(int, char** argv)
             if (std::strcmp(p, "-help") == 0) {
             } else if (std::strncmp(p, "-load=", 6) == 0) {
                 loadTemplates(p+6);
+            } else if (std::strncmp(p, "-bench=", 7) == 0) {
+                if (!afl::string::strToInteger(p+7, benchmarkRepeat) || benchmarkRepeat <= 0) {
+                    std::cerr << "Invalid repeat count: " << p << std::endl;
+                    return 1;
+                }
             } else if (*p == '-') {
                 std::cerr << "Unknown option: " << p << std::endl;
                 return 1;
@@ -194,6 +215,9 @@ int main(int, char** argv)
                 parseMessages(p);
             }
         }
+        if (benchmarkRepeat > 0) {
+            std::cout << benchmarkMessages << " messages parsed in " << benchmarkTime << " ms\n";
+        }
     }
     catch (std::exception& e) {
         logger.write(afl::sys::LogListener::Error, LOG_NAME, "Exception", e);
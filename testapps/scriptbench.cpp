@@ -0,0 +1,219 @@
+/**
+  *  \file testapps/scriptbench.cpp
+  *  \brief Interpreter micro-benchmark
+  *
+  *  Runs small loops and reports time and heap allocations per iteration.
+  *  Each loop is run twice: with the optimizer's fused instructions, and with them undone (unfuseInstructions()),
+  *  to show what instruction fusion gains.
+  *  Integer arithmetic is computed in place on the value stack and should not allocate;
+  *  float arithmetic is included for comparison.
+  *
+  *  With file name arguments, instead compiles those files (e.g. share/resource/core.q)
+  *  and reports the most frequent pairs of adjacent instructions, and the fused instructions produced.
+  *  This is the data fusion candidates are picked from.
+  */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <vector>
+#include "afl/io/filesystem.hpp"
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/sys/log.hpp"
+#include "afl/sys/time.hpp"
+#include "interpreter/bytecodeobject.hpp"
+#include "interpreter/defaultstatementcompilationcontext.hpp"
+#include "interpreter/error.hpp"
+#include "interpreter/fusion.hpp"
+#include "interpreter/memorycommandsource.hpp"
+#include "interpreter/process.hpp"
+#include "interpreter/statementcompiler.hpp"
+#include "interpreter/subroutinevalue.hpp"
+#include "interpreter/world.hpp"
+
+namespace {
+    unsigned long g_numAllocations;
+
+    const int NUM_ITERATIONS = 3000000;
+
+    /* Optimisation level, same as the default of c2console and the client */
+    const int OPTIMISATION_LEVEL = 1;
+
+    /*
+     *  Benchmark
+     */
+
+    interpreter::BCORef_t compileBenchmark(interpreter::World& world, const char* code, bool fused)
+    {
+        // Compile like a script file, including optimisation
+        interpreter::MemoryCommandSource mcs;
+        mcs.addLines(afl::string::toMemory(code));
+        interpreter::DefaultStatementCompilationContext scc(world);
+        scc.withFlag(scc.LocalContext)
+            .withFlag(scc.ExpressionsAreStatements)
+            .withFlag(scc.LinearExecution);
+        interpreter::BCORef_t bco = interpreter::BytecodeObject::create(true);
+        interpreter::StatementCompiler sc(mcs);
+        sc.setOptimisationLevel(OPTIMISATION_LEVEL);
+        sc.compileList(*bco, scc);
+        sc.finishBCO(*bco, scc);
+        if (!fused) {
+            interpreter::unfuseInstructions(*bco);
+        }
+        return bco;
+    }
+
+    void runBenchmark(const char* name, const char* code)
+    {
+        afl::sys::Log log;
+        afl::string::NullTranslator tx;
+        afl::io::NullFileSystem fs;
+        interpreter::World world(log, tx, fs);
+
+        uint32_t times[2];
+        unsigned long allocs[2];
+        for (int fused = 0; fused < 2; ++fused) {
+            interpreter::Process proc(world, name, 1);
+            proc.pushFrame(compileBenchmark(world, code, fused != 0), false);
+            allocs[fused] = g_numAllocations;
+            times[fused] = afl::sys::Time::getTickCounter();
+            proc.run();
+            times[fused] = afl::sys::Time::getTickCounter() - times[fused];
+            allocs[fused] = g_numAllocations - allocs[fused];
+
+            if (proc.getState() != interpreter::Process::Ended) {
+                std::printf("%-8s failed: %s\n", name, proc.getError().what());
+                return;
+            }
+        }
+        std::printf("%-8s %6u ms plain, %6u ms fused, %6.2f allocations per iteration\n",
+                    name, unsigned(times[0]), unsigned(times[1]), double(allocs[1]) / NUM_ITERATIONS);
+    }
+
+    /*
+     *  Instruction statistics
+     */
+
+    typedef std::map<String_t, long> Counts_t;
+
+    /* Get mnemonic of an instruction, as it was generated before fusion */
+    String_t getMnemonic(const interpreter::Opcode& op)
+    {
+        interpreter::Opcode external = op;
+        external.major = op.getExternalMajor();
+        String_t tpl = external.getDisassemblyTemplate();
+        return tpl.substr(0, tpl.find('\t'));
+    }
+
+    /* Get name of fused instruction; empty if not fused */
+    String_t getFusionName(const interpreter::Opcode& op)
+    {
+        switch (op.major) {
+         case interpreter::Opcode::maFusedUnary:       return "fusedunary";
+         case interpreter::Opcode::maFusedBinary:      return "fusedbinary";
+         case interpreter::Opcode::maFusedComparison:  return "fusedcomparison";
+         case interpreter::Opcode::maFusedComparison2: return "fusedcomparison2";
+         case interpreter::Opcode::maInplaceUnary:     return "inplaceunary";
+         case interpreter::Opcode::maFusedMove:        return "fusedmove";
+         case interpreter::Opcode::maFusedCondJump:    return "fusedcondjump";
+        }
+        return String_t();
+    }
+
+    /* Count instruction pairs of a BCO and all subroutines it defines */
+    void countPairs(const interpreter::BytecodeObject& bco, Counts_t& pairs, Counts_t& fusions, long& numInstructions)
+    {
+        for (interpreter::BytecodeObject::PC_t i = 0, n = bco.getNumInstructions(); i < n; ++i) {
+            ++numInstructions;
+            if (i+1 < n) {
+                ++pairs[getMnemonic(bco(i)) + " + " + getMnemonic(bco(i+1))];
+            }
+            String_t fusion = getFusionName(bco(i));
+            if (!fusion.empty()) {
+                ++fusions[fusion];
+            }
+        }
+
+        const afl::data::Segment& lits = bco.literals();
+        for (size_t i = 0, n = lits.size(); i < n; ++i) {
+            if (const interpreter::SubroutineValue* sv = dynamic_cast<const interpreter::SubroutineValue*>(lits[i])) {
+                countPairs(*sv->getBytecodeObject(), pairs, fusions, numInstructions);
+            }
+        }
+    }
+
+    bool compareCounts(const std::pair<String_t, long>& a, const std::pair<String_t, long>& b)
+    {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    }
+
+    void printCounts(const char* title, const Counts_t& counts, size_t limit, long numInstructions)
+    {
+        std::vector<std::pair<String_t, long> > sorted(counts.begin(), counts.end());
+        std::sort(sorted.begin(), sorted.end(), compareCounts);
+        std::printf("%s:\n", title);
+        for (size_t i = 0; i < sorted.size() && i < limit; ++i) {
+            std::printf("%7ld %5.1f%%  %s\n", sorted[i].second, 100.0 * double(sorted[i].second) / double(numInstructions), sorted[i].first.c_str());
+        }
+    }
+
+    int reportInstructionStatistics(char** fileNames)
+    {
+        afl::sys::Log log;
+        afl::string::NullTranslator tx;
+        afl::io::FileSystem& fs = afl::io::FileSystem::getInstance();
+        interpreter::World world(log, tx, fs);
+
+        Counts_t pairs, fusions;
+        long numInstructions = 0;
+        try {
+            while (const char* p = *fileNames++) {
+                afl::base::Ref<afl::io::Stream> file = fs.openFile(p, afl::io::FileSystem::OpenRead);
+                countPairs(*world.compileFile(*file, p, OPTIMISATION_LEVEL), pairs, fusions, numInstructions);
+            }
+        }
+        catch (std::exception& e) {
+            std::printf("failed: %s\n", e.what());
+            return 1;
+        }
+
+        std::printf("%ld instructions\n", numInstructions);
+        printCounts("Most frequent instruction pairs (static, before fusion)", pairs, 30, numInstructions);
+        printCounts("Fused instructions", fusions, 100, numInstructions);
+        return 0;
+    }
+}
+
+void* operator new(std::size_t n)
+{
+    ++g_numAllocations;
+    if (void* p = std::malloc(n != 0 ? n : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) throw()
+{
+    std::free(p);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1) {
+        return reportInstructionStatistics(argv + 1);
+    }
+
+    // ex "for i:=1 to 3000000 do j:=i+1" benchmark quoted in interpreter/binaryexecution.cpp
+    runBenchmark("int",    "Dim i, j\nFor i:=1 To 3000000 Do j:=i+1\n");
+    runBenchmark("intexp", "Dim i, j\nFor i:=1 To 3000000 Do j:=(i*3+7) Mod 1000 - i\n");
+    runBenchmark("float",  "Dim i, j\nFor i:=1 To 3000000 Do j:=i+1.5\n");
+
+    // push + poploc (fusedmove), push + jXXp (fusedcondjump)
+    runBenchmark("move",   "Dim i, j, k\nFor i:=1 To 3000000\n  j:=i\n  k:=j\nNext\n");
+    runBenchmark("cond",   "Dim i, j, f\nf:=True\nFor i:=1 To 3000000 Do If f Then j:=i\n");
+    return 0;
+}
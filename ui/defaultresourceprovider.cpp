@@ -12,12 +12,37 @@
 #include "ui/res/ccimageloader.hpp"
 #include "ui/res/resid.hpp"
 #include "gfx/defaultfont.hpp"
+#include "util/systeminformation.hpp"
 
 namespace {
     const char LOG_NAME[] = "ui.resload";
     const char THREAD_NAME[] = "ui.resload";
+
+    /* Maximum number of loader threads.
+       Loading is partially I/O bound, and many providers serialize their requests,
+       so there is little point in having many threads. */
+    const size_t MAX_THREADS = 4;
 }
 
+/* Signal image change in UI thread.
+   Multiple image loads are collapsed into a single sig_imageChange callback. */
+class ui::DefaultResourceProvider::Signaler : public afl::base::Runnable {
+ public:
+    Signaler(DefaultResourceProvider& parent)
+        : m_parent(parent)
+        { }
+    void run()
+        {
+            {
+                afl::sys::MutexGuard g(m_parent.m_imageMutex);
+                m_parent.m_signalPending = false;
+            }
+            m_parent.sig_imageChange.raise();
+        }
+ private:
+    DefaultResourceProvider& m_parent;
+};
+
 // Constructor.
 // FIXME: get rid of the "dir" parameter
 ui::DefaultResourceProvider::DefaultResourceProvider(ui::res::Manager& mgr,
@@ -31,12 +56,17 @@ ui::DefaultResourceProvider::DefaultResourceProvider(ui::res::Manager& mgr,
       m_mainThreadDispatcher(mainThreadDispatcher),
       m_log(log),
       m_translator(tx),
-      m_loaderThread(THREAD_NAME, *this),
+      m_loaderThreads(),
       m_imageMutex(),
       m_imageCache(),
+      m_cacheGeneration(0),
       m_imageQueue(),
+      m_prefetchQueue(),
+      m_activeImages(),
       m_managerRequests(),
       m_managerInvalidate(false),
+      m_managerActive(false),
+      m_signalPending(false),
       m_loaderWake(0),
       m_loaderStopRequest(false)
 {
@@ -47,7 +77,9 @@ ui::DefaultResourceProvider::DefaultResourceProvider(ui::res::Manager& mgr,
 ui::DefaultResourceProvider::~DefaultResourceProvider()
 {
     stop();
-    m_loaderThread.join();
+    for (size_t i = 0, n = m_loaderThreads.size(); i < n; ++i) {
+        m_loaderThreads[i]->join();
+    }
 }
 
 void
@@ -63,22 +95,36 @@ ui::DefaultResourceProvider::postNewManagerRequest(util::Request<ui::res::Manage
     m_loaderWake.post();
 }
 
+// Set image cache size limit.
+void
+ui::DefaultResourceProvider::setCacheLimit(size_t limit)
+{
+    afl::sys::MutexGuard g(m_imageMutex);
+    m_imageCache.setLimit(limit);
+}
+
 // Get image.
 afl::base::Ptr<gfx::Canvas>
 ui::DefaultResourceProvider::getImage(String_t name, bool* status)
 {
     // Check for existing image
     afl::sys::MutexGuard g(m_imageMutex);
-    std::map<String_t, afl::base::Ptr<gfx::Canvas> >::iterator it = m_imageCache.find(name);
-    if (it != m_imageCache.end()) {
+    afl::base::Ptr<gfx::Canvas> result;
+    if (m_imageCache.get(name, result)) {
         if (status != 0) {
             *status = true;
         }
-        return it->second;
+        return result;
     }
 
     // Not found; enqueue it
-    if (std::find(m_imageQueue.begin(), m_imageQueue.end(), name) == m_imageQueue.end()) {
+    std::list<String_t>::iterator it = std::find(m_prefetchQueue.begin(), m_prefetchQueue.end(), name);
+    if (it != m_prefetchQueue.end()) {
+        // Prefetch pending: promote it. This does not change the total queue length.
+        m_imageQueue.splice(m_imageQueue.end(), m_prefetchQueue, it);
+    } else if (m_activeImages.find(name) == m_activeImages.end()
+               && std::find(m_imageQueue.begin(), m_imageQueue.end(), name) == m_imageQueue.end())
+    {
         m_imageQueue.push_back(name);
         m_loaderWake.post();
     }
@@ -88,6 +134,17 @@ ui::DefaultResourceProvider::getImage(String_t name, bool* status)
     return 0;
 }
 
+// Prefetch image.
+void
+ui::DefaultResourceProvider::prefetchImage(String_t name)
+{
+    afl::sys::MutexGuard g(m_imageMutex);
+    if (!isKnownImage(name)) {
+        m_prefetchQueue.push_back(name);
+        m_loaderWake.post();
+    }
+}
+
 afl::base::Ref<gfx::Font>
 ui::DefaultResourceProvider::getFont(gfx::FontRequest req)
 {
@@ -113,8 +170,11 @@ ui::DefaultResourceProvider::init(afl::io::Directory& dir)
     addFont(dir, "font8.fnt", gfx::FontRequest().setStyle(FixedFont).addWeight(1));      // FIXED_BOLD
     addFont(dir, "font9.fnt", gfx::FontRequest().addSize(-2));                           // TINY
 
-    // Start background thread
-    m_loaderThread.start();
+    // Start background threads
+    const size_t numThreads = std::max(size_t(1), std::min(MAX_THREADS, util::getSystemInformation().numProcessors));
+    for (size_t i = 0; i < numThreads; ++i) {
+        m_loaderThreads.pushBackNew(new afl::sys::Thread(THREAD_NAME, *this))->start();
+    }
 }
 
 void
@@ -132,73 +192,45 @@ ui::DefaultResourceProvider::run()
     while (1) {
         m_loaderWake.wait();
 
-        while (util::Request<ui::res::Manager>* req = pullManagerRequest()) {
+        bool isManagerOwner = false;
+        while (util::Request<ui::res::Manager>* req = pullManagerRequest(isManagerOwner)) {
             req->handle(m_manager);
             delete req;
         }
 
         String_t todo;
+        uint32_t generation;
         {
             afl::sys::MutexGuard g(m_imageMutex);
             if (m_loaderStopRequest) {
                 break;
             }
-
-            while (!m_imageQueue.empty()) {
-                String_t n = m_imageQueue.front();
-                m_imageQueue.pop_front();
-                if (m_imageCache.find(n) == m_imageCache.end()) {
-                    todo = n;
-                    break;
-                }
+            if (!pullImage(todo)) {
+                continue;
             }
+            generation = m_cacheGeneration;
         }
 
-        if (!todo.empty()) {
-            // Load it
-            afl::base::Ptr<gfx::Canvas> can;
-            try {
-                String_t id = todo;
-                while (1) {
-                    can = m_manager.loadImage(id);
-                    if (can.get() != 0) {
-                        break;
-                    }
-                    if (!ui::res::generalizeResourceId(id)) {
-                        break;
-                    }
-                }
-                if (can.get() == 0) {
-                    m_log.write(m_log.Warn, LOG_NAME, afl::string::Format(m_translator.translateString("Image \"%s\" not found").c_str(), todo));
-                } else {
-                    m_log.write(m_log.Debug, LOG_NAME, afl::string::Format(m_translator.translateString("Loaded \"%s\"").c_str(), todo));
-                }
-            }
-            catch (std::exception& e) {
-                m_log.write(m_log.Warn, LOG_NAME, todo, e);
-            }
-            catch (...) {
-                m_log.write(m_log.Warn, LOG_NAME, afl::string::Format(m_translator.translateString("Unhandled exception while loading \"%s\"").c_str(), todo));
-            }
+        // Load it
+        afl::base::Ptr<gfx::Canvas> can = loadImage(todo);
 
-            // Save it
-            // for testing: afl::sys::Thread::sleep(1000);
+        // Save it
+        // for testing: afl::sys::Thread::sleep(1000);
+        {
             afl::sys::MutexGuard g(m_imageMutex);
-            m_imageCache[todo] = can;
-
-            // Tell caller
-            class Signaler : public afl::base::Runnable {
-             public:
-                Signaler(afl::base::Signal<void()>& sig)
-                    : m_sig(sig)
-                    { }
-                void run()
-                    { m_sig.raise(); }
-             private:
-                afl::base::Signal<void()>& m_sig;
-            };
-            m_mainThreadDispatcher.postNewRunnable(new Signaler(sig_imageChange));
+            m_activeImages.erase(todo);
+            if (generation == m_cacheGeneration) {
+                m_imageCache.put(todo, can);
+            } else {
+                // Cache has been invalidated while we were loading; result may be stale.
+                m_imageQueue.push_front(todo);
+                m_loaderWake.post();
+                continue;
+            }
         }
+
+        // Tell caller
+        signalImageChange();
     }
 }
 
@@ -209,19 +241,122 @@ ui::DefaultResourceProvider::stop()
         afl::sys::MutexGuard g(m_imageMutex);
         m_loaderStopRequest = true;
     }
-    m_loaderWake.post();
+    for (size_t i = 0, n = m_loaderThreads.size(); i < n; ++i) {
+        m_loaderWake.post();
+    }
 }
 
+/** Get next manager request.
+    Only one thread processes manager requests at a time, to keep them in order;
+    if another thread is already processing requests, returns null (that thread will process the request).
+    If the request queue is empty, performs a pending cache invalidation.
+    \param [in,out] isOwner true if this thread is currently processing requests; start with false
+    \return request; caller takes ownership. Null if none. */
 util::Request<ui::res::Manager>*
-ui::DefaultResourceProvider::pullManagerRequest()
+ui::DefaultResourceProvider::pullManagerRequest(bool& isOwner)
 {
     afl::sys::MutexGuard g(m_imageMutex);
     if (!m_managerRequests.empty()) {
+        if (m_managerActive && !isOwner) {
+            // Another thread is processing requests
+            return 0;
+        }
+        m_managerActive = true;
+        isOwner = true;
         return m_managerRequests.extractFront();
     }
-    if (m_managerInvalidate) {
+    if (isOwner) {
+        m_managerActive = false;
+        isOwner = false;
+    }
+    if (m_managerInvalidate && !m_managerActive) {
         m_managerInvalidate = false;
         m_imageCache.clear();
+        ++m_cacheGeneration;
     }
     return 0;
 }
+
+/** Get next image to load.
+    Call with m_imageMutex held.
+    Images requested by getImage() are served before prefetches.
+    The image is marked as being loaded.
+    \param [out] name Image name
+    \return true if an image was found */
+bool
+ui::DefaultResourceProvider::pullImage(String_t& name)
+{
+    std::list<String_t>* queues[] = { &m_imageQueue, &m_prefetchQueue };
+    for (size_t i = 0; i < sizeof(queues)/sizeof(queues[0]); ++i) {
+        while (!queues[i]->empty()) {
+            String_t n = queues[i]->front();
+            queues[i]->pop_front();
+            if (!m_imageCache.contains(n) && m_activeImages.insert(n).second) {
+                name = n;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/** Check whether an image is known (loaded, being loaded, or queued).
+    Call with m_imageMutex held.
+    \param name Image name
+    \return true if image is known */
+bool
+ui::DefaultResourceProvider::isKnownImage(const String_t& name) const
+{
+    return m_imageCache.contains(name)
+        || m_activeImages.find(name) != m_activeImages.end()
+        || std::find(m_imageQueue.begin(), m_imageQueue.end(), name) != m_imageQueue.end()
+        || std::find(m_prefetchQueue.begin(), m_prefetchQueue.end(), name) != m_prefetchQueue.end();
+}
+
+/** Load an image.
+    Called from a background thread without holding a lock.
+    \param name Image name
+    \return image; null if not found */
+afl::base::Ptr<gfx::Canvas>
+ui::DefaultResourceProvider::loadImage(const String_t& name)
+{
+    afl::base::Ptr<gfx::Canvas> can;
+    try {
+        String_t id = name;
+        while (1) {
+            can = m_manager.loadImage(id);
+            if (can.get() != 0) {
+                break;
+            }
+            if (!ui::res::generalizeResourceId(id)) {
+                break;
+            }
+        }
+        if (can.get() == 0) {
+            m_log.write(m_log.Warn, LOG_NAME, afl::string::Format(m_translator.translateString("Image \"%s\" not found").c_str(), name));
+        } else {
+            m_log.write(m_log.Debug, LOG_NAME, afl::string::Format(m_translator.translateString("Loaded \"%s\"").c_str(), name));
+        }
+    }
+    catch (std::exception& e) {
+        m_log.write(m_log.Warn, LOG_NAME, name, e);
+    }
+    catch (...) {
+        m_log.write(m_log.Warn, LOG_NAME, afl::string::Format(m_translator.translateString("Unhandled exception while loading \"%s\"").c_str(), name));
+    }
+    return can;
+}
+
+/** Post sig_imageChange to UI thread, unless one is already pending. */
+void
+ui::DefaultResourceProvider::signalImageChange()
+{
+    {
+        afl::sys::MutexGuard g(m_imageMutex);
+        if (m_signalPending) {
+            return;
+        }
+        m_signalPending = true;
+    }
+    m_mainThreadDispatcher.postNewRunnable(new Signaler(*this));
+}
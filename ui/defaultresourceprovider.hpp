@@ -5,8 +5,9 @@
 #ifndef C2NG_UI_DEFAULTRESOURCEPROVIDER_HPP
 #define C2NG_UI_DEFAULTRESOURCEPROVIDER_HPP
 
-#include <map>
 #include <list>
+#include <set>
+#include "afl/container/ptrvector.hpp"
 #include "afl/io/directory.hpp"
 #include "afl/string/translator.hpp"
 #include "afl/sys/loglistener.hpp"
@@ -15,6 +16,7 @@
 #include "afl/sys/thread.hpp"
 #include "gfx/fontlist.hpp"
 #include "gfx/resourceprovider.hpp"
+#include "ui/res/imagecache.hpp"
 #include "ui/res/manager.hpp"
 #include "util/requestdispatcher.hpp"
 #include "util/request.hpp"
@@ -23,7 +25,13 @@
 namespace ui {
 
     /** Default resource provider implementation.
-        Implements the gfx::ResourceProvider interface using a ui::res::Manager and a background thread. */
+        Implements the gfx::ResourceProvider interface using a ui::res::Manager and a pool of background threads.
+
+        Loaded images are kept in a size-limited cache (ui::res::ImageCache).
+        Images requested using getImage() are loaded before images requested using prefetchImage().
+        Multiple images can be loaded in parallel; see ui::res::Manager for thread-safety rules.
+
+        Manager requests (postNewManagerRequest()) are executed in order, one at a time, on one of the background threads. */
     class DefaultResourceProvider : public gfx::ResourceProvider,
                                     private afl::base::Stoppable
     {
@@ -51,8 +59,13 @@ namespace ui {
             \param invalidateCache true to invalidate the image cache after this request */
         void postNewManagerRequest(util::Request<ui::res::Manager>* req, bool invalidateCache);
 
+        /** Set image cache size limit.
+            \param limit Limit in bytes */
+        void setCacheLimit(size_t limit);
+
         // ResourceProvider:
         virtual afl::base::Ptr<gfx::Canvas> getImage(String_t name, bool* status = 0);
+        virtual void prefetchImage(String_t name);
         virtual afl::base::Ref<gfx::Font> getFont(gfx::FontRequest req);
 
      private:
@@ -72,8 +85,8 @@ namespace ui {
         /** Translator. */
         afl::string::Translator& m_translator;
 
-        /** Loader (background) thread. */
-        afl::sys::Thread m_loaderThread;
+        /** Loader (background) threads. */
+        afl::container::PtrVector<afl::sys::Thread> m_loaderThreads;
 
         /*
          *  Data shared with background thread
@@ -83,27 +96,48 @@ namespace ui {
         afl::sys::Mutex m_imageMutex;
 
         /** Loaded images. */
-        std::map<String_t, afl::base::Ptr<gfx::Canvas> > m_imageCache;
+        ui::res::ImageCache m_imageCache;
 
-        /** Queue of images to load. */
+        /** Cache generation. Incremented when the cache is invalidated, to discard results of loads that were started before. */
+        uint32_t m_cacheGeneration;
+
+        /** Queue of images to load, requested by getImage(). */
         std::list<String_t> m_imageQueue;
 
+        /** Queue of images to load, requested by prefetchImage(). */
+        std::list<String_t> m_prefetchQueue;
+
+        /** Images currently being loaded. */
+        std::set<String_t> m_activeImages;
+
         afl::container::PtrQueue<util::Request<ui::res::Manager> > m_managerRequests;
         bool m_managerInvalidate;
 
-        /** Semaphore to wake the background thread. Essentially tracks the m_imageQueue length. */
+        /** true if a thread is processing manager requests. Ensures that requests are processed in order. */
+        bool m_managerActive;
+
+        /** true if a sig_imageChange callback has been posted but not yet executed. */
+        bool m_signalPending;
+
+        /** Semaphore to wake the background threads. Essentially tracks the total length of all queues. */
         afl::sys::Semaphore m_loaderWake;
 
         /** Stop request. */
         bool m_loaderStopRequest;
 
+        class Signaler;
+
         void init(afl::io::Directory& dir);
         void addFont(afl::io::Directory& dir, const char* name, const gfx::FontRequest& defn);
 
         virtual void run();
         virtual void stop();
 
-        util::Request<ui::res::Manager>* pullManagerRequest();
+        util::Request<ui::res::Manager>* pullManagerRequest(bool& isOwner);
+        bool pullImage(String_t& name);
+        bool isKnownImage(const String_t& name) const;
+        afl::base::Ptr<gfx::Canvas> loadImage(const String_t& name);
+        void signalImageChange();
     };
 
 }
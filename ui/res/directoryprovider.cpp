@@ -87,7 +87,7 @@ ui::res::DirectoryProvider::loadImage(String_t name, Manager& mgr)
     }
 
     // Load pixmap
-    afl::base::Ptr<gfx::Canvas> pix = mgr.loadImage(*stream);
+    afl::base::Ptr<gfx::Canvas> pix = mgr.loadImage(*stream, *this);
     if (pix.get() == 0) {
         return 0;
     }
@@ -147,7 +147,7 @@ ui::res::DirectoryProvider::loadImage(String_t name, Manager& mgr)
         } else {
             afl::base::Ptr<afl::io::Stream> overlayStream = openResourceFile(*m_directory, op, graphicsSuffixes());
             if (overlayStream.get() != 0) {
-                afl::base::Ptr<gfx::Canvas> overlay = mgr.loadImage(*overlayStream);
+                afl::base::Ptr<gfx::Canvas> overlay = mgr.loadImage(*overlayStream, *this);
                 if (overlay.get() != 0) {
                     pix->blit(gfx::Point(), *overlay, gfx::Rectangle(gfx::Point(), overlay->getSize()));
                 }
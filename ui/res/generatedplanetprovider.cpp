@@ -26,6 +26,13 @@ ui::res::GeneratedPlanetProvider::loadImage(String_t name, Manager& /*mgr*/)
     }
 }
 
+bool
+ui::res::GeneratedPlanetProvider::isThreadSafe() const
+{
+    // Rendering uses only local state
+    return true;
+}
+
 afl::base::Ptr<gfx::Canvas>
 ui::res::GeneratedPlanetProvider::renderPlanet(int temp, int id)
 {
@@ -14,6 +14,7 @@ namespace ui { namespace res {
         ~GeneratedPlanetProvider();
 
         virtual afl::base::Ptr<gfx::Canvas> loadImage(String_t name, Manager& mgr);
+        virtual bool isThreadSafe() const;
 
      private:
         afl::base::Ptr<gfx::Canvas> renderPlanet(int temp, int id);
@@ -0,0 +1,144 @@
+/**
+  *  \file ui/res/imagecache.cpp
+  *  \brief Class ui::res::ImageCache
+  */
+
+#include "ui/res/imagecache.hpp"
+
+namespace {
+    /* Fixed cost per entry (map node, list node, name).
+       This also limits the number of negative entries. */
+    const size_t ENTRY_OVERHEAD = 128;
+}
+
+const size_t ui::res::ImageCache::DEFAULT_LIMIT;
+
+// Constructor.
+ui::res::ImageCache::ImageCache(size_t limit)
+    : m_entries(),
+      m_lru(),
+      m_limit(limit),
+      m_size(0)
+{ }
+
+// Destructor.
+ui::res::ImageCache::~ImageCache()
+{ }
+
+// Look up an image.
+bool
+ui::res::ImageCache::get(const String_t& name, afl::base::Ptr<gfx::Canvas>& result)
+{
+    Map_t::iterator it = m_entries.find(name);
+    if (it != m_entries.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+        result = it->second.image;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+// Check presence of an image.
+bool
+ui::res::ImageCache::contains(const String_t& name) const
+{
+    return m_entries.find(name) != m_entries.end();
+}
+
+// Add an image.
+void
+ui::res::ImageCache::put(const String_t& name, afl::base::Ptr<gfx::Canvas> image)
+{
+    Map_t::iterator it = m_entries.find(name);
+    if (it != m_entries.end()) {
+        remove(it);
+    }
+
+    Entry& e = m_entries[name];
+    e.image = image;
+    e.size = getImageSize(image.get()) + name.size() + ENTRY_OVERHEAD;
+    e.lruPosition = m_lru.insert(m_lru.begin(), name);
+    m_size += e.size;
+
+    discard(1);
+}
+
+// Discard all entries.
+void
+ui::res::ImageCache::clear()
+{
+    m_entries.clear();
+    m_lru.clear();
+    m_size = 0;
+}
+
+// Set size limit.
+void
+ui::res::ImageCache::setLimit(size_t limit)
+{
+    m_limit = limit;
+    discard(0);
+}
+
+// Get size limit.
+size_t
+ui::res::ImageCache::getLimit() const
+{
+    return m_limit;
+}
+
+// Get total size of cached entries.
+size_t
+ui::res::ImageCache::getSize() const
+{
+    return m_size;
+}
+
+// Get number of cached entries.
+size_t
+ui::res::ImageCache::getNumEntries() const
+{
+    return m_entries.size();
+}
+
+// Get approximate memory size of an image.
+size_t
+ui::res::ImageCache::getImageSize(gfx::Canvas* image)
+{
+    if (image == 0) {
+        return 0;
+    }
+    const gfx::Point size = image->getSize();
+    const int bytesPerPixel = (image->getBitsPerPixel() + 7) / 8;
+    if (size.getX() <= 0 || size.getY() <= 0 || bytesPerPixel <= 0) {
+        return 0;
+    }
+    return size_t(size.getX()) * size_t(size.getY()) * size_t(bytesPerPixel);
+}
+
+/** Remove an entry.
+    \param it Entry */
+void
+ui::res::ImageCache::remove(Map_t::iterator it)
+{
+    m_size -= it->second.size;
+    m_lru.erase(it->second.lruPosition);
+    m_entries.erase(it);
+}
+
+/** Discard least-recently used entries until the limit is honored.
+    \param keep Number of most-recently used entries to keep in any case */
+void
+ui::res::ImageCache::discard(size_t keep)
+{
+    while (m_size > m_limit && m_lru.size() > keep) {
+        Map_t::iterator it = m_entries.find(m_lru.back());
+        if (it == m_entries.end()) {
+            // Cannot happen
+            m_lru.pop_back();
+        } else {
+            remove(it);
+        }
+    }
+}
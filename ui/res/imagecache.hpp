@@ -0,0 +1,102 @@
+/**
+  *  \file ui/res/imagecache.hpp
+  *  \brief Class ui::res::ImageCache
+  */
+#ifndef C2NG_UI_RES_IMAGECACHE_HPP
+#define C2NG_UI_RES_IMAGECACHE_HPP
+
+#include <list>
+#include <map>
+#include "afl/base/ptr.hpp"
+#include "afl/string/string.hpp"
+#include "gfx/canvas.hpp"
+
+namespace ui { namespace res {
+
+    /** Size-limited image cache.
+        Stores images by name, including negative results (null images).
+        Each entry is charged its approximate memory size (see getImageSize()).
+        If the total size exceeds the limit, least-recently-used entries are discarded.
+        A single entry that exceeds the limit on its own is kept until the next insertion.
+
+        Discarding an entry only drops the cache's reference; users that still hold the image keep it alive.
+
+        This class is not thread-safe. */
+    class ImageCache {
+     public:
+        /** Default size limit in bytes. */
+        static const size_t DEFAULT_LIMIT = 64*1024*1024;
+
+        /** Constructor.
+            \param limit Size limit in bytes */
+        explicit ImageCache(size_t limit = DEFAULT_LIMIT);
+
+        /** Destructor. */
+        ~ImageCache();
+
+        /** Look up an image.
+            If the image is found, it is marked as most-recently used.
+            \param [in]  name   Image name
+            \param [out] result Image (can be null if the image is known to not exist)
+            \return true if image was found in cache; false if it is not known */
+        bool get(const String_t& name, afl::base::Ptr<gfx::Canvas>& result);
+
+        /** Check presence of an image.
+            Unlike get(), does not affect the order of discarding.
+            \param name Image name
+            \return true if image was found in cache */
+        bool contains(const String_t& name) const;
+
+        /** Add an image.
+            Replaces a previous entry of the same name.
+            The new entry is marked as most-recently used; other entries may be discarded to honor the limit.
+            \param name  Image name
+            \param image Image (can be null) */
+        void put(const String_t& name, afl::base::Ptr<gfx::Canvas> image);
+
+        /** Discard all entries. */
+        void clear();
+
+        /** Set size limit.
+            Discards entries as needed.
+            \param limit Size limit in bytes */
+        void setLimit(size_t limit);
+
+        /** Get size limit.
+            \return size limit in bytes */
+        size_t getLimit() const;
+
+        /** Get total size of cached entries.
+            \return size in bytes */
+        size_t getSize() const;
+
+        /** Get number of cached entries.
+            \return number */
+        size_t getNumEntries() const;
+
+        /** Get approximate memory size of an image.
+            \param image Image (can be null)
+            \return size in bytes */
+        static size_t getImageSize(gfx::Canvas* image);
+
+     private:
+        typedef std::list<String_t> LruList_t;
+        struct Entry {
+            afl::base::Ptr<gfx::Canvas> image;
+            size_t size;
+            LruList_t::iterator lruPosition;
+        };
+        typedef std::map<String_t, Entry> Map_t;
+
+        Map_t m_entries;
+        LruList_t m_lru;            ///< Names, most-recently used first.
+        size_t m_limit;
+        size_t m_size;
+
+        void remove(Map_t::iterator it);
+        void discard(size_t keep);
+    };
+
+} }
+
+#endif
@@ -3,11 +3,14 @@
   */
 
 #include "ui/res/manager.hpp"
+#include "afl/io/internalstream.hpp"
+#include "afl/sys/mutexguard.hpp"
 #include "ui/res/imageloader.hpp"
 #include "ui/res/provider.hpp"
 
 ui::res::Manager::Manager()
     : m_imageLoaders(),
+      m_mutex(),
       m_providers(),
       m_screenSize(320, 200)
 { }
@@ -28,16 +31,31 @@ ui::res::Manager::addNewProvider(Provider* p, String_t key)
 {
     if (p != 0) {
         std::auto_ptr<Provider> pp(p);
-        m_providers.pushBackNew(new ProviderKey(pp, key));
+        afl::base::Ptr<ProviderKey> pk = new ProviderKey(pp, key);
+        afl::sys::MutexGuard g(m_mutex);
+        m_providers.push_back(pk);
     }
 }
 
 afl::base::Ptr<gfx::Canvas>
 ui::res::Manager::loadImage(String_t name)
 {
+    // Work on a copy of the provider list, so providers can be added/removed while we're loading.
+    ProviderList_t providers;
+    {
+        afl::sys::MutexGuard g(m_mutex);
+        providers = m_providers;
+    }
+
     afl::base::Ptr<gfx::Canvas> result;
-    for (size_t i = m_providers.size(); i > 0; --i) {
-        result = m_providers[i-1]->provider->loadImage(name, *this);
+    for (size_t i = providers.size(); i > 0; --i) {
+        ProviderKey& pk = *providers[i-1];
+        if (pk.provider->isThreadSafe()) {
+            result = pk.provider->loadImage(name, *this);
+        } else {
+            afl::sys::MutexGuard g(pk.provider->m_mutex);
+            result = pk.provider->loadImage(name, *this);
+        }
         if (result.get() != 0) {
             break;
         }
@@ -58,13 +76,41 @@ ui::res::Manager::loadImage(afl::io::Stream& s)
     return result;
 }
 
+afl::base::Ptr<gfx::Canvas>
+ui::res::Manager::loadImage(afl::io::Stream& s, Provider& caller)
+{
+    if (caller.isThreadSafe()) {
+        return loadImage(s);
+    }
+
+    // Caller is serialized by loadImage(String_t) and holds its lock.
+    // Read the file while we still have it, then let go for the decode.
+    afl::io::InternalStream buffer;
+    buffer.copyFrom(s);
+    buffer.setPos(0);
+
+    class Unlocker {
+     public:
+        Unlocker(afl::sys::Mutex& mutex)
+            : m_mutex(mutex)
+            { m_mutex.post(); }
+        ~Unlocker()
+            { m_mutex.wait(); }
+     private:
+        afl::sys::Mutex& m_mutex;
+    };
+    Unlocker u(caller.m_mutex);
+    return loadImage(buffer);
+}
+
 void
 ui::res::Manager::removeProvidersByKey(String_t key)
 {
+    afl::sys::MutexGuard g(m_mutex);
     size_t out = 0;
     for (size_t i = 0, n = m_providers.size(); i < n; ++i) {
         if (m_providers[i]->key != key) {
-            m_providers.swapElements(i, out++);
+            m_providers[out++] = m_providers[i];
         }
     }
     m_providers.resize(out);
@@ -73,11 +119,13 @@ ui::res::Manager::removeProvidersByKey(String_t key)
 gfx::Point
 ui::res::Manager::getScreenSize() const
 {
+    afl::sys::MutexGuard g(m_mutex);
     return m_screenSize;
 }
 
 void
 ui::res::Manager::setScreenSize(gfx::Point sz)
 {
+    afl::sys::MutexGuard g(m_mutex);
     m_screenSize = sz;
 }
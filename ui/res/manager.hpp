@@ -5,8 +5,12 @@
 #define C2NG_UI_RES_MANAGER_HPP
 
 #include <memory>
+#include <vector>
+#include "afl/base/ptr.hpp"
+#include "afl/base/refcounted.hpp"
 #include "afl/container/ptrvector.hpp"
 #include "afl/io/stream.hpp"
+#include "afl/sys/mutex.hpp"
 #include "gfx/canvas.hpp"
 #include "ui/res/provider.hpp"
 
@@ -14,6 +18,17 @@ namespace ui { namespace res {
 
     class ImageLoader;
 
+    /** Resource manager.
+        Manages a list of providers and image loaders.
+
+        loadImage() can be called from multiple threads concurrently,
+        also while providers are being added or removed (addNewProvider(), removeProvidersByKey()).
+        Providers that are not thread-safe (Provider::isThreadSafe()) are called with a lock held.
+        Decoding an image does not need that lock;
+        such providers therefore pass their stream to loadImage(afl::io::Stream&, Provider&), which releases it while decoding.
+        A provider that is removed while a loadImage() call uses it is destroyed when that call completes.
+
+        Image loaders must be added before concurrent use, and must be thread-safe. */
     class Manager {
      public:
         Manager();
@@ -28,6 +43,15 @@ namespace ui { namespace res {
 
         afl::base::Ptr<gfx::Canvas> loadImage(afl::io::Stream& s);
 
+        /** Load image on behalf of a provider.
+            Must only be called from the provider's Provider::loadImage().
+            If the provider is not thread-safe, reads the stream into memory with the provider's lock still held,
+            and decodes it with the lock released, so that other threads can use the provider meanwhile.
+            \param s      Stream
+            \param caller Provider calling this function
+            \return Newly-allocated image; null if file type not recognized */
+        afl::base::Ptr<gfx::Canvas> loadImage(afl::io::Stream& s, Provider& caller);
+
         void removeProvidersByKey(String_t key);
 
         gfx::Point getScreenSize() const;
@@ -35,15 +59,20 @@ namespace ui { namespace res {
         void setScreenSize(gfx::Point sz);
 
      private:
-        struct ProviderKey {
+        struct ProviderKey : public afl::base::RefCounted {
             std::auto_ptr<Provider> provider;
             String_t key;
             ProviderKey(std::auto_ptr<Provider> provider, String_t key)
                 : provider(provider), key(key)
                 { }
         };
+        typedef std::vector<afl::base::Ptr<ProviderKey> > ProviderList_t;
+
         afl::container::PtrVector<ImageLoader> m_imageLoaders;
-        afl::container::PtrVector<ProviderKey> m_providers;
+
+        /** Mutex protecting m_providers, m_screenSize. */
+        mutable afl::sys::Mutex m_mutex;
+        ProviderList_t m_providers;
         gfx::Point m_screenSize;
     };
 
@@ -4,6 +4,13 @@
 
 #include "ui/res/provider.hpp"
 
+// Check thread safety.
+bool
+ui::res::Provider::isThreadSafe() const
+{
+    return false;
+}
+
 /** Open a resource file. If the specified file name ends with a dot, this
     searches for a file according to the suffix list. Otherwise, only the
     exact name specified is attempted.
@@ -10,6 +10,7 @@
 #include "afl/string/string.hpp"
 #include "afl/io/stream.hpp"
 #include "afl/io/directory.hpp"
+#include "afl/sys/mutex.hpp"
 
 namespace ui { namespace res {
 
@@ -19,12 +20,24 @@ namespace ui { namespace res {
      public:
         virtual afl::base::Ptr<gfx::Canvas> loadImage(String_t name, Manager& mgr) = 0;
 
+        /** Check thread safety.
+            If this function returns true, Manager may call loadImage() from multiple threads concurrently.
+            Otherwise, calls are serialized.
+            \return true if loadImage() is thread-safe. Default implementation returns false. */
+        virtual bool isThreadSafe() const;
+
         /*
          *  Utility functions
          */
         static afl::base::Ptr<afl::io::Stream> openResourceFile(afl::io::Directory& dir, String_t fileName, afl::base::Memory<const char*const> suffixes);
 
         static afl::base::Memory<const char*const> graphicsSuffixes();
+
+     private:
+        friend class Manager;
+
+        /** Serializes access to a provider that is not thread-safe; locked by Manager. */
+        afl::sys::Mutex m_mutex;
     };
 
 } }
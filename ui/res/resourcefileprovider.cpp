@@ -179,13 +179,13 @@ ui::res::ResourceFileProvider::loadImageById(uint16_t id, Manager& mgr)
     // Try 256-color version
     afl::base::Ptr<afl::io::Stream> in = m_file.openMember(uint16_t(id + 20000));
     if (in.get() != 0) {
-        return mgr.loadImage(*in);
+        return mgr.loadImage(*in, *this);
     }
 
     // Try 16-color version
     in = m_file.openMember(id);
     if (in.get() != 0) {
-        return mgr.loadImage(*in);
+        return mgr.loadImage(*in, *this);
     }
 
     // Not contained in resource file
@@ -24,7 +24,7 @@ ui::res::WinplanBitmapProvider::loadImage(String_t name, Manager& mgr)
     if (matchResourceId(name, SHIP, imageNumber) && imageNumber != 200) {
         afl::base::Ptr<afl::io::Stream> s = openResourceFile(*m_directory, afl::string::Format("vpl%d.", imageNumber), graphicsSuffixes());
         if (s.get() != 0) {
-            return mgr.loadImage(*s);
+            return mgr.loadImage(*s, *this);
         } else {
             return 0;
         }
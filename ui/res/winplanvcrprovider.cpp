@@ -47,7 +47,7 @@ ui::res::WinplanVcrProvider::loadImage(String_t name, Manager& mgr)
     afl::io::LimitedStream s(m_file, position-1, size);
     s.setPos(0);
 
-    afl::base::Ptr<gfx::Canvas> result = mgr.loadImage(s);
+    afl::base::Ptr<gfx::Canvas> result = mgr.loadImage(s, *this);
     if (result.get() != 0) {
         // FIXME: port this (colorkey)
         // /* I was cropping the image here, but I think that is
@@ -0,0 +1,145 @@
+/**
+  *  \file util/directorysnapshot.cpp
+  *  \brief Class util::DirectorySnapshot
+  */
+
+#include <cstring>
+#include <vector>
+#include "util/directorysnapshot.hpp"
+#include "afl/base/growablememory.hpp"
+#include "afl/bits/uint32le.hpp"
+#include "afl/bits/value.hpp"
+#include "afl/except/fileformatexception.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/directoryentry.hpp"
+#include "afl/io/filesystem.hpp"
+#include "afl/io/internaldirectory.hpp"
+
+namespace {
+    typedef afl::bits::Value<afl::bits::UInt32LE> UInt32_t;
+
+    const char MAGIC[] = "CCsnap\x1A\x01";
+
+    struct Header {
+        uint8_t magic[8];
+        UInt32_t numEntries;
+    };
+
+    struct Entry {
+        UInt32_t namePosition;
+        UInt32_t nameLength;
+        UInt32_t contentPosition;
+        UInt32_t contentLength;
+    };
+
+    /* A file to be saved. */
+    struct File {
+        String_t name;
+        afl::base::Ptr<afl::io::FileMapping> content;
+        File(const String_t& name, afl::base::Ptr<afl::io::FileMapping> content)
+            : name(name), content(content)
+            { }
+    };
+
+    /* A file in a snapshot.
+       Refers to the memory of the mapping, and keeps that alive. */
+    class MappedStream : public afl::io::ConstMemoryStream {
+     public:
+        MappedStream(afl::base::Ref<afl::io::FileMapping> mapping, afl::base::ConstBytes_t data)
+            : ConstMemoryStream(data),
+              m_mapping(mapping)
+            { }
+     private:
+        afl::base::Ref<afl::io::FileMapping> m_mapping;
+    };
+
+    /* Get a range from the snapshot, with validation. */
+    afl::base::ConstBytes_t getRange(afl::base::ConstBytes_t data, uint32_t pos, uint32_t length, const String_t& name, afl::string::Translator& tx)
+    {
+        if (pos > data.size() || length > data.size() - pos) {
+            throw afl::except::FileFormatException(name, tx("Invalid file format (bad pointer)"));
+        }
+        return data.subrange(pos, length);
+    }
+}
+
+// Save a snapshot.
+void
+util::DirectorySnapshot::save(afl::io::Directory& dir, afl::io::Stream& out)
+{
+    // Collect files
+    std::vector<File> files;
+
+    afl::base::Ref<afl::base::Enumerator<afl::base::Ptr<afl::io::DirectoryEntry> > > e = dir.getDirectoryEntries();
+    afl::base::Ptr<afl::io::DirectoryEntry> p;
+    while (e->getNextElement(p)) {
+        if (p.get() != 0 && p->getFileType() == afl::io::DirectoryEntry::tFile) {
+            files.push_back(File(p->getTitle(), p->openFile(afl::io::FileSystem::OpenRead)->createVirtualMapping().asPtr()));
+        }
+    }
+
+    // Build directory
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.numEntries = static_cast<uint32_t>(files.size());
+
+    afl::base::GrowableMemory<Entry> entries;
+    entries.resize(files.size());
+    uint32_t pos = static_cast<uint32_t>(sizeof(Header) + files.size() * sizeof(Entry));
+    for (size_t i = 0; i < files.size(); ++i) {
+        Entry& ent = *entries.at(i);
+        ent.namePosition = pos;
+        ent.nameLength = static_cast<uint32_t>(files[i].name.size());
+        pos += static_cast<uint32_t>(files[i].name.size());
+    }
+    for (size_t i = 0; i < files.size(); ++i) {
+        Entry& ent = *entries.at(i);
+        ent.contentPosition = pos;
+        ent.contentLength = static_cast<uint32_t>(files[i].content->get().size());
+        pos += static_cast<uint32_t>(files[i].content->get().size());
+    }
+
+    // Write
+    out.fullWrite(afl::base::fromObject(header));
+    out.fullWrite(entries.toBytes());
+    for (size_t i = 0; i < files.size(); ++i) {
+        out.fullWrite(afl::string::toBytes(files[i].name));
+    }
+    for (size_t i = 0; i < files.size(); ++i) {
+        out.fullWrite(files[i].content->get());
+    }
+}
+
+// Load a snapshot.
+afl::base::Ref<afl::io::Directory>
+util::DirectorySnapshot::load(afl::base::Ref<afl::io::FileMapping> mapping, const String_t& name, afl::string::Translator& tx)
+{
+    const afl::base::ConstBytes_t data = mapping->get();
+
+    // Header
+    Header header;
+    if (data.size() < sizeof(header)) {
+        throw afl::except::FileFormatException(name, tx("File is missing required signature"));
+    }
+    afl::base::fromObject(header).copyFrom(data);
+    if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0) {
+        throw afl::except::FileFormatException(name, tx("File is missing required signature"));
+    }
+
+    // Entries
+    const uint32_t numEntries = header.numEntries;
+    if (numEntries > (data.size() - sizeof(header)) / sizeof(Entry)) {
+        throw afl::except::FileFormatException(name, tx("Invalid file format (bad pointer)"));
+    }
+
+    afl::base::Ref<afl::io::InternalDirectory> dir = afl::io::InternalDirectory::create(name);
+    for (uint32_t i = 0; i < numEntries; ++i) {
+        Entry ent;
+        afl::base::fromObject(ent).copyFrom(data.subrange(sizeof(header) + i*sizeof(Entry)));
+
+        afl::base::ConstBytes_t fileName = getRange(data, ent.namePosition, ent.nameLength, name, tx);
+        afl::base::ConstBytes_t content  = getRange(data, ent.contentPosition, ent.contentLength, name, tx);
+        dir->addStream(afl::string::fromBytes(fileName), *new MappedStream(mapping, content));
+    }
+    return dir;
+}
@@ -0,0 +1,56 @@
+/**
+  *  \file util/directorysnapshot.hpp
+  *  \brief Class util::DirectorySnapshot
+  */
+#ifndef C2NG_UTIL_DIRECTORYSNAPSHOT_HPP
+#define C2NG_UTIL_DIRECTORYSNAPSHOT_HPP
+
+#include "afl/base/ref.hpp"
+#include "afl/io/directory.hpp"
+#include "afl/io/filemapping.hpp"
+#include "afl/io/stream.hpp"
+#include "afl/string/string.hpp"
+#include "afl/string/translator.hpp"
+
+namespace util {
+
+    /** Directory snapshot.
+
+        A directory snapshot stores the content of all files of a directory in a single file.
+        It is intended for specification directories:
+        a server that runs many game sessions on the same game can produce the snapshot once,
+        and each session maps it into memory instead of opening (and possibly downloading) each file separately.
+
+        The snapshot file contains only relative offsets, and can therefore be mapped anywhere.
+        Using a read-only file mapping, the data is shared by all processes that use the same snapshot.
+        File content is not copied when loading the snapshot.
+
+        Format (all values are 32-bit little-endian):
+        - header: magic (8 bytes), number of entries
+        - for each entry: name position, name length, content position, content length
+        - names and content; positions are 0-based file offsets */
+    class DirectorySnapshot {
+     public:
+        /** Save a snapshot.
+            Saves all files (not subdirectories) of a directory.
+            \param dir  Directory
+            \param out  Output stream
+            \throw afl::except::FileProblemException on error */
+        static void save(afl::io::Directory& dir, afl::io::Stream& out);
+
+        /** Load a snapshot.
+            Creates a directory that contains all files from the snapshot.
+            Files refer to the mapping, which is kept alive as long as needed.
+            Files can be read, but not modified in-place;
+            creating a file with the same name replaces it by a private copy.
+            \param mapping  Snapshot file content
+            \param name     Name of snapshot file (for error messages, and as name of the directory)
+            \param tx       Translator (for error messages)
+            \return newly-allocated directory
+            \throw afl::except::FileFormatException if the snapshot is invalid */
+        static afl::base::Ref<afl::io::Directory> load(afl::base::Ref<afl::io::FileMapping> mapping, const String_t& name, afl::string::Translator& tx);
+    };
+
+}
+
+#endif
@@ -27,7 +27,7 @@ namespace {
     class PosixSubprocess : public util::process::Subprocess {
      public:
         PosixSubprocess()
-            : m_pid(0), m_readFD(-1), m_writeFD(-1)
+            : m_pid(0), m_readFD(-1), m_writeFD(-1), m_buffer(), m_bufferPos(0)
             { }
 
         bool isActive() const
@@ -95,6 +95,8 @@ namespace {
                 m_readFD = fromChild[Read];
                 m_writeFD = toChild[Write];
                 m_pid = child;
+                m_buffer.clear();
+                m_bufferPos = 0;
                 close(fromChild[Write]);
                 close(toChild[Read]);
                 fcntl(m_readFD, F_SETFD, FD_CLOEXEC);
@@ -120,6 +122,8 @@ namespace {
                 }
                 close(m_readFD);
                 m_readFD = -1;
+                m_buffer.clear();
+                m_bufferPos = 0;
 
                 // Wait for termination
                 int status;
@@ -147,19 +151,29 @@ namespace {
 
         bool readLine(String_t& result)
             {
-                // FIXME: inefficient!!!
+                // Read in chunks; data after the line remains in m_buffer for the next call.
                 result.clear();
-
-                char ch;
-                while (read(m_readFD, &ch, 1) == 1) {
-                    if (ch != '\r') {
-                        result += ch;
+                while (1) {
+                    String_t::size_type n = m_buffer.find('\n', m_bufferPos);
+                    String_t::size_type end = (n == String_t::npos ? m_buffer.size() : n+1);
+                    for (String_t::size_type i = m_bufferPos; i < end; ++i) {
+                        if (m_buffer[i] != '\r') {
+                            result += m_buffer[i];
+                        }
                     }
-                    if (ch == '\n') {
+                    m_bufferPos = end;
+                    if (n != String_t::npos) {
                         return true;
                     }
+
+                    char tmp[4096];
+                    ssize_t got = (m_readFD < 0 ? -1 : read(m_readFD, tmp, sizeof(tmp)));
+                    if (got <= 0) {
+                        return false;
+                    }
+                    m_buffer.assign(tmp, size_t(got));
+                    m_bufferPos = 0;
                 }
-                return false;
             }
 
         String_t getStatus() const
@@ -170,6 +184,8 @@ namespace {
         int m_readFD;
         int m_writeFD;
         String_t m_status;
+        String_t m_buffer;
+        String_t::size_type m_bufferPos;
     };
 }
 
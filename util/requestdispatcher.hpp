@@ -6,6 +6,7 @@
 #define C2NG_UTIL_REQUESTDISPATCHER_HPP
 
 #include "afl/base/runnable.hpp"
+#include "afl/container/ptrvector.hpp"
 
 namespace util {
 
@@ -24,6 +25,31 @@ namespace util {
 
             \param p newly-allocated Runnable. RequestDispatcher takes ownership. Must not be null. */
         virtual void postNewRunnable(afl::base::Runnable* p) = 0;
+
+        /** Post multiple new Runnables.
+            Same as posting all elements of the list in order using postNewRunnable(),
+            but allows the implementation to enqueue them in one step.
+
+            \param list newly-allocated Runnables. RequestDispatcher takes ownership; list will be empty afterwards. Must not contain null. */
+        virtual void postNewRunnables(afl::container::PtrVector<afl::base::Runnable>& list)
+            {
+                for (size_t i = 0, n = list.size(); i < n; ++i) {
+                    postNewRunnable(list.extractElement(i));
+                }
+                list.clear();
+            }
+
+        /** Post new replaceable Runnable.
+            Use for requests that set a state, where a later request makes an earlier one obsolete
+            (e.g. "set position to X").
+            If the most recently posted Runnable has the same key and has not yet been started,
+            the implementation may discard it without executing it, and post this one instead.
+            Requests with a different or no key are never dropped or reordered.
+
+            \param p   newly-allocated Runnable. RequestDispatcher takes ownership. Must not be null.
+            \param key Key identifying the kind of request and its originator; null means not replaceable */
+        virtual void postNewReplaceableRunnable(afl::base::Runnable* p, const void* /*key*/)
+            { postNewRunnable(p); }
     };
 
 }
@@ -73,6 +73,8 @@ class util::RequestReceiver<ObjectType>::SenderImpl : public RequestSender<Objec
           m_dispatcher(dispatcher)
         { }
     virtual void postNewRequest(Request_t* req)
+        { postNewReplaceableRequest(req, 0); }
+    virtual void postNewReplaceableRequest(Request_t* req, const void* key)
         {
             // Request-to-Runnable adapter
             class Processor : public afl::base::Runnable {
@@ -95,7 +97,11 @@ class util::RequestReceiver<ObjectType>::SenderImpl : public RequestSender<Objec
 
             // Post it
             std::auto_ptr<Request_t> pp(req);
-            m_dispatcher.postNewRunnable(new Processor(*this, pp));
+            if (key != 0) {
+                m_dispatcher.postNewReplaceableRunnable(new Processor(*this, pp), key);
+            } else {
+                m_dispatcher.postNewRunnable(new Processor(*this, pp));
+            }
         }
     void disconnect()
         { m_pBacklink = 0; }
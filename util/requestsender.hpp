@@ -34,6 +34,8 @@ namespace util {
         class Impl : public afl::base::RefCounted, public afl::base::Deletable {
          public:
             virtual void postNewRequest(Request_t* req) = 0;
+            virtual void postNewReplaceableRequest(Request_t* req, const void* /*key*/)
+                { postNewRequest(req); }
         };
 
         /** Null implementation. */
@@ -71,6 +73,18 @@ namespace util {
         void postNewRequest(Request_t* p)
             { m_pImpl->postNewRequest(p); }
 
+        /** Post new replaceable request.
+            Same as postNewRequest(), but if the directly preceding request posted to the same RequestDispatcher
+            had the same key and has not yet been executed, that request may be discarded.
+            Use this for requests that set a state, where only the latest request matters,
+            to avoid a backlog when requests are produced faster than they can be processed.
+
+            \param p   Newly-allocated request. Ownership will be transferred to the RequestSender.
+            \param key Key; typically, the address of the object that produces the requests.
+                       Requests of different kinds posted by the same object must use different keys. */
+        void postNewReplaceableRequest(Request_t* p, const void* key)
+            { m_pImpl->postNewReplaceableRequest(p, key); }
+
         /** Post request to nullary function.
             Calls obj.fcn() on the object addressed by this RequestSender.
             \param fcn Function to call */
@@ -174,6 +188,11 @@ namespace util {
                             std::auto_ptr<OtherRequest_t> pp(p);
                             m_impl->postNewRequest(new RequestAdaptor(pp, m_closure));
                         }
+                    virtual void postNewReplaceableRequest(OtherRequest_t* p, const void* key)
+                        {
+                            std::auto_ptr<OtherRequest_t> pp(p);
+                            m_impl->postNewReplaceableRequest(new RequestAdaptor(pp, m_closure), key);
+                        }
                  private:
                     afl::base::Ref<Impl> m_impl;
                     ClosureRef_t m_closure;
@@ -363,6 +382,11 @@ util::RequestSender<ObjectType>::makeTemporary(afl::base::Closure<OtherType* (Ob
                 std::auto_ptr<OtherRequest_t> pp(p);
                 m_impl->postNewRequest(new RequestAdaptor(pp, *m_trampoline));
             }
+        virtual void postNewReplaceableRequest(OtherRequest_t* p, const void* key)
+            {
+                std::auto_ptr<OtherRequest_t> pp(p);
+                m_impl->postNewReplaceableRequest(new RequestAdaptor(pp, *m_trampoline), key);
+            }
      private:
         afl::base::Ref<Impl> m_impl;
         Trampoline_t* m_trampoline;
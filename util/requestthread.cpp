@@ -4,18 +4,26 @@
   */
 
 #include "util/requestthread.hpp"
+#include "afl/string/format.hpp"
 #include "afl/sys/mutexguard.hpp"
 
+namespace {
+    /* Log a message if a request waited longer than this (milliseconds) */
+    const uint32_t LATENCY_WARNING = 200;
+}
+
 // Constructor.
 util::RequestThread::RequestThread(String_t name, afl::sys::LogListener& log, afl::string::Translator& tx, int delay)
     : m_thread(),
       m_taskMutex(),
       m_taskSemaphore(0),
-      m_taskQueue(),
+      m_pFirstTask(0),
+      m_pLastTask(0),
       m_name(name),
       m_log(log),
       m_translator(tx),
       m_stop(false),
+      m_maxWaitTime(0),
       m_delay(delay)
 {
     m_thread.reset(new afl::sys::Thread(name, *this));
@@ -31,15 +39,13 @@ util::RequestThread::~RequestThread()
     }
 
     // Make sure tasks are destroyed in correct order (FIFO).
-    // PtrVector would destroy them from back to front.
     // Tasks might reference temporaries (RequestSender::makeTemporary) that refer to each other,
     // so destroying them in the wrong order means a task referring to the temporary overtakes one that destroys it.
-    while (!m_taskQueue.empty()) {
-        afl::container::PtrVector<afl::base::Runnable> tasks;
-        tasks.swap(m_taskQueue);
-        for (size_t i = 0, n = tasks.size(); i < n; ++i) {
-            tasks.replaceElementNew(i, 0);
-        }
+    // Destroying a task can post new tasks, so repeat until the queue is empty.
+    while (m_pFirstTask != 0) {
+        Task* p = m_pFirstTask;
+        m_pFirstTask = m_pLastTask = 0;
+        destroyTasks(p);
     }
 }
 
@@ -47,11 +53,64 @@ util::RequestThread::~RequestThread()
 void
 util::RequestThread::postNewRunnable(afl::base::Runnable* p)
 {
-    afl::sys::MutexGuard g(m_taskMutex);
-    m_taskQueue.pushBackNew(p);
-    if (m_taskQueue.size() == 1) {
-        m_taskSemaphore.post();
+    postNewReplaceableRunnable(p, 0);
+}
+
+// Post multiple new Runnables.
+void
+util::RequestThread::postNewRunnables(afl::container::PtrVector<afl::base::Runnable>& list)
+{
+    // Build the chain outside the mutex
+    Task* pFirst = 0;
+    Task* pLast = 0;
+    try {
+        for (size_t i = 0, n = list.size(); i < n; ++i) {
+            Task* t = new Task(list[i], 0);
+            list.extractElement(i);
+            if (pLast == 0) {
+                pFirst = t;
+            } else {
+                pLast->pNext = t;
+            }
+            pLast = t;
+        }
+    }
+    catch (...) {
+        destroyTasks(pFirst);
+        throw;
+    }
+    list.clear();
+
+    if (pFirst != 0) {
+        enqueue(pFirst, pLast);
+    }
+}
+
+// Post new replaceable Runnable.
+void
+util::RequestThread::postNewReplaceableRunnable(afl::base::Runnable* p, const void* key)
+{
+    std::auto_ptr<afl::base::Runnable> pp(p);
+    std::auto_ptr<Task> t(new Task(pp.release(), key));
+    if (key != 0) {
+        // The last task of the queue has not been taken by the worker yet, so it can still be replaced.
+        afl::base::Runnable* obsolete = 0;
+        {
+            afl::sys::MutexGuard g(m_taskMutex);
+            if (m_pLastTask != 0 && m_pLastTask->key == key) {
+                obsolete = m_pLastTask->pRunnable;
+                m_pLastTask->pRunnable = t->pRunnable;
+                t->pRunnable = obsolete;
+            }
+        }
+        if (obsolete != 0) {
+            // Destroy outside the mutex; destruction may post new tasks
+            destroyTasks(t.release());
+            return;
+        }
     }
+    enqueue(t.get(), t.get());
+    t.release();
 }
 
 // Thread entry point.
@@ -63,37 +122,60 @@ util::RequestThread::run()
         m_taskSemaphore.wait();
 
         // Fetch tasks under mutex lock. This is also a nice place to check for termination requests.
-        afl::container::PtrVector<afl::base::Runnable> tasks;
+        Task* tasks;
         {
             afl::sys::MutexGuard g(m_taskMutex);
             if (m_stop) {
-                // Do not modify m_taskQueue when stopped, to guarantee that unexecuted tasks are destroyed in order!
+                // Do not modify the queue when stopped, to guarantee that unexecuted tasks are destroyed in order!
                 break;
             }
-            tasks.swap(m_taskQueue);
+            tasks = m_pFirstTask;
+            m_pFirstTask = m_pLastTask = 0;
         }
 
         // Process tasks
         // FIXME: check termination requests between tasks?
-        for (size_t i = 0, n = tasks.size(); i < n; ++i) {
+        while (tasks != 0) {
             // Request delay. This is a testing feature, so no need to check for termination here.
             if (m_delay > 0) {
                 m_thread->sleep(m_delay);
             }
+
+            // Measure latency
+            const uint32_t waitTime = afl::sys::Time::getTickCounter() - tasks->postTime;
+            if (waitTime > m_maxWaitTime) {
+                afl::sys::MutexGuard g(m_taskMutex);
+                m_maxWaitTime = waitTime;
+            }
+            if (waitTime >= LATENCY_WARNING) {
+                m_log.write(m_log.Trace, m_name, afl::string::Format("Request waited %d ms (max %d ms)", waitTime, m_maxWaitTime));
+            }
+
             try {
-                tasks[i]->run();
+                tasks->pRunnable->run();
             }
             catch (std::exception& e) {
                 m_log.write(m_log.Warn, m_name, m_translator("Exception in background thread"), e);
             }
 
             // Destroy in correct order
-            tasks.replaceElementNew(i, 0);
+            Task* next = tasks->pNext;
+            tasks->pNext = 0;
+            destroyTasks(tasks);
+            tasks = next;
         }
     }
     m_log.write(m_log.Trace, m_name, "Thread terminates");
 }
 
+// Get maximum wait time.
+uint32_t
+util::RequestThread::getMaxWaitTime() const
+{
+    afl::sys::MutexGuard g(m_taskMutex);
+    return m_maxWaitTime;
+}
+
 void
 util::RequestThread::stop()
 {
@@ -103,3 +185,39 @@ util::RequestThread::stop()
     }
     m_taskSemaphore.post();
 }
+
+/** Append a chain of tasks to the queue.
+    Wakes the worker if the queue was empty.
+    \param pFirst First task
+    \param pLast  Last task (pLast->pNext must be null) */
+void
+util::RequestThread::enqueue(Task* pFirst, Task* pLast)
+{
+    bool wake;
+    {
+        afl::sys::MutexGuard g(m_taskMutex);
+        wake = (m_pFirstTask == 0);
+        if (wake) {
+            m_pFirstTask = pFirst;
+        } else {
+            m_pLastTask->pNext = pFirst;
+        }
+        m_pLastTask = pLast;
+    }
+    if (wake) {
+        m_taskSemaphore.post();
+    }
+}
+
+/** Destroy a chain of tasks, in order.
+    \param p First task */
+void
+util::RequestThread::destroyTasks(Task* p)
+{
+    while (p != 0) {
+        Task* next = p->pNext;
+        delete p->pRunnable;
+        delete p;
+        p = next;
+    }
+}
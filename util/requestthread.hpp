@@ -7,6 +7,7 @@
 
 #include <memory>
 #include "afl/base/stoppable.hpp"
+#include "afl/base/runnable.hpp"
 #include "afl/container/ptrvector.hpp"
 #include "afl/string/string.hpp"
 #include "afl/string/translator.hpp"
@@ -14,12 +15,17 @@
 #include "afl/sys/mutex.hpp"
 #include "afl/sys/semaphore.hpp"
 #include "afl/sys/thread.hpp"
+#include "afl/sys/time.hpp"
 #include "util/requestdispatcher.hpp"
 
 namespace util {
 
     /** Worker thread.
-        This implements RequestDispatcher and executes all posted Runnable's in a separate thread. */
+        This implements RequestDispatcher and executes all posted Runnable's in a separate thread.
+
+        For each request, the time between posting and start of execution is measured.
+        This is the latency a requester (e.g. the user interface) experiences.
+        Long waits are logged, the maximum can be obtained using getMaxWaitTime(). */
     class RequestThread : public RequestDispatcher, private afl::base::Stoppable {
      public:
         /** Constructor.
@@ -36,25 +42,49 @@ namespace util {
 
         // RequestDispatcher:
         virtual void postNewRunnable(afl::base::Runnable* p);
+        virtual void postNewRunnables(afl::container::PtrVector<afl::base::Runnable>& list);
+        virtual void postNewReplaceableRunnable(afl::base::Runnable* p, const void* key);
+
+        /** Get maximum wait time.
+            \return Maximum time a request waited between being posted and being started, in milliseconds */
+        uint32_t getMaxWaitTime() const;
 
      private:
+        /** Queue element.
+            Allocated by the posting thread outside the mutex, so enqueueing only needs to link it. */
+        struct Task {
+            afl::base::Runnable* pRunnable;
+            const void* key;
+            Task* pNext;
+            uint32_t postTime;
+
+            Task(afl::base::Runnable* pRunnable, const void* key)
+                : pRunnable(pRunnable), key(key), pNext(0), postTime(afl::sys::Time::getTickCounter())
+                { }
+        };
+
         // Runnable:
         virtual void run();
         virtual void stop();
 
+        void enqueue(Task* pFirst, Task* pLast);
+        static void destroyTasks(Task* p);
+
         /** Underlying thread. Created in constructor, shut down in destructor. */
         std::auto_ptr<afl::sys::Thread> m_thread;
 
-        /** Mutex protecting m_taskQueue and m_stop. */
-        afl::sys::Mutex m_taskMutex;
+        /** Mutex protecting m_pFirstTask, m_pLastTask, m_stop, and m_maxWaitTime. */
+        mutable afl::sys::Mutex m_taskMutex;
 
         /** Semaphore that signals availability of new tasks.
-            The semaphore is increased for every empty->nonempty transition of m_taskQueue,
+            The semaphore is increased for every empty->nonempty transition of the task queue,
             not for every individual task. */
         afl::sys::Semaphore m_taskSemaphore;
 
-        /** Tasks. Protected by m_taskMutex. */
-        afl::container::PtrVector<afl::base::Runnable> m_taskQueue;
+        /** Tasks (singly-linked list, FIFO). Protected by m_taskMutex.
+            The worker takes the whole list at once. */
+        Task* m_pFirstTask;
+        Task* m_pLastTask;
 
         /** Name. */
         String_t m_name;
@@ -68,6 +98,9 @@ namespace util {
         /** Stop flag. Protected by m_taskMutex. */
         bool m_stop;
 
+        /** Maximum wait time. Written by worker only; protected by m_taskMutex for readers. */
+        uint32_t m_maxWaitTime;
+
         /** Request delay. */
         int m_delay;
     };